@@ -0,0 +1,47 @@
+///////////////////////////////////////////////////////////////////////////////
+// bilateralblurfragmentshader.glsl
+// ============
+// depth aware blur fragment shader - one direction of a 9 tap gaussian that stops at edges
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+// ambient occlusion in red, with the view depth in green
+uniform sampler2D input0;
+// (1, 0) across or (0, 1) down
+uniform vec2 direction;
+
+// gaussian weights of the center and the taps each side
+const float weights[5] = float[](0.2270270270, 0.1945945946, 0.1216216216, 0.0540540541, 0.0162162162);
+// how quickly a tap's weight falls with its difference in
+// depth, against the depth of the center
+const float SHARPNESS = 40.0;
+
+void main()
+{
+	ivec2 size = textureSize(input0, 0);
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	ivec2 stride = ivec2(direction);
+	vec2 center = texelFetch(input0, pixel, 0).rg;
+
+	// the taps are read one by one, as blending two texels
+	// would mix depths across an edge
+	float sum = center.r * weights[0];
+	float totalWeight = weights[0];
+	for (int i = 1; i < 5; i++)
+	{
+		for (int side = -1; side <= 1; side += 2)
+		{
+			vec2 tap = texelFetch(input0, clamp(pixel + stride * i * side, ivec2(0), size - 1), 0).rg;
+			float weight = weights[i] * exp(-SHARPNESS * abs(tap.g - center.g) / max(center.g, 0.001));
+			sum += tap.r * weight;
+			totalWeight += weight;
+		}
+	}
+	outputColor = vec4(sum / totalWeight, center.g, 0.0, 1.0);
+}
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// bloomdownsamplefragmentshader.glsl
+// ============
+// bloom downsample fragment shader - one level of the chain, 13 taps to half size
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+// the level above, twice the size
+uniform sampler2D input0;
+// whether this is the first level, read from the scene, where
+// each group of taps is weighted down by its brightness so a
+// single bright pixel does not flicker as a large blob
+uniform int firstLevel;
+
+// the average of four taps, weighted by brightness on the
+// first level
+vec3 Group(vec3 a, vec3 b, vec3 c, vec3 d)
+{
+	if (firstLevel == 0)
+	{
+		return((a + b + c + d) * 0.25);
+	}
+	vec4 weights = 1.0 / (1.0 + vec4(max(a.r, max(a.g, a.b)), max(b.r, max(b.g, b.b)),
+		max(c.r, max(c.g, c.b)), max(d.r, max(d.g, d.b))));
+	return((a * weights.x + b * weights.y + c * weights.z + d * weights.w) / dot(weights, vec4(1.0)));
+}
+
+void main()
+{
+	// taps a to m at whole and half texel offsets, each read
+	// between four texels of the level above
+	vec2 texel = 1.0 / vec2(textureSize(input0, 0));
+	vec2 uv = fragmentTextureCoordinate;
+	vec3 a = texture(input0, uv + texel * vec2(-2.0, -2.0)).rgb;
+	vec3 b = texture(input0, uv + texel * vec2(0.0, -2.0)).rgb;
+	vec3 c = texture(input0, uv + texel * vec2(2.0, -2.0)).rgb;
+	vec3 d = texture(input0, uv + texel * vec2(-2.0, 0.0)).rgb;
+	vec3 e = texture(input0, uv).rgb;
+	vec3 f = texture(input0, uv + texel * vec2(2.0, 0.0)).rgb;
+	vec3 g = texture(input0, uv + texel * vec2(-2.0, 2.0)).rgb;
+	vec3 h = texture(input0, uv + texel * vec2(0.0, 2.0)).rgb;
+	vec3 i = texture(input0, uv + texel * vec2(2.0, 2.0)).rgb;
+	vec3 j = texture(input0, uv + texel * vec2(-1.0, -1.0)).rgb;
+	vec3 k = texture(input0, uv + texel * vec2(1.0, -1.0)).rgb;
+	vec3 l = texture(input0, uv + texel * vec2(-1.0, 1.0)).rgb;
+	vec3 m = texture(input0, uv + texel * vec2(1.0, 1.0)).rgb;
+
+	// the inner box counts half, the four overlapping outer
+	// boxes an eighth each
+	vec3 color = Group(j, k, l, m) * 0.5;
+	color += Group(a, b, d, e) * 0.125;
+	color += Group(b, c, e, f) * 0.125;
+	color += Group(d, e, g, h) * 0.125;
+	color += Group(e, f, h, i) * 0.125;
+	outputColor = vec4(color, 1.0);
+}
@@ -0,0 +1,31 @@
+///////////////////////////////////////////////////////////////////////////////
+// bloomupsamplefragmentshader.glsl
+// ============
+// bloom upsample fragment shader - adds the level below, spread by a tent, to this one
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+// the upsampled levels below, at half size, and this level
+// of the downsampled chain
+uniform sampler2D input0;
+uniform sampler2D input1;
+
+void main()
+{
+	// a 3x3 tent, read one texel of the smaller level apart
+	vec2 texel = 1.0 / vec2(textureSize(input0, 0));
+	vec2 uv = fragmentTextureCoordinate;
+	vec3 below = texture(input0, uv).rgb * 4.0;
+	below += (texture(input0, uv + vec2(-texel.x, 0.0)).rgb + texture(input0, uv + vec2(texel.x, 0.0)).rgb +
+		texture(input0, uv + vec2(0.0, -texel.y)).rgb + texture(input0, uv + vec2(0.0, texel.y)).rgb) * 2.0;
+	below += texture(input0, uv - texel).rgb + texture(input0, uv + texel).rgb +
+		texture(input0, uv + vec2(-texel.x, texel.y)).rgb + texture(input0, uv + vec2(texel.x, -texel.y)).rgb;
+
+	outputColor = vec4(texture(input1, uv).rgb + below / 16.0, 1.0);
+}
@@ -0,0 +1,19 @@
+///////////////////////////////////////////////////////////////////////////////
+// copyfragmentshader.glsl
+// ============
+// copy fragment shader - a target drawn into the frame as it is
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+uniform sampler2D input0;
+
+void main()
+{
+	outputColor = vec4(texture(input0, fragmentTextureCoordinate).rgb, 1.0);
+}
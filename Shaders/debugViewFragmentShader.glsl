@@ -0,0 +1,40 @@
+///////////////////////////////////////////////////////////////////////////////
+// debugviewfragmentshader.glsl
+// ============
+// debug view fragment shader - a count for overdraw, or the heat of a draw
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec3 fragmentNormal;
+
+out vec4 outputColor;
+
+// the DEBUG_VIEW being drawn, and the heat of the draw from
+// zero to one for the views that color whole draws
+uniform int debugView;
+uniform float debugValue;
+
+const int DEBUG_VIEW_OVERDRAW = 1;
+
+// blue through cyan, green and yellow to red
+vec3 HeatColor(float value)
+{
+	float ramp = clamp(value, 0.0, 1.0) * 4.0;
+	return clamp(vec3(ramp - 2.0, 2.0 - abs(ramp - 2.0), 2.0 - ramp), 0.0, 1.0);
+}
+
+void main()
+{
+	// every fragment adds one to the count target
+	if (debugView == DEBUG_VIEW_OVERDRAW)
+	{
+		outputColor = vec4(1.0);
+		return;
+	}
+
+	// a little shading from above keeps the shapes readable
+	float shade = 0.6 + 0.4 * abs(normalize(fragmentNormal).y);
+	outputColor = vec4(HeatColor(debugValue) * shade, 1.0);
+}
@@ -0,0 +1,25 @@
+///////////////////////////////////////////////////////////////////////////////
+// debugviewvertexshader.glsl
+// ============
+// debug view vertex shader - the scene's vertices with its camera
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+// the attribute locations of the scene's mesh heap
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+
+out vec3 fragmentNormal;
+
+// set by the scene and view managers as for the scene
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+	gl_Position = projection * view * model * vec4(position, 1.0);
+	fragmentNormal = mat3(model) * normal;
+}
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// exposurefragmentshader.glsl
+// ============
+// auto exposure fragment shader - adapts the exposure towards the frame's histogram
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+// the histogram, a bin to a column and a band to a row, and
+// the exposure of the last frame
+uniform sampler2D input0;
+uniform sampler2D input1;
+// the range of the bins in stops
+uniform float minimumLogLuminance;
+uniform float maximumLogLuminance;
+// share of the darkest and of the brightest samples left out
+// of the average
+uniform float lowPercent;
+uniform float highPercent;
+// luminance the average is brought to, and the limits of the
+// exposure doing it
+uniform float key;
+uniform float minimumExposure;
+uniform float maximumExposure;
+// seconds since the last frame, how quickly the eye adapts,
+// and whether there is a last exposure to adapt from
+uniform float deltaTime;
+uniform float adaptationSpeed;
+uniform int hasHistory;
+
+const int MAX_BINS = 64;
+
+void main()
+{
+	// add the bands of each bin up
+	ivec2 size = textureSize(input0, 0);
+	int binCount = min(size.x, MAX_BINS);
+	float bins[MAX_BINS];
+	float total = 0.0;
+	for (int bin = 0; bin < binCount; bin++)
+	{
+		bins[bin] = 0.0;
+		for (int band = 0; band < size.y; band++)
+		{
+			bins[bin] += texelFetch(input0, ivec2(bin, band), 0).r;
+		}
+		total += bins[bin];
+	}
+
+	// the average stop of the samples between the percentiles,
+	// so a lamp or a dark corner does not swing the exposure
+	float low = total * lowPercent;
+	float high = total * highPercent;
+	float below = 0.0;
+	float weightedSum = 0.0;
+	float counted = 0.0;
+	for (int bin = 0; bin < binCount; bin++)
+	{
+		float inRange = clamp(below + bins[bin], low, high) - clamp(below, low, high);
+		float stop = mix(minimumLogLuminance, maximumLogLuminance, (float(bin) + 0.5) / float(binCount));
+		weightedSum += stop * inRange;
+		counted += inRange;
+		below += bins[bin];
+	}
+	float averageStop = (counted > 0.0) ? (weightedSum / counted) : log2(key);
+	float target = clamp(key / exp2(averageStop), minimumExposure, maximumExposure);
+
+	// ease towards it in stops, at the same rate whatever the
+	// frame rate
+	float exposure = target;
+	if (hasHistory != 0)
+	{
+		float previous = texelFetch(input1, ivec2(0), 0).r;
+		float blend = 1.0 - exp(-deltaTime * adaptationSpeed);
+		exposure = exp2(mix(log2(max(previous, 1.0e-4)), log2(target), blend));
+	}
+	outputColor = vec4(exposure, 0.0, 0.0, 1.0);
+}
@@ -0,0 +1,18 @@
+///////////////////////////////////////////////////////////////////////////////
+// fullscreenvertexshader.glsl
+// ============
+// full screen pass vertex shader - clip space corners passed through
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+layout(location = 0) in vec2 position;
+
+out vec2 fragmentTextureCoordinate;
+
+void main()
+{
+	gl_Position = vec4(position, 0.0, 1.0);
+	fragmentTextureCoordinate = position * 0.5 + 0.5;
+}
@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+// fxaafragmentshader.glsl
+// ============
+// fast approximate anti-aliasing fragment shader - smooths the tone mapped frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+// the tone mapped frame
+uniform sampler2D input0;
+
+// contrast below which a pixel is left alone, against the
+// brighter of its neighbors and in absolute terms for the
+// dark areas where the relative test finds noise
+const float edgeThreshold = 0.125;
+const float edgeThresholdMinimum = 0.0312;
+// how much of the blur of single pixel detail is kept
+const float subpixelQuality = 0.75;
+// steps along an edge, each further than the one before
+const int searchSteps = 10;
+const float stepLengths[10] = float[](1.0, 1.0, 1.0, 1.5, 2.0, 2.0, 2.0, 4.0, 8.0, 8.0);
+
+float Luma(vec3 color)
+{
+	// perceptual weight, on the gamma encoded color
+	return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+float LumaAt(vec2 uv)
+{
+	return Luma(texture(input0, uv).rgb);
+}
+
+void main()
+{
+	vec2 texel = 1.0 / vec2(textureSize(input0, 0));
+	vec2 uv = fragmentTextureCoordinate;
+	vec3 center = texture(input0, uv).rgb;
+
+	float lumaCenter = Luma(center);
+	float lumaDown = LumaAt(uv + vec2(0.0, -texel.y));
+	float lumaUp = LumaAt(uv + vec2(0.0, texel.y));
+	float lumaLeft = LumaAt(uv + vec2(-texel.x, 0.0));
+	float lumaRight = LumaAt(uv + vec2(texel.x, 0.0));
+
+	float lumaMin = min(lumaCenter, min(min(lumaDown, lumaUp), min(lumaLeft, lumaRight)));
+	float lumaMax = max(lumaCenter, max(max(lumaDown, lumaUp), max(lumaLeft, lumaRight)));
+	float range = lumaMax - lumaMin;
+	if (range < max(edgeThresholdMinimum, lumaMax * edgeThreshold))
+	{
+		outputColor = vec4(center, 1.0);
+		return;
+	}
+
+	float lumaDownLeft = LumaAt(uv + vec2(-texel.x, -texel.y));
+	float lumaUpRight = LumaAt(uv + vec2(texel.x, texel.y));
+	float lumaUpLeft = LumaAt(uv + vec2(-texel.x, texel.y));
+	float lumaDownRight = LumaAt(uv + vec2(texel.x, -texel.y));
+
+	// the edge runs along the direction the luma changes
+	// least in
+	float lumaDownUp = lumaDown + lumaUp;
+	float lumaLeftRight = lumaLeft + lumaRight;
+	float lumaLeftCorners = lumaDownLeft + lumaUpLeft;
+	float lumaDownCorners = lumaDownLeft + lumaDownRight;
+	float lumaRightCorners = lumaDownRight + lumaUpRight;
+	float lumaUpCorners = lumaUpRight + lumaUpLeft;
+	float edgeHorizontal = abs(-2.0 * lumaLeft + lumaLeftCorners) + abs(-2.0 * lumaCenter + lumaDownUp) * 2.0 + abs(-2.0 * lumaRight + lumaRightCorners);
+	float edgeVertical = abs(-2.0 * lumaUp + lumaUpCorners) + abs(-2.0 * lumaCenter + lumaLeftRight) * 2.0 + abs(-2.0 * lumaDown + lumaDownCorners);
+	bool bHorizontal = (edgeHorizontal >= edgeVertical);
+
+	// which side of the pixel the edge lies on
+	float luma1 = bHorizontal ? lumaDown : lumaLeft;
+	float luma2 = bHorizontal ? lumaUp : lumaRight;
+	float gradient1 = luma1 - lumaCenter;
+	float gradient2 = luma2 - lumaCenter;
+	bool bSide1Steeper = abs(gradient1) >= abs(gradient2);
+	float gradientScaled = 0.25 * max(abs(gradient1), abs(gradient2));
+
+	float stepLength = bHorizontal ? texel.y : texel.x;
+	float lumaLocalAverage;
+	if (bSide1Steeper)
+	{
+		stepLength = -stepLength;
+		lumaLocalAverage = 0.5 * (luma1 + lumaCenter);
+	}
+	else
+	{
+		lumaLocalAverage = 0.5 * (luma2 + lumaCenter);
+	}
+
+	// walk both ways along the edge, half a pixel off the
+	// center, until the luma leaves the edge's average
+	vec2 edgeUV = uv;
+	if (bHorizontal)
+	{
+		edgeUV.y += stepLength * 0.5;
+	}
+	else
+	{
+		edgeUV.x += stepLength * 0.5;
+	}
+	vec2 offset = bHorizontal ? vec2(texel.x, 0.0) : vec2(0.0, texel.y);
+	vec2 uv1 = edgeUV - offset;
+	vec2 uv2 = edgeUV + offset;
+	float lumaEnd1 = LumaAt(uv1) - lumaLocalAverage;
+	float lumaEnd2 = LumaAt(uv2) - lumaLocalAverage;
+	bool bReached1 = abs(lumaEnd1) >= gradientScaled;
+	bool bReached2 = abs(lumaEnd2) >= gradientScaled;
+	for (int i = 1; (i < searchSteps) && !(bReached1 && bReached2); i++)
+	{
+		if (!bReached1)
+		{
+			uv1 -= offset * stepLengths[i];
+			lumaEnd1 = LumaAt(uv1) - lumaLocalAverage;
+			bReached1 = abs(lumaEnd1) >= gradientScaled;
+		}
+		if (!bReached2)
+		{
+			uv2 += offset * stepLengths[i];
+			lumaEnd2 = LumaAt(uv2) - lumaLocalAverage;
+			bReached2 = abs(lumaEnd2) >= gradientScaled;
+		}
+	}
+
+	// the nearer end decides how far across the edge the
+	// pixel is shifted, if the luma there goes the right way
+	float distance1 = bHorizontal ? (uv.x - uv1.x) : (uv.y - uv1.y);
+	float distance2 = bHorizontal ? (uv2.x - uv.x) : (uv2.y - uv.y);
+	bool bNearer1 = distance1 < distance2;
+	float distanceFinal = min(distance1, distance2);
+	float edgeLength = distance1 + distance2;
+	float pixelOffset = -distanceFinal / edgeLength + 0.5;
+	bool bCenterSmaller = lumaCenter < lumaLocalAverage;
+	bool bCorrectVariation = ((bNearer1 ? lumaEnd1 : lumaEnd2) < 0.0) != bCenterSmaller;
+	float finalOffset = bCorrectVariation ? pixelOffset : 0.0;
+
+	// single pixel detail has no edge to walk, so it is
+	// blurred by how much it stands out from around it
+	float lumaAverage = (1.0 / 12.0) * (2.0 * (lumaDownUp + lumaLeftRight) + lumaLeftCorners + lumaRightCorners);
+	float subpixelOffset1 = clamp(abs(lumaAverage - lumaCenter) / range, 0.0, 1.0);
+	float subpixelOffset2 = (-2.0 * subpixelOffset1 + 3.0) * subpixelOffset1 * subpixelOffset1;
+	float subpixelOffset = subpixelOffset2 * subpixelOffset2 * subpixelQuality;
+	finalOffset = max(finalOffset, subpixelOffset);
+
+	vec2 finalUV = uv;
+	if (bHorizontal)
+	{
+		finalUV.y += finalOffset * stepLength;
+	}
+	else
+	{
+		finalUV.x += finalOffset * stepLength;
+	}
+	outputColor = vec4(texture(input0, finalUV).rgb, 1.0);
+}
@@ -0,0 +1,27 @@
+///////////////////////////////////////////////////////////////////////////////
+// hudfragmentshader.glsl
+// ============
+// performance overlay fragment shader - signed distance field text
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+in vec4 fragmentColor;
+
+out vec4 outputColor;
+
+// distance to the glyph edges in the alpha channel, with
+// the edge at 0.5 and solid cells for plain rectangles
+uniform sampler2D fontAtlas;
+
+void main()
+{
+	float distance = texture(fontAtlas, fragmentTextureCoordinate).a - 0.5;
+	// antialias over about one pixel whatever the text scale
+	float edgeWidth = max(fwidth(distance), 0.0001);
+	float coverage = smoothstep(-edgeWidth, edgeWidth, distance);
+
+	outputColor = vec4(fragmentColor.rgb, fragmentColor.a * coverage);
+}
@@ -0,0 +1,28 @@
+///////////////////////////////////////////////////////////////////////////////
+// hudvertexshader.glsl
+// ============
+// performance overlay vertex shader - pixel positions to clip space
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 textureCoordinate;
+layout(location = 2) in vec4 color;
+
+out vec2 fragmentTextureCoordinate;
+out vec4 fragmentColor;
+
+// size of the frame in pixels
+uniform vec2 screenSize;
+
+void main()
+{
+	// pixels count down from the top left of the frame
+	vec2 clip = position / screenSize * 2.0 - 1.0;
+	gl_Position = vec4(clip.x, -clip.y, 0.0, 1.0);
+
+	fragmentTextureCoordinate = textureCoordinate;
+	fragmentColor = color;
+}
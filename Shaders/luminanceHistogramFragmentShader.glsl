@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////////////////////////////////
+// luminancehistogramfragmentshader.glsl
+// ============
+// luminance histogram fragment shader - counts one bin over one band of the frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+// a small level of the bloom chain, read on a grid of the same
+// size whatever the size of the frame
+uniform sampler2D input0;
+// the range of the bins in stops, and the size of the target
+// as bins across and bands down
+uniform float minimumLogLuminance;
+uniform float maximumLogLuminance;
+uniform int binCount;
+uniform int bandCount;
+
+// samples across and down the frame
+const int GRID_SIZE = 64;
+
+void main()
+{
+	// each column of the target is a bin and each row a band
+	// of the grid, added up by the exposure pass
+	int bin = int(gl_FragCoord.x);
+	int band = int(gl_FragCoord.y);
+	int bandRows = GRID_SIZE / bandCount;
+
+	float count = 0.0;
+	for (int row = band * bandRows; row < (band + 1) * bandRows; row++)
+	{
+		for (int column = 0; column < GRID_SIZE; column++)
+		{
+			vec2 uv = (vec2(column, row) + 0.5) / float(GRID_SIZE);
+			float luminance = dot(texture(input0, uv).rgb, vec3(0.2126, 0.7152, 0.0722));
+			float position = (log2(max(luminance, 1.0e-5)) - minimumLogLuminance) / (maximumLogLuminance - minimumLogLuminance);
+			int sampleBin = int(clamp(position, 0.0, 0.9999) * float(binCount));
+			count += (sampleBin == bin) ? 1.0 : 0.0;
+		}
+	}
+	outputColor = vec4(count, 0.0, 0.0, 1.0);
+}
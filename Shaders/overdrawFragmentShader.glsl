@@ -0,0 +1,35 @@
+///////////////////////////////////////////////////////////////////////////////
+// overdrawfragmentshader.glsl
+// ============
+// overdraw resolve fragment shader - fragment counts to a heat ramp
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+out vec4 outputColor;
+
+// fragments drawn on each pixel, the same size as the frame
+uniform sampler2D overdrawCounts;
+// count at the hot end of the ramp
+uniform float rampMaximum;
+
+// blue through cyan, green and yellow to red
+vec3 HeatColor(float value)
+{
+	float ramp = clamp(value, 0.0, 1.0) * 4.0;
+	return clamp(vec3(ramp - 2.0, 2.0 - abs(ramp - 2.0), 2.0 - ramp), 0.0, 1.0);
+}
+
+void main()
+{
+	float count = texelFetch(overdrawCounts, ivec2(gl_FragCoord.xy), 0).r;
+	// pixels nothing was drawn on stay black, and a single
+	// layer is the cold end
+	if (count < 0.5)
+	{
+		outputColor = vec4(0.0, 0.0, 0.0, 1.0);
+		return;
+	}
+	outputColor = vec4(HeatColor((count - 1.0) / (rampMaximum - 1.0)), 1.0);
+}
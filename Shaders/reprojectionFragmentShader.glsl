@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+// reprojectionfragmentshader.glsl
+// ============
+// scene reprojection fragment shader - reuses the last frame's pixels the camera still sees
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+// the last frame's scene color and depth
+uniform sampler2D previousColor;
+uniform sampler2D previousDepth;
+// from the last frame's clip space to this one's
+uniform mat4 forwardReprojection;
+// every pixel of one in tilePhases tiles is shaded again,
+// a different one each frame
+uniform int tileSize;
+uniform int tilePhases;
+uniform int tilePhase;
+// how much nearer than its surface a reused pixel is written
+uniform float depthBias;
+// the alpha of a pixel is one more than the frames it has
+// been reused, and one reused this often is shaded again
+uniform float maxReuseFrames;
+// pixels of the last frame's moving and shiny objects, as
+// minimum x and y then maximum x and y
+uniform vec4 reshadeRects[16];
+uniform int reshadeRectCount;
+
+// where the surface at a pixel of the last frame is now, in
+// pixels, with its depth in z
+vec3 MovePixel(ivec2 source, vec2 size)
+{
+	float depth = texelFetch(previousDepth, source, 0).r;
+	vec2 uv = (vec2(source) + 0.5) / size;
+	vec4 clip = forwardReprojection * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	if (clip.w <= 0.0)
+	{
+		return(vec3(-size, 1.0));
+	}
+	vec3 moved = clip.xyz / clip.w;
+	return(vec3((moved.xy * 0.5 + 0.5) * size, moved.z * 0.5 + 0.5));
+}
+
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	ivec2 tile = pixel / tileSize;
+	if (((tile.x + 3 * tile.y) % tilePhases) == tilePhase)
+	{
+		discard;
+	}
+
+	// this pixel's depth is not known until the scene is
+	// drawn, so the surface the last frame had here gives a
+	// first guess at how far the view moved, and the surface
+	// that guess lands on a better one
+	ivec2 size = textureSize(previousDepth, 0);
+	vec2 center = gl_FragCoord.xy;
+	ivec2 source = pixel;
+	for (int i = 0; i < 2; i++)
+	{
+		vec3 moved = MovePixel(source, vec2(size));
+		source = ivec2(floor(vec2(source) + 0.5 + (center - moved.xy)));
+		source = clamp(source, ivec2(0), size - 1);
+	}
+
+	// a pixel whose surface was hidden or off screen a frame
+	// ago finds the background or one that lands elsewhere,
+	// and has to be shaded
+	float depth = texelFetch(previousDepth, source, 0).r;
+	vec3 moved = MovePixel(source, vec2(size));
+	if ((depth >= 1.0) || any(greaterThan(abs(moved.xy - center), vec2(0.5))))
+	{
+		discard;
+	}
+
+	// the camera alone does not say where a moving object's
+	// pixels went, nor how a highlight slid
+	vec2 sourceCenter = vec2(source) + 0.5;
+	for (int i = 0; i < reshadeRectCount; i++)
+	{
+		if (all(greaterThanEqual(sourceCenter, reshadeRects[i].xy)) && all(lessThan(sourceCenter, reshadeRects[i].zw)))
+		{
+			discard;
+		}
+	}
+
+	vec4 previous = texelFetch(previousColor, source, 0);
+	float reuses = max(previous.a - 1.0, 0.0) + 1.0;
+	if (reuses > maxReuseFrames)
+	{
+		discard;
+	}
+
+	outputColor = vec4(previous.rgb, 1.0 + reuses);
+	gl_FragDepth = max(moved.z - depthBias, 0.0);
+}
@@ -0,0 +1,57 @@
+///////////////////////////////////////////////////////////////////////////////
+// smaablendfragmentshader.glsl
+// ============
+// morphological anti-aliasing blend fragment shader - mixes pixels across edges
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+out vec4 outputColor;
+
+// the tone mapped frame and the weights of each pixel's
+// edges - red and green for the one below, blue and alpha
+// for the one on the left, the first of each pair being
+// what the pixel takes across and the second what the
+// neighbor takes from it
+uniform sampler2D input0;
+uniform sampler2D input1;
+
+vec3 ColorAt(ivec2 pixel)
+{
+	ivec2 size = textureSize(input0, 0);
+	return texelFetch(input0, clamp(pixel, ivec2(0), size - 1), 0).rgb;
+}
+
+vec4 WeightsAt(ivec2 pixel)
+{
+	ivec2 size = textureSize(input1, 0);
+	if (any(lessThan(pixel, ivec2(0))) || any(greaterThanEqual(pixel, size)))
+	{
+		return vec4(0.0);
+	}
+	return texelFetch(input1, pixel, 0);
+}
+
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	vec4 own = WeightsAt(pixel);
+	float fromDown = own.r;
+	float fromLeft = own.b;
+	float fromUp = WeightsAt(pixel + ivec2(0, 1)).g;
+	float fromRight = WeightsAt(pixel + ivec2(1, 0)).a;
+
+	vec3 color = ColorAt(pixel);
+	float total = fromDown + fromLeft + fromUp + fromRight;
+	if (total > 0.0)
+	{
+		// a corner pixel takes from both edges, never more
+		// than the whole of itself
+		float scale = min(1.0, 1.0 / total);
+		vec3 taken = ColorAt(pixel + ivec2(0, -1)) * fromDown + ColorAt(pixel + ivec2(-1, 0)) * fromLeft +
+			ColorAt(pixel + ivec2(0, 1)) * fromUp + ColorAt(pixel + ivec2(1, 0)) * fromRight;
+		color = color * (1.0 - total * scale) + taken * scale;
+	}
+	outputColor = vec4(color, 1.0);
+}
@@ -0,0 +1,54 @@
+///////////////////////////////////////////////////////////////////////////////
+// smaaedgefragmentshader.glsl
+// ============
+// morphological anti-aliasing edge fragment shader - luma edges of each pixel
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+out vec4 outputColor;
+
+// the tone mapped frame
+uniform sampler2D input0;
+
+// luma step that is an edge, and how far below the
+// strongest step around a pixel its own may fall before it
+// is taken for the shading inside a shape instead
+const float threshold = 0.1;
+const float localContrastFactor = 2.0;
+
+float LumaAt(ivec2 pixel)
+{
+	ivec2 size = textureSize(input0, 0);
+	vec3 color = texelFetch(input0, clamp(pixel, ivec2(0), size - 1), 0).rgb;
+	return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float luma = LumaAt(pixel);
+	float lumaLeft = LumaAt(pixel + ivec2(-1, 0));
+	float lumaDown = LumaAt(pixel + ivec2(0, -1));
+
+	// red is the edge on the left of the pixel, green the
+	// one below it
+	vec2 delta = abs(luma - vec2(lumaLeft, lumaDown));
+	vec2 edges = step(threshold, delta);
+	if (dot(edges, vec2(1.0)) == 0.0)
+	{
+		outputColor = vec4(0.0);
+		return;
+	}
+
+	float lumaRight = LumaAt(pixel + ivec2(1, 0));
+	float lumaUp = LumaAt(pixel + ivec2(0, 1));
+	float lumaLeftLeft = LumaAt(pixel + ivec2(-2, 0));
+	float lumaDownDown = LumaAt(pixel + ivec2(0, -2));
+	vec4 around = abs(vec4(luma - lumaRight, luma - lumaUp, lumaLeft - lumaLeftLeft, lumaDown - lumaDownDown));
+	float maxDelta = max(max(delta.x, delta.y), max(max(around.x, around.y), max(around.z, around.w)));
+	edges *= step(maxDelta, localContrastFactor * delta);
+
+	outputColor = vec4(edges, 0.0, 1.0);
+}
@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////
+// smaaweightfragmentshader.glsl
+// ============
+// morphological anti-aliasing weight fragment shader - coverage across each edge
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+out vec4 outputColor;
+
+// the edges - red on the left of a pixel, green below it
+uniform sampler2D input0;
+
+// pixels searched along an edge each way
+const int maxSearch = 16;
+
+vec2 EdgesAt(ivec2 pixel)
+{
+	ivec2 size = textureSize(input0, 0);
+	if (any(lessThan(pixel, ivec2(0))) || any(greaterThanEqual(pixel, size)))
+	{
+		return vec2(0.0);
+	}
+	return texelFetch(input0, pixel, 0).rg;
+}
+
+// height of the line through a pixel, at its center, for
+// an edge ending distance1 before the pixel and distance2
+// after it, where it turns up (+0.5), down (-0.5) or not.
+// Two turns the same way are a notch, drawn as two lines
+// meeting halfway; otherwise one line joins the ends
+float LineHeight(float distance1, float distance2, float end1, float end2)
+{
+	if ((end1 == 0.0) && (end2 == 0.0))
+	{
+		return 0.0;
+	}
+
+	float start = -distance1;
+	float stop = distance2 + 1.0;
+	float x = 0.5;
+	if ((end1 != 0.0) && (end1 == end2))
+	{
+		float middle = 0.5 * (start + stop);
+		return (x < middle) ? end1 * (middle - x) / (middle - start) : end2 * (x - middle) / (stop - middle);
+	}
+	return mix(end1, end2, (x - start) / (stop - start));
+}
+
+// the sign of the turn at an end, from the crossing edges
+// on the pixel's side (up) and the far side (down)
+float EndTurn(float crossingNear, float crossingFar)
+{
+	return 0.5 * (step(0.5, crossingNear) - step(0.5, crossingFar));
+}
+
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	vec2 edges = EdgesAt(pixel);
+	vec4 weights = vec4(0.0);
+
+	// the edge below: walk it left and right, then see which
+	// way the shape turns past each end
+	if (edges.g > 0.5)
+	{
+		int left = 0;
+		while ((left < maxSearch) && (EdgesAt(pixel + ivec2(-left - 1, 0)).g > 0.5))
+		{
+			left++;
+		}
+		int right = 0;
+		while ((right < maxSearch) && (EdgesAt(pixel + ivec2(right + 1, 0)).g > 0.5))
+		{
+			right++;
+		}
+		float end1 = EndTurn(EdgesAt(pixel + ivec2(-left, 0)).r, EdgesAt(pixel + ivec2(-left, -1)).r);
+		float end2 = EndTurn(EdgesAt(pixel + ivec2(right + 1, 0)).r, EdgesAt(pixel + ivec2(right + 1, -1)).r);
+		float height = LineHeight(float(left), float(right), end1, end2);
+		// above the edge the line cuts into this pixel, which
+		// takes that much of the one below, and the other way
+		weights.r = max(height, 0.0);
+		weights.g = max(-height, 0.0);
+	}
+
+	// the edge on the left, walked down and up
+	if (edges.r > 0.5)
+	{
+		int down = 0;
+		while ((down < maxSearch) && (EdgesAt(pixel + ivec2(0, -down - 1)).r > 0.5))
+		{
+			down++;
+		}
+		int up = 0;
+		while ((up < maxSearch) && (EdgesAt(pixel + ivec2(0, up + 1)).r > 0.5))
+		{
+			up++;
+		}
+		float end1 = EndTurn(EdgesAt(pixel + ivec2(0, -down)).g, EdgesAt(pixel + ivec2(-1, -down)).g);
+		float end2 = EndTurn(EdgesAt(pixel + ivec2(0, up + 1)).g, EdgesAt(pixel + ivec2(-1, up + 1)).g);
+		float height = LineHeight(float(down), float(up), end1, end2);
+		weights.b = max(height, 0.0);
+		weights.a = max(-height, 0.0);
+	}
+
+	outputColor = weights;
+}
@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////////////
+// ssaocompositefragmentshader.glsl
+// ============
+// ambient occlusion composite fragment shader - darkens the scene by the upsampled occlusion
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+// the scene's color and depth, and the blurred occlusion at
+// half size with its view depth in green
+uniform sampler2D input0;
+uniform sampler2D input1;
+uniform sampler2D input2;
+// back from clip space to the view
+uniform mat4 inverseProjection;
+
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	vec4 color = texelFetch(input0, pixel, 0);
+	float depth = texelFetch(input1, pixel, 0).r;
+	if (depth >= 1.0)
+	{
+		outputColor = color;
+		return;
+	}
+	vec4 position = inverseProjection * vec4(fragmentTextureCoordinate * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	float viewDepth = -position.z / position.w;
+
+	// each half size texel was worked out at the top left of
+	// its four pixels, and the four around this pixel count
+	// by how near they are and how close their depth is, so
+	// the occlusion of one object does not bleed onto the
+	// one behind it
+	ivec2 size = textureSize(input2, 0);
+	vec2 coordinate = gl_FragCoord.xy * 0.5 - 0.25;
+	ivec2 base = ivec2(floor(coordinate));
+	vec2 blend = fract(coordinate);
+	float sum = 0.0;
+	float totalWeight = 0.0;
+	for (int y = 0; y <= 1; y++)
+	{
+		for (int x = 0; x <= 1; x++)
+		{
+			vec2 tap = texelFetch(input2, clamp(base + ivec2(x, y), ivec2(0), size - 1), 0).rg;
+			float bilinear = ((x == 1) ? blend.x : 1.0 - blend.x) * ((y == 1) ? blend.y : 1.0 - blend.y);
+			float weight = (bilinear + 0.001) / (abs(tap.g - viewDepth) / viewDepth + 0.001);
+			sum += tap.r * weight;
+			totalWeight += weight;
+		}
+	}
+	outputColor = vec4(color.rgb * (sum / totalWeight), color.a);
+}
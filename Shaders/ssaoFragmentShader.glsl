@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+// ssaofragmentshader.glsl
+// ============
+// ambient occlusion fragment shader - how much of the sky each half size pixel sees
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+// the scene's depth, at the full size
+uniform sampler2D input0;
+// tiled blue noise turning the samples of each pixel
+uniform sampler2D noise;
+// the camera's projection, and back from clip space
+uniform mat4 projection;
+uniform mat4 inverseProjection;
+// how far around a point is searched, in world units, and
+// how dark a point in full cover gets
+uniform float radius;
+uniform float intensity;
+
+const int SAMPLE_COUNT = 8;
+// how much nearer than a sample the scene must be to hide it
+const float BIAS = 0.02;
+const float GOLDEN_ANGLE = 2.39996323;
+
+// the view space point at a depth buffer value
+vec3 ViewPosition(vec2 uv, float depth)
+{
+	vec4 position = inverseProjection * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	return(position.xyz / position.w);
+}
+
+// the view space point at a full size pixel
+vec3 PixelPosition(ivec2 pixel, ivec2 size)
+{
+	pixel = clamp(pixel, ivec2(0), size - 1);
+	vec2 uv = (vec2(pixel) + 0.5) / vec2(size);
+	return(ViewPosition(uv, texelFetch(input0, pixel, 0).r));
+}
+
+void main()
+{
+	ivec2 size = textureSize(input0, 0);
+	ivec2 pixel = min(ivec2(gl_FragCoord.xy) * 2, size - 1);
+	float depth = texelFetch(input0, pixel, 0).r;
+	vec3 position = PixelPosition(pixel, size);
+	// the view depth goes along for the blur and upsample
+	if (depth >= 1.0)
+	{
+		outputColor = vec4(1.0, -position.z, 0.0, 1.0);
+		return;
+	}
+
+	// the normal from the neighbors, each way the nearer one
+	// so the edges of objects do not bend it, and never one
+	// past the border
+	vec3 left = PixelPosition(pixel - ivec2(1, 0), size);
+	vec3 right = PixelPosition(pixel + ivec2(1, 0), size);
+	vec3 below = PixelPosition(pixel - ivec2(0, 1), size);
+	vec3 above = PixelPosition(pixel + ivec2(0, 1), size);
+	float leftGap = (pixel.x > 0) ? abs(position.z - left.z) : 1.0e30;
+	float rightGap = (pixel.x < size.x - 1) ? abs(right.z - position.z) : 1.0e30;
+	float belowGap = (pixel.y > 0) ? abs(position.z - below.z) : 1.0e30;
+	float aboveGap = (pixel.y < size.y - 1) ? abs(above.z - position.z) : 1.0e30;
+	vec3 across = (rightGap < leftGap) ? (right - position) : (position - left);
+	vec3 up = (aboveGap < belowGap) ? (above - position) : (position - below);
+	vec3 normal = normalize(cross(across, up));
+	if (dot(normal, position) > 0.0)
+	{
+		normal = -normal;
+	}
+
+	// any two directions at right angles to the normal
+	float side = (normal.z >= 0.0) ? 1.0 : -1.0;
+	float a = -1.0 / (side + normal.z);
+	float b = normal.x * normal.y * a;
+	vec3 tangent = vec3(1.0 + side * normal.x * normal.x * a, side * b, -side * normal.x);
+	vec3 bitangent = vec3(b, side + normal.y * normal.y * a, -normal.y);
+
+	// samples spiral over the hemisphere, cosine weighted and
+	// nearer the point first, turned and pushed out by noise
+	vec4 turn = texelFetch(noise, ivec2(gl_FragCoord.xy) % textureSize(noise, 0), 0);
+	float occlusion = 0.0;
+	for (int i = 0; i < SAMPLE_COUNT; i++)
+	{
+		float u = (float(i) + 0.5) / float(SAMPLE_COUNT);
+		float angle = float(i) * GOLDEN_ANGLE + turn.r * 6.28318531;
+		float spread = sqrt(u);
+		vec3 direction = vec3(spread * cos(angle), spread * sin(angle), sqrt(1.0 - u));
+		float reach = (float(i) + turn.g) / float(SAMPLE_COUNT);
+		reach = mix(0.1, 1.0, reach * reach) * radius;
+		vec3 probe = position + (tangent * direction.x + bitangent * direction.y + normal * direction.z) * reach;
+
+		vec4 clip = projection * vec4(probe, 1.0);
+		vec2 sampleUV = clip.xy / clip.w * 0.5 + 0.5;
+		float sceneDepth = ViewPosition(sampleUV, texture(input0, sampleUV).r).z;
+		// what is far in front of the point is another object,
+		// not one shading it
+		float range = smoothstep(0.0, 1.0, radius / abs(position.z - sceneDepth));
+		occlusion += ((sceneDepth >= probe.z + BIAS) ? 1.0 : 0.0) * range;
+	}
+
+	float visibility = clamp(1.0 - intensity * occlusion / float(SAMPLE_COUNT), 0.0, 1.0);
+	outputColor = vec4(visibility, -position.z, 0.0, 1.0);
+}
@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////////////
+// taafragmentshader.glsl
+// ============
+// temporal anti-aliasing fragment shader - blends the jittered frame with its history
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+// the tone mapped frame, the scene's depth and the result
+// of the last frame
+uniform sampler2D input0;
+uniform sampler2D input1;
+uniform sampler2D input2;
+// from this frame's clip space to the last frame's, and
+// how much of the last frame is kept - zero without one
+uniform mat4 reprojection;
+uniform float historyWeight;
+
+void main()
+{
+	vec2 uv = fragmentTextureCoordinate;
+	vec3 current = texture(input0, uv).rgb;
+
+	// where this pixel's surface was in the last frame
+	float depth = texture(input1, uv).r;
+	vec4 previous = reprojection * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	vec2 previousUV = (previous.xy / previous.w) * 0.5 + 0.5;
+
+	// the history is clamped to the colors around the pixel
+	// now, which throws out what the last frame saw there
+	// that is no longer in view
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	ivec2 size = textureSize(input0, 0);
+	vec3 lowest = current;
+	vec3 highest = current;
+	for (int y = -1; y <= 1; y++)
+	{
+		for (int x = -1; x <= 1; x++)
+		{
+			vec3 neighbor = texelFetch(input0, clamp(pixel + ivec2(x, y), ivec2(0), size - 1), 0).rgb;
+			lowest = min(lowest, neighbor);
+			highest = max(highest, neighbor);
+		}
+	}
+	vec3 history = clamp(texture(input2, previousUV).rgb, lowest, highest);
+
+	float weight = historyWeight;
+	if (any(lessThan(previousUV, vec2(0.0))) || any(greaterThan(previousUV, vec2(1.0))))
+	{
+		weight = 0.0;
+	}
+	outputColor = vec4(mix(current, history, weight), 1.0);
+}
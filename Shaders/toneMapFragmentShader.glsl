@@ -0,0 +1,50 @@
+///////////////////////////////////////////////////////////////////////////////
+// tonemapfragmentshader.glsl
+// ============
+// tone mapping fragment shader - maps the exposed scene with bloom to the display
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 outputColor;
+
+// the scene's color, the bloom chain and the exposure
+uniform sampler2D input0;
+uniform sampler2D input1;
+uniform sampler2D input2;
+// share of the bloom in the result, and the scale bringing
+// the added levels of the chain back to the scene's range
+uniform float bloomStrength;
+uniform float bloomScale;
+
+// the ACES reference rendering and output transforms, as
+// fitted by Stephen Hill, with the sRGB primaries moved to
+// those of ACES and back
+const mat3 INPUT_MATRIX = mat3(
+	0.59719, 0.07600, 0.02840,
+	0.35458, 0.90834, 0.13383,
+	0.04823, 0.01566, 0.83777);
+const mat3 OUTPUT_MATRIX = mat3(
+	1.60475, -0.10208, -0.00327,
+	-0.53108, 1.10813, -0.07276,
+	-0.07367, -0.00605, 1.07602);
+
+vec3 ToneMapACES(vec3 color)
+{
+	color = INPUT_MATRIX * color;
+	vec3 a = color * (color + 0.0245786) - 0.000090537;
+	vec3 b = color * (0.983729 * color + 0.4329510) + 0.238081;
+	return(clamp(OUTPUT_MATRIX * (a / b), 0.0, 1.0));
+}
+
+void main()
+{
+	vec3 color = texture(input0, fragmentTextureCoordinate).rgb;
+	vec3 bloom = texture(input1, fragmentTextureCoordinate).rgb * bloomScale;
+	color = mix(color, bloom, bloomStrength);
+	color *= texelFetch(input2, ivec2(0), 0).r;
+	outputColor = vec4(ToneMapACES(color), 1.0);
+}
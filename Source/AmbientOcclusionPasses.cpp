@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////
+// ambientocclusionpasses.cpp
+// ============
+// screen space ambient occlusion passes of the post-processing chain
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AmbientOcclusionPasses.h"
+#include "BlueNoise.h"
+
+#include <iostream>
+#include <vector>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// distance around a point the occlusion searches, about
+	// the height of the keyboard and mouse, and how dark a
+	// point in full cover gets
+	const float g_Radius = 0.3f;
+	const float g_Intensity = 1.2f;
+	// side of the blue noise tile, and the texture slot it
+	// takes past the inputs of the passes
+	const int g_NoiseSize = 32;
+	const int g_NoiseSlot = 14;
+}
+
+/***********************************************************
+ *  AmbientOcclusionPasses()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+AmbientOcclusionPasses::AmbientOcclusionPasses(RenderBackend* pBackend)
+{
+	m_pBackend = pBackend;
+	m_occlusionProgram = 0;
+	m_blurProgram = 0;
+	m_compositeProgram = 0;
+	m_noiseTexture = 0;
+	m_projection = glm::mat4(1.0f);
+}
+
+/***********************************************************
+ *  ~AmbientOcclusionPasses()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+AmbientOcclusionPasses::~AmbientOcclusionPasses()
+{
+	if (0 != m_noiseTexture)
+	{
+		m_pBackend->DestroyTexture(m_noiseTexture);
+		m_noiseTexture = 0;
+	}
+	m_pBackend = NULL;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for loading the programs of the
+ *  passes, which all draw the triangle covering the frame,
+ *  and making the blue noise tile that turns the samples,
+ *  two values a pixel from different dimensions.
+ ***********************************************************/
+bool AmbientOcclusionPasses::Create()
+{
+	const char* vertexFilename = "Shaders/fullscreenVertexShader.glsl";
+	m_occlusionProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/ssaoFragmentShader.glsl");
+	m_blurProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/bilateralBlurFragmentShader.glsl");
+	m_compositeProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/ssaoCompositeFragmentShader.glsl");
+	if ((0 == m_occlusionProgram) || (0 == m_blurProgram) || (0 == m_compositeProgram))
+	{
+		std::cout << "Could not load the ambient occlusion shaders" << std::endl;
+		return(false);
+	}
+
+	BlueNoise blueNoise;
+	blueNoise.Generate(g_NoiseSize);
+	std::vector<unsigned char> pixels(g_NoiseSize * g_NoiseSize * 4, 0);
+	for (int y = 0; y < g_NoiseSize; y++)
+	{
+		for (int x = 0; x < g_NoiseSize; x++)
+		{
+			unsigned char* pPixel = &pixels[(y * g_NoiseSize + x) * 4];
+			pPixel[0] = static_cast<unsigned char>(blueNoise.Sample(x, y, 0, 0) * 255.0f);
+			pPixel[1] = static_cast<unsigned char>(blueNoise.Sample(x, y, 1, 0) * 255.0f);
+			pPixel[3] = 255;
+		}
+	}
+	m_noiseTexture = m_pBackend->CreateTexture(g_NoiseSize, g_NoiseSize, 4, &pixels[0]);
+	return(0 != m_noiseTexture);
+}
+
+/***********************************************************
+ *  SetProjection()
+ *
+ *  This method is used for keeping the projection the
+ *  scene is drawn with this frame, which the passes turn
+ *  its depth back into positions with.
+ ***********************************************************/
+void AmbientOcclusionPasses::SetProjection(const glm::mat4& projection)
+{
+	m_projection = projection;
+}
+
+/***********************************************************
+ *  AddPasses()
+ *
+ *  This method is used for adding the passes to a chain,
+ *  reading the passed output and its depth, and returning
+ *  the output holding the darkened scene.
+ ***********************************************************/
+std::string AmbientOcclusionPasses::AddPasses(PostProcessChain* pChain, const std::string& scene)
+{
+	POST_PROCESS_PASS pass;
+	pass.width = 0;
+	pass.height = 0;
+
+	pass.name = "ssao";
+	pass.program = m_occlusionProgram;
+	pass.inputs.assign(1, scene + ".depth");
+	pass.output = "ssao";
+	pass.format = RENDER_TARGET_RGBA16F;
+	pass.scale = 0.5f;
+	pass.setUniforms = [this](RenderBackend* pBackend)
+	{
+		pBackend->SetUniformMat4("projection", m_projection);
+		pBackend->SetUniformMat4("inverseProjection", glm::inverse(m_projection));
+		pBackend->SetUniformFloat("radius", g_Radius);
+		pBackend->SetUniformFloat("intensity", g_Intensity);
+		pBackend->BindTexture(g_NoiseSlot, m_noiseTexture);
+		pBackend->SetUniformSampler("noise", g_NoiseSlot);
+	};
+	pChain->AddPass(pass);
+
+	pass.name = "ssao blur across";
+	pass.program = m_blurProgram;
+	pass.inputs.assign(1, "ssao");
+	pass.output = "ssaoAcross";
+	pass.setUniforms = [](RenderBackend* pBackend)
+	{
+		pBackend->SetUniformVec2("direction", glm::vec2(1.0f, 0.0f));
+	};
+	pChain->AddPass(pass);
+
+	pass.name = "ssao blur down";
+	pass.inputs.assign(1, "ssaoAcross");
+	pass.output = "ssaoBlurred";
+	pass.setUniforms = [](RenderBackend* pBackend)
+	{
+		pBackend->SetUniformVec2("direction", glm::vec2(0.0f, 1.0f));
+	};
+	pChain->AddPass(pass);
+
+	pass.name = "ssao composite";
+	pass.program = m_compositeProgram;
+	pass.inputs.assign(1, scene);
+	pass.inputs.push_back(scene + ".depth");
+	pass.inputs.push_back("ssaoBlurred");
+	pass.output = "sceneOccluded";
+	pass.scale = 1.0f;
+	pass.setUniforms = [this](RenderBackend* pBackend)
+	{
+		pBackend->SetUniformMat4("inverseProjection", glm::inverse(m_projection));
+	};
+	pChain->AddPass(pass);
+	return(pass.output);
+}
@@ -0,0 +1,52 @@
+///////////////////////////////////////////////////////////////////////////////
+// ambientocclusionpasses.h
+// ============
+// screen space ambient occlusion passes of the post-processing chain
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "PostProcessChain.h"
+#include "RenderBackend.h"
+
+#include <string>
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  AmbientOcclusionPasses
+ *
+ *  This class holds the programs and the blue noise tile
+ *  of the ambient occlusion, and adds its passes to a
+ *  chain: the occlusion worked out at half size from the
+ *  scene's depth, blurred across and down without crossing
+ *  edges in depth, and upsampled the same way onto the
+ *  scene the later passes read.
+ ***********************************************************/
+class AmbientOcclusionPasses
+{
+public:
+	// constructor
+	AmbientOcclusionPasses(RenderBackend* pBackend);
+	// destructor
+	~AmbientOcclusionPasses();
+
+	// make the programs and the blue noise tile
+	bool Create();
+
+	// the projection the scene is drawn with this frame
+	void SetProjection(const glm::mat4& projection);
+	// add the passes darkening the passed output of the chain,
+	// which has depth - returns the output they write
+	std::string AddPasses(PostProcessChain* pChain, const std::string& scene);
+
+private:
+	RenderBackend* m_pBackend;
+	uint32_t m_occlusionProgram;
+	uint32_t m_blurProgram;
+	uint32_t m_compositeProgram;
+	// blue noise turning the samples
+	uint32_t m_noiseTexture;
+	glm::mat4 m_projection;
+};
@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////
+// antialiasing.cpp
+// ============
+// anti-aliasing modes and the jitter of the temporal one
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AntiAliasing.h"
+
+// declaration of the global variables and helpers
+namespace
+{
+	// frames before the jitter repeats - enough positions to
+	// cover the pixel evenly, few enough that the history,
+	// which fades over about ten frames, sees them all
+	const unsigned int g_JitterPhases = 8;
+	// samples of the multisampled mode
+	const int g_MultisampleCount = 4;
+
+	/***********************************************************
+	 *  Halton()
+	 *
+	 *  This function is used for getting an element of the
+	 *  Halton sequence of a base, which spreads points evenly
+	 *  over zero to one in any prefix.
+	 ***********************************************************/
+	float Halton(unsigned int index, unsigned int base)
+	{
+		float fraction = 1.0f;
+		float result = 0.0f;
+		while (index > 0)
+		{
+			fraction /= static_cast<float>(base);
+			result += fraction * static_cast<float>(index % base);
+			index /= base;
+		}
+		return(result);
+	}
+}
+
+/***********************************************************
+ *  GetAntiAliasingName()
+ *
+ *  This function is used for getting the name of a mode.
+ ***********************************************************/
+const char* GetAntiAliasingName(ANTI_ALIASING mode)
+{
+	switch (mode)
+	{
+	case ANTI_ALIASING_FXAA:
+		return("FXAA");
+	case ANTI_ALIASING_SMAA:
+		return("SMAA 1x");
+	case ANTI_ALIASING_TAA:
+		return("TAA");
+	case ANTI_ALIASING_MSAA_4X:
+		return("MSAA 4x");
+	default:
+		return("off");
+	}
+}
+
+/***********************************************************
+ *  GetAntiAliasingSamples()
+ *
+ *  This function is used for getting the samples a pixel
+ *  of the scene is drawn with in a mode.
+ ***********************************************************/
+int GetAntiAliasingSamples(ANTI_ALIASING mode)
+{
+	return((ANTI_ALIASING_MSAA_4X == mode) ? g_MultisampleCount : 1);
+}
+
+/***********************************************************
+ *  GetTemporalJitter()
+ *
+ *  This function is used for getting the offset of the
+ *  projection in a frame, from the Halton sequences of two
+ *  and three, starting at their second element since the
+ *  first is zero in both.
+ ***********************************************************/
+glm::vec2 GetTemporalJitter(unsigned int frame)
+{
+	unsigned int index = (frame % g_JitterPhases) + 1;
+	return(glm::vec2(Halton(index, 2) - 0.5f, Halton(index, 3) - 0.5f));
+}
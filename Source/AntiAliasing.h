@@ -0,0 +1,36 @@
+///////////////////////////////////////////////////////////////////////////////
+// antialiasing.h
+// ============
+// anti-aliasing modes and the jitter of the temporal one
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  ANTI_ALIASING
+ *
+ *  How the edges of the frame are smoothed.  FXAA and SMAA
+ *  filter the tone mapped frame, TAA blends it with the
+ *  frames before it, drawn with a jittered projection, and
+ *  MSAA draws the scene with four samples a pixel.
+ ***********************************************************/
+enum ANTI_ALIASING
+{
+	ANTI_ALIASING_NONE,
+	ANTI_ALIASING_FXAA,
+	ANTI_ALIASING_SMAA,
+	ANTI_ALIASING_TAA,
+	ANTI_ALIASING_MSAA_4X,
+	ANTI_ALIASING_COUNT
+};
+
+// name of a mode, for the console and the benchmark
+const char* GetAntiAliasingName(ANTI_ALIASING mode);
+// samples a pixel of the scene needs in a mode
+int GetAntiAliasingSamples(ANTI_ALIASING mode);
+// offset of the projection in a frame of the temporal mode,
+// in pixels within half a pixel of the center
+glm::vec2 GetTemporalJitter(unsigned int frame);
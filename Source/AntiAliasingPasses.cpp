@@ -0,0 +1,216 @@
+///////////////////////////////////////////////////////////////////////////////
+// antialiasingpasses.cpp
+// ============
+// anti-aliasing passes of the post-processing chain
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AntiAliasingPasses.h"
+
+#include <iostream>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// share of the last frame TAA keeps
+	const float g_HistoryWeight = 0.9f;
+}
+
+/***********************************************************
+ *  AntiAliasingPasses()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+AntiAliasingPasses::AntiAliasingPasses(RenderBackend* pBackend) :
+	m_history(pBackend, RENDER_TARGET_RGBA16F, false)
+{
+	m_pBackend = pBackend;
+	m_fxaaProgram = 0;
+	m_smaaEdgesProgram = 0;
+	m_smaaWeightsProgram = 0;
+	m_smaaBlendProgram = 0;
+	m_taaProgram = 0;
+	m_copyProgram = 0;
+	m_viewProjection = glm::mat4(1.0f);
+}
+
+/***********************************************************
+ *  ~AntiAliasingPasses()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+AntiAliasingPasses::~AntiAliasingPasses()
+{
+	m_pBackend = NULL;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for loading the programs of the
+ *  passes, which all draw the triangle covering the frame.
+ ***********************************************************/
+bool AntiAliasingPasses::Create()
+{
+	const char* vertexFilename = "Shaders/fullscreenVertexShader.glsl";
+	m_fxaaProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/fxaaFragmentShader.glsl");
+	m_smaaEdgesProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/smaaEdgeFragmentShader.glsl");
+	m_smaaWeightsProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/smaaWeightFragmentShader.glsl");
+	m_smaaBlendProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/smaaBlendFragmentShader.glsl");
+	m_taaProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/taaFragmentShader.glsl");
+	m_copyProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/copyFragmentShader.glsl");
+	if ((0 == m_fxaaProgram) || (0 == m_smaaEdgesProgram) || (0 == m_smaaWeightsProgram) ||
+		(0 == m_smaaBlendProgram) || (0 == m_taaProgram) || (0 == m_copyProgram))
+	{
+		std::cout << "Could not load the anti-aliasing shaders" << std::endl;
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  HasPasses()
+ *
+ *  This method is used for checking whether a mode adds
+ *  passes after the tone mapping, which then has to draw
+ *  into a target they read.
+ ***********************************************************/
+bool AntiAliasingPasses::HasPasses(ANTI_ALIASING mode) const
+{
+	return((ANTI_ALIASING_NONE != mode) && (ANTI_ALIASING_MSAA_4X != mode));
+}
+
+/***********************************************************
+ *  SetCamera()
+ *
+ *  This method is used for keeping the view and projection
+ *  the scene is drawn with this frame, which TAA finds the
+ *  last frame's pixels with.
+ ***********************************************************/
+void AntiAliasingPasses::SetCamera(const glm::mat4& viewProjection)
+{
+	m_viewProjection = viewProjection;
+}
+
+/***********************************************************
+ *  AddPasses()
+ *
+ *  This method is used for adding the passes of a mode to
+ *  a chain, reading the passed output and drawing into the
+ *  window.
+ ***********************************************************/
+void AntiAliasingPasses::AddPasses(PostProcessChain* pChain, ANTI_ALIASING mode, const std::string& input)
+{
+	POST_PROCESS_PASS pass;
+	pass.format = RENDER_TARGET_RGBA8;
+	pass.scale = 1.0f;
+	pass.width = 0;
+	pass.height = 0;
+
+	if (ANTI_ALIASING_FXAA == mode)
+	{
+		pass.name = "fxaa";
+		pass.program = m_fxaaProgram;
+		pass.inputs.assign(1, input);
+		pass.output.clear();
+		pChain->AddPass(pass);
+	}
+	else if (ANTI_ALIASING_SMAA == mode)
+	{
+		pass.name = "smaa edges";
+		pass.program = m_smaaEdgesProgram;
+		pass.inputs.assign(1, input);
+		pass.output = "smaaEdges";
+		pChain->AddPass(pass);
+
+		pass.name = "smaa weights";
+		pass.program = m_smaaWeightsProgram;
+		pass.inputs.assign(1, "smaaEdges");
+		pass.output = "smaaWeights";
+		pChain->AddPass(pass);
+
+		pass.name = "smaa blend";
+		pass.program = m_smaaBlendProgram;
+		pass.inputs.assign(1, input);
+		pass.inputs.push_back("smaaWeights");
+		pass.output.clear();
+		pChain->AddPass(pass);
+	}
+	else if (ANTI_ALIASING_TAA == mode)
+	{
+		pass.name = "taa";
+		pass.program = m_taaProgram;
+		pass.inputs.assign(1, input);
+		pass.inputs.push_back("scene.depth");
+		pass.inputs.push_back("history");
+		pass.output = "taa";
+		pass.setUniforms = [this](RenderBackend* pBackend)
+		{
+			pBackend->SetUniformMat4("reprojection", m_history.GetReprojection(m_viewProjection));
+			pBackend->SetUniformFloat("historyWeight", m_history.HasHistory() ? g_HistoryWeight : 0.0f);
+		};
+		pChain->AddPass(pass);
+		pass.setUniforms = nullptr;
+
+		pass.name = "present";
+		pass.program = m_copyProgram;
+		pass.inputs.assign(1, "taa");
+		pass.output.clear();
+		pChain->AddPass(pass);
+	}
+}
+
+/***********************************************************
+ *  ImportTargets()
+ *
+ *  This method is used for putting the history targets in
+ *  place of the transient ones the chain declared for the
+ *  TAA passes.  They swap every frame, so they are
+ *  imported again each one.
+ ***********************************************************/
+void AntiAliasingPasses::ImportTargets(FrameGraph* pGraph)
+{
+	pGraph->ImportTarget("history", m_history.GetHistoryTarget());
+	pGraph->ImportTarget("taa", m_history.GetCurrentTarget());
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for making the history targets for
+ *  a frame drawn with TAA and putting them in the graph.
+ *  Any other frame leaves the history stale, so it is
+ *  dropped.
+ ***********************************************************/
+bool AntiAliasingPasses::BeginFrame(FrameGraph* pGraph, bool bTemporal, int width, int height)
+{
+	if (bTemporal && m_history.BeginFrame(width, height))
+	{
+		ImportTargets(pGraph);
+		return(true);
+	}
+	m_history.Invalidate();
+	return(false);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for keeping the frame just drawn,
+ *  with the camera it was drawn with, for the next one.
+ ***********************************************************/
+void AntiAliasingPasses::EndFrame(const glm::mat4& viewProjection)
+{
+	m_history.EndFrame(viewProjection);
+}
+
+/***********************************************************
+ *  GetHistoryBytes()
+ *
+ *  This method is used for estimating the memory of the
+ *  history targets.
+ ***********************************************************/
+size_t AntiAliasingPasses::GetHistoryBytes() const
+{
+	return(m_history.GetBytes());
+}
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// antialiasingpasses.h
+// ============
+// anti-aliasing passes of the post-processing chain
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "AntiAliasing.h"
+#include "FrameGraph.h"
+#include "PostProcessChain.h"
+#include "RenderBackend.h"
+#include "TemporalHistory.h"
+
+#include <cstddef>
+#include <string>
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  AntiAliasingPasses
+ *
+ *  This class holds the programs of the anti-aliasing
+ *  modes that work on the tone mapped frame, and the
+ *  history of the temporal one, and adds the passes of a
+ *  mode to a chain.  FXAA and SMAA filter the frame on its
+ *  way to the window, and TAA blends it into the history,
+ *  which is copied to the window.  MSAA needs no pass, the
+ *  scene target's samples being resolved when the scene is
+ *  done.
+ ***********************************************************/
+class AntiAliasingPasses
+{
+public:
+	// constructor
+	AntiAliasingPasses(RenderBackend* pBackend);
+	// destructor
+	~AntiAliasingPasses();
+
+	// make the programs
+	bool Create();
+
+	// whether a mode has passes, which read the tone mapped
+	// frame from a target instead of the window
+	bool HasPasses(ANTI_ALIASING mode) const;
+	// the camera the scene is drawn with this frame
+	void SetCamera(const glm::mat4& viewProjection);
+	// add the passes of a mode reading the passed output
+	void AddPasses(PostProcessChain* pChain, ANTI_ALIASING mode, const std::string& input);
+	// put the history targets in place of the transient ones
+	// the chain declared for TAA
+	void ImportTargets(FrameGraph* pGraph);
+
+	// keep the history through a frame drawn with TAA, or
+	// drop it - returns whether it is kept
+	bool BeginFrame(FrameGraph* pGraph, bool bTemporal, int width, int height);
+	// keep the frame drawn as the history of the next one
+	void EndFrame(const glm::mat4& viewProjection);
+	// estimated memory of the history
+	size_t GetHistoryBytes() const;
+
+private:
+	RenderBackend* m_pBackend;
+	uint32_t m_fxaaProgram;
+	uint32_t m_smaaEdgesProgram;
+	uint32_t m_smaaWeightsProgram;
+	uint32_t m_smaaBlendProgram;
+	uint32_t m_taaProgram;
+	uint32_t m_copyProgram;
+	// the last frame, blended in by TAA
+	TemporalHistory m_history;
+	glm::mat4 m_viewProjection;
+};
@@ -0,0 +1,305 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmark.cpp
+// ============
+// time small pieces of code and report them like Google Benchmark
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// most iterations a benchmark is run with
+	const size_t g_MaxIterations = 1000000000;
+	// most the iterations grow by between runs
+	const double g_MaxGrowth = 10.0;
+
+	/***********************************************************
+	 *  WriteJSONString()
+	 *
+	 *  This function is used for writing a string as a JSON
+	 *  string, escaping quotes and backslashes.
+	 ***********************************************************/
+	void WriteJSONString(std::ostream& out, const std::string& text)
+	{
+		out << "\"";
+		for (size_t i = 0; i < text.size(); i++)
+		{
+			if ((text[i] == '"') || (text[i] == '\\'))
+			{
+				out << "\\";
+			}
+			out << text[i];
+		}
+		out << "\"";
+	}
+}
+
+/***********************************************************
+ *  BenchmarkState()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+BenchmarkState::BenchmarkState(size_t iterations)
+{
+	m_iterations = iterations;
+	m_remaining = iterations;
+	m_bStarted = false;
+	m_cpuStart = 0;
+	m_realSeconds = 0.0;
+	m_cpuSeconds = 0.0;
+}
+
+/***********************************************************
+ *  KeepRunning()
+ *
+ *  This method is used for counting down the iterations,
+ *  starting the timer on the first call and stopping it
+ *  after the last iteration.
+ ***********************************************************/
+bool BenchmarkState::KeepRunning()
+{
+	if (!m_bStarted)
+	{
+		m_bStarted = true;
+		m_cpuStart = std::clock();
+		m_realStart = std::chrono::steady_clock::now();
+	}
+
+	if (m_remaining > 0)
+	{
+		m_remaining--;
+		return(true);
+	}
+
+	std::chrono::steady_clock::time_point realEnd = std::chrono::steady_clock::now();
+	std::clock_t cpuEnd = std::clock();
+	m_realSeconds = std::chrono::duration<double>(realEnd - m_realStart).count();
+	m_cpuSeconds = static_cast<double>(cpuEnd - m_cpuStart) / CLOCKS_PER_SEC;
+	return(false);
+}
+
+/***********************************************************
+ *  GetIterations()
+ *
+ *  This method is used for getting the number of iterations
+ *  the loop runs.
+ ***********************************************************/
+size_t BenchmarkState::GetIterations() const
+{
+	return(m_iterations);
+}
+
+/***********************************************************
+ *  GetRealSeconds()
+ *
+ *  This method is used for getting the wall clock time of
+ *  the iterations.
+ ***********************************************************/
+double BenchmarkState::GetRealSeconds() const
+{
+	return(m_realSeconds);
+}
+
+/***********************************************************
+ *  GetCPUSeconds()
+ *
+ *  This method is used for getting the processor time of
+ *  the iterations.
+ ***********************************************************/
+double BenchmarkState::GetCPUSeconds() const
+{
+	return(m_cpuSeconds);
+}
+
+/***********************************************************
+ *  BenchmarkSuite()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+BenchmarkSuite::BenchmarkSuite(double minSeconds, size_t repetitions)
+{
+	m_minSeconds = minSeconds;
+	m_repetitions = std::max<size_t>(repetitions, 1);
+}
+
+/***********************************************************
+ *  Register()
+ *
+ *  This method is used for adding a benchmark to the suite.
+ ***********************************************************/
+void BenchmarkSuite::Register(const std::string& name, const BENCHMARK_FUNCTION& function)
+{
+	BENCHMARK_ENTRY benchmark;
+	benchmark.name = name;
+	benchmark.function = function;
+	m_benchmarks.push_back(benchmark);
+}
+
+/***********************************************************
+ *  RunBenchmark()
+ *
+ *  This method is used for timing one run of a benchmark.
+ ***********************************************************/
+BENCHMARK_RESULT BenchmarkSuite::RunBenchmark(const BENCHMARK_ENTRY& benchmark, size_t iterations, size_t repetition)
+{
+	BenchmarkState state(iterations);
+	benchmark.function(state);
+
+	BENCHMARK_RESULT result;
+	result.name = benchmark.name;
+	result.repetition = repetition;
+	result.iterations = iterations;
+	result.realNanoseconds = state.GetRealSeconds() * 1.0e9 / iterations;
+	result.cpuNanoseconds = state.GetCPUSeconds() * 1.0e9 / iterations;
+	return(result);
+}
+
+/***********************************************************
+ *  FindIterations()
+ *
+ *  This method is used for finding how many iterations a
+ *  run needs.  Like Google Benchmark it starts with one
+ *  iteration and grows the count from the last run's time
+ *  until a run lasts at least the minimum time.
+ ***********************************************************/
+size_t BenchmarkSuite::FindIterations(const BENCHMARK_ENTRY& benchmark)
+{
+	size_t iterations = 1;
+
+	for (;;)
+	{
+		BenchmarkState state(iterations);
+		benchmark.function(state);
+
+		double seconds = state.GetRealSeconds();
+		if ((seconds >= m_minSeconds) || (iterations >= g_MaxIterations))
+		{
+			break;
+		}
+
+		// aim 40% past the minimum so the next run is long
+		// enough, and grow tenfold when the run was too short
+		// to say anything
+		double growth = g_MaxGrowth;
+		if (seconds > m_minSeconds / g_MaxGrowth)
+		{
+			growth = std::min(g_MaxGrowth, 1.4 * m_minSeconds / seconds);
+		}
+		size_t nextIterations = static_cast<size_t>(iterations * growth + 0.5);
+		iterations = std::min(g_MaxIterations, std::max(nextIterations, iterations + 1));
+	}
+
+	return(iterations);
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for running the benchmarks whose
+ *  name contains the filter and printing a line for each
+ *  run.  The run that found the iteration count is not
+ *  reported, so it also warms the caches up.
+ ***********************************************************/
+size_t BenchmarkSuite::Run(const char* filter)
+{
+	m_results.clear();
+
+	std::cout << std::left << std::setw(48) << "Benchmark" << std::right
+		<< std::setw(16) << "Time" << std::setw(16) << "CPU" << std::setw(14) << "Iterations" << std::endl;
+	std::cout << std::string(94, '-') << std::endl;
+
+	for (size_t i = 0; i < m_benchmarks.size(); i++)
+	{
+		const BENCHMARK_ENTRY& benchmark = m_benchmarks[i];
+		if ((NULL != filter) && (std::string::npos == benchmark.name.find(filter)))
+		{
+			continue;
+		}
+
+		size_t iterations = FindIterations(benchmark);
+		for (size_t repetition = 0; repetition < m_repetitions; repetition++)
+		{
+			BENCHMARK_RESULT result = RunBenchmark(benchmark, iterations, repetition);
+			m_results.push_back(result);
+
+			std::cout << std::left << std::setw(48) << result.name << std::right << std::fixed << std::setprecision(1)
+				<< std::setw(13) << result.realNanoseconds << " ns"
+				<< std::setw(13) << result.cpuNanoseconds << " ns"
+				<< std::setw(14) << result.iterations << std::endl;
+		}
+	}
+	std::cout.unsetf(std::ios::fixed);
+
+	return(m_results.size() / m_repetitions);
+}
+
+/***********************************************************
+ *  GetResults()
+ *
+ *  This method is used for getting the results of the last
+ *  Run() call.
+ ***********************************************************/
+const std::vector<BENCHMARK_RESULT>& BenchmarkSuite::GetResults() const
+{
+	return(m_results);
+}
+
+/***********************************************************
+ *  SaveJSON()
+ *
+ *  This method is used for writing the results in the JSON
+ *  layout Google Benchmark writes with
+ *  --benchmark_format=json.
+ ***********************************************************/
+bool BenchmarkSuite::SaveJSON(const char* filename) const
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not write benchmark results:" << filename << std::endl;
+		return(false);
+	}
+
+	std::time_t now = std::time(NULL);
+	char date[32] = { 0 };
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+	file << "{\n  \"context\": {\n";
+	file << "    \"date\": \"" << date << "\",\n";
+	file << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+	file << "    \"library_build_type\": \"release\"\n";
+#else
+	file << "    \"library_build_type\": \"debug\"\n";
+#endif
+	file << "  },\n  \"benchmarks\": [\n";
+
+	file << std::setprecision(10);
+	for (size_t i = 0; i < m_results.size(); i++)
+	{
+		const BENCHMARK_RESULT& result = m_results[i];
+		file << "    {\n      \"name\": ";
+		WriteJSONString(file, result.name);
+		file << ",\n      \"run_name\": ";
+		WriteJSONString(file, result.name);
+		file << ",\n      \"run_type\": \"iteration\",\n";
+		file << "      \"repetitions\": " << m_repetitions << ",\n";
+		file << "      \"repetition_index\": " << result.repetition << ",\n";
+		file << "      \"iterations\": " << result.iterations << ",\n";
+		file << "      \"real_time\": " << result.realNanoseconds << ",\n";
+		file << "      \"cpu_time\": " << result.cpuNanoseconds << ",\n";
+		file << "      \"time_unit\": \"ns\"\n    }";
+		file << (((i + 1) < m_results.size()) ? ",\n" : "\n");
+	}
+	file << "  ]\n}\n";
+
+	return(file.good());
+}
@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmark.h
+// ============
+// time small pieces of code and report them like Google Benchmark
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/***********************************************************
+ *  BenchmarkState
+ *
+ *  What a benchmark function loops on.  The timer starts
+ *  at the first KeepRunning() call, so the set up before
+ *  the loop is not measured, and stops when the asked
+ *  number of iterations is done:
+ *
+ *      while (state.KeepRunning())
+ *      {
+ *          DoNotOptimize(FunctionBeingTimed());
+ *      }
+ ***********************************************************/
+class BenchmarkState
+{
+public:
+	// constructor
+	BenchmarkState(size_t iterations);
+
+	// true while iterations remain
+	bool KeepRunning();
+	size_t GetIterations() const;
+
+	// time of the iterations, valid once the loop is over
+	double GetRealSeconds() const;
+	double GetCPUSeconds() const;
+
+private:
+	size_t m_iterations;
+	size_t m_remaining;
+	bool m_bStarted;
+	std::chrono::steady_clock::time_point m_realStart;
+	std::clock_t m_cpuStart;
+	double m_realSeconds;
+	double m_cpuSeconds;
+};
+
+/***********************************************************
+ *  DoNotOptimize()
+ *
+ *  This function is used for keeping the compiler from
+ *  removing the computation of a value nothing else reads.
+ ***********************************************************/
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+	volatile const void* pSink = &value;
+	(void)pSink;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// a benchmark - loops on the state it is passed
+typedef std::function<void(BenchmarkState&)> BENCHMARK_FUNCTION;
+
+/***********************************************************
+ *  BENCHMARK_RESULT
+ *
+ *  Time per iteration of one run of a benchmark.
+ ***********************************************************/
+struct BENCHMARK_RESULT
+{
+	std::string name;
+	// which of the repeated runs this is, from zero
+	size_t repetition;
+	size_t iterations;
+	double realNanoseconds;
+	double cpuNanoseconds;
+};
+
+/***********************************************************
+ *  BenchmarkSuite
+ *
+ *  This class keeps a list of named benchmarks and runs
+ *  them the way Google Benchmark does: each one is run with
+ *  a growing number of iterations until a run lasts long
+ *  enough to trust, and that run is reported.  Asking for
+ *  repetitions runs it that many more times with the same
+ *  iterations, giving a set of samples that statistics can
+ *  compare between builds.  The results are printed as a
+ *  table and can be saved in Google Benchmark's JSON
+ *  format, so its compare.py and other tools read them.
+ ***********************************************************/
+class BenchmarkSuite
+{
+public:
+	// constructor - runs shorter than minSeconds are repeated
+	// with more iterations, and every benchmark is reported
+	// for the asked number of repetitions
+	BenchmarkSuite(double minSeconds = 0.5, size_t repetitions = 1);
+
+	void Register(const std::string& name, const BENCHMARK_FUNCTION& function);
+
+	// run the benchmarks whose name contains the filter, or
+	// all of them for NULL - returns the number run
+	size_t Run(const char* filter);
+	const std::vector<BENCHMARK_RESULT>& GetResults() const;
+
+	// write the results as Google Benchmark JSON
+	bool SaveJSON(const char* filename) const;
+
+private:
+	struct BENCHMARK_ENTRY
+	{
+		std::string name;
+		BENCHMARK_FUNCTION function;
+	};
+
+	std::vector<BENCHMARK_ENTRY> m_benchmarks;
+	std::vector<BENCHMARK_RESULT> m_results;
+	double m_minSeconds;
+	size_t m_repetitions;
+
+	// find the iterations one run of a benchmark needs
+	size_t FindIterations(const BENCHMARK_ENTRY& benchmark);
+	// time one run of a benchmark
+	BENCHMARK_RESULT RunBenchmark(const BENCHMARK_ENTRY& benchmark, size_t iterations, size_t repetition);
+};
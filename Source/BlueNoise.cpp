@@ -0,0 +1,229 @@
+///////////////////////////////////////////////////////////////////////////////
+// bluenoise.cpp
+// ============
+// tileable blue noise for spreading random samples evenly over the screen
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BlueNoise.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// width of the filter that measures how crowded a pixel's
+	// neighborhood is
+	const float g_FilterSigma = 1.5f;
+	// share of the pixels set in the starting pattern
+	const float g_InitialDensity = 0.1f;
+
+	/***********************************************************
+	 *  ENERGY_FIELD
+	 *
+	 *  The set pixels of a binary pattern and, per pixel, the
+	 *  sum of the gaussian filter over the set pixels around
+	 *  it, wrapping at the edges.
+	 ***********************************************************/
+	struct ENERGY_FIELD
+	{
+		int size;
+		std::vector<float> kernel;
+		std::vector<char> pattern;
+		std::vector<float> energy;
+	};
+
+	/***********************************************************
+	 *  TogglePixel()
+	 *
+	 *  Set or clear one pixel of the pattern and update the
+	 *  energy of every pixel.
+	 ***********************************************************/
+	void TogglePixel(ENERGY_FIELD& field, int index, bool bSet)
+	{
+		field.pattern[index] = bSet ? 1 : 0;
+		float sign = bSet ? 1.0f : -1.0f;
+		int px = index % field.size;
+		int py = index / field.size;
+		for (int y = 0; y < field.size; y++)
+		{
+			int dy = (y - py + field.size) % field.size;
+			for (int x = 0; x < field.size; x++)
+			{
+				int dx = (x - px + field.size) % field.size;
+				field.energy[y * field.size + x] += sign * field.kernel[dy * field.size + dx];
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  FindTightestCluster()
+	 *
+	 *  Set pixel with the most set pixels close to it.
+	 ***********************************************************/
+	int FindTightestCluster(const ENERGY_FIELD& field)
+	{
+		int best = -1;
+		for (int i = 0; i < static_cast<int>(field.pattern.size()); i++)
+		{
+			if (field.pattern[i] && ((best < 0) || (field.energy[i] > field.energy[best])))
+			{
+				best = i;
+			}
+		}
+		return(best);
+	}
+
+	/***********************************************************
+	 *  FindLargestVoid()
+	 *
+	 *  Clear pixel with the fewest set pixels close to it.
+	 ***********************************************************/
+	int FindLargestVoid(const ENERGY_FIELD& field)
+	{
+		int best = -1;
+		for (int i = 0; i < static_cast<int>(field.pattern.size()); i++)
+		{
+			if (!field.pattern[i] && ((best < 0) || (field.energy[i] < field.energy[best])))
+			{
+				best = i;
+			}
+		}
+		return(best);
+	}
+}
+
+/***********************************************************
+ *  BlueNoise()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+BlueNoise::BlueNoise()
+{
+	m_size = 0;
+}
+
+/***********************************************************
+ *  Generate()
+ *
+ *  This method is used for building the mask.  A random
+ *  starting pattern is relaxed until its most crowded set
+ *  pixel is also its emptiest spot.  The set pixels are
+ *  then ranked by removing the most crowded one each time,
+ *  and the rest by filling the emptiest spot each time, so
+ *  every prefix of the ranking is evenly spread.
+ ***********************************************************/
+void BlueNoise::Generate(int size)
+{
+	m_size = size;
+	int pixelCount = size * size;
+	m_values.assign(pixelCount, 0.0f);
+	if (pixelCount == 0)
+	{
+		return;
+	}
+
+	ENERGY_FIELD field;
+	field.size = size;
+	field.kernel.resize(pixelCount);
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			// shortest distance across the wrapped edges
+			float dx = static_cast<float>(std::min(x, size - x));
+			float dy = static_cast<float>(std::min(y, size - y));
+			field.kernel[y * size + x] = std::exp(-(dx * dx + dy * dy) / (2.0f * g_FilterSigma * g_FilterSigma));
+		}
+	}
+	field.pattern.assign(pixelCount, 0);
+	field.energy.assign(pixelCount, 0.0f);
+
+	// fixed seed, so every run makes the same mask
+	std::mt19937 random(1234u);
+	int initialCount = std::max(1, static_cast<int>(pixelCount * g_InitialDensity));
+	for (int placed = 0; placed < initialCount;)
+	{
+		int index = static_cast<int>(random() % pixelCount);
+		if (!field.pattern[index])
+		{
+			TogglePixel(field, index, true);
+			placed++;
+		}
+	}
+
+	for (;;)
+	{
+		int cluster = FindTightestCluster(field);
+		TogglePixel(field, cluster, false);
+		int gap = FindLargestVoid(field);
+		TogglePixel(field, gap, true);
+		if (gap == cluster)
+		{
+			break;
+		}
+	}
+
+	std::vector<int> ranks(pixelCount, 0);
+	ENERGY_FIELD start = field;
+	for (int rank = initialCount - 1; rank >= 0; rank--)
+	{
+		int cluster = FindTightestCluster(field);
+		TogglePixel(field, cluster, false);
+		ranks[cluster] = rank;
+	}
+
+	field = start;
+	for (int rank = initialCount; rank < pixelCount; rank++)
+	{
+		int gap = FindLargestVoid(field);
+		TogglePixel(field, gap, true);
+		ranks[gap] = rank;
+	}
+
+	for (int i = 0; i < pixelCount; i++)
+	{
+		m_values[i] = (ranks[i] + 0.5f) / pixelCount;
+	}
+}
+
+/***********************************************************
+ *  Sample()
+ *
+ *  This method is used for reading the mask.  Dimensions
+ *  are offset from each other along a two dimensional low
+ *  discrepancy sequence so they do not repeat the same
+ *  pattern.
+ ***********************************************************/
+float BlueNoise::Sample(int x, int y, int dimension, uint32_t frame) const
+{
+	if (m_size == 0)
+	{
+		return(0.5f);
+	}
+
+	const double plastic1 = 0.7548776662466927;
+	const double plastic2 = 0.5698402909980532;
+	const double golden = 0.6180339887498949;
+
+	double offsetX = dimension * plastic1;
+	double offsetY = dimension * plastic2;
+	int sampleX = (x + static_cast<int>((offsetX - std::floor(offsetX)) * m_size)) % m_size;
+	int sampleY = (y + static_cast<int>((offsetY - std::floor(offsetY)) * m_size)) % m_size;
+
+	double value = m_values[sampleY * m_size + sampleX] + frame * golden + dimension * plastic2;
+	// keep values just below one from rounding up to it
+	return(std::min(static_cast<float>(value - std::floor(value)), 0.99999994f));
+}
+
+/***********************************************************
+ *  GetSize()
+ *
+ *  This method is used for getting the width of the mask.
+ ***********************************************************/
+int BlueNoise::GetSize() const
+{
+	return(m_size);
+}
@@ -0,0 +1,41 @@
+///////////////////////////////////////////////////////////////////////////////
+// bluenoise.h
+// ============
+// tileable blue noise for spreading random samples evenly over the screen
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  BlueNoise
+ *
+ *  This class holds a square, tileable blue noise mask made
+ *  with the void and cluster method.  Neighboring pixels
+ *  get values far apart, so the error of a few samples per
+ *  pixel shows up as fine grain instead of blotches.  Each
+ *  sample dimension reads the mask at its own offset and
+ *  each frame shifts the values by the golden ratio, which
+ *  keeps the sequence per pixel well spread over time.
+ ***********************************************************/
+class BlueNoise
+{
+public:
+	// constructor
+	BlueNoise();
+
+	// build a mask of size by size pixels
+	void Generate(int size);
+
+	// value in [0, 1) for a pixel, sample dimension and frame
+	float Sample(int x, int y, int dimension, uint32_t frame) const;
+
+	int GetSize() const;
+
+private:
+	int m_size;
+	std::vector<float> m_values;
+};
@@ -0,0 +1,224 @@
+///////////////////////////////////////////////////////////////////////////////
+// buddyallocator.cpp
+// ============
+// hand out power of two ranges from one large block of memory
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BuddyAllocator.h"
+
+// declaration of the helpers
+namespace
+{
+	/***********************************************************
+	 *  RoundUpToPowerOfTwo()
+	 *
+	 *  Smallest power of two that is not below the value.
+	 ***********************************************************/
+	uint32_t RoundUpToPowerOfTwo(uint32_t value)
+	{
+		uint32_t result = 1;
+		while (result < value)
+		{
+			result <<= 1;
+		}
+		return(result);
+	}
+}
+
+/***********************************************************
+ *  BuddyAllocator()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+BuddyAllocator::BuddyAllocator()
+{
+	m_minBlockSize = 1;
+	m_maxOrder = 0;
+	m_usedSize = 0;
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for forgetting every allocation and
+ *  starting with one free block covering the whole range.
+ ***********************************************************/
+void BuddyAllocator::Reset(uint32_t capacity, uint32_t minBlockSize)
+{
+	m_minBlockSize = RoundUpToPowerOfTwo(minBlockSize);
+	capacity = RoundUpToPowerOfTwo(capacity < m_minBlockSize ? m_minBlockSize : capacity);
+
+	m_maxOrder = 0;
+	while ((m_minBlockSize << m_maxOrder) < capacity)
+	{
+		m_maxOrder++;
+	}
+
+	m_freeLists.assign(m_maxOrder + 1, std::set<uint32_t>());
+	m_freeLists[m_maxOrder].insert(0);
+	m_allocatedOrders.assign(capacity / m_minBlockSize, 0);
+	m_usedSize = 0;
+}
+
+/***********************************************************
+ *  Grow()
+ *
+ *  This method is used for doubling the managed range.  The
+ *  old range becomes the lower half of the new one, so the
+ *  existing offsets stay valid.
+ ***********************************************************/
+void BuddyAllocator::Grow()
+{
+	uint32_t capacity = GetCapacity();
+	m_freeLists.push_back(std::set<uint32_t>());
+
+	// a completely free range merges with the new half
+	if (m_freeLists[m_maxOrder].erase(0) > 0)
+	{
+		m_freeLists[m_maxOrder + 1].insert(0);
+	}
+	else
+	{
+		m_freeLists[m_maxOrder].insert(capacity);
+	}
+
+	m_maxOrder++;
+	m_allocatedOrders.resize(GetCapacity() / m_minBlockSize, 0);
+}
+
+/***********************************************************
+ *  Allocate()
+ *
+ *  This method is used for reserving a range of at least
+ *  size units.  The smallest free block that fits is split
+ *  in halves until it matches, preferring low offsets.
+ ***********************************************************/
+bool BuddyAllocator::Allocate(uint32_t size, uint32_t& offset)
+{
+	uint32_t order = GetOrder(size);
+	if (order > m_maxOrder)
+	{
+		return(false);
+	}
+
+	uint32_t freeOrder = order;
+	while ((freeOrder <= m_maxOrder) && m_freeLists[freeOrder].empty())
+	{
+		freeOrder++;
+	}
+	if (freeOrder > m_maxOrder)
+	{
+		return(false);
+	}
+
+	offset = *m_freeLists[freeOrder].begin();
+	m_freeLists[freeOrder].erase(m_freeLists[freeOrder].begin());
+
+	// hand the upper halves back until the block fits
+	while (freeOrder > order)
+	{
+		freeOrder--;
+		m_freeLists[freeOrder].insert(offset + (m_minBlockSize << freeOrder));
+	}
+
+	m_allocatedOrders[offset / m_minBlockSize] = static_cast<uint8_t>(order + 1);
+	m_usedSize += m_minBlockSize << order;
+	return(true);
+}
+
+/***********************************************************
+ *  Free()
+ *
+ *  This method is used for releasing a range and merging
+ *  it with its buddy for as long as the buddy is free.
+ ***********************************************************/
+void BuddyAllocator::Free(uint32_t offset)
+{
+	uint32_t block = offset / m_minBlockSize;
+	if ((block >= m_allocatedOrders.size()) || (m_allocatedOrders[block] == 0))
+	{
+		return;
+	}
+
+	uint32_t order = m_allocatedOrders[block] - 1u;
+	m_allocatedOrders[block] = 0;
+	m_usedSize -= m_minBlockSize << order;
+
+	while (order < m_maxOrder)
+	{
+		uint32_t buddy = offset ^ (m_minBlockSize << order);
+		if (m_freeLists[order].erase(buddy) == 0)
+		{
+			break;
+		}
+		offset = (offset < buddy) ? offset : buddy;
+		order++;
+	}
+	m_freeLists[order].insert(offset);
+}
+
+/***********************************************************
+ *  GetBlockSize()
+ *
+ *  This method returns the size of the block that a request
+ *  of the passed size occupies.
+ ***********************************************************/
+uint32_t BuddyAllocator::GetBlockSize(uint32_t size) const
+{
+	return(m_minBlockSize << GetOrder(size));
+}
+
+/***********************************************************
+ *  GetCapacity()
+ *
+ *  This method returns the number of units managed.
+ ***********************************************************/
+uint32_t BuddyAllocator::GetCapacity() const
+{
+	return(m_minBlockSize << m_maxOrder);
+}
+
+/***********************************************************
+ *  GetUsedSize()
+ *
+ *  This method returns the number of units in use.
+ ***********************************************************/
+uint32_t BuddyAllocator::GetUsedSize() const
+{
+	return(m_usedSize);
+}
+
+/***********************************************************
+ *  GetLargestFreeBlock()
+ *
+ *  This method returns the size of the largest free block,
+ *  which is the largest request that can still succeed.
+ ***********************************************************/
+uint32_t BuddyAllocator::GetLargestFreeBlock() const
+{
+	for (uint32_t order = m_maxOrder + 1; order > 0; order--)
+	{
+		if (!m_freeLists[order - 1].empty())
+		{
+			return(m_minBlockSize << (order - 1));
+		}
+	}
+	return(0);
+}
+
+/***********************************************************
+ *  GetOrder()
+ *
+ *  This method returns the order of the smallest block that
+ *  holds the passed number of units.
+ ***********************************************************/
+uint32_t BuddyAllocator::GetOrder(uint32_t size) const
+{
+	uint32_t order = 0;
+	while ((order < 31) && ((m_minBlockSize << order) < size))
+	{
+		order++;
+	}
+	return(order);
+}
@@ -0,0 +1,66 @@
+///////////////////////////////////////////////////////////////////////////////
+// buddyallocator.h
+// ============
+// hand out power of two ranges from one large block of memory
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+/***********************************************************
+ *  BuddyAllocator
+ *
+ *  This class tracks which parts of a range of units are in
+ *  use.  Every request is rounded up to a power of two
+ *  number of blocks, and a freed range is merged with its
+ *  neighbor (its buddy) whenever that one is free too.  It
+ *  only does the bookkeeping - the memory itself lives
+ *  somewhere else, such as in an OpenGL buffer.
+ ***********************************************************/
+class BuddyAllocator
+{
+public:
+	// constructor
+	BuddyAllocator();
+
+	// start over with a free range - both sizes are rounded
+	// up to powers of two
+	void Reset(uint32_t capacity, uint32_t minBlockSize);
+	// double the range, keeping the current allocations
+	void Grow();
+
+	// find a free range of at least size units
+	bool Allocate(uint32_t size, uint32_t& offset);
+	// return a range given out by Allocate()
+	void Free(uint32_t offset);
+
+	// size of the block given out for a request of size units
+	uint32_t GetBlockSize(uint32_t size) const;
+	// total number of units managed
+	uint32_t GetCapacity() const;
+	// number of units given out, rounded up to whole blocks
+	uint32_t GetUsedSize() const;
+	// size of the largest range that can still be allocated
+	uint32_t GetLargestFreeBlock() const;
+
+private:
+	// free block offsets for each order, where a block of
+	// order n holds m_minBlockSize << n units
+	std::vector<std::set<uint32_t>> m_freeLists;
+	// order + 1 of the allocation starting at each minimum
+	// block, or 0 when no allocation starts there
+	std::vector<uint8_t> m_allocatedOrders;
+	// size of the smallest block
+	uint32_t m_minBlockSize;
+	// order of the block covering the whole range
+	uint32_t m_maxOrder;
+	// units given out
+	uint32_t m_usedSize;
+
+	// order of the smallest block that holds size units
+	uint32_t GetOrder(uint32_t size) const;
+};
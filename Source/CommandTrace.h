@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////
+// commandtrace.h
+// ============
+// binary format of a recorded stream of rendering commands
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+/***********************************************************
+ *  TRACE_COMMAND
+ *
+ *  The one byte that starts every command in a trace, one
+ *  for each method of the rendering interface.  The fields
+ *  of the method follow it in order as raw values, with
+ *  sizes and offsets as 32 bits and created objects first
+ *  as the handle the recording backend returned.  Data
+ *  passed by pointer is a byte count, a byte that is zero
+ *  for a NULL pointer, and the bytes.  Strings are a 16 bit
+ *  length and the characters.  Uniform names are written
+ *  once with TRACE_DEFINE_NAME and referred to by a 16 bit
+ *  id after that.  Flags and enums that fit are one byte,
+ *  and a render target's texture is recorded as the target
+ *  followed by the texture handle the backend returned.
+ ***********************************************************/
+enum TRACE_COMMAND
+{
+	TRACE_DEFINE_NAME,
+	TRACE_CREATE_BUFFER,
+	TRACE_UPDATE_BUFFER,
+	TRACE_COPY_BUFFER,
+	TRACE_DESTROY_BUFFER,
+	TRACE_CREATE_VERTEX_LAYOUT,
+	TRACE_DESTROY_VERTEX_LAYOUT,
+	TRACE_CREATE_TEXTURE,
+	TRACE_BIND_TEXTURE,
+	TRACE_DESTROY_TEXTURE,
+	TRACE_CREATE_PROGRAM,
+	TRACE_USE_PROGRAM,
+	TRACE_SET_UNIFORM_INT,
+	TRACE_SET_UNIFORM_FLOAT,
+	TRACE_SET_UNIFORM_VEC2,
+	TRACE_SET_UNIFORM_VEC3,
+	TRACE_SET_UNIFORM_VEC4,
+	TRACE_SET_UNIFORM_MAT4,
+	TRACE_SET_UNIFORM_SAMPLER,
+	TRACE_BEGIN_FRAME,
+	TRACE_END_FRAME,
+	TRACE_SET_PIPELINE_STATE,
+	TRACE_CLEAR,
+	TRACE_DRAW_INDEXED,
+	TRACE_DRAW_INDEXED_INDIRECT,
+	TRACE_CREATE_RENDER_TARGET,
+	TRACE_GET_RENDER_TARGET_TEXTURE,
+	TRACE_SET_RENDER_TARGET,
+	TRACE_DESTROY_RENDER_TARGET,
+	TRACE_GET_RENDER_TARGET_DEPTH_TEXTURE
+};
+
+/***********************************************************
+ *  TRACE_HEADER
+ *
+ *  Start of a trace file.  The commands before the first
+ *  TRACE_BEGIN_FRAME set the scene up, and the rest are the
+ *  recorded frames.
+ ***********************************************************/
+struct TRACE_HEADER
+{
+	// "RTRC"
+	char magic[4];
+	uint32_t version;
+	// frames recorded after the setup
+	uint32_t frameCount;
+	// bytes of commands after the header
+	uint32_t commandBytes;
+};
+
+// version written into new traces
+const uint32_t g_TraceVersion = 3;
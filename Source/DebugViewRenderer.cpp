@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////
+// debugviewrenderer.cpp
+// ============
+// overdraw, draw cost and triangle density views of the scene
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DebugViewRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// texture unit of the overdraw counts, above the ones the
+	// scene's textures take and below the overlay's atlas
+	const int g_CountSlot = 14;
+	// layers of overdraw at the hot end of the ramp
+	const float g_OverdrawRampMax = 8.0f;
+	// rough cost of issuing a draw and sending its state,
+	// counted in triangles - the draw cost ramp starts at a
+	// draw with no triangles and spans eight doublings
+	const float g_DrawCallCost = 256.0f;
+	const float g_DrawCostDoublings = 8.0f;
+	// triangles per pixel at the cold end of the density
+	// ramp, which reaches one triangle per pixel at the hot
+	// end - past that pixel quads are shaded more than once
+	const float g_SparseTrianglesPerPixel = 1.0f / 64.0f;
+
+	/***********************************************************
+	 *  HeatOfRatio()
+	 *
+	 *  This function is used for placing a ratio on a ramp of
+	 *  doublings, from zero at one to one at the top.
+	 ***********************************************************/
+	float HeatOfRatio(float ratio, float doublings)
+	{
+		if (ratio <= 1.0f)
+		{
+			return(0.0f);
+		}
+		return(std::min(std::log2(ratio) / doublings, 1.0f));
+	}
+}
+
+/***********************************************************
+ *  GetDebugViewName()
+ *
+ *  This function is used for getting the name of a view.
+ ***********************************************************/
+const char* GetDebugViewName(DEBUG_VIEW view)
+{
+	switch (view)
+	{
+	case DEBUG_VIEW_OVERDRAW:
+		return("overdraw");
+	case DEBUG_VIEW_DRAW_COST:
+		return("draw cost");
+	case DEBUG_VIEW_TRIANGLE_DENSITY:
+		return("triangle density");
+	default:
+		return("off");
+	}
+}
+
+/***********************************************************
+ *  GetDrawCostHeat()
+ *
+ *  This function is used for getting the heat of a draw
+ *  from its estimated cost, the fixed cost of a draw plus
+ *  its triangles.
+ ***********************************************************/
+float GetDrawCostHeat(size_t triangles)
+{
+	float cost = g_DrawCallCost + static_cast<float>(triangles);
+	return(HeatOfRatio(cost / g_DrawCallCost, g_DrawCostDoublings));
+}
+
+/***********************************************************
+ *  GetTriangleDensityHeat()
+ *
+ *  This function is used for getting the heat of a draw
+ *  from its triangles for each pixel it covers.
+ ***********************************************************/
+float GetTriangleDensityHeat(size_t triangles, float coveredPixels)
+{
+	float trianglesPerPixel = static_cast<float>(triangles) / std::max(coveredPixels, 1.0f);
+	return(HeatOfRatio(trianglesPerPixel / g_SparseTrianglesPerPixel, -std::log2(g_SparseTrianglesPerPixel)));
+}
+
+/***********************************************************
+ *  DebugViewRenderer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+DebugViewRenderer::DebugViewRenderer(RenderBackend* pBackend)
+{
+	m_pBackend = pBackend;
+	m_sceneProgram = 0;
+	m_resolveProgram = 0;
+	m_triangleBuffer = 0;
+	m_triangleIndexBuffer = 0;
+	m_triangleLayout = 0;
+	m_countTarget = 0;
+	m_countWidth = 0;
+	m_countHeight = 0;
+	m_view = DEBUG_VIEW_NONE;
+}
+
+/***********************************************************
+ *  ~DebugViewRenderer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+DebugViewRenderer::~DebugViewRenderer()
+{
+	if (0 != m_countTarget)
+	{
+		m_pBackend->DestroyRenderTarget(m_countTarget);
+		m_countTarget = 0;
+	}
+	if (0 != m_triangleLayout)
+	{
+		m_pBackend->DestroyVertexLayout(m_triangleLayout);
+		m_triangleLayout = 0;
+	}
+	if (0 != m_triangleBuffer)
+	{
+		m_pBackend->DestroyBuffer(m_triangleBuffer);
+		m_triangleBuffer = 0;
+	}
+	if (0 != m_triangleIndexBuffer)
+	{
+		m_pBackend->DestroyBuffer(m_triangleIndexBuffer);
+		m_triangleIndexBuffer = 0;
+	}
+	m_pBackend = NULL;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for making the program the scene is
+ *  drawn with, the one that maps the overdraw counts, and
+ *  the triangle that covers the frame for it.
+ ***********************************************************/
+bool DebugViewRenderer::Create(
+	const char* sceneVertexFilename,
+	const char* sceneFragmentFilename,
+	const char* resolveVertexFilename,
+	const char* resolveFragmentFilename)
+{
+	m_sceneProgram = m_pBackend->CreateProgram(sceneVertexFilename, sceneFragmentFilename);
+	m_resolveProgram = m_pBackend->CreateProgram(resolveVertexFilename, resolveFragmentFilename);
+	if ((0 == m_sceneProgram) || (0 == m_resolveProgram))
+	{
+		std::cout << "Could not load the debug view shaders" << std::endl;
+		return(false);
+	}
+
+	// one triangle past the corners covers the frame without
+	// the seam two would have along the diagonal
+	const float corners[6] = { -1.0f, -1.0f, 3.0f, -1.0f, -1.0f, 3.0f };
+	const uint32_t indices[3] = { 0, 1, 2 };
+	m_triangleBuffer = m_pBackend->CreateBuffer(BUFFER_VERTEX, sizeof(corners), corners);
+	m_triangleIndexBuffer = m_pBackend->CreateBuffer(BUFFER_INDEX, sizeof(indices), indices);
+
+	VERTEX_ATTRIBUTE attribute;
+	attribute.location = 0;
+	attribute.buffer = m_triangleBuffer;
+	attribute.components = 2;
+	attribute.stride = 2 * sizeof(float);
+	attribute.offset = 0;
+	m_triangleLayout = m_pBackend->CreateVertexLayout(&attribute, 1, m_triangleIndexBuffer);
+	return(true);
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used for setting up the drawing of the
+ *  scene as a view.  Overdraw goes into the count target,
+ *  made again when the frame size changes, with additive
+ *  blending and no depth test so hidden layers count too.
+ ***********************************************************/
+void DebugViewRenderer::Begin(DEBUG_VIEW view, int width, int height)
+{
+	m_view = view;
+	if ((0 == m_sceneProgram) || (DEBUG_VIEW_NONE == view))
+	{
+		return;
+	}
+
+	PIPELINE_STATE state;
+	state.bDepthTest = true;
+	state.blendMode = BLEND_NONE;
+
+	if (DEBUG_VIEW_OVERDRAW == view)
+	{
+		if ((0 != m_countTarget) && ((width != m_countWidth) || (height != m_countHeight)))
+		{
+			m_pBackend->DestroyRenderTarget(m_countTarget);
+			m_countTarget = 0;
+		}
+		if (0 == m_countTarget)
+		{
+			m_countTarget = m_pBackend->CreateRenderTarget(width, height, RENDER_TARGET_R32F, false, 1);
+			m_countWidth = width;
+			m_countHeight = height;
+		}
+		m_pBackend->SetRenderTarget(m_countTarget);
+		state.bDepthTest = false;
+		state.blendMode = BLEND_ADDITIVE;
+	}
+
+	m_pBackend->SetPipelineState(state);
+	m_pBackend->Clear(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	m_pBackend->UseProgram(m_sceneProgram);
+	m_pBackend->SetUniformInt("debugView", static_cast<int>(view));
+}
+
+/***********************************************************
+ *  End()
+ *
+ *  This method is used for finishing a view.  The overdraw
+ *  counts are drawn over the frame with the heat ramp.
+ ***********************************************************/
+void DebugViewRenderer::End()
+{
+	if ((DEBUG_VIEW_OVERDRAW != m_view) || (0 == m_countTarget))
+	{
+		m_view = DEBUG_VIEW_NONE;
+		return;
+	}
+	m_view = DEBUG_VIEW_NONE;
+
+	m_pBackend->SetRenderTarget(0);
+
+	PIPELINE_STATE state;
+	state.bDepthTest = false;
+	state.blendMode = BLEND_NONE;
+	m_pBackend->SetPipelineState(state);
+	m_pBackend->UseProgram(m_resolveProgram);
+	m_pBackend->BindTexture(g_CountSlot, m_pBackend->GetRenderTargetTexture(m_countTarget));
+	m_pBackend->SetUniformSampler("overdrawCounts", g_CountSlot);
+	m_pBackend->SetUniformFloat("rampMaximum", g_OverdrawRampMax);
+	m_pBackend->DrawIndexed(m_triangleLayout, 3, 0, 0);
+}
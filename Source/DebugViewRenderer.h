@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////
+// debugviewrenderer.h
+// ============
+// overdraw, draw cost and triangle density views of the scene
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+
+#include <cstddef>
+
+/***********************************************************
+ *  DEBUG_VIEW
+ *
+ *  What the scene is drawn as instead of its materials.
+ ***********************************************************/
+enum DEBUG_VIEW
+{
+	DEBUG_VIEW_NONE,
+	// fragments drawn on each pixel, hidden ones included
+	DEBUG_VIEW_OVERDRAW,
+	// estimated cost of the draw each surface belongs to
+	DEBUG_VIEW_DRAW_COST,
+	// triangles of a draw for the pixels it covers
+	DEBUG_VIEW_TRIANGLE_DENSITY,
+	DEBUG_VIEW_COUNT
+};
+
+// name of a view, for printing
+const char* GetDebugViewName(DEBUG_VIEW view);
+// heat of a draw from zero to one, for the views that
+// color whole draws
+float GetDrawCostHeat(size_t triangles);
+float GetTriangleDensityHeat(size_t triangles, float coveredPixels);
+
+/***********************************************************
+ *  DebugViewRenderer
+ *
+ *  This class draws the scene as one of the debug views
+ *  used while authoring it.  Begin() makes the debug
+ *  program current, so the camera uniforms the view
+ *  manager sets and the model matrices the scene manager
+ *  sets land on it, and the scene is then drawn as usual.
+ *
+ *  For overdraw every fragment adds one to a float render
+ *  target, with the depth test off, and End() maps the
+ *  counts onto the frame as a heat ramp.  The other views
+ *  draw straight into the frame with the depth test on,
+ *  each draw colored by the heat the scene manager sets in
+ *  the "debugValue" uniform.
+ ***********************************************************/
+class DebugViewRenderer
+{
+public:
+	// constructor
+	DebugViewRenderer(RenderBackend* pBackend);
+	// destructor
+	~DebugViewRenderer();
+
+	// make the programs and the full screen triangle
+	bool Create(
+		const char* sceneVertexFilename,
+		const char* sceneFragmentFilename,
+		const char* resolveVertexFilename,
+		const char* resolveFragmentFilename);
+
+	// start drawing the scene as a view into a frame of the
+	// passed size, clearing what is drawn into
+	void Begin(DEBUG_VIEW view, int width, int height);
+	// finish the view, leaving the frame as the target - the
+	// caller makes its own program current again afterwards
+	void End();
+
+private:
+	RenderBackend* m_pBackend;
+	// draws the scene, and maps the overdraw counts
+	uint32_t m_sceneProgram;
+	uint32_t m_resolveProgram;
+	// one triangle covering the frame
+	uint32_t m_triangleBuffer;
+	uint32_t m_triangleIndexBuffer;
+	uint32_t m_triangleLayout;
+	// overdraw counts, made at the size of the frame
+	uint32_t m_countTarget;
+	int m_countWidth;
+	int m_countHeight;
+	// view between Begin() and End()
+	DEBUG_VIEW m_view;
+};
@@ -0,0 +1,577 @@
+///////////////////////////////////////////////////////////////////////////////
+// framegraph.cpp
+// ============
+// schedule the passes of a frame from what they read and write
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameGraph.h"
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// marks a pass that is not the writer of anything
+	const size_t g_NoPass = static_cast<size_t>(-1);
+	// ending of a read of a target's depth texture
+	const std::string g_DepthSuffix = ".depth";
+
+	/***********************************************************
+	 *  IsDepthRead()
+	 *
+	 *  This function is used for checking whether a read is of
+	 *  a target's depth texture.
+	 ***********************************************************/
+	bool IsDepthRead(const std::string& read)
+	{
+		return((read.size() > g_DepthSuffix.size()) &&
+			(0 == read.compare(read.size() - g_DepthSuffix.size(), g_DepthSuffix.size(), g_DepthSuffix)));
+	}
+
+	/***********************************************************
+	 *  GetTargetName()
+	 *
+	 *  This function is used for getting the target a read is
+	 *  of, without the depth ending.
+	 ***********************************************************/
+	std::string GetTargetName(const std::string& read)
+	{
+		return(IsDepthRead(read) ? read.substr(0, read.size() - g_DepthSuffix.size()) : read);
+	}
+}
+
+/***********************************************************
+ *  FrameGraph()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameGraph::FrameGraph(RenderBackend* pBackend)
+	: m_pool(pBackend)
+{
+	m_pBackend = pBackend;
+	m_bCompiled = false;
+	m_bValid = false;
+	m_bTargetFailed = false;
+	m_width = 0;
+	m_height = 0;
+}
+
+/***********************************************************
+ *  ~FrameGraph()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameGraph::~FrameGraph()
+{
+	ReleaseTargets();
+	m_pBackend = NULL;
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for dropping the declared passes and
+ *  targets.
+ ***********************************************************/
+void FrameGraph::Reset()
+{
+	ReleaseTargets();
+	m_passes.clear();
+	m_targets.clear();
+	m_bCompiled = false;
+}
+
+/***********************************************************
+ *  DeclareTarget()
+ *
+ *  This method is used for declaring a transient target,
+ *  with a size of the frame's times the passed scale.
+ ***********************************************************/
+void FrameGraph::DeclareTarget(const std::string& name, RENDER_TARGET_FORMAT format, float scale, bool bDepth, int samples)
+{
+	TRANSIENT_TARGET transient;
+	transient.format = format;
+	transient.scale = scale;
+	transient.width = 0;
+	transient.height = 0;
+	transient.bDepth = bDepth;
+	transient.samples = samples;
+	transient.bImported = false;
+	transient.target = 0;
+	m_targets[name] = transient;
+	m_bCompiled = false;
+}
+
+/***********************************************************
+ *  DeclareFixedTarget()
+ *
+ *  This method is used for declaring a transient target of
+ *  a fixed size, whatever the size of the frame.
+ ***********************************************************/
+void FrameGraph::DeclareFixedTarget(const std::string& name, RENDER_TARGET_FORMAT format, int width, int height)
+{
+	DeclareTarget(name, format, 1.0f, false, 1);
+	m_targets[name].width = std::max(width, 1);
+	m_targets[name].height = std::max(height, 1);
+}
+
+/***********************************************************
+ *  ImportTarget()
+ *
+ *  This method is used for adding a target the caller made
+ *  and keeps, or for changing the handle of one imported
+ *  before.
+ ***********************************************************/
+void FrameGraph::ImportTarget(const std::string& name, uint32_t target)
+{
+	std::unordered_map<std::string, TRANSIENT_TARGET>::iterator imported = m_targets.find(name);
+	if ((imported != m_targets.end()) && imported->second.bImported)
+	{
+		imported->second.target = target;
+		return;
+	}
+
+	TRANSIENT_TARGET transient;
+	transient.format = RENDER_TARGET_RGBA8;
+	transient.scale = 1.0f;
+	transient.width = 0;
+	transient.height = 0;
+	transient.bDepth = false;
+	transient.samples = 1;
+	transient.bImported = true;
+	transient.target = target;
+	m_targets[name] = transient;
+	m_bCompiled = false;
+}
+
+/***********************************************************
+ *  AddPass()
+ *
+ *  This method is used for adding a pass.
+ ***********************************************************/
+void FrameGraph::AddPass(const FRAME_GRAPH_PASS& pass)
+{
+	m_passes.push_back(pass);
+	m_bCompiled = false;
+}
+
+/***********************************************************
+ *  SetPassHooks()
+ *
+ *  This method is used for setting the functions called
+ *  around each pass that runs - either may be empty.
+ ***********************************************************/
+void FrameGraph::SetPassHooks(
+	const std::function<void(size_t, const std::string&)>& beginPass,
+	const std::function<void(size_t)>& endPass)
+{
+	m_beginPass = beginPass;
+	m_endPass = endPass;
+}
+
+/***********************************************************
+ *  Compile()
+ *
+ *  This method is used for working out how the passes run.
+ *  Walking back from the passes that draw into the frame
+ *  through the writers of what they read finds the passes
+ *  that matter, and the rest are culled.  Those are sorted
+ *  so writers come before their readers, taking the first
+ *  added of the passes that are ready each time, and the
+ *  last reader of each target is where it is given back.
+ ***********************************************************/
+bool FrameGraph::Compile()
+{
+	m_bCompiled = true;
+	m_bValid = true;
+	m_order.clear();
+	m_releases.clear();
+	m_barriers.clear();
+
+	// each target has one writer, and every read is of a
+	// target something writes, or one imported
+	std::unordered_map<std::string, size_t> writers;
+	for (size_t i = 0; i < m_passes.size(); i++)
+	{
+		const std::string& write = m_passes[i].write;
+		if (write.empty())
+		{
+			continue;
+		}
+		if (0 == m_targets.count(write))
+		{
+			std::cout << "Frame graph pass " << m_passes[i].name << " writes undeclared " << write << std::endl;
+			m_bValid = false;
+		}
+		else if (writers.count(write) > 0)
+		{
+			std::cout << "Frame graph pass " << m_passes[i].name << " writes " << write << ", already written" << std::endl;
+			m_bValid = false;
+		}
+		writers[write] = i;
+	}
+	for (size_t i = 0; i < m_passes.size(); i++)
+	{
+		for (size_t k = 0; k < m_passes[i].reads.size(); k++)
+		{
+			std::string name = GetTargetName(m_passes[i].reads[k]);
+			std::unordered_map<std::string, TRANSIENT_TARGET>::const_iterator transient = m_targets.find(name);
+			bool bImported = (transient != m_targets.end()) && transient->second.bImported;
+			if (!bImported && (0 == writers.count(name)))
+			{
+				std::cout << "Frame graph pass " << m_passes[i].name << " reads " << m_passes[i].reads[k] << ", which nothing writes" << std::endl;
+				m_bValid = false;
+			}
+		}
+	}
+	if (!m_bValid)
+	{
+		return(false);
+	}
+
+	// keep the passes drawing into the frame and those they
+	// depend on
+	std::vector<bool> needed(m_passes.size(), false);
+	std::vector<size_t> pending;
+	for (size_t i = 0; i < m_passes.size(); i++)
+	{
+		if (m_passes[i].write.empty())
+		{
+			needed[i] = true;
+			pending.push_back(i);
+		}
+	}
+	if (pending.empty())
+	{
+		std::cout << "Frame graph has no pass drawing into the frame" << std::endl;
+		m_bValid = false;
+		return(false);
+	}
+	while (!pending.empty())
+	{
+		size_t pass = pending.back();
+		pending.pop_back();
+		for (size_t k = 0; k < m_passes[pass].reads.size(); k++)
+		{
+			std::unordered_map<std::string, size_t>::const_iterator found = writers.find(GetTargetName(m_passes[pass].reads[k]));
+			if (found == writers.end())
+			{
+				continue;
+			}
+			size_t writer = found->second;
+			if (!needed[writer])
+			{
+				needed[writer] = true;
+				pending.push_back(writer);
+			}
+		}
+	}
+
+	// count what each pass waits on - its writers, and the
+	// frame pass added before it
+	std::vector<size_t> waiting(m_passes.size(), 0);
+	std::vector<std::vector<size_t> > followers(m_passes.size());
+	size_t previousFramePass = g_NoPass;
+	size_t neededCount = 0;
+	for (size_t i = 0; i < m_passes.size(); i++)
+	{
+		if (!needed[i])
+		{
+			continue;
+		}
+		neededCount++;
+		std::unordered_set<size_t> sources;
+		for (size_t k = 0; k < m_passes[i].reads.size(); k++)
+		{
+			std::unordered_map<std::string, size_t>::const_iterator found = writers.find(GetTargetName(m_passes[i].reads[k]));
+			if (found != writers.end())
+			{
+				sources.insert(found->second);
+			}
+		}
+		if (m_passes[i].write.empty())
+		{
+			if (g_NoPass != previousFramePass)
+			{
+				sources.insert(previousFramePass);
+			}
+			previousFramePass = i;
+		}
+		std::unordered_set<size_t>::const_iterator source;
+		for (source = sources.begin(); source != sources.end(); ++source)
+		{
+			followers[*source].push_back(i);
+			waiting[i]++;
+		}
+	}
+
+	std::vector<bool> ready(m_passes.size(), false);
+	for (size_t i = 0; i < m_passes.size(); i++)
+	{
+		ready[i] = needed[i] && (0 == waiting[i]);
+	}
+	while (m_order.size() < neededCount)
+	{
+		std::vector<bool>::const_iterator first = std::find(ready.begin(), ready.end(), true);
+		if (first == ready.end())
+		{
+			std::cout << "Frame graph passes read each other's targets in a cycle" << std::endl;
+			m_bValid = false;
+			m_order.clear();
+			return(false);
+		}
+		size_t pass = static_cast<size_t>(first - ready.begin());
+		ready[pass] = false;
+		m_order.push_back(pass);
+		for (size_t k = 0; k < followers[pass].size(); k++)
+		{
+			size_t follower = followers[pass][k];
+			if (0 == --waiting[follower])
+			{
+				ready[follower] = true;
+			}
+		}
+	}
+
+	// a texture turns from written to read once, before its
+	// first reader, and a declared target is free after the
+	// last read of either of its textures
+	std::unordered_set<std::string> readTextures;
+	std::unordered_map<std::string, size_t> lastReaders;
+	m_barriers.assign(m_order.size(), 0);
+	for (size_t position = 0; position < m_order.size(); position++)
+	{
+		const FRAME_GRAPH_PASS& pass = m_passes[m_order[position]];
+		for (size_t k = 0; k < pass.reads.size(); k++)
+		{
+			if (readTextures.insert(pass.reads[k]).second)
+			{
+				m_barriers[position]++;
+			}
+			std::string name = GetTargetName(pass.reads[k]);
+			if (!m_targets[name].bImported)
+			{
+				lastReaders[name] = position;
+			}
+		}
+	}
+	m_releases.assign(m_order.size(), std::vector<std::string>());
+	std::unordered_map<std::string, size_t>::const_iterator reader;
+	for (reader = lastReaders.begin(); reader != lastReaders.end(); ++reader)
+	{
+		m_releases[reader->second].push_back(reader->first);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  Execute()
+ *
+ *  This method is used for running the compiled passes.
+ *  Each takes its target from the pool, bound before it
+ *  runs, and the targets it was the last reader of go back
+ *  after.  A target the pool cannot make stops only this
+ *  frame: what was taken goes back and the next frame tries
+ *  again, once idle targets may have been freed.  OpenGL
+ *  finishes the drawing into a framebuffer before its
+ *  texture is sampled without being asked, so
+ *  the barriers are only counted here; a backend needing
+ *  them would issue them before the passes they belong to.
+ ***********************************************************/
+void FrameGraph::Execute(int width, int height)
+{
+	if (!m_bCompiled)
+	{
+		Compile();
+	}
+	if (!m_bValid)
+	{
+		return;
+	}
+
+	m_width = std::max(width, 1);
+	m_height = std::max(height, 1);
+	bool bTargetFailed = false;
+	for (size_t position = 0; position < m_order.size(); position++)
+	{
+		const FRAME_GRAPH_PASS& pass = m_passes[m_order[position]];
+
+		uint32_t target = 0;
+		if (!pass.write.empty() && m_targets[pass.write].bImported)
+		{
+			target = m_targets[pass.write].target;
+		}
+		else if (!pass.write.empty())
+		{
+			TRANSIENT_TARGET& transient = m_targets[pass.write];
+			int targetWidth = std::max(static_cast<int>(m_width * transient.scale + 0.5f), 1);
+			int targetHeight = std::max(static_cast<int>(m_height * transient.scale + 0.5f), 1);
+			if (transient.width > 0)
+			{
+				targetWidth = transient.width;
+				targetHeight = transient.height;
+			}
+			transient.target = m_pool.Acquire(targetWidth, targetHeight, transient.format, transient.bDepth, transient.samples);
+			target = transient.target;
+			if (0 == target)
+			{
+				if (!m_bTargetFailed)
+				{
+					std::cout << "Frame graph could not make " << pass.write << " for pass " << pass.name << ", skipping frames until it can" << std::endl;
+				}
+				bTargetFailed = true;
+				break;
+			}
+		}
+		m_pBackend->SetRenderTarget(target);
+
+		if (m_beginPass)
+		{
+			m_beginPass(position, pass.name);
+		}
+		if (pass.execute)
+		{
+			pass.execute(*this);
+		}
+		if (m_endPass)
+		{
+			m_endPass(position);
+		}
+
+		for (size_t k = 0; k < m_releases[position].size(); k++)
+		{
+			TRANSIENT_TARGET& transient = m_targets[m_releases[position][k]];
+			m_pool.Release(transient.target);
+			transient.target = 0;
+		}
+	}
+
+	m_bTargetFailed = bTargetFailed;
+	ReleaseTargets();
+	m_pBackend->SetRenderTarget(0);
+	m_pool.EndFrame();
+}
+
+/***********************************************************
+ *  GetTexture()
+ *
+ *  This method is used for getting the texture of a read
+ *  while the passes run, or zero if it is not alive.
+ ***********************************************************/
+uint32_t FrameGraph::GetTexture(const std::string& name) const
+{
+	std::unordered_map<std::string, TRANSIENT_TARGET>::const_iterator transient = m_targets.find(GetTargetName(name));
+	if ((transient == m_targets.end()) || (0 == transient->second.target))
+	{
+		return(0);
+	}
+	if (IsDepthRead(name))
+	{
+		return(m_pBackend->GetRenderTargetDepthTexture(transient->second.target));
+	}
+	return(m_pBackend->GetRenderTargetTexture(transient->second.target));
+}
+
+/***********************************************************
+ *  GetWidth()
+ *
+ *  This method is used for getting the width of the frame
+ *  being run.
+ ***********************************************************/
+int FrameGraph::GetWidth() const
+{
+	return(m_width);
+}
+
+/***********************************************************
+ *  GetHeight()
+ *
+ *  This method is used for getting the height of the frame
+ *  being run.
+ ***********************************************************/
+int FrameGraph::GetHeight() const
+{
+	return(m_height);
+}
+
+/***********************************************************
+ *  GetPassCount()
+ *
+ *  This method is used for getting the number of passes
+ *  added, culled or not.
+ ***********************************************************/
+size_t FrameGraph::GetPassCount() const
+{
+	return(m_passes.size());
+}
+
+/***********************************************************
+ *  GetExecutedPassCount()
+ *
+ *  This method is used for getting the number of passes
+ *  that run.
+ ***********************************************************/
+size_t FrameGraph::GetExecutedPassCount() const
+{
+	return(m_order.size());
+}
+
+/***********************************************************
+ *  GetExecutedPassName()
+ *
+ *  This method is used for getting the name of a pass by
+ *  its position in the compiled order.
+ ***********************************************************/
+const std::string& FrameGraph::GetExecutedPassName(size_t index) const
+{
+	return(m_passes[m_order[index]].name);
+}
+
+/***********************************************************
+ *  GetBarrierCount()
+ *
+ *  This method is used for getting the barriers a frame of
+ *  the compiled passes needs.
+ ***********************************************************/
+size_t FrameGraph::GetBarrierCount() const
+{
+	size_t barriers = 0;
+	for (size_t i = 0; i < m_barriers.size(); i++)
+	{
+		barriers += m_barriers[i];
+	}
+	return(barriers);
+}
+
+/***********************************************************
+ *  GetPool()
+ *
+ *  This method is used for getting the pool of the
+ *  transient targets, for its memory.
+ ***********************************************************/
+const RenderTargetPool& FrameGraph::GetPool() const
+{
+	return(m_pool);
+}
+
+/***********************************************************
+ *  ReleaseTargets()
+ *
+ *  This method is used for giving back the declared targets
+ *  still alive, after a frame that stopped part way.
+ ***********************************************************/
+void FrameGraph::ReleaseTargets()
+{
+	std::unordered_map<std::string, TRANSIENT_TARGET>::iterator transient;
+	for (transient = m_targets.begin(); transient != m_targets.end(); ++transient)
+	{
+		if (!transient->second.bImported && (0 != transient->second.target))
+		{
+			m_pool.Release(transient->second.target);
+			transient->second.target = 0;
+		}
+	}
+}
@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// framegraph.h
+// ============
+// schedule the passes of a frame from what they read and write
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+#include "RenderTargetPool.h"
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FrameGraph;
+
+/***********************************************************
+ *  FRAME_GRAPH_PASS
+ *
+ *  One pass of the frame.  It reads targets written by
+ *  other passes and writes one target, or the frame when
+ *  its write is empty.  A read of "<target>.depth" is of
+ *  the target's depth texture.  The graph binds the written
+ *  target before calling execute, and the pass finds the
+ *  textures of its reads with FrameGraph::GetTexture().
+ ***********************************************************/
+struct FRAME_GRAPH_PASS
+{
+	std::string name;
+	std::vector<std::string> reads;
+	std::string write;
+	std::function<void(FrameGraph&)> execute;
+};
+
+/***********************************************************
+ *  FrameGraph
+ *
+ *  This class runs the passes of a frame in an order worked
+ *  out from their reads and writes, instead of the order
+ *  they were added in.  Compile() keeps only the passes the
+ *  frame depends on, sorts them so each runs after the
+ *  writers of what it reads - passes drawing into the frame
+ *  keep the order they were added in - and notes where a
+ *  target goes from being written to being read, which is
+ *  where a barrier belongs.
+ *
+ *  Declared targets are transient: each is taken from a
+ *  render target pool just before its writer runs and given
+ *  back after its last reader, so targets whose lifetimes
+ *  do not overlap share memory.  Most are sized against the
+ *  frame, and the few whose work must not grow with it, a
+ *  histogram say, have a fixed size.  Imported targets
+ *  belong to the caller and live across frames, like a
+ *  history kept for the next frame; reading one needs no
+ *  writer.  Hooks called around every pass let the caller
+ *  time each one without naming them.
+ ***********************************************************/
+class FrameGraph
+{
+public:
+	// constructor
+	FrameGraph(RenderBackend* pBackend);
+	// destructor
+	~FrameGraph();
+
+	// drop the passes and targets to declare others - the
+	// pool keeps its targets for them
+	void Reset();
+
+	// a transient target, sized against the frame
+	void DeclareTarget(const std::string& name, RENDER_TARGET_FORMAT format, float scale, bool bDepth, int samples);
+	// a transient target of the same size in every frame
+	void DeclareFixedTarget(const std::string& name, RENDER_TARGET_FORMAT format, int width, int height);
+	// a target of the caller's - importing it again with
+	// another handle needs no new Compile()
+	void ImportTarget(const std::string& name, uint32_t target);
+	// a pass, in any order against the passes it reads from
+	void AddPass(const FRAME_GRAPH_PASS& pass);
+	// called with the position of the pass in the compiled
+	// order before and after it runs
+	void SetPassHooks(
+		const std::function<void(size_t, const std::string&)>& beginPass,
+		const std::function<void(size_t)>& endPass);
+
+	// cull, order and find the lifetimes of the targets -
+	// done by Execute() when the passes have changed
+	bool Compile();
+	// run the compiled passes for a frame of the passed size
+	void Execute(int width, int height);
+
+	// for the passes while they run: the texture of a target
+	// and the size of the frame
+	uint32_t GetTexture(const std::string& name) const;
+	int GetWidth() const;
+	int GetHeight() const;
+
+	// passes added, the ones that run and their barriers
+	size_t GetPassCount() const;
+	size_t GetExecutedPassCount() const;
+	const std::string& GetExecutedPassName(size_t index) const;
+	size_t GetBarrierCount() const;
+	// the targets behind the declared ones
+	const RenderTargetPool& GetPool() const;
+
+private:
+	struct TRANSIENT_TARGET
+	{
+		RENDER_TARGET_FORMAT format;
+		float scale;
+		// size in pixels, or zero to scale with the frame
+		int width;
+		int height;
+		bool bDepth;
+		int samples;
+		bool bImported;
+		// the pool's target while it is alive, else zero, or
+		// the caller's target when imported
+		uint32_t target;
+	};
+
+	RenderBackend* m_pBackend;
+	std::vector<FRAME_GRAPH_PASS> m_passes;
+	std::unordered_map<std::string, TRANSIENT_TARGET> m_targets;
+	bool m_bCompiled;
+	bool m_bValid;
+	// set while frames keep failing to get a target, so the
+	// failure is reported once rather than every frame
+	bool m_bTargetFailed;
+	// indices of the passes that run, in order, with the
+	// targets free after each and the barriers before each
+	std::vector<size_t> m_order;
+	std::vector<std::vector<std::string> > m_releases;
+	std::vector<size_t> m_barriers;
+	RenderTargetPool m_pool;
+	std::function<void(size_t, const std::string&)> m_beginPass;
+	std::function<void(size_t)> m_endPass;
+	int m_width;
+	int m_height;
+
+	// give back the targets still alive
+	void ReleaseTargets();
+};
@@ -0,0 +1,157 @@
+///////////////////////////////////////////////////////////////////////////////
+// glgputimer.cpp
+// ============
+// time zones of a frame on the GPU with OpenGL timer queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLGPUTimer.h"
+
+// declaration of the global variables and helpers
+namespace
+{
+	// frames a query may be in flight before its slot is
+	// used again, and the zones of a frame
+	const size_t g_FramesInFlight = 4;
+	const size_t g_MaxZones = 32;
+}
+
+/***********************************************************
+ *  GLGPUTimer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GLGPUTimer::GLGPUTimer()
+{
+	m_pending.assign(g_FramesInFlight * g_MaxZones, false);
+	m_milliseconds.assign(g_MaxZones, 0.0);
+	m_frameSlot = 0;
+	m_openZone = g_MaxZones;
+}
+
+/***********************************************************
+ *  ~GLGPUTimer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+GLGPUTimer::~GLGPUTimer()
+{
+	if (!m_queries.empty())
+	{
+		glDeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+		m_queries.clear();
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for moving on to the next frame's
+ *  queries, first reading the results of the frame that
+ *  last used them.  A result that is still not in is
+ *  dropped rather than waited for.
+ ***********************************************************/
+void GLGPUTimer::BeginFrame()
+{
+	m_frameSlot = (m_frameSlot + 1) % g_FramesInFlight;
+	if (m_queries.empty())
+	{
+		return;
+	}
+
+	for (size_t zone = 0; zone < g_MaxZones; zone++)
+	{
+		size_t index = m_frameSlot * g_MaxZones + zone;
+		if (!m_pending[index])
+		{
+			continue;
+		}
+		m_pending[index] = false;
+
+		GLint bAvailable = GL_FALSE;
+		glGetQueryObjectiv(m_queries[index], GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+		if (GL_FALSE != bAvailable)
+		{
+			GLuint64 nanoseconds = 0;
+			glGetQueryObjectui64v(m_queries[index], GL_QUERY_RESULT, &nanoseconds);
+			m_milliseconds[zone] = static_cast<double>(nanoseconds) * 1.0e-6;
+		}
+	}
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for closing a zone left open at the
+ *  end of a frame.
+ ***********************************************************/
+void GLGPUTimer::EndFrame()
+{
+	EndZone();
+}
+
+/***********************************************************
+ *  BeginZone()
+ *
+ *  This method is used for starting to time a zone, ending
+ *  the one that was open.
+ ***********************************************************/
+void GLGPUTimer::BeginZone(size_t zone)
+{
+	if (zone >= g_MaxZones)
+	{
+		return;
+	}
+	EndZone();
+
+	if (m_queries.empty())
+	{
+		m_queries.assign(g_FramesInFlight * g_MaxZones, 0);
+		glGenQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+	}
+
+	size_t index = m_frameSlot * g_MaxZones + zone;
+	glBeginQuery(GL_TIME_ELAPSED, m_queries[index]);
+	m_pending[index] = true;
+	m_openZone = zone;
+}
+
+/***********************************************************
+ *  EndZone()
+ *
+ *  This method is used for ending the open zone, if any.
+ ***********************************************************/
+void GLGPUTimer::EndZone()
+{
+	if (m_openZone < g_MaxZones)
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		m_openZone = g_MaxZones;
+	}
+}
+
+/***********************************************************
+ *  GetMaxZones()
+ *
+ *  This method is used for getting how many zones a frame
+ *  can have.
+ ***********************************************************/
+size_t GLGPUTimer::GetMaxZones() const
+{
+	return(g_MaxZones);
+}
+
+/***********************************************************
+ *  GetMilliseconds()
+ *
+ *  This method is used for getting the GPU time of a zone
+ *  in the latest frame whose results were read.
+ ***********************************************************/
+double GLGPUTimer::GetMilliseconds(size_t zone) const
+{
+	if (zone >= g_MaxZones)
+	{
+		return(0.0);
+	}
+	return(m_milliseconds[zone]);
+}
@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////////////
+// glgputimer.h
+// ============
+// time zones of a frame on the GPU with OpenGL timer queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <vector>
+
+/***********************************************************
+ *  GLGPUTimer
+ *
+ *  This class measures how long the GPU spends on numbered
+ *  zones of a frame with GL_TIME_ELAPSED queries.  Results
+ *  are read a few frames after the queries are issued, and
+ *  only once available, so timing never waits on the GPU;
+ *  the times reported are those of the latest frame whose
+ *  results are in.  Zones may not nest, since OpenGL runs
+ *  one elapsed time query at a time.
+ ***********************************************************/
+class GLGPUTimer
+{
+public:
+	// constructor - the queries are made on first use, so
+	// it may run before the context exists
+	GLGPUTimer();
+	// destructor
+	~GLGPUTimer();
+
+	// frames - collects the results that are ready
+	void BeginFrame();
+	void EndFrame();
+
+	// zones, from zero to GetMaxZones() - 1
+	void BeginZone(size_t zone);
+	void EndZone();
+	size_t GetMaxZones() const;
+
+	// GPU time of a zone in the latest measured frame
+	double GetMilliseconds(size_t zone) const;
+
+private:
+	// query names, frames in flight by zones, made on use
+	std::vector<GLuint> m_queries;
+	// which queries are waiting for a result
+	std::vector<bool> m_pending;
+	std::vector<double> m_milliseconds;
+	size_t m_frameSlot;
+	// the zone being timed, or GetMaxZones() for none
+	size_t m_openZone;
+};
@@ -0,0 +1,745 @@
+///////////////////////////////////////////////////////////////////////////////
+// glrenderbackend.cpp
+// ============
+// render through OpenGL
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLRenderBackend.h"
+
+#include <algorithm>
+#include <iostream>
+
+/***********************************************************
+ *  GLRenderBackend()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GLRenderBackend::GLRenderBackend(ShaderManager* pShaderManager)
+{
+	m_pShaderManager = pShaderManager;
+	m_indirectBuffer = 0;
+	m_frameCounts.drawCalls = 0;
+	m_frameCounts.triangles = 0;
+	m_frameCounts.bufferBytes = 0;
+	m_frameCounts.textureBytes = 0;
+	m_currentTarget = 0;
+	m_frameViewport[0] = 0;
+	m_frameViewport[1] = 0;
+	m_frameViewport[2] = 0;
+	m_frameViewport[3] = 0;
+}
+
+/***********************************************************
+ *  ~GLRenderBackend()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+GLRenderBackend::~GLRenderBackend()
+{
+	if (0 != m_indirectBuffer)
+	{
+		m_stateCache.DeleteBuffer(m_indirectBuffer);
+		m_indirectBuffer = 0;
+	}
+	while (!m_renderTargets.empty())
+	{
+		DestroyRenderTarget(m_renderTargets.begin()->first);
+	}
+	m_pShaderManager = NULL;
+}
+
+/***********************************************************
+ *  CreateBuffer()
+ *
+ *  This method is used for creating a buffer object.  The
+ *  copy targets are used so the bound vertex array is never
+ *  touched, and the buffer is left bound since nothing
+ *  else reads them.
+ ***********************************************************/
+uint32_t GLRenderBackend::CreateBuffer(BUFFER_TYPE, size_t size, const void* pData)
+{
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	m_stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(size), pData, GL_STATIC_DRAW);
+
+	m_bufferSizes[buffer] = size;
+	m_frameCounts.bufferBytes += size;
+	return(buffer);
+}
+
+/***********************************************************
+ *  UpdateBuffer()
+ *
+ *  This method is used for overwriting part of a buffer.
+ ***********************************************************/
+void GLRenderBackend::UpdateBuffer(uint32_t buffer, size_t offset, size_t size, const void* pData)
+{
+	m_stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), pData);
+}
+
+/***********************************************************
+ *  CopyBuffer()
+ *
+ *  This method is used for copying a range of one buffer
+ *  into another on the GPU.
+ ***********************************************************/
+void GLRenderBackend::CopyBuffer(uint32_t source, uint32_t destination, size_t sourceOffset, size_t destinationOffset, size_t size)
+{
+	m_stateCache.BindBuffer(GL_COPY_READ_BUFFER, source);
+	m_stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, destination);
+	glCopyBufferSubData(
+		GL_COPY_READ_BUFFER,
+		GL_COPY_WRITE_BUFFER,
+		static_cast<GLintptr>(sourceOffset),
+		static_cast<GLintptr>(destinationOffset),
+		static_cast<GLsizeiptr>(size));
+}
+
+/***********************************************************
+ *  DestroyBuffer()
+ *
+ *  This method is used for deleting a buffer object.
+ ***********************************************************/
+void GLRenderBackend::DestroyBuffer(uint32_t buffer)
+{
+	std::unordered_map<GLuint, size_t>::iterator found = m_bufferSizes.find(buffer);
+	if (found != m_bufferSizes.end())
+	{
+		m_frameCounts.bufferBytes -= found->second;
+		m_bufferSizes.erase(found);
+	}
+	m_stateCache.DeleteBuffer(buffer);
+}
+
+/***********************************************************
+ *  CreateVertexLayout()
+ *
+ *  This method is used for creating a vertex array that
+ *  reads the passed attributes and index buffer.  It stays
+ *  bound, which is fine since its index buffer is already
+ *  set and the other buffers are bound to copy targets.
+ ***********************************************************/
+uint32_t GLRenderBackend::CreateVertexLayout(const VERTEX_ATTRIBUTE* pAttributes, int attributeCount, uint32_t indexBuffer)
+{
+	GLuint vertexArray = 0;
+	glGenVertexArrays(1, &vertexArray);
+	m_stateCache.BindVertexArray(vertexArray);
+
+	for (int i = 0; i < attributeCount; i++)
+	{
+		const VERTEX_ATTRIBUTE& attribute = pAttributes[i];
+		m_stateCache.BindBuffer(GL_ARRAY_BUFFER, attribute.buffer);
+		glVertexAttribPointer(
+			attribute.location,
+			attribute.components,
+			GL_FLOAT,
+			GL_FALSE,
+			attribute.stride,
+			(void*)(size_t)attribute.offset);
+		glEnableVertexAttribArray(attribute.location);
+	}
+
+	m_stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+	return(vertexArray);
+}
+
+/***********************************************************
+ *  DestroyVertexLayout()
+ *
+ *  This method is used for deleting a vertex array.
+ ***********************************************************/
+void GLRenderBackend::DestroyVertexLayout(uint32_t layout)
+{
+	m_stateCache.DeleteVertexArray(layout);
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used for creating a texture from 8 bit
+ *  RGB or RGBA pixels, configuring the texture mapping
+ *  parameters and generating the mipmaps.  The texture is
+ *  left bound to the active unit, where the cache knows it.
+ ***********************************************************/
+uint32_t GLRenderBackend::CreateTexture(int width, int height, int channels, const unsigned char* pPixels)
+{
+	GLuint textureID = 0;
+	glGenTextures(1, &textureID);
+	m_stateCache.BindTexture(textureID);
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// if the image is in RGB format
+	if (channels == 3)
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, pPixels);
+	// if the image is in RGBA format - it supports transparency
+	else
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pPixels);
+
+	// generate the texture mipmaps for mapping textures to lower resolutions
+	glGenerateMipmap(GL_TEXTURE_2D);
+
+	// the mipmaps add a third, and drivers keep RGB as RGBA
+	size_t bytes = static_cast<size_t>(width) * height * 4 * 4 / 3;
+	m_textureSizes[textureID] = bytes;
+	m_frameCounts.textureBytes += bytes;
+	return(textureID);
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used for binding a texture to one of the
+ *  texture units.
+ ***********************************************************/
+void GLRenderBackend::BindTexture(int slot, uint32_t texture)
+{
+	m_stateCache.BindTexture(slot, texture);
+}
+
+/***********************************************************
+ *  DestroyTexture()
+ *
+ *  This method is used for deleting a texture.
+ ***********************************************************/
+void GLRenderBackend::DestroyTexture(uint32_t texture)
+{
+	std::unordered_map<GLuint, size_t>::iterator found = m_textureSizes.find(texture);
+	if (found != m_textureSizes.end())
+	{
+		m_frameCounts.textureBytes -= found->second;
+		m_textureSizes.erase(found);
+	}
+	m_stateCache.DeleteTexture(texture);
+}
+
+/***********************************************************
+ *  CreateProgram()
+ *
+ *  This method is used for compiling and linking a program
+ *  from GLSL files with the shader manager.  The cache
+ *  cannot see what the shader manager binds while loading,
+ *  so it starts over.
+ ***********************************************************/
+uint32_t GLRenderBackend::CreateProgram(const char* vertexFilename, const char* fragmentFilename)
+{
+	uint32_t program = m_pShaderManager->LoadShaders(vertexFilename, fragmentFilename);
+	m_stateCache.Invalidate();
+	return(program);
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used for making a program current, which
+ *  is also the one the shader manager sets uniforms on.
+ ***********************************************************/
+void GLRenderBackend::UseProgram(uint32_t program)
+{
+	m_pShaderManager->m_programID = program;
+	m_stateCache.UseProgram(program);
+}
+
+/***********************************************************
+ *  SetUniformInt()
+ *
+ *  This method is used for setting an int or bool uniform.
+ ***********************************************************/
+void GLRenderBackend::SetUniformInt(const std::string& name, int value)
+{
+	m_pShaderManager->setIntValue(name, value);
+}
+
+/***********************************************************
+ *  SetUniformFloat()
+ *
+ *  This method is used for setting a float uniform.
+ ***********************************************************/
+void GLRenderBackend::SetUniformFloat(const std::string& name, float value)
+{
+	m_pShaderManager->setFloatValue(name, value);
+}
+
+/***********************************************************
+ *  SetUniformVec2()
+ *
+ *  This method is used for setting a vec2 uniform.
+ ***********************************************************/
+void GLRenderBackend::SetUniformVec2(const std::string& name, const glm::vec2& value)
+{
+	m_pShaderManager->setVec2Value(name, value);
+}
+
+/***********************************************************
+ *  SetUniformVec3()
+ *
+ *  This method is used for setting a vec3 uniform.
+ ***********************************************************/
+void GLRenderBackend::SetUniformVec3(const std::string& name, const glm::vec3& value)
+{
+	m_pShaderManager->setVec3Value(name, value);
+}
+
+/***********************************************************
+ *  SetUniformVec4()
+ *
+ *  This method is used for setting a vec4 uniform.
+ ***********************************************************/
+void GLRenderBackend::SetUniformVec4(const std::string& name, const glm::vec4& value)
+{
+	m_pShaderManager->setVec4Value(name, value);
+}
+
+/***********************************************************
+ *  SetUniformMat4()
+ *
+ *  This method is used for setting a mat4 uniform.
+ ***********************************************************/
+void GLRenderBackend::SetUniformMat4(const std::string& name, const glm::mat4& value)
+{
+	m_pShaderManager->setMat4Value(name, value);
+}
+
+/***********************************************************
+ *  SetUniformSampler()
+ *
+ *  This method is used for pointing a sampler uniform at a
+ *  texture unit.
+ ***********************************************************/
+void GLRenderBackend::SetUniformSampler(const std::string& name, int slot)
+{
+	m_pShaderManager->setSampler2DValue(name, slot);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting a frame.  OpenGL runs
+ *  the commands as they are made, so only the counts and
+ *  the GPU timer are started.
+ ***********************************************************/
+void GLRenderBackend::BeginFrame()
+{
+	m_stateCache.BeginFrame();
+	m_gpuTimer.BeginFrame();
+	m_frameCounts.drawCalls = 0;
+	m_frameCounts.triangles = 0;
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for finishing a frame.  The window
+ *  owner swaps the buffers.
+ ***********************************************************/
+void GLRenderBackend::EndFrame()
+{
+	m_gpuTimer.EndFrame();
+	m_stateCache.EndFrame();
+}
+
+/***********************************************************
+ *  CreateRenderTarget()
+ *
+ *  This method is used for creating a framebuffer with a
+ *  color texture and, when asked, a depth texture.  The
+ *  textures have no mipmaps and are clamped, since they
+ *  are read back one texel per pixel.  With more than one
+ *  sample the framebuffer draws into multisampled
+ *  renderbuffers instead, and a second framebuffer holds
+ *  the textures they are resolved into.
+ ***********************************************************/
+uint32_t GLRenderBackend::CreateRenderTarget(int width, int height, RENDER_TARGET_FORMAT format, bool bDepth, int samples)
+{
+	GL_RENDER_TARGET target;
+	target.texture = 0;
+	target.depth = 0;
+	target.width = width;
+	target.height = height;
+	target.samples = std::max(samples, 1);
+	target.colorSamples = 0;
+	target.depthSamples = 0;
+	target.resolveFramebuffer = 0;
+
+	GLint internalFormat = GL_RGBA8;
+	GLenum pixelFormat = GL_RGBA;
+	size_t texelBytes = 4;
+	if (RENDER_TARGET_RGBA16F == format)
+	{
+		internalFormat = GL_RGBA16F;
+		texelBytes = 8;
+	}
+	else if (RENDER_TARGET_R32F == format)
+	{
+		internalFormat = GL_R32F;
+		pixelFormat = GL_RED;
+	}
+
+	glGenTextures(1, &target.texture);
+	m_stateCache.BindTexture(target.texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, pixelFormat, GL_FLOAT, NULL);
+	if (bDepth)
+	{
+		// depth is read exactly, never filtered between texels
+		glGenTextures(1, &target.depth);
+		m_stateCache.BindTexture(target.depth);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	}
+
+	// the framebuffer of the textures, drawn into directly
+	// or resolved into
+	GLuint textureFramebuffer = 0;
+	glGenFramebuffers(1, &textureFramebuffer);
+	m_stateCache.BindFramebuffer(textureFramebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.texture, 0);
+	if (bDepth)
+	{
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, target.depth, 0);
+	}
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+	GLuint framebuffer = textureFramebuffer;
+	if ((GL_FRAMEBUFFER_COMPLETE == status) && (target.samples > 1))
+	{
+		target.resolveFramebuffer = textureFramebuffer;
+		glGenFramebuffers(1, &framebuffer);
+		m_stateCache.BindFramebuffer(framebuffer);
+		glGenRenderbuffers(1, &target.colorSamples);
+		glBindRenderbuffer(GL_RENDERBUFFER, target.colorSamples);
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, target.samples, internalFormat, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.colorSamples);
+		if (bDepth)
+		{
+			glGenRenderbuffers(1, &target.depthSamples);
+			glBindRenderbuffer(GL_RENDERBUFFER, target.depthSamples);
+			glRenderbufferStorageMultisample(GL_RENDERBUFFER, target.samples, GL_DEPTH_COMPONENT24, width, height);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, target.depthSamples);
+		}
+		status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	}
+
+	m_stateCache.BindFramebuffer(m_currentTarget);
+	if (GL_FRAMEBUFFER_COMPLETE != status)
+	{
+		std::cout << "Render target " << width << "x" << height << " with " << target.samples
+			<< " samples is incomplete: 0x" << std::hex << status << std::dec << std::endl;
+		m_stateCache.DeleteFramebuffer(textureFramebuffer);
+		if (framebuffer != textureFramebuffer)
+		{
+			m_stateCache.DeleteFramebuffer(framebuffer);
+		}
+		m_stateCache.DeleteTexture(target.texture);
+		if (0 != target.depth)
+		{
+			m_stateCache.DeleteTexture(target.depth);
+		}
+		if (0 != target.colorSamples)
+		{
+			glDeleteRenderbuffers(1, &target.colorSamples);
+		}
+		if (0 != target.depthSamples)
+		{
+			glDeleteRenderbuffers(1, &target.depthSamples);
+		}
+		return(0);
+	}
+
+	// the textures, and the samples drawn into when there are
+	// more than one
+	size_t pixelBytes = texelBytes + (bDepth ? 4 : 0);
+	size_t bytes = static_cast<size_t>(width) * height * pixelBytes;
+	if (target.samples > 1)
+	{
+		bytes += static_cast<size_t>(width) * height * pixelBytes * target.samples;
+	}
+	m_textureSizes[target.texture] = bytes;
+	m_frameCounts.textureBytes += bytes;
+	m_renderTargets[framebuffer] = target;
+	return(framebuffer);
+}
+
+/***********************************************************
+ *  GetRenderTargetTexture()
+ *
+ *  This method is used for getting the color texture of a
+ *  render target.
+ ***********************************************************/
+uint32_t GLRenderBackend::GetRenderTargetTexture(uint32_t target)
+{
+	std::unordered_map<GLuint, GL_RENDER_TARGET>::iterator found = m_renderTargets.find(target);
+	if (found == m_renderTargets.end())
+	{
+		return(0);
+	}
+	return(found->second.texture);
+}
+
+/***********************************************************
+ *  GetRenderTargetDepthTexture()
+ *
+ *  This method is used for getting the depth texture of a
+ *  render target, or zero when it has none.
+ ***********************************************************/
+uint32_t GLRenderBackend::GetRenderTargetDepthTexture(uint32_t target)
+{
+	std::unordered_map<GLuint, GL_RENDER_TARGET>::iterator found = m_renderTargets.find(target);
+	if (found == m_renderTargets.end())
+	{
+		return(0);
+	}
+	return(found->second.depth);
+}
+
+/***********************************************************
+ *  SetRenderTarget()
+ *
+ *  This method is used for drawing into a render target,
+ *  with the viewport covering it, or back into the window
+ *  with the viewport it had before.  A multisampled target
+ *  left behind is resolved, so its textures can be read.
+ ***********************************************************/
+void GLRenderBackend::SetRenderTarget(uint32_t target)
+{
+	if (target == m_currentTarget)
+	{
+		return;
+	}
+
+	std::unordered_map<GLuint, GL_RENDER_TARGET>::iterator found = m_renderTargets.find(target);
+	if ((0 != target) && (found == m_renderTargets.end()))
+	{
+		return;
+	}
+
+	if (0 == m_currentTarget)
+	{
+		glGetIntegerv(GL_VIEWPORT, m_frameViewport);
+	}
+	else
+	{
+		std::unordered_map<GLuint, GL_RENDER_TARGET>::iterator current = m_renderTargets.find(m_currentTarget);
+		if ((current != m_renderTargets.end()) && (current->second.samples > 1))
+		{
+			ResolveRenderTarget(current->first, current->second);
+		}
+	}
+	m_stateCache.BindFramebuffer(target);
+	if (0 == target)
+	{
+		glViewport(m_frameViewport[0], m_frameViewport[1], m_frameViewport[2], m_frameViewport[3]);
+	}
+	else
+	{
+		glViewport(0, 0, found->second.width, found->second.height);
+	}
+	m_currentTarget = target;
+}
+
+/***********************************************************
+ *  DestroyRenderTarget()
+ *
+ *  This method is used for deleting a render target and
+ *  its texture, going back to the window when it was the
+ *  one drawn into.
+ ***********************************************************/
+void GLRenderBackend::DestroyRenderTarget(uint32_t target)
+{
+	std::unordered_map<GLuint, GL_RENDER_TARGET>::iterator found = m_renderTargets.find(target);
+	if (found == m_renderTargets.end())
+	{
+		return;
+	}
+
+	if (target == m_currentTarget)
+	{
+		SetRenderTarget(0);
+	}
+	DestroyTexture(found->second.texture);
+	if (0 != found->second.depth)
+	{
+		m_stateCache.DeleteTexture(found->second.depth);
+	}
+	if (0 != found->second.colorSamples)
+	{
+		glDeleteRenderbuffers(1, &found->second.colorSamples);
+	}
+	if (0 != found->second.depthSamples)
+	{
+		glDeleteRenderbuffers(1, &found->second.depthSamples);
+	}
+	if (0 != found->second.resolveFramebuffer)
+	{
+		m_stateCache.DeleteFramebuffer(found->second.resolveFramebuffer);
+	}
+	m_stateCache.DeleteFramebuffer(target);
+	m_renderTargets.erase(found);
+}
+
+/***********************************************************
+ *  ResolveRenderTarget()
+ *
+ *  This method is used for averaging the color samples of a
+ *  multisampled target into its texture.  Depth samples are
+ *  not averaged - one of each pixel is kept.
+ ***********************************************************/
+void GLRenderBackend::ResolveRenderTarget(GLuint framebuffer, const GL_RENDER_TARGET& target)
+{
+	GLbitfield mask = GL_COLOR_BUFFER_BIT;
+	if (0 != target.depth)
+	{
+		mask |= GL_DEPTH_BUFFER_BIT;
+	}
+	m_stateCache.BlitFramebuffer(framebuffer, target.resolveFramebuffer, target.width, target.height, mask);
+}
+
+/***********************************************************
+ *  SetPipelineState()
+ *
+ *  This method is used for turning depth testing on or off
+ *  and choosing how colors are blended.
+ ***********************************************************/
+void GLRenderBackend::SetPipelineState(const PIPELINE_STATE& state)
+{
+	m_stateCache.SetCapability(GL_DEPTH_TEST, state.bDepthTest);
+	m_stateCache.SetCapability(GL_BLEND, BLEND_NONE != state.blendMode);
+	if (BLEND_ALPHA == state.blendMode)
+	{
+		m_stateCache.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+	else if (BLEND_ADDITIVE == state.blendMode)
+	{
+		m_stateCache.BlendFunc(GL_ONE, GL_ONE);
+	}
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for clearing the color and z buffers
+ *  of the window or render target being drawn.
+ ***********************************************************/
+void GLRenderBackend::Clear(const glm::vec4& color)
+{
+	m_stateCache.ClearColor(color.r, color.g, color.b, color.a);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+/***********************************************************
+ *  DrawIndexed()
+ *
+ *  This method is used for drawing a range of indexed
+ *  triangles from a vertex array.  The vertex array stays
+ *  bound, so the next draw from it binds nothing.
+ ***********************************************************/
+void GLRenderBackend::DrawIndexed(uint32_t layout, uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex)
+{
+	m_stateCache.BindVertexArray(layout);
+	glDrawElementsBaseVertex(
+		GL_TRIANGLES,
+		indexCount,
+		GL_UNSIGNED_INT,
+		(void*)(firstIndex * sizeof(uint32_t)),
+		baseVertex);
+
+	m_frameCounts.drawCalls++;
+	m_frameCounts.triangles += indexCount / 3;
+}
+
+/***********************************************************
+ *  DrawIndexedIndirect()
+ *
+ *  This method is used for drawing a list of triangle
+ *  ranges from a vertex array with one indirect multi-draw.
+ ***********************************************************/
+void GLRenderBackend::DrawIndexedIndirect(uint32_t layout, const DRAW_ELEMENTS_INDIRECT_COMMAND* pCommands, size_t commandCount)
+{
+	if (0 == commandCount)
+	{
+		return;
+	}
+
+	m_stateCache.BindVertexArray(layout);
+	m_frameCounts.drawCalls++;
+	for (size_t i = 0; i < commandCount; i++)
+	{
+		m_frameCounts.triangles += (pCommands[i].count / 3) * pCommands[i].instanceCount;
+	}
+#ifdef __APPLE__
+	// no indirect draws in OpenGL 3.3, so issue them one by one
+	for (size_t i = 0; i < commandCount; i++)
+	{
+		glDrawElementsBaseVertex(
+			GL_TRIANGLES,
+			pCommands[i].count,
+			GL_UNSIGNED_INT,
+			(void*)(pCommands[i].firstIndex * sizeof(uint32_t)),
+			pCommands[i].baseVertex);
+	}
+#else
+	if (0 == m_indirectBuffer)
+	{
+		glGenBuffers(1, &m_indirectBuffer);
+	}
+
+	// orphan the last commands and upload these
+	GLsizeiptr commandBytes = commandCount * sizeof(DRAW_ELEMENTS_INDIRECT_COMMAND);
+	m_stateCache.BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, commandBytes, pCommands, GL_STREAM_DRAW);
+	glMultiDrawElementsIndirect(
+		GL_TRIANGLES,
+		GL_UNSIGNED_INT,
+		(void*)0,
+		static_cast<GLsizei>(commandCount),
+		0);
+#endif
+}
+
+/***********************************************************
+ *  GetStateCache()
+ *
+ *  This method is used for getting the state cache, whose
+ *  counts show the calls it saved.
+ ***********************************************************/
+const GLStateCache& GLRenderBackend::GetStateCache() const
+{
+	return(m_stateCache);
+}
+
+/***********************************************************
+ *  GetGPUTimer()
+ *
+ *  This method is used for getting the timer the zones of
+ *  a frame are measured on the GPU with.
+ ***********************************************************/
+GLGPUTimer& GLRenderBackend::GetGPUTimer()
+{
+	return(m_gpuTimer);
+}
+
+/***********************************************************
+ *  GetFrameCounts()
+ *
+ *  This method is used for getting the draws of the frame
+ *  so far and the memory held by buffers and textures.
+ ***********************************************************/
+GL_FRAME_COUNTS GLRenderBackend::GetFrameCounts() const
+{
+	return(m_frameCounts);
+}
@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// glrenderbackend.h
+// ============
+// render through OpenGL
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLGPUTimer.h"
+#include "GLStateCache.h"
+#include "RenderBackend.h"
+#include "ShaderManager.h"
+
+#include <GL/glew.h>
+
+#include <unordered_map>
+
+/***********************************************************
+ *  GL_FRAME_COUNTS
+ *
+ *  What a frame has drawn so far, and the memory held by
+ *  the buffers and textures the backend has made.
+ ***********************************************************/
+struct GL_FRAME_COUNTS
+{
+	size_t drawCalls;
+	size_t triangles;
+	size_t bufferBytes;
+	// texture bytes, counting the mipmaps
+	size_t textureBytes;
+};
+
+/***********************************************************
+ *  GL_RENDER_TARGET
+ *
+ *  The OpenGL objects of a render target.  The handle is
+ *  the framebuffer name.  A multisampled target draws into
+ *  renderbuffers, resolved into the textures of a second
+ *  framebuffer when the drawing moves elsewhere.
+ ***********************************************************/
+struct GL_RENDER_TARGET
+{
+	GLuint texture;
+	// depth texture, or zero for none
+	GLuint depth;
+	int width;
+	int height;
+	int samples;
+	// the multisampled renderbuffers and the framebuffer of
+	// the textures they resolve into, or zero
+	GLuint colorSamples;
+	GLuint depthSamples;
+	GLuint resolveFramebuffer;
+};
+
+/***********************************************************
+ *  GLRenderBackend
+ *
+ *  This class implements the rendering interface with
+ *  OpenGL.  Programs are loaded and their uniforms set by
+ *  the shader manager, and the handles are the OpenGL
+ *  object names.  Vertex layouts are vertex arrays and
+ *  render targets are framebuffers.  State
+ *  and binding calls go through a cache that skips the ones
+ *  changing nothing, so nothing is unbound after use.  The
+ *  draws of each frame and the memory of the buffers and
+ *  textures are counted, and zones of the frame can be
+ *  timed on the GPU, for the performance overlay.
+ ***********************************************************/
+class GLRenderBackend : public RenderBackend
+{
+public:
+	// constructor
+	GLRenderBackend(ShaderManager* pShaderManager);
+	// destructor
+	virtual ~GLRenderBackend();
+
+	virtual uint32_t CreateBuffer(BUFFER_TYPE type, size_t size, const void* pData);
+	virtual void UpdateBuffer(uint32_t buffer, size_t offset, size_t size, const void* pData);
+	virtual void CopyBuffer(uint32_t source, uint32_t destination, size_t sourceOffset, size_t destinationOffset, size_t size);
+	virtual void DestroyBuffer(uint32_t buffer);
+
+	virtual uint32_t CreateVertexLayout(const VERTEX_ATTRIBUTE* pAttributes, int attributeCount, uint32_t indexBuffer);
+	virtual void DestroyVertexLayout(uint32_t layout);
+
+	virtual uint32_t CreateTexture(int width, int height, int channels, const unsigned char* pPixels);
+	virtual void BindTexture(int slot, uint32_t texture);
+	virtual void DestroyTexture(uint32_t texture);
+
+	virtual uint32_t CreateProgram(const char* vertexFilename, const char* fragmentFilename);
+	virtual void UseProgram(uint32_t program);
+	virtual void SetUniformInt(const std::string& name, int value);
+	virtual void SetUniformFloat(const std::string& name, float value);
+	virtual void SetUniformVec2(const std::string& name, const glm::vec2& value);
+	virtual void SetUniformVec3(const std::string& name, const glm::vec3& value);
+	virtual void SetUniformVec4(const std::string& name, const glm::vec4& value);
+	virtual void SetUniformMat4(const std::string& name, const glm::mat4& value);
+	virtual void SetUniformSampler(const std::string& name, int slot);
+
+	virtual void BeginFrame();
+	virtual void EndFrame();
+
+	virtual uint32_t CreateRenderTarget(int width, int height, RENDER_TARGET_FORMAT format, bool bDepth, int samples);
+	virtual uint32_t GetRenderTargetTexture(uint32_t target);
+	virtual uint32_t GetRenderTargetDepthTexture(uint32_t target);
+	virtual void SetRenderTarget(uint32_t target);
+	virtual void DestroyRenderTarget(uint32_t target);
+
+	virtual void SetPipelineState(const PIPELINE_STATE& state);
+	virtual void Clear(const glm::vec4& color);
+
+	virtual void DrawIndexed(uint32_t layout, uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex);
+	virtual void DrawIndexedIndirect(uint32_t layout, const DRAW_ELEMENTS_INDIRECT_COMMAND* pCommands, size_t commandCount);
+
+	// the state cache, for its counts of skipped calls
+	const GLStateCache& GetStateCache() const;
+	// GPU timer of the frame zones
+	GLGPUTimer& GetGPUTimer();
+	// counts of the frame so far
+	GL_FRAME_COUNTS GetFrameCounts() const;
+
+private:
+	// loads the programs and sets their uniforms
+	ShaderManager* m_pShaderManager;
+	// buffer the indirect draw commands are streamed through,
+	// created on first use
+	GLuint m_indirectBuffer;
+	// state last set on the context
+	GLStateCache m_stateCache;
+	GLGPUTimer m_gpuTimer;
+	GL_FRAME_COUNTS m_frameCounts;
+	// size of every buffer and texture alive, by name
+	std::unordered_map<GLuint, size_t> m_bufferSizes;
+	std::unordered_map<GLuint, size_t> m_textureSizes;
+	// render targets by framebuffer name, the one drawn
+	// into, and the window viewport to go back to
+	std::unordered_map<GLuint, GL_RENDER_TARGET> m_renderTargets;
+	GLuint m_currentTarget;
+	GLint m_frameViewport[4];
+
+	// copy the samples of a multisampled target into its
+	// textures
+	void ResolveRenderTarget(GLuint framebuffer, const GL_RENDER_TARGET& target);
+};
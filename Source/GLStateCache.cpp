@@ -0,0 +1,411 @@
+///////////////////////////////////////////////////////////////////////////////
+// glstatecache.cpp
+// ============
+// skip OpenGL state calls that would not change anything
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLStateCache.h"
+
+#include <cstring>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// name of a binding the cache does not know - OpenGL
+	// never hands out this name
+	const GLuint g_UnknownName = 0xFFFFFFFF;
+	// texture units tracked before any is used
+	const int g_InitialTextureUnits = 16;
+}
+
+/***********************************************************
+ *  GLStateCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GLStateCache::GLStateCache()
+{
+	memset(&m_frameCounts, 0, sizeof(m_frameCounts));
+	memset(&m_lastFrameCounts, 0, sizeof(m_lastFrameCounts));
+	memset(&m_totalCounts, 0, sizeof(m_totalCounts));
+	m_finishedFrames = 0;
+	Invalidate();
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for forgetting all of the cached
+ *  state, after OpenGL was used without the cache.
+ ***********************************************************/
+void GLStateCache::Invalidate()
+{
+	m_program = g_UnknownName;
+	m_vertexArray = g_UnknownName;
+	m_buffers.clear();
+	m_activeUnit = -1;
+	m_textures.assign(g_InitialTextureUnits, g_UnknownName);
+	m_samplers.assign(g_InitialTextureUnits, g_UnknownName);
+	m_framebuffer = g_UnknownName;
+	m_capabilities.clear();
+	m_blendSource = 0;
+	m_blendDestination = 0;
+	memset(m_clearColor, 0, sizeof(m_clearColor));
+	m_bClearColorKnown = false;
+}
+
+/***********************************************************
+ *  Request()
+ *
+ *  This method is used for counting a state request, and
+ *  returns whether it changes anything and must be made.
+ ***********************************************************/
+bool GLStateCache::Request(bool bChanged)
+{
+	m_frameCounts.calls++;
+	if (!bChanged)
+	{
+		m_frameCounts.skipped++;
+	}
+	return(bChanged);
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used for making a program current.
+ ***********************************************************/
+void GLStateCache::UseProgram(GLuint program)
+{
+	if (Request(program != m_program))
+	{
+		glUseProgram(program);
+		m_program = program;
+	}
+}
+
+/***********************************************************
+ *  BindVertexArray()
+ *
+ *  This method is used for binding a vertex array.
+ ***********************************************************/
+void GLStateCache::BindVertexArray(GLuint vertexArray)
+{
+	if (Request(vertexArray != m_vertexArray))
+	{
+		glBindVertexArray(vertexArray);
+		m_vertexArray = vertexArray;
+	}
+}
+
+/***********************************************************
+ *  BindBuffer()
+ *
+ *  This method is used for binding a buffer to a target.
+ *  The element array target is part of the bound vertex
+ *  array, so it is always set.
+ ***********************************************************/
+void GLStateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+	if (GL_ELEMENT_ARRAY_BUFFER == target)
+	{
+		Request(true);
+		glBindBuffer(target, buffer);
+		return;
+	}
+
+	std::unordered_map<GLenum, GLuint>::iterator bound = m_buffers.find(target);
+	if (Request((bound == m_buffers.end()) || (bound->second != buffer)))
+	{
+		glBindBuffer(target, buffer);
+		m_buffers[target] = buffer;
+	}
+}
+
+/***********************************************************
+ *  ActiveTexture()
+ *
+ *  This method is used for selecting the texture unit the
+ *  next texture binds go to.
+ ***********************************************************/
+void GLStateCache::ActiveTexture(int unit)
+{
+	if (Request(unit != m_activeUnit))
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		m_activeUnit = unit;
+	}
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used for binding a 2D texture to the
+ *  active texture unit.
+ ***********************************************************/
+void GLStateCache::BindTexture(GLuint texture)
+{
+	if (m_activeUnit < 0)
+	{
+		ActiveTexture(0);
+	}
+	BindTexture(m_activeUnit, texture);
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used for binding a 2D texture to a
+ *  texture unit.  The unit is only made active when the
+ *  binding changes.
+ ***********************************************************/
+void GLStateCache::BindTexture(int unit, GLuint texture)
+{
+	if (unit >= static_cast<int>(m_textures.size()))
+	{
+		m_textures.resize(unit + 1, g_UnknownName);
+	}
+
+	if (Request(texture != m_textures[unit]))
+	{
+		ActiveTexture(unit);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		m_textures[unit] = texture;
+	}
+}
+
+/***********************************************************
+ *  BindSampler()
+ *
+ *  This method is used for binding a sampler object to a
+ *  texture unit, or zero to use the texture's parameters.
+ ***********************************************************/
+void GLStateCache::BindSampler(int unit, GLuint sampler)
+{
+	if (unit >= static_cast<int>(m_samplers.size()))
+	{
+		m_samplers.resize(unit + 1, g_UnknownName);
+	}
+
+	if (Request(sampler != m_samplers[unit]))
+	{
+		glBindSampler(unit, sampler);
+		m_samplers[unit] = sampler;
+	}
+}
+
+/***********************************************************
+ *  BindFramebuffer()
+ *
+ *  This method is used for binding the framebuffer draws
+ *  and clears go to, or zero for the window.
+ ***********************************************************/
+void GLStateCache::BindFramebuffer(GLuint framebuffer)
+{
+	if (Request(framebuffer != m_framebuffer))
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		m_framebuffer = framebuffer;
+	}
+}
+
+/***********************************************************
+ *  BlitFramebuffer()
+ *
+ *  This method is used for copying the passed buffers of
+ *  one framebuffer into another of the same size, as when
+ *  resolving samples.  The framebuffer bound before is
+ *  bound again, so the cache stays right.
+ ***********************************************************/
+void GLStateCache::BlitFramebuffer(GLuint source, GLuint destination, int width, int height, GLbitfield mask)
+{
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, source);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, destination);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, mask, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, (g_UnknownName == m_framebuffer) ? 0 : m_framebuffer);
+}
+
+/***********************************************************
+ *  SetCapability()
+ *
+ *  This method is used for enabling or disabling an OpenGL
+ *  capability like depth testing, blending or culling.
+ ***********************************************************/
+void GLStateCache::SetCapability(GLenum capability, bool bEnabled)
+{
+	std::unordered_map<GLenum, bool>::iterator known = m_capabilities.find(capability);
+	if (Request((known == m_capabilities.end()) || (known->second != bEnabled)))
+	{
+		if (bEnabled)
+		{
+			glEnable(capability);
+		}
+		else
+		{
+			glDisable(capability);
+		}
+		m_capabilities[capability] = bEnabled;
+	}
+}
+
+/***********************************************************
+ *  BlendFunc()
+ *
+ *  This method is used for setting the blend factors.
+ ***********************************************************/
+void GLStateCache::BlendFunc(GLenum source, GLenum destination)
+{
+	if (Request((source != m_blendSource) || (destination != m_blendDestination)))
+	{
+		glBlendFunc(source, destination);
+		m_blendSource = source;
+		m_blendDestination = destination;
+	}
+}
+
+/***********************************************************
+ *  ClearColor()
+ *
+ *  This method is used for setting the color the frame is
+ *  cleared to.
+ ***********************************************************/
+void GLStateCache::ClearColor(float red, float green, float blue, float alpha)
+{
+	bool bChanged = !m_bClearColorKnown ||
+		(red != m_clearColor[0]) || (green != m_clearColor[1]) ||
+		(blue != m_clearColor[2]) || (alpha != m_clearColor[3]);
+	if (Request(bChanged))
+	{
+		glClearColor(red, green, blue, alpha);
+		m_clearColor[0] = red;
+		m_clearColor[1] = green;
+		m_clearColor[2] = blue;
+		m_clearColor[3] = alpha;
+		m_bClearColorKnown = true;
+	}
+}
+
+/***********************************************************
+ *  DeleteBuffer()
+ *
+ *  This method is used for deleting a buffer.  OpenGL
+ *  unbinds it from every target it was bound to.
+ ***********************************************************/
+void GLStateCache::DeleteBuffer(GLuint buffer)
+{
+	glDeleteBuffers(1, &buffer);
+
+	std::unordered_map<GLenum, GLuint>::iterator bound = m_buffers.begin();
+	for (; bound != m_buffers.end(); ++bound)
+	{
+		if (bound->second == buffer)
+		{
+			bound->second = 0;
+		}
+	}
+}
+
+/***********************************************************
+ *  DeleteVertexArray()
+ *
+ *  This method is used for deleting a vertex array, which
+ *  reverts the binding to zero when it was bound.
+ ***********************************************************/
+void GLStateCache::DeleteVertexArray(GLuint vertexArray)
+{
+	glDeleteVertexArrays(1, &vertexArray);
+
+	if (m_vertexArray == vertexArray)
+	{
+		m_vertexArray = 0;
+	}
+}
+
+/***********************************************************
+ *  DeleteTexture()
+ *
+ *  This method is used for deleting a texture, which is
+ *  unbound from every unit it was bound to.
+ ***********************************************************/
+void GLStateCache::DeleteTexture(GLuint texture)
+{
+	glDeleteTextures(1, &texture);
+
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		if (m_textures[i] == texture)
+		{
+			m_textures[i] = 0;
+		}
+	}
+}
+
+/***********************************************************
+ *  DeleteFramebuffer()
+ *
+ *  This method is used for deleting a framebuffer, which
+ *  reverts the binding to the window when it was bound.
+ ***********************************************************/
+void GLStateCache::DeleteFramebuffer(GLuint framebuffer)
+{
+	glDeleteFramebuffers(1, &framebuffer);
+
+	if (m_framebuffer == framebuffer)
+	{
+		m_framebuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting the counts of a frame.
+ ***********************************************************/
+void GLStateCache::BeginFrame()
+{
+	memset(&m_frameCounts, 0, sizeof(m_frameCounts));
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for keeping the counts of a finished
+ *  frame and adding them to the totals.
+ ***********************************************************/
+void GLStateCache::EndFrame()
+{
+	m_lastFrameCounts = m_frameCounts;
+	m_totalCounts.calls += m_frameCounts.calls;
+	m_totalCounts.skipped += m_frameCounts.skipped;
+	m_finishedFrames++;
+	memset(&m_frameCounts, 0, sizeof(m_frameCounts));
+}
+
+/***********************************************************
+ *  GetLastFrameCounts()
+ *
+ *  This method is used for getting the requests and the
+ *  skipped calls of the last finished frame.
+ ***********************************************************/
+const GL_STATE_CACHE_COUNTS& GLStateCache::GetLastFrameCounts() const
+{
+	return(m_lastFrameCounts);
+}
+
+/***********************************************************
+ *  GetAverageCounts()
+ *
+ *  This method is used for getting the requests and the
+ *  skipped calls per frame over every finished frame.
+ ***********************************************************/
+GL_STATE_CACHE_COUNTS GLStateCache::GetAverageCounts() const
+{
+	GL_STATE_CACHE_COUNTS average = m_totalCounts;
+	if (m_finishedFrames > 0)
+	{
+		average.calls /= m_finishedFrames;
+		average.skipped /= m_finishedFrames;
+	}
+	return(average);
+}
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+// glstatecache.h
+// ============
+// skip OpenGL state calls that would not change anything
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  GL_STATE_CACHE_COUNTS
+ *
+ *  State calls asked of the cache, and how many of them
+ *  were skipped because the state was already set.
+ ***********************************************************/
+struct GL_STATE_CACHE_COUNTS
+{
+	size_t calls;
+	size_t skipped;
+};
+
+/***********************************************************
+ *  GLStateCache
+ *
+ *  This class keeps a copy of the OpenGL binding and fixed
+ *  function state it has set, and only calls OpenGL when a
+ *  request differs from that copy.  It tracks the program,
+ *  vertex array, buffer targets, framebuffer, the active
+ *  texture unit, the texture and sampler of every unit, the
+ *  enabled
+ *  capabilities, blend function and clear color.  State it
+ *  has not set yet is unknown, so the first request always
+ *  reaches OpenGL; code that changes state behind the
+ *  cache's back must call Invalidate().
+ *
+ *  The element array binding belongs to the vertex array,
+ *  so it is set directly and never cached.
+ ***********************************************************/
+class GLStateCache
+{
+public:
+	// constructor - makes no OpenGL calls, so it may run
+	// before the context exists
+	GLStateCache();
+
+	// forget everything, so the next requests are all made
+	void Invalidate();
+
+	// bindings
+	void UseProgram(GLuint program);
+	void BindVertexArray(GLuint vertexArray);
+	void BindBuffer(GLenum target, GLuint buffer);
+	void ActiveTexture(int unit);
+	// bind on the active unit, for creating and uploading
+	void BindTexture(GLuint texture);
+	void BindTexture(int unit, GLuint texture);
+	void BindSampler(int unit, GLuint sampler);
+	// draw and read framebuffer, zero for the window
+	void BindFramebuffer(GLuint framebuffer);
+	// copy between framebuffers, leaving the bound one bound
+	void BlitFramebuffer(GLuint source, GLuint destination, int width, int height, GLbitfield mask);
+
+	// fixed function state
+	void SetCapability(GLenum capability, bool bEnabled);
+	void BlendFunc(GLenum source, GLenum destination);
+	void ClearColor(float red, float green, float blue, float alpha);
+
+	// delete objects and drop them from the bindings, as
+	// OpenGL does for the objects bound to the context
+	void DeleteBuffer(GLuint buffer);
+	void DeleteVertexArray(GLuint vertexArray);
+	void DeleteTexture(GLuint texture);
+	void DeleteFramebuffer(GLuint framebuffer);
+
+	// frames - the counts of the last finished frame and the
+	// mean over every frame so far
+	void BeginFrame();
+	void EndFrame();
+	const GL_STATE_CACHE_COUNTS& GetLastFrameCounts() const;
+	GL_STATE_CACHE_COUNTS GetAverageCounts() const;
+
+private:
+	GLuint m_program;
+	GLuint m_vertexArray;
+	std::unordered_map<GLenum, GLuint> m_buffers;
+	int m_activeUnit;
+	std::vector<GLuint> m_textures;
+	std::vector<GLuint> m_samplers;
+	GLuint m_framebuffer;
+	// capabilities by enum - missing ones are unknown
+	std::unordered_map<GLenum, bool> m_capabilities;
+	GLenum m_blendSource;
+	GLenum m_blendDestination;
+	float m_clearColor[4];
+	bool m_bClearColorKnown;
+
+	// counts of the frame in progress, the last one and the
+	// sums over the finished frames
+	GL_STATE_CACHE_COUNTS m_frameCounts;
+	GL_STATE_CACHE_COUNTS m_lastFrameCounts;
+	GL_STATE_CACHE_COUNTS m_totalCounts;
+	size_t m_finishedFrames;
+
+	// count a request, returning true when it must be made
+	bool Request(bool bChanged);
+};
@@ -0,0 +1,44 @@
+///////////////////////////////////////////////////////////////////////////////
+// imagefile.cpp
+// ============
+// write the color buffers of the CPU renderers to image files
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ImageFile.h"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+/***********************************************************
+ *  SavePPMImage()
+ *
+ *  This function is used for writing pixels into a binary
+ *  PPM image, which most image viewers can open.
+ ***********************************************************/
+bool SavePPMImage(const char* filename, int width, int height, const uint32_t* pixels)
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not write image:" << filename << std::endl;
+		return false;
+	}
+
+	file << "P6\n" << width << " " << height << "\n255\n";
+	std::vector<unsigned char> row(static_cast<size_t>(width) * 3);
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			uint32_t color = pixels[static_cast<size_t>(y) * width + x];
+			row[x * 3] = static_cast<unsigned char>(color & 0xFF);
+			row[x * 3 + 1] = static_cast<unsigned char>((color >> 8) & 0xFF);
+			row[x * 3 + 2] = static_cast<unsigned char>((color >> 16) & 0xFF);
+		}
+		file.write(reinterpret_cast<const char*>(row.data()), row.size());
+	}
+
+	return true;
+}
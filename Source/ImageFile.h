@@ -0,0 +1,14 @@
+///////////////////////////////////////////////////////////////////////////////
+// imagefile.h
+// ============
+// write the color buffers of the CPU renderers to image files
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+// write RGBA pixels, top row first, into a binary PPM file -
+// the alpha channel is dropped
+bool SavePPMImage(const char* filename, int width, int height, const uint32_t* pixels);
@@ -0,0 +1,751 @@
+///////////////////////////////////////////////////////////////////////////////
+// instrumentedrenderbackend.cpp
+// ============
+// count the rendering commands of each frame on their way to a backend
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InstrumentedRenderBackend.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// declaration of the global variables and helpers
+namespace
+{
+	/***********************************************************
+	 *  ClearStatistics()
+	 *
+	 *  This function is used for zeroing a set of counters.
+	 ***********************************************************/
+	void ClearStatistics(FRAME_STATISTICS& statistics)
+	{
+		memset(&statistics, 0, sizeof(statistics));
+	}
+
+	/***********************************************************
+	 *  AddStatistics()
+	 *
+	 *  This function is used for adding the counters of a
+	 *  frame to a running total.
+	 ***********************************************************/
+	void AddStatistics(FRAME_STATISTICS& totals, const FRAME_STATISTICS& frame)
+	{
+		totals.milliseconds += frame.milliseconds;
+		totals.drawCalls += frame.drawCalls;
+		totals.drawRanges += frame.drawRanges;
+		totals.triangles += frame.triangles;
+		totals.uniformUploads += frame.uniformUploads;
+		totals.redundantUniformUploads += frame.redundantUniformUploads;
+		totals.layoutBinds += frame.layoutBinds;
+		totals.redundantLayoutBinds += frame.redundantLayoutBinds;
+		totals.textureBinds += frame.textureBinds;
+		totals.redundantTextureBinds += frame.redundantTextureBinds;
+		totals.programChanges += frame.programChanges;
+		totals.redundantProgramChanges += frame.redundantProgramChanges;
+		totals.stateChanges += frame.stateChanges;
+		totals.redundantStateChanges += frame.redundantStateChanges;
+		totals.clears += frame.clears;
+		totals.bufferUploads += frame.bufferUploads;
+		totals.textureUploads += frame.textureUploads;
+		totals.bytesUploaded += frame.bytesUploaded;
+		totals.bytesCopied += frame.bytesCopied;
+	}
+
+	/***********************************************************
+	 *  WriteCount()
+	 *
+	 *  This function is used for writing one counter as a JSON
+	 *  member.  A divisor other than zero writes the counter
+	 *  divided by it, for averages.
+	 ***********************************************************/
+	void WriteCount(std::ostream& out, const char* name, size_t value, size_t divisor, bool bLast = false)
+	{
+		out << "\"" << name << "\": ";
+		if (divisor > 0)
+		{
+			out << static_cast<double>(value) / divisor;
+		}
+		else
+		{
+			out << value;
+		}
+		out << (bLast ? "" : ", ");
+	}
+
+	/***********************************************************
+	 *  WriteStatistics()
+	 *
+	 *  This function is used for writing a set of counters as
+	 *  one JSON object on one line.  Totals are passed with
+	 *  the number of frames they cover to write averages, and
+	 *  single frames with a divisor of zero.
+	 ***********************************************************/
+	void WriteStatistics(std::ostream& out, const FRAME_STATISTICS& statistics, size_t divisor)
+	{
+		out << "{";
+		if (0 == divisor)
+		{
+			WriteCount(out, "frame", statistics.frame, 0);
+		}
+		out << "\"milliseconds\": " << statistics.milliseconds / std::max<size_t>(divisor, 1) << ", ";
+		WriteCount(out, "drawCalls", statistics.drawCalls, divisor);
+		WriteCount(out, "drawRanges", statistics.drawRanges, divisor);
+		WriteCount(out, "triangles", statistics.triangles, divisor);
+		WriteCount(out, "uniformUploads", statistics.uniformUploads, divisor);
+		WriteCount(out, "redundantUniformUploads", statistics.redundantUniformUploads, divisor);
+		WriteCount(out, "layoutBinds", statistics.layoutBinds, divisor);
+		WriteCount(out, "redundantLayoutBinds", statistics.redundantLayoutBinds, divisor);
+		WriteCount(out, "textureBinds", statistics.textureBinds, divisor);
+		WriteCount(out, "redundantTextureBinds", statistics.redundantTextureBinds, divisor);
+		WriteCount(out, "programChanges", statistics.programChanges, divisor);
+		WriteCount(out, "redundantProgramChanges", statistics.redundantProgramChanges, divisor);
+		WriteCount(out, "stateChanges", statistics.stateChanges, divisor);
+		WriteCount(out, "redundantStateChanges", statistics.redundantStateChanges, divisor);
+		WriteCount(out, "clears", statistics.clears, divisor);
+		WriteCount(out, "bufferUploads", statistics.bufferUploads, divisor);
+		WriteCount(out, "textureUploads", statistics.textureUploads, divisor);
+		WriteCount(out, "bytesUploaded", statistics.bytesUploaded, divisor);
+		WriteCount(out, "bytesCopied", statistics.bytesCopied, divisor, true);
+		out << "}";
+	}
+}
+
+/***********************************************************
+ *  InstrumentedRenderBackend()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InstrumentedRenderBackend::InstrumentedRenderBackend(RenderBackend* pBackend, size_t historySize)
+{
+	m_pBackend = pBackend;
+	m_historySize = std::max<size_t>(historySize, 1);
+	m_bInFrame = false;
+	m_frameNumber = 0;
+
+	m_currentProgram = 0;
+	m_bProgramKnown = false;
+	m_pipelineState.bDepthTest = false;
+	m_pipelineState.blendMode = BLEND_NONE;
+	m_bStateKnown = false;
+	m_currentTarget = 0;
+	m_lastLayout = 0;
+
+	ClearStatistics(m_currentFrame);
+	ClearStatistics(m_setup);
+}
+
+/***********************************************************
+ *  Counters()
+ *
+ *  This method returns the counters of the frame being
+ *  drawn, or the setup counters between frames.
+ ***********************************************************/
+FRAME_STATISTICS& InstrumentedRenderBackend::Counters()
+{
+	return(m_bInFrame ? m_currentFrame : m_setup);
+}
+
+/***********************************************************
+ *  CreateBuffer()
+ *
+ *  This method is used for counting a buffer creation and
+ *  the bytes it is filled with.
+ ***********************************************************/
+uint32_t InstrumentedRenderBackend::CreateBuffer(BUFFER_TYPE type, size_t size, const void* pData)
+{
+	if (NULL != pData)
+	{
+		Counters().bufferUploads++;
+		Counters().bytesUploaded += size;
+	}
+	return(m_pBackend->CreateBuffer(type, size, pData));
+}
+
+/***********************************************************
+ *  UpdateBuffer()
+ *
+ *  This method is used for counting a buffer update.
+ ***********************************************************/
+void InstrumentedRenderBackend::UpdateBuffer(uint32_t buffer, size_t offset, size_t size, const void* pData)
+{
+	Counters().bufferUploads++;
+	Counters().bytesUploaded += size;
+	m_pBackend->UpdateBuffer(buffer, offset, size, pData);
+}
+
+/***********************************************************
+ *  CopyBuffer()
+ *
+ *  This method is used for counting a copy between buffers.
+ ***********************************************************/
+void InstrumentedRenderBackend::CopyBuffer(uint32_t source, uint32_t destination, size_t sourceOffset, size_t destinationOffset, size_t size)
+{
+	Counters().bytesCopied += size;
+	m_pBackend->CopyBuffer(source, destination, sourceOffset, destinationOffset, size);
+}
+
+/***********************************************************
+ *  DestroyBuffer()
+ *
+ *  This method is used for passing a buffer deletion on.
+ ***********************************************************/
+void InstrumentedRenderBackend::DestroyBuffer(uint32_t buffer)
+{
+	m_pBackend->DestroyBuffer(buffer);
+}
+
+/***********************************************************
+ *  CreateVertexLayout()
+ *
+ *  This method is used for passing a vertex layout creation
+ *  on.
+ ***********************************************************/
+uint32_t InstrumentedRenderBackend::CreateVertexLayout(const VERTEX_ATTRIBUTE* pAttributes, int attributeCount, uint32_t indexBuffer)
+{
+	return(m_pBackend->CreateVertexLayout(pAttributes, attributeCount, indexBuffer));
+}
+
+/***********************************************************
+ *  DestroyVertexLayout()
+ *
+ *  This method is used for passing a vertex layout deletion
+ *  on.  The handle may be given out again, so it no longer
+ *  counts as bound.
+ ***********************************************************/
+void InstrumentedRenderBackend::DestroyVertexLayout(uint32_t layout)
+{
+	if (m_lastLayout == layout)
+	{
+		m_lastLayout = 0;
+	}
+	m_pBackend->DestroyVertexLayout(layout);
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used for counting a texture upload.
+ ***********************************************************/
+uint32_t InstrumentedRenderBackend::CreateTexture(int width, int height, int channels, const unsigned char* pPixels)
+{
+	Counters().textureUploads++;
+	Counters().bytesUploaded += static_cast<size_t>(width) * height * channels;
+	return(m_pBackend->CreateTexture(width, height, channels, pPixels));
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used for counting a texture binding, and
+ *  whether the slot already held the texture.
+ ***********************************************************/
+void InstrumentedRenderBackend::BindTexture(int slot, uint32_t texture)
+{
+	Counters().textureBinds++;
+	auto bound = m_boundTextures.find(slot);
+	if ((bound != m_boundTextures.end()) && (bound->second == texture))
+	{
+		Counters().redundantTextureBinds++;
+	}
+	m_boundTextures[slot] = texture;
+	m_pBackend->BindTexture(slot, texture);
+}
+
+/***********************************************************
+ *  DestroyTexture()
+ *
+ *  This method is used for passing a texture deletion on
+ *  and emptying the slots that held it.
+ ***********************************************************/
+void InstrumentedRenderBackend::DestroyTexture(uint32_t texture)
+{
+	for (auto bound = m_boundTextures.begin(); bound != m_boundTextures.end(); ++bound)
+	{
+		if (bound->second == texture)
+		{
+			bound->second = 0;
+		}
+	}
+	m_pBackend->DestroyTexture(texture);
+}
+
+/***********************************************************
+ *  CreateProgram()
+ *
+ *  This method is used for passing a program creation on.
+ ***********************************************************/
+uint32_t InstrumentedRenderBackend::CreateProgram(const char* vertexFilename, const char* fragmentFilename)
+{
+	return(m_pBackend->CreateProgram(vertexFilename, fragmentFilename));
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used for counting a program change, and
+ *  whether the program was already in use.
+ ***********************************************************/
+void InstrumentedRenderBackend::UseProgram(uint32_t program)
+{
+	Counters().programChanges++;
+	if (m_bProgramKnown && (m_currentProgram == program))
+	{
+		Counters().redundantProgramChanges++;
+	}
+	m_currentProgram = program;
+	m_bProgramKnown = true;
+	m_pBackend->UseProgram(program);
+}
+
+/***********************************************************
+ *  CountUniform()
+ *
+ *  This method is used for counting a uniform upload, and
+ *  whether the program already had the same value.
+ ***********************************************************/
+void InstrumentedRenderBackend::CountUniform(const std::string& name, const void* pData, size_t size)
+{
+	Counters().uniformUploads++;
+
+	std::string value(static_cast<const char*>(pData), size);
+	std::string& lastValue = m_uniformValues[m_currentProgram][name];
+	if (lastValue == value)
+	{
+		Counters().redundantUniformUploads++;
+	}
+	else
+	{
+		lastValue = value;
+	}
+}
+
+/***********************************************************
+ *  SetUniformInt()
+ *
+ *  This method is used for counting an int uniform upload.
+ ***********************************************************/
+void InstrumentedRenderBackend::SetUniformInt(const std::string& name, int value)
+{
+	CountUniform(name, &value, sizeof(value));
+	m_pBackend->SetUniformInt(name, value);
+}
+
+/***********************************************************
+ *  SetUniformFloat()
+ *
+ *  This method is used for counting a float uniform upload.
+ ***********************************************************/
+void InstrumentedRenderBackend::SetUniformFloat(const std::string& name, float value)
+{
+	CountUniform(name, &value, sizeof(value));
+	m_pBackend->SetUniformFloat(name, value);
+}
+
+/***********************************************************
+ *  SetUniformVec2()
+ *
+ *  This method is used for counting a vec2 uniform upload.
+ ***********************************************************/
+void InstrumentedRenderBackend::SetUniformVec2(const std::string& name, const glm::vec2& value)
+{
+	float data[2] = { value.x, value.y };
+	CountUniform(name, data, sizeof(data));
+	m_pBackend->SetUniformVec2(name, value);
+}
+
+/***********************************************************
+ *  SetUniformVec3()
+ *
+ *  This method is used for counting a vec3 uniform upload.
+ ***********************************************************/
+void InstrumentedRenderBackend::SetUniformVec3(const std::string& name, const glm::vec3& value)
+{
+	float data[3] = { value.x, value.y, value.z };
+	CountUniform(name, data, sizeof(data));
+	m_pBackend->SetUniformVec3(name, value);
+}
+
+/***********************************************************
+ *  SetUniformVec4()
+ *
+ *  This method is used for counting a vec4 uniform upload.
+ ***********************************************************/
+void InstrumentedRenderBackend::SetUniformVec4(const std::string& name, const glm::vec4& value)
+{
+	float data[4] = { value.x, value.y, value.z, value.w };
+	CountUniform(name, data, sizeof(data));
+	m_pBackend->SetUniformVec4(name, value);
+}
+
+/***********************************************************
+ *  SetUniformMat4()
+ *
+ *  This method is used for counting a mat4 uniform upload.
+ ***********************************************************/
+void InstrumentedRenderBackend::SetUniformMat4(const std::string& name, const glm::mat4& value)
+{
+	float data[16];
+	for (int column = 0; column < 4; column++)
+	{
+		for (int row = 0; row < 4; row++)
+		{
+			data[column * 4 + row] = value[column][row];
+		}
+	}
+	CountUniform(name, data, sizeof(data));
+	m_pBackend->SetUniformMat4(name, value);
+}
+
+/***********************************************************
+ *  SetUniformSampler()
+ *
+ *  This method is used for counting a sampler uniform
+ *  upload.
+ ***********************************************************/
+void InstrumentedRenderBackend::SetUniformSampler(const std::string& name, int slot)
+{
+	CountUniform(name, &slot, sizeof(slot));
+	m_pBackend->SetUniformSampler(name, slot);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting the counters of a new
+ *  frame.
+ ***********************************************************/
+void InstrumentedRenderBackend::BeginFrame()
+{
+	ClearStatistics(m_currentFrame);
+	m_currentFrame.frame = m_frameNumber;
+	m_bInFrame = true;
+	m_frameStart = std::chrono::steady_clock::now();
+	m_pBackend->BeginFrame();
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for finishing the frame and keeping
+ *  its counters, dropping the oldest frame when the history
+ *  is full.
+ ***********************************************************/
+void InstrumentedRenderBackend::EndFrame()
+{
+	m_pBackend->EndFrame();
+	if (!m_bInFrame)
+	{
+		return;
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	m_currentFrame.milliseconds = std::chrono::duration<double, std::milli>(end - m_frameStart).count();
+	m_history.push_back(m_currentFrame);
+	if (m_history.size() > m_historySize)
+	{
+		m_history.pop_front();
+	}
+	m_bInFrame = false;
+	m_frameNumber++;
+}
+
+/***********************************************************
+ *  CreateRenderTarget()
+ *
+ *  This method is used for passing a render target on.
+ *  Nothing is uploaded, so nothing is counted.
+ ***********************************************************/
+uint32_t InstrumentedRenderBackend::CreateRenderTarget(int width, int height, RENDER_TARGET_FORMAT format, bool bDepth, int samples)
+{
+	return(m_pBackend->CreateRenderTarget(width, height, format, bDepth, samples));
+}
+
+/***********************************************************
+ *  GetRenderTargetTexture()
+ *
+ *  This method is used for getting the texture of a render
+ *  target from the wrapped backend.
+ ***********************************************************/
+uint32_t InstrumentedRenderBackend::GetRenderTargetTexture(uint32_t target)
+{
+	return(m_pBackend->GetRenderTargetTexture(target));
+}
+
+/***********************************************************
+ *  GetRenderTargetDepthTexture()
+ *
+ *  This method is used for getting the depth texture of a
+ *  render target from the wrapped backend.
+ ***********************************************************/
+uint32_t InstrumentedRenderBackend::GetRenderTargetDepthTexture(uint32_t target)
+{
+	return(m_pBackend->GetRenderTargetDepthTexture(target));
+}
+
+/***********************************************************
+ *  SetRenderTarget()
+ *
+ *  This method is used for counting a render target change
+ *  as a state change, and whether it was already set.
+ ***********************************************************/
+void InstrumentedRenderBackend::SetRenderTarget(uint32_t target)
+{
+	Counters().stateChanges++;
+	if (m_currentTarget == target)
+	{
+		Counters().redundantStateChanges++;
+	}
+	m_currentTarget = target;
+	m_pBackend->SetRenderTarget(target);
+}
+
+/***********************************************************
+ *  DestroyRenderTarget()
+ *
+ *  This method is used for passing a render target
+ *  deletion on.
+ ***********************************************************/
+void InstrumentedRenderBackend::DestroyRenderTarget(uint32_t target)
+{
+	if (m_currentTarget == target)
+	{
+		m_currentTarget = 0;
+	}
+	m_pBackend->DestroyRenderTarget(target);
+}
+
+/***********************************************************
+ *  SetPipelineState()
+ *
+ *  This method is used for counting a state change, and
+ *  whether the state was already set.
+ ***********************************************************/
+void InstrumentedRenderBackend::SetPipelineState(const PIPELINE_STATE& state)
+{
+	Counters().stateChanges++;
+	if (m_bStateKnown &&
+		(m_pipelineState.bDepthTest == state.bDepthTest) &&
+		(m_pipelineState.blendMode == state.blendMode))
+	{
+		Counters().redundantStateChanges++;
+	}
+	m_pipelineState = state;
+	m_bStateKnown = true;
+	m_pBackend->SetPipelineState(state);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for counting a clear.
+ ***********************************************************/
+void InstrumentedRenderBackend::Clear(const glm::vec4& color)
+{
+	Counters().clears++;
+	m_pBackend->Clear(color);
+}
+
+/***********************************************************
+ *  CountDraw()
+ *
+ *  This method is used for counting a draw call and the
+ *  layout binding it makes, which is redundant when the
+ *  previous draw used the same layout.
+ ***********************************************************/
+void InstrumentedRenderBackend::CountDraw(uint32_t layout)
+{
+	Counters().drawCalls++;
+	Counters().layoutBinds++;
+	if (m_lastLayout == layout)
+	{
+		Counters().redundantLayoutBinds++;
+	}
+	m_lastLayout = layout;
+}
+
+/***********************************************************
+ *  DrawIndexed()
+ *
+ *  This method is used for counting an indexed draw.
+ ***********************************************************/
+void InstrumentedRenderBackend::DrawIndexed(uint32_t layout, uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex)
+{
+	CountDraw(layout);
+	Counters().drawRanges++;
+	Counters().triangles += indexCount / 3;
+	m_pBackend->DrawIndexed(layout, indexCount, firstIndex, baseVertex);
+}
+
+/***********************************************************
+ *  DrawIndexedIndirect()
+ *
+ *  This method is used for counting an indirect draw, its
+ *  ranges and the commands it uploads.
+ ***********************************************************/
+void InstrumentedRenderBackend::DrawIndexedIndirect(uint32_t layout, const DRAW_ELEMENTS_INDIRECT_COMMAND* pCommands, size_t commandCount)
+{
+	if (0 != commandCount)
+	{
+		CountDraw(layout);
+		Counters().drawRanges += commandCount;
+		Counters().bytesUploaded += commandCount * sizeof(DRAW_ELEMENTS_INDIRECT_COMMAND);
+		for (size_t i = 0; i < commandCount; i++)
+		{
+			Counters().triangles += static_cast<size_t>(pCommands[i].count / 3) * pCommands[i].instanceCount;
+		}
+	}
+	m_pBackend->DrawIndexedIndirect(layout, pCommands, commandCount);
+}
+
+/***********************************************************
+ *  GetFrameCount()
+ *
+ *  This method returns how many finished frames are kept.
+ ***********************************************************/
+size_t InstrumentedRenderBackend::GetFrameCount() const
+{
+	return(m_history.size());
+}
+
+/***********************************************************
+ *  GetFrame()
+ *
+ *  This method returns the counters of a kept frame, the
+ *  oldest one at index zero.
+ ***********************************************************/
+const FRAME_STATISTICS& InstrumentedRenderBackend::GetFrame(size_t index) const
+{
+	return(m_history[index]);
+}
+
+/***********************************************************
+ *  GetLastFrame()
+ *
+ *  This method returns the counters of the last finished
+ *  frame.
+ ***********************************************************/
+const FRAME_STATISTICS& InstrumentedRenderBackend::GetLastFrame() const
+{
+	static FRAME_STATISTICS noFrame;
+	if (m_history.empty())
+	{
+		ClearStatistics(noFrame);
+		return(noFrame);
+	}
+	return(m_history.back());
+}
+
+/***********************************************************
+ *  GetAverageFrame()
+ *
+ *  This method returns the mean counters of the kept
+ *  frames.  The frame number is that of the last one.
+ ***********************************************************/
+FRAME_STATISTICS InstrumentedRenderBackend::GetAverageFrame() const
+{
+	FRAME_STATISTICS average;
+	ClearStatistics(average);
+	if (m_history.empty())
+	{
+		return(average);
+	}
+
+	for (size_t i = 0; i < m_history.size(); i++)
+	{
+		AddStatistics(average, m_history[i]);
+	}
+
+	size_t count = m_history.size();
+	average.frame = m_history.back().frame;
+	average.milliseconds /= count;
+	average.drawCalls /= count;
+	average.drawRanges /= count;
+	average.triangles /= count;
+	average.uniformUploads /= count;
+	average.redundantUniformUploads /= count;
+	average.layoutBinds /= count;
+	average.redundantLayoutBinds /= count;
+	average.textureBinds /= count;
+	average.redundantTextureBinds /= count;
+	average.programChanges /= count;
+	average.redundantProgramChanges /= count;
+	average.stateChanges /= count;
+	average.redundantStateChanges /= count;
+	average.clears /= count;
+	average.bufferUploads /= count;
+	average.textureUploads /= count;
+	average.bytesUploaded /= count;
+	average.bytesCopied /= count;
+	return(average);
+}
+
+/***********************************************************
+ *  GetSetupStatistics()
+ *
+ *  This method returns the counters of the commands made
+ *  outside of any frame.
+ ***********************************************************/
+const FRAME_STATISTICS& InstrumentedRenderBackend::GetSetupStatistics() const
+{
+	return(m_setup);
+}
+
+/***********************************************************
+ *  ResetStatistics()
+ *
+ *  This method is used for forgetting the kept frames and
+ *  the setup counts.  What the API has been told is still
+ *  known, so redundant calls keep being spotted.
+ ***********************************************************/
+void InstrumentedRenderBackend::ResetStatistics()
+{
+	m_history.clear();
+	ClearStatistics(m_setup);
+}
+
+/***********************************************************
+ *  SaveJSON()
+ *
+ *  This method is used for writing the statistics as JSON:
+ *  the setup counts, the exact mean of the kept frames and
+ *  one line per frame.
+ ***********************************************************/
+bool InstrumentedRenderBackend::SaveJSON(const char* filename) const
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not write frame statistics:" << filename << std::endl;
+		return false;
+	}
+
+	FRAME_STATISTICS totals;
+	ClearStatistics(totals);
+	for (size_t i = 0; i < m_history.size(); i++)
+	{
+		AddStatistics(totals, m_history[i]);
+	}
+
+	file << "{\n";
+	file << "  \"frameCount\": " << m_history.size() << ",\n";
+	file << "  \"setup\": ";
+	WriteStatistics(file, m_setup, 0);
+	file << ",\n";
+	file << "  \"average\": ";
+	WriteStatistics(file, totals, std::max<size_t>(m_history.size(), 1));
+	file << ",\n";
+	file << "  \"frames\": [\n";
+	for (size_t i = 0; i < m_history.size(); i++)
+	{
+		file << "    ";
+		WriteStatistics(file, m_history[i], 0);
+		file << ((i + 1 < m_history.size()) ? ",\n" : "\n");
+	}
+	file << "  ]\n";
+	file << "}\n";
+
+	return(static_cast<bool>(file));
+}
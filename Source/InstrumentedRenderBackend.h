@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+// instrumentedrenderbackend.h
+// ============
+// count the rendering commands of each frame on their way to a backend
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+
+/***********************************************************
+ *  FRAME_STATISTICS
+ *
+ *  What one frame asked of the graphics API.  The redundant
+ *  counts are calls that set what was already set, which
+ *  the driver still pays for.
+ ***********************************************************/
+struct FRAME_STATISTICS
+{
+	// frame number, and CPU time from BeginFrame() to the
+	// end of EndFrame()
+	size_t frame;
+	double milliseconds;
+	// draw calls, and the ranges and triangles they covered
+	size_t drawCalls;
+	size_t drawRanges;
+	size_t triangles;
+	size_t uniformUploads;
+	size_t redundantUniformUploads;
+	// vertex layouts bound by the draws, which bind their
+	// vertex and index buffers
+	size_t layoutBinds;
+	size_t redundantLayoutBinds;
+	size_t textureBinds;
+	size_t redundantTextureBinds;
+	size_t programChanges;
+	size_t redundantProgramChanges;
+	size_t stateChanges;
+	size_t redundantStateChanges;
+	size_t clears;
+	// buffer and texture uploads, and the bytes sent with
+	// them and with the indirect draw commands
+	size_t bufferUploads;
+	size_t textureUploads;
+	size_t bytesUploaded;
+	// bytes copied between buffers on the GPU
+	size_t bytesCopied;
+};
+
+/***********************************************************
+ *  InstrumentedRenderBackend
+ *
+ *  This class sits in front of another backend and passes
+ *  every command on after counting it.  Everything the
+ *  scene, view and main code draw goes through the backend
+ *  interface, so wrapping the OpenGL backend sees every GL
+ *  call they cause.  The counts of the last frames are kept
+ *  for querying and can be saved as JSON; commands made
+ *  outside a frame, like the scene's uploads, are counted
+ *  as setup.
+ ***********************************************************/
+class InstrumentedRenderBackend : public RenderBackend
+{
+public:
+	// constructor - the wrapped backend is not owned
+	InstrumentedRenderBackend(RenderBackend* pBackend, size_t historySize = 600);
+
+	virtual uint32_t CreateBuffer(BUFFER_TYPE type, size_t size, const void* pData);
+	virtual void UpdateBuffer(uint32_t buffer, size_t offset, size_t size, const void* pData);
+	virtual void CopyBuffer(uint32_t source, uint32_t destination, size_t sourceOffset, size_t destinationOffset, size_t size);
+	virtual void DestroyBuffer(uint32_t buffer);
+
+	virtual uint32_t CreateVertexLayout(const VERTEX_ATTRIBUTE* pAttributes, int attributeCount, uint32_t indexBuffer);
+	virtual void DestroyVertexLayout(uint32_t layout);
+
+	virtual uint32_t CreateTexture(int width, int height, int channels, const unsigned char* pPixels);
+	virtual void BindTexture(int slot, uint32_t texture);
+	virtual void DestroyTexture(uint32_t texture);
+
+	virtual uint32_t CreateProgram(const char* vertexFilename, const char* fragmentFilename);
+	virtual void UseProgram(uint32_t program);
+	virtual void SetUniformInt(const std::string& name, int value);
+	virtual void SetUniformFloat(const std::string& name, float value);
+	virtual void SetUniformVec2(const std::string& name, const glm::vec2& value);
+	virtual void SetUniformVec3(const std::string& name, const glm::vec3& value);
+	virtual void SetUniformVec4(const std::string& name, const glm::vec4& value);
+	virtual void SetUniformMat4(const std::string& name, const glm::mat4& value);
+	virtual void SetUniformSampler(const std::string& name, int slot);
+
+	virtual void BeginFrame();
+	virtual void EndFrame();
+
+	virtual uint32_t CreateRenderTarget(int width, int height, RENDER_TARGET_FORMAT format, bool bDepth, int samples);
+	virtual uint32_t GetRenderTargetTexture(uint32_t target);
+	virtual uint32_t GetRenderTargetDepthTexture(uint32_t target);
+	virtual void SetRenderTarget(uint32_t target);
+	virtual void DestroyRenderTarget(uint32_t target);
+
+	virtual void SetPipelineState(const PIPELINE_STATE& state);
+	virtual void Clear(const glm::vec4& color);
+
+	virtual void DrawIndexed(uint32_t layout, uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex);
+	virtual void DrawIndexedIndirect(uint32_t layout, const DRAW_ELEMENTS_INDIRECT_COMMAND* pCommands, size_t commandCount);
+
+	// finished frames kept, oldest first
+	size_t GetFrameCount() const;
+	const FRAME_STATISTICS& GetFrame(size_t index) const;
+	// most recent finished frame - all zero before the first
+	const FRAME_STATISTICS& GetLastFrame() const;
+	// mean of the kept frames, rounded down
+	FRAME_STATISTICS GetAverageFrame() const;
+	// commands made outside of any frame
+	const FRAME_STATISTICS& GetSetupStatistics() const;
+	// forget the kept frames and the setup counts
+	void ResetStatistics();
+
+	// write the setup counts, the average and every kept
+	// frame to a JSON file
+	bool SaveJSON(const char* filename) const;
+
+private:
+	RenderBackend* m_pBackend;
+	// finished frames, at most m_historySize of them
+	std::deque<FRAME_STATISTICS> m_history;
+	size_t m_historySize;
+	FRAME_STATISTICS m_currentFrame;
+	FRAME_STATISTICS m_setup;
+	bool m_bInFrame;
+	size_t m_frameNumber;
+	std::chrono::steady_clock::time_point m_frameStart;
+
+	// what the API has been told, for spotting redundant calls
+	uint32_t m_currentProgram;
+	bool m_bProgramKnown;
+	PIPELINE_STATE m_pipelineState;
+	bool m_bStateKnown;
+	uint32_t m_currentTarget;
+	uint32_t m_lastLayout;
+	std::unordered_map<int, uint32_t> m_boundTextures;
+	// last value of every uniform, by program and name
+	std::unordered_map<uint32_t, std::unordered_map<std::string, std::string>> m_uniformValues;
+
+	// counters the next command goes to
+	FRAME_STATISTICS& Counters();
+	void CountUniform(const std::string& name, const void* pData, size_t size);
+	void CountDraw(uint32_t layout);
+};
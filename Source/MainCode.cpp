@@ -1,177 +1,1214 @@
-#include <iostream>         // error handling and output
-#include <cstdlib>          // EXIT_FAILURE
-
-#include <GL/glew.h>        // GLEW library
-#include "GLFW/glfw3.h"     // GLFW library
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "SceneManager.h"
-#include "ViewManager.h"
-#include "ShapeMeshes.h"
-#include "ShaderManager.h"
-
-// Namespace for declaring global variables
-namespace
-{
-	// Macro for window title
-	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
-
-	// Main GLFW window
-	GLFWwindow* g_Window = nullptr;
-
-	// scene manager object for managing the 3D scene prepare and render
-	SceneManager* g_SceneManager = nullptr;
-	// shader manager object for dynamic interaction with the shader code
-	ShaderManager* g_ShaderManager = nullptr;
-	// view manager object for managing the 3D view setup and projection to 2D
-	ViewManager* g_ViewManager = nullptr;
-}
-
-// Function declarations - all functions that are called manually
-// need to be pre-declared at the beginning of the source code.
-bool InitializeGLFW();
-bool InitializeGLEW();
-
-
-/***********************************************************
- *  main(int, char*)
- *
- *  This function gets called after the application has been
- *  launched.
- ***********************************************************/
-int main(int argc, char* argv[])
-{
-	// if GLFW fails initialization, then terminate the application
-	if (InitializeGLFW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// try to create a new shader manager object
-	g_ShaderManager = new ShaderManager();
-	// try to create a new view manager object
-	g_ViewManager = new ViewManager(
-		g_ShaderManager);
-
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
-
-	// if GLEW fails initialization, then terminate the application
-	if (InitializeGLEW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// load the shader code from the external GLSL files
-	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
-
-	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
-	g_SceneManager->PrepareScene();
-
-	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
-	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
-
-		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
-
-		// refresh the 3D scene
-		g_SceneManager->RenderScene();
-
-
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
-
-		// query the latest GLFW events
-		glfwPollEvents();
-	}
-
-	// clear the allocated manager objects from memory
-	if (NULL != g_SceneManager)
-	{
-		delete g_SceneManager;
-		g_SceneManager = NULL;
-	}
-	if (NULL != g_ViewManager)
-	{
-		delete g_ViewManager;
-		g_ViewManager = NULL;
-	}
-	if (NULL != g_ShaderManager)
-	{
-		delete g_ShaderManager;
-		g_ShaderManager = NULL;
-	}
-
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS); 
-}
-
-/***********************************************************
- *	InitializeGLFW()
- * 
- *  This function is used to initialize the GLFW library.   
- ***********************************************************/
-bool InitializeGLFW()
-{
-	// GLFW: initialize and configure library
-	// --------------------------------------
-	glfwInit();
-
-#ifdef __APPLE__
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#else
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#endif
-	// GLFW: end -------------------------------
-
-	return(true);
-}
-
-/***********************************************************
- *	InitializeGLEW()
- *
- *  This function is used to initialize the GLEW library.
- ***********************************************************/
-bool InitializeGLEW()
-{
-	// GLEW: initialize
-	// -----------------------------------------
-	GLenum GLEWInitResult = GLEW_OK;
-
-	// try to initialize the GLEW library
-	GLEWInitResult = glewInit();
-	if (GLEW_OK != GLEWInitResult)
-	{
-		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
-		return false;
-	}
-	// GLEW: end -------------------------------
-
-	// Displays a successful OpenGL initialization message
-	std::cout << "INFO: OpenGL Successfully Initialized\n";
-	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
-
-	return(true);
-}
\ No newline at end of file
+#include <iostream>         // error handling and output
+#include <cstdlib>          // EXIT_FAILURE
+#include <string>
+#include <vector>
+#include <chrono>           // software frame timing
+#include <algorithm>
+
+#include <GL/glew.h>        // GLEW library
+#include "GLFW/glfw3.h"     // GLFW library
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "ShapeMeshes.h"
+#include "ShaderManager.h"
+#include "GLRenderBackend.h"
+#include "NullRenderBackend.h"
+#include "InstrumentedRenderBackend.h"
+#include "RecordingRenderBackend.h"
+#include "TraceReplayer.h"
+#include "SceneBenchmarks.h"
+#include "SelfTests.h"
+#include "PerformanceHUD.h"
+#include "DebugViewRenderer.h"
+#include "PostProcessChain.h"
+#include "AmbientOcclusionPasses.h"
+#include "AntiAliasingPasses.h"
+#include "ToneMapPasses.h"
+#include "FrameGraph.h"
+#include "AntiAliasing.h"
+#include "SceneReprojection.h"
+
+// Namespace for declaring global variables
+namespace
+{
+	// Macro for window title
+	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
+
+	// Main GLFW window
+	GLFWwindow* g_Window = nullptr;
+
+	// scene manager object for managing the 3D scene prepare and render
+	SceneManager* g_SceneManager = nullptr;
+	// shader manager object for dynamic interaction with the shader code
+	ShaderManager* g_ShaderManager = nullptr;
+	// rendering backend the scene and view managers draw through
+	RenderBackend* g_RenderBackend = nullptr;
+	// OpenGL backend, wrapped when frame statistics are collected
+	GLRenderBackend* g_GLRenderBackend = nullptr;
+	// counts the commands of each frame, or null when not wanted
+	InstrumentedRenderBackend* g_InstrumentedBackend = nullptr;
+	// records the commands into a trace, or null when not wanted
+	RecordingRenderBackend* g_RecordingBackend = nullptr;
+	// view manager object for managing the 3D view setup and projection to 2D
+	ViewManager* g_ViewManager = nullptr;
+	// performance overlay, shown with F1
+	PerformanceHUD* g_PerformanceHUD = nullptr;
+	// overdraw, draw cost and triangle density views, stepped
+	// through with F2
+	DebugViewRenderer* g_DebugViewRenderer = nullptr;
+	// passes the scene goes through on its way to the frame
+	PostProcessChain* g_PostProcessChain = nullptr;
+	// the passes of a frame, run in the order their reads and
+	// writes call for
+	FrameGraph* g_FrameGraph = nullptr;
+	// ambient occlusion, tone mapping and anti-aliasing passes
+	// of the chain
+	AmbientOcclusionPasses* g_AmbientOcclusionPasses = nullptr;
+	ToneMapPasses* g_ToneMapPasses = nullptr;
+	AntiAliasingPasses* g_AntiAliasingPasses = nullptr;
+	// the last frame's scene, reused where the camera still
+	// sees it once F4 turns it on
+	SceneReprojection* g_SceneReprojection = nullptr;
+	// whether the passes are timed on the GPU this frame
+	bool g_bTimePasses = false;
+
+	// frames of each mode the anti-aliasing benchmark skips
+	// while the targets are made and the GPU timer fills
+	const int AA_BENCHMARK_WARMUP_FRAMES = 16;
+}
+
+// Function declarations - all functions that are called manually
+// need to be pre-declared at the beginning of the source code.
+bool InitializeGLFW();
+bool InitializeGLEW();
+void DrawPerformanceHUD(uint32_t sceneProgram);
+void DrawSceneView(DEBUG_VIEW debugView, bool bReprojection, int width, int height, uint32_t sceneProgram);
+void AddPostProcessPasses(PostProcessChain* pChain, ANTI_ALIASING antiAliasing, bool bAmbientOcclusion);
+void BuildFrameGraph(DEBUG_VIEW debugView, ANTI_ALIASING antiAliasing, bool bReprojection, bool bAmbientOcclusion, bool bPerformanceHUD, uint32_t sceneProgram);
+double GetFrameGraphGPUMilliseconds();
+void PrintAntiAliasingBenchmark(const std::vector<double>& milliseconds, const std::vector<size_t>& bytes, int frames);
+void PrintPickedObject();
+void BeginFrameGraphPass(size_t position, const std::string& name);
+void EndFrameGraphPass(size_t position);
+SceneManager* CreateHeadlessScene(int width, int height, RenderBackend* pBackend);
+int RunNullBackend(int frameCount, int width, int height, const char* statisticsFilename);
+void PrintFrameStatistics(const FRAME_STATISTICS& statistics);
+int RunTraceReplay(const char* traceFilename, int loopCount, bool bNullBackend);
+int RunBenchmarks(const char* filter, const char* resultsFilename, int repetitions);
+int RunSelfTests(unsigned int seed);
+int RunSoftwareRenderer(int frameCount, int width, int height);
+int RunRayTracer(int samplesPerAxis, int width, int height, bool bShadows);
+int RunPathTracer(int sampleCount, int width, int height, int maxBounces);
+
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the application has been
+ *  launched.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	// "--null [frames] [width] [height] [json]" renders the scene
+	// through a backend that draws nothing, timing the CPU side
+	// alone, and saves the frame statistics when a file is named
+	if ((argc > 1) && (std::string(argv[1]) == "--null"))
+	{
+		int frameCount = (argc > 2) ? std::atoi(argv[2]) : 1000;
+		int width = (argc > 3) ? std::atoi(argv[3]) : 1000;
+		int height = (argc > 4) ? std::atoi(argv[4]) : 800;
+		const char* statisticsFilename = (argc > 5) ? argv[5] : NULL;
+		return(RunNullBackend(frameCount, width, height, statisticsFilename));
+	}
+
+	// "--software [frames] [width] [height]" renders the scene on
+	// the CPU without opening a window, for machines with no GPU
+	if ((argc > 1) && (std::string(argv[1]) == "--software"))
+	{
+		int frameCount = (argc > 2) ? std::atoi(argv[2]) : 100;
+		int width = (argc > 3) ? std::atoi(argv[3]) : 1000;
+		int height = (argc > 4) ? std::atoi(argv[4]) : 800;
+		return(RunSoftwareRenderer(frameCount, width, height));
+	}
+	// "--raytrace [samples] [width] [height] [shadows]" traces a
+	// still image, with samples by samples rays per pixel - pass
+	// 1 and 0 for an image comparable with --software
+	if ((argc > 1) && (std::string(argv[1]) == "--raytrace"))
+	{
+		int samplesPerAxis = (argc > 2) ? std::atoi(argv[2]) : 2;
+		int width = (argc > 3) ? std::atoi(argv[3]) : 1000;
+		int height = (argc > 4) ? std::atoi(argv[4]) : 800;
+		bool bShadows = (argc > 5) ? (std::atoi(argv[5]) != 0) : true;
+		return(RunRayTracer(samplesPerAxis, width, height, bShadows));
+	}
+	// "--pathtrace [samples] [width] [height] [bounces]" collects
+	// a ground truth image with bounced light
+	if ((argc > 1) && (std::string(argv[1]) == "--pathtrace"))
+	{
+		int sampleCount = (argc > 2) ? std::atoi(argv[2]) : 256;
+		int width = (argc > 3) ? std::atoi(argv[3]) : 1000;
+		int height = (argc > 4) ? std::atoi(argv[4]) : 800;
+		int maxBounces = (argc > 5) ? std::atoi(argv[5]) : 3;
+		return(RunPathTracer(sampleCount, width, height, maxBounces));
+	}
+
+	// "--replay trace [loops] [null]" issues the recorded frames
+	// of a trace again and again with no scene behind them
+	if ((argc > 2) && (std::string(argv[1]) == "--replay"))
+	{
+		int loopCount = (argc > 3) ? std::atoi(argv[3]) : 100;
+		bool bNullBackend = (argc > 4) && (std::string(argv[4]) == "null");
+		return(RunTraceReplay(argv[2], loopCount, bNullBackend));
+	}
+
+	// "--benchmark [filter] [json] [repetitions]" times the scene
+	// and view hot paths headless, running only the benchmarks
+	// whose names contain the filter ("all" for every one)
+	if ((argc > 1) && (std::string(argv[1]) == "--benchmark"))
+	{
+		const char* filter = ((argc > 2) && (std::string(argv[2]) != "all")) ? argv[2] : NULL;
+		const char* resultsFilename = (argc > 3) ? argv[3] : NULL;
+		int repetitions = (argc > 4) ? std::atoi(argv[4]) : 1;
+		return(RunBenchmarks(filter, resultsFilename, repetitions));
+	}
+
+	// "--selftest [seed]" checks the allocators, the picker and
+	// the collision grid against brute force on random cases,
+	// the same ones for the same seed
+	if ((argc > 1) && (std::string(argv[1]) == "--selftest"))
+	{
+		unsigned int seed = (argc > 2) ? static_cast<unsigned int>(std::atoi(argv[2])) : 1u;
+		return(RunSelfTests(seed));
+	}
+
+	// "--stats [json]" opens the window as usual and saves the
+	// statistics of the last frames when it is closed
+	const char* statisticsFilename = NULL;
+	if ((argc > 1) && (std::string(argv[1]) == "--stats"))
+	{
+		statisticsFilename = (argc > 2) ? argv[2] : "frame_statistics.json";
+	}
+	// "--record [trace] [frames]" opens the window as usual and
+	// saves the commands of the setup and the first frames
+	const char* traceFilename = NULL;
+	int recordFrames = 0;
+	if ((argc > 1) && (std::string(argv[1]) == "--record"))
+	{
+		traceFilename = (argc > 2) ? argv[2] : "frames.trace";
+		recordFrames = (argc > 3) ? std::atoi(argv[3]) : 60;
+	}
+	// "--aa-benchmark [frames]" opens the window and draws the
+	// frames with each anti-aliasing mode in turn, then prints
+	// the GPU time the passes of each took
+	int aaBenchmarkFrames = 0;
+	if ((argc > 1) && (std::string(argv[1]) == "--aa-benchmark"))
+	{
+		aaBenchmarkFrames = std::max((argc > 2) ? std::atoi(argv[2]) : 300, AA_BENCHMARK_WARMUP_FRAMES + 1);
+	}
+
+	// if GLFW fails initialization, then terminate the application
+	if (InitializeGLFW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// try to create a new shader manager object
+	g_ShaderManager = new ShaderManager();
+	// the rendering goes through OpenGL with the shader manager
+	g_GLRenderBackend = new GLRenderBackend(g_ShaderManager);
+	g_RenderBackend = g_GLRenderBackend;
+	if (NULL != statisticsFilename)
+	{
+		g_InstrumentedBackend = new InstrumentedRenderBackend(g_GLRenderBackend);
+		g_RenderBackend = g_InstrumentedBackend;
+	}
+	if (NULL != traceFilename)
+	{
+		g_RecordingBackend = new RecordingRenderBackend(g_RenderBackend, recordFrames);
+		g_RenderBackend = g_RecordingBackend;
+	}
+	// try to create a new view manager object
+	g_ViewManager = new ViewManager(
+		g_RenderBackend);
+
+	// try to create the main display window
+	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+
+	// if GLEW fails initialization, then terminate the application
+	if (InitializeGLEW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// load the shader code from the external GLSL files
+	uint32_t program = g_RenderBackend->CreateProgram(
+		"../../Utilities/shaders/vertexShader.glsl",
+		"../../Utilities/shaders/fragmentShader.glsl");
+
+	// the overlay's program and font atlas, drawn once F1
+	// turns it on
+	g_PerformanceHUD = new PerformanceHUD(g_RenderBackend);
+	g_PerformanceHUD->Create(
+		"Shaders/hudVertexShader.glsl",
+		"Shaders/hudFragmentShader.glsl");
+	g_DebugViewRenderer = new DebugViewRenderer(g_RenderBackend);
+	g_DebugViewRenderer->Create(
+		"Shaders/debugViewVertexShader.glsl",
+		"Shaders/debugViewFragmentShader.glsl",
+		"Shaders/fullscreenVertexShader.glsl",
+		"Shaders/overdrawFragmentShader.glsl");
+	g_PostProcessChain = new PostProcessChain(g_RenderBackend);
+	g_PostProcessChain->Create();
+	g_AmbientOcclusionPasses = new AmbientOcclusionPasses(g_RenderBackend);
+	g_AmbientOcclusionPasses->Create();
+	g_ToneMapPasses = new ToneMapPasses(g_RenderBackend);
+	g_ToneMapPasses->Create();
+	g_AntiAliasingPasses = new AntiAliasingPasses(g_RenderBackend);
+	g_AntiAliasingPasses->Create();
+	g_SceneReprojection = new SceneReprojection(g_RenderBackend);
+	g_SceneReprojection->Create(
+		"Shaders/fullscreenVertexShader.glsl",
+		"Shaders/reprojectionFragmentShader.glsl");
+	g_FrameGraph = new FrameGraph(g_RenderBackend);
+	g_FrameGraph->SetPassHooks(BeginFrameGraphPass, EndFrameGraphPass);
+
+	g_RenderBackend->UseProgram(program);
+
+	// try to create a new scene manager object and prepare the 3D scene
+	g_SceneManager = new SceneManager(g_RenderBackend);
+	g_SceneManager->PrepareScene();
+	// keep the camera out of the scene's objects
+	g_ViewManager->SetCollision(&g_SceneManager->GetCollision());
+
+	// what the frame graph was last declared for
+	bool bFrameGraphBuilt = false;
+	DEBUG_VIEW frameGraphView = DEBUG_VIEW_NONE;
+	ANTI_ALIASING frameGraphAntiAliasing = ANTI_ALIASING_NONE;
+	bool bFrameGraphReprojection = false;
+	bool bFrameGraphAmbientOcclusion = false;
+	bool bFrameGraphHUD = false;
+	// frames drawn, and the benchmark's sums for each mode
+	int frameNumber = 0;
+	std::vector<double> benchmarkMilliseconds(ANTI_ALIASING_COUNT, 0.0);
+	std::vector<size_t> benchmarkBytes(ANTI_ALIASING_COUNT, 0);
+	double previousFrameTime = glfwGetTime();
+
+	// loop will keep running until the application is closed 
+	// or until an error has occurred
+	while (!glfwWindowShouldClose(g_Window))
+	{
+		g_PerformanceHUD->BeginFrame();
+		g_RenderBackend->BeginFrame();
+		double frameTime = glfwGetTime();
+		float frameSeconds = static_cast<float>(frameTime - previousFrameTime);
+		previousFrameTime = frameTime;
+
+		// the debug view F2 has chosen draws the scene straight
+		// into the frame instead of through the post-processing
+		DEBUG_VIEW debugView = g_ViewManager->GetDebugView();
+		int frameWidth = 0;
+		int frameHeight = 0;
+		glfwGetFramebufferSize(g_Window, &frameWidth, &frameHeight);
+		g_SceneManager->SetDebugView(debugView, frameWidth, frameHeight);
+		g_PerformanceHUD->SetVisible(g_ViewManager->IsPerformanceHUDVisible());
+
+		// the benchmark steps through the anti-aliasing modes,
+		// and stops after the last
+		ANTI_ALIASING antiAliasing = g_ViewManager->GetAntiAliasing();
+		if (aaBenchmarkFrames > 0)
+		{
+			antiAliasing = static_cast<ANTI_ALIASING>(frameNumber / aaBenchmarkFrames);
+			if (ANTI_ALIASING_COUNT == antiAliasing)
+			{
+				PrintAntiAliasingBenchmark(benchmarkMilliseconds, benchmarkBytes, aaBenchmarkFrames - AA_BENCHMARK_WARMUP_FRAMES);
+				break;
+			}
+			g_ViewManager->SetAntiAliasing(antiAliasing);
+		}
+		g_bTimePasses = g_PerformanceHUD->IsVisible() || (aaBenchmarkFrames > 0);
+
+		// the scene reuses the last frame's pixels into one of
+		// two targets that swap, which the jittered and the
+		// multisampled scenes cannot
+		bool bReprojection = g_ViewManager->IsReprojectionEnabled() && (DEBUG_VIEW_NONE == debugView) &&
+			(ANTI_ALIASING_TAA != antiAliasing) && (1 == GetAntiAliasingSamples(antiAliasing)) &&
+			g_SceneReprojection->BeginFrame(frameWidth, frameHeight);
+
+		// declare the passes again when what the frame draws
+		// changes
+		bool bAmbientOcclusion = g_ViewManager->IsAmbientOcclusionEnabled();
+		if (!bFrameGraphBuilt || (debugView != frameGraphView) || (antiAliasing != frameGraphAntiAliasing) ||
+			(bReprojection != bFrameGraphReprojection) || (bAmbientOcclusion != bFrameGraphAmbientOcclusion) ||
+			(g_PerformanceHUD->IsVisible() != bFrameGraphHUD))
+		{
+			frameGraphView = debugView;
+			frameGraphAntiAliasing = antiAliasing;
+			bFrameGraphReprojection = bReprojection;
+			bFrameGraphAmbientOcclusion = bAmbientOcclusion;
+			bFrameGraphHUD = g_PerformanceHUD->IsVisible();
+			bFrameGraphBuilt = true;
+			BuildFrameGraph(frameGraphView, frameGraphAntiAliasing, bFrameGraphReprojection,
+				bFrameGraphAmbientOcclusion, bFrameGraphHUD, program);
+		}
+		if (bReprojection)
+		{
+			g_FrameGraph->ImportTarget("scene", g_SceneReprojection->GetCurrentTarget());
+		}
+
+		// temporal anti-aliasing reads the last frame and draws
+		// this one into the other history target; anything else
+		// leaves the history stale
+		bool bTemporal = g_AntiAliasingPasses->BeginFrame(g_FrameGraph,
+			(ANTI_ALIASING_TAA == antiAliasing) && (DEBUG_VIEW_NONE == debugView), frameWidth, frameHeight);
+
+		// the exposure eases from the last frame's, which the
+		// debug views leave alone
+		bool bExposure = g_ToneMapPasses->BeginFrame(g_FrameGraph, DEBUG_VIEW_NONE == debugView, frameSeconds);
+
+		// run the passes
+		g_FrameGraph->Execute(frameWidth, frameHeight);
+		if (bTemporal)
+		{
+			g_AntiAliasingPasses->EndFrame(g_ViewManager->GetProjectionMatrix() * g_ViewManager->GetViewMatrix());
+		}
+		if (bExposure)
+		{
+			g_ToneMapPasses->EndFrame();
+		}
+		if (bReprojection)
+		{
+			g_SceneReprojection->EndFrame(
+				g_ViewManager->GetViewMatrix(),
+				g_ViewManager->GetProjectionMatrix(),
+				g_SceneManager->GetReshadeBounds());
+		}
+		else
+		{
+			g_SceneReprojection->Invalidate();
+		}
+		// a click picks the object under the cursor, with the
+		// camera the frame was just drawn with
+		if (g_ViewManager->TakePickRequest())
+		{
+			PrintPickedObject();
+		}
+		if ((aaBenchmarkFrames > 0) && ((frameNumber % aaBenchmarkFrames) >= AA_BENCHMARK_WARMUP_FRAMES))
+		{
+			benchmarkMilliseconds[antiAliasing] += GetFrameGraphGPUMilliseconds();
+			benchmarkBytes[antiAliasing] = g_FrameGraph->GetPool().GetBytes() + (bTemporal ? g_AntiAliasingPasses->GetHistoryBytes() : 0);
+		}
+		frameNumber++;
+		g_RenderBackend->EndFrame();
+
+		// Flips the the back buffer with the front buffer every frame.
+		g_PerformanceHUD->BeginZone("swap");
+		glfwSwapBuffers(g_Window);
+		g_PerformanceHUD->EndZone();
+
+		// query the latest GLFW events
+		glfwPollEvents();
+	}
+
+	// clear the allocated manager objects from memory
+	if (NULL != g_PerformanceHUD)
+	{
+		delete g_PerformanceHUD;
+		g_PerformanceHUD = NULL;
+	}
+	if (NULL != g_DebugViewRenderer)
+	{
+		delete g_DebugViewRenderer;
+		g_DebugViewRenderer = NULL;
+	}
+	if (NULL != g_FrameGraph)
+	{
+		if (NULL != statisticsFilename)
+		{
+			const RenderTargetPool& pool = g_FrameGraph->GetPool();
+			std::cout << "Frame graph: " << g_FrameGraph->GetExecutedPassCount() << " of "
+				<< g_FrameGraph->GetPassCount() << " passes run, " << g_FrameGraph->GetBarrierCount() << " barriers, "
+				<< pool.GetTargetCount() << " pooled targets, " << pool.GetBytes() << " bytes" << std::endl;
+		}
+		delete g_FrameGraph;
+		g_FrameGraph = NULL;
+	}
+	if (NULL != g_AmbientOcclusionPasses)
+	{
+		delete g_AmbientOcclusionPasses;
+		g_AmbientOcclusionPasses = NULL;
+	}
+	if (NULL != g_AntiAliasingPasses)
+	{
+		delete g_AntiAliasingPasses;
+		g_AntiAliasingPasses = NULL;
+	}
+	if (NULL != g_ToneMapPasses)
+	{
+		delete g_ToneMapPasses;
+		g_ToneMapPasses = NULL;
+	}
+	if (NULL != g_SceneReprojection)
+	{
+		if (NULL != statisticsFilename)
+		{
+			std::cout << "Reprojection: " << g_SceneReprojection->GetReusedFrameCount() << " frames reused the last, "
+				<< g_SceneReprojection->GetFullFrameCount() << " drawn in full" << std::endl;
+		}
+		delete g_SceneReprojection;
+		g_SceneReprojection = NULL;
+	}
+	if (NULL != g_PostProcessChain)
+	{
+		delete g_PostProcessChain;
+		g_PostProcessChain = NULL;
+	}
+	if (NULL != g_SceneManager)
+	{
+		if (NULL != g_ViewManager)
+		{
+			g_ViewManager->SetCollision(NULL);
+		}
+		delete g_SceneManager;
+		g_SceneManager = NULL;
+	}
+	if (NULL != g_ViewManager)
+	{
+		delete g_ViewManager;
+		g_ViewManager = NULL;
+	}
+	if (NULL != g_RecordingBackend)
+	{
+		g_RecordingBackend->SaveTrace(traceFilename);
+		delete g_RecordingBackend;
+		g_RecordingBackend = NULL;
+	}
+	if (NULL != g_InstrumentedBackend)
+	{
+		PrintFrameStatistics(g_InstrumentedBackend->GetAverageFrame());
+		g_InstrumentedBackend->SaveJSON(statisticsFilename);
+		delete g_InstrumentedBackend;
+		g_InstrumentedBackend = NULL;
+	}
+	if (NULL != g_GLRenderBackend)
+	{
+		if (NULL != statisticsFilename)
+		{
+			GL_STATE_CACHE_COUNTS cacheCounts = g_GLRenderBackend->GetStateCache().GetAverageCounts();
+			std::cout << "GL state cache: " << cacheCounts.skipped << " of " << cacheCounts.calls
+				<< " state calls skipped per frame" << std::endl;
+		}
+		delete g_GLRenderBackend;
+		g_GLRenderBackend = NULL;
+	}
+	g_RenderBackend = NULL;
+	if (NULL != g_ShaderManager)
+	{
+		delete g_ShaderManager;
+		g_ShaderManager = NULL;
+	}
+
+	// Terminates the program successfully
+	exit(EXIT_SUCCESS); 
+}
+
+/***********************************************************
+ *	InitializeGLFW()
+ * 
+ *  This function is used to initialize the GLFW library.   
+ ***********************************************************/
+bool InitializeGLFW()
+{
+	// GLFW: initialize and configure library
+	// --------------------------------------
+	glfwInit();
+
+#ifdef __APPLE__
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#else
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#endif
+	// GLFW: end -------------------------------
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeGLEW()
+ *
+ *  This function is used to initialize the GLEW library.
+ ***********************************************************/
+bool InitializeGLEW()
+{
+	// GLEW: initialize
+	// -----------------------------------------
+	GLenum GLEWInitResult = GLEW_OK;
+
+	// try to initialize the GLEW library
+	GLEWInitResult = glewInit();
+	if (GLEW_OK != GLEWInitResult)
+	{
+		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
+		return false;
+	}
+	// GLEW: end -------------------------------
+
+	// Displays a successful OpenGL initialization message
+	std::cout << "INFO: OpenGL Successfully Initialized\n";
+	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *	DrawPerformanceHUD()
+ *
+ *  This function is used for passing the frame's counts
+ *  and zone times to the overlay and drawing it over the
+ *  scene.  The GPU times are a few frames old, since they
+ *  are read once the GPU has them.  The scene's program is
+ *  made current again for the next frame.
+ ***********************************************************/
+void DrawPerformanceHUD(uint32_t sceneProgram)
+{
+	GLGPUTimer& gpuTimer = g_GLRenderBackend->GetGPUTimer();
+	GL_FRAME_COUNTS counts = g_GLRenderBackend->GetFrameCounts();
+	g_PerformanceHUD->SetFrameCounts(counts.drawCalls, counts.triangles, counts.bufferBytes + counts.textureBytes);
+	size_t timedPasses = std::min(g_FrameGraph->GetExecutedPassCount(), gpuTimer.GetMaxZones());
+	for (size_t i = 0; i < timedPasses; i++)
+	{
+		g_PerformanceHUD->SetGPUZone(g_FrameGraph->GetExecutedPassName(i), gpuTimer.GetMilliseconds(i));
+	}
+
+	g_PerformanceHUD->Render(g_FrameGraph->GetWidth(), g_FrameGraph->GetHeight());
+
+	g_RenderBackend->UseProgram(sceneProgram);
+}
+
+/***********************************************************
+ *	DrawSceneView()
+ *
+ *  This function is used for drawing the scene into the
+ *  target the frame graph has bound, as the debug view
+ *  when one is on.  The debug program is current while the
+ *  camera is set so the view lands on it.  With the
+ *  reprojection on, what the camera still sees of the last
+ *  frame is drawn first, and the scene's depth test leaves
+ *  those pixels unshaded.
+ ***********************************************************/
+void DrawSceneView(DEBUG_VIEW debugView, bool bReprojection, int width, int height, uint32_t sceneProgram)
+{
+	// Enable z-depth, and blending for supporting transparent rendering
+	PIPELINE_STATE pipelineState;
+	pipelineState.bDepthTest = true;
+	pipelineState.blendMode = BLEND_ALPHA;
+	g_RenderBackend->SetPipelineState(pipelineState);
+
+	// Clear the color and z buffers, with the scene program
+	// current again after the passes of the last frame
+	g_RenderBackend->Clear(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	g_RenderBackend->UseProgram(sceneProgram);
+	if (DEBUG_VIEW_NONE != debugView)
+	{
+		g_DebugViewRenderer->Begin(debugView, width, height);
+	}
+
+	// convert from 3D object space to 2D view
+	g_ViewManager->PrepareSceneView();
+	g_SceneManager->SetViewParameters(
+		g_ViewManager->GetViewMatrix(),
+		g_ViewManager->GetProjectionMatrix(),
+		g_ViewManager->GetViewPosition());
+	// the passes after the scene use the camera it is drawn with
+	g_AmbientOcclusionPasses->SetProjection(g_ViewManager->GetProjectionMatrix());
+	g_AntiAliasingPasses->SetCamera(g_ViewManager->GetProjectionMatrix() * g_ViewManager->GetViewMatrix());
+	if (bReprojection && g_SceneReprojection->Draw(g_ViewManager->GetViewMatrix(), g_ViewManager->GetProjectionMatrix()))
+	{
+		g_RenderBackend->SetPipelineState(pipelineState);
+		g_RenderBackend->UseProgram(sceneProgram);
+	}
+
+	// refresh the 3D scene
+	g_SceneManager->RenderScene();
+	if (DEBUG_VIEW_NONE != debugView)
+	{
+		g_DebugViewRenderer->End();
+	}
+	g_RenderBackend->UseProgram(sceneProgram);
+}
+
+/***********************************************************
+ *	BuildFrameGraph()
+ *
+ *  This function is used for declaring the passes of the
+ *  frame: the scene into a half float target, multisampled
+ *  for MSAA, the post-processing and anti-aliasing passes
+ *  from it into the frame, and the overlay over them.  A
+ *  debug view draws the scene into the frame, which leaves
+ *  the post-processing passes with no reader, so the graph
+ *  is declared without them.  The reprojected scene is
+ *  drawn into the target it will reuse next frame, which
+ *  is imported in place of a transient one.
+ ***********************************************************/
+void BuildFrameGraph(DEBUG_VIEW debugView, ANTI_ALIASING antiAliasing, bool bReprojection, bool bAmbientOcclusion, bool bPerformanceHUD, uint32_t sceneProgram)
+{
+	g_FrameGraph->Reset();
+
+	FRAME_GRAPH_PASS scenePass;
+	scenePass.name = "scene";
+	if (DEBUG_VIEW_NONE == debugView)
+	{
+		scenePass.write = "scene";
+		if (bReprojection)
+		{
+			g_FrameGraph->ImportTarget(scenePass.write, g_SceneReprojection->GetCurrentTarget());
+		}
+		else
+		{
+			g_FrameGraph->DeclareTarget(scenePass.write, RENDER_TARGET_RGBA16F, 1.0f, true, GetAntiAliasingSamples(antiAliasing));
+		}
+	}
+	scenePass.execute = [debugView, bReprojection, sceneProgram](FrameGraph& graph)
+	{
+		DrawSceneView(debugView, bReprojection, graph.GetWidth(), graph.GetHeight(), sceneProgram);
+	};
+	g_FrameGraph->AddPass(scenePass);
+
+	if (DEBUG_VIEW_NONE == debugView)
+	{
+		g_PostProcessChain->ClearPasses();
+		AddPostProcessPasses(g_PostProcessChain, antiAliasing, bAmbientOcclusion);
+		g_PostProcessChain->AddToGraph(g_FrameGraph);
+
+		// the history targets replace the transient ones the
+		// chain declared for the exposure and TAA passes, and
+		// are imported again each frame as they swap
+		g_ToneMapPasses->ImportTargets(g_FrameGraph);
+		if (ANTI_ALIASING_TAA == antiAliasing)
+		{
+			g_AntiAliasingPasses->ImportTargets(g_FrameGraph);
+		}
+	}
+
+	if (bPerformanceHUD)
+	{
+		FRAME_GRAPH_PASS hudPass;
+		hudPass.name = "hud";
+		hudPass.execute = [sceneProgram](FrameGraph&)
+		{
+			DrawPerformanceHUD(sceneProgram);
+		};
+		g_FrameGraph->AddPass(hudPass);
+	}
+}
+
+/***********************************************************
+ *	BeginFrameGraphPass()
+ *
+ *  This function is used for timing each pass of the frame
+ *  graph on the CPU, and on the GPU while the overlay is
+ *  shown, under the pass's own name.
+ ***********************************************************/
+void BeginFrameGraphPass(size_t position, const std::string& name)
+{
+	if (g_bTimePasses)
+	{
+		g_GLRenderBackend->GetGPUTimer().BeginZone(position);
+	}
+	g_PerformanceHUD->BeginZone(name);
+}
+
+/***********************************************************
+ *	EndFrameGraphPass()
+ *
+ *  This function is used for ending the timing of a pass.
+ ***********************************************************/
+void EndFrameGraphPass(size_t)
+{
+	g_PerformanceHUD->EndZone();
+	if (g_bTimePasses)
+	{
+		g_GLRenderBackend->GetGPUTimer().EndZone();
+	}
+}
+
+/***********************************************************
+ *	GetFrameGraphGPUMilliseconds()
+ *
+ *  This function is used for adding up the GPU time of the
+ *  passes in the latest frame the timer has results for,
+ *  leaving out the overlay.
+ ***********************************************************/
+double GetFrameGraphGPUMilliseconds()
+{
+	GLGPUTimer& gpuTimer = g_GLRenderBackend->GetGPUTimer();
+	size_t timedPasses = std::min(g_FrameGraph->GetExecutedPassCount(), gpuTimer.GetMaxZones());
+	double milliseconds = 0.0;
+	for (size_t i = 0; i < timedPasses; i++)
+	{
+		if (g_FrameGraph->GetExecutedPassName(i) != "hud")
+		{
+			milliseconds += gpuTimer.GetMilliseconds(i);
+		}
+	}
+	return(milliseconds);
+}
+
+/***********************************************************
+ *	PrintAntiAliasingBenchmark()
+ *
+ *  This function is used for printing the average GPU time
+ *  of a frame in each anti-aliasing mode, with the memory
+ *  of its targets and its cost over drawing without any.
+ ***********************************************************/
+void PrintAntiAliasingBenchmark(const std::vector<double>& milliseconds, const std::vector<size_t>& bytes, int frames)
+{
+	double baseline = milliseconds[ANTI_ALIASING_NONE] / frames;
+	std::cout << "Anti-aliasing benchmark, GPU time of a frame's passes over " << frames << " frames:" << std::endl;
+	for (int mode = 0; mode < ANTI_ALIASING_COUNT; mode++)
+	{
+		double average = milliseconds[mode] / frames;
+		std::cout << "  " << GetAntiAliasingName(static_cast<ANTI_ALIASING>(mode)) << ": " << average << " ms ("
+			<< ((average >= baseline) ? "+" : "") << (average - baseline) << " ms), "
+			<< (bytes[mode] / (1024 * 1024)) << " MB of targets" << std::endl;
+	}
+}
+
+/***********************************************************
+ *	PrintPickedObject()
+ *
+ *  This function is used for printing the object under the
+ *  cursor, with the time the pick took.
+ ***********************************************************/
+void PrintPickedObject()
+{
+	glm::vec3 origin;
+	glm::vec3 direction;
+	g_ViewManager->GetCursorRay(origin, direction);
+
+	PICK_RESULT result;
+	SCENE_OBJECT object;
+	auto start = std::chrono::steady_clock::now();
+	bool bPicked = g_SceneManager->PickObject(origin, direction, result, object);
+	double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	if (!bPicked)
+	{
+		std::cout << "Picked nothing (" << microseconds << " us)" << std::endl;
+		return;
+	}
+
+	std::cout << "Picked object " << result.object << ", "
+		<< (object.meshTag.empty() ? ("shape " + std::to_string(object.shape)) : object.meshTag)
+		<< " with material " << object.materialTag << ", at " << result.position.x << ", "
+		<< result.position.y << ", " << result.position.z << " (" << microseconds << " us)" << std::endl;
+}
+
+/***********************************************************
+ *	AddPostProcessPasses()
+ *
+ *  This function is used for declaring the passes the
+ *  scene goes through: the ambient occlusion when it is
+ *  on, the bloom, exposure and tone mapping, and the
+ *  passes of the anti-aliasing mode, which read the tone
+ *  mapped frame from a target when there are any.
+ ***********************************************************/
+void AddPostProcessPasses(PostProcessChain* pChain, ANTI_ALIASING antiAliasing, bool bAmbientOcclusion)
+{
+	std::string scene = "scene";
+	if (bAmbientOcclusion)
+	{
+		scene = g_AmbientOcclusionPasses->AddPasses(pChain, scene);
+	}
+
+	bool bFiltered = g_AntiAliasingPasses->HasPasses(antiAliasing);
+	g_ToneMapPasses->AddPasses(pChain, scene, bFiltered ? "toneMapped" : "");
+	g_AntiAliasingPasses->AddPasses(pChain, antiAliasing, "toneMapped");
+}
+
+/***********************************************************
+ *	CreateHeadlessScene()
+ *
+ *  This function is used for preparing the scene without a
+ *  window, seen from the camera position the view manager
+ *  starts with.
+ ***********************************************************/
+SceneManager* CreateHeadlessScene(int width, int height, RenderBackend* pBackend)
+{
+	// without a rendering backend the scene keeps only the CPU
+	// copies of its meshes and textures
+	SceneManager* pSceneManager = new SceneManager(pBackend);
+	pSceneManager->PrepareScene();
+
+	glm::vec3 position = glm::vec3(0.0f, 3.3f, 12.0f);
+	glm::vec3 front = glm::vec3(0.0f, -0.5f, -2.0f);
+	glm::mat4 view = glm::lookAt(position, position + front, glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::mat4 projection = glm::perspective(
+		glm::radians(80.0f), (GLfloat)width / (GLfloat)height, 0.1f, 100.0f);
+	pSceneManager->SetViewParameters(view, projection, position);
+
+	return(pSceneManager);
+}
+
+/***********************************************************
+ *	RunNullBackend()
+ *
+ *  This function is used for timing RenderScene() through
+ *  the null backend from the default camera position.  No
+ *  GPU or window is needed, so the time is the CPU cost of
+ *  walking, culling and batching the scene and of building
+ *  its commands, and the command counts of the last frame
+ *  are printed with it.  With a statistics file the frames
+ *  also go through the instrumentation layer, whose counts
+ *  are the same on every machine, so CI can hold them
+ *  against earlier runs.
+ ***********************************************************/
+int RunNullBackend(int frameCount, int width, int height, const char* statisticsFilename)
+{
+	if ((frameCount < 1) || (width < 1) || (height < 1))
+	{
+		std::cout << "Invalid null backend settings" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	NullRenderBackend* pNullBackend = new NullRenderBackend();
+	RenderBackend* pBackend = pNullBackend;
+	InstrumentedRenderBackend* pInstrumentedBackend = NULL;
+	if (NULL != statisticsFilename)
+	{
+		pInstrumentedBackend = new InstrumentedRenderBackend(pNullBackend, frameCount);
+		pBackend = pInstrumentedBackend;
+	}
+	SceneManager* pSceneManager = CreateHeadlessScene(width, height, pBackend);
+
+	PIPELINE_STATE pipelineState;
+	pipelineState.bDepthTest = true;
+	pipelineState.blendMode = BLEND_ALPHA;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < frameCount; i++)
+	{
+		pNullBackend->ResetCommandCounts();
+		pBackend->BeginFrame();
+		pBackend->SetPipelineState(pipelineState);
+		pBackend->Clear(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		pSceneManager->RenderScene();
+		pBackend->EndFrame();
+	}
+	auto end = std::chrono::steady_clock::now();
+	double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+	const RENDER_COMMAND_COUNTS& counts = pNullBackend->GetCommandCounts();
+	std::cout << "Null backend: " << frameCount << " frames, " << (milliseconds / frameCount) << " ms per frame" << std::endl;
+	std::cout << "  per frame: " << counts.drawCalls << " draw calls, " << counts.drawRanges << " ranges, "
+		<< (counts.indices / 3) << " triangles, " << counts.uniformUpdates << " uniform updates, "
+		<< counts.textureBinds << " texture binds, " << counts.bufferBytes << " buffer bytes" << std::endl;
+
+	delete pSceneManager;
+	pSceneManager = NULL;
+	if (NULL != pInstrumentedBackend)
+	{
+		PrintFrameStatistics(pInstrumentedBackend->GetAverageFrame());
+		pInstrumentedBackend->SaveJSON(statisticsFilename);
+		delete pInstrumentedBackend;
+		pInstrumentedBackend = NULL;
+	}
+	delete pNullBackend;
+	pNullBackend = NULL;
+	pBackend = NULL;
+
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	PrintFrameStatistics()
+ *
+ *  This function is used for printing the counters of a
+ *  frame, with the share of the calls that were redundant.
+ ***********************************************************/
+void PrintFrameStatistics(const FRAME_STATISTICS& statistics)
+{
+	std::cout << "Frame statistics: " << statistics.milliseconds << " ms, "
+		<< statistics.drawCalls << " draw calls, " << statistics.drawRanges << " ranges, "
+		<< statistics.triangles << " triangles" << std::endl;
+	std::cout << "  uniforms " << statistics.uniformUploads << " (" << statistics.redundantUniformUploads << " redundant), "
+		<< "layouts " << statistics.layoutBinds << " (" << statistics.redundantLayoutBinds << "), "
+		<< "textures " << statistics.textureBinds << " (" << statistics.redundantTextureBinds << "), "
+		<< "programs " << statistics.programChanges << " (" << statistics.redundantProgramChanges << "), "
+		<< "states " << statistics.stateChanges << " (" << statistics.redundantStateChanges << ")" << std::endl;
+	std::cout << "  uploads " << statistics.bufferUploads << " buffers, " << statistics.textureUploads << " textures, "
+		<< statistics.bytesUploaded << " bytes, " << statistics.bytesCopied << " bytes copied" << std::endl;
+}
+
+/***********************************************************
+ *	RunTraceReplay()
+ *
+ *  This function is used for timing the frames of a
+ *  recorded trace, issued again with no scene behind them,
+ *  so only the driver and the GPU are measured.  OpenGL
+ *  draws into a hidden window; the null backend shows what
+ *  decoding the trace costs on its own.
+ ***********************************************************/
+int RunTraceReplay(const char* traceFilename, int loopCount, bool bNullBackend)
+{
+	if (loopCount < 1)
+	{
+		std::cout << "Invalid trace replay settings" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	TraceReplayer replayer;
+	if (!replayer.LoadTrace(traceFilename) || (0 == replayer.GetFrameCount()))
+	{
+		std::cout << "No frames to replay in " << traceFilename << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	GLFWwindow* pWindow = NULL;
+	ShaderManager* pShaderManager = NULL;
+	RenderBackend* pBackend = NULL;
+	if (bNullBackend)
+	{
+		pBackend = new NullRenderBackend();
+	}
+	else
+	{
+		InitializeGLFW();
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		pWindow = glfwCreateWindow(1000, 800, WINDOW_TITLE, NULL, NULL);
+		if (NULL == pWindow)
+		{
+			std::cout << "Failed to create a window for the replay" << std::endl;
+			glfwTerminate();
+			return(EXIT_FAILURE);
+		}
+		glfwMakeContextCurrent(pWindow);
+		if (InitializeGLEW() == false)
+		{
+			glfwTerminate();
+			return(EXIT_FAILURE);
+		}
+		pShaderManager = new ShaderManager();
+		pBackend = new GLRenderBackend(pShaderManager);
+	}
+
+	bool bReplayed = replayer.Prepare(pBackend);
+	// one untimed pass, so the driver has seen every state
+	// and every resource is resident
+	bReplayed = bReplayed && replayer.ReplayFrames(pBackend);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; (i < loopCount) && bReplayed; i++)
+	{
+		bReplayed = replayer.ReplayFrames(pBackend);
+	}
+	if (NULL != pWindow)
+	{
+		glFinish();
+	}
+	auto end = std::chrono::steady_clock::now();
+	double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+	if (bReplayed)
+	{
+		size_t frameCount = loopCount * replayer.GetFrameCount();
+		std::cout << "Replayed " << replayer.GetFrameCount() << " frames " << loopCount << " times: "
+			<< (milliseconds / frameCount) << " ms per frame" << std::endl;
+	}
+
+	replayer.Release(pBackend);
+	delete pBackend;
+	pBackend = NULL;
+	if (NULL != pShaderManager)
+	{
+		delete pShaderManager;
+		pShaderManager = NULL;
+	}
+	if (NULL != pWindow)
+	{
+		glfwDestroyWindow(pWindow);
+		glfwTerminate();
+	}
+
+	return(bReplayed ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/***********************************************************
+ *	RunBenchmarks()
+ *
+ *  This function is used for running the microbenchmarks
+ *  and saving their results as Google Benchmark JSON when
+ *  a file is named.  Repeated runs give the regression
+ *  database enough samples to compare builds with.
+ ***********************************************************/
+int RunBenchmarks(const char* filter, const char* resultsFilename, int repetitions)
+{
+	if (repetitions < 1)
+	{
+		std::cout << "Invalid benchmark settings" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	SceneBenchmarks benchmarks;
+	if (!benchmarks.Prepare())
+	{
+		return(EXIT_FAILURE);
+	}
+
+	BenchmarkSuite suite(0.5, repetitions);
+	benchmarks.Register(suite);
+	if (0 == suite.Run(filter))
+	{
+		std::cout << "No benchmark matches " << ((NULL != filter) ? filter : "all") << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	if ((NULL != resultsFilename) && !suite.SaveJSON(resultsFilename))
+	{
+		return(EXIT_FAILURE);
+	}
+
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	RunSelfTests()
+ *
+ *  This function is used for running the randomized checks
+ *  headless, failing when any of them does.
+ ***********************************************************/
+int RunSelfTests(unsigned int seed)
+{
+	std::cout << "Self tests with seed " << seed << std::endl;
+	SelfTests selfTests(seed);
+	if (0 != selfTests.Run())
+	{
+		return(EXIT_FAILURE);
+	}
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	RunSoftwareRenderer()
+ *
+ *  This function is used for drawing the scene with the
+ *  CPU rasterizer from the default camera position, timing
+ *  the frames and saving the last one to software.ppm.
+ ***********************************************************/
+int RunSoftwareRenderer(int frameCount, int width, int height)
+{
+	if ((frameCount < 1) || (width < 1) || (height < 1))
+	{
+		std::cout << "Invalid software renderer settings" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	SceneManager* pSceneManager = CreateHeadlessScene(width, height, NULL);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < frameCount; i++)
+	{
+		pSceneManager->RenderSceneSoftware(width, height);
+	}
+	auto end = std::chrono::steady_clock::now();
+	double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+	std::cout << "Software renderer: " << frameCount << " frames at " << width << "x" << height
+		<< ", " << (milliseconds / frameCount) << " ms per frame" << std::endl;
+
+	pSceneManager->SaveSoftwareFrame("software.ppm");
+
+	delete pSceneManager;
+	pSceneManager = NULL;
+
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	RunRayTracer()
+ *
+ *  This function is used for tracing one still image of
+ *  the scene and saving it to raytrace.ppm.
+ ***********************************************************/
+int RunRayTracer(int samplesPerAxis, int width, int height, bool bShadows)
+{
+	if ((samplesPerAxis < 1) || (width < 1) || (height < 1))
+	{
+		std::cout << "Invalid ray tracer settings" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	SceneManager* pSceneManager = CreateHeadlessScene(width, height, NULL);
+
+	RAY_TRACE_SETTINGS settings;
+	settings.samplesPerAxis = samplesPerAxis;
+	settings.bShadows = bShadows;
+
+	auto start = std::chrono::steady_clock::now();
+	pSceneManager->RenderSceneRayTraced(width, height, settings);
+	auto end = std::chrono::steady_clock::now();
+	double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+	std::cout << "Ray tracer: " << width << "x" << height << " at " << (samplesPerAxis * samplesPerAxis)
+		<< " samples per pixel, " << milliseconds << " ms" << std::endl;
+
+	pSceneManager->SaveRayTracedFrame("raytrace.ppm");
+
+	delete pSceneManager;
+	pSceneManager = NULL;
+
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	RunPathTracer()
+ *
+ *  This function is used for collecting a path traced
+ *  reference image of the scene and saving it to
+ *  pathtrace.ppm.  The image so far is saved every 64
+ *  samples, so long runs can be checked on the way.
+ ***********************************************************/
+int RunPathTracer(int sampleCount, int width, int height, int maxBounces)
+{
+	if ((sampleCount < 1) || (width < 1) || (height < 1) || (maxBounces < 0))
+	{
+		std::cout << "Invalid path tracer settings" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	SceneManager* pSceneManager = CreateHeadlessScene(width, height, NULL);
+
+	PATH_TRACE_SETTINGS settings;
+	settings.maxBounces = maxBounces;
+	settings.bAmbientTerm = false;
+	settings.environmentColor = glm::vec3(0.0f);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < sampleCount; i++)
+	{
+		pSceneManager->RenderScenePathTraced(width, height, settings);
+		if ((pSceneManager->GetPathTracedSampleCount() % 64) == 0)
+		{
+			pSceneManager->SavePathTracedFrame("pathtrace.ppm");
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+	std::cout << "Path tracer: " << pSceneManager->GetPathTracedSampleCount() << " samples per pixel at "
+		<< width << "x" << height << ", " << (milliseconds / sampleCount) << " ms per sample" << std::endl;
+
+	pSceneManager->SavePathTracedFrame("pathtrace.ppm");
+
+	delete pSceneManager;
+	pSceneManager = NULL;
+
+	return(EXIT_SUCCESS);
+}
@@ -0,0 +1,889 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshbvh.cpp
+// ============
+// bounding volume hierarchies for casting rays against meshes and scenes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshBVH.h"
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// number of buckets the surface area heuristic tries
+	const int g_SplitBins = 12;
+	// deepest allowed node, which also bounds the size of
+	// the traversal stacks
+	const int g_MaxDepth = 60;
+	const int g_StackSize = g_MaxDepth + 4;
+
+	/***********************************************************
+	 *  SurfaceArea()
+	 *
+	 *  Area of the sides of a box, or zero for an empty box.
+	 ***********************************************************/
+	float SurfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+	{
+		glm::vec3 size = boundsMax - boundsMin;
+		if ((size.x < 0.0f) || (size.y < 0.0f) || (size.z < 0.0f))
+		{
+			return(0.0f);
+		}
+		return(2.0f * (size.x * size.y + size.y * size.z + size.z * size.x));
+	}
+
+	/***********************************************************
+	 *  SafeReciprocal()
+	 *
+	 *  One over a direction component, keeping zero
+	 *  components away from the infinity times zero case of
+	 *  the slab test.
+	 ***********************************************************/
+	float SafeReciprocal(float value)
+	{
+		if (std::fabs(value) < 1.0e-20f)
+		{
+			value = (value < 0.0f) ? -1.0e-20f : 1.0e-20f;
+		}
+		return(1.0f / value);
+	}
+
+	/***********************************************************
+	 *  SafeReciprocalPacket()
+	 *
+	 *  SafeReciprocal() for the four lanes of a packet.
+	 ***********************************************************/
+	__m128 SafeReciprocalPacket(__m128 value)
+	{
+		const __m128 signBit = _mm_set1_ps(-0.0f);
+		const __m128 tiny = _mm_set1_ps(1.0e-20f);
+		__m128 bSmall = _mm_cmplt_ps(_mm_andnot_ps(signBit, value), tiny);
+		__m128 signedTiny = _mm_or_ps(_mm_and_ps(value, signBit), tiny);
+		value = _mm_or_ps(_mm_and_ps(bSmall, signedTiny), _mm_andnot_ps(bSmall, value));
+		return(_mm_div_ps(_mm_set1_ps(1.0f), value));
+	}
+
+	/***********************************************************
+	 *  RayHitsBox()
+	 *
+	 *  Slab test of one ray against a node, giving the
+	 *  distance where the ray enters the box.
+	 ***********************************************************/
+	bool RayHitsBox(
+		const BVH_NODE& node,
+		const glm::vec3& origin,
+		const glm::vec3& inverseDirection,
+		float tMax,
+		float& entry)
+	{
+		glm::vec3 t0 = (node.boundsMin - origin) * inverseDirection;
+		glm::vec3 t1 = (node.boundsMax - origin) * inverseDirection;
+		glm::vec3 tNear = glm::min(t0, t1);
+		glm::vec3 tFar = glm::max(t0, t1);
+		entry = std::max(std::max(tNear.x, tNear.y), tNear.z);
+		float exit = std::min(std::min(tFar.x, tFar.y), tFar.z);
+		return((exit >= std::max(entry, 0.0f)) && (entry < tMax));
+	}
+
+	/***********************************************************
+	 *  PacketHitsBox()
+	 *
+	 *  Slab test of four rays against a node, returning one
+	 *  bit per ray that enters the box before its hit.
+	 ***********************************************************/
+	int PacketHitsBox(
+		const BVH_NODE& node,
+		const __m128 origin[3],
+		const __m128 inverseDirection[3],
+		__m128 t)
+	{
+		__m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.x), origin[0]), inverseDirection[0]);
+		__m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.x), origin[0]), inverseDirection[0]);
+		__m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.y), origin[1]), inverseDirection[1]);
+		__m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.y), origin[1]), inverseDirection[1]);
+		__m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.z), origin[2]), inverseDirection[2]);
+		__m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.z), origin[2]), inverseDirection[2]);
+
+		__m128 entry = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)), _mm_min_ps(t0z, t1z));
+		__m128 exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)), _mm_max_ps(t0z, t1z));
+		__m128 hit = _mm_and_ps(
+			_mm_cmpge_ps(exit, _mm_max_ps(entry, _mm_setzero_ps())),
+			_mm_cmplt_ps(entry, t));
+		return(_mm_movemask_ps(hit));
+	}
+
+	/***********************************************************
+	 *  NearChildFirst()
+	 *
+	 *  True when the first child of an inner node is closer
+	 *  along the packet's average direction than the second.
+	 ***********************************************************/
+	bool NearChildFirst(const BVH_NODE& first, const BVH_NODE& second, const RAY_PACKET& packet)
+	{
+		glm::vec3 offset = (second.boundsMin + second.boundsMax) - (first.boundsMin + first.boundsMax);
+		glm::vec3 direction(
+			packet.directionX[0] + packet.directionX[1] + packet.directionX[2] + packet.directionX[3],
+			packet.directionY[0] + packet.directionY[1] + packet.directionY[2] + packet.directionY[3],
+			packet.directionZ[0] + packet.directionZ[1] + packet.directionZ[2] + packet.directionZ[3]);
+		return(glm::dot(offset, direction) >= 0.0f);
+	}
+
+	/***********************************************************
+	 *  TraverseRay()
+	 *
+	 *  Walk a hierarchy with one ray, nearest child first,
+	 *  calling visitLeaf for every leaf the ray reaches.  The
+	 *  callback returns true when it shortened the ray.
+	 ***********************************************************/
+	template<typename LEAF_VISITOR>
+	bool TraverseRay(const std::vector<BVH_NODE>& nodes, BVH_RAY& ray, bool bAnyHit, LEAF_VISITOR visitLeaf)
+	{
+		if (nodes.empty())
+		{
+			return(false);
+		}
+
+		glm::vec3 inverseDirection(
+			SafeReciprocal(ray.direction.x),
+			SafeReciprocal(ray.direction.y),
+			SafeReciprocal(ray.direction.z));
+
+		uint32_t stack[g_StackSize];
+		float stackEntry[g_StackSize];
+		int stackSize = 0;
+		bool bHit = false;
+
+		float entry = 0.0f;
+		if (!RayHitsBox(nodes[0], ray.origin, inverseDirection, ray.t, entry))
+		{
+			return(false);
+		}
+		stack[0] = 0;
+		stackEntry[0] = entry;
+		stackSize = 1;
+
+		while (stackSize > 0)
+		{
+			stackSize--;
+			if (stackEntry[stackSize] >= ray.t)
+			{
+				continue;
+			}
+			const BVH_NODE& node = nodes[stack[stackSize]];
+
+			if (node.count > 0)
+			{
+				if (visitLeaf(node))
+				{
+					bHit = true;
+					if (bAnyHit)
+					{
+						return(true);
+					}
+				}
+				continue;
+			}
+
+			float entryA = 0.0f;
+			float entryB = 0.0f;
+			bool bHitA = RayHitsBox(nodes[node.first], ray.origin, inverseDirection, ray.t, entryA);
+			bool bHitB = RayHitsBox(nodes[node.first + 1], ray.origin, inverseDirection, ray.t, entryB);
+
+			// the nearer child goes on top of the stack
+			if (bHitA && bHitB && (entryB < entryA))
+			{
+				stack[stackSize] = node.first;
+				stackEntry[stackSize++] = entryA;
+				stack[stackSize] = node.first + 1;
+				stackEntry[stackSize++] = entryB;
+			}
+			else
+			{
+				if (bHitB)
+				{
+					stack[stackSize] = node.first + 1;
+					stackEntry[stackSize++] = entryB;
+				}
+				if (bHitA)
+				{
+					stack[stackSize] = node.first;
+					stackEntry[stackSize++] = entryA;
+				}
+			}
+		}
+
+		return(bHit);
+	}
+
+	/***********************************************************
+	 *  TraversePacket()
+	 *
+	 *  Walk a hierarchy with four rays at once.  A node is
+	 *  entered when any ray of the packet reaches it, and
+	 *  visitLeaf updates the hits stored in the packet.
+	 ***********************************************************/
+	template<typename LEAF_VISITOR>
+	void TraversePacket(const std::vector<BVH_NODE>& nodes, RAY_PACKET& packet, LEAF_VISITOR visitLeaf)
+	{
+		if (nodes.empty())
+		{
+			return;
+		}
+
+		__m128 origin[3];
+		origin[0] = _mm_loadu_ps(packet.originX);
+		origin[1] = _mm_loadu_ps(packet.originY);
+		origin[2] = _mm_loadu_ps(packet.originZ);
+		__m128 inverseDirection[3];
+		inverseDirection[0] = SafeReciprocalPacket(_mm_loadu_ps(packet.directionX));
+		inverseDirection[1] = SafeReciprocalPacket(_mm_loadu_ps(packet.directionY));
+		inverseDirection[2] = SafeReciprocalPacket(_mm_loadu_ps(packet.directionZ));
+
+		uint32_t stack[g_StackSize];
+		int stackSize = 0;
+		stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			const BVH_NODE& node = nodes[stack[--stackSize]];
+			if (0 == PacketHitsBox(node, origin, inverseDirection, _mm_loadu_ps(packet.t)))
+			{
+				continue;
+			}
+
+			if (node.count > 0)
+			{
+				visitLeaf(node);
+				continue;
+			}
+
+			// the nearer child goes on top of the stack
+			if (NearChildFirst(nodes[node.first], nodes[node.first + 1], packet))
+			{
+				stack[stackSize++] = node.first + 1;
+				stack[stackSize++] = node.first;
+			}
+			else
+			{
+				stack[stackSize++] = node.first;
+				stack[stackSize++] = node.first + 1;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildBVHNodes()
+ *
+ *  This function is used for building a hierarchy from the
+ *  bounds of a list of primitives.  Each node is split at
+ *  the bucket boundary of the primitive centers that has
+ *  the lowest surface area cost, or kept as a leaf when
+ *  splitting costs more than testing its primitives.
+ ***********************************************************/
+void BuildBVHNodes(
+	const std::vector<glm::vec3>& boundsMin,
+	const std::vector<glm::vec3>& boundsMax,
+	uint32_t maxLeafSize,
+	std::vector<BVH_NODE>& nodes,
+	std::vector<uint32_t>& order)
+{
+	uint32_t primitiveCount = static_cast<uint32_t>(boundsMin.size());
+	nodes.clear();
+	order.resize(primitiveCount);
+	for (uint32_t i = 0; i < primitiveCount; i++)
+	{
+		order[i] = i;
+	}
+	if (primitiveCount == 0)
+	{
+		return;
+	}
+
+	std::vector<glm::vec3> centers(primitiveCount);
+	for (uint32_t i = 0; i < primitiveCount; i++)
+	{
+		centers[i] = (boundsMin[i] + boundsMax[i]) * 0.5f;
+	}
+
+	nodes.reserve(primitiveCount * 2);
+	BVH_NODE root;
+	root.first = 0;
+	root.count = primitiveCount;
+	nodes.push_back(root);
+
+	// node index and depth of the nodes left to split
+	std::vector<std::pair<uint32_t, int>> pending;
+	pending.push_back(std::make_pair(0u, 0));
+
+	while (!pending.empty())
+	{
+		uint32_t nodeIndex = pending.back().first;
+		int depth = pending.back().second;
+		pending.pop_back();
+
+		uint32_t first = nodes[nodeIndex].first;
+		uint32_t count = nodes[nodeIndex].count;
+
+		glm::vec3 nodeMin(FLT_MAX);
+		glm::vec3 nodeMax(-FLT_MAX);
+		glm::vec3 centerMin(FLT_MAX);
+		glm::vec3 centerMax(-FLT_MAX);
+		for (uint32_t i = first; i < first + count; i++)
+		{
+			uint32_t primitive = order[i];
+			nodeMin = glm::min(nodeMin, boundsMin[primitive]);
+			nodeMax = glm::max(nodeMax, boundsMax[primitive]);
+			centerMin = glm::min(centerMin, centers[primitive]);
+			centerMax = glm::max(centerMax, centers[primitive]);
+		}
+		nodes[nodeIndex].boundsMin = nodeMin;
+		nodes[nodeIndex].boundsMax = nodeMax;
+
+		if ((count <= 2) || (depth >= g_MaxDepth))
+		{
+			continue;
+		}
+
+		// cost of every bucket boundary along every axis
+		float bestCost = FLT_MAX;
+		int bestAxis = -1;
+		int bestSplit = 0;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float extent = centerMax[axis] - centerMin[axis];
+			if (extent <= 0.0f)
+			{
+				continue;
+			}
+			float binScale = g_SplitBins / extent;
+
+			uint32_t binCounts[g_SplitBins] = { 0 };
+			glm::vec3 binMin[g_SplitBins];
+			glm::vec3 binMax[g_SplitBins];
+			for (int b = 0; b < g_SplitBins; b++)
+			{
+				binMin[b] = glm::vec3(FLT_MAX);
+				binMax[b] = glm::vec3(-FLT_MAX);
+			}
+			for (uint32_t i = first; i < first + count; i++)
+			{
+				uint32_t primitive = order[i];
+				int bin = std::min(static_cast<int>((centers[primitive][axis] - centerMin[axis]) * binScale), g_SplitBins - 1);
+				binCounts[bin]++;
+				binMin[bin] = glm::min(binMin[bin], boundsMin[primitive]);
+				binMax[bin] = glm::max(binMax[bin], boundsMax[primitive]);
+			}
+
+			float rightArea[g_SplitBins];
+			uint32_t rightCount[g_SplitBins];
+			glm::vec3 sweepMin(FLT_MAX);
+			glm::vec3 sweepMax(-FLT_MAX);
+			uint32_t sweepCount = 0;
+			for (int b = g_SplitBins - 1; b > 0; b--)
+			{
+				sweepMin = glm::min(sweepMin, binMin[b]);
+				sweepMax = glm::max(sweepMax, binMax[b]);
+				sweepCount += binCounts[b];
+				rightArea[b] = SurfaceArea(sweepMin, sweepMax);
+				rightCount[b] = sweepCount;
+			}
+
+			sweepMin = glm::vec3(FLT_MAX);
+			sweepMax = glm::vec3(-FLT_MAX);
+			sweepCount = 0;
+			for (int b = 0; b < g_SplitBins - 1; b++)
+			{
+				sweepMin = glm::min(sweepMin, binMin[b]);
+				sweepMax = glm::max(sweepMax, binMax[b]);
+				sweepCount += binCounts[b];
+				if ((sweepCount == 0) || (rightCount[b + 1] == 0))
+				{
+					continue;
+				}
+				float cost = sweepCount * SurfaceArea(sweepMin, sweepMax) + rightCount[b + 1] * rightArea[b + 1];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = b + 1;
+				}
+			}
+		}
+
+		// one box test costs about as much as one primitive test
+		float nodeArea = SurfaceArea(nodeMin, nodeMax);
+		bool bSplit = (bestAxis >= 0) &&
+			((count > maxLeafSize) || (bestCost + nodeArea < count * nodeArea));
+
+		uint32_t leftCount = 0;
+		if (bSplit)
+		{
+			float binScale = g_SplitBins / (centerMax[bestAxis] - centerMin[bestAxis]);
+			float axisMin = centerMin[bestAxis];
+			std::vector<uint32_t>::iterator begin = order.begin() + first;
+			std::vector<uint32_t>::iterator middle = std::partition(
+				begin,
+				begin + count,
+				[&](uint32_t primitive)
+			{
+				int bin = std::min(static_cast<int>((centers[primitive][bestAxis] - axisMin) * binScale), g_SplitBins - 1);
+				return(bin < bestSplit);
+			});
+			leftCount = static_cast<uint32_t>(middle - begin);
+		}
+		else if (count > maxLeafSize)
+		{
+			// the centers all coincide, so halve the list
+			leftCount = count / 2;
+		}
+		if ((leftCount == 0) || (leftCount == count))
+		{
+			continue;
+		}
+
+		uint32_t childIndex = static_cast<uint32_t>(nodes.size());
+		BVH_NODE child;
+		child.first = first;
+		child.count = leftCount;
+		nodes.push_back(child);
+		child.first = first + leftCount;
+		child.count = count - leftCount;
+		nodes.push_back(child);
+
+		nodes[nodeIndex].first = childIndex;
+		nodes[nodeIndex].count = 0;
+		pending.push_back(std::make_pair(childIndex, depth + 1));
+		pending.push_back(std::make_pair(childIndex + 1, depth + 1));
+	}
+}
+
+/***********************************************************
+ *  TransformBounds()
+ *
+ *  This function is used for finding the box around the
+ *  eight transformed corners of a box.
+ ***********************************************************/
+void TransformBounds(
+	const glm::mat4& transform,
+	const glm::vec3& boundsMin,
+	const glm::vec3& boundsMax,
+	glm::vec3& resultMin,
+	glm::vec3& resultMax)
+{
+	resultMin = glm::vec3(FLT_MAX);
+	resultMax = glm::vec3(-FLT_MAX);
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec3 corner(
+			(i & 1) ? boundsMax.x : boundsMin.x,
+			(i & 2) ? boundsMax.y : boundsMin.y,
+			(i & 4) ? boundsMax.z : boundsMin.z);
+		glm::vec3 transformed = glm::vec3(transform * glm::vec4(corner, 1.0f));
+		resultMin = glm::min(resultMin, transformed);
+		resultMax = glm::max(resultMax, transformed);
+	}
+}
+
+/***********************************************************
+ *  MeshBVH()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshBVH::MeshBVH()
+{
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for building the hierarchy over the
+ *  triangles of a mesh.  The triangles are copied in leaf
+ *  order, so a leaf reads one continuous block of memory.
+ ***********************************************************/
+void MeshBVH::Build(const MESH_DATA& mesh, const glm::mat4& transform)
+{
+	size_t triangleCount = mesh.indices.size() / 3;
+	std::vector<glm::vec3> positions(mesh.vertices.size());
+	for (size_t i = 0; i < mesh.vertices.size(); i++)
+	{
+		positions[i] = glm::vec3(transform * glm::vec4(mesh.vertices[i].position, 1.0f));
+	}
+
+	std::vector<glm::vec3> triangleMin(triangleCount);
+	std::vector<glm::vec3> triangleMax(triangleCount);
+	for (size_t i = 0; i < triangleCount; i++)
+	{
+		const glm::vec3& a = positions[mesh.indices[i * 3]];
+		const glm::vec3& b = positions[mesh.indices[i * 3 + 1]];
+		const glm::vec3& c = positions[mesh.indices[i * 3 + 2]];
+		triangleMin[i] = glm::min(a, glm::min(b, c));
+		triangleMax[i] = glm::max(a, glm::max(b, c));
+	}
+
+	std::vector<uint32_t> order;
+	BuildBVHNodes(triangleMin, triangleMax, 4, m_nodes, order);
+
+	m_triangles.resize(triangleCount);
+	for (size_t i = 0; i < triangleCount; i++)
+	{
+		uint32_t triangle = order[i];
+		const glm::vec3& a = positions[mesh.indices[triangle * 3]];
+		m_triangles[i].corner = a;
+		m_triangles[i].edge1 = positions[mesh.indices[triangle * 3 + 1]] - a;
+		m_triangles[i].edge2 = positions[mesh.indices[triangle * 3 + 2]] - a;
+		m_triangles[i].index = static_cast<int32_t>(triangle);
+	}
+}
+
+/***********************************************************
+ *  Traverse()
+ *
+ *  This method is used for testing one ray against the
+ *  triangles of the leaves it reaches.
+ ***********************************************************/
+bool MeshBVH::Traverse(BVH_RAY& ray, int32_t instance, bool bAnyHit) const
+{
+	return(TraverseRay(m_nodes, ray, bAnyHit, [&](const BVH_NODE& node)
+	{
+		bool bHit = false;
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+		{
+			const BVH_TRIANGLE& triangle = m_triangles[i];
+
+			glm::vec3 p = glm::cross(ray.direction, triangle.edge2);
+			float determinant = glm::dot(triangle.edge1, p);
+			if (determinant == 0.0f)
+			{
+				continue;
+			}
+			float inverseDeterminant = 1.0f / determinant;
+			glm::vec3 s = ray.origin - triangle.corner;
+			float u = glm::dot(s, p) * inverseDeterminant;
+			if ((u < 0.0f) || (u > 1.0f))
+			{
+				continue;
+			}
+			glm::vec3 q = glm::cross(s, triangle.edge1);
+			float v = glm::dot(ray.direction, q) * inverseDeterminant;
+			if ((v < 0.0f) || (u + v > 1.0f))
+			{
+				continue;
+			}
+			float t = glm::dot(triangle.edge2, q) * inverseDeterminant;
+			if ((t <= 0.0f) || (t >= ray.t))
+			{
+				continue;
+			}
+
+			ray.t = t;
+			ray.u = u;
+			ray.v = v;
+			ray.triangle = triangle.index;
+			ray.instance = instance;
+			bHit = true;
+			if (bAnyHit)
+			{
+				break;
+			}
+		}
+		return(bHit);
+	}));
+}
+
+/***********************************************************
+ *  Intersect()
+ *
+ *  This method is used for finding the closest triangle
+ *  hit by a ray.
+ ***********************************************************/
+bool MeshBVH::Intersect(BVH_RAY& ray, int32_t instance) const
+{
+	return(Traverse(ray, instance, false));
+}
+
+/***********************************************************
+ *  IsOccluded()
+ *
+ *  This method is used for checking if any triangle lies
+ *  along a ray, as needed for shadows.
+ ***********************************************************/
+bool MeshBVH::IsOccluded(const BVH_RAY& ray) const
+{
+	BVH_RAY shadowRay = ray;
+	return(Traverse(shadowRay, -1, true));
+}
+
+/***********************************************************
+ *  IntersectPacket()
+ *
+ *  This method is used for finding the closest triangle
+ *  hit by each of four rays, testing each triangle against
+ *  all four rays with SSE.
+ ***********************************************************/
+void MeshBVH::IntersectPacket(RAY_PACKET& packet, int32_t instance) const
+{
+	const __m128 originX = _mm_loadu_ps(packet.originX);
+	const __m128 originY = _mm_loadu_ps(packet.originY);
+	const __m128 originZ = _mm_loadu_ps(packet.originZ);
+	const __m128 directionX = _mm_loadu_ps(packet.directionX);
+	const __m128 directionY = _mm_loadu_ps(packet.directionY);
+	const __m128 directionZ = _mm_loadu_ps(packet.directionZ);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128i instanceValue = _mm_set1_epi32(instance);
+
+	TraversePacket(m_nodes, packet, [&](const BVH_NODE& node)
+	{
+		__m128 t = _mm_loadu_ps(packet.t);
+		__m128 hitU = _mm_loadu_ps(packet.u);
+		__m128 hitV = _mm_loadu_ps(packet.v);
+		__m128i hitTriangle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packet.triangle));
+		__m128i hitInstance = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packet.instance));
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+		{
+			const BVH_TRIANGLE& triangle = m_triangles[i];
+			__m128 edge1X = _mm_set1_ps(triangle.edge1.x);
+			__m128 edge1Y = _mm_set1_ps(triangle.edge1.y);
+			__m128 edge1Z = _mm_set1_ps(triangle.edge1.z);
+			__m128 edge2X = _mm_set1_ps(triangle.edge2.x);
+			__m128 edge2Y = _mm_set1_ps(triangle.edge2.y);
+			__m128 edge2Z = _mm_set1_ps(triangle.edge2.z);
+
+			// p = direction x edge2
+			__m128 pX = _mm_sub_ps(_mm_mul_ps(directionY, edge2Z), _mm_mul_ps(directionZ, edge2Y));
+			__m128 pY = _mm_sub_ps(_mm_mul_ps(directionZ, edge2X), _mm_mul_ps(directionX, edge2Z));
+			__m128 pZ = _mm_sub_ps(_mm_mul_ps(directionX, edge2Y), _mm_mul_ps(directionY, edge2X));
+			__m128 determinant = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(edge1X, pX), _mm_mul_ps(edge1Y, pY)), _mm_mul_ps(edge1Z, pZ));
+			__m128 inverseDeterminant = _mm_div_ps(one, determinant);
+
+			__m128 sX = _mm_sub_ps(originX, _mm_set1_ps(triangle.corner.x));
+			__m128 sY = _mm_sub_ps(originY, _mm_set1_ps(triangle.corner.y));
+			__m128 sZ = _mm_sub_ps(originZ, _mm_set1_ps(triangle.corner.z));
+			__m128 triangleU = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(sX, pX), _mm_mul_ps(sY, pY)), _mm_mul_ps(sZ, pZ)), inverseDeterminant);
+
+			// q = s x edge1
+			__m128 qX = _mm_sub_ps(_mm_mul_ps(sY, edge1Z), _mm_mul_ps(sZ, edge1Y));
+			__m128 qY = _mm_sub_ps(_mm_mul_ps(sZ, edge1X), _mm_mul_ps(sX, edge1Z));
+			__m128 qZ = _mm_sub_ps(_mm_mul_ps(sX, edge1Y), _mm_mul_ps(sY, edge1X));
+			__m128 triangleV = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(directionX, qX), _mm_mul_ps(directionY, qY)), _mm_mul_ps(directionZ, qZ)), inverseDeterminant);
+			__m128 triangleT = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(edge2X, qX), _mm_mul_ps(edge2Y, qY)), _mm_mul_ps(edge2Z, qZ)), inverseDeterminant);
+
+			// comparisons against NaN fail, which also rejects
+			// rays running parallel to the triangle
+			__m128 mask = _mm_cmpneq_ps(determinant, zero);
+			mask = _mm_and_ps(mask, _mm_cmpge_ps(triangleU, zero));
+			mask = _mm_and_ps(mask, _mm_cmpge_ps(triangleV, zero));
+			mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(triangleU, triangleV), one));
+			mask = _mm_and_ps(mask, _mm_cmpgt_ps(triangleT, zero));
+			mask = _mm_and_ps(mask, _mm_cmplt_ps(triangleT, t));
+			if (0 == _mm_movemask_ps(mask))
+			{
+				continue;
+			}
+
+			__m128i maskInteger = _mm_castps_si128(mask);
+			t = _mm_or_ps(_mm_and_ps(mask, triangleT), _mm_andnot_ps(mask, t));
+			hitU = _mm_or_ps(_mm_and_ps(mask, triangleU), _mm_andnot_ps(mask, hitU));
+			hitV = _mm_or_ps(_mm_and_ps(mask, triangleV), _mm_andnot_ps(mask, hitV));
+			hitTriangle = _mm_or_si128(
+				_mm_and_si128(maskInteger, _mm_set1_epi32(triangle.index)),
+				_mm_andnot_si128(maskInteger, hitTriangle));
+			hitInstance = _mm_or_si128(
+				_mm_and_si128(maskInteger, instanceValue),
+				_mm_andnot_si128(maskInteger, hitInstance));
+		}
+
+		_mm_storeu_ps(packet.t, t);
+		_mm_storeu_ps(packet.u, hitU);
+		_mm_storeu_ps(packet.v, hitV);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(packet.triangle), hitTriangle);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(packet.instance), hitInstance);
+	});
+}
+
+/***********************************************************
+ *  IsEmpty()
+ *
+ *  This method is used for checking if the mesh had any
+ *  triangles.
+ ***********************************************************/
+bool MeshBVH::IsEmpty() const
+{
+	return(m_nodes.empty());
+}
+
+/***********************************************************
+ *  GetBoundsMin()
+ *
+ *  This method is used for getting the corner of the box
+ *  around all the triangles with the lowest coordinates.
+ ***********************************************************/
+glm::vec3 MeshBVH::GetBoundsMin() const
+{
+	return(m_nodes.empty() ? glm::vec3(0.0f) : m_nodes[0].boundsMin);
+}
+
+/***********************************************************
+ *  GetBoundsMax()
+ *
+ *  This method is used for getting the corner of the box
+ *  around all the triangles with the highest coordinates.
+ ***********************************************************/
+glm::vec3 MeshBVH::GetBoundsMax() const
+{
+	return(m_nodes.empty() ? glm::vec3(0.0f) : m_nodes[0].boundsMax);
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for building the hierarchy over the
+ *  world space boxes of the instances.
+ ***********************************************************/
+void SceneBVH::Build(const std::vector<BVH_INSTANCE>& instances)
+{
+	m_instances = instances;
+
+	std::vector<glm::vec3> instanceMin(instances.size());
+	std::vector<glm::vec3> instanceMax(instances.size());
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		instanceMin[i] = instances[i].boundsMin;
+		instanceMax[i] = instances[i].boundsMax;
+	}
+	BuildBVHNodes(instanceMin, instanceMax, 1, m_nodes, m_order);
+}
+
+/***********************************************************
+ *  Traverse()
+ *
+ *  This method is used for moving one ray into the space of
+ *  each instance it reaches and testing it there.  The
+ *  directions are not normalized, so the hit distances
+ *  stay the same in both spaces.
+ ***********************************************************/
+bool SceneBVH::Traverse(BVH_RAY& ray, bool bAnyHit) const
+{
+	return(TraverseRay(m_nodes, ray, bAnyHit, [&](const BVH_NODE& node)
+	{
+		bool bHit = false;
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+		{
+			uint32_t instanceIndex = m_order[i];
+			const BVH_INSTANCE& instance = m_instances[instanceIndex];
+
+			BVH_RAY meshRay = ray;
+			meshRay.origin = glm::vec3(instance.worldToMesh * glm::vec4(ray.origin, 1.0f));
+			meshRay.direction = glm::vec3(instance.worldToMesh * glm::vec4(ray.direction, 0.0f));
+
+			if (bAnyHit)
+			{
+				if (instance.pBVH->IsOccluded(meshRay))
+				{
+					return(true);
+				}
+			}
+			else if (instance.pBVH->Intersect(meshRay, static_cast<int32_t>(instanceIndex)))
+			{
+				ray.t = meshRay.t;
+				ray.u = meshRay.u;
+				ray.v = meshRay.v;
+				ray.triangle = meshRay.triangle;
+				ray.instance = meshRay.instance;
+				bHit = true;
+			}
+		}
+		return(bHit);
+	}));
+}
+
+/***********************************************************
+ *  Intersect()
+ *
+ *  This method is used for finding the closest triangle of
+ *  any instance hit by a ray.
+ ***********************************************************/
+bool SceneBVH::Intersect(BVH_RAY& ray) const
+{
+	return(Traverse(ray, false));
+}
+
+/***********************************************************
+ *  IsOccluded()
+ *
+ *  This method is used for checking if any instance blocks
+ *  a ray.
+ ***********************************************************/
+bool SceneBVH::IsOccluded(const BVH_RAY& ray) const
+{
+	BVH_RAY shadowRay = ray;
+	return(Traverse(shadowRay, true));
+}
+
+/***********************************************************
+ *  IntersectPacket()
+ *
+ *  This method is used for finding the closest hits of four
+ *  rays, moving the whole packet into the space of each
+ *  instance that any of its rays reaches.
+ ***********************************************************/
+void SceneBVH::IntersectPacket(RAY_PACKET& packet) const
+{
+	TraversePacket(m_nodes, packet, [&](const BVH_NODE& node)
+	{
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+		{
+			uint32_t instanceIndex = m_order[i];
+			const BVH_INSTANCE& instance = m_instances[instanceIndex];
+
+			RAY_PACKET meshPacket = packet;
+			for (int lane = 0; lane < 4; lane++)
+			{
+				glm::vec3 origin = glm::vec3(instance.worldToMesh * glm::vec4(
+					packet.originX[lane], packet.originY[lane], packet.originZ[lane], 1.0f));
+				glm::vec3 direction = glm::vec3(instance.worldToMesh * glm::vec4(
+					packet.directionX[lane], packet.directionY[lane], packet.directionZ[lane], 0.0f));
+				meshPacket.originX[lane] = origin.x;
+				meshPacket.originY[lane] = origin.y;
+				meshPacket.originZ[lane] = origin.z;
+				meshPacket.directionX[lane] = direction.x;
+				meshPacket.directionY[lane] = direction.y;
+				meshPacket.directionZ[lane] = direction.z;
+			}
+
+			instance.pBVH->IntersectPacket(meshPacket, static_cast<int32_t>(instanceIndex));
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				packet.t[lane] = meshPacket.t[lane];
+				packet.triangle[lane] = meshPacket.triangle[lane];
+				packet.instance[lane] = meshPacket.instance[lane];
+				packet.u[lane] = meshPacket.u[lane];
+				packet.v[lane] = meshPacket.v[lane];
+			}
+		}
+	});
+}
+
+/***********************************************************
+ *  IsEmpty()
+ *
+ *  This method is used for checking if the scene has any
+ *  instances.
+ ***********************************************************/
+bool SceneBVH::IsEmpty() const
+{
+	return(m_nodes.empty());
+}
@@ -0,0 +1,184 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshbvh.h
+// ============
+// bounding volume hierarchies for casting rays against meshes and scenes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshData.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  BVH_NODE
+ *
+ *  One box of a hierarchy.  Inner nodes have no primitives
+ *  and their two children are stored next to each other.
+ ***********************************************************/
+struct BVH_NODE
+{
+	glm::vec3 boundsMin;
+	// first child for inner nodes, first primitive for leaves
+	uint32_t first;
+	glm::vec3 boundsMax;
+	// number of primitives, zero for inner nodes
+	uint32_t count;
+};
+
+/***********************************************************
+ *  BVH_RAY
+ *
+ *  A single ray.  The hit point is origin + t * direction,
+ *  and t starts as the furthest distance to look at and
+ *  is shortened to the closest hit found.
+ ***********************************************************/
+struct BVH_RAY
+{
+	glm::vec3 origin;
+	glm::vec3 direction;
+	float t;
+	// barycentric weights of the second and third corner
+	float u;
+	float v;
+	// triangle index in the mesh, or -1 when nothing was hit
+	int32_t triangle;
+	int32_t instance;
+};
+
+/***********************************************************
+ *  RAY_PACKET
+ *
+ *  Four rays stored component by component, so they can be
+ *  tested against a box or triangle with one SSE operation.
+ *  The fields mean the same as in BVH_RAY, and rays that
+ *  are not needed get a t of zero.
+ ***********************************************************/
+struct RAY_PACKET
+{
+	float originX[4];
+	float originY[4];
+	float originZ[4];
+	float directionX[4];
+	float directionY[4];
+	float directionZ[4];
+	float t[4];
+	float u[4];
+	float v[4];
+	int32_t triangle[4];
+	int32_t instance[4];
+};
+
+// sort primitives with the given bounds into a hierarchy using
+// the surface area heuristic - order receives the primitive
+// indices in the order the leaves reference them
+void BuildBVHNodes(
+	const std::vector<glm::vec3>& boundsMin,
+	const std::vector<glm::vec3>& boundsMax,
+	uint32_t maxLeafSize,
+	std::vector<BVH_NODE>& nodes,
+	std::vector<uint32_t>& order);
+
+/***********************************************************
+ *  MeshBVH
+ *
+ *  This class holds a hierarchy over the triangles of one
+ *  mesh, in the space of the mesh's vertices or in the
+ *  space given to Build().  Triangles are double sided so
+ *  the hits match what the rasterizers draw.
+ ***********************************************************/
+class MeshBVH
+{
+public:
+	// constructor
+	MeshBVH();
+
+	// build the hierarchy over the transformed triangles
+	void Build(const MESH_DATA& mesh, const glm::mat4& transform);
+
+	// find the closest hit along the ray, returning true when
+	// the ray was shortened
+	bool Intersect(BVH_RAY& ray, int32_t instance) const;
+	// true when anything is hit along the ray
+	bool IsOccluded(const BVH_RAY& ray) const;
+	// find the closest hit of each ray of the packet
+	void IntersectPacket(RAY_PACKET& packet, int32_t instance) const;
+
+	bool IsEmpty() const;
+	glm::vec3 GetBoundsMin() const;
+	glm::vec3 GetBoundsMax() const;
+
+private:
+	// one corner and two edges of a triangle, in leaf order
+	struct BVH_TRIANGLE
+	{
+		glm::vec3 corner;
+		glm::vec3 edge1;
+		glm::vec3 edge2;
+		int32_t index;
+	};
+
+	std::vector<BVH_NODE> m_nodes;
+	std::vector<BVH_TRIANGLE> m_triangles;
+
+	// walk the tree with one ray, stopping at the first hit
+	// when bAnyHit is set
+	bool Traverse(BVH_RAY& ray, int32_t instance, bool bAnyHit) const;
+};
+
+/***********************************************************
+ *  BVH_INSTANCE
+ *
+ *  A mesh hierarchy placed in the world.  The rays are moved
+ *  into the mesh's space, so worldToMesh must be invertible.
+ ***********************************************************/
+struct BVH_INSTANCE
+{
+	const MeshBVH* pBVH;
+	glm::mat4 worldToMesh;
+	// world space box around the placed mesh
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+};
+
+/***********************************************************
+ *  SceneBVH
+ *
+ *  This class holds a hierarchy over mesh instances, so a
+ *  scene can be rebuilt every frame while the much larger
+ *  mesh hierarchies are kept.  Hits report the index of the
+ *  instance in the list passed to Build().
+ ***********************************************************/
+class SceneBVH
+{
+public:
+	// build the hierarchy - the mesh hierarchies must stay
+	// alive while the scene is used
+	void Build(const std::vector<BVH_INSTANCE>& instances);
+
+	bool Intersect(BVH_RAY& ray) const;
+	bool IsOccluded(const BVH_RAY& ray) const;
+	void IntersectPacket(RAY_PACKET& packet) const;
+
+	bool IsEmpty() const;
+
+private:
+	std::vector<BVH_NODE> m_nodes;
+	std::vector<BVH_INSTANCE> m_instances;
+	// instance indices in leaf order
+	std::vector<uint32_t> m_order;
+
+	bool Traverse(BVH_RAY& ray, bool bAnyHit) const;
+};
+
+// world space box around a box transformed by the matrix
+void TransformBounds(
+	const glm::mat4& transform,
+	const glm::vec3& boundsMin,
+	const glm::vec3& boundsMax,
+	glm::vec3& resultMin,
+	glm::vec3& resultMax);
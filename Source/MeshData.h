@@ -0,0 +1,50 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshdata.h
+// ============
+// CPU side mesh data in the engine's vertex format
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  MESH_VERTEX
+ *
+ *  One vertex in the same interleaved layout that the
+ *  ShapeMeshes class uploads: 3 floats of position, 3 floats
+ *  of normal and 2 floats of texture coordinates, bound to
+ *  vertex attributes 0, 1 and 2.
+ ***********************************************************/
+struct MESH_VERTEX
+{
+	glm::vec3 position;
+	glm::vec3 normal;
+	glm::vec2 texCoord;
+};
+
+/***********************************************************
+ *  MESH_DATA
+ *
+ *  Indexed triangle list ready to be uploaded to OpenGL.
+ ***********************************************************/
+struct MESH_DATA
+{
+	std::string tag;
+	std::vector<MESH_VERTEX> vertices;
+	std::vector<uint32_t> indices;
+	// optional per vertex tangents - xyz is the direction of
+	// increasing u and w is the sign of the bitangent
+	std::vector<glm::vec4> tangents;
+	// object space bounding box of the vertex positions
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+};
+
+// number of floats in each interleaved vertex
+const int MESH_FLOATS_PER_VERTEX = 8;
@@ -0,0 +1,391 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshheap.cpp
+// ============
+// keep the data of every mesh in a few large GPU buffers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshHeap.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// smallest ranges handed out, in vertices and indices
+	const uint32_t g_MinVertexBlock = 64;
+	const uint32_t g_MinIndexBlock = 256;
+
+	// bytes per unit of each buffer
+	const size_t g_VertexBytes = sizeof(MESH_VERTEX);
+	const size_t g_TangentBytes = sizeof(glm::vec4);
+	const size_t g_IndexBytes = sizeof(uint32_t);
+
+	/***********************************************************
+	 *  RANGE_MOVE
+	 *
+	 *  One range to copy while defragmenting, in units.
+	 ***********************************************************/
+	struct RANGE_MOVE
+	{
+		uint32_t from;
+		uint32_t to;
+		uint32_t count;
+	};
+
+	/***********************************************************
+	 *  ResizeBuffer()
+	 *
+	 *  Replace a buffer with a larger one that starts with the
+	 *  same data.  The copy stays on the GPU.
+	 ***********************************************************/
+	void ResizeBuffer(RenderBackend* pBackend, uint32_t& buffer, BUFFER_TYPE type, size_t oldSize, size_t newSize)
+	{
+		uint32_t resized = pBackend->CreateBuffer(type, newSize, NULL);
+		pBackend->CopyBuffer(buffer, resized, 0, 0, oldSize);
+		pBackend->DestroyBuffer(buffer);
+		buffer = resized;
+	}
+
+	/***********************************************************
+	 *  MoveRanges()
+	 *
+	 *  Copy the passed ranges into a fresh buffer of the same
+	 *  size and replace the old buffer with it.  Copying into
+	 *  another buffer avoids the overlapping copies that
+	 *  OpenGL does not allow within one buffer.
+	 ***********************************************************/
+	void MoveRanges(RenderBackend* pBackend, uint32_t& buffer, BUFFER_TYPE type, size_t size, size_t unitBytes, const std::vector<RANGE_MOVE>& moves)
+	{
+		uint32_t packed = pBackend->CreateBuffer(type, size, NULL);
+		for (size_t i = 0; i < moves.size(); i++)
+		{
+			pBackend->CopyBuffer(
+				buffer,
+				packed,
+				moves[i].from * unitBytes,
+				moves[i].to * unitBytes,
+				moves[i].count * unitBytes);
+		}
+		pBackend->DestroyBuffer(buffer);
+		buffer = packed;
+	}
+}
+
+/***********************************************************
+ *  MeshHeap()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshHeap::MeshHeap()
+{
+	m_pBackend = NULL;
+	m_vertexLayout = 0;
+	m_vertexBuffer = 0;
+	m_tangentBuffer = 0;
+	m_indexBuffer = 0;
+}
+
+/***********************************************************
+ *  ~MeshHeap()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshHeap::~MeshHeap()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the shared buffers and
+ *  the vertex layout.  It must be called from the thread
+ *  that owns the graphics context.
+ ***********************************************************/
+bool MeshHeap::Create(RenderBackend* pBackend, uint32_t vertexCapacity, uint32_t indexCapacity)
+{
+	Destroy();
+	m_pBackend = pBackend;
+
+	m_vertexRanges.Reset(vertexCapacity, g_MinVertexBlock);
+	m_indexRanges.Reset(indexCapacity, g_MinIndexBlock);
+
+	m_vertexBuffer = m_pBackend->CreateBuffer(BUFFER_VERTEX, m_vertexRanges.GetCapacity() * g_VertexBytes, NULL);
+	m_tangentBuffer = m_pBackend->CreateBuffer(BUFFER_VERTEX, m_vertexRanges.GetCapacity() * g_TangentBytes, NULL);
+	m_indexBuffer = m_pBackend->CreateBuffer(BUFFER_INDEX, m_indexRanges.GetCapacity() * g_IndexBytes, NULL);
+	SetupVertexLayout();
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the shared buffers.
+ *  Every handle becomes invalid.
+ ***********************************************************/
+void MeshHeap::Destroy()
+{
+	if (0 != m_vertexLayout)
+	{
+		m_pBackend->DestroyVertexLayout(m_vertexLayout);
+		m_pBackend->DestroyBuffer(m_vertexBuffer);
+		m_pBackend->DestroyBuffer(m_tangentBuffer);
+		m_pBackend->DestroyBuffer(m_indexBuffer);
+	}
+	m_vertexLayout = 0;
+	m_vertexBuffer = 0;
+	m_tangentBuffer = 0;
+	m_indexBuffer = 0;
+	m_allocations.clear();
+	m_freeHandles.clear();
+}
+
+/***********************************************************
+ *  SetupVertexLayout()
+ *
+ *  This method is used for replacing the shared vertex
+ *  layout with one that reads the current buffers, with the
+ *  same attribute layout as the basic shape meshes plus the
+ *  tangents.
+ ***********************************************************/
+void MeshHeap::SetupVertexLayout()
+{
+	if (0 != m_vertexLayout)
+	{
+		m_pBackend->DestroyVertexLayout(m_vertexLayout);
+	}
+
+	// position, normal and texture coordinate attributes, and
+	// the tangents kept in their own buffer at the same vertex
+	// positions, so one base vertex covers both
+	uint32_t stride = sizeof(MESH_VERTEX);
+	VERTEX_ATTRIBUTE attributes[4] =
+	{
+		{ 0, m_vertexBuffer, 3, stride, static_cast<uint32_t>(offsetof(MESH_VERTEX, position)) },
+		{ 1, m_vertexBuffer, 3, stride, static_cast<uint32_t>(offsetof(MESH_VERTEX, normal)) },
+		{ 2, m_vertexBuffer, 2, stride, static_cast<uint32_t>(offsetof(MESH_VERTEX, texCoord)) },
+		{ 3, m_tangentBuffer, 4, sizeof(glm::vec4), 0 }
+	};
+	m_vertexLayout = m_pBackend->CreateVertexLayout(attributes, 4, m_indexBuffer);
+}
+
+/***********************************************************
+ *  GrowVertices()
+ *
+ *  This method is used for doubling the vertex capacity.
+ *  The existing data moves on the GPU and keeps its offsets.
+ ***********************************************************/
+void MeshHeap::GrowVertices()
+{
+	size_t oldCapacity = m_vertexRanges.GetCapacity();
+	m_vertexRanges.Grow();
+	size_t newCapacity = m_vertexRanges.GetCapacity();
+
+	ResizeBuffer(m_pBackend, m_vertexBuffer, BUFFER_VERTEX, oldCapacity * g_VertexBytes, newCapacity * g_VertexBytes);
+	ResizeBuffer(m_pBackend, m_tangentBuffer, BUFFER_VERTEX, oldCapacity * g_TangentBytes, newCapacity * g_TangentBytes);
+	SetupVertexLayout();
+
+	std::cout << "Mesh heap grown to " << newCapacity << " vertices" << std::endl;
+}
+
+/***********************************************************
+ *  GrowIndices()
+ *
+ *  This method is used for doubling the index capacity.
+ ***********************************************************/
+void MeshHeap::GrowIndices()
+{
+	size_t oldCapacity = m_indexRanges.GetCapacity();
+	m_indexRanges.Grow();
+	size_t newCapacity = m_indexRanges.GetCapacity();
+
+	ResizeBuffer(m_pBackend, m_indexBuffer, BUFFER_INDEX, oldCapacity * g_IndexBytes, newCapacity * g_IndexBytes);
+	SetupVertexLayout();
+
+	std::cout << "Mesh heap grown to " << newCapacity << " indices" << std::endl;
+}
+
+/***********************************************************
+ *  Allocate()
+ *
+ *  This method is used for reserving ranges for a mesh and
+ *  copying its data into them.  The heap only grows when a
+ *  mesh does not fit anywhere, which is the one case where
+ *  new buffer objects are made.
+ ***********************************************************/
+int MeshHeap::Allocate(const MESH_DATA& mesh)
+{
+	if ((0 == m_vertexLayout) || mesh.vertices.empty() || mesh.indices.empty())
+	{
+		return(-1);
+	}
+
+	uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+	uint32_t indexCount = static_cast<uint32_t>(mesh.indices.size());
+	uint32_t vertexOffset = 0;
+	uint32_t indexOffset = 0;
+	while (!m_vertexRanges.Allocate(vertexCount, vertexOffset))
+	{
+		GrowVertices();
+	}
+	while (!m_indexRanges.Allocate(indexCount, indexOffset))
+	{
+		GrowIndices();
+	}
+
+	m_pBackend->UpdateBuffer(m_vertexBuffer, vertexOffset * g_VertexBytes, vertexCount * g_VertexBytes, mesh.vertices.data());
+	if (mesh.tangents.size() == mesh.vertices.size())
+	{
+		m_pBackend->UpdateBuffer(m_tangentBuffer, vertexOffset * g_TangentBytes, vertexCount * g_TangentBytes, mesh.tangents.data());
+	}
+	m_pBackend->UpdateBuffer(m_indexBuffer, indexOffset * g_IndexBytes, indexCount * g_IndexBytes, mesh.indices.data());
+
+	MESH_ALLOCATION allocation;
+	allocation.baseVertex = static_cast<int32_t>(vertexOffset);
+	allocation.vertexCount = vertexCount;
+	allocation.firstIndex = indexOffset;
+	allocation.indexCount = indexCount;
+	allocation.bInUse = true;
+
+	int handle = static_cast<int>(m_allocations.size());
+	if (!m_freeHandles.empty())
+	{
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+		m_allocations[handle] = allocation;
+	}
+	else
+	{
+		m_allocations.push_back(allocation);
+	}
+
+	return(handle);
+}
+
+/***********************************************************
+ *  Free()
+ *
+ *  This method is used for releasing the ranges of a mesh.
+ *  The data stays in the buffers until it is overwritten.
+ ***********************************************************/
+void MeshHeap::Free(int handle)
+{
+	if ((handle < 0) || (handle >= (int)m_allocations.size()) || !m_allocations[handle].bInUse)
+	{
+		return;
+	}
+
+	m_vertexRanges.Free(m_allocations[handle].baseVertex);
+	m_indexRanges.Free(m_allocations[handle].firstIndex);
+	m_allocations[handle].bInUse = false;
+	m_freeHandles.push_back(handle);
+}
+
+/***********************************************************
+ *  IsFragmented()
+ *
+ *  This method is used for checking if the free space of
+ *  either buffer is split so much that its largest free
+ *  block is less than half of it.
+ ***********************************************************/
+bool MeshHeap::IsFragmented() const
+{
+	uint32_t freeVertices = m_vertexRanges.GetCapacity() - m_vertexRanges.GetUsedSize();
+	uint32_t freeIndices = m_indexRanges.GetCapacity() - m_indexRanges.GetUsedSize();
+	return((m_vertexRanges.GetLargestFreeBlock() * 2 < freeVertices) ||
+		(m_indexRanges.GetLargestFreeBlock() * 2 < freeIndices));
+}
+
+/***********************************************************
+ *  Defragment()
+ *
+ *  This method is used for packing every mesh at the start
+ *  of the buffers.  The ranges are placed largest first,
+ *  which keeps every block aligned to its size with no gaps.
+ *  The data is copied on the GPU into fresh buffers that
+ *  replace the old ones, and the handles stay the same.
+ ***********************************************************/
+void MeshHeap::Defragment()
+{
+	if (0 == m_vertexLayout)
+	{
+		return;
+	}
+
+	std::vector<int> handles;
+	for (size_t i = 0; i < m_allocations.size(); i++)
+	{
+		if (m_allocations[i].bInUse)
+		{
+			handles.push_back(static_cast<int>(i));
+		}
+	}
+
+	// repack the vertex ranges, largest first
+	std::sort(handles.begin(), handles.end(), [this](int a, int b)
+	{
+		return(m_allocations[a].vertexCount > m_allocations[b].vertexCount);
+	});
+	std::vector<RANGE_MOVE> vertexMoves;
+	m_vertexRanges.Reset(m_vertexRanges.GetCapacity(), g_MinVertexBlock);
+	for (size_t i = 0; i < handles.size(); i++)
+	{
+		MESH_ALLOCATION& allocation = m_allocations[handles[i]];
+		RANGE_MOVE move;
+		move.from = allocation.baseVertex;
+		move.count = allocation.vertexCount;
+		m_vertexRanges.Allocate(allocation.vertexCount, move.to);
+		allocation.baseVertex = static_cast<int32_t>(move.to);
+		vertexMoves.push_back(move);
+	}
+
+	// and the index ranges the same way
+	std::sort(handles.begin(), handles.end(), [this](int a, int b)
+	{
+		return(m_allocations[a].indexCount > m_allocations[b].indexCount);
+	});
+	std::vector<RANGE_MOVE> indexMoves;
+	m_indexRanges.Reset(m_indexRanges.GetCapacity(), g_MinIndexBlock);
+	for (size_t i = 0; i < handles.size(); i++)
+	{
+		MESH_ALLOCATION& allocation = m_allocations[handles[i]];
+		RANGE_MOVE move;
+		move.from = allocation.firstIndex;
+		move.count = allocation.indexCount;
+		m_indexRanges.Allocate(allocation.indexCount, move.to);
+		allocation.firstIndex = move.to;
+		indexMoves.push_back(move);
+	}
+
+	size_t vertexCapacity = m_vertexRanges.GetCapacity();
+	MoveRanges(m_pBackend, m_vertexBuffer, BUFFER_VERTEX, vertexCapacity * g_VertexBytes, g_VertexBytes, vertexMoves);
+	MoveRanges(m_pBackend, m_tangentBuffer, BUFFER_VERTEX, vertexCapacity * g_TangentBytes, g_TangentBytes, vertexMoves);
+	MoveRanges(m_pBackend, m_indexBuffer, BUFFER_INDEX, m_indexRanges.GetCapacity() * g_IndexBytes, g_IndexBytes, indexMoves);
+	SetupVertexLayout();
+}
+
+/***********************************************************
+ *  GetAllocation()
+ *
+ *  This method returns where the mesh with the passed
+ *  handle currently lives.
+ ***********************************************************/
+const MESH_ALLOCATION& MeshHeap::GetAllocation(int handle) const
+{
+	return(m_allocations[handle]);
+}
+
+/***********************************************************
+ *  GetVertexLayout()
+ *
+ *  This method returns the vertex layout for drawing the
+ *  meshes in the heap.
+ ***********************************************************/
+uint32_t MeshHeap::GetVertexLayout() const
+{
+	return(m_vertexLayout);
+}
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshheap.h
+// ============
+// keep the data of every mesh in a few large GPU buffers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "BuddyAllocator.h"
+#include "MeshData.h"
+#include "RenderBackend.h"
+
+#include <vector>
+
+/***********************************************************
+ *  MESH_ALLOCATION
+ *
+ *  Where one mesh lives inside the heap.  The mesh indices
+ *  start at zero, so the draw calls pass baseVertex to move
+ *  them onto the mesh's vertices.
+ ***********************************************************/
+struct MESH_ALLOCATION
+{
+	int32_t baseVertex;
+	uint32_t vertexCount;
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	bool bInUse;
+};
+
+/***********************************************************
+ *  MeshHeap
+ *
+ *  This class owns one vertex buffer, one tangent buffer,
+ *  one index buffer and the vertex layout that reads them.
+ *  Meshes get ranges of these buffers from buddy
+ *  allocators, so loading and unloading a mesh never
+ *  creates or deletes a buffer object, and every mesh is
+ *  drawn with the same vertex layout.  Meshes
+ *  are referred to by handles that stay valid when the
+ *  heap grows or is defragmented.
+ ***********************************************************/
+class MeshHeap
+{
+public:
+	// constructor
+	MeshHeap();
+	// destructor
+	~MeshHeap();
+
+	// create the buffers through the passed backend - the
+	// capacities are numbers of vertices and indices, rounded
+	// up to powers of two
+	bool Create(RenderBackend* pBackend, uint32_t vertexCapacity, uint32_t indexCapacity);
+	// free the buffers and every allocation
+	void Destroy();
+
+	// copy a mesh into the heap and get its handle, or -1
+	int Allocate(const MESH_DATA& mesh);
+	// release the ranges of a mesh
+	void Free(int handle);
+	// move every mesh to the start of the buffers so the
+	// free space is in one piece again
+	void Defragment();
+	// true when the free space is split up badly enough
+	// that Defragment() is worth its copying
+	bool IsFragmented() const;
+
+	// where the mesh with the passed handle lives
+	const MESH_ALLOCATION& GetAllocation(int handle) const;
+	// vertex layout that draws every mesh in the heap
+	uint32_t GetVertexLayout() const;
+
+private:
+	// backend the buffers belong to
+	RenderBackend* m_pBackend;
+	// the vertex layout and its buffers
+	uint32_t m_vertexLayout;
+	uint32_t m_vertexBuffer;
+	uint32_t m_tangentBuffer;
+	uint32_t m_indexBuffer;
+	// ranges of the vertex and tangent buffers, in vertices
+	BuddyAllocator m_vertexRanges;
+	// ranges of the index buffer, in indices
+	BuddyAllocator m_indexRanges;
+	// allocations by handle
+	std::vector<MESH_ALLOCATION> m_allocations;
+	// handles of freed allocations for reuse
+	std::vector<int> m_freeHandles;
+
+	// point the vertex layout at the current buffers
+	void SetupVertexLayout();
+	// double the vertex or index capacity
+	void GrowVertices();
+	void GrowIndices();
+};
@@ -0,0 +1,1554 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshimporter.cpp
+// ============
+// load external mesh files (Wavefront OBJ and glTF 2.0) into mesh data
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshImporter.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// declaration of the global variables and helpers
+namespace
+{
+	// number of bytes of OBJ text each parsing task works on
+	const size_t OBJ_CHUNK_BYTES = 1 << 20;
+
+	// glTF constants
+	const uint32_t GLB_MAGIC = 0x46546C67;
+	const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+	const uint32_t GLB_CHUNK_BIN = 0x004E4942;
+	const int GLTF_BYTE = 5120;
+	const int GLTF_UNSIGNED_BYTE = 5121;
+	const int GLTF_SHORT = 5122;
+	const int GLTF_UNSIGNED_SHORT = 5123;
+	const int GLTF_UNSIGNED_INT = 5125;
+	const int GLTF_FLOAT = 5126;
+	const int GLTF_TRIANGLES = 4;
+
+	/***********************************************************
+	 *  MAPPED_FILE
+	 *
+	 *  Read-only memory mapping of a whole file, so the parsers
+	 *  can work on the file contents without copying them.
+	 ***********************************************************/
+	class MAPPED_FILE
+	{
+	public:
+		MAPPED_FILE() : m_pData(NULL), m_size(0)
+		{
+#ifdef _WIN32
+			m_hFile = INVALID_HANDLE_VALUE;
+			m_hMapping = NULL;
+#endif
+		}
+		~MAPPED_FILE() { Close(); }
+
+		bool Open(const std::string& filename)
+		{
+			Close();
+#ifdef _WIN32
+			m_hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+				OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (m_hFile == INVALID_HANDLE_VALUE)
+			{
+				return(false);
+			}
+			LARGE_INTEGER fileSize;
+			GetFileSizeEx(m_hFile, &fileSize);
+			m_size = static_cast<size_t>(fileSize.QuadPart);
+			if (m_size == 0)
+			{
+				return(true);
+			}
+			m_hMapping = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (m_hMapping == NULL)
+			{
+				Close();
+				return(false);
+			}
+			m_pData = static_cast<const unsigned char*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+#else
+			int fd = open(filename.c_str(), O_RDONLY);
+			if (fd < 0)
+			{
+				return(false);
+			}
+			struct stat fileStat;
+			fstat(fd, &fileStat);
+			m_size = static_cast<size_t>(fileStat.st_size);
+			if (m_size > 0)
+			{
+				void* pMapped = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				m_pData = (pMapped == MAP_FAILED) ? NULL : static_cast<const unsigned char*>(pMapped);
+				if (m_pData != NULL)
+				{
+					madvise(pMapped, m_size, MADV_SEQUENTIAL);
+				}
+			}
+			close(fd);
+#endif
+			if ((m_size > 0) && (m_pData == NULL))
+			{
+				Close();
+				return(false);
+			}
+			return(true);
+		}
+
+		void Close()
+		{
+#ifdef _WIN32
+			if (m_pData != NULL)
+				UnmapViewOfFile(m_pData);
+			if (m_hMapping != NULL)
+				CloseHandle(m_hMapping);
+			if (m_hFile != INVALID_HANDLE_VALUE)
+				CloseHandle(m_hFile);
+			m_hMapping = NULL;
+			m_hFile = INVALID_HANDLE_VALUE;
+#else
+			if (m_pData != NULL)
+				munmap(const_cast<unsigned char*>(m_pData), m_size);
+#endif
+			m_pData = NULL;
+			m_size = 0;
+		}
+
+		const unsigned char* Data() const { return m_pData; }
+		size_t Size() const { return m_size; }
+
+	private:
+		const unsigned char* m_pData;
+		size_t m_size;
+#ifdef _WIN32
+		HANDLE m_hFile;
+		HANDLE m_hMapping;
+#endif
+		MAPPED_FILE(const MAPPED_FILE&);
+		MAPPED_FILE& operator=(const MAPPED_FILE&);
+	};
+
+	/***********************************************************
+	 *  Text parsing helpers
+	 *
+	 *  These work directly on the mapped bytes and never read
+	 *  past the end pointer.
+	 ***********************************************************/
+	inline void SkipSpaces(const char*& p, const char* end)
+	{
+		while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\r')))
+			p++;
+	}
+
+	inline void SkipLine(const char*& p, const char* end)
+	{
+		const void* pNewline = memchr(p, '\n', end - p);
+		p = (pNewline != NULL) ? static_cast<const char*>(pNewline) + 1 : end;
+	}
+
+	inline bool IsDigit(char c)
+	{
+		return (c >= '0') && (c <= '9');
+	}
+
+	// parse a decimal number without going through the C
+	// locale or reading past the end of the buffer
+	inline double ParseDouble(const char*& p, const char* end)
+	{
+		SkipSpaces(p, end);
+
+		bool bNegative = false;
+		if ((p < end) && ((*p == '-') || (*p == '+')))
+		{
+			bNegative = (*p == '-');
+			p++;
+		}
+
+		double value = 0.0;
+		while ((p < end) && IsDigit(*p))
+		{
+			value = value * 10.0 + (*p - '0');
+			p++;
+		}
+		if ((p < end) && (*p == '.'))
+		{
+			p++;
+			double scale = 0.1;
+			while ((p < end) && IsDigit(*p))
+			{
+				value += (*p - '0') * scale;
+				scale *= 0.1;
+				p++;
+			}
+		}
+		if ((p < end) && ((*p == 'e') || (*p == 'E')))
+		{
+			p++;
+			bool bNegativeExponent = false;
+			if ((p < end) && ((*p == '-') || (*p == '+')))
+			{
+				bNegativeExponent = (*p == '-');
+				p++;
+			}
+			int exponent = 0;
+			while ((p < end) && IsDigit(*p))
+			{
+				exponent = exponent * 10 + (*p - '0');
+				p++;
+			}
+			value *= pow(10.0, bNegativeExponent ? -exponent : exponent);
+		}
+
+		return bNegative ? -value : value;
+	}
+
+	inline float ParseFloat(const char*& p, const char* end)
+	{
+		return static_cast<float>(ParseDouble(p, end));
+	}
+
+	inline bool ParseInt(const char*& p, const char* end, int& value)
+	{
+		bool bNegative = false;
+		if ((p < end) && (*p == '-'))
+		{
+			bNegative = true;
+			p++;
+		}
+		if ((p >= end) || !IsDigit(*p))
+		{
+			return(false);
+		}
+		value = 0;
+		while ((p < end) && IsDigit(*p))
+		{
+			value = value * 10 + (*p - '0');
+			p++;
+		}
+		if (bNegative)
+			value = -value;
+		return(true);
+	}
+
+	inline uint32_t HashCombine(uint32_t hash, uint32_t value)
+	{
+		hash ^= value + 0x9e3779b9u + (hash << 6) + (hash >> 2);
+		return(hash);
+	}
+
+	inline uint32_t NextPowerOfTwo(size_t value)
+	{
+		uint32_t result = 16;
+		while (result < value)
+			result <<= 1;
+		return(result);
+	}
+
+	/***********************************************************
+	 *  OBJ_CORNER
+	 *
+	 *  Position/texture/normal index triple of one face corner.
+	 *  Absolute indices are stored zero based and missing ones
+	 *  as -1.  Negative (relative) OBJ indices are stored as a
+	 *  chunk local index shifted by OBJ_RELATIVE_BIAS until the
+	 *  chunk's base offsets are known; the local index can be
+	 *  negative when it points back into an earlier chunk.
+	 ***********************************************************/
+	struct OBJ_CORNER
+	{
+		int32_t p;
+		int32_t t;
+		int32_t n;
+	};
+
+	struct OBJ_CHUNK
+	{
+		const char* begin;
+		const char* end;
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec2> texCoords;
+		std::vector<glm::vec3> normals;
+		std::vector<OBJ_CORNER> corners;
+		bool bHasRelative;
+	};
+
+	const int32_t OBJ_RELATIVE_BIAS = 0x40000000;
+
+	inline int32_t EncodeObjIndex(int value, size_t localCount, bool& bHasRelative)
+	{
+		if (value > 0)
+			return(value - 1);
+		if (value < 0)
+		{
+			bHasRelative = true;
+			return(static_cast<int32_t>(localCount) + value - OBJ_RELATIVE_BIAS);
+		}
+		return(-1);
+	}
+
+	inline int32_t ResolveObjIndex(int32_t value, size_t base)
+	{
+		return (value < -1) ? static_cast<int32_t>(base) + (value + OBJ_RELATIVE_BIAS) : value;
+	}
+
+	// parse the OBJ statements between begin and end
+	void ParseObjChunk(OBJ_CHUNK& chunk)
+	{
+		const char* p = chunk.begin;
+		const char* end = chunk.end;
+		std::vector<OBJ_CORNER> polygon;
+
+		while (p < end)
+		{
+			SkipSpaces(p, end);
+			if ((p + 1 < end) && (p[0] == 'v') && ((p[1] == ' ') || (p[1] == '\t')))
+			{
+				p += 1;
+				glm::vec3 position;
+				position.x = ParseFloat(p, end);
+				position.y = ParseFloat(p, end);
+				position.z = ParseFloat(p, end);
+				chunk.positions.push_back(position);
+			}
+			else if ((p + 2 < end) && (p[0] == 'v') && (p[1] == 't') && ((p[2] == ' ') || (p[2] == '\t')))
+			{
+				p += 2;
+				glm::vec2 texCoord;
+				texCoord.x = ParseFloat(p, end);
+				texCoord.y = ParseFloat(p, end);
+				chunk.texCoords.push_back(texCoord);
+			}
+			else if ((p + 2 < end) && (p[0] == 'v') && (p[1] == 'n') && ((p[2] == ' ') || (p[2] == '\t')))
+			{
+				p += 2;
+				glm::vec3 normal;
+				normal.x = ParseFloat(p, end);
+				normal.y = ParseFloat(p, end);
+				normal.z = ParseFloat(p, end);
+				chunk.normals.push_back(normal);
+			}
+			else if ((p + 1 < end) && (p[0] == 'f') && ((p[1] == ' ') || (p[1] == '\t')))
+			{
+				p += 1;
+				polygon.clear();
+				while (true)
+				{
+					SkipSpaces(p, end);
+					OBJ_CORNER corner;
+					int value = 0;
+					if (!ParseInt(p, end, value))
+						break;
+					corner.p = EncodeObjIndex(value, chunk.positions.size(), chunk.bHasRelative);
+					corner.t = -1;
+					corner.n = -1;
+					if ((p < end) && (*p == '/'))
+					{
+						p++;
+						if (ParseInt(p, end, value))
+							corner.t = EncodeObjIndex(value, chunk.texCoords.size(), chunk.bHasRelative);
+						if ((p < end) && (*p == '/'))
+						{
+							p++;
+							if (ParseInt(p, end, value))
+								corner.n = EncodeObjIndex(value, chunk.normals.size(), chunk.bHasRelative);
+						}
+					}
+					polygon.push_back(corner);
+				}
+
+				// triangulate the polygon as a fan around the first corner
+				for (size_t i = 2; i < polygon.size(); i++)
+				{
+					chunk.corners.push_back(polygon[0]);
+					chunk.corners.push_back(polygon[i - 1]);
+					chunk.corners.push_back(polygon[i]);
+				}
+			}
+			SkipLine(p, end);
+		}
+	}
+
+	/***********************************************************
+	 *  CORNER_HASH_MAP
+	 *
+	 *  Open addressing hash map from an OBJ corner triple to
+	 *  the index of the merged output vertex.  It does not
+	 *  grow, so it is made for the most corners it can hold.
+	 ***********************************************************/
+	class CORNER_HASH_MAP
+	{
+	public:
+		CORNER_HASH_MAP(size_t expectedCount)
+		{
+			m_mask = NextPowerOfTwo(expectedCount * 2) - 1;
+			m_keys.resize(m_mask + 1);
+			m_values.assign(m_mask + 1, UINT32_MAX);
+		}
+
+		// returns the existing value, or stores and returns newValue
+		uint32_t FindOrInsert(const OBJ_CORNER& key, uint32_t newValue)
+		{
+			uint32_t hash = HashCombine(HashCombine(static_cast<uint32_t>(key.p) * 0x85ebca6bu, key.t), key.n);
+			uint32_t slot = hash & m_mask;
+			while (m_values[slot] != UINT32_MAX)
+			{
+				const OBJ_CORNER& stored = m_keys[slot];
+				if ((stored.p == key.p) && (stored.t == key.t) && (stored.n == key.n))
+					return(m_values[slot]);
+				slot = (slot + 1) & m_mask;
+			}
+			m_keys[slot] = key;
+			m_values[slot] = newValue;
+			return(newValue);
+		}
+
+	private:
+		uint32_t m_mask;
+		std::vector<OBJ_CORNER> m_keys;
+		std::vector<uint32_t> m_values;
+	};
+
+	/***********************************************************
+	 *  VERTEX_HASH_MAP
+	 *
+	 *  Open addressing hash map that merges bit-identical
+	 *  vertices of an already indexed mesh.
+	 ***********************************************************/
+	class VERTEX_HASH_MAP
+	{
+	public:
+		VERTEX_HASH_MAP(const std::vector<MESH_VERTEX>& vertices, size_t expectedCount)
+			: m_vertices(vertices)
+		{
+			m_mask = NextPowerOfTwo(expectedCount * 2) - 1;
+			m_values.assign(m_mask + 1, UINT32_MAX);
+		}
+
+		uint32_t FindOrInsert(const MESH_VERTEX& vertex, uint32_t newValue)
+		{
+			uint32_t words[MESH_FLOATS_PER_VERTEX];
+			memcpy(words, &vertex, sizeof(words));
+			uint32_t hash = 0;
+			for (int i = 0; i < MESH_FLOATS_PER_VERTEX; i++)
+				hash = HashCombine(hash, words[i]);
+
+			uint32_t slot = hash & m_mask;
+			while (m_values[slot] != UINT32_MAX)
+			{
+				if (memcmp(&m_vertices[m_values[slot]], &vertex, sizeof(MESH_VERTEX)) == 0)
+					return(m_values[slot]);
+				slot = (slot + 1) & m_mask;
+			}
+			m_values[slot] = newValue;
+			return(newValue);
+		}
+
+	private:
+		const std::vector<MESH_VERTEX>& m_vertices;
+		uint32_t m_mask;
+		std::vector<uint32_t> m_values;
+	};
+
+	// fill in smooth vertex normals from the triangle faces
+	void ComputeSmoothNormals(
+		std::vector<MESH_VERTEX>& vertices,
+		const std::vector<uint32_t>& indices)
+	{
+		for (size_t i = 0; i < vertices.size(); i++)
+			vertices[i].normal = glm::vec3(0.0f);
+
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			MESH_VERTEX& v0 = vertices[indices[i]];
+			MESH_VERTEX& v1 = vertices[indices[i + 1]];
+			MESH_VERTEX& v2 = vertices[indices[i + 2]];
+			// area weighted face normal
+			glm::vec3 faceNormal = glm::cross(v1.position - v0.position, v2.position - v0.position);
+			v0.normal += faceNormal;
+			v1.normal += faceNormal;
+			v2.normal += faceNormal;
+		}
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			float length = glm::length(vertices[i].normal);
+			vertices[i].normal = (length > 0.0f) ? vertices[i].normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+		}
+	}
+
+	void ComputeBounds(MESH_DATA& mesh)
+	{
+		mesh.boundsMin = glm::vec3(0.0f);
+		mesh.boundsMax = glm::vec3(0.0f);
+		if (mesh.vertices.empty())
+			return;
+
+		mesh.boundsMin = mesh.vertices[0].position;
+		mesh.boundsMax = mesh.vertices[0].position;
+		for (size_t i = 1; i < mesh.vertices.size(); i++)
+		{
+			mesh.boundsMin = glm::min(mesh.boundsMin, mesh.vertices[i].position);
+			mesh.boundsMax = glm::max(mesh.boundsMax, mesh.vertices[i].position);
+		}
+	}
+
+	/***********************************************************
+	 *  JSON_VALUE
+	 *
+	 *  Small JSON document tree, just enough for glTF headers.
+	 ***********************************************************/
+	struct JSON_VALUE
+	{
+		enum TYPE { JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT };
+
+		TYPE type;
+		double number;
+		std::string text;
+		std::vector<JSON_VALUE> items;
+		std::vector<std::string> keys;
+
+		JSON_VALUE() : type(JSON_NULL), number(0.0) {}
+
+		const JSON_VALUE* Find(const char* key) const
+		{
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				if (keys[i] == key)
+					return(&items[i]);
+			}
+			return(NULL);
+		}
+
+		int GetInt(const char* key, int defaultValue) const
+		{
+			const JSON_VALUE* pValue = Find(key);
+			return ((pValue != NULL) && (pValue->type == JSON_NUMBER)) ? static_cast<int>(pValue->number) : defaultValue;
+		}
+
+		size_t Size() const { return items.size(); }
+	};
+
+	class JSON_PARSER
+	{
+	public:
+		JSON_PARSER(const char* text, size_t size) : m_p(text), m_end(text + size) {}
+
+		bool Parse(JSON_VALUE& value)
+		{
+			SkipWhitespace();
+			if (m_p >= m_end)
+				return(false);
+
+			switch (*m_p)
+			{
+			case '{':
+				return ParseObject(value);
+			case '[':
+				return ParseArray(value);
+			case '"':
+				value.type = JSON_VALUE::JSON_STRING;
+				return ParseString(value.text);
+			case 't':
+			case 'f':
+				value.type = JSON_VALUE::JSON_BOOL;
+				value.number = (*m_p == 't') ? 1.0 : 0.0;
+				return SkipWord();
+			case 'n':
+				value.type = JSON_VALUE::JSON_NULL;
+				return SkipWord();
+			default:
+				// the buffer may be a mapped file that is not NUL
+				// terminated, so strtod() could read past its end
+				if ((*m_p != '-') && !IsDigit(*m_p))
+					return(false);
+				value.type = JSON_VALUE::JSON_NUMBER;
+				value.number = ParseDouble(m_p, m_end);
+				return(true);
+			}
+		}
+
+	private:
+		const char* m_p;
+		const char* m_end;
+
+		void SkipWhitespace()
+		{
+			while ((m_p < m_end) && ((*m_p == ' ') || (*m_p == '\t') || (*m_p == '\n') || (*m_p == '\r')))
+				m_p++;
+		}
+
+		bool SkipWord()
+		{
+			while ((m_p < m_end) && (*m_p >= 'a') && (*m_p <= 'z'))
+				m_p++;
+			return(true);
+		}
+
+		bool ParseString(std::string& text)
+		{
+			m_p++;
+			while ((m_p < m_end) && (*m_p != '"'))
+			{
+				if ((*m_p == '\\') && (m_p + 1 < m_end))
+				{
+					m_p++;
+					switch (*m_p)
+					{
+					case 'n': text.push_back('\n'); break;
+					case 't': text.push_back('\t'); break;
+					case 'r': text.push_back('\r'); break;
+					case 'b': text.push_back('\b'); break;
+					case 'f': text.push_back('\f'); break;
+					case 'u':
+						// glTF keys and URIs are ASCII, keep a placeholder
+						text.push_back('?');
+						m_p += 4;
+						break;
+					default: text.push_back(*m_p); break;
+					}
+				}
+				else
+				{
+					text.push_back(*m_p);
+				}
+				m_p++;
+			}
+			if (m_p >= m_end)
+				return(false);
+			m_p++;
+			return(true);
+		}
+
+		bool ParseArray(JSON_VALUE& value)
+		{
+			value.type = JSON_VALUE::JSON_ARRAY;
+			m_p++;
+			SkipWhitespace();
+			if ((m_p < m_end) && (*m_p == ']'))
+			{
+				m_p++;
+				return(true);
+			}
+			while (m_p < m_end)
+			{
+				value.items.push_back(JSON_VALUE());
+				if (!Parse(value.items.back()))
+					return(false);
+				SkipWhitespace();
+				if ((m_p < m_end) && (*m_p == ','))
+				{
+					m_p++;
+					continue;
+				}
+				if ((m_p < m_end) && (*m_p == ']'))
+				{
+					m_p++;
+					return(true);
+				}
+				return(false);
+			}
+			return(false);
+		}
+
+		bool ParseObject(JSON_VALUE& value)
+		{
+			value.type = JSON_VALUE::JSON_OBJECT;
+			m_p++;
+			SkipWhitespace();
+			if ((m_p < m_end) && (*m_p == '}'))
+			{
+				m_p++;
+				return(true);
+			}
+			while (m_p < m_end)
+			{
+				SkipWhitespace();
+				if ((m_p >= m_end) || (*m_p != '"'))
+					return(false);
+				value.keys.push_back(std::string());
+				if (!ParseString(value.keys.back()))
+					return(false);
+				SkipWhitespace();
+				if ((m_p >= m_end) || (*m_p != ':'))
+					return(false);
+				m_p++;
+				value.items.push_back(JSON_VALUE());
+				if (!Parse(value.items.back()))
+					return(false);
+				SkipWhitespace();
+				if ((m_p < m_end) && (*m_p == ','))
+				{
+					m_p++;
+					continue;
+				}
+				if ((m_p < m_end) && (*m_p == '}'))
+				{
+					m_p++;
+					return(true);
+				}
+				return(false);
+			}
+			return(false);
+		}
+	};
+
+	bool DecodeBase64(const char* text, size_t size, std::vector<unsigned char>& output)
+	{
+		static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		int lookup[256];
+		for (int i = 0; i < 256; i++)
+			lookup[i] = -1;
+		for (int i = 0; i < 64; i++)
+			lookup[static_cast<unsigned char>(alphabet[i])] = i;
+
+		output.reserve(size * 3 / 4);
+		uint32_t bits = 0;
+		int bitCount = 0;
+		for (size_t i = 0; i < size; i++)
+		{
+			int value = lookup[static_cast<unsigned char>(text[i])];
+			if (value < 0)
+			{
+				if (text[i] == '=')
+					break;
+				continue;
+			}
+			bits = (bits << 6) | static_cast<uint32_t>(value);
+			bitCount += 6;
+			if (bitCount >= 8)
+			{
+				bitCount -= 8;
+				output.push_back(static_cast<unsigned char>((bits >> bitCount) & 0xFF));
+			}
+		}
+		return(true);
+	}
+
+	/***********************************************************
+	 *  GLTF_BUFFER
+	 *
+	 *  Raw bytes of one glTF buffer, either borrowed from a
+	 *  memory mapping or decoded from a data URI.
+	 ***********************************************************/
+	struct GLTF_BUFFER
+	{
+		const unsigned char* pData;
+		size_t size;
+		std::vector<unsigned char> decoded;
+		std::shared_ptr<MAPPED_FILE> mapping;
+	};
+
+	struct GLTF_DOCUMENT
+	{
+		JSON_VALUE root;
+		std::vector<GLTF_BUFFER> buffers;
+	};
+
+	// read a glTF accessor as floats, componentCount per element
+	bool ReadAccessor(
+		const GLTF_DOCUMENT& document,
+		int accessorIndex,
+		int componentCount,
+		std::vector<float>& output)
+	{
+		const JSON_VALUE* pAccessors = document.root.Find("accessors");
+		const JSON_VALUE* pViews = document.root.Find("bufferViews");
+		if ((pAccessors == NULL) || (pViews == NULL) || (accessorIndex < 0) || (accessorIndex >= (int)pAccessors->Size()))
+			return(false);
+
+		const JSON_VALUE& accessor = pAccessors->items[accessorIndex];
+		int viewIndex = accessor.GetInt("bufferView", -1);
+		int componentType = accessor.GetInt("componentType", GLTF_FLOAT);
+		size_t count = static_cast<size_t>(accessor.GetInt("count", 0));
+		const JSON_VALUE* pNormalized = accessor.Find("normalized");
+		bool bNormalized = (pNormalized != NULL) && (pNormalized->number != 0.0);
+
+		output.assign(count * componentCount, 0.0f);
+		if ((viewIndex < 0) || (viewIndex >= (int)pViews->Size()))
+			return(true); // sparse-only or zero-filled accessor
+
+		const JSON_VALUE& view = pViews->items[viewIndex];
+		int bufferIndex = view.GetInt("buffer", 0);
+		if ((bufferIndex < 0) || (bufferIndex >= (int)document.buffers.size()))
+			return(false);
+		const GLTF_BUFFER& buffer = document.buffers[bufferIndex];
+
+		size_t componentSize = 4;
+		if ((componentType == GLTF_BYTE) || (componentType == GLTF_UNSIGNED_BYTE))
+			componentSize = 1;
+		else if ((componentType == GLTF_SHORT) || (componentType == GLTF_UNSIGNED_SHORT))
+			componentSize = 2;
+
+		size_t offset = static_cast<size_t>(view.GetInt("byteOffset", 0)) + static_cast<size_t>(accessor.GetInt("byteOffset", 0));
+		size_t stride = static_cast<size_t>(view.GetInt("byteStride", 0));
+		if (stride == 0)
+			stride = componentSize * componentCount;
+
+		if ((count > 0) && (offset + stride * (count - 1) + componentSize * componentCount > buffer.size))
+		{
+			std::cout << "glTF accessor " << accessorIndex << " reads past the end of its buffer" << std::endl;
+			return(false);
+		}
+
+		const unsigned char* pBase = buffer.pData + offset;
+		for (size_t i = 0; i < count; i++)
+		{
+			const unsigned char* pElement = pBase + i * stride;
+			for (int c = 0; c < componentCount; c++)
+			{
+				float value = 0.0f;
+				switch (componentType)
+				{
+				case GLTF_FLOAT:
+				{
+					memcpy(&value, pElement + c * 4, 4);
+					break;
+				}
+				case GLTF_UNSIGNED_INT:
+				{
+					uint32_t raw;
+					memcpy(&raw, pElement + c * 4, 4);
+					value = static_cast<float>(raw);
+					break;
+				}
+				case GLTF_UNSIGNED_SHORT:
+				{
+					uint16_t raw;
+					memcpy(&raw, pElement + c * 2, 2);
+					value = bNormalized ? raw / 65535.0f : static_cast<float>(raw);
+					break;
+				}
+				case GLTF_SHORT:
+				{
+					int16_t raw;
+					memcpy(&raw, pElement + c * 2, 2);
+					value = bNormalized ? std::max(raw / 32767.0f, -1.0f) : static_cast<float>(raw);
+					break;
+				}
+				case GLTF_UNSIGNED_BYTE:
+				{
+					uint8_t raw = pElement[c];
+					value = bNormalized ? raw / 255.0f : static_cast<float>(raw);
+					break;
+				}
+				case GLTF_BYTE:
+				{
+					int8_t raw = static_cast<int8_t>(pElement[c]);
+					value = bNormalized ? std::max(raw / 127.0f, -1.0f) : static_cast<float>(raw);
+					break;
+				}
+				}
+				output[i * componentCount + c] = value;
+			}
+		}
+		return(true);
+	}
+
+	// read a glTF index accessor without going through floats
+	bool ReadIndices(const GLTF_DOCUMENT& document, int accessorIndex, std::vector<uint32_t>& output)
+	{
+		const JSON_VALUE* pAccessors = document.root.Find("accessors");
+		const JSON_VALUE* pViews = document.root.Find("bufferViews");
+		if ((pAccessors == NULL) || (pViews == NULL) || (accessorIndex < 0) || (accessorIndex >= (int)pAccessors->Size()))
+			return(false);
+
+		const JSON_VALUE& accessor = pAccessors->items[accessorIndex];
+		int viewIndex = accessor.GetInt("bufferView", -1);
+		int componentType = accessor.GetInt("componentType", GLTF_UNSIGNED_INT);
+		size_t count = static_cast<size_t>(accessor.GetInt("count", 0));
+		if ((viewIndex < 0) || (viewIndex >= (int)pViews->Size()))
+			return(false);
+
+		const JSON_VALUE& view = pViews->items[viewIndex];
+		int bufferIndex = view.GetInt("buffer", 0);
+		if ((bufferIndex < 0) || (bufferIndex >= (int)document.buffers.size()))
+			return(false);
+		const GLTF_BUFFER& buffer = document.buffers[bufferIndex];
+
+		size_t componentSize = (componentType == GLTF_UNSIGNED_BYTE) ? 1 : (componentType == GLTF_UNSIGNED_SHORT) ? 2 : 4;
+		size_t offset = static_cast<size_t>(view.GetInt("byteOffset", 0)) + static_cast<size_t>(accessor.GetInt("byteOffset", 0));
+		if (offset + componentSize * count > buffer.size)
+			return(false);
+
+		output.resize(count);
+		const unsigned char* pBase = buffer.pData + offset;
+		if (componentType == GLTF_UNSIGNED_INT)
+		{
+			memcpy(output.data(), pBase, count * 4);
+		}
+		else if (componentType == GLTF_UNSIGNED_SHORT)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				uint16_t raw;
+				memcpy(&raw, pBase + i * 2, 2);
+				output[i] = raw;
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < count; i++)
+				output[i] = pBase[i];
+		}
+		return(true);
+	}
+
+	// local transform of a glTF node from its matrix or TRS values
+	glm::mat4 GetNodeTransform(const JSON_VALUE& node)
+	{
+		const JSON_VALUE* pMatrix = node.Find("matrix");
+		if ((pMatrix != NULL) && (pMatrix->Size() == 16))
+		{
+			glm::mat4 matrix;
+			for (int i = 0; i < 16; i++)
+				matrix[i / 4][i % 4] = static_cast<float>(pMatrix->items[i].number);
+			return(matrix);
+		}
+
+		glm::mat4 translation;
+		glm::mat4 rotation;
+		glm::mat4 scale;
+		const JSON_VALUE* pTranslation = node.Find("translation");
+		if ((pTranslation != NULL) && (pTranslation->Size() == 3))
+		{
+			translation = glm::translate(glm::vec3(
+				static_cast<float>(pTranslation->items[0].number),
+				static_cast<float>(pTranslation->items[1].number),
+				static_cast<float>(pTranslation->items[2].number)));
+		}
+		const JSON_VALUE* pRotation = node.Find("rotation");
+		if ((pRotation != NULL) && (pRotation->Size() == 4))
+		{
+			// unit quaternion (x, y, z, w) to rotation matrix
+			float x = static_cast<float>(pRotation->items[0].number);
+			float y = static_cast<float>(pRotation->items[1].number);
+			float z = static_cast<float>(pRotation->items[2].number);
+			float w = static_cast<float>(pRotation->items[3].number);
+			rotation[0] = glm::vec4(1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w), 0.0f);
+			rotation[1] = glm::vec4(2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w), 0.0f);
+			rotation[2] = glm::vec4(2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y), 0.0f);
+		}
+		const JSON_VALUE* pScale = node.Find("scale");
+		if ((pScale != NULL) && (pScale->Size() == 3))
+		{
+			scale = glm::scale(glm::vec3(
+				static_cast<float>(pScale->items[0].number),
+				static_cast<float>(pScale->items[1].number),
+				static_cast<float>(pScale->items[2].number)));
+		}
+		return(translation * rotation * scale);
+	}
+
+	struct GLTF_PRIMITIVE_JOB
+	{
+		const JSON_VALUE* pPrimitive;
+		glm::mat4 transform;
+		MESH_DATA result;
+		bool bSuccess;
+	};
+
+	void CollectNodePrimitives(
+		const JSON_VALUE& root,
+		int nodeIndex,
+		const glm::mat4& parentTransform,
+		int depth,
+		std::vector<GLTF_PRIMITIVE_JOB>& jobs)
+	{
+		const JSON_VALUE* pNodes = root.Find("nodes");
+		if ((pNodes == NULL) || (nodeIndex < 0) || (nodeIndex >= (int)pNodes->Size()) || (depth > 64))
+			return;
+
+		const JSON_VALUE& node = pNodes->items[nodeIndex];
+		glm::mat4 transform = parentTransform * GetNodeTransform(node);
+
+		int meshIndex = node.GetInt("mesh", -1);
+		const JSON_VALUE* pMeshes = root.Find("meshes");
+		if ((meshIndex >= 0) && (pMeshes != NULL) && (meshIndex < (int)pMeshes->Size()))
+		{
+			const JSON_VALUE* pPrimitives = pMeshes->items[meshIndex].Find("primitives");
+			for (size_t i = 0; (pPrimitives != NULL) && (i < pPrimitives->Size()); i++)
+			{
+				GLTF_PRIMITIVE_JOB job;
+				job.pPrimitive = &pPrimitives->items[i];
+				job.transform = transform;
+				job.bSuccess = false;
+				jobs.push_back(job);
+			}
+		}
+
+		const JSON_VALUE* pChildren = node.Find("children");
+		for (size_t i = 0; (pChildren != NULL) && (i < pChildren->Size()); i++)
+		{
+			CollectNodePrimitives(root, static_cast<int>(pChildren->items[i].number), transform, depth + 1, jobs);
+		}
+	}
+
+	// decode one triangle primitive into world space vertices
+	bool DecodePrimitive(const GLTF_DOCUMENT& document, GLTF_PRIMITIVE_JOB& job)
+	{
+		const JSON_VALUE& primitive = *job.pPrimitive;
+		if (primitive.GetInt("mode", GLTF_TRIANGLES) != GLTF_TRIANGLES)
+		{
+			std::cout << "Skipping glTF primitive that is not a triangle list" << std::endl;
+			return(false);
+		}
+
+		const JSON_VALUE* pAttributes = primitive.Find("attributes");
+		if (pAttributes == NULL)
+			return(false);
+
+		std::vector<float> positions;
+		std::vector<float> normals;
+		std::vector<float> texCoords;
+		if (!ReadAccessor(document, pAttributes->GetInt("POSITION", -1), 3, positions))
+			return(false);
+		bool bHasNormals = ReadAccessor(document, pAttributes->GetInt("NORMAL", -1), 3, normals);
+		bool bHasTexCoords = ReadAccessor(document, pAttributes->GetInt("TEXCOORD_0", -1), 2, texCoords);
+
+		size_t vertexCount = positions.size() / 3;
+		std::vector<uint32_t> sourceIndices;
+		if (primitive.Find("indices") != NULL)
+		{
+			if (!ReadIndices(document, primitive.GetInt("indices", -1), sourceIndices))
+				return(false);
+		}
+		else
+		{
+			sourceIndices.resize(vertexCount);
+			for (size_t i = 0; i < vertexCount; i++)
+				sourceIndices[i] = static_cast<uint32_t>(i);
+		}
+
+		glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(job.transform)));
+
+		std::vector<MESH_VERTEX> sourceVertices(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			glm::vec3 position(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+			sourceVertices[i].position = glm::vec3(job.transform * glm::vec4(position, 1.0f));
+			if (bHasNormals && (normals.size() >= (i + 1) * 3))
+				sourceVertices[i].normal = glm::normalize(normalMatrix * glm::vec3(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]));
+			else
+				sourceVertices[i].normal = glm::vec3(0.0f);
+			// glTF puts the texture origin at the top left, OpenGL at the bottom left
+			if (bHasTexCoords && (texCoords.size() >= (i + 1) * 2))
+				sourceVertices[i].texCoord = glm::vec2(texCoords[i * 2], 1.0f - texCoords[i * 2 + 1]);
+			else
+				sourceVertices[i].texCoord = glm::vec2(0.0f);
+		}
+
+		// merge identical vertices
+		MESH_DATA& mesh = job.result;
+		mesh.vertices.reserve(vertexCount);
+		mesh.indices.reserve(sourceIndices.size());
+		VERTEX_HASH_MAP vertexMap(mesh.vertices, vertexCount);
+		std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			uint32_t index = vertexMap.FindOrInsert(sourceVertices[i], static_cast<uint32_t>(mesh.vertices.size()));
+			if (index == mesh.vertices.size())
+				mesh.vertices.push_back(sourceVertices[i]);
+			remap[i] = index;
+		}
+		for (size_t i = 0; i + 2 < sourceIndices.size(); i += 3)
+		{
+			if ((sourceIndices[i] >= vertexCount) || (sourceIndices[i + 1] >= vertexCount) || (sourceIndices[i + 2] >= vertexCount))
+				return(false);
+			mesh.indices.push_back(remap[sourceIndices[i]]);
+			mesh.indices.push_back(remap[sourceIndices[i + 1]]);
+			mesh.indices.push_back(remap[sourceIndices[i + 2]]);
+		}
+
+		if (!bHasNormals)
+			ComputeSmoothNormals(mesh.vertices, mesh.indices);
+
+		return(true);
+	}
+
+	std::string GetDirectory(const std::string& filename)
+	{
+		size_t slash = filename.find_last_of("/\\");
+		return (slash == std::string::npos) ? std::string() : filename.substr(0, slash + 1);
+	}
+
+	bool HasExtension(const std::string& filename, const char* extension)
+	{
+		size_t length = strlen(extension);
+		if (filename.size() < length)
+			return(false);
+		for (size_t i = 0; i < length; i++)
+		{
+			char c = filename[filename.size() - length + i];
+			if (tolower(static_cast<unsigned char>(c)) != extension[i])
+				return(false);
+		}
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  MeshImporter()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshImporter::MeshImporter(ThreadPool* pThreadPool)
+{
+	m_pThreadPool = pThreadPool;
+}
+
+/***********************************************************
+ *  ~MeshImporter()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshImporter::~MeshImporter()
+{
+	m_pThreadPool = NULL;
+}
+
+/***********************************************************
+ *  LoadMesh()
+ *
+ *  This method is used for parsing an external model file
+ *  into the passed mesh data.  The file type is picked by
+ *  its extension and the parse time is reported.
+ ***********************************************************/
+bool MeshImporter::LoadMesh(const std::string& filename, MESH_DATA& mesh)
+{
+	std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+
+	MAPPED_FILE file;
+	if (!file.Open(filename))
+	{
+		std::cout << "Could not open mesh file:" << filename << std::endl;
+		return(false);
+	}
+
+	mesh.vertices.clear();
+	mesh.indices.clear();
+
+	bool bReturn = false;
+	if (HasExtension(filename, ".obj"))
+	{
+		bReturn = ParseOBJ(reinterpret_cast<const char*>(file.Data()), file.Size(), mesh);
+	}
+	else if (HasExtension(filename, ".gltf"))
+	{
+		bReturn = ParseGLTF(filename, reinterpret_cast<const char*>(file.Data()), file.Size(), NULL, 0, mesh);
+	}
+	else if (HasExtension(filename, ".glb"))
+	{
+		bReturn = ParseGLB(filename, file.Data(), file.Size(), mesh);
+	}
+	else
+	{
+		std::cout << "Not implemented to handle mesh file:" << filename << std::endl;
+	}
+
+	if (bReturn)
+	{
+		ComputeBounds(mesh);
+
+		double elapsedMs = std::chrono::duration<double, std::milli>(
+			std::chrono::high_resolution_clock::now() - startTime).count();
+		std::cout << "Successfully loaded mesh:" << filename
+			<< ", vertices:" << mesh.vertices.size()
+			<< ", triangles:" << mesh.indices.size() / 3
+			<< ", parse time:" << elapsedMs << "ms" << std::endl;
+	}
+	else
+	{
+		std::cout << "Could not load mesh:" << filename << std::endl;
+	}
+
+	return(bReturn);
+}
+
+/***********************************************************
+ *  LoadMeshAsync()
+ *
+ *  This method is used for parsing an external model file on
+ *  one of the worker threads.  No OpenGL calls are made, so
+ *  the result must be uploaded from the main thread.
+ ***********************************************************/
+std::future<bool> MeshImporter::LoadMeshAsync(const std::string& filename, MESH_DATA* pMesh)
+{
+	return m_pThreadPool->Submit([this, filename, pMesh]()
+	{
+		return LoadMesh(filename, *pMesh);
+	});
+}
+
+/***********************************************************
+ *  ParseOBJ()
+ *
+ *  This method is used for parsing Wavefront OBJ text.  The
+ *  text is cut into chunks at line breaks and each chunk is
+ *  parsed by a separate task, then the chunks are stitched
+ *  together and the position/texture/normal triples are
+ *  merged into unique vertices.
+ ***********************************************************/
+bool MeshImporter::ParseOBJ(const char* text, size_t size, MESH_DATA& mesh)
+{
+	// cut the text into chunks that end on a line break
+	std::vector<OBJ_CHUNK> chunks;
+	const char* end = text + size;
+	const char* chunkBegin = text;
+	while (chunkBegin < end)
+	{
+		const char* chunkEnd = chunkBegin + std::min(OBJ_CHUNK_BYTES, static_cast<size_t>(end - chunkBegin));
+		if (chunkEnd < end)
+		{
+			const void* pNewline = memchr(chunkEnd, '\n', end - chunkEnd);
+			chunkEnd = (pNewline != NULL) ? static_cast<const char*>(pNewline) + 1 : end;
+		}
+		OBJ_CHUNK chunk;
+		chunk.begin = chunkBegin;
+		chunk.end = chunkEnd;
+		chunk.bHasRelative = false;
+		chunks.push_back(chunk);
+		chunkBegin = chunkEnd;
+	}
+
+	m_pThreadPool->ParallelFor(chunks.size(), 1, [&chunks](size_t begin, size_t finish)
+	{
+		for (size_t i = begin; i < finish; i++)
+			ParseObjChunk(chunks[i]);
+	});
+
+	// offsets of every chunk in the combined attribute arrays
+	std::vector<size_t> positionBase(chunks.size());
+	std::vector<size_t> texCoordBase(chunks.size());
+	std::vector<size_t> normalBase(chunks.size());
+	std::vector<size_t> cornerBase(chunks.size());
+	size_t positionCount = 0;
+	size_t texCoordCount = 0;
+	size_t normalCount = 0;
+	size_t cornerCount = 0;
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		positionBase[i] = positionCount;
+		texCoordBase[i] = texCoordCount;
+		normalBase[i] = normalCount;
+		cornerBase[i] = cornerCount;
+		positionCount += chunks[i].positions.size();
+		texCoordCount += chunks[i].texCoords.size();
+		normalCount += chunks[i].normals.size();
+		cornerCount += chunks[i].corners.size();
+	}
+
+	if ((positionCount == 0) || (cornerCount == 0))
+	{
+		std::cout << "OBJ file has no faces" << std::endl;
+		return(false);
+	}
+
+	std::vector<glm::vec3> positions(positionCount);
+	std::vector<glm::vec2> texCoords(texCoordCount);
+	std::vector<glm::vec3> normals(normalCount);
+	std::vector<OBJ_CORNER> corners(cornerCount);
+
+	m_pThreadPool->ParallelFor(chunks.size(), 1, [&](size_t begin, size_t finish)
+	{
+		for (size_t i = begin; i < finish; i++)
+		{
+			OBJ_CHUNK& chunk = chunks[i];
+			std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + positionBase[i]);
+			std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), texCoords.begin() + texCoordBase[i]);
+			std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + normalBase[i]);
+			for (size_t c = 0; c < chunk.corners.size(); c++)
+			{
+				OBJ_CORNER corner = chunk.corners[c];
+				if (chunk.bHasRelative)
+				{
+					corner.p = ResolveObjIndex(corner.p, positionBase[i]);
+					corner.t = ResolveObjIndex(corner.t, texCoordBase[i]);
+					corner.n = ResolveObjIndex(corner.n, normalBase[i]);
+				}
+				// drop references to attributes that do not exist
+				if ((corner.t < 0) || (corner.t >= (int32_t)texCoordCount))
+					corner.t = -1;
+				if ((corner.n < 0) || (corner.n >= (int32_t)normalCount))
+					corner.n = -1;
+				corners[cornerBase[i] + c] = corner;
+			}
+			// release the chunk memory as soon as it is merged
+			std::vector<glm::vec3>().swap(chunk.positions);
+			std::vector<glm::vec2>().swap(chunk.texCoords);
+			std::vector<glm::vec3>().swap(chunk.normals);
+			std::vector<OBJ_CORNER>().swap(chunk.corners);
+		}
+	});
+
+	// merge the corners that share all three indices
+	mesh.indices.resize(cornerCount);
+	mesh.vertices.reserve(cornerCount / 4);
+	std::vector<int32_t> vertexPositions;
+	vertexPositions.reserve(cornerCount / 4);
+	bool bMissingNormals = false;
+	// sized for every corner being distinct, as in a triangle
+	// soup, so the table never fills up
+	CORNER_HASH_MAP cornerMap(cornerCount);
+	for (size_t i = 0; i < cornerCount; i++)
+	{
+		const OBJ_CORNER& corner = corners[i];
+		if ((corner.p < 0) || (corner.p >= (int32_t)positionCount))
+		{
+			std::cout << "OBJ face references a missing vertex" << std::endl;
+			return(false);
+		}
+
+		uint32_t nextIndex = static_cast<uint32_t>(mesh.vertices.size());
+		uint32_t index = cornerMap.FindOrInsert(corner, nextIndex);
+		if (index == nextIndex)
+		{
+			MESH_VERTEX vertex;
+			vertex.position = positions[corner.p];
+			vertex.texCoord = (corner.t >= 0) ? texCoords[corner.t] : glm::vec2(0.0f);
+			vertex.normal = (corner.n >= 0) ? normals[corner.n] : glm::vec3(0.0f);
+			bMissingNormals = bMissingNormals || (corner.n < 0);
+			mesh.vertices.push_back(vertex);
+			vertexPositions.push_back(corner.p);
+		}
+		mesh.indices[i] = index;
+	}
+
+	if (bMissingNormals)
+	{
+		// smooth across every corner that shares a position, even
+		// when the texture coordinates split the vertex
+		std::vector<glm::vec3> positionNormals(positionCount, glm::vec3(0.0f));
+		for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+		{
+			int32_t p0 = vertexPositions[mesh.indices[i]];
+			int32_t p1 = vertexPositions[mesh.indices[i + 1]];
+			int32_t p2 = vertexPositions[mesh.indices[i + 2]];
+			glm::vec3 faceNormal = glm::cross(positions[p1] - positions[p0], positions[p2] - positions[p0]);
+			positionNormals[p0] += faceNormal;
+			positionNormals[p1] += faceNormal;
+			positionNormals[p2] += faceNormal;
+		}
+		for (size_t i = 0; i < mesh.vertices.size(); i++)
+		{
+			if (mesh.vertices[i].normal == glm::vec3(0.0f))
+			{
+				glm::vec3 normal = positionNormals[vertexPositions[i]];
+				float length = glm::length(normal);
+				mesh.vertices[i].normal = (length > 0.0f) ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+			}
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ParseGLB()
+ *
+ *  This method is used for splitting a binary glTF container
+ *  into its JSON and BIN chunks.  The BIN chunk is used in
+ *  place from the memory mapping.
+ ***********************************************************/
+bool MeshImporter::ParseGLB(const std::string& filename, const unsigned char* data, size_t size, MESH_DATA& mesh)
+{
+	uint32_t header[3];
+	if (size < sizeof(header))
+	{
+		std::cout << "GLB file is too small:" << filename << std::endl;
+		return(false);
+	}
+	memcpy(header, data, sizeof(header));
+	if ((header[0] != GLB_MAGIC) || (header[1] != 2))
+	{
+		std::cout << "Not a glTF 2.0 binary file:" << filename << std::endl;
+		return(false);
+	}
+
+	const char* pJson = NULL;
+	size_t jsonSize = 0;
+	const unsigned char* pBin = NULL;
+	size_t binSize = 0;
+
+	size_t offset = sizeof(header);
+	size_t length = std::min(size, static_cast<size_t>(header[2]));
+	while (offset + 8 <= length)
+	{
+		uint32_t chunkHeader[2];
+		memcpy(chunkHeader, data + offset, sizeof(chunkHeader));
+		offset += 8;
+		if (offset + chunkHeader[0] > length)
+			break;
+		if ((chunkHeader[1] == GLB_CHUNK_JSON) && (pJson == NULL))
+		{
+			pJson = reinterpret_cast<const char*>(data + offset);
+			jsonSize = chunkHeader[0];
+		}
+		else if ((chunkHeader[1] == GLB_CHUNK_BIN) && (pBin == NULL))
+		{
+			pBin = data + offset;
+			binSize = chunkHeader[0];
+		}
+		// chunks are padded to four bytes
+		offset += (chunkHeader[0] + 3) & ~3u;
+	}
+
+	if (pJson == NULL)
+	{
+		std::cout << "GLB file has no JSON chunk:" << filename << std::endl;
+		return(false);
+	}
+
+	return ParseGLTF(filename, pJson, jsonSize, pBin, binSize, mesh);
+}
+
+/***********************************************************
+ *  ParseGLTF()
+ *
+ *  This method is used for parsing a glTF 2.0 document.  All
+ *  of the triangle primitives reachable from the default
+ *  scene are transformed into model space and decoded on
+ *  the worker threads, then appended into one mesh.
+ ***********************************************************/
+bool MeshImporter::ParseGLTF(
+	const std::string& filename,
+	const char* json,
+	size_t jsonSize,
+	const unsigned char* binChunk,
+	size_t binSize,
+	MESH_DATA& mesh)
+{
+	GLTF_DOCUMENT document;
+	JSON_PARSER parser(json, jsonSize);
+	if (!parser.Parse(document.root) || (document.root.type != JSON_VALUE::JSON_OBJECT))
+	{
+		std::cout << "Could not parse glTF JSON:" << filename << std::endl;
+		return(false);
+	}
+
+	// resolve every buffer to a block of bytes
+	const JSON_VALUE* pBuffers = document.root.Find("buffers");
+	for (size_t i = 0; (pBuffers != NULL) && (i < pBuffers->Size()); i++)
+	{
+		GLTF_BUFFER buffer;
+		buffer.pData = NULL;
+		buffer.size = 0;
+
+		const JSON_VALUE* pUri = pBuffers->items[i].Find("uri");
+		if (pUri == NULL)
+		{
+			// the first buffer of a GLB file lives in the BIN chunk
+			buffer.pData = binChunk;
+			buffer.size = binSize;
+		}
+		else if (pUri->text.compare(0, 5, "data:") == 0)
+		{
+			size_t comma = pUri->text.find(',');
+			if (comma != std::string::npos)
+				DecodeBase64(pUri->text.c_str() + comma + 1, pUri->text.size() - comma - 1, buffer.decoded);
+			buffer.pData = buffer.decoded.data();
+			buffer.size = buffer.decoded.size();
+		}
+		else
+		{
+			buffer.mapping = std::make_shared<MAPPED_FILE>();
+			if (!buffer.mapping->Open(GetDirectory(filename) + pUri->text))
+			{
+				std::cout << "Could not open glTF buffer:" << pUri->text << std::endl;
+				return(false);
+			}
+			buffer.pData = buffer.mapping->Data();
+			buffer.size = buffer.mapping->Size();
+		}
+		document.buffers.push_back(buffer);
+	}
+	// decoded bytes were copied along with the buffer entries
+	for (size_t i = 0; i < document.buffers.size(); i++)
+	{
+		if (!document.buffers[i].decoded.empty())
+			document.buffers[i].pData = document.buffers[i].decoded.data();
+	}
+
+	// gather the primitives of the default scene, or of every
+	// mesh when the file has no scene graph
+	std::vector<GLTF_PRIMITIVE_JOB> jobs;
+	const JSON_VALUE* pScenes = document.root.Find("scenes");
+	int sceneIndex = document.root.GetInt("scene", 0);
+	if ((pScenes != NULL) && (sceneIndex >= 0) && (sceneIndex < (int)pScenes->Size()))
+	{
+		const JSON_VALUE* pRootNodes = pScenes->items[sceneIndex].Find("nodes");
+		for (size_t i = 0; (pRootNodes != NULL) && (i < pRootNodes->Size()); i++)
+			CollectNodePrimitives(document.root, static_cast<int>(pRootNodes->items[i].number), glm::mat4(1.0f), 0, jobs);
+	}
+	else
+	{
+		const JSON_VALUE* pMeshes = document.root.Find("meshes");
+		for (size_t m = 0; (pMeshes != NULL) && (m < pMeshes->Size()); m++)
+		{
+			const JSON_VALUE* pPrimitives = pMeshes->items[m].Find("primitives");
+			for (size_t i = 0; (pPrimitives != NULL) && (i < pPrimitives->Size()); i++)
+			{
+				GLTF_PRIMITIVE_JOB job;
+				job.pPrimitive = &pPrimitives->items[i];
+				job.transform = glm::mat4(1.0f);
+				job.bSuccess = false;
+				jobs.push_back(job);
+			}
+		}
+	}
+
+	m_pThreadPool->ParallelFor(jobs.size(), 1, [&document, &jobs](size_t begin, size_t finish)
+	{
+		for (size_t i = begin; i < finish; i++)
+			jobs[i].bSuccess = DecodePrimitive(document, jobs[i]);
+	});
+
+	// append the decoded primitives into the output mesh
+	size_t vertexCount = 0;
+	size_t indexCount = 0;
+	for (size_t i = 0; i < jobs.size(); i++)
+	{
+		if (jobs[i].bSuccess)
+		{
+			vertexCount += jobs[i].result.vertices.size();
+			indexCount += jobs[i].result.indices.size();
+		}
+	}
+	mesh.vertices.reserve(vertexCount);
+	mesh.indices.reserve(indexCount);
+	for (size_t i = 0; i < jobs.size(); i++)
+	{
+		if (!jobs[i].bSuccess)
+			continue;
+		uint32_t baseVertex = static_cast<uint32_t>(mesh.vertices.size());
+		mesh.vertices.insert(mesh.vertices.end(), jobs[i].result.vertices.begin(), jobs[i].result.vertices.end());
+		for (size_t j = 0; j < jobs[i].result.indices.size(); j++)
+			mesh.indices.push_back(baseVertex + jobs[i].result.indices[j]);
+	}
+
+	if (mesh.indices.empty())
+	{
+		std::cout << "glTF file has no triangle primitives:" << filename << std::endl;
+		return(false);
+	}
+	return(true);
+}
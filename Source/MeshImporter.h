@@ -0,0 +1,55 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshimporter.h
+// ============
+// load external mesh files (Wavefront OBJ and glTF 2.0) into mesh data
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshData.h"
+#include "ThreadPool.h"
+
+#include <future>
+#include <string>
+
+/***********************************************************
+ *  MeshImporter
+ *
+ *  This class parses external model files into indexed
+ *  triangle lists in the engine's vertex format.  Files are
+ *  memory mapped and parsed in place, the heavy parts are
+ *  split across the worker threads, and identical vertices
+ *  are merged through a hash map.
+ ***********************************************************/
+class MeshImporter
+{
+public:
+	// constructor
+	MeshImporter(ThreadPool* pThreadPool);
+	// destructor
+	~MeshImporter();
+
+	// parse a .obj, .gltf or .glb file into the passed mesh
+	bool LoadMesh(const std::string& filename, MESH_DATA& mesh);
+	// parse a mesh file on a worker thread - the mesh object
+	// must stay alive until the returned future is ready
+	std::future<bool> LoadMeshAsync(const std::string& filename, MESH_DATA* pMesh);
+
+private:
+	// worker threads used for parsing
+	ThreadPool* m_pThreadPool;
+
+	// parse Wavefront OBJ text
+	bool ParseOBJ(const char* text, size_t size, MESH_DATA& mesh);
+	// parse a glTF 2.0 JSON document with an optional GLB binary chunk
+	bool ParseGLTF(
+		const std::string& filename,
+		const char* json,
+		size_t jsonSize,
+		const unsigned char* binChunk,
+		size_t binSize,
+		MESH_DATA& mesh);
+	// parse a binary glTF 2.0 container
+	bool ParseGLB(const std::string& filename, const unsigned char* data, size_t size, MESH_DATA& mesh);
+};
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshuploadqueue.cpp
+// ============
+// hand meshes built on worker threads back to the OpenGL thread
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshUploadQueue.h"
+
+/***********************************************************
+ *  MeshUploadQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshUploadQueue::MeshUploadQueue()
+{
+	m_outstanding = 0;
+}
+
+/***********************************************************
+ *  ~MeshUploadQueue()
+ *
+ *  The destructor for the class.  Meshes that were never
+ *  taken are freed here.
+ ***********************************************************/
+MeshUploadQueue::~MeshUploadQueue()
+{
+	for (size_t i = 0; i < m_ready.size(); i++)
+	{
+		delete m_ready[i].pMesh;
+		delete m_ready[i].pMeshlets;
+	}
+	m_ready.clear();
+}
+
+/***********************************************************
+ *  Expect()
+ *
+ *  This method is used for announcing a mesh before its
+ *  task is queued, so WaitPop() knows to wait for it.
+ ***********************************************************/
+void MeshUploadQueue::Expect()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_outstanding++;
+}
+
+/***********************************************************
+ *  Push()
+ *
+ *  This method is used for handing a finished mesh to the
+ *  OpenGL thread.  The queue owns the mesh from now on.
+ ***********************************************************/
+void MeshUploadQueue::Push(const MESH_UPLOAD& upload)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_ready.push_back(upload);
+	}
+	m_signal.notify_one();
+}
+
+/***********************************************************
+ *  TryPop()
+ *
+ *  This method is used for taking a finished mesh without
+ *  waiting, such as once per frame.
+ ***********************************************************/
+bool MeshUploadQueue::TryPop(MESH_UPLOAD& upload)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_ready.empty())
+	{
+		return(false);
+	}
+	upload = m_ready.front();
+	m_ready.pop_front();
+	m_outstanding--;
+	return(true);
+}
+
+/***********************************************************
+ *  WaitPop()
+ *
+ *  This method is used for taking the next finished mesh,
+ *  waiting for a worker if none is ready yet.
+ ***********************************************************/
+bool MeshUploadQueue::WaitPop(MESH_UPLOAD& upload)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_signal.wait(lock, [this]() { return !m_ready.empty() || m_outstanding == 0; });
+	if (m_ready.empty())
+	{
+		return(false);
+	}
+	upload = m_ready.front();
+	m_ready.pop_front();
+	m_outstanding--;
+	return(true);
+}
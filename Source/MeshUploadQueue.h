@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshuploadqueue.h
+// ============
+// hand meshes built on worker threads back to the OpenGL thread
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshData.h"
+#include "MeshletBuilder.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+/***********************************************************
+ *  MESH_UPLOAD
+ *
+ *  A finished mesh waiting for its OpenGL buffers.  The
+ *  slot is chosen by whoever queued the work and tells the
+ *  OpenGL thread where the mesh belongs.
+ ***********************************************************/
+struct MESH_UPLOAD
+{
+	MESH_DATA* pMesh;
+	MESHLET_DATA* pMeshlets;
+	bool bClosedMesh;
+	int slot;
+};
+
+/***********************************************************
+ *  MeshUploadQueue
+ *
+ *  This class collects meshes from the worker threads so
+ *  the thread that owns the OpenGL context can upload each
+ *  one as soon as it is ready, while the rest are still
+ *  being built.
+ ***********************************************************/
+class MeshUploadQueue
+{
+public:
+	// constructor
+	MeshUploadQueue();
+	// destructor
+	~MeshUploadQueue();
+
+	// announce a mesh that will be pushed later
+	void Expect();
+	// hand over a finished mesh - called from the workers
+	void Push(const MESH_UPLOAD& upload);
+	// take a finished mesh if one is ready
+	bool TryPop(MESH_UPLOAD& upload);
+	// wait for the next finished mesh, returning false once
+	// every expected mesh has been taken
+	bool WaitPop(MESH_UPLOAD& upload);
+
+private:
+	// meshes that are ready for upload
+	std::deque<MESH_UPLOAD> m_ready;
+	// meshes announced but not taken yet
+	size_t m_outstanding;
+	// guards the ready list and the count
+	std::mutex m_mutex;
+	// signalled when a mesh is pushed
+	std::condition_variable m_signal;
+};
@@ -0,0 +1,438 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshletbuilder.cpp
+// ============
+// split large meshes into small clusters and cull them per frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshletBuilder.h"
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of the global variables and helpers
+namespace
+{
+	/***********************************************************
+	 *  ComputeMeshletBounds()
+	 *
+	 *  Bounding sphere (Ritter's method) and normal cone of the
+	 *  triangles in the passed index range.
+	 ***********************************************************/
+	void ComputeMeshletBounds(
+		const MESH_DATA& mesh,
+		const uint32_t* pIndices,
+		uint32_t indexCount,
+		glm::vec3& center,
+		float& radius,
+		glm::vec3& coneAxis,
+		float& coneCutoff)
+	{
+		// start with the two corners that are far apart
+		glm::vec3 first = mesh.vertices[pIndices[0]].position;
+		glm::vec3 farthest = first;
+		float farthestDistance = 0.0f;
+		for (uint32_t i = 0; i < indexCount; i++)
+		{
+			glm::vec3 position = mesh.vertices[pIndices[i]].position;
+			float distance = glm::dot(position - first, position - first);
+			if (distance > farthestDistance)
+			{
+				farthestDistance = distance;
+				farthest = position;
+			}
+		}
+		glm::vec3 opposite = farthest;
+		farthestDistance = 0.0f;
+		for (uint32_t i = 0; i < indexCount; i++)
+		{
+			glm::vec3 position = mesh.vertices[pIndices[i]].position;
+			float distance = glm::dot(position - farthest, position - farthest);
+			if (distance > farthestDistance)
+			{
+				farthestDistance = distance;
+				opposite = position;
+			}
+		}
+
+		// then grow the sphere until it holds every corner
+		center = (farthest + opposite) * 0.5f;
+		radius = glm::length(opposite - farthest) * 0.5f;
+		for (uint32_t i = 0; i < indexCount; i++)
+		{
+			glm::vec3 position = mesh.vertices[pIndices[i]].position;
+			float distance = glm::length(position - center);
+			if (distance > radius)
+			{
+				float newRadius = (radius + distance) * 0.5f;
+				center += (position - center) * ((newRadius - radius) / distance);
+				radius = newRadius;
+			}
+		}
+
+		// the cone axis is the average face direction, and the
+		// cutoff is the sine of the widest angle away from it
+		std::vector<glm::vec3> faceNormals;
+		faceNormals.reserve(indexCount / 3);
+		glm::vec3 normalSum(0.0f);
+		for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			glm::vec3 p0 = mesh.vertices[pIndices[i]].position;
+			glm::vec3 p1 = mesh.vertices[pIndices[i + 1]].position;
+			glm::vec3 p2 = mesh.vertices[pIndices[i + 2]].position;
+			glm::vec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(faceNormal);
+			if (area > 0.0f)
+			{
+				faceNormals.push_back(faceNormal / area);
+				normalSum += faceNormal / area;
+			}
+		}
+
+		coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+		coneCutoff = 1.0f;
+		float sumLength = glm::length(normalSum);
+		if (faceNormals.empty() || (sumLength <= 0.0f))
+		{
+			return;
+		}
+		coneAxis = normalSum / sumLength;
+
+		float minDot = 1.0f;
+		for (size_t i = 0; i < faceNormals.size(); i++)
+		{
+			minDot = std::min(minDot, glm::dot(faceNormals[i], coneAxis));
+		}
+		// cones wider than about 84 degrees never get culled
+		if (minDot > 0.1f)
+		{
+			coneCutoff = std::sqrt(1.0f - minDot * minDot);
+		}
+	}
+
+	inline void AppendMeshletCommand(
+		const MESHLET& meshlet,
+		std::vector<DRAW_ELEMENTS_INDIRECT_COMMAND>& commands)
+	{
+		// neighbouring visible meshlets become one draw
+		if (!commands.empty())
+		{
+			DRAW_ELEMENTS_INDIRECT_COMMAND& last = commands.back();
+			if (last.firstIndex + last.count == meshlet.firstIndex)
+			{
+				last.count += meshlet.indexCount;
+				return;
+			}
+		}
+
+		DRAW_ELEMENTS_INDIRECT_COMMAND command;
+		command.count = meshlet.indexCount;
+		command.instanceCount = 1;
+		command.firstIndex = meshlet.firstIndex;
+		command.baseVertex = 0;
+		command.baseInstance = 0;
+		commands.push_back(command);
+	}
+}
+
+/***********************************************************
+ *  BuildMeshlets()
+ *
+ *  This function is used for splitting a mesh into meshlets
+ *  of at most MESHLET_MAX_VERTICES unique vertices and
+ *  MESHLET_MAX_TRIANGLES triangles.  Each meshlet is grown
+ *  from a seed triangle by always adding the neighbouring
+ *  triangle that brings in the fewest new vertices, so the
+ *  clusters stay compact.  The mesh index buffer is rewritten
+ *  in meshlet order.
+ ***********************************************************/
+void BuildMeshlets(MESH_DATA& mesh, MESHLET_DATA& meshletData)
+{
+	meshletData = MESHLET_DATA();
+
+	uint32_t triangleCount = static_cast<uint32_t>(mesh.indices.size() / 3);
+	uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// vertex to triangle adjacency in compressed rows
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (uint32_t i = 0; i < triangleCount * 3; i++)
+	{
+		adjacencyOffsets[mesh.indices[i] + 1]++;
+	}
+	for (uint32_t v = 0; v < vertexCount; v++)
+	{
+		adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+	}
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+	std::vector<uint32_t> fillCursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (uint32_t t = 0; t < triangleCount; t++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			adjacency[fillCursor[mesh.indices[t * 3 + c]]++] = t;
+		}
+	}
+
+	std::vector<uint32_t> reordered;
+	reordered.reserve(mesh.indices.size());
+	std::vector<bool> emitted(triangleCount, false);
+	// id of the last meshlet that used each vertex
+	std::vector<uint32_t> vertexStamp(vertexCount, UINT32_MAX);
+	std::vector<uint32_t> candidates;
+	uint32_t scanCursor = 0;
+	uint32_t emittedCount = 0;
+
+	while (emittedCount < triangleCount)
+	{
+		uint32_t meshletId = static_cast<uint32_t>(meshletData.meshlets.size());
+		MESHLET meshlet;
+		meshlet.firstIndex = static_cast<uint32_t>(reordered.size());
+		meshlet.indexCount = 0;
+		meshlet.vertexCount = 0;
+		candidates.clear();
+
+		// seed with the next triangle in the original order
+		while (emitted[scanCursor])
+		{
+			scanCursor++;
+		}
+		uint32_t next = scanCursor;
+
+		while (next != UINT32_MAX)
+		{
+			// add the chosen triangle to the meshlet
+			emitted[next] = true;
+			emittedCount++;
+			for (int c = 0; c < 3; c++)
+			{
+				uint32_t vertex = mesh.indices[next * 3 + c];
+				reordered.push_back(vertex);
+				if (vertexStamp[vertex] != meshletId)
+				{
+					vertexStamp[vertex] = meshletId;
+					meshlet.vertexCount++;
+					// its neighbours become candidates
+					for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; a++)
+					{
+						if (!emitted[adjacency[a]])
+							candidates.push_back(adjacency[a]);
+					}
+				}
+			}
+			meshlet.indexCount += 3;
+
+			if (meshlet.indexCount / 3 >= MESHLET_MAX_TRIANGLES)
+			{
+				break;
+			}
+
+			// pick the candidate that adds the fewest vertices
+			next = UINT32_MAX;
+			uint32_t bestNewVertices = 4;
+			size_t write = 0;
+			for (size_t i = 0; i < candidates.size(); i++)
+			{
+				uint32_t triangle = candidates[i];
+				if (emitted[triangle])
+				{
+					continue;
+				}
+				candidates[write++] = triangle;
+
+				uint32_t newVertices = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					if (vertexStamp[mesh.indices[triangle * 3 + c]] != meshletId)
+						newVertices++;
+				}
+				if ((newVertices < bestNewVertices) && (meshlet.vertexCount + newVertices <= MESHLET_MAX_VERTICES))
+				{
+					bestNewVertices = newVertices;
+					next = triangle;
+					if (newVertices == 0)
+					{
+						// keep the remaining candidates for the next step
+						for (size_t j = i + 1; j < candidates.size(); j++)
+						{
+							if (!emitted[candidates[j]])
+								candidates[write++] = candidates[j];
+						}
+						break;
+					}
+				}
+			}
+			candidates.resize(write);
+		}
+
+		meshletData.meshlets.push_back(meshlet);
+	}
+
+	mesh.indices.swap(reordered);
+
+	// compute the culling bounds, padded to groups of four
+	size_t paddedCount = (meshletData.meshlets.size() + 3) & ~static_cast<size_t>(3);
+	meshletData.centerX.assign(paddedCount, 0.0f);
+	meshletData.centerY.assign(paddedCount, 0.0f);
+	meshletData.centerZ.assign(paddedCount, 0.0f);
+	meshletData.radius.assign(paddedCount, -1.0e30f);
+	meshletData.coneX.assign(paddedCount, 0.0f);
+	meshletData.coneY.assign(paddedCount, 0.0f);
+	meshletData.coneZ.assign(paddedCount, 1.0f);
+	meshletData.coneCutoff.assign(paddedCount, 1.0f);
+	for (size_t i = 0; i < meshletData.meshlets.size(); i++)
+	{
+		const MESHLET& meshlet = meshletData.meshlets[i];
+		glm::vec3 center;
+		glm::vec3 coneAxis;
+		ComputeMeshletBounds(
+			mesh,
+			&mesh.indices[meshlet.firstIndex],
+			meshlet.indexCount,
+			center,
+			meshletData.radius[i],
+			coneAxis,
+			meshletData.coneCutoff[i]);
+		meshletData.centerX[i] = center.x;
+		meshletData.centerY[i] = center.y;
+		meshletData.centerZ[i] = center.z;
+		meshletData.coneX[i] = coneAxis.x;
+		meshletData.coneY[i] = coneAxis.y;
+		meshletData.coneZ[i] = coneAxis.z;
+	}
+}
+
+/***********************************************************
+ *  ExtractFrustumPlanes()
+ *
+ *  This function is used for getting the six frustum planes
+ *  out of a combined projection matrix (Gribb/Hartmann).
+ *  The planes face inwards and are normalized, so a point's
+ *  dot product with a plane is its distance inside it.
+ ***********************************************************/
+void ExtractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6])
+{
+	glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+	for (int i = 0; i < 3; i++)
+	{
+		glm::vec4 row(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+		planes[i * 2] = row3 + row;
+		planes[i * 2 + 1] = row3 - row;
+	}
+
+	for (int p = 0; p < 6; p++)
+	{
+		float length = glm::length(glm::vec3(planes[p]));
+		if (length > 0.0f)
+		{
+			planes[p] /= length;
+		}
+	}
+}
+
+/***********************************************************
+ *  CullMeshlets()
+ *
+ *  This function is used for testing the meshlets of one
+ *  object against the view frustum and, for closed meshes
+ *  drawn with back faces hidden, against their normal cones,
+ *  four meshlets at a time with SSE.  All tests run in the
+ *  object's own space: the frustum planes come straight out
+ *  of the model-view-projection matrix and the camera is
+ *  passed already transformed by the inverse model matrix.
+ *  The cones are not carried into world space at all, so a
+ *  non-uniform scale cannot bend them; see the cone test.
+ *  Draw commands for the visible meshlets are appended, with
+ *  neighbouring meshlets merged, and the number of visible
+ *  meshlets is returned.
+ ***********************************************************/
+size_t CullMeshlets(
+	const MESHLET_DATA& meshletData,
+	const glm::mat4& modelViewProjection,
+	const glm::vec3& objectSpaceCamera,
+	bool bCullBackFaces,
+	std::vector<DRAW_ELEMENTS_INDIRECT_COMMAND>& commands)
+{
+	glm::vec4 planes[6];
+	ExtractFrustumPlanes(modelViewProjection, planes);
+
+	__m128 planeX[6];
+	__m128 planeY[6];
+	__m128 planeZ[6];
+	__m128 planeW[6];
+	for (int p = 0; p < 6; p++)
+	{
+		planeX[p] = _mm_set1_ps(planes[p].x);
+		planeY[p] = _mm_set1_ps(planes[p].y);
+		planeZ[p] = _mm_set1_ps(planes[p].z);
+		planeW[p] = _mm_set1_ps(planes[p].w);
+	}
+
+	__m128 cameraX = _mm_set1_ps(objectSpaceCamera.x);
+	__m128 cameraY = _mm_set1_ps(objectSpaceCamera.y);
+	__m128 cameraZ = _mm_set1_ps(objectSpaceCamera.z);
+	__m128 zero = _mm_setzero_ps();
+
+	size_t visibleCount = 0;
+	size_t meshletCount = meshletData.meshlets.size();
+	for (size_t base = 0; base < meshletCount; base += 4)
+	{
+		__m128 centerX = _mm_loadu_ps(&meshletData.centerX[base]);
+		__m128 centerY = _mm_loadu_ps(&meshletData.centerY[base]);
+		__m128 centerZ = _mm_loadu_ps(&meshletData.centerZ[base]);
+		__m128 radius = _mm_loadu_ps(&meshletData.radius[base]);
+		__m128 negativeRadius = _mm_sub_ps(zero, radius);
+
+		// the sphere must not be fully behind any plane
+		__m128 visible = _mm_cmpeq_ps(zero, zero);
+		for (int p = 0; p < 6; p++)
+		{
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(planeX[p], centerX), _mm_mul_ps(planeY[p], centerY)),
+				_mm_add_ps(_mm_mul_ps(planeZ[p], centerZ), planeW[p]));
+			visible = _mm_and_ps(visible, _mm_cmpgt_ps(distance, negativeRadius));
+		}
+
+		// back facing when the whole cone points away:
+		// dot(c - cam, axis) >= cutoff * |c - cam| + radius
+		// A face normal n moves to world space as inverse
+		// transpose(M) * n and the offset d to the camera as
+		// M * d, so dot(n, d) keeps its sign under any model
+		// matrix, scaled unevenly, sheared or mirrored; testing
+		// the object space cone against the object space camera
+		// is therefore exact and needs no widening
+		if (bCullBackFaces)
+		{
+			__m128 toCenterX = _mm_sub_ps(centerX, cameraX);
+			__m128 toCenterY = _mm_sub_ps(centerY, cameraY);
+			__m128 toCenterZ = _mm_sub_ps(centerZ, cameraZ);
+			__m128 distance = _mm_sqrt_ps(_mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(toCenterX, toCenterX), _mm_mul_ps(toCenterY, toCenterY)),
+				_mm_mul_ps(toCenterZ, toCenterZ)));
+			__m128 axisDot = _mm_add_ps(
+				_mm_add_ps(
+					_mm_mul_ps(toCenterX, _mm_loadu_ps(&meshletData.coneX[base])),
+					_mm_mul_ps(toCenterY, _mm_loadu_ps(&meshletData.coneY[base]))),
+				_mm_mul_ps(toCenterZ, _mm_loadu_ps(&meshletData.coneZ[base])));
+			__m128 limit = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&meshletData.coneCutoff[base]), distance), radius);
+			visible = _mm_andnot_ps(_mm_cmpge_ps(axisDot, limit), visible);
+		}
+
+		int mask = _mm_movemask_ps(visible);
+		for (int lane = 0; (mask != 0) && (lane < 4); lane++)
+		{
+			if ((mask & (1 << lane)) && (base + lane < meshletCount))
+			{
+				AppendMeshletCommand(meshletData.meshlets[base + lane], commands);
+				visibleCount++;
+			}
+		}
+	}
+
+	return(visibleCount);
+}
@@ -0,0 +1,88 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshletbuilder.h
+// ============
+// split large meshes into small clusters and cull them per frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshData.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// cluster size limits, matching common mesh shader limits
+const uint32_t MESHLET_MAX_VERTICES = 64;
+const uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+/***********************************************************
+ *  MESHLET
+ *
+ *  One cluster of triangles.  The triangles of a meshlet are
+ *  stored next to each other in the mesh index buffer, so a
+ *  meshlet is drawn as a single index range.
+ ***********************************************************/
+struct MESHLET
+{
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	uint32_t vertexCount;
+};
+
+/***********************************************************
+ *  MESHLET_DATA
+ *
+ *  The meshlets of one mesh, with the culling bounds kept in
+ *  structure-of-arrays form so four meshlets can be tested
+ *  at once.  The bounds arrays are padded to a multiple of
+ *  four with entries that always fail the frustum test.
+ ***********************************************************/
+struct MESHLET_DATA
+{
+	std::vector<MESHLET> meshlets;
+	// bounding sphere of each meshlet in object space
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> radius;
+	// normal cone axis and cutoff of each meshlet; a cutoff
+	// of 1 or more means the cone is too wide to cull
+	std::vector<float> coneX;
+	std::vector<float> coneY;
+	std::vector<float> coneZ;
+	std::vector<float> coneCutoff;
+};
+
+/***********************************************************
+ *  DRAW_ELEMENTS_INDIRECT_COMMAND
+ *
+ *  Layout read by glMultiDrawElementsIndirect().
+ ***********************************************************/
+struct DRAW_ELEMENTS_INDIRECT_COMMAND
+{
+	uint32_t count;
+	uint32_t instanceCount;
+	uint32_t firstIndex;
+	int32_t baseVertex;
+	uint32_t baseInstance;
+};
+
+// reorder the mesh indices into meshlets and compute their bounds
+void BuildMeshlets(MESH_DATA& mesh, MESHLET_DATA& meshletData);
+
+// get the normalized, inward facing frustum planes of a
+// combined projection matrix
+void ExtractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]);
+
+// append draw commands for the meshlets that are inside the
+// view frustum and, when back faces are culled, not facing
+// away from the camera
+size_t CullMeshlets(
+	const MESHLET_DATA& meshletData,
+	const glm::mat4& modelViewProjection,
+	const glm::vec3& objectSpaceCamera,
+	bool bCullBackFaces,
+	std::vector<DRAW_ELEMENTS_INDIRECT_COMMAND>& commands);
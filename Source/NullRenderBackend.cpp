@@ -0,0 +1,340 @@
+///////////////////////////////////////////////////////////////////////////////
+// nullrenderbackend.cpp
+// ============
+// count rendering commands without drawing anything
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "NullRenderBackend.h"
+
+/***********************************************************
+ *  NullRenderBackend()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+NullRenderBackend::NullRenderBackend()
+{
+	m_lastHandle = 0;
+	ResetCommandCounts();
+}
+
+/***********************************************************
+ *  CreateBuffer()
+ *
+ *  This method is used for counting a buffer creation.
+ ***********************************************************/
+uint32_t NullRenderBackend::CreateBuffer(BUFFER_TYPE, size_t size, const void*)
+{
+	m_counts.bufferWrites++;
+	m_counts.bufferBytes += size;
+	return(++m_lastHandle);
+}
+
+/***********************************************************
+ *  UpdateBuffer()
+ *
+ *  This method is used for counting a buffer update.
+ ***********************************************************/
+void NullRenderBackend::UpdateBuffer(uint32_t, size_t, size_t size, const void*)
+{
+	m_counts.bufferWrites++;
+	m_counts.bufferBytes += size;
+}
+
+/***********************************************************
+ *  CopyBuffer()
+ *
+ *  This method is used for counting a buffer copy.
+ ***********************************************************/
+void NullRenderBackend::CopyBuffer(uint32_t, uint32_t, size_t, size_t, size_t size)
+{
+	m_counts.bufferWrites++;
+	m_counts.bufferBytes += size;
+}
+
+/***********************************************************
+ *  DestroyBuffer()
+ *
+ *  This method is used for ignoring a buffer deletion.
+ ***********************************************************/
+void NullRenderBackend::DestroyBuffer(uint32_t)
+{
+}
+
+/***********************************************************
+ *  CreateVertexLayout()
+ *
+ *  This method is used for handing out a vertex layout
+ *  handle.
+ ***********************************************************/
+uint32_t NullRenderBackend::CreateVertexLayout(const VERTEX_ATTRIBUTE*, int, uint32_t)
+{
+	return(++m_lastHandle);
+}
+
+/***********************************************************
+ *  DestroyVertexLayout()
+ *
+ *  This method is used for ignoring a vertex layout
+ *  deletion.
+ ***********************************************************/
+void NullRenderBackend::DestroyVertexLayout(uint32_t)
+{
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used for handing out a texture handle.
+ ***********************************************************/
+uint32_t NullRenderBackend::CreateTexture(int, int, int, const unsigned char*)
+{
+	return(++m_lastHandle);
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used for counting a texture binding.
+ ***********************************************************/
+void NullRenderBackend::BindTexture(int, uint32_t)
+{
+	m_counts.textureBinds++;
+}
+
+/***********************************************************
+ *  DestroyTexture()
+ *
+ *  This method is used for ignoring a texture deletion.
+ ***********************************************************/
+void NullRenderBackend::DestroyTexture(uint32_t)
+{
+}
+
+/***********************************************************
+ *  CreateProgram()
+ *
+ *  This method is used for handing out a program handle
+ *  without reading the shader files.
+ ***********************************************************/
+uint32_t NullRenderBackend::CreateProgram(const char*, const char*)
+{
+	return(++m_lastHandle);
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used for counting a program change.
+ ***********************************************************/
+void NullRenderBackend::UseProgram(uint32_t)
+{
+	m_counts.programChanges++;
+}
+
+/***********************************************************
+ *  SetUniformInt()
+ *
+ *  This method is used for counting a uniform update.
+ ***********************************************************/
+void NullRenderBackend::SetUniformInt(const std::string&, int)
+{
+	m_counts.uniformUpdates++;
+}
+
+/***********************************************************
+ *  SetUniformFloat()
+ *
+ *  This method is used for counting a uniform update.
+ ***********************************************************/
+void NullRenderBackend::SetUniformFloat(const std::string&, float)
+{
+	m_counts.uniformUpdates++;
+}
+
+/***********************************************************
+ *  SetUniformVec2()
+ *
+ *  This method is used for counting a uniform update.
+ ***********************************************************/
+void NullRenderBackend::SetUniformVec2(const std::string&, const glm::vec2&)
+{
+	m_counts.uniformUpdates++;
+}
+
+/***********************************************************
+ *  SetUniformVec3()
+ *
+ *  This method is used for counting a uniform update.
+ ***********************************************************/
+void NullRenderBackend::SetUniformVec3(const std::string&, const glm::vec3&)
+{
+	m_counts.uniformUpdates++;
+}
+
+/***********************************************************
+ *  SetUniformVec4()
+ *
+ *  This method is used for counting a uniform update.
+ ***********************************************************/
+void NullRenderBackend::SetUniformVec4(const std::string&, const glm::vec4&)
+{
+	m_counts.uniformUpdates++;
+}
+
+/***********************************************************
+ *  SetUniformMat4()
+ *
+ *  This method is used for counting a uniform update.
+ ***********************************************************/
+void NullRenderBackend::SetUniformMat4(const std::string&, const glm::mat4&)
+{
+	m_counts.uniformUpdates++;
+}
+
+/***********************************************************
+ *  SetUniformSampler()
+ *
+ *  This method is used for counting a uniform update.
+ ***********************************************************/
+void NullRenderBackend::SetUniformSampler(const std::string&, int)
+{
+	m_counts.uniformUpdates++;
+}
+
+/***********************************************************
+ *  CreateRenderTarget()
+ *
+ *  This method is used for handing out a render target
+ *  handle, and the two after it for its textures.
+ ***********************************************************/
+uint32_t NullRenderBackend::CreateRenderTarget(int, int, RENDER_TARGET_FORMAT, bool, int)
+{
+	uint32_t target = ++m_lastHandle;
+	m_lastHandle += 2;
+	return(target);
+}
+
+/***********************************************************
+ *  GetRenderTargetTexture()
+ *
+ *  This method is used for getting the texture handle that
+ *  was handed out with a render target.
+ ***********************************************************/
+uint32_t NullRenderBackend::GetRenderTargetTexture(uint32_t target)
+{
+	return((0 == target) ? 0 : target + 1);
+}
+
+/***********************************************************
+ *  GetRenderTargetDepthTexture()
+ *
+ *  This method is used for getting the depth texture handle
+ *  that was handed out with a render target.
+ ***********************************************************/
+uint32_t NullRenderBackend::GetRenderTargetDepthTexture(uint32_t target)
+{
+	return((0 == target) ? 0 : target + 2);
+}
+
+/***********************************************************
+ *  SetRenderTarget()
+ *
+ *  This method is used for counting a render target change.
+ ***********************************************************/
+void NullRenderBackend::SetRenderTarget(uint32_t)
+{
+	m_counts.stateChanges++;
+}
+
+/***********************************************************
+ *  DestroyRenderTarget()
+ *
+ *  This method is used for ignoring a render target
+ *  deletion.
+ ***********************************************************/
+void NullRenderBackend::DestroyRenderTarget(uint32_t)
+{
+}
+
+/***********************************************************
+ *  SetPipelineState()
+ *
+ *  This method is used for counting a state change.
+ ***********************************************************/
+void NullRenderBackend::SetPipelineState(const PIPELINE_STATE&)
+{
+	m_counts.stateChanges++;
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for ignoring a clear.
+ ***********************************************************/
+void NullRenderBackend::Clear(const glm::vec4&)
+{
+}
+
+/***********************************************************
+ *  DrawIndexed()
+ *
+ *  This method is used for counting a draw call.
+ ***********************************************************/
+void NullRenderBackend::DrawIndexed(uint32_t, uint32_t indexCount, uint32_t, int32_t)
+{
+	m_counts.drawCalls++;
+	m_counts.drawRanges++;
+	m_counts.indices += indexCount;
+}
+
+/***********************************************************
+ *  DrawIndexedIndirect()
+ *
+ *  This method is used for counting an indirect draw call
+ *  and the ranges it covers.
+ ***********************************************************/
+void NullRenderBackend::DrawIndexedIndirect(uint32_t, const DRAW_ELEMENTS_INDIRECT_COMMAND* pCommands, size_t commandCount)
+{
+	if (0 == commandCount)
+	{
+		return;
+	}
+
+	m_counts.drawCalls++;
+	m_counts.drawRanges += commandCount;
+	for (size_t i = 0; i < commandCount; i++)
+	{
+		m_counts.indices += pCommands[i].count;
+	}
+}
+
+/***********************************************************
+ *  GetCommandCounts()
+ *
+ *  This method returns the commands counted since the last
+ *  reset.
+ ***********************************************************/
+const RENDER_COMMAND_COUNTS& NullRenderBackend::GetCommandCounts() const
+{
+	return(m_counts);
+}
+
+/***********************************************************
+ *  ResetCommandCounts()
+ *
+ *  This method is used for starting the counts over, for
+ *  example at the start of a frame.
+ ***********************************************************/
+void NullRenderBackend::ResetCommandCounts()
+{
+	m_counts.drawCalls = 0;
+	m_counts.drawRanges = 0;
+	m_counts.indices = 0;
+	m_counts.uniformUpdates = 0;
+	m_counts.textureBinds = 0;
+	m_counts.programChanges = 0;
+	m_counts.stateChanges = 0;
+	m_counts.bufferWrites = 0;
+	m_counts.bufferBytes = 0;
+}
@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////
+// nullrenderbackend.h
+// ============
+// count rendering commands without drawing anything
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+
+/***********************************************************
+ *  RENDER_COMMAND_COUNTS
+ *
+ *  How many commands of each kind reached the null backend
+ *  since the counts were last reset.
+ ***********************************************************/
+struct RENDER_COMMAND_COUNTS
+{
+	// draw calls, and the ranges and indices they covered
+	size_t drawCalls;
+	size_t drawRanges;
+	size_t indices;
+	size_t uniformUpdates;
+	size_t textureBinds;
+	size_t programChanges;
+	size_t stateChanges;
+	// buffer creations, updates and copies, and their bytes
+	size_t bufferWrites;
+	size_t bufferBytes;
+};
+
+/***********************************************************
+ *  NullRenderBackend
+ *
+ *  This class implements the rendering interface without a
+ *  graphics API.  Every command is counted and thrown away,
+ *  and new objects get increasing handles.  Rendering the
+ *  scene through it times the CPU side of a frame alone -
+ *  traversal, culling, batching and the cost of building
+ *  the commands - on any machine.
+ ***********************************************************/
+class NullRenderBackend : public RenderBackend
+{
+public:
+	// constructor
+	NullRenderBackend();
+
+	virtual uint32_t CreateBuffer(BUFFER_TYPE type, size_t size, const void* pData);
+	virtual void UpdateBuffer(uint32_t buffer, size_t offset, size_t size, const void* pData);
+	virtual void CopyBuffer(uint32_t source, uint32_t destination, size_t sourceOffset, size_t destinationOffset, size_t size);
+	virtual void DestroyBuffer(uint32_t buffer);
+
+	virtual uint32_t CreateVertexLayout(const VERTEX_ATTRIBUTE* pAttributes, int attributeCount, uint32_t indexBuffer);
+	virtual void DestroyVertexLayout(uint32_t layout);
+
+	virtual uint32_t CreateTexture(int width, int height, int channels, const unsigned char* pPixels);
+	virtual void BindTexture(int slot, uint32_t texture);
+	virtual void DestroyTexture(uint32_t texture);
+
+	virtual uint32_t CreateProgram(const char* vertexFilename, const char* fragmentFilename);
+	virtual void UseProgram(uint32_t program);
+	virtual void SetUniformInt(const std::string& name, int value);
+	virtual void SetUniformFloat(const std::string& name, float value);
+	virtual void SetUniformVec2(const std::string& name, const glm::vec2& value);
+	virtual void SetUniformVec3(const std::string& name, const glm::vec3& value);
+	virtual void SetUniformVec4(const std::string& name, const glm::vec4& value);
+	virtual void SetUniformMat4(const std::string& name, const glm::mat4& value);
+	virtual void SetUniformSampler(const std::string& name, int slot);
+
+	virtual uint32_t CreateRenderTarget(int width, int height, RENDER_TARGET_FORMAT format, bool bDepth, int samples);
+	virtual uint32_t GetRenderTargetTexture(uint32_t target);
+	virtual uint32_t GetRenderTargetDepthTexture(uint32_t target);
+	virtual void SetRenderTarget(uint32_t target);
+	virtual void DestroyRenderTarget(uint32_t target);
+
+	virtual void SetPipelineState(const PIPELINE_STATE& state);
+	virtual void Clear(const glm::vec4& color);
+
+	virtual void DrawIndexed(uint32_t layout, uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex);
+	virtual void DrawIndexedIndirect(uint32_t layout, const DRAW_ELEMENTS_INDIRECT_COMMAND* pCommands, size_t commandCount);
+
+	// commands counted since the last reset
+	const RENDER_COMMAND_COUNTS& GetCommandCounts() const;
+	void ResetCommandCounts();
+
+private:
+	RENDER_COMMAND_COUNTS m_counts;
+	// last handle given out
+	uint32_t m_lastHandle;
+};
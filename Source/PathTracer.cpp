@@ -0,0 +1,422 @@
+///////////////////////////////////////////////////////////////////////////////
+// pathtracer.cpp
+// ============
+// progressive path traced reference images of the scene
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PathTracer.h"
+#include "ImageFile.h"
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// size in pixels of the square tiles handed to the threads
+	const int g_TileSize = 16;
+	// width of the blue noise mask
+	const int g_BlueNoiseSize = 64;
+	// highest share of light a surface bounces on, so paths
+	// between bright surfaces still fade out
+	const float g_MaxAlbedo = 0.95f;
+	// bounces before paths may be cut short at random
+	const int g_RouletteStart = 2;
+	// blue noise dimensions used by the pixel position and
+	// by every bounce
+	const int g_PixelDimensions = 2;
+	const int g_BounceDimensions = 3;
+
+	const float g_Pi = 3.14159265358979f;
+
+	/***********************************************************
+	 *  IsSameLight()
+	 *
+	 *  True when two lights have the same values.
+	 ***********************************************************/
+	bool IsSameLight(const SCENE_LIGHT& a, const SCENE_LIGHT& b)
+	{
+		return((a.position == b.position) &&
+			(a.ambientColor == b.ambientColor) &&
+			(a.diffuseColor == b.diffuseColor) &&
+			(a.specularColor == b.specularColor) &&
+			(a.focalStrength == b.focalStrength) &&
+			(a.specularIntensity == b.specularIntensity));
+	}
+
+	/***********************************************************
+	 *  SampleCosineHemisphere()
+	 *
+	 *  Direction above a surface, picked with a density that
+	 *  follows the cosine to the normal like a diffuse
+	 *  surface reflects light.
+	 ***********************************************************/
+	glm::vec3 SampleCosineHemisphere(const glm::vec3& normal, float u1, float u2)
+	{
+		float radius = std::sqrt(u1);
+		float angle = 2.0f * g_Pi * u2;
+		float x = radius * std::cos(angle);
+		float y = radius * std::sin(angle);
+		float z = std::sqrt(std::max(0.0f, 1.0f - u1));
+
+		// any two directions perpendicular to the normal
+		glm::vec3 helper = (std::fabs(normal.x) > 0.9f) ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+		glm::vec3 tangent = glm::normalize(glm::cross(helper, normal));
+		glm::vec3 bitangent = glm::cross(normal, tangent);
+		return(tangent * x + bitangent * y + normal * z);
+	}
+}
+
+/***********************************************************
+ *  PathTracer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+PathTracer::PathTracer(ThreadPool* pThreadPool)
+{
+	m_pThreadPool = pThreadPool;
+	m_settings.maxBounces = 3;
+	m_settings.bAmbientTerm = false;
+	m_settings.environmentColor = glm::vec3(0.0f);
+	m_width = 0;
+	m_height = 0;
+	m_tilesX = 0;
+	m_tilesY = 0;
+	m_sampleCount = 0;
+	m_view = glm::mat4(1.0f);
+	m_projection = glm::mat4(1.0f);
+	m_inverseViewProjection = glm::mat4(1.0f);
+	m_viewPosition = glm::vec3(0.0f);
+
+	m_blueNoise.Generate(g_BlueNoiseSize);
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the size of the image,
+ *  which starts it over.
+ ***********************************************************/
+void PathTracer::Resize(int width, int height)
+{
+	m_width = std::max(width, 0);
+	m_height = std::max(height, 0);
+	m_tilesX = (m_width + g_TileSize - 1) / g_TileSize;
+	m_tilesY = (m_height + g_TileSize - 1) / g_TileSize;
+	m_colorBuffer.assign(static_cast<size_t>(m_width) * m_height, PackColor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+	Reset();
+}
+
+/***********************************************************
+ *  SetCamera()
+ *
+ *  This method is used for setting the view and projection
+ *  matrices and the camera position.  Samples taken from
+ *  another camera position would blur the image, so any
+ *  change starts it over.
+ ***********************************************************/
+void PathTracer::SetCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition)
+{
+	if ((view != m_view) || (projection != m_projection) || (viewPosition != m_viewPosition))
+	{
+		m_view = view;
+		m_projection = projection;
+		m_inverseViewProjection = glm::inverse(projection * view);
+		m_viewPosition = viewPosition;
+		Reset();
+	}
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for setting the light sources.
+ ***********************************************************/
+void PathTracer::SetLights(const std::vector<SCENE_LIGHT>& lights)
+{
+	bool bChanged = (lights.size() != m_lights.size());
+	for (size_t i = 0; !bChanged && (i < lights.size()); i++)
+	{
+		bChanged = !IsSameLight(lights[i], m_lights[i]);
+	}
+
+	if (bChanged)
+	{
+		m_lights = lights;
+		Reset();
+	}
+}
+
+/***********************************************************
+ *  SetSettings()
+ *
+ *  This method is used for setting the bounce count, the
+ *  ambient term and the environment.
+ ***********************************************************/
+void PathTracer::SetSettings(const PATH_TRACE_SETTINGS& settings)
+{
+	int maxBounces = std::max(settings.maxBounces, 0);
+	if ((maxBounces != m_settings.maxBounces) ||
+		(settings.bAmbientTerm != m_settings.bAmbientTerm) ||
+		(settings.environmentColor != m_settings.environmentColor))
+	{
+		m_settings = settings;
+		m_settings.maxBounces = maxBounces;
+		Reset();
+	}
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for throwing away the collected
+ *  samples.
+ ***********************************************************/
+void PathTracer::Reset()
+{
+	m_accumulation.assign(static_cast<size_t>(m_width) * m_height, glm::vec3(0.0f));
+	m_sampleCount = 0;
+}
+
+/***********************************************************
+ *  Render()
+ *
+ *  This method is used for adding one sample to every
+ *  pixel.  The tiles are handed out to the threads one at
+ *  a time, so threads that finish early take over the rest.
+ ***********************************************************/
+void PathTracer::Render(const std::vector<SOFTWARE_DRAW>& draws)
+{
+	if ((m_width == 0) || (m_height == 0))
+	{
+		return;
+	}
+
+	m_scene.Build(draws, m_pThreadPool);
+
+	m_pThreadPool->ParallelFor(
+		static_cast<size_t>(m_tilesX) * m_tilesY,
+		1,
+		[this, &draws](size_t begin, size_t end)
+	{
+		for (size_t tile = begin; tile < end; tile++)
+		{
+			RenderTile(static_cast<int>(tile), draws);
+		}
+	});
+
+	m_sampleCount++;
+}
+
+/***********************************************************
+ *  ClearMeshCache()
+ *
+ *  This method is used for dropping the mesh hierarchies so
+ *  they are rebuilt from the current mesh data.
+ ***********************************************************/
+void PathTracer::ClearMeshCache()
+{
+	m_scene.ClearMeshCache();
+}
+
+/***********************************************************
+ *  RenderTile()
+ *
+ *  This method is used for tracing one more path through
+ *  every pixel of a tile and updating the averaged colors.
+ ***********************************************************/
+void PathTracer::RenderTile(int tileIndex, const std::vector<SOFTWARE_DRAW>& draws)
+{
+	int tileX = (tileIndex % m_tilesX) * g_TileSize;
+	int tileY = (tileIndex / m_tilesX) * g_TileSize;
+	int endX = std::min(tileX + g_TileSize, m_width);
+	int endY = std::min(tileY + g_TileSize, m_height);
+	uint32_t frame = static_cast<uint32_t>(m_sampleCount);
+	float sampleWeight = 1.0f / (m_sampleCount + 1);
+
+	for (int y = tileY; y < endY; y++)
+	{
+		for (int x = tileX; x < endX; x++)
+		{
+			BVH_RAY ray;
+			GetCameraRay(
+				m_inverseViewProjection,
+				m_width,
+				m_height,
+				x + m_blueNoise.Sample(x, y, 0, frame),
+				y + m_blueNoise.Sample(x, y, 1, frame),
+				ray.origin,
+				ray.direction);
+
+			size_t pixel = static_cast<size_t>(y) * m_width + x;
+			m_accumulation[pixel] += TracePath(ray, draws, x, y);
+			m_colorBuffer[pixel] = PackColor(glm::vec4(m_accumulation[pixel] * sampleWeight, 1.0f));
+		}
+	}
+}
+
+/***********************************************************
+ *  TracePath()
+ *
+ *  This method is used for following one path from the
+ *  camera.  Every hit adds the light that reaches it
+ *  directly, lit with the terms of the fragment shader, and
+ *  then the path bounces off in a random direction like off
+ *  a diffuse surface colored by the material's diffuse
+ *  color and the texture or object color.
+ ***********************************************************/
+glm::vec3 PathTracer::TracePath(BVH_RAY ray, const std::vector<SOFTWARE_DRAW>& draws, int x, int y) const
+{
+	uint32_t frame = static_cast<uint32_t>(m_sampleCount);
+	glm::vec3 radiance(0.0f);
+	glm::vec3 throughput(1.0f);
+
+	for (int bounce = 0; bounce <= m_settings.maxBounces; bounce++)
+	{
+		// camera rays end at the far plane, bounced rays do not
+		ray.t = (bounce == 0) ? 1.0f : 1.0e30f;
+		ray.triangle = -1;
+		if (!m_scene.GetBVH().Intersect(ray))
+		{
+			radiance += throughput * m_settings.environmentColor;
+			break;
+		}
+
+		SURFACE_POINT point;
+		m_scene.GetSurfacePoint(ray, draws, point);
+		float normalLength = glm::length(point.normal);
+		if (normalLength <= 0.0f)
+		{
+			break;
+		}
+
+		// surfaces are lit on whichever side the path arrives
+		glm::vec3 normal = point.normal / normalLength;
+		glm::vec3 viewDirection = -glm::normalize(ray.direction);
+		if (glm::dot(normal, viewDirection) < 0.0f)
+		{
+			normal = -normal;
+		}
+
+		const SURFACE_SHADING& shading = point.pDraw->shading;
+		glm::vec3 baseColor = glm::vec3(shading.color);
+		if (NULL != shading.pTexture)
+		{
+			baseColor = glm::vec3(SampleTexture(*shading.pTexture, point.texCoord * shading.uvScale));
+		}
+
+		glm::vec3 direct(0.0f);
+		for (size_t i = 0; i < m_lights.size(); i++)
+		{
+			const SCENE_LIGHT& light = m_lights[i];
+			if (m_settings.bAmbientTerm)
+			{
+				direct += light.ambientColor * shading.material.ambientColor;
+			}
+
+			glm::vec3 lightDirection = light.position - point.position;
+			if ((glm::dot(normal, lightDirection) <= 0.0f) ||
+				!m_scene.IsPointVisible(point.position, normal, light.position))
+			{
+				continue;
+			}
+			lightDirection = glm::normalize(lightDirection);
+
+			float impact = glm::dot(normal, lightDirection);
+			direct += impact * light.diffuseColor * shading.material.diffuseColor;
+
+			glm::vec3 reflectDirection = glm::reflect(-lightDirection, normal);
+			float specularComponent = std::pow(std::max(glm::dot(viewDirection, reflectDirection), 0.0f), light.focalStrength);
+			direct += light.specularIntensity * specularComponent * shading.material.specularColor;
+		}
+		radiance += throughput * baseColor * direct;
+
+		if (bounce == m_settings.maxBounces)
+		{
+			break;
+		}
+
+		// the shader's diffuse term already includes the 1 / pi
+		// of a diffuse surface, so the bounce keeps the same
+		// scale when the cosine weighted pick cancels the rest
+		glm::vec3 albedo = glm::min(baseColor * shading.material.diffuseColor, glm::vec3(g_MaxAlbedo));
+		throughput *= albedo;
+
+		int dimension = g_PixelDimensions + bounce * g_BounceDimensions;
+		if (bounce >= g_RouletteStart)
+		{
+			float survival = std::max(throughput.r, std::max(throughput.g, throughput.b));
+			if (m_blueNoise.Sample(x, y, dimension + 2, frame) >= survival)
+			{
+				break;
+			}
+			throughput /= survival;
+		}
+		if ((throughput.r <= 0.0f) && (throughput.g <= 0.0f) && (throughput.b <= 0.0f))
+		{
+			break;
+		}
+
+		glm::vec3 direction = SampleCosineHemisphere(
+			normal,
+			m_blueNoise.Sample(x, y, dimension, frame),
+			m_blueNoise.Sample(x, y, dimension + 1, frame));
+		ray.origin = OffsetFromSurface(point.position, normal, direction);
+		ray.direction = direction;
+	}
+
+	return(radiance);
+}
+
+/***********************************************************
+ *  GetSampleCount()
+ *
+ *  This method is used for getting the number of samples
+ *  averaged in every pixel.
+ ***********************************************************/
+int PathTracer::GetSampleCount() const
+{
+	return(m_sampleCount);
+}
+
+/***********************************************************
+ *  GetWidth()
+ *
+ *  This method is used for getting the width of the image.
+ ***********************************************************/
+int PathTracer::GetWidth() const
+{
+	return(m_width);
+}
+
+/***********************************************************
+ *  GetHeight()
+ *
+ *  This method is used for getting the height of the image.
+ ***********************************************************/
+int PathTracer::GetHeight() const
+{
+	return(m_height);
+}
+
+/***********************************************************
+ *  GetColorBuffer()
+ *
+ *  This method is used for getting the averaged pixels.
+ ***********************************************************/
+const uint32_t* PathTracer::GetColorBuffer() const
+{
+	return(m_colorBuffer.data());
+}
+
+/***********************************************************
+ *  SaveImage()
+ *
+ *  This method is used for writing the averaged image into
+ *  a binary PPM image.
+ ***********************************************************/
+bool PathTracer::SaveImage(const char* filename) const
+{
+	return(SavePPMImage(filename, m_width, m_height, m_colorBuffer.data()));
+}
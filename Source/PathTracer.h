@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+// pathtracer.h
+// ============
+// progressive path traced reference images of the scene
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "BlueNoise.h"
+#include "ShadingModel.h"
+#include "SoftwareRasterizer.h"
+#include "ThreadPool.h"
+#include "TracedScene.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  PATH_TRACE_SETTINGS
+ *
+ *  Settings of the path tracer.
+ ***********************************************************/
+struct PATH_TRACE_SETTINGS
+{
+	// diffuse bounces after the first hit - zero gives the
+	// direct light of the fragment shader with shadows
+	int maxBounces;
+	// add the lights' ambient terms like the fragment shader,
+	// off shows what the bounced light alone provides
+	bool bAmbientTerm;
+	// light arriving along rays that leave the scene
+	glm::vec3 environmentColor;
+};
+
+/***********************************************************
+ *  PathTracer
+ *
+ *  This class renders ground truth images of the draw lists
+ *  the other CPU renderers take.  Every Render() traces one
+ *  path per pixel, with shadow rays to every light at each
+ *  bounce, and adds it to the image.  The image keeps
+ *  converging for as long as the camera stays still, and
+ *  starts over when the camera or the settings change.  The
+ *  random numbers come from a blue noise mask, and the
+ *  tiles of the screen are traced on the worker threads.
+ ***********************************************************/
+class PathTracer
+{
+public:
+	// constructor
+	PathTracer(ThreadPool* pThreadPool);
+
+	// set the size of the image in pixels
+	void Resize(int width, int height);
+	// set the camera - a different camera than the last one
+	// starts the image over
+	void SetCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition);
+	// set the lights - changed lights start the image over
+	void SetLights(const std::vector<SCENE_LIGHT>& lights);
+	// set the settings - changed settings start the image over
+	void SetSettings(const PATH_TRACE_SETTINGS& settings);
+	// throw away the samples collected so far
+	void Reset();
+
+	// add one sample per pixel with the passed meshes - the
+	// meshes must not change while their hierarchies are cached
+	void Render(const std::vector<SOFTWARE_DRAW>& draws);
+	// forget the cached mesh hierarchies, needed before a
+	// drawn mesh is changed or freed
+	void ClearMeshCache();
+
+	// number of samples per pixel collected so far
+	int GetSampleCount() const;
+	int GetWidth() const;
+	int GetHeight() const;
+	// RGBA bytes of the averaged image, top row first
+	const uint32_t* GetColorBuffer() const;
+	// write the averaged image to a binary PPM file
+	bool SaveImage(const char* filename) const;
+
+private:
+	// workers shared with the rest of the scene code
+	ThreadPool* m_pThreadPool;
+	PATH_TRACE_SETTINGS m_settings;
+
+	int m_width;
+	int m_height;
+	int m_tilesX;
+	int m_tilesY;
+	// sum of the samples of every pixel, and their average
+	std::vector<glm::vec3> m_accumulation;
+	std::vector<uint32_t> m_colorBuffer;
+	int m_sampleCount;
+
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	glm::mat4 m_inverseViewProjection;
+	glm::vec3 m_viewPosition;
+	std::vector<SCENE_LIGHT> m_lights;
+
+	TracedScene m_scene;
+	BlueNoise m_blueNoise;
+
+	// trace one sample for each pixel of a tile
+	void RenderTile(int tileIndex, const std::vector<SOFTWARE_DRAW>& draws);
+	// light arriving at the camera along one path
+	glm::vec3 TracePath(BVH_RAY ray, const std::vector<SOFTWARE_DRAW>& draws, int x, int y) const;
+};
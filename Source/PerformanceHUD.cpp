@@ -0,0 +1,548 @@
+///////////////////////////////////////////////////////////////////////////////
+// performancehud.cpp
+// ============
+// on-screen overlay of the frame rate, zone times and draw counts
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PerformanceHUD.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+// declaration of the global variables and helpers
+namespace
+{
+	// most quads the overlay draws in a frame
+	const size_t g_MaxQuads = 2048;
+	// texture unit of the font atlas, above the ones the
+	// scene's textures take
+	const int g_AtlasSlot = 15;
+	// frame times in the graph
+	const size_t g_GraphFrames = 150;
+	// frame time at the top of the graph, and the one a
+	// 60 Hz display allows
+	const float g_GraphMilliseconds = 33.3f;
+	const float g_TargetMilliseconds = 16.7f;
+	// seconds between refreshes of the numbers
+	const double g_RefreshSeconds = 0.25;
+
+	// size of the text in pixels per font pixel, and the
+	// layout of the panel
+	const float g_TextScale = 2.0f;
+	const float g_LineHeight = 10.0f * g_TextScale;
+	const float g_Margin = 8.0f;
+	const float g_GraphWidth = 300.0f;
+	const float g_GraphHeight = 60.0f;
+
+	const glm::vec4 g_PanelColor(0.0f, 0.0f, 0.0f, 0.6f);
+	const glm::vec4 g_TextColor(1.0f, 1.0f, 1.0f, 1.0f);
+	const glm::vec4 g_GraphColor(0.15f, 0.15f, 0.15f, 0.8f);
+	const glm::vec4 g_FastColor(0.2f, 0.85f, 0.3f, 1.0f);
+	const glm::vec4 g_SlowColor(0.95f, 0.8f, 0.2f, 1.0f);
+	const glm::vec4 g_TooSlowColor(0.95f, 0.25f, 0.2f, 1.0f);
+
+	/***********************************************************
+	 *  GetProcessMemoryBytes()
+	 *
+	 *  This function is used for getting the resident memory
+	 *  of the process, or zero where it is not known.
+	 ***********************************************************/
+	size_t GetProcessMemoryBytes()
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		{
+			return(counters.WorkingSetSize);
+		}
+		return(0);
+#elif defined(__APPLE__)
+		mach_task_basic_info_data_t info;
+		mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+		if (KERN_SUCCESS == task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count))
+		{
+			return(info.resident_size);
+		}
+		return(0);
+#else
+		std::ifstream statm("/proc/self/statm");
+		size_t totalPages = 0;
+		size_t residentPages = 0;
+		if (statm >> totalPages >> residentPages)
+		{
+			return(residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+		}
+		return(0);
+#endif
+	}
+}
+
+/***********************************************************
+ *  PerformanceHUD()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+PerformanceHUD::PerformanceHUD(RenderBackend* pBackend)
+{
+	m_pBackend = pBackend;
+	m_program = 0;
+	m_atlasTexture = 0;
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+	m_layout = 0;
+	m_bVisible = false;
+	m_frameTimes.assign(g_GraphFrames, 0.0f);
+	m_nextFrameTime = 0;
+	m_bFrameStarted = false;
+	m_lastRefresh = std::chrono::steady_clock::now();
+	m_frameTimeSum = 0.0;
+	m_frameSamples = 0;
+	m_bZoneOpen = false;
+	m_openZone = 0;
+	m_drawCalls = 0;
+	m_triangles = 0;
+	m_gpuBytes = 0;
+}
+
+/***********************************************************
+ *  ~PerformanceHUD()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+PerformanceHUD::~PerformanceHUD()
+{
+	if (0 != m_layout)
+	{
+		m_pBackend->DestroyVertexLayout(m_layout);
+		m_layout = 0;
+	}
+	if (0 != m_vertexBuffer)
+	{
+		m_pBackend->DestroyBuffer(m_vertexBuffer);
+		m_vertexBuffer = 0;
+	}
+	if (0 != m_indexBuffer)
+	{
+		m_pBackend->DestroyBuffer(m_indexBuffer);
+		m_indexBuffer = 0;
+	}
+	if (0 != m_atlasTexture)
+	{
+		m_pBackend->DestroyTexture(m_atlasTexture);
+		m_atlasTexture = 0;
+	}
+	m_pBackend = NULL;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for building the font atlas and
+ *  making the overlay's program, texture and buffers.  The
+ *  index buffer never changes, since every quad is two
+ *  triangles over its own four vertices.
+ ***********************************************************/
+bool PerformanceHUD::Create(const char* vertexFilename, const char* fragmentFilename)
+{
+	m_program = m_pBackend->CreateProgram(vertexFilename, fragmentFilename);
+	if (0 == m_program)
+	{
+		std::cout << "Could not load the performance overlay shaders" << std::endl;
+		return(false);
+	}
+
+	m_font.Build();
+	m_atlasTexture = m_pBackend->CreateTexture(
+		m_font.GetAtlasWidth(), m_font.GetAtlasHeight(), 4, m_font.GetAtlasPixels().data());
+
+	std::vector<uint32_t> indices(g_MaxQuads * 6);
+	for (uint32_t quad = 0; quad < g_MaxQuads; quad++)
+	{
+		uint32_t vertex = quad * 4;
+		indices[quad * 6 + 0] = vertex + 0;
+		indices[quad * 6 + 1] = vertex + 1;
+		indices[quad * 6 + 2] = vertex + 2;
+		indices[quad * 6 + 3] = vertex + 0;
+		indices[quad * 6 + 4] = vertex + 2;
+		indices[quad * 6 + 5] = vertex + 3;
+	}
+	m_indexBuffer = m_pBackend->CreateBuffer(BUFFER_INDEX, indices.size() * sizeof(uint32_t), indices.data());
+	m_vertexBuffer = m_pBackend->CreateBuffer(BUFFER_VERTEX, g_MaxQuads * 4 * sizeof(HUD_VERTEX), NULL);
+
+	VERTEX_ATTRIBUTE attributes[3];
+	attributes[0].location = 0;
+	attributes[0].buffer = m_vertexBuffer;
+	attributes[0].components = 2;
+	attributes[0].stride = sizeof(HUD_VERTEX);
+	attributes[0].offset = offsetof(HUD_VERTEX, position);
+	attributes[1] = attributes[0];
+	attributes[1].location = 1;
+	attributes[1].offset = offsetof(HUD_VERTEX, uv);
+	attributes[2] = attributes[0];
+	attributes[2].location = 2;
+	attributes[2].components = 4;
+	attributes[2].offset = offsetof(HUD_VERTEX, color);
+	m_layout = m_pBackend->CreateVertexLayout(attributes, 3, m_indexBuffer);
+
+	m_vertices.reserve(g_MaxQuads * 4);
+	return(true);
+}
+
+/***********************************************************
+ *  SetVisible()
+ *
+ *  This method is used for showing or hiding the overlay.
+ ***********************************************************/
+void PerformanceHUD::SetVisible(bool bVisible)
+{
+	m_bVisible = bVisible;
+}
+
+/***********************************************************
+ *  IsVisible()
+ *
+ *  This method is used for checking whether the overlay is
+ *  shown.
+ ***********************************************************/
+bool PerformanceHUD::IsVisible() const
+{
+	return(m_bVisible);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for ending the last frame's timing
+ *  and starting this one's.  The frame time goes into the
+ *  graph, and when enough time has passed the averages
+ *  shown are refreshed.
+ ***********************************************************/
+void PerformanceHUD::BeginFrame()
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (m_bFrameStarted)
+	{
+		double milliseconds = std::chrono::duration<double, std::milli>(now - m_frameStart).count();
+		m_frameTimes[m_nextFrameTime] = static_cast<float>(milliseconds);
+		m_nextFrameTime = (m_nextFrameTime + 1) % m_frameTimes.size();
+		m_frameTimeSum += milliseconds;
+		m_frameSamples++;
+	}
+	m_bFrameStarted = true;
+	m_frameStart = now;
+
+	if (std::chrono::duration<double>(now - m_lastRefresh).count() >= g_RefreshSeconds)
+	{
+		m_lastRefresh = now;
+		RefreshText();
+	}
+}
+
+/***********************************************************
+ *  FindZone()
+ *
+ *  This method is used for finding a zone by name, adding
+ *  it the first time it is seen.
+ ***********************************************************/
+size_t PerformanceHUD::FindZone(const std::string& name, bool bGPU)
+{
+	for (size_t i = 0; i < m_zones.size(); i++)
+	{
+		if ((m_zones[i].bGPU == bGPU) && (m_zones[i].name == name))
+		{
+			return(i);
+		}
+	}
+
+	HUD_ZONE zone;
+	zone.name = name;
+	zone.bGPU = bGPU;
+	zone.sumMilliseconds = 0.0;
+	zone.samples = 0;
+	zone.shownMilliseconds = 0.0;
+	m_zones.push_back(zone);
+	return(m_zones.size() - 1);
+}
+
+/***********************************************************
+ *  AddZoneTime()
+ *
+ *  This method is used for adding a time to the average
+ *  of a zone.
+ ***********************************************************/
+void PerformanceHUD::AddZoneTime(size_t zone, double milliseconds)
+{
+	m_zones[zone].sumMilliseconds += milliseconds;
+	m_zones[zone].samples++;
+}
+
+/***********************************************************
+ *  BeginZone()
+ *
+ *  This method is used for starting to time a CPU zone.
+ ***********************************************************/
+void PerformanceHUD::BeginZone(const std::string& name)
+{
+	m_openZone = FindZone(name, false);
+	m_bZoneOpen = true;
+	m_zoneStart = std::chrono::steady_clock::now();
+}
+
+/***********************************************************
+ *  EndZone()
+ *
+ *  This method is used for ending the CPU zone being timed.
+ ***********************************************************/
+void PerformanceHUD::EndZone()
+{
+	if (!m_bZoneOpen)
+	{
+		return;
+	}
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	AddZoneTime(m_openZone, std::chrono::duration<double, std::milli>(now - m_zoneStart).count());
+	m_bZoneOpen = false;
+}
+
+/***********************************************************
+ *  SetGPUZone()
+ *
+ *  This method is used for passing in the GPU time of a
+ *  zone, one sample per frame.
+ ***********************************************************/
+void PerformanceHUD::SetGPUZone(const std::string& name, double milliseconds)
+{
+	AddZoneTime(FindZone(name, true), milliseconds);
+}
+
+/***********************************************************
+ *  SetFrameCounts()
+ *
+ *  This method is used for passing in what the frame drew
+ *  and the GPU memory in use.
+ ***********************************************************/
+void PerformanceHUD::SetFrameCounts(size_t drawCalls, size_t triangles, size_t gpuBytes)
+{
+	m_drawCalls = drawCalls;
+	m_triangles = triangles;
+	m_gpuBytes = gpuBytes;
+}
+
+/***********************************************************
+ *  RefreshText()
+ *
+ *  This method is used for turning the sums since the last
+ *  refresh into the averages shown, and formatting the
+ *  lines of the overlay.  The memory is only read here,
+ *  since asking the system for it is not free.
+ ***********************************************************/
+void PerformanceHUD::RefreshText()
+{
+	char line[64];
+	m_lines.clear();
+
+	double frameMilliseconds = (m_frameSamples > 0) ? (m_frameTimeSum / m_frameSamples) : 0.0;
+	double framesPerSecond = (frameMilliseconds > 0.0) ? (1000.0 / frameMilliseconds) : 0.0;
+	std::snprintf(line, sizeof(line), "FPS %6.1f  %7.2f MS", framesPerSecond, frameMilliseconds);
+	m_lines.push_back(line);
+	m_frameTimeSum = 0.0;
+	m_frameSamples = 0;
+
+	for (size_t i = 0; i < m_zones.size(); i++)
+	{
+		HUD_ZONE& zone = m_zones[i];
+		if (zone.samples > 0)
+		{
+			zone.shownMilliseconds = zone.sumMilliseconds / zone.samples;
+		}
+		zone.sumMilliseconds = 0.0;
+		zone.samples = 0;
+
+		std::snprintf(line, sizeof(line), "%s %-10.10s %7.3f MS",
+			zone.bGPU ? "GPU" : "CPU", zone.name.c_str(), zone.shownMilliseconds);
+		m_lines.push_back(line);
+	}
+
+	std::snprintf(line, sizeof(line), "DRAWS %-6u TRIS %u",
+		static_cast<unsigned int>(m_drawCalls), static_cast<unsigned int>(m_triangles));
+	m_lines.push_back(line);
+
+	double megabyte = 1024.0 * 1024.0;
+	std::snprintf(line, sizeof(line), "VRAM %6.1f MB RAM %6.1f MB",
+		m_gpuBytes / megabyte, GetProcessMemoryBytes() / megabyte);
+	m_lines.push_back(line);
+}
+
+/***********************************************************
+ *  AddQuad()
+ *
+ *  This method is used for adding a textured quad to the
+ *  batch, dropping it once the batch is full.
+ ***********************************************************/
+void PerformanceHUD::AddQuad(const glm::vec2& position0, const glm::vec2& position1,
+	const glm::vec2& uv0, const glm::vec2& uv1, const glm::vec4& color)
+{
+	if (m_vertices.size() + 4 > g_MaxQuads * 4)
+	{
+		return;
+	}
+
+	HUD_VERTEX vertex;
+	vertex.color = color;
+	vertex.position = position0;
+	vertex.uv = uv0;
+	m_vertices.push_back(vertex);
+	vertex.position = glm::vec2(position1.x, position0.y);
+	vertex.uv = glm::vec2(uv1.x, uv0.y);
+	m_vertices.push_back(vertex);
+	vertex.position = position1;
+	vertex.uv = uv1;
+	m_vertices.push_back(vertex);
+	vertex.position = glm::vec2(position0.x, position1.y);
+	vertex.uv = glm::vec2(uv0.x, uv1.y);
+	m_vertices.push_back(vertex);
+}
+
+/***********************************************************
+ *  AddRectangle()
+ *
+ *  This method is used for adding a plain rectangle, which
+ *  samples the solid cell of the atlas.
+ ***********************************************************/
+void PerformanceHUD::AddRectangle(const glm::vec2& position0, const glm::vec2& position1, const glm::vec4& color)
+{
+	glm::vec2 solid = m_font.GetSolidUV();
+	AddQuad(position0, position1, solid, solid, color);
+}
+
+/***********************************************************
+ *  AddText()
+ *
+ *  This method is used for adding a line of text whose
+ *  first character's top left is at the pen.  Spaces add
+ *  no quad.
+ ***********************************************************/
+void PerformanceHUD::AddText(const std::string& text, const glm::vec2& pen, float scale, const glm::vec4& color)
+{
+	glm::vec2 position = pen;
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		if (text[i] != ' ')
+		{
+			SDF_GLYPH_QUAD quad = m_font.GetGlyphQuad(text[i], position, scale);
+			AddQuad(quad.position0, quad.position1, quad.uv0, quad.uv1, color);
+		}
+		position.x += m_font.GetAdvance() * scale;
+	}
+}
+
+/***********************************************************
+ *  AddFrameGraph()
+ *
+ *  This method is used for adding a bar per recent frame,
+ *  oldest on the left, colored by whether it kept up with
+ *  60 Hz, with a line at that frame time.
+ ***********************************************************/
+void PerformanceHUD::AddFrameGraph(const glm::vec2& origin, const glm::vec2& size)
+{
+	AddRectangle(origin, origin + size, g_GraphColor);
+
+	float barWidth = size.x / m_frameTimes.size();
+	for (size_t i = 0; i < m_frameTimes.size(); i++)
+	{
+		float milliseconds = m_frameTimes[(m_nextFrameTime + i) % m_frameTimes.size()];
+		if (milliseconds <= 0.0f)
+		{
+			continue;
+		}
+
+		glm::vec4 color = g_FastColor;
+		if (milliseconds > g_GraphMilliseconds)
+		{
+			color = g_TooSlowColor;
+		}
+		else if (milliseconds > g_TargetMilliseconds)
+		{
+			color = g_SlowColor;
+		}
+
+		float height = size.y * std::min(milliseconds / g_GraphMilliseconds, 1.0f);
+		float left = origin.x + i * barWidth;
+		AddRectangle(glm::vec2(left, origin.y + size.y - height), glm::vec2(left + barWidth, origin.y + size.y), color);
+	}
+
+	float targetY = origin.y + size.y * (1.0f - g_TargetMilliseconds / g_GraphMilliseconds);
+	AddRectangle(glm::vec2(origin.x, targetY), glm::vec2(origin.x + size.x, targetY + 1.0f), g_TextColor);
+}
+
+/***********************************************************
+ *  Render()
+ *
+ *  This method is used for building the overlay's quads and
+ *  drawing them with one buffer update and one draw call.
+ ***********************************************************/
+void PerformanceHUD::Render(int width, int height)
+{
+	if (!m_bVisible || (0 == m_layout))
+	{
+		return;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// the panel fits the longest line and the graph
+	size_t lineCount = m_lines.size();
+	size_t longestLine = 0;
+	for (size_t i = 0; i < lineCount; i++)
+	{
+		longestLine = std::max(longestLine, m_lines[i].size());
+	}
+	float contentWidth = std::max(g_GraphWidth, longestLine * m_font.GetAdvance() * g_TextScale);
+	glm::vec2 panelSize(contentWidth + 2.0f * g_Margin, g_Margin * 3.0f + g_GraphHeight + lineCount * g_LineHeight);
+	glm::vec2 pen(g_Margin * 2.0f, g_Margin * 2.0f);
+
+	m_vertices.clear();
+	AddRectangle(glm::vec2(g_Margin), glm::vec2(g_Margin) + panelSize, g_PanelColor);
+	for (size_t i = 0; i < lineCount; i++)
+	{
+		AddText(m_lines[i], pen, g_TextScale, g_TextColor);
+		pen.y += g_LineHeight;
+		// the graph goes under the frame rate
+		if (0 == i)
+		{
+			AddFrameGraph(pen, glm::vec2(contentWidth, g_GraphHeight));
+			pen.y += g_GraphHeight + g_Margin;
+		}
+	}
+
+	size_t quadCount = m_vertices.size() / 4;
+	m_pBackend->UpdateBuffer(m_vertexBuffer, 0, m_vertices.size() * sizeof(HUD_VERTEX), m_vertices.data());
+
+	PIPELINE_STATE state;
+	state.bDepthTest = false;
+	state.blendMode = BLEND_ALPHA;
+	m_pBackend->SetPipelineState(state);
+	m_pBackend->UseProgram(m_program);
+	m_pBackend->SetUniformVec2("screenSize", glm::vec2(static_cast<float>(width), static_cast<float>(height)));
+	m_pBackend->SetUniformSampler("fontAtlas", g_AtlasSlot);
+	m_pBackend->BindTexture(g_AtlasSlot, m_atlasTexture);
+	m_pBackend->DrawIndexed(m_layout, static_cast<uint32_t>(quadCount * 6), 0, 0);
+
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	AddZoneTime(FindZone("hud", false), std::chrono::duration<double, std::milli>(end - start).count());
+}
@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+// performancehud.h
+// ============
+// on-screen overlay of the frame rate, zone times and draw counts
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+#include "SDFFont.h"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  PerformanceHUD
+ *
+ *  This class draws an overlay with the frame rate, a graph
+ *  of the recent frame times, the CPU and GPU time of named
+ *  zones of the frame, the draw calls and triangles, and
+ *  the memory in use.  The whole overlay is one batch: its
+ *  text and rectangles are quads written into one vertex
+ *  buffer each frame and drawn with a single call, sampling
+ *  a signed distance field font atlas so the text is sharp
+ *  at any scale.  The numbers are averaged and the text
+ *  refreshed a few times a second, so they can be read.
+ *  The overlay times itself as the "hud" CPU zone.
+ ***********************************************************/
+class PerformanceHUD
+{
+public:
+	// constructor
+	PerformanceHUD(RenderBackend* pBackend);
+	// destructor
+	~PerformanceHUD();
+
+	// build the font atlas and make the program, texture
+	// and buffers of the overlay
+	bool Create(const char* vertexFilename, const char* fragmentFilename);
+
+	// whether Render() draws anything
+	void SetVisible(bool bVisible);
+	bool IsVisible() const;
+
+	// start a frame - the time since the last call is the
+	// frame time
+	void BeginFrame();
+	// time a CPU zone of the frame between the calls, which
+	// may not nest
+	void BeginZone(const std::string& name);
+	void EndZone();
+	// time of a GPU zone, measured elsewhere
+	void SetGPUZone(const std::string& name, double milliseconds);
+	// what the frame drew, and the GPU memory of its buffers
+	// and textures
+	void SetFrameCounts(size_t drawCalls, size_t triangles, size_t gpuBytes);
+
+	// draw the overlay over a frame of the passed size, with
+	// depth testing off - the caller sets its own program and
+	// state again afterwards
+	void Render(int width, int height);
+
+private:
+	// vertex of the overlay's quads, in pixels from the top
+	// left of the frame
+	struct HUD_VERTEX
+	{
+		glm::vec2 position;
+		glm::vec2 uv;
+		glm::vec4 color;
+	};
+
+	// a timed zone, with the times since the last refresh
+	struct HUD_ZONE
+	{
+		std::string name;
+		bool bGPU;
+		double sumMilliseconds;
+		size_t samples;
+		double shownMilliseconds;
+	};
+
+	RenderBackend* m_pBackend;
+	SDFFont m_font;
+	uint32_t m_program;
+	uint32_t m_atlasTexture;
+	uint32_t m_vertexBuffer;
+	uint32_t m_indexBuffer;
+	uint32_t m_layout;
+	bool m_bVisible;
+	// quads of the frame being built
+	std::vector<HUD_VERTEX> m_vertices;
+
+	// recent frame times, a ring starting at m_nextFrameTime
+	std::vector<float> m_frameTimes;
+	size_t m_nextFrameTime;
+	bool m_bFrameStarted;
+	std::chrono::steady_clock::time_point m_frameStart;
+
+	// sums since the numbers were last refreshed
+	std::chrono::steady_clock::time_point m_lastRefresh;
+	double m_frameTimeSum;
+	size_t m_frameSamples;
+	std::vector<HUD_ZONE> m_zones;
+	// the CPU zone being timed
+	bool m_bZoneOpen;
+	size_t m_openZone;
+	std::chrono::steady_clock::time_point m_zoneStart;
+	size_t m_drawCalls;
+	size_t m_triangles;
+	size_t m_gpuBytes;
+	// text shown until the next refresh
+	std::vector<std::string> m_lines;
+
+	size_t FindZone(const std::string& name, bool bGPU);
+	void AddZoneTime(size_t zone, double milliseconds);
+	void RefreshText();
+
+	// add quads to the batch
+	void AddQuad(const glm::vec2& position0, const glm::vec2& position1,
+		const glm::vec2& uv0, const glm::vec2& uv1, const glm::vec4& color);
+	void AddRectangle(const glm::vec2& position0, const glm::vec2& position1, const glm::vec4& color);
+	void AddText(const std::string& text, const glm::vec2& pen, float scale, const glm::vec4& color);
+	void AddFrameGraph(const glm::vec2& origin, const glm::vec2& size);
+};
@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+// postprocesschain.cpp
+// ============
+// full screen passes run on the scene before it reaches the frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PostProcessChain.h"
+
+#include <iostream>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// inputs a pass may have, and the texture unit of the
+	// first, above the ones the scene's textures take and
+	// below those of the debug views and the overlay
+	const size_t g_MaxInputs = 4;
+	const int g_FirstInputSlot = 10;
+	const char* const g_InputSamplers[g_MaxInputs] = { "input0", "input1", "input2", "input3" };
+}
+
+/***********************************************************
+ *  PostProcessChain()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+PostProcessChain::PostProcessChain(RenderBackend* pBackend)
+{
+	m_pBackend = pBackend;
+	m_triangleBuffer = 0;
+	m_triangleIndexBuffer = 0;
+	m_triangleLayout = 0;
+}
+
+/***********************************************************
+ *  ~PostProcessChain()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+PostProcessChain::~PostProcessChain()
+{
+	if (0 != m_triangleLayout)
+	{
+		m_pBackend->DestroyVertexLayout(m_triangleLayout);
+		m_triangleLayout = 0;
+	}
+	if (0 != m_triangleBuffer)
+	{
+		m_pBackend->DestroyBuffer(m_triangleBuffer);
+		m_triangleBuffer = 0;
+	}
+	if (0 != m_triangleIndexBuffer)
+	{
+		m_pBackend->DestroyBuffer(m_triangleIndexBuffer);
+		m_triangleIndexBuffer = 0;
+	}
+	m_pBackend = NULL;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for making the triangle that covers
+ *  the frame, which every pass draws.
+ ***********************************************************/
+bool PostProcessChain::Create()
+{
+	const float corners[6] = { -1.0f, -1.0f, 3.0f, -1.0f, -1.0f, 3.0f };
+	const uint32_t indices[3] = { 0, 1, 2 };
+	m_triangleBuffer = m_pBackend->CreateBuffer(BUFFER_VERTEX, sizeof(corners), corners);
+	m_triangleIndexBuffer = m_pBackend->CreateBuffer(BUFFER_INDEX, sizeof(indices), indices);
+
+	VERTEX_ATTRIBUTE attribute;
+	attribute.location = 0;
+	attribute.buffer = m_triangleBuffer;
+	attribute.components = 2;
+	attribute.stride = 2 * sizeof(float);
+	attribute.offset = 0;
+	m_triangleLayout = m_pBackend->CreateVertexLayout(&attribute, 1, m_triangleIndexBuffer);
+	return(0 != m_triangleLayout);
+}
+
+/***********************************************************
+ *  AddPass()
+ *
+ *  This method is used for adding a pass at the end of the
+ *  chain.
+ ***********************************************************/
+void PostProcessChain::AddPass(const POST_PROCESS_PASS& pass)
+{
+	m_passes.push_back(pass);
+}
+
+/***********************************************************
+ *  ClearPasses()
+ *
+ *  This method is used for dropping the passes, to add
+ *  another set.  Graphs they were added to must be reset.
+ ***********************************************************/
+void PostProcessChain::ClearPasses()
+{
+	m_passes.clear();
+}
+
+/***********************************************************
+ *  GetPassCount()
+ *
+ *  This method is used for getting the number of passes.
+ ***********************************************************/
+size_t PostProcessChain::GetPassCount() const
+{
+	return(m_passes.size());
+}
+
+/***********************************************************
+ *  AddToGraph()
+ *
+ *  This method is used for declaring the passes in a frame
+ *  graph.  Passes with no program or too many inputs are
+ *  left out, so the graph culls whatever depends on them.
+ ***********************************************************/
+void PostProcessChain::AddToGraph(FrameGraph* pGraph)
+{
+	for (size_t i = 0; i < m_passes.size(); i++)
+	{
+		const POST_PROCESS_PASS& pass = m_passes[i];
+		if ((0 == pass.program) || (pass.inputs.size() > g_MaxInputs))
+		{
+			std::cout << "Post-process pass " << pass.name << " has no program or too many inputs" << std::endl;
+			continue;
+		}
+		if (!pass.output.empty() && (pass.width > 0))
+		{
+			pGraph->DeclareFixedTarget(pass.output, pass.format, pass.width, pass.height);
+		}
+		else if (!pass.output.empty())
+		{
+			pGraph->DeclareTarget(pass.output, pass.format, pass.scale, false, 1);
+		}
+
+		FRAME_GRAPH_PASS graphPass;
+		graphPass.name = pass.name;
+		graphPass.reads = pass.inputs;
+		graphPass.write = pass.output;
+		graphPass.execute = [this, i](FrameGraph& graph)
+		{
+			RunPass(m_passes[i], graph);
+		};
+		pGraph->AddPass(graphPass);
+	}
+}
+
+/***********************************************************
+ *  RunPass()
+ *
+ *  This method is used for drawing the triangle with the
+ *  pass's program and inputs into the target the graph has
+ *  bound.
+ ***********************************************************/
+void PostProcessChain::RunPass(const POST_PROCESS_PASS& pass, const FrameGraph& graph)
+{
+	PIPELINE_STATE state;
+	state.bDepthTest = false;
+	state.blendMode = BLEND_NONE;
+	m_pBackend->SetPipelineState(state);
+
+	m_pBackend->UseProgram(pass.program);
+	for (size_t k = 0; k < pass.inputs.size(); k++)
+	{
+		int slot = g_FirstInputSlot + static_cast<int>(k);
+		m_pBackend->BindTexture(slot, graph.GetTexture(pass.inputs[k]));
+		m_pBackend->SetUniformSampler(g_InputSamplers[k], slot);
+	}
+	if (pass.setUniforms)
+	{
+		pass.setUniforms(m_pBackend);
+	}
+	m_pBackend->DrawIndexed(m_triangleLayout, 3, 0, 0);
+}
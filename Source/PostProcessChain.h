@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+// postprocesschain.h
+// ============
+// full screen passes run on the scene before it reaches the frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameGraph.h"
+#include "RenderBackend.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  POST_PROCESS_PASS
+ *
+ *  One full screen pass of the chain.  Its inputs are the
+ *  outputs of earlier passes, or "scene" for the scene's
+ *  color, bound to the samplers "input0", "input1" and so
+ *  on in order.  A pass with no output draws into the frame.
+ ***********************************************************/
+struct POST_PROCESS_PASS
+{
+	std::string name;
+	uint32_t program;
+	std::vector<std::string> inputs;
+	std::string output;
+	// format of the output and its size against the frame,
+	// or in pixels when the width is not zero
+	RENDER_TARGET_FORMAT format;
+	float scale;
+	int width;
+	int height;
+	// sets the pass's own uniforms once its program is in
+	// use - may be empty
+	std::function<void(RenderBackend*)> setUniforms;
+};
+
+/***********************************************************
+ *  PostProcessChain
+ *
+ *  This class holds the full screen passes run over the
+ *  scene and adds them to a frame graph, each output as a
+ *  transient target and each pass as one drawing the
+ *  triangle that covers the frame with its inputs bound.
+ *  The graph orders them, culls those whose outputs nobody
+ *  reads and lets outputs that are never alive together
+ *  share a target, so the memory stays flat as passes are
+ *  added.  The caller's scene pass writes "scene".
+ ***********************************************************/
+class PostProcessChain
+{
+public:
+	// constructor
+	PostProcessChain(RenderBackend* pBackend);
+	// destructor
+	~PostProcessChain();
+
+	// make the triangle the passes draw
+	bool Create();
+
+	// add a pass after the others, or drop them all
+	void AddPass(const POST_PROCESS_PASS& pass);
+	void ClearPasses();
+	size_t GetPassCount() const;
+
+	// declare the outputs and passes in a frame graph, which
+	// must not outlive the chain
+	void AddToGraph(FrameGraph* pGraph);
+
+private:
+	RenderBackend* m_pBackend;
+	std::vector<POST_PROCESS_PASS> m_passes;
+	// one triangle covering the frame
+	uint32_t m_triangleBuffer;
+	uint32_t m_triangleIndexBuffer;
+	uint32_t m_triangleLayout;
+
+	// draw a pass with its inputs from the graph
+	void RunPass(const POST_PROCESS_PASS& pass, const FrameGraph& graph);
+};
@@ -0,0 +1,792 @@
+///////////////////////////////////////////////////////////////////////////////
+// proceduralmeshes.cpp
+// ============
+// generate the basic scene shapes at several levels of detail
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ProceduralMeshes.h"
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of the global variables and helpers
+namespace
+{
+	const float g_Pi = 3.14159265358979f;
+
+	// segments around the axis of the curved shapes, per level
+	const int g_RadialSegments[SHAPE_MAX_LODS] = { 256, 64, 24, 12 };
+	// segments from pole to pole of the spheres, per level
+	const int g_RingSegments[SHAPE_MAX_LODS] = { 128, 32, 12, 6 };
+	// segments around the tube of the torus, per level
+	const int g_TubeSegments[SHAPE_MAX_LODS] = { 64, 16, 8, 6 };
+	// thickness of the torus tube, as in ShapeMeshes
+	const float g_TorusTubeRadius = 0.1f;
+
+	// triangles or vertices handled by one parallel batch
+	const size_t g_BatchSize = 8192;
+
+	/***********************************************************
+	 *  PROFILE_POINT
+	 *
+	 *  One point of the outline that is swept around the Y
+	 *  axis to build a curved shape.
+	 ***********************************************************/
+	struct PROFILE_POINT
+	{
+		float radius;
+		float height;
+		float v;
+	};
+
+	/***********************************************************
+	 *  AppendLathe()
+	 *
+	 *  Sweep the profile around the Y axis.  The seam column
+	 *  is duplicated so the texture wraps once, and the seam,
+	 *  the poles and the ends of a closed profile share one
+	 *  normal group.  The profile must run so the surface on
+	 *  its left faces outwards when seen from above.
+	 ***********************************************************/
+	void AppendLathe(
+		MESH_DATA& mesh,
+		std::vector<uint32_t>& normalGroups,
+		const std::vector<PROFILE_POINT>& profile,
+		int segments,
+		bool bClosedProfile,
+		bool bPlanarUV)
+	{
+		uint32_t base = static_cast<uint32_t>(mesh.vertices.size());
+		uint32_t columns = static_cast<uint32_t>(segments + 1);
+		uint32_t rows = static_cast<uint32_t>(profile.size());
+
+		std::vector<float> sines(columns);
+		std::vector<float> cosines(columns);
+		for (uint32_t j = 0; j < columns; j++)
+		{
+			float angle = 2.0f * g_Pi * (j % segments) / segments;
+			sines[j] = std::sin(angle);
+			cosines[j] = std::cos(angle);
+		}
+
+		// planar texture mapping across the widest ring
+		float planarRadius = 0.0f;
+		for (uint32_t i = 0; i < rows; i++)
+		{
+			planarRadius = std::max(planarRadius, profile[i].radius);
+		}
+
+		for (uint32_t i = 0; i < rows; i++)
+		{
+			const PROFILE_POINT& point = profile[i];
+			uint32_t groupRow = (bClosedProfile && i == rows - 1) ? 0 : i;
+			for (uint32_t j = 0; j < columns; j++)
+			{
+				MESH_VERTEX vertex;
+				vertex.position = glm::vec3(point.radius * sines[j], point.height, point.radius * cosines[j]);
+				vertex.normal = glm::vec3(0.0f);
+				if (bPlanarUV)
+				{
+					vertex.texCoord = glm::vec2(
+						0.5f + 0.5f * vertex.position.x / planarRadius,
+						0.5f - 0.5f * vertex.position.z / planarRadius);
+				}
+				else
+				{
+					vertex.texCoord = glm::vec2(static_cast<float>(j) / segments, point.v);
+				}
+				mesh.vertices.push_back(vertex);
+
+				uint32_t groupColumn = (point.radius == 0.0f || j == columns - 1) ? 0 : j;
+				normalGroups.push_back(base + groupRow * columns + groupColumn);
+			}
+		}
+
+		for (uint32_t i = 0; i + 1 < rows; i++)
+		{
+			for (uint32_t j = 0; j < columns - 1; j++)
+			{
+				uint32_t a = base + i * columns + j;
+				uint32_t b = a + 1;
+				uint32_t c = a + columns;
+				uint32_t d = c + 1;
+				// skip the triangles that collapse at a pole
+				if (profile[i].radius != 0.0f)
+				{
+					mesh.indices.push_back(a);
+					mesh.indices.push_back(b);
+					mesh.indices.push_back(d);
+				}
+				if (profile[i + 1].radius != 0.0f)
+				{
+					mesh.indices.push_back(a);
+					mesh.indices.push_back(d);
+					mesh.indices.push_back(c);
+				}
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  AppendDisc()
+	 *
+	 *  Flat cap at the passed height, facing up or down.
+	 ***********************************************************/
+	void AppendDisc(
+		MESH_DATA& mesh,
+		std::vector<uint32_t>& normalGroups,
+		float radius,
+		float height,
+		bool bFacingUp,
+		int segments)
+	{
+		std::vector<PROFILE_POINT> profile(2);
+		PROFILE_POINT center = { 0.0f, height, 0.0f };
+		PROFILE_POINT rim = { radius, height, 1.0f };
+		profile[0] = bFacingUp ? rim : center;
+		profile[1] = bFacingUp ? center : rim;
+		AppendLathe(mesh, normalGroups, profile, segments, false, true);
+	}
+
+	/***********************************************************
+	 *  AppendPolygon()
+	 *
+	 *  Flat triangle or quad with its corners in counter
+	 *  clockwise order when seen from the front.
+	 ***********************************************************/
+	void AppendPolygon(
+		MESH_DATA& mesh,
+		std::vector<uint32_t>& normalGroups,
+		const glm::vec3* pCorners,
+		const glm::vec2* pTexCoords,
+		int cornerCount)
+	{
+		uint32_t base = static_cast<uint32_t>(mesh.vertices.size());
+		for (int i = 0; i < cornerCount; i++)
+		{
+			MESH_VERTEX vertex;
+			vertex.position = pCorners[i];
+			vertex.normal = glm::vec3(0.0f);
+			vertex.texCoord = pTexCoords[i];
+			mesh.vertices.push_back(vertex);
+			normalGroups.push_back(base + i);
+		}
+		for (int i = 1; i + 1 < cornerCount; i++)
+		{
+			mesh.indices.push_back(base);
+			mesh.indices.push_back(base + i);
+			mesh.indices.push_back(base + i + 1);
+		}
+	}
+
+	/***********************************************************
+	 *  AppendBoxFace()
+	 *
+	 *  One face of the unit box, spanned by two half-size
+	 *  axes whose cross product points outwards.
+	 ***********************************************************/
+	void AppendBoxFace(
+		MESH_DATA& mesh,
+		std::vector<uint32_t>& normalGroups,
+		glm::vec3 center,
+		glm::vec3 uAxis,
+		glm::vec3 vAxis)
+	{
+		glm::vec3 corners[4] = {
+			center - uAxis - vAxis,
+			center + uAxis - vAxis,
+			center + uAxis + vAxis,
+			center - uAxis + vAxis };
+		glm::vec2 texCoords[4] = {
+			glm::vec2(0.0f, 0.0f),
+			glm::vec2(1.0f, 0.0f),
+			glm::vec2(1.0f, 1.0f),
+			glm::vec2(0.0f, 1.0f) };
+		AppendPolygon(mesh, normalGroups, corners, texCoords, 4);
+	}
+
+	/***********************************************************
+	 *  BuildPlane(), BuildBox(), BuildPrism()
+	 *
+	 *  The flat shapes, which only have one detail level.
+	 ***********************************************************/
+	void BuildPlane(MESH_DATA& mesh, std::vector<uint32_t>& normalGroups)
+	{
+		AppendBoxFace(mesh, normalGroups, glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+	}
+
+	void BuildBox(MESH_DATA& mesh, std::vector<uint32_t>& normalGroups)
+	{
+		AppendBoxFace(mesh, normalGroups, glm::vec3(0.5f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -0.5f), glm::vec3(0.0f, 0.5f, 0.0f));
+		AppendBoxFace(mesh, normalGroups, glm::vec3(-0.5f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.5f), glm::vec3(0.0f, 0.5f, 0.0f));
+		AppendBoxFace(mesh, normalGroups, glm::vec3(0.0f, 0.5f, 0.0f), glm::vec3(0.5f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -0.5f));
+		AppendBoxFace(mesh, normalGroups, glm::vec3(0.0f, -0.5f, 0.0f), glm::vec3(0.5f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.5f));
+		AppendBoxFace(mesh, normalGroups, glm::vec3(0.0f, 0.0f, 0.5f), glm::vec3(0.5f, 0.0f, 0.0f), glm::vec3(0.0f, 0.5f, 0.0f));
+		AppendBoxFace(mesh, normalGroups, glm::vec3(0.0f, 0.0f, -0.5f), glm::vec3(-0.5f, 0.0f, 0.0f), glm::vec3(0.0f, 0.5f, 0.0f));
+	}
+
+	void BuildPrism(MESH_DATA& mesh, std::vector<uint32_t>& normalGroups)
+	{
+		// triangle in the XY plane, extruded along Z
+		glm::vec2 outline[3] = {
+			glm::vec2(-0.5f, -0.5f),
+			glm::vec2(0.5f, -0.5f),
+			glm::vec2(0.0f, 0.5f) };
+
+		glm::vec3 corners[4];
+		glm::vec2 texCoords[4];
+		for (int i = 0; i < 3; i++)
+		{
+			corners[i] = glm::vec3(outline[i], 0.5f);
+			texCoords[i] = outline[i] + glm::vec2(0.5f);
+		}
+		AppendPolygon(mesh, normalGroups, corners, texCoords, 3);
+		for (int i = 0; i < 3; i++)
+		{
+			corners[i] = glm::vec3(outline[2 - i], -0.5f);
+			texCoords[i] = glm::vec2(0.5f - outline[2 - i].x, outline[2 - i].y + 0.5f);
+		}
+		AppendPolygon(mesh, normalGroups, corners, texCoords, 3);
+
+		// one quad for each edge of the outline
+		for (int i = 0; i < 3; i++)
+		{
+			glm::vec2 from = outline[i];
+			glm::vec2 to = outline[(i + 1) % 3];
+			corners[0] = glm::vec3(from, -0.5f);
+			corners[1] = glm::vec3(to, -0.5f);
+			corners[2] = glm::vec3(to, 0.5f);
+			corners[3] = glm::vec3(from, 0.5f);
+			texCoords[0] = glm::vec2(0.0f, 0.0f);
+			texCoords[1] = glm::vec2(1.0f, 0.0f);
+			texCoords[2] = glm::vec2(1.0f, 1.0f);
+			texCoords[3] = glm::vec2(0.0f, 1.0f);
+			AppendPolygon(mesh, normalGroups, corners, texCoords, 4);
+		}
+	}
+
+	/***********************************************************
+	 *  BuildCylinder(), BuildSphere(), BuildHalfSphere(),
+	 *  BuildTorus()
+	 *
+	 *  The curved shapes, swept around the Y axis.
+	 ***********************************************************/
+	void BuildCylinder(MESH_DATA& mesh, std::vector<uint32_t>& normalGroups, int lod)
+	{
+		int segments = g_RadialSegments[lod];
+		std::vector<PROFILE_POINT> side(2);
+		side[0].radius = 1.0f;
+		side[0].height = 0.0f;
+		side[0].v = 0.0f;
+		side[1].radius = 1.0f;
+		side[1].height = 1.0f;
+		side[1].v = 1.0f;
+		AppendLathe(mesh, normalGroups, side, segments, false, false);
+		AppendDisc(mesh, normalGroups, 1.0f, 0.0f, false, segments);
+		AppendDisc(mesh, normalGroups, 1.0f, 1.0f, true, segments);
+	}
+
+	void BuildSphere(MESH_DATA& mesh, std::vector<uint32_t>& normalGroups, int lod, bool bHalf)
+	{
+		int rings = g_RingSegments[lod];
+		int firstRing = bHalf ? rings / 2 : 0;
+		std::vector<PROFILE_POINT> profile;
+		for (int i = firstRing; i <= rings; i++)
+		{
+			float angle = g_Pi * (static_cast<float>(i) / rings - 0.5f);
+			PROFILE_POINT point;
+			point.radius = (i == 0 || i == rings) ? 0.0f : std::cos(angle);
+			point.height = std::sin(angle);
+			point.v = static_cast<float>(i - firstRing) / (rings - firstRing);
+			profile.push_back(point);
+		}
+		AppendLathe(mesh, normalGroups, profile, g_RadialSegments[lod], false, false);
+		if (bHalf)
+		{
+			AppendDisc(mesh, normalGroups, 1.0f, 0.0f, false, g_RadialSegments[lod]);
+		}
+	}
+
+	void BuildTorus(MESH_DATA& mesh, std::vector<uint32_t>& normalGroups, int lod)
+	{
+		int tubeSegments = g_TubeSegments[lod];
+		std::vector<PROFILE_POINT> profile(tubeSegments + 1);
+		for (int i = 0; i <= tubeSegments; i++)
+		{
+			float angle = 2.0f * g_Pi * (i % tubeSegments) / tubeSegments;
+			profile[i].radius = 1.0f + g_TorusTubeRadius * std::cos(angle);
+			profile[i].height = g_TorusTubeRadius * std::sin(angle);
+			profile[i].v = static_cast<float>(i) / tubeSegments;
+		}
+		AppendLathe(mesh, normalGroups, profile, g_RadialSegments[lod], true, false);
+	}
+
+	/***********************************************************
+	 *  ReciprocalLength()
+	 *
+	 *  1 / sqrt(x) for four values, refined with one Newton
+	 *  step to near full float precision.
+	 ***********************************************************/
+	inline __m128 ReciprocalLength(__m128 lengthSquared)
+	{
+		__m128 estimate = _mm_rsqrt_ps(lengthSquared);
+		__m128 halfLength = _mm_mul_ps(_mm_set1_ps(0.5f), lengthSquared);
+		__m128 correction = _mm_sub_ps(
+			_mm_set1_ps(1.5f),
+			_mm_mul_ps(halfLength, _mm_mul_ps(estimate, estimate)));
+		return(_mm_mul_ps(estimate, correction));
+	}
+
+	/***********************************************************
+	 *  VECTOR4
+	 *
+	 *  Four 3D vectors in structure-of-arrays form.
+	 ***********************************************************/
+	struct VECTOR4
+	{
+		__m128 x;
+		__m128 y;
+		__m128 z;
+	};
+
+	inline VECTOR4 Subtract(const VECTOR4& a, const VECTOR4& b)
+	{
+		VECTOR4 result = { _mm_sub_ps(a.x, b.x), _mm_sub_ps(a.y, b.y), _mm_sub_ps(a.z, b.z) };
+		return(result);
+	}
+
+	inline VECTOR4 Cross(const VECTOR4& a, const VECTOR4& b)
+	{
+		VECTOR4 result = {
+			_mm_sub_ps(_mm_mul_ps(a.y, b.z), _mm_mul_ps(a.z, b.y)),
+			_mm_sub_ps(_mm_mul_ps(a.z, b.x), _mm_mul_ps(a.x, b.z)),
+			_mm_sub_ps(_mm_mul_ps(a.x, b.y), _mm_mul_ps(a.y, b.x)) };
+		return(result);
+	}
+
+	inline __m128 Dot(const VECTOR4& a, const VECTOR4& b)
+	{
+		return(_mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)),
+			_mm_mul_ps(a.z, b.z)));
+	}
+
+	// gather four vectors into structure-of-arrays form
+	inline VECTOR4 Gather(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d)
+	{
+		VECTOR4 result = {
+			_mm_setr_ps(a.x, b.x, c.x, d.x),
+			_mm_setr_ps(a.y, b.y, c.y, d.y),
+			_mm_setr_ps(a.z, b.z, c.z, d.z) };
+		return(result);
+	}
+
+	// write four vectors back from structure-of-arrays form
+	inline void Scatter(const VECTOR4& v, glm::vec3* pOut)
+	{
+		float x[4], y[4], z[4];
+		_mm_storeu_ps(x, v.x);
+		_mm_storeu_ps(y, v.y);
+		_mm_storeu_ps(z, v.z);
+		for (int i = 0; i < 4; i++)
+		{
+			pOut[i] = glm::vec3(x[i], y[i], z[i]);
+		}
+	}
+
+	/***********************************************************
+	 *  ComputeFaceNormals()
+	 *
+	 *  Unnormalized normal of each triangle, so larger faces
+	 *  weigh more in the vertex normals.  Four triangles are
+	 *  handled per step.
+	 ***********************************************************/
+	void ComputeFaceNormals(const MESH_DATA& mesh, size_t begin, size_t end, glm::vec3* pFaceNormals)
+	{
+		const uint32_t* pIndices = mesh.indices.data();
+		const MESH_VERTEX* pVertices = mesh.vertices.data();
+
+		size_t t = begin;
+		for (; t + 4 <= end; t += 4)
+		{
+			const uint32_t* p = pIndices + t * 3;
+			VECTOR4 a = Gather(pVertices[p[0]].position, pVertices[p[3]].position, pVertices[p[6]].position, pVertices[p[9]].position);
+			VECTOR4 b = Gather(pVertices[p[1]].position, pVertices[p[4]].position, pVertices[p[7]].position, pVertices[p[10]].position);
+			VECTOR4 c = Gather(pVertices[p[2]].position, pVertices[p[5]].position, pVertices[p[8]].position, pVertices[p[11]].position);
+			Scatter(Cross(Subtract(b, a), Subtract(c, a)), pFaceNormals + t);
+		}
+		for (; t < end; t++)
+		{
+			const uint32_t* p = pIndices + t * 3;
+			glm::vec3 a = pVertices[p[0]].position;
+			pFaceNormals[t] = glm::cross(pVertices[p[1]].position - a, pVertices[p[2]].position - a);
+		}
+	}
+
+	/***********************************************************
+	 *  NormalizeNormals()
+	 *
+	 *  Normalize the summed normals of the vertices in the
+	 *  passed range, four at a time.  Vertices without any
+	 *  area around them point up.
+	 ***********************************************************/
+	void NormalizeNormals(
+		MESH_DATA& mesh,
+		const std::vector<glm::vec3>& sums,
+		const std::vector<uint32_t>& normalGroups,
+		size_t begin,
+		size_t end)
+	{
+		__m128 tiny = _mm_set1_ps(1.0e-24f);
+		__m128 up = _mm_set1_ps(1.0f);
+
+		size_t v = begin;
+		for (; v < end; v += 4)
+		{
+			glm::vec3 gathered[4];
+			size_t count = std::min<size_t>(4, end - v);
+			for (size_t i = 0; i < 4; i++)
+			{
+				size_t vertex = v + std::min(i, count - 1);
+				gathered[i] = sums[normalGroups.empty() ? vertex : normalGroups[vertex]];
+			}
+			VECTOR4 n = Gather(gathered[0], gathered[1], gathered[2], gathered[3]);
+			__m128 lengthSquared = Dot(n, n);
+			__m128 degenerate = _mm_cmplt_ps(lengthSquared, tiny);
+			__m128 scale = ReciprocalLength(_mm_max_ps(lengthSquared, tiny));
+			n.x = _mm_andnot_ps(degenerate, _mm_mul_ps(n.x, scale));
+			n.y = _mm_or_ps(_mm_and_ps(degenerate, up), _mm_andnot_ps(degenerate, _mm_mul_ps(n.y, scale)));
+			n.z = _mm_andnot_ps(degenerate, _mm_mul_ps(n.z, scale));
+
+			Scatter(n, gathered);
+			for (size_t i = 0; i < count; i++)
+			{
+				mesh.vertices[v + i].normal = gathered[i];
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  ComputeFaceTangents()
+	 *
+	 *  Direction of increasing u and v across each triangle,
+	 *  weighted by the triangle area.  Four triangles are
+	 *  handled per step.
+	 ***********************************************************/
+	void ComputeFaceTangents(
+		const MESH_DATA& mesh,
+		size_t begin,
+		size_t end,
+		glm::vec3* pFaceTangents,
+		glm::vec3* pFaceBitangents)
+	{
+		const uint32_t* pIndices = mesh.indices.data();
+		const MESH_VERTEX* pVertices = mesh.vertices.data();
+		__m128 signBit = _mm_set1_ps(-0.0f);
+
+		size_t t = begin;
+		for (; t + 4 <= end; t += 4)
+		{
+			const uint32_t* p = pIndices + t * 3;
+			const MESH_VERTEX* a[4] = { &pVertices[p[0]], &pVertices[p[3]], &pVertices[p[6]], &pVertices[p[9]] };
+			const MESH_VERTEX* b[4] = { &pVertices[p[1]], &pVertices[p[4]], &pVertices[p[7]], &pVertices[p[10]] };
+			const MESH_VERTEX* c[4] = { &pVertices[p[2]], &pVertices[p[5]], &pVertices[p[8]], &pVertices[p[11]] };
+
+			VECTOR4 origin = Gather(a[0]->position, a[1]->position, a[2]->position, a[3]->position);
+			VECTOR4 edge1 = Subtract(Gather(b[0]->position, b[1]->position, b[2]->position, b[3]->position), origin);
+			VECTOR4 edge2 = Subtract(Gather(c[0]->position, c[1]->position, c[2]->position, c[3]->position), origin);
+
+			__m128 u0 = _mm_setr_ps(a[0]->texCoord.x, a[1]->texCoord.x, a[2]->texCoord.x, a[3]->texCoord.x);
+			__m128 v0 = _mm_setr_ps(a[0]->texCoord.y, a[1]->texCoord.y, a[2]->texCoord.y, a[3]->texCoord.y);
+			__m128 du1 = _mm_sub_ps(_mm_setr_ps(b[0]->texCoord.x, b[1]->texCoord.x, b[2]->texCoord.x, b[3]->texCoord.x), u0);
+			__m128 dv1 = _mm_sub_ps(_mm_setr_ps(b[0]->texCoord.y, b[1]->texCoord.y, b[2]->texCoord.y, b[3]->texCoord.y), v0);
+			__m128 du2 = _mm_sub_ps(_mm_setr_ps(c[0]->texCoord.x, c[1]->texCoord.x, c[2]->texCoord.x, c[3]->texCoord.x), u0);
+			__m128 dv2 = _mm_sub_ps(_mm_setr_ps(c[0]->texCoord.y, c[1]->texCoord.y, c[2]->texCoord.y, c[3]->texCoord.y), v0);
+
+			// flip by the sign of the texture space area instead
+			// of dividing by it, which keeps the area weighting
+			__m128 area = _mm_sub_ps(_mm_mul_ps(du1, dv2), _mm_mul_ps(du2, dv1));
+			__m128 sign = _mm_and_ps(area, signBit);
+			du1 = _mm_xor_ps(du1, sign);
+			dv1 = _mm_xor_ps(dv1, sign);
+			du2 = _mm_xor_ps(du2, sign);
+			dv2 = _mm_xor_ps(dv2, sign);
+
+			VECTOR4 tangent = {
+				_mm_sub_ps(_mm_mul_ps(edge1.x, dv2), _mm_mul_ps(edge2.x, dv1)),
+				_mm_sub_ps(_mm_mul_ps(edge1.y, dv2), _mm_mul_ps(edge2.y, dv1)),
+				_mm_sub_ps(_mm_mul_ps(edge1.z, dv2), _mm_mul_ps(edge2.z, dv1)) };
+			VECTOR4 bitangent = {
+				_mm_sub_ps(_mm_mul_ps(edge2.x, du1), _mm_mul_ps(edge1.x, du2)),
+				_mm_sub_ps(_mm_mul_ps(edge2.y, du1), _mm_mul_ps(edge1.y, du2)),
+				_mm_sub_ps(_mm_mul_ps(edge2.z, du1), _mm_mul_ps(edge1.z, du2)) };
+			Scatter(tangent, pFaceTangents + t);
+			Scatter(bitangent, pFaceBitangents + t);
+		}
+		for (; t < end; t++)
+		{
+			const uint32_t* p = pIndices + t * 3;
+			const MESH_VERTEX& a = pVertices[p[0]];
+			glm::vec3 edge1 = pVertices[p[1]].position - a.position;
+			glm::vec3 edge2 = pVertices[p[2]].position - a.position;
+			glm::vec2 delta1 = pVertices[p[1]].texCoord - a.texCoord;
+			glm::vec2 delta2 = pVertices[p[2]].texCoord - a.texCoord;
+			if (delta1.x * delta2.y - delta2.x * delta1.y < 0.0f)
+			{
+				delta1 = -delta1;
+				delta2 = -delta2;
+			}
+			pFaceTangents[t] = edge1 * delta2.y - edge2 * delta1.y;
+			pFaceBitangents[t] = edge2 * delta1.x - edge1 * delta2.x;
+		}
+	}
+
+	/***********************************************************
+	 *  OrthogonalizeTangents()
+	 *
+	 *  Make the summed tangents of the vertices in the passed
+	 *  range perpendicular to the normal and unit length, four
+	 *  at a time, and store the handedness in w.
+	 ***********************************************************/
+	void OrthogonalizeTangents(
+		MESH_DATA& mesh,
+		const std::vector<glm::vec3>& tangentSums,
+		const std::vector<glm::vec3>& bitangentSums,
+		size_t begin,
+		size_t end)
+	{
+		__m128 tiny = _mm_set1_ps(1.0e-24f);
+		__m128 zero = _mm_setzero_ps();
+
+		for (size_t v = begin; v < end; v += 4)
+		{
+			size_t count = std::min<size_t>(4, end - v);
+			size_t lane[4];
+			for (size_t i = 0; i < 4; i++)
+			{
+				lane[i] = v + std::min(i, count - 1);
+			}
+			VECTOR4 n = Gather(
+				mesh.vertices[lane[0]].normal, mesh.vertices[lane[1]].normal,
+				mesh.vertices[lane[2]].normal, mesh.vertices[lane[3]].normal);
+			VECTOR4 t = Gather(tangentSums[lane[0]], tangentSums[lane[1]], tangentSums[lane[2]], tangentSums[lane[3]]);
+			VECTOR4 b = Gather(bitangentSums[lane[0]], bitangentSums[lane[1]], bitangentSums[lane[2]], bitangentSums[lane[3]]);
+
+			// Gram-Schmidt against the normal
+			__m128 along = Dot(n, t);
+			t.x = _mm_sub_ps(t.x, _mm_mul_ps(n.x, along));
+			t.y = _mm_sub_ps(t.y, _mm_mul_ps(n.y, along));
+			t.z = _mm_sub_ps(t.z, _mm_mul_ps(n.z, along));
+			__m128 lengthSquared = Dot(t, t);
+			__m128 degenerate = _mm_cmplt_ps(lengthSquared, tiny);
+			__m128 scale = ReciprocalLength(_mm_max_ps(lengthSquared, tiny));
+			t.x = _mm_mul_ps(t.x, scale);
+			t.y = _mm_mul_ps(t.y, scale);
+			t.z = _mm_mul_ps(t.z, scale);
+
+			// negative when the texture is mirrored
+			__m128 handedness = _mm_cmplt_ps(Dot(Cross(n, t), b), zero);
+			int degenerateMask = _mm_movemask_ps(degenerate);
+			int mirroredMask = _mm_movemask_ps(handedness);
+
+			glm::vec3 tangents[4];
+			Scatter(t, tangents);
+			for (size_t i = 0; i < count; i++)
+			{
+				glm::vec3 tangent = tangents[i];
+				if (degenerateMask & (1 << i))
+				{
+					// no usable texture direction, so pick any
+					// direction perpendicular to the normal
+					glm::vec3 normal = mesh.vertices[v + i].normal;
+					glm::vec3 other = (std::fabs(normal.x) < 0.9f) ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+					tangent = glm::normalize(glm::cross(other, normal));
+				}
+				mesh.tangents[v + i] = glm::vec4(tangent, (mirroredMask & (1 << i)) ? -1.0f : 1.0f);
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  RunBatches()
+	 *
+	 *  Run the body over [0, count) on the pool, or on the
+	 *  calling thread when there is no pool.
+	 ***********************************************************/
+	void RunBatches(ThreadPool* pThreadPool, size_t count, const std::function<void(size_t, size_t)>& body)
+	{
+		if (NULL != pThreadPool)
+		{
+			pThreadPool->ParallelFor(count, g_BatchSize, body);
+		}
+		else if (count > 0)
+		{
+			body(0, count);
+		}
+	}
+}
+
+/***********************************************************
+ *  GetShapeLODCount()
+ *
+ *  This function is used for getting the number of detail
+ *  levels that are generated for the passed shape.
+ ***********************************************************/
+int GetShapeLODCount(SHAPE_TYPE shape)
+{
+	switch (shape)
+	{
+	case SHAPE_CYLINDER:
+	case SHAPE_SPHERE:
+	case SHAPE_HALF_SPHERE:
+	case SHAPE_TORUS:
+		return(SHAPE_MAX_LODS);
+	default:
+		return(1);
+	}
+}
+
+/***********************************************************
+ *  GenerateShapeMesh()
+ *
+ *  This function is used for building one detail level of
+ *  a basic shape.  The surface is built first, then the
+ *  normals and tangents are computed from the triangles.
+ *  It only touches the passed mesh, so different shapes
+ *  and levels can be generated on different threads.
+ ***********************************************************/
+void GenerateShapeMesh(SHAPE_TYPE shape, int lod, MESH_DATA& mesh, ThreadPool* pThreadPool)
+{
+	lod = std::max(0, std::min(lod, GetShapeLODCount(shape) - 1));
+	mesh.vertices.clear();
+	mesh.indices.clear();
+	mesh.tangents.clear();
+
+	std::vector<uint32_t> normalGroups;
+	switch (shape)
+	{
+	case SHAPE_PLANE:
+		BuildPlane(mesh, normalGroups);
+		break;
+	case SHAPE_BOX:
+		BuildBox(mesh, normalGroups);
+		break;
+	case SHAPE_CYLINDER:
+		BuildCylinder(mesh, normalGroups, lod);
+		break;
+	case SHAPE_PRISM:
+		BuildPrism(mesh, normalGroups);
+		break;
+	case SHAPE_SPHERE:
+		BuildSphere(mesh, normalGroups, lod, false);
+		break;
+	case SHAPE_HALF_SPHERE:
+		BuildSphere(mesh, normalGroups, lod, true);
+		break;
+	case SHAPE_TORUS:
+		BuildTorus(mesh, normalGroups, lod);
+		break;
+	default:
+		return;
+	}
+
+	ComputeMeshNormals(mesh, normalGroups, pThreadPool);
+	ComputeMeshTangents(mesh, pThreadPool);
+
+	// the torus is swept around Y but lies in the XY plane
+	if (shape == SHAPE_TORUS)
+	{
+		for (size_t i = 0; i < mesh.vertices.size(); i++)
+		{
+			glm::vec3& position = mesh.vertices[i].position;
+			glm::vec3& normal = mesh.vertices[i].normal;
+			glm::vec4& tangent = mesh.tangents[i];
+			position = glm::vec3(position.x, -position.z, position.y);
+			normal = glm::vec3(normal.x, -normal.z, normal.y);
+			tangent = glm::vec4(tangent.x, -tangent.z, tangent.y, tangent.w);
+		}
+	}
+
+	mesh.boundsMin = glm::vec3(1.0e30f);
+	mesh.boundsMax = glm::vec3(-1.0e30f);
+	for (size_t i = 0; i < mesh.vertices.size(); i++)
+	{
+		mesh.boundsMin = glm::min(mesh.boundsMin, mesh.vertices[i].position);
+		mesh.boundsMax = glm::max(mesh.boundsMax, mesh.vertices[i].position);
+	}
+}
+
+/***********************************************************
+ *  ComputeMeshNormals()
+ *
+ *  This function is used for computing area weighted vertex
+ *  normals.  The face normals and the final normalization
+ *  run four at a time in parallel batches, and only the
+ *  summing into the vertices runs on one thread.
+ ***********************************************************/
+void ComputeMeshNormals(
+	MESH_DATA& mesh,
+	const std::vector<uint32_t>& normalGroups,
+	ThreadPool* pThreadPool)
+{
+	size_t triangleCount = mesh.indices.size() / 3;
+	std::vector<glm::vec3> faceNormals(triangleCount);
+	RunBatches(pThreadPool, triangleCount, [&](size_t begin, size_t end)
+	{
+		ComputeFaceNormals(mesh, begin, end, faceNormals.data());
+	});
+
+	std::vector<glm::vec3> sums(mesh.vertices.size(), glm::vec3(0.0f));
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		for (int corner = 0; corner < 3; corner++)
+		{
+			uint32_t vertex = mesh.indices[t * 3 + corner];
+			sums[normalGroups.empty() ? vertex : normalGroups[vertex]] += faceNormals[t];
+		}
+	}
+
+	RunBatches(pThreadPool, mesh.vertices.size(), [&](size_t begin, size_t end)
+	{
+		NormalizeNormals(mesh, sums, normalGroups, begin, end);
+	});
+}
+
+/***********************************************************
+ *  ComputeMeshTangents()
+ *
+ *  This function is used for computing the vertex tangents
+ *  from the texture coordinates, for normal mapping.  The
+ *  vertex normals must already be set.
+ ***********************************************************/
+void ComputeMeshTangents(MESH_DATA& mesh, ThreadPool* pThreadPool)
+{
+	size_t triangleCount = mesh.indices.size() / 3;
+	std::vector<glm::vec3> faceTangents(triangleCount);
+	std::vector<glm::vec3> faceBitangents(triangleCount);
+	RunBatches(pThreadPool, triangleCount, [&](size_t begin, size_t end)
+	{
+		ComputeFaceTangents(mesh, begin, end, faceTangents.data(), faceBitangents.data());
+	});
+
+	std::vector<glm::vec3> tangentSums(mesh.vertices.size(), glm::vec3(0.0f));
+	std::vector<glm::vec3> bitangentSums(mesh.vertices.size(), glm::vec3(0.0f));
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		for (int corner = 0; corner < 3; corner++)
+		{
+			uint32_t vertex = mesh.indices[t * 3 + corner];
+			tangentSums[vertex] += faceTangents[t];
+			bitangentSums[vertex] += faceBitangents[t];
+		}
+	}
+
+	mesh.tangents.resize(mesh.vertices.size());
+	RunBatches(pThreadPool, mesh.vertices.size(), [&](size_t begin, size_t end)
+	{
+		OrthogonalizeTangents(mesh, tangentSums, bitangentSums, begin, end);
+	});
+}
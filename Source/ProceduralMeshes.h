@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////////////
+// proceduralmeshes.h
+// ============
+// generate the basic scene shapes at several levels of detail
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshData.h"
+#include "ThreadPool.h"
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  SHAPE_TYPE
+ *
+ *  The basic shapes, with the same size and placement as
+ *  the ShapeMeshes versions: the plane spans -1..1 in X and
+ *  Z, the box and prism span -0.5..0.5, the cylinder has a
+ *  radius of 1 and runs from 0 to 1 in Y, the spheres have
+ *  a radius of 1 and the torus lies in the XY plane with a
+ *  main radius of 1 and a tube radius of 0.1.
+ ***********************************************************/
+enum SHAPE_TYPE
+{
+	SHAPE_PLANE = 0,
+	SHAPE_BOX,
+	SHAPE_CYLINDER,
+	SHAPE_PRISM,
+	SHAPE_SPHERE,
+	SHAPE_HALF_SPHERE,
+	SHAPE_TORUS,
+	SHAPE_COUNT
+};
+
+// most detail levels generated for one shape
+const int SHAPE_MAX_LODS = 4;
+
+// number of detail levels generated for the shape - flat
+// shapes only have one
+int GetShapeLODCount(SHAPE_TYPE shape);
+
+// fill the mesh with one detail level of the shape, where
+// level 0 is the finest, including normals and tangents
+void GenerateShapeMesh(SHAPE_TYPE shape, int lod, MESH_DATA& mesh, ThreadPool* pThreadPool);
+
+// compute smooth vertex normals from the triangles - vertices
+// that share a group index get the same normal, which joins
+// texture seams; an empty group list gives every vertex its own
+void ComputeMeshNormals(
+	MESH_DATA& mesh,
+	const std::vector<uint32_t>& normalGroups,
+	ThreadPool* pThreadPool);
+
+// compute vertex tangents from the texture coordinates
+void ComputeMeshTangents(MESH_DATA& mesh, ThreadPool* pThreadPool);
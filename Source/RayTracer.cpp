@@ -0,0 +1,309 @@
+///////////////////////////////////////////////////////////////////////////////
+// raytracer.cpp
+// ============
+// render still images of the scene by tracing rays on the CPU
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RayTracer.h"
+#include "ImageFile.h"
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// size in pixels of the square tiles handed to the threads
+	const int g_TileSize = 16;
+}
+
+/***********************************************************
+ *  RayTracer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RayTracer::RayTracer(ThreadPool* pThreadPool)
+{
+	m_pThreadPool = pThreadPool;
+	m_settings.samplesPerAxis = 2;
+	m_settings.bShadows = true;
+	m_width = 0;
+	m_height = 0;
+	m_tilesX = 0;
+	m_tilesY = 0;
+	m_clearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	m_inverseViewProjection = glm::mat4(1.0f);
+	m_viewPosition = glm::vec3(0.0f);
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the size of the color
+ *  buffer that the next frames are traced into.
+ ***********************************************************/
+void RayTracer::Resize(int width, int height)
+{
+	m_width = std::max(width, 0);
+	m_height = std::max(height, 0);
+	m_tilesX = (m_width + g_TileSize - 1) / g_TileSize;
+	m_tilesY = (m_height + g_TileSize - 1) / g_TileSize;
+	m_colorBuffer.assign(static_cast<size_t>(m_width) * m_height, PackColor(m_clearColor));
+}
+
+/***********************************************************
+ *  SetCamera()
+ *
+ *  This method is used for setting the view and projection
+ *  matrices and the camera position, as they are passed to
+ *  the shaders.
+ ***********************************************************/
+void RayTracer::SetCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition)
+{
+	m_inverseViewProjection = glm::inverse(projection * view);
+	m_viewPosition = viewPosition;
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for setting the light sources.
+ ***********************************************************/
+void RayTracer::SetLights(const std::vector<SCENE_LIGHT>& lights)
+{
+	m_lights = lights;
+}
+
+/***********************************************************
+ *  SetClearColor()
+ *
+ *  This method is used for setting the background color.
+ ***********************************************************/
+void RayTracer::SetClearColor(const glm::vec4& color)
+{
+	m_clearColor = color;
+}
+
+/***********************************************************
+ *  SetSettings()
+ *
+ *  This method is used for setting the sample count and
+ *  whether shadows are traced.
+ ***********************************************************/
+void RayTracer::SetSettings(const RAY_TRACE_SETTINGS& settings)
+{
+	m_settings = settings;
+	m_settings.samplesPerAxis = std::max(m_settings.samplesPerAxis, 1);
+}
+
+/***********************************************************
+ *  Render()
+ *
+ *  This method is used for tracing a frame.  The scene is
+ *  placed first, then the tiles are traced in parallel.
+ ***********************************************************/
+void RayTracer::Render(const std::vector<SOFTWARE_DRAW>& draws)
+{
+	if ((m_width == 0) || (m_height == 0))
+	{
+		return;
+	}
+
+	m_scene.Build(draws, m_pThreadPool);
+
+	m_pThreadPool->ParallelFor(
+		static_cast<size_t>(m_tilesX) * m_tilesY,
+		1,
+		[this, &draws](size_t begin, size_t end)
+	{
+		for (size_t tile = begin; tile < end; tile++)
+		{
+			RenderTile(static_cast<int>(tile), draws);
+		}
+	});
+}
+
+/***********************************************************
+ *  ClearMeshCache()
+ *
+ *  This method is used for dropping the mesh hierarchies so
+ *  they are rebuilt from the current mesh data.
+ ***********************************************************/
+void RayTracer::ClearMeshCache()
+{
+	m_scene.ClearMeshCache();
+}
+
+/***********************************************************
+ *  RenderTile()
+ *
+ *  This method is used for tracing the pixels of one tile
+ *  in blocks of two by two pixels.  Each sample position
+ *  inside the pixels sends one packet of four rays, and the
+ *  shaded samples are averaged.
+ ***********************************************************/
+void RayTracer::RenderTile(int tileIndex, const std::vector<SOFTWARE_DRAW>& draws)
+{
+	int tileX = (tileIndex % m_tilesX) * g_TileSize;
+	int tileY = (tileIndex / m_tilesX) * g_TileSize;
+	int endX = std::min(tileX + g_TileSize, m_width);
+	int endY = std::min(tileY + g_TileSize, m_height);
+
+	int samplesPerAxis = m_settings.samplesPerAxis;
+	float sampleWeight = 1.0f / (samplesPerAxis * samplesPerAxis);
+	std::vector<float> lightVisibility(m_lights.size(), 1.0f);
+
+	for (int blockY = tileY; blockY < endY; blockY += 2)
+	{
+		for (int blockX = tileX; blockX < endX; blockX += 2)
+		{
+			glm::vec3 colors[4] = { glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f) };
+
+			for (int sample = 0; sample < samplesPerAxis * samplesPerAxis; sample++)
+			{
+				float offsetX = ((sample % samplesPerAxis) + 0.5f) / samplesPerAxis;
+				float offsetY = ((sample / samplesPerAxis) + 0.5f) / samplesPerAxis;
+
+				RAY_PACKET packet;
+				for (int lane = 0; lane < 4; lane++)
+				{
+					int x = blockX + (lane & 1);
+					int y = blockY + (lane >> 1);
+					glm::vec3 origin;
+					glm::vec3 direction;
+					GetCameraRay(m_inverseViewProjection, m_width, m_height, x + offsetX, y + offsetY, origin, direction);
+
+					packet.originX[lane] = origin.x;
+					packet.originY[lane] = origin.y;
+					packet.originZ[lane] = origin.z;
+					packet.directionX[lane] = direction.x;
+					packet.directionY[lane] = direction.y;
+					packet.directionZ[lane] = direction.z;
+					// pixels past the edge of the screen trace nothing
+					packet.t[lane] = ((x < endX) && (y < endY)) ? 1.0f : 0.0f;
+					packet.u[lane] = 0.0f;
+					packet.v[lane] = 0.0f;
+					packet.triangle[lane] = -1;
+					packet.instance[lane] = -1;
+				}
+
+				m_scene.GetBVH().IntersectPacket(packet);
+
+				for (int lane = 0; lane < 4; lane++)
+				{
+					if (packet.triangle[lane] < 0)
+					{
+						colors[lane] += glm::vec3(m_clearColor);
+						continue;
+					}
+
+					BVH_RAY ray;
+					ray.origin = glm::vec3(packet.originX[lane], packet.originY[lane], packet.originZ[lane]);
+					ray.direction = glm::vec3(packet.directionX[lane], packet.directionY[lane], packet.directionZ[lane]);
+					ray.t = packet.t[lane];
+					ray.u = packet.u[lane];
+					ray.v = packet.v[lane];
+					ray.triangle = packet.triangle[lane];
+					ray.instance = packet.instance[lane];
+					colors[lane] += ShadeHit(ray, draws, lightVisibility);
+				}
+			}
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				int x = blockX + (lane & 1);
+				int y = blockY + (lane >> 1);
+				if ((x < endX) && (y < endY))
+				{
+					m_colorBuffer[static_cast<size_t>(y) * m_width + x] =
+						PackColor(glm::vec4(colors[lane] * sampleWeight, 1.0f));
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  ShadeHit()
+ *
+ *  This method is used for interpolating the vertices of
+ *  the triangle a ray hit and lighting the point like the
+ *  fragment shader.  With shadows turned on, every light
+ *  that is blocked only adds its ambient term.
+ ***********************************************************/
+glm::vec3 RayTracer::ShadeHit(
+	const BVH_RAY& ray,
+	const std::vector<SOFTWARE_DRAW>& draws,
+	std::vector<float>& lightVisibility) const
+{
+	SURFACE_POINT point;
+	m_scene.GetSurfacePoint(ray, draws, point);
+	const glm::vec3& position = point.position;
+	const glm::vec3& normal = point.normal;
+
+	const float* pVisibility = NULL;
+	if (m_settings.bShadows)
+	{
+		for (size_t i = 0; i < m_lights.size(); i++)
+		{
+			lightVisibility[i] = m_scene.IsPointVisible(position, normal, m_lights[i].position) ? 1.0f : 0.0f;
+		}
+		pVisibility = lightVisibility.data();
+	}
+
+	glm::vec4 color = ShadeSurface(
+		point.pDraw->shading,
+		m_lights.data(),
+		static_cast<int>(m_lights.size()),
+		m_viewPosition,
+		position,
+		normal,
+		point.texCoord,
+		pVisibility);
+	return(glm::vec3(color));
+}
+
+/***********************************************************
+ *  GetWidth()
+ *
+ *  This method is used for getting the width of the color
+ *  buffer.
+ ***********************************************************/
+int RayTracer::GetWidth() const
+{
+	return(m_width);
+}
+
+/***********************************************************
+ *  GetHeight()
+ *
+ *  This method is used for getting the height of the color
+ *  buffer.
+ ***********************************************************/
+int RayTracer::GetHeight() const
+{
+	return(m_height);
+}
+
+/***********************************************************
+ *  GetColorBuffer()
+ *
+ *  This method is used for getting the pixels of the last
+ *  frame.
+ ***********************************************************/
+const uint32_t* RayTracer::GetColorBuffer() const
+{
+	return(m_colorBuffer.data());
+}
+
+/***********************************************************
+ *  SaveImage()
+ *
+ *  This method is used for writing the last frame into a
+ *  binary PPM image.
+ ***********************************************************/
+bool RayTracer::SaveImage(const char* filename) const
+{
+	return(SavePPMImage(filename, m_width, m_height, m_colorBuffer.data()));
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// raytracer.h
+// ============
+// render still images of the scene by tracing rays on the CPU
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShadingModel.h"
+#include "SoftwareRasterizer.h"
+#include "ThreadPool.h"
+#include "TracedScene.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  RAY_TRACE_SETTINGS
+ *
+ *  Quality settings of the ray tracer.
+ ***********************************************************/
+struct RAY_TRACE_SETTINGS
+{
+	// every pixel is sampled on an n by n grid
+	int samplesPerAxis;
+	// trace a ray to each light to darken the points it
+	// does not reach - off matches the rasterizers
+	bool bShadows;
+};
+
+/***********************************************************
+ *  RayTracer
+ *
+ *  This class renders the same draw lists as the software
+ *  rasterizer by casting rays through every pixel.  The
+ *  screen is split into tiles that are traced
+ *  on the worker threads, four neighboring pixels at a
+ *  time as one SSE ray packet.
+ ***********************************************************/
+class RayTracer
+{
+public:
+	// constructor
+	RayTracer(ThreadPool* pThreadPool);
+
+	// set the size of the color buffer in pixels
+	void Resize(int width, int height);
+	// set the camera used for the next frames
+	void SetCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition);
+	// set the lights used for the next frames
+	void SetLights(const std::vector<SCENE_LIGHT>& lights);
+	// set the color of the pixels not covered by any mesh
+	void SetClearColor(const glm::vec4& color);
+	// set the quality used for the next frames
+	void SetSettings(const RAY_TRACE_SETTINGS& settings);
+
+	// draw a frame with the passed meshes - the meshes must
+	// not change while their hierarchies are cached
+	void Render(const std::vector<SOFTWARE_DRAW>& draws);
+	// forget the cached mesh hierarchies, needed before a
+	// drawn mesh is changed or freed
+	void ClearMeshCache();
+
+	int GetWidth() const;
+	int GetHeight() const;
+	// RGBA bytes of the last frame, top row first
+	const uint32_t* GetColorBuffer() const;
+	// write the last frame to a binary PPM file
+	bool SaveImage(const char* filename) const;
+
+private:
+	// workers shared with the rest of the scene code
+	ThreadPool* m_pThreadPool;
+	RAY_TRACE_SETTINGS m_settings;
+
+	int m_width;
+	int m_height;
+	int m_tilesX;
+	int m_tilesY;
+	std::vector<uint32_t> m_colorBuffer;
+	glm::vec4 m_clearColor;
+
+	glm::mat4 m_inverseViewProjection;
+	glm::vec3 m_viewPosition;
+	std::vector<SCENE_LIGHT> m_lights;
+
+	// the draws of the current frame, placed for tracing
+	TracedScene m_scene;
+
+	// trace and shade the pixels of one tile
+	void RenderTile(int tileIndex, const std::vector<SOFTWARE_DRAW>& draws);
+	// color of the point where a ray hit a triangle
+	glm::vec3 ShadeHit(
+		const BVH_RAY& ray,
+		const std::vector<SOFTWARE_DRAW>& draws,
+		std::vector<float>& lightVisibility) const;
+};
@@ -0,0 +1,595 @@
+///////////////////////////////////////////////////////////////////////////////
+// recordingrenderbackend.cpp
+// ============
+// record the rendering commands on their way to a backend
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RecordingRenderBackend.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+/***********************************************************
+ *  RecordingRenderBackend()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RecordingRenderBackend::RecordingRenderBackend(RenderBackend* pBackend, size_t frameCount)
+{
+	m_pBackend = pBackend;
+	m_frameLimit = frameCount;
+	m_recordedFrames = 0;
+	m_traceEnd = 0;
+	m_bRecording = (frameCount > 0);
+}
+
+/***********************************************************
+ *  WriteBytes()
+ *
+ *  This method is used for appending raw bytes to the
+ *  trace, unless the recording has finished.
+ ***********************************************************/
+void RecordingRenderBackend::WriteBytes(const void* pData, size_t size)
+{
+	if (!m_bRecording)
+	{
+		return;
+	}
+
+	const unsigned char* pBytes = static_cast<const unsigned char*>(pData);
+	m_commands.insert(m_commands.end(), pBytes, pBytes + size);
+}
+
+/***********************************************************
+ *  WriteCommand()
+ *
+ *  This method is used for starting a command.
+ ***********************************************************/
+void RecordingRenderBackend::WriteCommand(TRACE_COMMAND command)
+{
+	uint8_t code = static_cast<uint8_t>(command);
+	WriteBytes(&code, sizeof(code));
+}
+
+/***********************************************************
+ *  WriteUint32()
+ *
+ *  This method is used for appending a size, offset or
+ *  handle as 32 bits.
+ ***********************************************************/
+void RecordingRenderBackend::WriteUint32(size_t value)
+{
+	uint32_t value32 = static_cast<uint32_t>(value);
+	WriteBytes(&value32, sizeof(value32));
+}
+
+/***********************************************************
+ *  WriteData()
+ *
+ *  This method is used for appending data passed by
+ *  pointer, which may be NULL.
+ ***********************************************************/
+void RecordingRenderBackend::WriteData(const void* pData, size_t size)
+{
+	uint8_t present = (NULL != pData) ? 1 : 0;
+	WriteUint32(size);
+	WriteBytes(&present, sizeof(present));
+	if (NULL != pData)
+	{
+		WriteBytes(pData, size);
+	}
+}
+
+/***********************************************************
+ *  WriteString()
+ *
+ *  This method is used for appending a string.
+ ***********************************************************/
+void RecordingRenderBackend::WriteString(const char* text)
+{
+	uint16_t length = static_cast<uint16_t>((NULL != text) ? strlen(text) : 0);
+	WriteBytes(&length, sizeof(length));
+	WriteBytes(text, length);
+}
+
+/***********************************************************
+ *  DefineName()
+ *
+ *  This method is used for getting the id of a uniform
+ *  name, writing the name into the trace the first time it
+ *  is used.
+ ***********************************************************/
+uint16_t RecordingRenderBackend::DefineName(const std::string& name)
+{
+	std::unordered_map<std::string, uint16_t>::const_iterator known = m_names.find(name);
+	if (known != m_names.end())
+	{
+		return(known->second);
+	}
+
+	uint16_t id = static_cast<uint16_t>(m_names.size());
+	m_names[name] = id;
+	WriteCommand(TRACE_DEFINE_NAME);
+	WriteBytes(&id, sizeof(id));
+	WriteString(name.c_str());
+	return(id);
+}
+
+/***********************************************************
+ *  WriteUniform()
+ *
+ *  This method is used for appending a uniform command
+ *  with the raw bytes of its value.
+ ***********************************************************/
+void RecordingRenderBackend::WriteUniform(TRACE_COMMAND command, const std::string& name, const void* pValue, size_t size)
+{
+	if (!m_bRecording)
+	{
+		return;
+	}
+
+	uint16_t id = DefineName(name);
+	WriteCommand(command);
+	WriteBytes(&id, sizeof(id));
+	WriteBytes(pValue, size);
+}
+
+/***********************************************************
+ *  CreateBuffer()
+ *
+ *  This method is used for creating a buffer and recording
+ *  it with its data.
+ ***********************************************************/
+uint32_t RecordingRenderBackend::CreateBuffer(BUFFER_TYPE type, size_t size, const void* pData)
+{
+	uint32_t buffer = m_pBackend->CreateBuffer(type, size, pData);
+	WriteCommand(TRACE_CREATE_BUFFER);
+	WriteUint32(buffer);
+	WriteUint32(type);
+	WriteData(pData, size);
+	return(buffer);
+}
+
+/***********************************************************
+ *  UpdateBuffer()
+ *
+ *  This method is used for recording a buffer update.
+ ***********************************************************/
+void RecordingRenderBackend::UpdateBuffer(uint32_t buffer, size_t offset, size_t size, const void* pData)
+{
+	WriteCommand(TRACE_UPDATE_BUFFER);
+	WriteUint32(buffer);
+	WriteUint32(offset);
+	WriteData(pData, size);
+	m_pBackend->UpdateBuffer(buffer, offset, size, pData);
+}
+
+/***********************************************************
+ *  CopyBuffer()
+ *
+ *  This method is used for recording a copy between
+ *  buffers.
+ ***********************************************************/
+void RecordingRenderBackend::CopyBuffer(uint32_t source, uint32_t destination, size_t sourceOffset, size_t destinationOffset, size_t size)
+{
+	WriteCommand(TRACE_COPY_BUFFER);
+	WriteUint32(source);
+	WriteUint32(destination);
+	WriteUint32(sourceOffset);
+	WriteUint32(destinationOffset);
+	WriteUint32(size);
+	m_pBackend->CopyBuffer(source, destination, sourceOffset, destinationOffset, size);
+}
+
+/***********************************************************
+ *  DestroyBuffer()
+ *
+ *  This method is used for recording a deleted buffer.
+ ***********************************************************/
+void RecordingRenderBackend::DestroyBuffer(uint32_t buffer)
+{
+	WriteCommand(TRACE_DESTROY_BUFFER);
+	WriteUint32(buffer);
+	m_pBackend->DestroyBuffer(buffer);
+}
+
+/***********************************************************
+ *  CreateVertexLayout()
+ *
+ *  This method is used for creating a vertex layout and
+ *  recording its attributes.
+ ***********************************************************/
+uint32_t RecordingRenderBackend::CreateVertexLayout(const VERTEX_ATTRIBUTE* pAttributes, int attributeCount, uint32_t indexBuffer)
+{
+	uint32_t layout = m_pBackend->CreateVertexLayout(pAttributes, attributeCount, indexBuffer);
+	WriteCommand(TRACE_CREATE_VERTEX_LAYOUT);
+	WriteUint32(layout);
+	WriteUint32(indexBuffer);
+	WriteUint32(attributeCount);
+	WriteBytes(pAttributes, attributeCount * sizeof(VERTEX_ATTRIBUTE));
+	return(layout);
+}
+
+/***********************************************************
+ *  DestroyVertexLayout()
+ *
+ *  This method is used for recording a deleted layout.
+ ***********************************************************/
+void RecordingRenderBackend::DestroyVertexLayout(uint32_t layout)
+{
+	WriteCommand(TRACE_DESTROY_VERTEX_LAYOUT);
+	WriteUint32(layout);
+	m_pBackend->DestroyVertexLayout(layout);
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used for creating a texture and recording
+ *  it with its pixels.
+ ***********************************************************/
+uint32_t RecordingRenderBackend::CreateTexture(int width, int height, int channels, const unsigned char* pPixels)
+{
+	uint32_t texture = m_pBackend->CreateTexture(width, height, channels, pPixels);
+	WriteCommand(TRACE_CREATE_TEXTURE);
+	WriteUint32(texture);
+	WriteUint32(width);
+	WriteUint32(height);
+	WriteUint32(channels);
+	WriteData(pPixels, static_cast<size_t>(width) * height * channels);
+	return(texture);
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used for recording a texture bind.
+ ***********************************************************/
+void RecordingRenderBackend::BindTexture(int slot, uint32_t texture)
+{
+	WriteCommand(TRACE_BIND_TEXTURE);
+	WriteUint32(slot);
+	WriteUint32(texture);
+	m_pBackend->BindTexture(slot, texture);
+}
+
+/***********************************************************
+ *  DestroyTexture()
+ *
+ *  This method is used for recording a deleted texture.
+ ***********************************************************/
+void RecordingRenderBackend::DestroyTexture(uint32_t texture)
+{
+	WriteCommand(TRACE_DESTROY_TEXTURE);
+	WriteUint32(texture);
+	m_pBackend->DestroyTexture(texture);
+}
+
+/***********************************************************
+ *  CreateProgram()
+ *
+ *  This method is used for creating a program and recording
+ *  the files it was built from.
+ ***********************************************************/
+uint32_t RecordingRenderBackend::CreateProgram(const char* vertexFilename, const char* fragmentFilename)
+{
+	uint32_t program = m_pBackend->CreateProgram(vertexFilename, fragmentFilename);
+	WriteCommand(TRACE_CREATE_PROGRAM);
+	WriteUint32(program);
+	WriteString(vertexFilename);
+	WriteString(fragmentFilename);
+	return(program);
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used for recording a program change.
+ ***********************************************************/
+void RecordingRenderBackend::UseProgram(uint32_t program)
+{
+	WriteCommand(TRACE_USE_PROGRAM);
+	WriteUint32(program);
+	m_pBackend->UseProgram(program);
+}
+
+/***********************************************************
+ *  SetUniformInt()
+ *
+ *  This method is used for recording an int uniform.
+ ***********************************************************/
+void RecordingRenderBackend::SetUniformInt(const std::string& name, int value)
+{
+	WriteUniform(TRACE_SET_UNIFORM_INT, name, &value, sizeof(value));
+	m_pBackend->SetUniformInt(name, value);
+}
+
+/***********************************************************
+ *  SetUniformFloat()
+ *
+ *  This method is used for recording a float uniform.
+ ***********************************************************/
+void RecordingRenderBackend::SetUniformFloat(const std::string& name, float value)
+{
+	WriteUniform(TRACE_SET_UNIFORM_FLOAT, name, &value, sizeof(value));
+	m_pBackend->SetUniformFloat(name, value);
+}
+
+/***********************************************************
+ *  SetUniformVec2()
+ *
+ *  This method is used for recording a vec2 uniform.
+ ***********************************************************/
+void RecordingRenderBackend::SetUniformVec2(const std::string& name, const glm::vec2& value)
+{
+	WriteUniform(TRACE_SET_UNIFORM_VEC2, name, &value, sizeof(value));
+	m_pBackend->SetUniformVec2(name, value);
+}
+
+/***********************************************************
+ *  SetUniformVec3()
+ *
+ *  This method is used for recording a vec3 uniform.
+ ***********************************************************/
+void RecordingRenderBackend::SetUniformVec3(const std::string& name, const glm::vec3& value)
+{
+	WriteUniform(TRACE_SET_UNIFORM_VEC3, name, &value, sizeof(value));
+	m_pBackend->SetUniformVec3(name, value);
+}
+
+/***********************************************************
+ *  SetUniformVec4()
+ *
+ *  This method is used for recording a vec4 uniform.
+ ***********************************************************/
+void RecordingRenderBackend::SetUniformVec4(const std::string& name, const glm::vec4& value)
+{
+	WriteUniform(TRACE_SET_UNIFORM_VEC4, name, &value, sizeof(value));
+	m_pBackend->SetUniformVec4(name, value);
+}
+
+/***********************************************************
+ *  SetUniformMat4()
+ *
+ *  This method is used for recording a mat4 uniform.
+ ***********************************************************/
+void RecordingRenderBackend::SetUniformMat4(const std::string& name, const glm::mat4& value)
+{
+	WriteUniform(TRACE_SET_UNIFORM_MAT4, name, &value, sizeof(value));
+	m_pBackend->SetUniformMat4(name, value);
+}
+
+/***********************************************************
+ *  SetUniformSampler()
+ *
+ *  This method is used for recording a sampler uniform.
+ ***********************************************************/
+void RecordingRenderBackend::SetUniformSampler(const std::string& name, int slot)
+{
+	WriteUniform(TRACE_SET_UNIFORM_SAMPLER, name, &slot, sizeof(slot));
+	m_pBackend->SetUniformSampler(name, slot);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for recording the start of a frame.
+ ***********************************************************/
+void RecordingRenderBackend::BeginFrame()
+{
+	WriteCommand(TRACE_BEGIN_FRAME);
+	m_pBackend->BeginFrame();
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for recording the end of a frame,
+ *  and stops the recording after the last frame asked for.
+ ***********************************************************/
+void RecordingRenderBackend::EndFrame()
+{
+	m_pBackend->EndFrame();
+	if (!m_bRecording)
+	{
+		return;
+	}
+
+	WriteCommand(TRACE_END_FRAME);
+	m_recordedFrames++;
+	m_traceEnd = m_commands.size();
+	if (m_recordedFrames >= m_frameLimit)
+	{
+		m_bRecording = false;
+	}
+}
+
+/***********************************************************
+ *  CreateRenderTarget()
+ *
+ *  This method is used for creating a render target and
+ *  recording it.
+ ***********************************************************/
+uint32_t RecordingRenderBackend::CreateRenderTarget(int width, int height, RENDER_TARGET_FORMAT format, bool bDepth, int samples)
+{
+	uint32_t target = m_pBackend->CreateRenderTarget(width, height, format, bDepth, samples);
+	uint8_t flags[3];
+	flags[0] = static_cast<uint8_t>(format);
+	flags[1] = bDepth ? 1 : 0;
+	flags[2] = static_cast<uint8_t>(std::min(std::max(samples, 1), 255));
+	WriteCommand(TRACE_CREATE_RENDER_TARGET);
+	WriteUint32(target);
+	WriteUint32(width);
+	WriteUint32(height);
+	WriteBytes(flags, sizeof(flags));
+	return(target);
+}
+
+/***********************************************************
+ *  GetRenderTargetTexture()
+ *
+ *  This method is used for getting the texture of a render
+ *  target and recording the handle, so the replay can map
+ *  the binds of it.
+ ***********************************************************/
+uint32_t RecordingRenderBackend::GetRenderTargetTexture(uint32_t target)
+{
+	uint32_t texture = m_pBackend->GetRenderTargetTexture(target);
+	WriteCommand(TRACE_GET_RENDER_TARGET_TEXTURE);
+	WriteUint32(target);
+	WriteUint32(texture);
+	return(texture);
+}
+
+/***********************************************************
+ *  GetRenderTargetDepthTexture()
+ *
+ *  This method is used for getting the depth texture of a
+ *  render target and recording the handle, like its color
+ *  texture.
+ ***********************************************************/
+uint32_t RecordingRenderBackend::GetRenderTargetDepthTexture(uint32_t target)
+{
+	uint32_t texture = m_pBackend->GetRenderTargetDepthTexture(target);
+	WriteCommand(TRACE_GET_RENDER_TARGET_DEPTH_TEXTURE);
+	WriteUint32(target);
+	WriteUint32(texture);
+	return(texture);
+}
+
+/***********************************************************
+ *  SetRenderTarget()
+ *
+ *  This method is used for recording a render target
+ *  change.
+ ***********************************************************/
+void RecordingRenderBackend::SetRenderTarget(uint32_t target)
+{
+	WriteCommand(TRACE_SET_RENDER_TARGET);
+	WriteUint32(target);
+	m_pBackend->SetRenderTarget(target);
+}
+
+/***********************************************************
+ *  DestroyRenderTarget()
+ *
+ *  This method is used for recording a deleted render
+ *  target.
+ ***********************************************************/
+void RecordingRenderBackend::DestroyRenderTarget(uint32_t target)
+{
+	WriteCommand(TRACE_DESTROY_RENDER_TARGET);
+	WriteUint32(target);
+	m_pBackend->DestroyRenderTarget(target);
+}
+
+/***********************************************************
+ *  SetPipelineState()
+ *
+ *  This method is used for recording the pipeline state.
+ ***********************************************************/
+void RecordingRenderBackend::SetPipelineState(const PIPELINE_STATE& state)
+{
+	uint8_t flags[2];
+	flags[0] = state.bDepthTest ? 1 : 0;
+	flags[1] = static_cast<uint8_t>(state.blendMode);
+	WriteCommand(TRACE_SET_PIPELINE_STATE);
+	WriteBytes(flags, sizeof(flags));
+	m_pBackend->SetPipelineState(state);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for recording a clear.
+ ***********************************************************/
+void RecordingRenderBackend::Clear(const glm::vec4& color)
+{
+	WriteCommand(TRACE_CLEAR);
+	WriteBytes(&color, sizeof(color));
+	m_pBackend->Clear(color);
+}
+
+/***********************************************************
+ *  DrawIndexed()
+ *
+ *  This method is used for recording a draw.
+ ***********************************************************/
+void RecordingRenderBackend::DrawIndexed(uint32_t layout, uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex)
+{
+	WriteCommand(TRACE_DRAW_INDEXED);
+	WriteUint32(layout);
+	WriteUint32(indexCount);
+	WriteUint32(firstIndex);
+	WriteBytes(&baseVertex, sizeof(baseVertex));
+	m_pBackend->DrawIndexed(layout, indexCount, firstIndex, baseVertex);
+}
+
+/***********************************************************
+ *  DrawIndexedIndirect()
+ *
+ *  This method is used for recording an indirect draw with
+ *  its list of commands.
+ ***********************************************************/
+void RecordingRenderBackend::DrawIndexedIndirect(uint32_t layout, const DRAW_ELEMENTS_INDIRECT_COMMAND* pCommands, size_t commandCount)
+{
+	WriteCommand(TRACE_DRAW_INDEXED_INDIRECT);
+	WriteUint32(layout);
+	WriteUint32(commandCount);
+	WriteBytes(pCommands, commandCount * sizeof(DRAW_ELEMENTS_INDIRECT_COMMAND));
+	m_pBackend->DrawIndexedIndirect(layout, pCommands, commandCount);
+}
+
+/***********************************************************
+ *  IsFinished()
+ *
+ *  This method is used for checking whether every frame
+ *  asked for has been recorded.
+ ***********************************************************/
+bool RecordingRenderBackend::IsFinished() const
+{
+	return(!m_bRecording);
+}
+
+/***********************************************************
+ *  GetRecordedFrames()
+ *
+ *  This method is used for getting the number of frames
+ *  recorded so far.
+ ***********************************************************/
+size_t RecordingRenderBackend::GetRecordedFrames() const
+{
+	return(m_recordedFrames);
+}
+
+/***********************************************************
+ *  SaveTrace()
+ *
+ *  This method is used for writing the trace to a file.
+ *  It ends with the last finished frame, so a trace saved
+ *  while recording never replays half a frame.
+ ***********************************************************/
+bool RecordingRenderBackend::SaveTrace(const char* filename) const
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not write trace:" << filename << std::endl;
+		return(false);
+	}
+
+	TRACE_HEADER header;
+	memcpy(header.magic, "RTRC", sizeof(header.magic));
+	header.version = g_TraceVersion;
+	header.frameCount = static_cast<uint32_t>(m_recordedFrames);
+	header.commandBytes = static_cast<uint32_t>(m_traceEnd);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(m_commands.data()), m_traceEnd);
+
+	std::cout << "Saved " << m_recordedFrames << " frames of commands, "
+		<< m_traceEnd << " bytes, to " << filename << std::endl;
+	return(file.good());
+}
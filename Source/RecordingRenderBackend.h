@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////
+// recordingrenderbackend.h
+// ============
+// record the rendering commands on their way to a backend
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CommandTrace.h"
+#include "RenderBackend.h"
+
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  RecordingRenderBackend
+ *
+ *  This class sits in front of another backend, passes
+ *  every command on and writes it into a trace, with the
+ *  uniform values and the uploaded data.  It records from
+ *  its creation, so the trace holds everything needed to
+ *  set the scene up, until the asked number of frames has
+ *  ended, and keeps passing commands on after that.  The
+ *  trace is held in memory and written out by SaveTrace(),
+ *  so recording adds no file access to the frames.
+ ***********************************************************/
+class RecordingRenderBackend : public RenderBackend
+{
+public:
+	// constructor - the wrapped backend is not owned
+	RecordingRenderBackend(RenderBackend* pBackend, size_t frameCount);
+
+	virtual uint32_t CreateBuffer(BUFFER_TYPE type, size_t size, const void* pData);
+	virtual void UpdateBuffer(uint32_t buffer, size_t offset, size_t size, const void* pData);
+	virtual void CopyBuffer(uint32_t source, uint32_t destination, size_t sourceOffset, size_t destinationOffset, size_t size);
+	virtual void DestroyBuffer(uint32_t buffer);
+
+	virtual uint32_t CreateVertexLayout(const VERTEX_ATTRIBUTE* pAttributes, int attributeCount, uint32_t indexBuffer);
+	virtual void DestroyVertexLayout(uint32_t layout);
+
+	virtual uint32_t CreateTexture(int width, int height, int channels, const unsigned char* pPixels);
+	virtual void BindTexture(int slot, uint32_t texture);
+	virtual void DestroyTexture(uint32_t texture);
+
+	virtual uint32_t CreateProgram(const char* vertexFilename, const char* fragmentFilename);
+	virtual void UseProgram(uint32_t program);
+	virtual void SetUniformInt(const std::string& name, int value);
+	virtual void SetUniformFloat(const std::string& name, float value);
+	virtual void SetUniformVec2(const std::string& name, const glm::vec2& value);
+	virtual void SetUniformVec3(const std::string& name, const glm::vec3& value);
+	virtual void SetUniformVec4(const std::string& name, const glm::vec4& value);
+	virtual void SetUniformMat4(const std::string& name, const glm::mat4& value);
+	virtual void SetUniformSampler(const std::string& name, int slot);
+
+	virtual void BeginFrame();
+	virtual void EndFrame();
+
+	virtual uint32_t CreateRenderTarget(int width, int height, RENDER_TARGET_FORMAT format, bool bDepth, int samples);
+	virtual uint32_t GetRenderTargetTexture(uint32_t target);
+	virtual uint32_t GetRenderTargetDepthTexture(uint32_t target);
+	virtual void SetRenderTarget(uint32_t target);
+	virtual void DestroyRenderTarget(uint32_t target);
+
+	virtual void SetPipelineState(const PIPELINE_STATE& state);
+	virtual void Clear(const glm::vec4& color);
+
+	virtual void DrawIndexed(uint32_t layout, uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex);
+	virtual void DrawIndexedIndirect(uint32_t layout, const DRAW_ELEMENTS_INDIRECT_COMMAND* pCommands, size_t commandCount);
+
+	// true once the asked number of frames has been recorded
+	bool IsFinished() const;
+	size_t GetRecordedFrames() const;
+	// write the header and the commands recorded so far
+	bool SaveTrace(const char* filename) const;
+
+private:
+	RenderBackend* m_pBackend;
+	// commands recorded so far, without the header
+	std::vector<unsigned char> m_commands;
+	// ids of the uniform names written so far
+	std::unordered_map<std::string, uint16_t> m_names;
+	size_t m_frameLimit;
+	size_t m_recordedFrames;
+	// end of the last recorded frame
+	size_t m_traceEnd;
+	bool m_bRecording;
+
+	// append to the trace while recording
+	void WriteCommand(TRACE_COMMAND command);
+	void WriteBytes(const void* pData, size_t size);
+	void WriteUint32(size_t value);
+	void WriteData(const void* pData, size_t size);
+	void WriteString(const char* text);
+	void WriteUniform(TRACE_COMMAND command, const std::string& name, const void* pValue, size_t size);
+	// id of a uniform name, written into the trace on first use
+	uint16_t DefineName(const std::string& name);
+};
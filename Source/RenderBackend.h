@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderbackend.h
+// ============
+// interface between the scene code and the graphics API
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshletBuilder.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/***********************************************************
+ *  BUFFER_TYPE
+ *
+ *  What a buffer holds, for APIs that need to know when it
+ *  is created.
+ ***********************************************************/
+enum BUFFER_TYPE
+{
+	BUFFER_VERTEX,
+	BUFFER_INDEX
+};
+
+/***********************************************************
+ *  VERTEX_ATTRIBUTE
+ *
+ *  One float attribute of a vertex layout, read from the
+ *  passed buffer at offset + vertex * stride.
+ ***********************************************************/
+struct VERTEX_ATTRIBUTE
+{
+	uint32_t location;
+	uint32_t buffer;
+	int components;
+	uint32_t stride;
+	uint32_t offset;
+};
+
+/***********************************************************
+ *  BLEND_MODE
+ *
+ *  How a draw's color is combined with the target's.
+ ***********************************************************/
+enum BLEND_MODE
+{
+	BLEND_NONE,
+	// standard alpha blending for transparent objects
+	BLEND_ALPHA,
+	// the color is added, for counting and light
+	BLEND_ADDITIVE,
+	BLEND_MODE_COUNT
+};
+
+/***********************************************************
+ *  PIPELINE_STATE
+ *
+ *  Fixed function state the draws run with.
+ ***********************************************************/
+struct PIPELINE_STATE
+{
+	bool bDepthTest;
+	BLEND_MODE blendMode;
+};
+
+/***********************************************************
+ *  RENDER_TARGET_FORMAT
+ *
+ *  Color format of a render target.  The float formats keep
+ *  values above one, and whole numbers exactly, so counts
+ *  can be added into them.
+ ***********************************************************/
+enum RENDER_TARGET_FORMAT
+{
+	RENDER_TARGET_RGBA8,
+	RENDER_TARGET_RGBA16F,
+	RENDER_TARGET_R32F
+};
+
+/***********************************************************
+ *  RenderBackend
+ *
+ *  This class is the thin layer the scene, view and main
+ *  code render through instead of calling the graphics API
+ *  themselves.  Objects are referred to by handles, and a
+ *  handle of zero is never a valid object.  Uniforms are
+ *  set by name on the program in use.  Every method must be
+ *  called from the thread that owns the graphics context.
+ ***********************************************************/
+class RenderBackend
+{
+public:
+	// destructor
+	virtual ~RenderBackend() {}
+
+	// buffers - the data may be NULL to leave the storage
+	// uninitialized
+	virtual uint32_t CreateBuffer(BUFFER_TYPE type, size_t size, const void* pData) = 0;
+	virtual void UpdateBuffer(uint32_t buffer, size_t offset, size_t size, const void* pData) = 0;
+	virtual void CopyBuffer(uint32_t source, uint32_t destination, size_t sourceOffset, size_t destinationOffset, size_t size) = 0;
+	virtual void DestroyBuffer(uint32_t buffer) = 0;
+
+	// vertex layouts - which buffers the draws read their
+	// vertices and indices from
+	virtual uint32_t CreateVertexLayout(const VERTEX_ATTRIBUTE* pAttributes, int attributeCount, uint32_t indexBuffer) = 0;
+	virtual void DestroyVertexLayout(uint32_t layout) = 0;
+
+	// textures - 8 bit RGB or RGBA images, repeated, linearly
+	// filtered and mipmapped
+	virtual uint32_t CreateTexture(int width, int height, int channels, const unsigned char* pPixels) = 0;
+	virtual void BindTexture(int slot, uint32_t texture) = 0;
+	virtual void DestroyTexture(uint32_t texture) = 0;
+
+	// programs - built from shader source files
+	virtual uint32_t CreateProgram(const char* vertexFilename, const char* fragmentFilename) = 0;
+	virtual void UseProgram(uint32_t program) = 0;
+	virtual void SetUniformInt(const std::string& name, int value) = 0;
+	virtual void SetUniformFloat(const std::string& name, float value) = 0;
+	virtual void SetUniformVec2(const std::string& name, const glm::vec2& value) = 0;
+	virtual void SetUniformVec3(const std::string& name, const glm::vec3& value) = 0;
+	virtual void SetUniformVec4(const std::string& name, const glm::vec4& value) = 0;
+	virtual void SetUniformMat4(const std::string& name, const glm::mat4& value) = 0;
+	// point a sampler at a texture slot
+	virtual void SetUniformSampler(const std::string& name, int slot) = 0;
+
+	// frames - every draw of a frame happens between these,
+	// for the layers that count, time or record per frame.
+	// A backend with nothing to do per frame leaves them out
+	virtual void BeginFrame() {}
+	virtual void EndFrame() {}
+
+	// render targets - textures the frame can be drawn into
+	// and then sampled, clamped and linearly filtered, with
+	// an optional depth texture of their own.  With more than
+	// one sample the drawing is multisampled and resolved
+	// into the textures once another target is set
+	virtual uint32_t CreateRenderTarget(int width, int height, RENDER_TARGET_FORMAT format, bool bDepth, int samples) = 0;
+	// the color and depth textures of a target, for
+	// BindTexture() - the depth texture is zero without depth
+	virtual uint32_t GetRenderTargetTexture(uint32_t target) = 0;
+	virtual uint32_t GetRenderTargetDepthTexture(uint32_t target) = 0;
+	// draw into a target, or into the frame for zero
+	virtual void SetRenderTarget(uint32_t target) = 0;
+	virtual void DestroyRenderTarget(uint32_t target) = 0;
+
+	// frame state
+	virtual void SetPipelineState(const PIPELINE_STATE& state) = 0;
+	// clear the color and depth of the target being drawn
+	virtual void Clear(const glm::vec4& color) = 0;
+
+	// draw indexed triangles - the indices are moved onto the
+	// vertices by baseVertex
+	virtual void DrawIndexed(uint32_t layout, uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex) = 0;
+	// draw a list of indexed triangle ranges with one call
+	virtual void DrawIndexedIndirect(uint32_t layout, const DRAW_ELEMENTS_INDIRECT_COMMAND* pCommands, size_t commandCount) = 0;
+};
@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendertargetpool.cpp
+// ============
+// reuse render targets between the passes of a frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderTargetPool.h"
+
+// declaration of the global variables and helpers
+namespace
+{
+	// frames a free target is kept before it is destroyed
+	const int g_MaxIdleFrames = 3;
+
+	/***********************************************************
+	 *  GetTexelBytes()
+	 *
+	 *  This function is used for getting the bytes of a texel
+	 *  of a render target format.
+	 ***********************************************************/
+	size_t GetTexelBytes(RENDER_TARGET_FORMAT format)
+	{
+		return((RENDER_TARGET_RGBA16F == format) ? 8 : 4);
+	}
+}
+
+/***********************************************************
+ *  RenderTargetPool()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderTargetPool::RenderTargetPool(RenderBackend* pBackend)
+{
+	m_pBackend = pBackend;
+}
+
+/***********************************************************
+ *  ~RenderTargetPool()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderTargetPool::~RenderTargetPool()
+{
+	for (size_t i = 0; i < m_targets.size(); i++)
+	{
+		m_pBackend->DestroyRenderTarget(m_targets[i].target);
+	}
+	m_targets.clear();
+	m_pBackend = NULL;
+}
+
+/***********************************************************
+ *  Acquire()
+ *
+ *  This method is used for getting a free target of the
+ *  passed size and format, making one when none is free.
+ *  Returns zero when the backend cannot make it.
+ ***********************************************************/
+uint32_t RenderTargetPool::Acquire(int width, int height, RENDER_TARGET_FORMAT format, bool bDepth, int samples)
+{
+	for (size_t i = 0; i < m_targets.size(); i++)
+	{
+		POOLED_TARGET& pooled = m_targets[i];
+		if (!pooled.bInUse && (pooled.width == width) && (pooled.height == height) &&
+			(pooled.format == format) && (pooled.bDepth == bDepth) && (pooled.samples == samples))
+		{
+			pooled.bInUse = true;
+			pooled.idleFrames = 0;
+			return(pooled.target);
+		}
+	}
+
+	POOLED_TARGET pooled;
+	pooled.target = m_pBackend->CreateRenderTarget(width, height, format, bDepth, samples);
+	if (0 == pooled.target)
+	{
+		return(0);
+	}
+	pooled.width = width;
+	pooled.height = height;
+	pooled.format = format;
+	pooled.bDepth = bDepth;
+	pooled.samples = samples;
+	pooled.bInUse = true;
+	pooled.idleFrames = 0;
+	m_targets.push_back(pooled);
+	return(pooled.target);
+}
+
+/***********************************************************
+ *  Release()
+ *
+ *  This method is used for giving a target back, so later
+ *  requests of its size and format can have it.
+ ***********************************************************/
+void RenderTargetPool::Release(uint32_t target)
+{
+	for (size_t i = 0; i < m_targets.size(); i++)
+	{
+		if (m_targets[i].target == target)
+		{
+			m_targets[i].bInUse = false;
+			return;
+		}
+	}
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for counting the frames the free
+ *  targets have waited and destroying the ones that have
+ *  waited too long.
+ ***********************************************************/
+void RenderTargetPool::EndFrame()
+{
+	size_t kept = 0;
+	for (size_t i = 0; i < m_targets.size(); i++)
+	{
+		POOLED_TARGET& pooled = m_targets[i];
+		if (!pooled.bInUse && (++pooled.idleFrames > g_MaxIdleFrames))
+		{
+			m_pBackend->DestroyRenderTarget(pooled.target);
+			continue;
+		}
+		m_targets[kept++] = pooled;
+	}
+	m_targets.resize(kept);
+}
+
+/***********************************************************
+ *  GetTargetCount()
+ *
+ *  This method is used for getting how many targets the
+ *  pool holds, free or not.
+ ***********************************************************/
+size_t RenderTargetPool::GetTargetCount() const
+{
+	return(m_targets.size());
+}
+
+/***********************************************************
+ *  GetBytes()
+ *
+ *  This method is used for estimating the memory of the
+ *  targets the pool holds, with four bytes a pixel for a
+ *  depth buffer, and the samples of multisampled targets
+ *  on top of their textures.
+ ***********************************************************/
+size_t RenderTargetPool::GetBytes() const
+{
+	size_t bytes = 0;
+	for (size_t i = 0; i < m_targets.size(); i++)
+	{
+		const POOLED_TARGET& pooled = m_targets[i];
+		size_t texelBytes = GetTexelBytes(pooled.format) + (pooled.bDepth ? 4 : 0);
+		size_t copies = (pooled.samples > 1) ? pooled.samples + 1 : 1;
+		bytes += static_cast<size_t>(pooled.width) * pooled.height * texelBytes * copies;
+	}
+	return(bytes);
+}
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendertargetpool.h
+// ============
+// reuse render targets between the passes of a frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+
+#include <cstddef>
+#include <vector>
+
+/***********************************************************
+ *  RenderTargetPool
+ *
+ *  This class hands out transient render targets.  A target
+ *  given back with Release() goes to the next Acquire() of
+ *  the same size and format, so passes whose outputs are
+ *  never alive at the same time share memory, and the
+ *  targets are kept from frame to frame instead of being
+ *  made again.  Targets nobody has acquired for a few
+ *  frames, like those of a size the window no longer has,
+ *  are destroyed by EndFrame().
+ ***********************************************************/
+class RenderTargetPool
+{
+public:
+	// constructor
+	RenderTargetPool(RenderBackend* pBackend);
+	// destructor
+	~RenderTargetPool();
+
+	// a free target matching the request, made if needed
+	uint32_t Acquire(int width, int height, RENDER_TARGET_FORMAT format, bool bDepth, int samples);
+	// give a target back for the next request
+	void Release(uint32_t target);
+	// age the free targets and destroy the stale ones
+	void EndFrame();
+
+	// targets alive and their estimated memory
+	size_t GetTargetCount() const;
+	size_t GetBytes() const;
+
+private:
+	struct POOLED_TARGET
+	{
+		uint32_t target;
+		int width;
+		int height;
+		RENDER_TARGET_FORMAT format;
+		bool bDepth;
+		int samples;
+		bool bInUse;
+		// frames since it was last acquired
+		int idleFrames;
+	};
+
+	RenderBackend* m_pBackend;
+	std::vector<POOLED_TARGET> m_targets;
+};
@@ -0,0 +1,310 @@
+///////////////////////////////////////////////////////////////////////////////
+// sdffont.cpp
+// ============
+// signed distance field font atlas for on-screen text
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SDFFont.h"
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// the built in font covers ASCII space to underscore,
+	// one row of 5 bits per glyph pixel row, top row first
+	const int g_FirstCharacter = 32;
+	const int g_GlyphCount = 64;
+	const int g_GlyphWidth = 5;
+	const int g_GlyphHeight = 7;
+	const unsigned char g_Glyphs[g_GlyphCount][g_GlyphHeight] =
+	{
+		{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },	// space
+		{ 0x04, 0x04, 0x04, 0x04, 0x00, 0x00, 0x04 },	// !
+		{ 0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00 },	// "
+		{ 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A },	// #
+		{ 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 },	// $
+		{ 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 },	// %
+		{ 0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D },	// &
+		{ 0x0C, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00 },	// '
+		{ 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 },	// (
+		{ 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 },	// )
+		{ 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00 },	// *
+		{ 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 },	// +
+		{ 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 },	// ,
+		{ 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 },	// -
+		{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C },	// .
+		{ 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 },	// /
+		{ 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },	// 0
+		{ 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },	// 1
+		{ 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },	// 2
+		{ 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },	// 3
+		{ 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },	// 4
+		{ 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },	// 5
+		{ 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },	// 6
+		{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },	// 7
+		{ 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },	// 8
+		{ 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C },	// 9
+		{ 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 },	// :
+		{ 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08 },	// ;
+		{ 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 },	// <
+		{ 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 },	// =
+		{ 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 },	// >
+		{ 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 },	// ?
+		{ 0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E },	// @
+		{ 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 },	// A
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E },	// B
+		{ 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E },	// C
+		{ 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C },	// D
+		{ 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F },	// E
+		{ 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 },	// F
+		{ 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F },	// G
+		{ 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },	// H
+		{ 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E },	// I
+		{ 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C },	// J
+		{ 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },	// K
+		{ 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F },	// L
+		{ 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 },	// M
+		{ 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },	// N
+		{ 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },	// O
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 },	// P
+		{ 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D },	// Q
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 },	// R
+		{ 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E },	// S
+		{ 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },	// T
+		{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },	// U
+		{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 },	// V
+		{ 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A },	// W
+		{ 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 },	// X
+		{ 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 },	// Y
+		{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F },	// Z
+		{ 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E },	// [
+		{ 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 },	// backslash
+		{ 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E },	// ]
+		{ 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00 },	// ^
+		{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }	// _
+	};
+	// the cell after the glyphs is solid
+	const int g_SolidCell = g_GlyphCount;
+
+	// atlas texels per font pixel, and the empty font pixels
+	// around each glyph that the distance fades out in
+	const int g_TexelsPerPixel = 4;
+	const int g_CellMargin = 1;
+	const int g_CellWidth = (g_GlyphWidth + 2 * g_CellMargin) * g_TexelsPerPixel;
+	const int g_CellHeight = (g_GlyphHeight + 2 * g_CellMargin) * g_TexelsPerPixel;
+	const int g_AtlasColumns = 16;
+	const int g_AtlasRows = (g_GlyphCount + 1 + g_AtlasColumns - 1) / g_AtlasColumns;
+	const int g_AtlasWidth = g_AtlasColumns * g_CellWidth;
+	const int g_AtlasHeight = g_AtlasRows * g_CellHeight;
+	// distance in font pixels that maps to the full 0 to 1
+	// range around the edge
+	const float g_DistanceRange = 2.0f * g_CellMargin;
+
+	/***********************************************************
+	 *  IsGlyphPixelSet()
+	 *
+	 *  This function is used for reading one pixel of a glyph,
+	 *  with everything outside the 5 by 7 grid empty.
+	 ***********************************************************/
+	bool IsGlyphPixelSet(int glyph, int x, int y)
+	{
+		if ((x < 0) || (y < 0) || (x >= g_GlyphWidth) || (y >= g_GlyphHeight))
+		{
+			return(false);
+		}
+		return(0 != (g_Glyphs[glyph][y] & (1 << (g_GlyphWidth - 1 - x))));
+	}
+
+	/***********************************************************
+	 *  GlyphIndex()
+	 *
+	 *  This function is used for finding the glyph of a
+	 *  character, drawing lower case as upper case and
+	 *  anything else the font lacks as a question mark.
+	 ***********************************************************/
+	int GlyphIndex(char character)
+	{
+		int code = static_cast<unsigned char>(character);
+		if ((code >= 'a') && (code <= 'z'))
+		{
+			code -= 'a' - 'A';
+		}
+		if ((code < g_FirstCharacter) || (code >= g_FirstCharacter + g_GlyphCount))
+		{
+			code = '?';
+		}
+		return(code - g_FirstCharacter);
+	}
+}
+
+/***********************************************************
+ *  SDFFont()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SDFFont::SDFFont()
+{
+}
+
+/***********************************************************
+ *  GlyphDistance()
+ *
+ *  This method is used for the signed distance, in font
+ *  pixels, from a point of a glyph's grid to the edge of
+ *  its set pixels - positive inside.  Outside it is the
+ *  distance to the nearest set pixel square, and inside
+ *  the distance to the nearest empty one.
+ ***********************************************************/
+float SDFFont::GlyphDistance(int glyph, float x, float y) const
+{
+	int pixelX = static_cast<int>(std::floor(x));
+	int pixelY = static_cast<int>(std::floor(y));
+	bool bInside = IsGlyphPixelSet(glyph, pixelX, pixelY);
+
+	float nearest = g_DistanceRange;
+	for (int j = -1; j <= g_GlyphHeight; j++)
+	{
+		for (int i = -1; i <= g_GlyphWidth; i++)
+		{
+			if (IsGlyphPixelSet(glyph, i, j) == bInside)
+			{
+				continue;
+			}
+			float dx = std::max(std::max(i - x, x - (i + 1)), 0.0f);
+			float dy = std::max(std::max(j - y, y - (j + 1)), 0.0f);
+			nearest = std::min(nearest, std::sqrt(dx * dx + dy * dy));
+		}
+	}
+
+	return(bInside ? nearest : -nearest);
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for filling the atlas.  Every texel
+ *  stores the distance at its center, mapped so the glyph
+ *  edge is 0.5 and the cell margin covers the rest.
+ ***********************************************************/
+void SDFFont::Build()
+{
+	m_atlasPixels.assign(g_AtlasWidth * g_AtlasHeight * 4, 255);
+
+	for (int cell = 0; cell <= g_SolidCell; cell++)
+	{
+		int cellX = (cell % g_AtlasColumns) * g_CellWidth;
+		int cellY = (cell / g_AtlasColumns) * g_CellHeight;
+
+		for (int y = 0; y < g_CellHeight; y++)
+		{
+			for (int x = 0; x < g_CellWidth; x++)
+			{
+				float distance = g_DistanceRange;
+				if (cell != g_SolidCell)
+				{
+					float glyphX = (x + 0.5f) / g_TexelsPerPixel - g_CellMargin;
+					float glyphY = (y + 0.5f) / g_TexelsPerPixel - g_CellMargin;
+					distance = GlyphDistance(cell, glyphX, glyphY);
+				}
+
+				float value = std::min(std::max(0.5f + 0.5f * distance / g_DistanceRange, 0.0f), 1.0f);
+				size_t texel = ((cellY + y) * g_AtlasWidth + cellX + x) * 4;
+				m_atlasPixels[texel + 3] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  GetAtlasWidth()
+ *
+ *  This method is used for getting the atlas width.
+ ***********************************************************/
+int SDFFont::GetAtlasWidth() const
+{
+	return(g_AtlasWidth);
+}
+
+/***********************************************************
+ *  GetAtlasHeight()
+ *
+ *  This method is used for getting the atlas height.
+ ***********************************************************/
+int SDFFont::GetAtlasHeight() const
+{
+	return(g_AtlasHeight);
+}
+
+/***********************************************************
+ *  GetAtlasPixels()
+ *
+ *  This method is used for getting the RGBA atlas pixels,
+ *  empty until Build() is called.
+ ***********************************************************/
+const std::vector<unsigned char>& SDFFont::GetAtlasPixels() const
+{
+	return(m_atlasPixels);
+}
+
+/***********************************************************
+ *  GetGlyphSize()
+ *
+ *  This method is used for getting the size of a glyph at
+ *  a scale of one, which is a font pixel.
+ ***********************************************************/
+glm::vec2 SDFFont::GetGlyphSize() const
+{
+	return(glm::vec2(static_cast<float>(g_GlyphWidth), static_cast<float>(g_GlyphHeight)));
+}
+
+/***********************************************************
+ *  GetAdvance()
+ *
+ *  This method is used for getting the distance from one
+ *  character to the next at a scale of one.
+ ***********************************************************/
+float SDFFont::GetAdvance() const
+{
+	return(static_cast<float>(g_GlyphWidth + 1));
+}
+
+/***********************************************************
+ *  GetGlyphQuad()
+ *
+ *  This method is used for placing a character whose top
+ *  left glyph pixel is at the pen.  The quad takes in the
+ *  cell margin, where the edge fades out.
+ ***********************************************************/
+SDF_GLYPH_QUAD SDFFont::GetGlyphQuad(char character, const glm::vec2& pen, float scale) const
+{
+	int glyph = GlyphIndex(character);
+	glm::vec2 cellTexels(static_cast<float>(g_CellWidth), static_cast<float>(g_CellHeight));
+	glm::vec2 atlasSize(static_cast<float>(g_AtlasWidth), static_cast<float>(g_AtlasHeight));
+	glm::vec2 cellOrigin(
+		static_cast<float>((glyph % g_AtlasColumns) * g_CellWidth),
+		static_cast<float>((glyph / g_AtlasColumns) * g_CellHeight));
+
+	SDF_GLYPH_QUAD quad;
+	quad.position0 = pen - glm::vec2(static_cast<float>(g_CellMargin)) * scale;
+	quad.position1 = quad.position0 + (cellTexels / static_cast<float>(g_TexelsPerPixel)) * scale;
+	quad.uv0 = cellOrigin / atlasSize;
+	quad.uv1 = (cellOrigin + cellTexels) / atlasSize;
+	return(quad);
+}
+
+/***********************************************************
+ *  GetSolidUV()
+ *
+ *  This method is used for getting the center of the solid
+ *  cell, for drawing plain rectangles.
+ ***********************************************************/
+glm::vec2 SDFFont::GetSolidUV() const
+{
+	glm::vec2 center(
+		(g_SolidCell % g_AtlasColumns + 0.5f) * g_CellWidth,
+		(g_SolidCell / g_AtlasColumns + 0.5f) * g_CellHeight);
+	return(center / glm::vec2(static_cast<float>(g_AtlasWidth), static_cast<float>(g_AtlasHeight)));
+}
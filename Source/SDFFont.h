@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+// sdffont.h
+// ============
+// signed distance field font atlas for on-screen text
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  SDF_GLYPH_QUAD
+ *
+ *  Where one character is drawn, in pixels from the top
+ *  left of the text, and the atlas rectangle it samples.
+ ***********************************************************/
+struct SDF_GLYPH_QUAD
+{
+	glm::vec2 position0;
+	glm::vec2 position1;
+	glm::vec2 uv0;
+	glm::vec2 uv1;
+};
+
+/***********************************************************
+ *  SDFFont
+ *
+ *  This class builds a font atlas of signed distances from
+ *  a built in 5 by 7 pixel font, so no font file has to be
+ *  shipped.  Each glyph's pixels are squares, and the
+ *  distance to their union is exact, so the edges stay
+ *  sharp at any size when the shader thresholds it.  The
+ *  atlas holds the printable ASCII characters; lower case
+ *  is drawn with the upper case glyphs.  One cell is solid
+ *  inside, so rectangles can be drawn with the same
+ *  texture and shader as the text.
+ ***********************************************************/
+class SDFFont
+{
+public:
+	// constructor
+	SDFFont();
+
+	// build the atlas pixels
+	void Build();
+
+	// RGBA atlas, with the distance in the alpha channel -
+	// 0.5 is the glyph edge, larger is inside
+	int GetAtlasWidth() const;
+	int GetAtlasHeight() const;
+	const std::vector<unsigned char>& GetAtlasPixels() const;
+
+	// size of a glyph at a scale of one, and the horizontal
+	// advance between characters
+	glm::vec2 GetGlyphSize() const;
+	float GetAdvance() const;
+
+	// the quad of a character at a pen position, scaled
+	SDF_GLYPH_QUAD GetGlyphQuad(char character, const glm::vec2& pen, float scale) const;
+	// an atlas coordinate that is solid inside
+	glm::vec2 GetSolidUV() const;
+
+private:
+	std::vector<unsigned char> m_atlasPixels;
+
+	// distance from a texel center to the edge of a glyph
+	float GlyphDistance(int glyph, float x, float y) const;
+};
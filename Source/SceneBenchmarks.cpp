@@ -0,0 +1,448 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebenchmarks.cpp
+// ============
+// microbenchmarks of the scene and view hot paths
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneBenchmarks.h"
+#include "ProceduralMeshes.h"
+#include "TracedScene.h"
+
+#include "stb_image.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <random>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// the images LoadSceneTextures() loads
+	const char* g_ImageFilenames[] = { "desktop.jpg", "tab.png", "table.png" };
+
+	// names of the shapes, in SHAPE_TYPE order
+	const char* g_ShapeNames[SHAPE_COUNT] =
+	{
+		"plane", "box", "cylinder", "prism", "sphere", "half_sphere", "torus"
+	};
+
+	// shapes along each side of the picking grid, and the
+	// rays the picks cycle through
+	const int g_PickGridSide = 316;
+	const int g_PickRayCount = 256;
+	// the shapes the picking grid is made of
+	const SHAPE_TYPE g_PickGridShapes[] = { SHAPE_BOX, SHAPE_SPHERE, SHAPE_CYLINDER };
+
+	// moves the collision benchmarks cycle through, each about
+	// as long as the camera goes in a frame, and the size of
+	// the sphere moved
+	const int g_MoveCount = 256;
+	const float g_MoveLength = 0.05f;
+	const float g_MoveRadius = 0.2f;
+	// size of the sphere the overlap benchmark looks around
+	const float g_QueryRadius = 1.0f;
+}
+
+/***********************************************************
+ *  SceneBenchmarks()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneBenchmarks::SceneBenchmarks()
+{
+	m_pBackend = NULL;
+	m_pSceneManager = NULL;
+	m_pViewManager = NULL;
+	m_pGridPicker = NULL;
+}
+
+/***********************************************************
+ *  ~SceneBenchmarks()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneBenchmarks::~SceneBenchmarks()
+{
+	if (NULL != m_pGridPicker)
+	{
+		delete m_pGridPicker;
+		m_pGridPicker = NULL;
+	}
+	if (NULL != m_pViewManager)
+	{
+		delete m_pViewManager;
+		m_pViewManager = NULL;
+	}
+	if (NULL != m_pSceneManager)
+	{
+		delete m_pSceneManager;
+		m_pSceneManager = NULL;
+	}
+	if (NULL != m_pBackend)
+	{
+		delete m_pBackend;
+		m_pBackend = NULL;
+	}
+}
+
+/***********************************************************
+ *  Prepare()
+ *
+ *  This method is used for building the scene on the null
+ *  backend and reading the bundled images into memory.
+ ***********************************************************/
+bool SceneBenchmarks::Prepare()
+{
+	m_pBackend = new NullRenderBackend();
+	m_pSceneManager = new SceneManager(m_pBackend);
+	m_pSceneManager->PrepareScene();
+	m_pViewManager = new ViewManager(m_pBackend);
+
+	// time the calls as they are before the static objects
+	// are baked, when every one reaches the shader
+	m_pSceneManager->m_bStaticBaked = false;
+	m_pSceneManager->m_bRecordingScene = false;
+
+	for (size_t i = 0; i < sizeof(g_ImageFilenames) / sizeof(g_ImageFilenames[0]); i++)
+	{
+		std::ifstream file(g_ImageFilenames[i], std::ios::binary);
+		if (!file)
+		{
+			std::cout << "Skipping the decode benchmark of " << g_ImageFilenames[i] << std::endl;
+			continue;
+		}
+
+		IMAGE_FILE image;
+		image.filename = g_ImageFilenames[i];
+		image.bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		m_images.push_back(image);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Register()
+ *
+ *  This method is used for adding every benchmark to the
+ *  suite.
+ ***********************************************************/
+void SceneBenchmarks::Register(BenchmarkSuite& suite)
+{
+	RegisterSceneCalls(suite);
+	RegisterShapes(suite);
+	RegisterImages(suite);
+	RegisterPicking(suite);
+	RegisterCollision(suite);
+}
+
+/***********************************************************
+ *  RegisterSceneCalls()
+ *
+ *  This method is used for adding the benchmarks of the
+ *  calls RenderScene() makes for each object, and of the
+ *  camera matrices.  The lookups are timed for the first
+ *  and the last entry, since they search in order, and for
+ *  a tag that is not there.
+ ***********************************************************/
+void SceneBenchmarks::RegisterSceneCalls(BenchmarkSuite& suite)
+{
+	SceneManager* pScene = m_pSceneManager;
+	ViewManager* pView = m_pViewManager;
+
+	suite.Register("BM_SetTransformations", [pScene](BenchmarkState& state)
+	{
+		float angle = 0.0f;
+		while (state.KeepRunning())
+		{
+			pScene->SetTransformations(glm::vec3(1.0f, 2.0f, 3.0f), angle, 30.0f, 45.0f, glm::vec3(0.5f, 1.0f, -2.0f));
+			angle += 1.0f;
+		}
+	});
+
+	std::vector<std::string> materialTags;
+	if (!pScene->m_objectMaterials.empty())
+	{
+		materialTags.push_back(pScene->m_objectMaterials.front().tag);
+		materialTags.push_back(pScene->m_objectMaterials.back().tag);
+	}
+	materialTags.push_back("missing");
+	const char* lookupNames[] = { "first", "last", "missing" };
+	size_t firstName = 3 - materialTags.size();
+
+	for (size_t i = 0; i < materialTags.size(); i++)
+	{
+		std::string tag = materialTags[i];
+		suite.Register(std::string("BM_FindMaterial/") + lookupNames[firstName + i], [pScene, tag](BenchmarkState& state)
+		{
+			SceneManager::OBJECT_MATERIAL material;
+			while (state.KeepRunning())
+			{
+				DoNotOptimize(pScene->FindMaterial(tag, material));
+			}
+		});
+	}
+
+	std::vector<std::string> textureTags;
+	if (pScene->m_loadedTextures > 0)
+	{
+		textureTags.push_back(pScene->m_textureIDs[0].tag);
+		textureTags.push_back(pScene->m_textureIDs[pScene->m_loadedTextures - 1].tag);
+	}
+	textureTags.push_back("missing");
+	firstName = 3 - textureTags.size();
+
+	for (size_t i = 0; i < textureTags.size(); i++)
+	{
+		std::string tag = textureTags[i];
+		suite.Register(std::string("BM_FindTextureSlot/") + lookupNames[firstName + i], [pScene, tag](BenchmarkState& state)
+		{
+			while (state.KeepRunning())
+			{
+				DoNotOptimize(pScene->FindTextureSlot(tag));
+			}
+		});
+	}
+
+	std::string materialTag = materialTags.front();
+	suite.Register("BM_SetShaderMaterial", [pScene, materialTag](BenchmarkState& state)
+	{
+		while (state.KeepRunning())
+		{
+			pScene->SetShaderMaterial(materialTag);
+		}
+	});
+
+	suite.Register("BM_UpdateCameraMatrices", [pView](BenchmarkState& state)
+	{
+		while (state.KeepRunning())
+		{
+			pView->UpdateCameraMatrices();
+			DoNotOptimize(pView->GetViewMatrix());
+		}
+	});
+}
+
+/***********************************************************
+ *  RegisterShapes()
+ *
+ *  This method is used for adding a benchmark of the most
+ *  detailed level of every basic shape, generated on the
+ *  calling thread.
+ ***********************************************************/
+void SceneBenchmarks::RegisterShapes(BenchmarkSuite& suite)
+{
+	for (int shape = 0; shape < SHAPE_COUNT; shape++)
+	{
+		SHAPE_TYPE type = static_cast<SHAPE_TYPE>(shape);
+		suite.Register(std::string("BM_GenerateShapeMesh/") + g_ShapeNames[shape], [type](BenchmarkState& state)
+		{
+			while (state.KeepRunning())
+			{
+				MESH_DATA mesh;
+				GenerateShapeMesh(type, 0, mesh, NULL);
+				DoNotOptimize(mesh.indices.size());
+			}
+		});
+	}
+}
+
+/***********************************************************
+ *  RegisterImages()
+ *
+ *  This method is used for adding a benchmark of decoding
+ *  each bundled image from memory, so the file system is
+ *  not part of the time.
+ ***********************************************************/
+void SceneBenchmarks::RegisterImages(BenchmarkSuite& suite)
+{
+	for (size_t i = 0; i < m_images.size(); i++)
+	{
+		const IMAGE_FILE* pImage = &m_images[i];
+		suite.Register(std::string("BM_DecodeImage/") + pImage->filename, [pImage](BenchmarkState& state)
+		{
+			while (state.KeepRunning())
+			{
+				int width = 0;
+				int height = 0;
+				int channels = 0;
+				unsigned char* pPixels = stbi_load_from_memory(
+					pImage->bytes.data(), static_cast<int>(pImage->bytes.size()), &width, &height, &channels, 0);
+				DoNotOptimize(pPixels);
+				stbi_image_free(pPixels);
+			}
+		});
+	}
+}
+
+/***********************************************************
+ *  RegisterPicking()
+ *
+ *  This method is used for adding the benchmarks of picking
+ *  the object under the cursor, with rays spread over the
+ *  view of the scene and over a grid of about 100,000
+ *  boxes, spheres and cylinders of random sizes seen from
+ *  above at an angle.
+ ***********************************************************/
+void SceneBenchmarks::RegisterPicking(BenchmarkSuite& suite)
+{
+	SceneManager* pScene = m_pSceneManager;
+	ViewManager* pView = m_pViewManager;
+
+	std::vector<glm::vec3> sceneOrigins(g_PickRayCount);
+	std::vector<glm::vec3> sceneDirections(g_PickRayCount);
+	pView->UpdateCameraMatrices();
+	glm::mat4 inverseViewProjection = glm::inverse(pView->GetProjectionMatrix() * pView->GetViewMatrix());
+	for (int i = 0; i < g_PickRayCount; i++)
+	{
+		GetCameraRay(inverseViewProjection, 16, 16, (i % 16) + 0.5f, (i / 16) + 0.5f, sceneOrigins[i], sceneDirections[i]);
+	}
+
+	suite.Register("BM_PickObject/scene", [pScene, sceneOrigins, sceneDirections](BenchmarkState& state)
+	{
+		PICK_RESULT result;
+		SCENE_OBJECT object;
+		int ray = 0;
+		// the first pick captures the scene
+		pScene->PickObject(sceneOrigins[0], sceneDirections[0], result, object);
+		while (state.KeepRunning())
+		{
+			DoNotOptimize(pScene->PickObject(sceneOrigins[ray], sceneDirections[ray], result, object));
+			ray = (ray + 1) % g_PickRayCount;
+		}
+	});
+
+	GenerateShapeMesh(SHAPE_BOX, 0, m_boxMesh, NULL);
+	std::mt19937 random(1234u);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<PICK_OBJECT> objects(g_PickGridSide * g_PickGridSide);
+	for (int i = 0; i < static_cast<int>(objects.size()); i++)
+	{
+		glm::vec3 position(static_cast<float>(i % g_PickGridSide), 0.0f, static_cast<float>(i / g_PickGridSide));
+		glm::vec3 scale = glm::vec3(0.2f) + glm::vec3(unit(random), unit(random), unit(random)) * 0.25f;
+		PICK_OBJECT& object = objects[i];
+		object.shape = g_PickGridShapes[i % 3];
+		object.pMesh = (SHAPE_BOX == object.shape) ? &m_boxMesh : NULL;
+		object.model = glm::translate(position) * glm::rotate(unit(random) * 6.2831853f, glm::vec3(0.0f, 1.0f, 0.0f)) * glm::scale(scale);
+	}
+	m_pGridPicker = new ScenePicker(pScene->m_pThreadPool);
+	m_pGridPicker->Build(objects);
+
+	// from above one corner, looking across the grid
+	float side = static_cast<float>(g_PickGridSide);
+	glm::mat4 view = glm::lookAt(glm::vec3(-10.0f, 40.0f, -10.0f), glm::vec3(side * 0.5f, 0.0f, side * 0.5f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.25f, 0.1f, side * 2.0f);
+	inverseViewProjection = glm::inverse(projection * view);
+	std::vector<glm::vec3> gridOrigins(g_PickRayCount);
+	std::vector<glm::vec3> gridDirections(g_PickRayCount);
+	for (int i = 0; i < g_PickRayCount; i++)
+	{
+		GetCameraRay(inverseViewProjection, 16, 16, (i % 16) + 0.5f, (i / 16) + 0.5f, gridOrigins[i], gridDirections[i]);
+	}
+
+	const ScenePicker* pPicker = m_pGridPicker;
+	suite.Register("BM_PickObject/grid_100k", [pPicker, gridOrigins, gridDirections](BenchmarkState& state)
+	{
+		PICK_RESULT result;
+		int ray = 0;
+		while (state.KeepRunning())
+		{
+			DoNotOptimize(pPicker->Pick(gridOrigins[ray], gridDirections[ray], result));
+			ray = (ray + 1) % g_PickRayCount;
+		}
+	});
+}
+
+/***********************************************************
+ *  RegisterCollision()
+ *
+ *  This method is used for adding the benchmarks of keeping
+ *  the camera out of the objects, with short moves in the
+ *  view of the scene and among a grid of about 100,000
+ *  boxes of random sizes and turns, and of finding the
+ *  boxes around a point of that grid.
+ ***********************************************************/
+void SceneBenchmarks::RegisterCollision(BenchmarkSuite& suite)
+{
+	SceneManager* pScene = m_pSceneManager;
+	std::mt19937 random(4321u);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	// moves from along the view of the default camera, the way
+	// the keys move it
+	glm::vec3 cameraPosition = m_pViewManager->GetViewPosition();
+	std::vector<glm::vec3> sceneStarts(g_MoveCount);
+	std::vector<glm::vec3> sceneEnds(g_MoveCount);
+	for (int i = 0; i < g_MoveCount; i++)
+	{
+		glm::vec3 direction = glm::normalize(glm::vec3(unit(random) - 0.5f, -0.4f * unit(random), -1.0f));
+		sceneStarts[i] = cameraPosition + direction * (unit(random) * 12.0f);
+		sceneEnds[i] = sceneStarts[i] + direction * g_MoveLength;
+	}
+
+	suite.Register("BM_MoveSphere/scene", [pScene, sceneStarts, sceneEnds](BenchmarkState& state)
+	{
+		// the first call captures the scene
+		const SceneCollision& collision = pScene->GetCollision();
+		int move = 0;
+		while (state.KeepRunning())
+		{
+			DoNotOptimize(collision.MoveSphere(sceneStarts[move], sceneEnds[move], g_MoveRadius));
+			move = (move + 1) % g_MoveCount;
+		}
+	});
+
+	if (m_boxMesh.vertices.empty())
+	{
+		GenerateShapeMesh(SHAPE_BOX, 0, m_boxMesh, NULL);
+	}
+	std::vector<COLLISION_OBJECT> objects(g_PickGridSide * g_PickGridSide);
+	for (int i = 0; i < static_cast<int>(objects.size()); i++)
+	{
+		glm::vec3 position(static_cast<float>(i % g_PickGridSide), 0.0f, static_cast<float>(i / g_PickGridSide));
+		glm::vec3 scale = glm::vec3(0.2f) + glm::vec3(unit(random), unit(random), unit(random)) * 0.25f;
+		COLLISION_OBJECT& object = objects[i];
+		object.boundsMin = m_boxMesh.boundsMin;
+		object.boundsMax = m_boxMesh.boundsMax;
+		object.model = glm::translate(position) * glm::rotate(unit(random) * 6.2831853f, glm::vec3(0.0f, 1.0f, 0.0f)) * glm::scale(scale);
+	}
+	m_gridCollision.Build(objects);
+
+	// moves in every direction at the height of the boxes
+	float side = static_cast<float>(g_PickGridSide);
+	std::vector<glm::vec3> gridStarts(g_MoveCount);
+	std::vector<glm::vec3> gridEnds(g_MoveCount);
+	for (int i = 0; i < g_MoveCount; i++)
+	{
+		glm::vec3 direction = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) - 0.5f);
+		gridStarts[i] = glm::vec3(unit(random) * side, unit(random) * 0.5f, unit(random) * side);
+		gridEnds[i] = gridStarts[i] + direction * g_MoveLength;
+	}
+
+	const SceneCollision* pCollision = &m_gridCollision;
+	suite.Register("BM_MoveSphere/grid_100k", [pCollision, gridStarts, gridEnds](BenchmarkState& state)
+	{
+		int move = 0;
+		while (state.KeepRunning())
+		{
+			DoNotOptimize(pCollision->MoveSphere(gridStarts[move], gridEnds[move], g_MoveRadius));
+			move = (move + 1) % g_MoveCount;
+		}
+	});
+
+	suite.Register("BM_QuerySphere/grid_100k", [pCollision, gridStarts](BenchmarkState& state)
+	{
+		std::vector<int> overlapped;
+		int query = 0;
+		while (state.KeepRunning())
+		{
+			overlapped.clear();
+			pCollision->QuerySphere(gridStarts[query], g_QueryRadius, overlapped);
+			DoNotOptimize(overlapped.size());
+			query = (query + 1) % g_MoveCount;
+		}
+	});
+}
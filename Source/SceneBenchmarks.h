@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebenchmarks.h
+// ============
+// microbenchmarks of the scene and view hot paths
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Benchmark.h"
+#include "NullRenderBackend.h"
+#include "SceneCollision.h"
+#include "SceneManager.h"
+#include "ScenePicker.h"
+#include "ViewManager.h"
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SceneBenchmarks
+ *
+ *  This class prepares the scene on the null backend, so no
+ *  display or GPU is needed, and registers benchmarks of
+ *  the per-object calls of RenderScene(), the camera
+ *  matrices of PrepareSceneView(), the shape generation,
+ *  the decoding of the bundled texture images, and picking
+ *  objects and moving the camera through them in the scene
+ *  and in a large made up one.  The scene
+ *  is kept out of its baked state, so the object calls take
+ *  the path that sends the settings to the shader.
+ ***********************************************************/
+class SceneBenchmarks
+{
+public:
+	// constructor
+	SceneBenchmarks();
+	// destructor
+	~SceneBenchmarks();
+
+	// build the scene the benchmarks run against
+	bool Prepare();
+	// add the benchmarks to a suite
+	void Register(BenchmarkSuite& suite);
+
+private:
+	// an image file read into memory, decoded by a benchmark
+	struct IMAGE_FILE
+	{
+		std::string filename;
+		std::vector<unsigned char> bytes;
+	};
+
+	NullRenderBackend* m_pBackend;
+	SceneManager* m_pSceneManager;
+	ViewManager* m_pViewManager;
+	std::vector<IMAGE_FILE> m_images;
+	// a grid of many shapes to pick from, and the box mesh
+	// its boxes are tested against
+	ScenePicker* m_pGridPicker;
+	MESH_DATA m_boxMesh;
+	// a grid of as many boxes to move through
+	SceneCollision m_gridCollision;
+
+	void RegisterSceneCalls(BenchmarkSuite& suite);
+	void RegisterShapes(BenchmarkSuite& suite);
+	void RegisterImages(BenchmarkSuite& suite);
+	void RegisterPicking(BenchmarkSuite& suite);
+	void RegisterCollision(BenchmarkSuite& suite);
+};
@@ -0,0 +1,637 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenecollision.cpp
+// ============
+// overlap and sweep queries against the boxes of the scene objects
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneCollision.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// most cells the grid has for each object, so objects
+	// spread over a large space do not make a huge grid
+	const int g_CellsPerObject = 4;
+	// times a moving sphere slides along the boxes it touches
+	// before it stops
+	const int g_MaxSlides = 3;
+	// distance a moving sphere stops short of a box, so the
+	// next move does not start inside it
+	const float g_ContactSkin = 0.001f;
+	// times the boxes around a sphere are pushed out of
+	// again, since leaving one box can enter the next.  Most
+	// pushes settle in one or two, but a sphere between two
+	// close boxes goes back and forth for a few dozen
+	const int g_MaxPushPasses = 64;
+
+	/***********************************************************
+	 *  BoxesOverlap()
+	 *
+	 *  True when two world space boxes share any point.
+	 ***********************************************************/
+	bool BoxesOverlap(
+		const glm::vec3& minA,
+		const glm::vec3& maxA,
+		const glm::vec3& minB,
+		const glm::vec3& maxB)
+	{
+		return((minA.x <= maxB.x) && (maxA.x >= minB.x) &&
+			(minA.y <= maxB.y) && (maxA.y >= minB.y) &&
+			(minA.z <= maxB.z) && (maxA.z >= minB.z));
+	}
+
+	/***********************************************************
+	 *  SweepBall()
+	 *
+	 *  This function is used for finding where a sphere moving
+	 *  by motion from position first touches a point, as the
+	 *  share of the move made and the direction from the point
+	 *  to the sphere's center.  A sphere that starts on the
+	 *  point is left out.
+	 ***********************************************************/
+	bool SweepBall(
+		const glm::vec3& position,
+		const glm::vec3& motion,
+		const glm::vec3& center,
+		float radius,
+		float& t,
+		glm::vec3& normal)
+	{
+		glm::vec3 offset = position - center;
+		float a = glm::dot(motion, motion);
+		float b = glm::dot(offset, motion);
+		float c = glm::dot(offset, offset) - radius * radius;
+		if ((c <= 0.0f) || (b >= 0.0f) || (a <= 0.0f))
+		{
+			return(false);
+		}
+		float discriminant = b * b - a * c;
+		if (discriminant < 0.0f)
+		{
+			return(false);
+		}
+
+		t = (-b - std::sqrt(discriminant)) / a;
+		normal = (offset + motion * t) / radius;
+		return(true);
+	}
+
+	/***********************************************************
+	 *  SweepEdge()
+	 *
+	 *  This function is used for finding where a sphere moving
+	 *  by motion from position first touches the edge of a box
+	 *  along one axis, all in the box's frame.  The edge runs
+	 *  through corner, whose other coordinates pick which of
+	 *  the four it is.  Past either end of the edge the sphere
+	 *  meets the corner there instead.  A sphere that starts
+	 *  on the edge is left out.
+	 ***********************************************************/
+	bool SweepEdge(
+		const glm::vec3& position,
+		const glm::vec3& motion,
+		const glm::vec3& halfExtents,
+		float radius,
+		int axis,
+		const glm::vec3& corner,
+		float& t,
+		glm::vec3& normal)
+	{
+		// the side of the cylinder around the edge, across it
+		int axisA = (axis + 1) % 3;
+		int axisB = (axis + 2) % 3;
+		glm::vec2 offset(position[axisA] - corner[axisA], position[axisB] - corner[axisB]);
+		glm::vec2 across(motion[axisA], motion[axisB]);
+		float a = glm::dot(across, across);
+		float b = glm::dot(offset, across);
+		float c = glm::dot(offset, offset) - radius * radius;
+		t = 0.0f;
+		if (c > 0.0f)
+		{
+			float discriminant = b * b - a * c;
+			if ((b >= 0.0f) || (a <= 0.0f) || (discriminant < 0.0f))
+			{
+				return(false);
+			}
+			t = (-b - std::sqrt(discriminant)) / a;
+		}
+
+		float along = position[axis] + motion[axis] * t;
+		if (std::fabs(along) <= halfExtents[axis])
+		{
+			if (c <= 0.0f)
+			{
+				return(false);
+			}
+			glm::vec2 side = (offset + across * t) / radius;
+			normal = glm::vec3(0.0f);
+			normal[axisA] = side.x;
+			normal[axisB] = side.y;
+			return(true);
+		}
+
+		glm::vec3 vertex = corner;
+		vertex[axis] = (along > 0.0f) ? halfExtents[axis] : -halfExtents[axis];
+		return(SweepBall(position, motion, vertex, radius, t, normal));
+	}
+}
+
+/***********************************************************
+ *  SceneCollision()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneCollision::SceneCollision()
+{
+	m_gridMin = glm::vec3(0.0f);
+	m_inverseCellSize = 1.0f;
+	m_gridSize = glm::ivec3(0);
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for turning each object into an
+ *  oriented box and sorting the boxes into the grid.  The
+ *  cells are about as large as the average object, grown
+ *  until there are no more than a few for each object.  An
+ *  object is listed in every cell it covers.
+ ***********************************************************/
+void SceneCollision::Build(const std::vector<COLLISION_OBJECT>& objects)
+{
+	m_boxes.resize(objects.size());
+	m_cellStarts.clear();
+	m_cellObjects.clear();
+	m_gridSize = glm::ivec3(0);
+	if (objects.empty())
+	{
+		return;
+	}
+
+	glm::vec3 sceneMin(FLT_MAX);
+	glm::vec3 sceneMax(-FLT_MAX);
+	float extentSum = 0.0f;
+	size_t placedCount = 0;
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		const COLLISION_OBJECT& object = objects[i];
+		COLLISION_BOX& box = m_boxes[i];
+		// an object with no box covers no cells
+		box.firstCell = glm::ivec3(0);
+		box.lastCell = glm::ivec3(-1);
+		if (glm::any(glm::greaterThan(object.boundsMin, object.boundsMax)))
+		{
+			box.center = glm::vec3(0.0f);
+			box.halfExtents = glm::vec3(-1.0f);
+			continue;
+		}
+		glm::vec3 localCenter = (object.boundsMin + object.boundsMax) * 0.5f;
+		glm::vec3 localHalf = (object.boundsMax - object.boundsMin) * 0.5f;
+		box.center = glm::vec3(object.model * glm::vec4(localCenter, 1.0f));
+
+		// a flattened axis is at right angles to the others
+		float lengths[3];
+		int flatAxis = -1;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			glm::vec3 column = glm::vec3(object.model[axis]);
+			lengths[axis] = glm::length(column);
+			box.axes[axis] = (lengths[axis] > 0.0f) ? (column / lengths[axis]) : glm::vec3(0.0f);
+			flatAxis = (lengths[axis] > 0.0f) ? flatAxis : axis;
+		}
+		if (flatAxis >= 0)
+		{
+			glm::vec3 normal = glm::cross(box.axes[(flatAxis + 1) % 3], box.axes[(flatAxis + 2) % 3]);
+			float normalLength = glm::length(normal);
+			box.axes[flatAxis] = (normalLength > 0.0f) ? (normal / normalLength) : glm::vec3(0.0f);
+		}
+		box.halfExtents = localHalf * glm::vec3(lengths[0], lengths[1], lengths[2]);
+
+		glm::vec3 worldHalf =
+			glm::abs(box.axes[0]) * box.halfExtents.x +
+			glm::abs(box.axes[1]) * box.halfExtents.y +
+			glm::abs(box.axes[2]) * box.halfExtents.z;
+		box.boundsMin = box.center - worldHalf;
+		box.boundsMax = box.center + worldHalf;
+		sceneMin = glm::min(sceneMin, box.boundsMin);
+		sceneMax = glm::max(sceneMax, box.boundsMax);
+		extentSum += std::max(std::max(worldHalf.x, worldHalf.y), worldHalf.z) * 2.0f;
+		placedCount++;
+	}
+	if (0 == placedCount)
+	{
+		return;
+	}
+
+	glm::vec3 sceneSize = sceneMax - sceneMin;
+	float cellSize = std::max(extentSum / placedCount, 1.0e-3f);
+	double maxCells = static_cast<double>(placedCount) * g_CellsPerObject;
+	glm::vec3 cellCounts = glm::max(glm::ceil(sceneSize / cellSize), glm::vec3(1.0f));
+	while (static_cast<double>(cellCounts.x) * cellCounts.y * cellCounts.z > maxCells)
+	{
+		// a quarter larger each step, about half the cells
+		cellSize *= 1.25f;
+		cellCounts = glm::max(glm::ceil(sceneSize / cellSize), glm::vec3(1.0f));
+	}
+	m_gridMin = sceneMin;
+	m_inverseCellSize = 1.0f / cellSize;
+	m_gridSize = glm::ivec3(cellCounts);
+
+	// count the objects of each cell, then list them
+	size_t cellCount = static_cast<size_t>(m_gridSize.x) * m_gridSize.y * m_gridSize.z;
+	m_cellStarts.assign(cellCount + 1, 0);
+	for (size_t i = 0; i < m_boxes.size(); i++)
+	{
+		COLLISION_BOX& box = m_boxes[i];
+		if (box.halfExtents.x >= 0.0f)
+		{
+			GetCellRange(box.boundsMin, box.boundsMax, box.firstCell, box.lastCell);
+		}
+		for (int z = box.firstCell.z; z <= box.lastCell.z; z++)
+		{
+			for (int y = box.firstCell.y; y <= box.lastCell.y; y++)
+			{
+				for (int x = box.firstCell.x; x <= box.lastCell.x; x++)
+				{
+					m_cellStarts[x + m_gridSize.x * (y + m_gridSize.y * z) + 1]++;
+				}
+			}
+		}
+	}
+	for (size_t cell = 0; cell < cellCount; cell++)
+	{
+		m_cellStarts[cell + 1] += m_cellStarts[cell];
+	}
+
+	m_cellObjects.resize(m_cellStarts[cellCount]);
+	std::vector<uint32_t> cellFill(m_cellStarts.begin(), m_cellStarts.end() - 1);
+	for (size_t i = 0; i < m_boxes.size(); i++)
+	{
+		const COLLISION_BOX& box = m_boxes[i];
+		for (int z = box.firstCell.z; z <= box.lastCell.z; z++)
+		{
+			for (int y = box.firstCell.y; y <= box.lastCell.y; y++)
+			{
+				for (int x = box.firstCell.x; x <= box.lastCell.x; x++)
+				{
+					m_cellObjects[cellFill[x + m_gridSize.x * (y + m_gridSize.y * z)]++] = static_cast<uint32_t>(i);
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  IsEmpty()
+ *
+ *  This method is used for checking if there is anything
+ *  to collide with.
+ ***********************************************************/
+bool SceneCollision::IsEmpty() const
+{
+	return(m_boxes.empty());
+}
+
+/***********************************************************
+ *  GetCellRange()
+ *
+ *  This method is used for finding the first and last cell
+ *  along each axis that a world space box covers, clamped
+ *  to the grid.
+ ***********************************************************/
+bool SceneCollision::GetCellRange(
+	const glm::vec3& boundsMin,
+	const glm::vec3& boundsMax,
+	glm::ivec3& firstCell,
+	glm::ivec3& lastCell) const
+{
+	if (m_cellStarts.empty())
+	{
+		return(false);
+	}
+
+	glm::vec3 first = glm::floor((boundsMin - m_gridMin) * m_inverseCellSize);
+	glm::vec3 last = glm::floor((boundsMax - m_gridMin) * m_inverseCellSize);
+	glm::vec3 gridLast = glm::vec3(m_gridSize - glm::ivec3(1));
+	if (glm::any(glm::lessThan(last, glm::vec3(0.0f))) || glm::any(glm::greaterThan(first, gridLast)))
+	{
+		return(false);
+	}
+	firstCell = glm::ivec3(glm::clamp(first, glm::vec3(0.0f), gridLast));
+	lastCell = glm::ivec3(glm::clamp(last, glm::vec3(0.0f), gridLast));
+	return(true);
+}
+
+/***********************************************************
+ *  VisitBoxes()
+ *
+ *  This method is used for walking the cells a world space
+ *  box covers.  An object listed in several of them is
+ *  only visited from the first cell both cover, so no list
+ *  of the objects seen is needed.
+ ***********************************************************/
+template<typename BOX_VISITOR>
+void SceneCollision::VisitBoxes(const glm::vec3& boundsMin, const glm::vec3& boundsMax, BOX_VISITOR visitBox) const
+{
+	glm::ivec3 firstCell;
+	glm::ivec3 lastCell;
+	if (!GetCellRange(boundsMin, boundsMax, firstCell, lastCell))
+	{
+		return;
+	}
+
+	for (int z = firstCell.z; z <= lastCell.z; z++)
+	{
+		for (int y = firstCell.y; y <= lastCell.y; y++)
+		{
+			for (int x = firstCell.x; x <= lastCell.x; x++)
+			{
+				glm::ivec3 cell(x, y, z);
+				uint32_t cellIndex = x + m_gridSize.x * (y + m_gridSize.y * z);
+				for (uint32_t i = m_cellStarts[cellIndex]; i < m_cellStarts[cellIndex + 1]; i++)
+				{
+					uint32_t object = m_cellObjects[i];
+					const COLLISION_BOX& box = m_boxes[object];
+					if ((glm::max(box.firstCell, firstCell) == cell) &&
+						BoxesOverlap(box.boundsMin, box.boundsMax, boundsMin, boundsMax))
+					{
+						visitBox(object, box);
+					}
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  QueryBox()
+ *
+ *  This method is used for listing the objects whose world
+ *  space boxes overlap the passed box.
+ ***********************************************************/
+void SceneCollision::QueryBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<int>& objects) const
+{
+	VisitBoxes(boundsMin, boundsMax, [&](uint32_t object, const COLLISION_BOX&)
+	{
+		objects.push_back(static_cast<int>(object));
+	});
+}
+
+/***********************************************************
+ *  QuerySphere()
+ *
+ *  This method is used for listing the objects whose boxes
+ *  the sphere overlaps, by the distance from the center to
+ *  the closest point of each box.
+ ***********************************************************/
+void SceneCollision::QuerySphere(const glm::vec3& center, float radius, std::vector<int>& objects) const
+{
+	VisitBoxes(center - glm::vec3(radius), center + glm::vec3(radius), [&](uint32_t object, const COLLISION_BOX& box)
+	{
+		glm::vec3 offset = center - box.center;
+		float distanceSquared = 0.0f;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float along = glm::dot(offset, box.axes[axis]);
+			float outside = std::max(std::fabs(along) - box.halfExtents[axis], 0.0f);
+			distanceSquared += outside * outside;
+		}
+		if (distanceSquared <= radius * radius)
+		{
+			objects.push_back(static_cast<int>(object));
+		}
+	});
+}
+
+/***********************************************************
+ *  SweepSphere()
+ *
+ *  This method is used for finding the first box a moving
+ *  sphere touches.  The move is taken into the space of
+ *  each box the cells along it hold.  A slab test against
+ *  the box grown by the radius finds where the sphere's
+ *  center could first touch, and that point shows whether
+ *  it is across a face or past an edge or a corner, where
+ *  the grown box is rounded.  Those are tested again
+ *  against the cylinders around the edges and the balls
+ *  around the corners.
+ ***********************************************************/
+bool SceneCollision::SweepSphere(const glm::vec3& start, const glm::vec3& end, float radius, SWEEP_HIT& hit) const
+{
+	hit.object = -1;
+	hit.t = 1.0f;
+	glm::vec3 motion = end - start;
+	glm::vec3 reach(radius);
+
+	VisitBoxes(glm::min(start, end) - reach, glm::max(start, end) + reach, [&](uint32_t object, const COLLISION_BOX& box)
+	{
+		glm::vec3 offset = start - box.center;
+		glm::vec3 grown = box.halfExtents + reach;
+		glm::vec3 position;
+		glm::vec3 direction;
+		float entry = -FLT_MAX;
+		float exit = FLT_MAX;
+		int entryAxis = -1;
+		float entrySide = 0.0f;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			position[axis] = glm::dot(offset, box.axes[axis]);
+			direction[axis] = glm::dot(motion, box.axes[axis]);
+			if (direction[axis] == 0.0f)
+			{
+				if (std::fabs(position[axis]) > grown[axis])
+				{
+					return;
+				}
+				continue;
+			}
+			// the side facing the move is entered first
+			float side = (direction[axis] > 0.0f) ? -1.0f : 1.0f;
+			float entering = (side * grown[axis] - position[axis]) / direction[axis];
+			float leaving = (-side * grown[axis] - position[axis]) / direction[axis];
+			if (entering > entry)
+			{
+				entry = entering;
+				entryAxis = axis;
+				entrySide = side;
+			}
+			exit = std::min(exit, leaving);
+		}
+		if ((entry > exit) || (exit < 0.0f) || (entry >= hit.t))
+		{
+			return;
+		}
+
+		// the axes the center is beyond the box on where it
+		// first reaches the grown box, or where it starts
+		bool bStartsInside = (entry < 0.0f);
+		entry = std::max(entry, 0.0f);
+		glm::vec3 point = position + direction * entry;
+		glm::vec3 corner(0.0f);
+		int outsideCount = 0;
+		int insideAxis = 0;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (std::fabs(point[axis]) > box.halfExtents[axis])
+			{
+				corner[axis] = (point[axis] > 0.0f) ? box.halfExtents[axis] : -box.halfExtents[axis];
+				outsideCount++;
+			}
+			else
+			{
+				insideAxis = axis;
+			}
+		}
+
+		float t = entry;
+		glm::vec3 normal(0.0f);
+		if (outsideCount <= 1)
+		{
+			// across a face - a start here already overlaps
+			if (bStartsInside || (entryAxis < 0))
+			{
+				return;
+			}
+			normal[entryAxis] = entrySide;
+		}
+		else if (outsideCount == 2)
+		{
+			if (!SweepEdge(position, direction, box.halfExtents, radius, insideAxis, corner, t, normal))
+			{
+				return;
+			}
+		}
+		else
+		{
+			// past a corner, touching one of its three edges or
+			// the corner itself
+			t = FLT_MAX;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float edgeT = 0.0f;
+				glm::vec3 edgeNormal;
+				if (SweepEdge(position, direction, box.halfExtents, radius, axis, corner, edgeT, edgeNormal) && (edgeT < t))
+				{
+					t = edgeT;
+					normal = edgeNormal;
+				}
+			}
+		}
+		if (t >= hit.t)
+		{
+			return;
+		}
+
+		hit.object = static_cast<int>(object);
+		hit.t = t;
+		hit.normal = box.axes[0] * normal.x + box.axes[1] * normal.y + box.axes[2] * normal.z;
+	});
+
+	if (hit.object < 0)
+	{
+		return(false);
+	}
+	hit.position = start + motion * hit.t;
+	return(true);
+}
+
+/***********************************************************
+ *  PushSphereOut()
+ *
+ *  This method is used for moving a sphere out of the
+ *  boxes it overlaps, the shortest way out of each.  A
+ *  center inside a box leaves through its nearest face.
+ *  Leaving one box can enter another, so the boxes around
+ *  where the sphere has got to are gone through again
+ *  until none moves it.  A sphere wedged where it cannot
+ *  fit may still touch one when the passes run out.
+ ***********************************************************/
+glm::vec3 SceneCollision::PushSphereOut(const glm::vec3& center, float radius) const
+{
+	glm::vec3 position = center;
+	glm::vec3 reach(radius);
+
+	bool bPushed = true;
+	for (int pass = 0; (pass < g_MaxPushPasses) && bPushed; pass++)
+	{
+		bPushed = false;
+		VisitBoxes(position - reach, position + reach, [&](uint32_t, const COLLISION_BOX& box)
+		{
+			glm::vec3 offset = position - box.center;
+			glm::vec3 local;
+			glm::vec3 closest;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				local[axis] = glm::dot(offset, box.axes[axis]);
+				closest[axis] = glm::clamp(local[axis], -box.halfExtents[axis], box.halfExtents[axis]);
+			}
+			glm::vec3 away = local - closest;
+			float distance = glm::length(away);
+			if (distance >= radius)
+			{
+				return;
+			}
+
+			glm::vec3 push(0.0f);
+			if (distance > 0.0f)
+			{
+				push = away * ((radius + g_ContactSkin - distance) / distance);
+			}
+			else
+			{
+				int nearestAxis = 0;
+				for (int axis = 1; axis < 3; axis++)
+				{
+					float depth = box.halfExtents[axis] - std::fabs(local[axis]);
+					float nearestDepth = box.halfExtents[nearestAxis] - std::fabs(local[nearestAxis]);
+					nearestAxis = (depth < nearestDepth) ? axis : nearestAxis;
+				}
+				float depth = box.halfExtents[nearestAxis] - std::fabs(local[nearestAxis]);
+				push[nearestAxis] = ((local[nearestAxis] >= 0.0f) ? 1.0f : -1.0f) * (depth + radius + g_ContactSkin);
+			}
+			bPushed = true;
+			position += box.axes[0] * push.x + box.axes[1] * push.y + box.axes[2] * push.z;
+		});
+	}
+
+	return(position);
+}
+
+/***********************************************************
+ *  MoveSphere()
+ *
+ *  This method is used for moving a sphere as far as it
+ *  goes towards the end before touching a box, then on
+ *  along the surface it touched with what is left of the
+ *  move, a few times over so it follows a corner.  A
+ *  sphere that starts in a box is pushed out first, and
+ *  the move is made from there.
+ ***********************************************************/
+glm::vec3 SceneCollision::MoveSphere(const glm::vec3& start, const glm::vec3& end, float radius) const
+{
+	glm::vec3 position = PushSphereOut(start, radius);
+	glm::vec3 target = end + (position - start);
+	for (int slide = 0; slide < g_MaxSlides; slide++)
+	{
+		SWEEP_HIT hit;
+		if (!SweepSphere(position, target, radius, hit))
+		{
+			return(target);
+		}
+
+		glm::vec3 motion = target - position;
+		float length = glm::length(motion);
+		float t = std::max(hit.t - g_ContactSkin / length, 0.0f);
+		position += motion * t;
+
+		// the rest of the move, less what goes into the face
+		glm::vec3 rest = target - position;
+		target = position + rest - hit.normal * glm::dot(rest, hit.normal);
+	}
+	return(position);
+}
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenecollision.h
+// ============
+// overlap and sweep queries against the boxes of the scene objects
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  COLLISION_OBJECT
+ *
+ *  One object that can be collided with: the box around
+ *  its mesh in object space and where it is placed.  The
+ *  transform is expected to rotate and scale, with no
+ *  shear, as SetTransformations() makes them.  A box with
+ *  its minimum above its maximum is never hit.
+ ***********************************************************/
+struct COLLISION_OBJECT
+{
+	glm::mat4 model;
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+};
+
+/***********************************************************
+ *  SWEEP_HIT
+ *
+ *  The first box a moving sphere touches.
+ ***********************************************************/
+struct SWEEP_HIT
+{
+	// index in the list passed to Build()
+	int object;
+	// share of the move made before the touch
+	float t;
+	// center of the sphere as it touches
+	glm::vec3 position;
+	// face of the box touched, pointing out of it
+	glm::vec3 normal;
+};
+
+/***********************************************************
+ *  SceneCollision
+ *
+ *  This class answers which objects a box or a sphere
+ *  overlaps and where a moving sphere first touches one,
+ *  for keeping the camera out of the scene and for any
+ *  other system that needs it.  Each object is an oriented
+ *  box, and the boxes are sorted into a uniform grid of
+ *  cells about the size of an object, so a query only
+ *  looks at the few objects in the cells it covers.  A
+ *  moving sphere is tested against each box grown by its
+ *  radius, with the edges and corners rounded as the
+ *  sphere rounds them.  The sphere's radius must be above
+ *  zero.
+ ***********************************************************/
+class SceneCollision
+{
+public:
+	// constructor
+	SceneCollision();
+
+	// place the objects in the grid
+	void Build(const std::vector<COLLISION_OBJECT>& objects);
+	bool IsEmpty() const;
+
+	// objects whose world space boxes overlap the box, added
+	// to the list
+	void QueryBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<int>& objects) const;
+	// objects whose boxes the sphere overlaps, added to the
+	// list
+	void QuerySphere(const glm::vec3& center, float radius, std::vector<int>& objects) const;
+	// first box a sphere moving from start to end touches -
+	// boxes the sphere starts in are left out, so it can
+	// always move out of them
+	bool SweepSphere(const glm::vec3& start, const glm::vec3& end, float radius, SWEEP_HIT& hit) const;
+	// move a sphere out of the boxes it overlaps and return
+	// where it ends up
+	glm::vec3 PushSphereOut(const glm::vec3& center, float radius) const;
+	// move a sphere from start towards end, sliding along the
+	// boxes it touches, and return where it stops - a sphere
+	// that starts in a box is pushed out of it first
+	glm::vec3 MoveSphere(const glm::vec3& start, const glm::vec3& end, float radius) const;
+
+private:
+	// an object's box, with the cells it covers
+	struct COLLISION_BOX
+	{
+		glm::vec3 center;
+		// unit axes of the box, and its half size along each
+		glm::vec3 axes[3];
+		glm::vec3 halfExtents;
+		// world space box around it
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+		glm::ivec3 firstCell;
+		glm::ivec3 lastCell;
+	};
+
+	std::vector<COLLISION_BOX> m_boxes;
+	// corner and size of the grid, in cells of equal size
+	glm::vec3 m_gridMin;
+	float m_inverseCellSize;
+	glm::ivec3 m_gridSize;
+	// the objects of each cell, from m_cellStarts[cell] up to
+	// m_cellStarts[cell + 1]
+	std::vector<uint32_t> m_cellStarts;
+	std::vector<uint32_t> m_cellObjects;
+
+	// cells covering a world space box - returns false when it
+	// is outside the grid
+	bool GetCellRange(
+		const glm::vec3& boundsMin,
+		const glm::vec3& boundsMax,
+		glm::ivec3& firstCell,
+		glm::ivec3& lastCell) const;
+	// call visitBox once for every object whose world space box
+	// overlaps the passed one
+	template<typename BOX_VISITOR>
+	void VisitBoxes(const glm::vec3& boundsMin, const glm::vec3& boundsMax, BOX_VISITOR visitBox) const;
+};
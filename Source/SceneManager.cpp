@@ -1,957 +1,2413 @@
-///////////////////////////////////////////////////////////////////////////////
-// shadermanager.cpp
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "SceneManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
-
-#include <glm/gtx/transform.hpp>
-
-// declaration of global variables
-namespace
-{
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
-}
-
-/***********************************************************
- *  SceneManager()
- *
- *  The constructor for the class
- ***********************************************************/
-SceneManager::SceneManager(ShaderManager *pShaderManager)
-{
-	m_pShaderManager = pShaderManager;
-	m_basicMeshes = new ShapeMeshes();
-}
-
-/***********************************************************
- *  ~SceneManager()
- *
- *  The destructor for the class
- ***********************************************************/
-SceneManager::~SceneManager()
-{
-	m_pShaderManager = NULL;
-	delete m_basicMeshes;
-	m_basicMeshes = NULL;
-}
-
-/***********************************************************
- *  CreateGLTexture()
- *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
- ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
-{
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
-	}
-
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
-}
-
-/***********************************************************
- *  BindGLTextures()
- *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
- ***********************************************************/
-void SceneManager::BindGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  DestroyGLTextures()
- *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
- ***********************************************************/
-void SceneManager::DestroyGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  FindTextureID()
- *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
-{
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
-}
-
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureSlot);
-}
-
-/***********************************************************
- *  FindMaterial()
- *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
- ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
-{
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.ambientColor = m_objectMaterials[index].ambientColor;
-			material.ambientStrength = m_objectMaterials[index].ambientStrength;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return(true);
-}
-
-/***********************************************************
- *  SetTransformations()
- *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
- ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationZ * rotationY * rotationX * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
-}
-
-/***********************************************************
- *  SetShaderColor()
- *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
- ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
-{
-	// variables for this method
-	glm::vec4 currentColor;
-
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
-}
-
-/***********************************************************
- *  SetShaderTexture()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
-
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
-}
-
-/***********************************************************
- *  SetTextureUVScale()
- *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
- ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
-}
-
-/***********************************************************
- *  LoadSceneTextures()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene
- *  rendering
- ***********************************************************/
-void SceneManager::LoadSceneTextures()
-{
-	bool bReturn = false;
-
-	//Function to load textures into memory.
-	bReturn = CreateGLTexture(
-		"desktop.jpg",
-		"desktop");
-
-	bReturn = CreateGLTexture(
-		"tab.png",
-		"tab");
-
-	bReturn = CreateGLTexture(
-		"table.png",
-		"table");
-
-	// afer the texture image data is loaded into memory, the
-	// loaded textures need to be bound to texture slots - there
-	// are a total of 16 available slots for scene textures
-	BindGLTextures();
-}
-
-/***********************************************************
- *  SetShaderMaterial()
- *
- *  This method is used for passing the material values
- *  into the shader.
- ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
-{
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
-	}
-}
-
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
-/**************************************************************/
-
- /***********************************************************
-  *  DefineObjectMaterials()
-  *
-  *  This method is used for configuring the various material
-  *  settings for all of the objects within the 3D scene.
-  ***********************************************************/
-
-void SceneManager::DefineObjectMaterials()
-{
-	//Makes a non reflective material for the tabletop since it's wooden. 
-	OBJECT_MATERIAL tableMaterial;
-	tableMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	tableMaterial.ambientStrength = 0.5f;
-	tableMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.3f);
-	tableMaterial.specularColor = glm::vec3(0.8f, 0.8f, 1.0f);
-	tableMaterial.shininess = 1.0;
-	tableMaterial.tag = "table";
-	m_objectMaterials.push_back(tableMaterial);
-
-	//Makes a black pastic material for the monitor's black plastic parts.
-	OBJECT_MATERIAL blackPlasticMaterial;
-	blackPlasticMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	blackPlasticMaterial.ambientStrength = 0.1f;
-	blackPlasticMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	blackPlasticMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	blackPlasticMaterial.shininess = 32.0;
-	blackPlasticMaterial.tag = "blackPlastic";
-	m_objectMaterials.push_back(blackPlasticMaterial);
-
-	//Makes a grey plastic material for the legs and base of the monitor.
-	OBJECT_MATERIAL greyPlasticMaterial;
-	greyPlasticMaterial.ambientColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	greyPlasticMaterial.ambientStrength = 0.3f;
-	greyPlasticMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	greyPlasticMaterial.specularColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	greyPlasticMaterial.shininess = 32.0;
-	greyPlasticMaterial.tag = "greyPlastic";
-	m_objectMaterials.push_back(greyPlasticMaterial);
-
-	//Makes a reflective material for the monitor's screen. 
-	OBJECT_MATERIAL screenMaterial;
-	screenMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	screenMaterial.ambientStrength = 0.8f;
-	screenMaterial.diffuseColor = glm::vec3(0.4f, 0.4f, 0.5f);
-	screenMaterial.specularColor = glm::vec3(1.0f, 1.0f, 1.0f);
-	screenMaterial.shininess = 256.0f;
-	screenMaterial.tag = "screen";
-	m_objectMaterials.push_back(screenMaterial);
-}
-
-/***********************************************************
- *  SetupSceneLights()
- *
- *  This method is called to add and configure the light
- *  sources for the 3D scene.  There are up to 4 light sources.
- ***********************************************************/
-void SceneManager::SetupSceneLights()
-{
-	//Configures light source and its params to best suite scene. 
-	m_pShaderManager->setVec3Value("lightSources[0].position", 0.0f, 8.0f, 10.0f);
-	m_pShaderManager->setVec3Value("lightSources[0].ambientColor", 0.01f, 0.01f, 0.01f);
-	m_pShaderManager->setVec3Value("lightSources[0].diffuseColor", 0.4f, 0.4f, 0.4f);
-	m_pShaderManager->setVec3Value("lightSources[0].specularColor", 0.0f, 0.0f, 0.0f);
-	m_pShaderManager->setFloatValue("lightSources[0].focalStrength", 32.0f);
-	m_pShaderManager->setFloatValue("lightSources[0].specularIntensity", 0.05f);
-
-	m_pShaderManager->setVec3Value("lightSources[1].position", 0.0f, 4.0f, 8.0f);
-	m_pShaderManager->setVec3Value("lightSources[1].ambientColor", 0.1f, 0.0f, 0.15f);
-	m_pShaderManager->setVec3Value("lightSources[1].diffuseColor", 0.2f, 0.0f, 0.25f);
-	m_pShaderManager->setVec3Value("lightSources[1].specularColor", 0.0f, 0.0f, 0.0f);
-	m_pShaderManager->setFloatValue("lightSources[1].focalStrength", 32.0f);
-	m_pShaderManager->setFloatValue("lightSources[1].specularIntensity", 0.05f);
-
-
-	//Enables lighting to be used in the scene. 
-	m_pShaderManager->setBoolValue("bUseLighting", true);
-}
-
-/***********************************************************
- *  PrepareScene()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void SceneManager::PrepareScene()
-{
-	// load the textures for the 3D scene
-	LoadSceneTextures();
-	DefineObjectMaterials();
-	SetupSceneLights();
-
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadBoxMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadPrismMesh();
-	m_basicMeshes->LoadSphereMesh();
-	m_basicMeshes->LoadTorusMesh();
-}
-
-/***********************************************************
- *  RenderScene()
- *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
- ***********************************************************/
-void SceneManager::RenderScene()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//SetShaderColor(1, 1, 1, 1);
-	//Applies a texture
-	SetShaderTexture("table");
-	//Sets the shader material.
-	SetShaderMaterial("table");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	//Deactivate textures so that other objects don't receive wood texture.
-	m_pShaderManager->setIntValue("bUseTexture", false);
-	/****************************************************************/
-
-	//Student's code starts below: 
-
-	//First draw the base of the monitor stand:
-
-	//Determine size
-	glm::vec3 baseCylinderScaleXYZ = glm::vec3(1.0f, .5f, 1.0f);
-	float baseCylinderRadius = baseCylinderScaleXYZ.x;
-	//Determine rotation
-	float baseCylinderXrotationDegrees = 0.0f;
-	float baseCylinderYrotationDegrees = 0.0f;
-	float baseCylinderZrotationDegrees = 0.0f;
-	//Determine position
-	glm::vec3 baseCylinderPositionXYZ = glm::vec3(0.0f, 1.0f, 3.0f);
-	//Determine color: grey
-	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	//Sets shader material. 
-	SetShaderMaterial("greyPlastic");
-	//Confirm transformations
-	SetTransformations(
-		baseCylinderScaleXYZ,
-		baseCylinderXrotationDegrees,
-		baseCylinderYrotationDegrees,
-		baseCylinderZrotationDegrees,
-		baseCylinderPositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawCylinderMesh();
-
-	//Create the monitor stand's legs: 
-
-	//Leg 1: 
-
-	//Determine size
-	glm::vec3 prong1ScaleXYZ = glm::vec3(.2f, .2f, 2.6f);
-	//Determine position
-	glm::vec3 prong1PositionXYZ = baseCylinderPositionXYZ;
-	prong1PositionXYZ.x -= 1.8f;
-	prong1PositionXYZ.z += 1.0f;
-	prong1PositionXYZ.y -= 0.3f;
-	//Determine rotation
-	float prong1XrotationDegrees = 30.0f;
-	float prong1YrotationDegrees = -60.0f;
-	float prong1ZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	//Sets shader material. 
-	SetShaderMaterial("greyPlastic");
-
-	//Confirm transformations
-	SetTransformations(
-		prong1ScaleXYZ,
-		prong1XrotationDegrees,
-		prong1YrotationDegrees,
-		prong1ZrotationDegrees,
-		prong1PositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawBoxMesh();
-
-	//Leg 2: 
-
-	//Determine size
-	glm::vec3 prong2ScaleXYZ = glm::vec3(.2f, .2f, 2.6f);
-	//Determine position
-	glm::vec3 prong2PositionXYZ = baseCylinderPositionXYZ;
-	prong2PositionXYZ.x += 1.8f;
-	prong2PositionXYZ.z += 1.0f;
-	prong2PositionXYZ.y -= 0.3f;
-	//Determine rotation
-	float prong2XrotationDegrees = 30.0f;
-	float prong2YrotationDegrees = 60.0f;
-	float prong2ZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	//Sets shader material. 
-	SetShaderMaterial("greyPlastic");
-	//Confirm transformations
-	SetTransformations(
-		prong2ScaleXYZ,
-		prong2XrotationDegrees,
-		prong2YrotationDegrees,
-		prong2ZrotationDegrees,
-		prong2PositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawBoxMesh();
-
-	//Leg 3: 
-
-	//Determine size
-	glm::vec3 prong3ScaleXYZ = glm::vec3(.2f, .2f, 1.8f);
-	//Determine position
-	glm::vec3 prong3PositionXYZ = baseCylinderPositionXYZ;
-	prong3PositionXYZ.z -= 1.5;
-	prong3PositionXYZ.y -= 0.3f;
-	//Determine rotation
-	float prong3XrotationDegrees = -45.0f;
-	float prong3YrotationDegrees = 0.0f;
-	float prong3ZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	//Sets shader material. 
-	SetShaderMaterial("greyPlastic");
-	//Confirm transformations
-	SetTransformations(
-		prong3ScaleXYZ,
-		prong3XrotationDegrees,
-		prong3YrotationDegrees,
-		prong3ZrotationDegrees,
-		prong3PositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawBoxMesh();
-
-	//Now draw monitor stand post:
-
-	//Determine size
-	glm::vec3 postScaleXYZ = glm::vec3(baseCylinderScaleXYZ.x - .2f, 4.0f, 1.0f);
-	//Determine position
-	glm::vec3 postPositionXYZ = baseCylinderPositionXYZ;
-	postPositionXYZ.y += postScaleXYZ.y / 2;
-	//Determine rotation
-	float postXrotationDegrees = 0.0f;
-	float postYrotationDegrees = 0.0f;
-	float postZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(0.7f, 0.7f, 0.7f, 1.0f);
-	//Sets shader material. 
-	SetShaderMaterial("greyPlastic");
-	//Confirm transformations
-	SetTransformations(
-		postScaleXYZ,
-		postXrotationDegrees,
-		postYrotationDegrees,
-		postZrotationDegrees,
-		postPositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawBoxMesh();
-
-	//Now draw monitor:
-
-	//Determine size
-	glm::vec3 monitorScaleXYZ = glm::vec3(8.0f, 4.0f, 1.0f);
-	//Determine position
-	glm::vec3 monitorPositionXYZ = postPositionXYZ;
-	monitorPositionXYZ.y += postScaleXYZ.y/2;
-	monitorPositionXYZ.z += .1f;
-	//Determine rotation
-	float monitorXrotationDegrees = 0.0f;
-	float monitorYrotationDegrees = 0.0f;
-	float monitorZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(.2f, .2f, .2f, 1.0f);
-	//Sets shader material.
-	SetShaderMaterial("blackPlastic");
-	//Confirm transformations
-	SetTransformations(
-		monitorScaleXYZ,
-		monitorXrotationDegrees,
-		monitorYrotationDegrees,
-		monitorZrotationDegrees,
-		monitorPositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawBoxMesh();
-
-	//Draw screen:
-
-	//Determine size
-	glm::vec3 screenScaleXYZ = glm::vec3(3.5f, 0.0f, 1.7f);
-	//Determine position
-	glm::vec3 screenPositionXYZ = monitorPositionXYZ;
-	screenPositionXYZ.z += 0.567f;
-	//Determine rotation
-	float screenXrotationDegrees = 90.0f;
-	float screenYrotationDegrees = 0.0f;
-	float screenZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(.9f, .9f, .9f, 1.0f);
-	//Set Texture
-	//Reactivate textures to apply them to current and future objects. 
-	m_pShaderManager->setIntValue("bUseTexture", true);
-	SetShaderTexture("desktop");
-	//Sets shader material. 
-	SetShaderMaterial("screen");
-	//Confirm transformations
-	SetTransformations(
-		screenScaleXYZ,
-		screenXrotationDegrees,
-		screenYrotationDegrees,
-		screenZrotationDegrees,
-		screenPositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawPlaneMesh();
-
-	// Determine size for the second texture (scaled down three times smaller)
-	glm::vec3 smallScreenScaleXYZ = screenScaleXYZ / 3.0f; // Divide the original size by 3
-
-	// Determine position for the second texture (adjust it to be on top of the first texture)
-	glm::vec3 smallScreenPositionXYZ = screenPositionXYZ;
-	// Adjust position slightly in the z-axis to layer it on top
-	smallScreenPositionXYZ.z += 0.01f; // Slightly closer to the camera to prevent z-fighting
-	smallScreenPositionXYZ.x -= 1.7f;
-	smallScreenPositionXYZ.y -= 1.0f;
-
-	// Set texture for the smaller texture
-	SetShaderTexture("tab");
-
-	//Sets shader material. 
-	SetShaderMaterial("screen");
-
-	// Confirm transformations for the smaller texture
-	SetTransformations(
-		smallScreenScaleXYZ,
-		screenXrotationDegrees,
-		screenYrotationDegrees,
-		screenZrotationDegrees,
-		smallScreenPositionXYZ
-	);
-
-	// Draw the smaller texture mesh
-	m_basicMeshes->DrawPlaneMesh();
-
-	//Now draw keyboard: 
-
-	//Determine size
-	glm::vec3 keyboardScaleXYZ = glm::vec3(6.0f, .2f, 1.5f);
-	//Determine position
-	glm::vec3 keyboardPositionXYZ = glm::vec3(0.0f, 0.0f, 7.0f);
-	//Determine rotation
-	float keyboardXrotationDegrees = 0.0f;
-	float keyboardYrotationDegrees = 0.0f;
-	float keyboardZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	//Sets matertial
-	m_pShaderManager->setIntValue("bUseTexture", false);
-	SetShaderMaterial("blackPlastic");
-	//Confirm transformations
-	SetTransformations(
-		keyboardScaleXYZ,
-		keyboardXrotationDegrees,
-		keyboardYrotationDegrees,
-		keyboardZrotationDegrees,
-		keyboardPositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawBoxMesh();
-
-	// Determine size of keys
-	glm::vec3 keyScaleXYZ = glm::vec3(0.2f, 0.2f, 0.2f);
-
-	// Calculate number of keys horizontally and vertically
-	int horizontalSpace = static_cast<int>(keyboardScaleXYZ.x / (keyScaleXYZ.x + 0.1f));
-	int verticalSpace = static_cast<int>(keyboardScaleXYZ.z / (keyScaleXYZ.z + 0.1f));
-
-	// Draw keys
-	for (int v = 0; v < verticalSpace; v++) {
-		for (int h = 0; h < horizontalSpace; h++) {
-			// Calculate position for each key
-			glm::vec3 keyPositionXYZ = keyboardPositionXYZ;
-			keyPositionXYZ.y += 0.1f; // Slightly above keyboard
-			keyPositionXYZ.x = keyboardPositionXYZ.x - ((keyboardScaleXYZ.x / 2) - .15f) + ((keyScaleXYZ.x + 0.1f) * h);
-			keyPositionXYZ.z = keyboardPositionXYZ.z - ((keyboardScaleXYZ.z / 2) - .15f) + ((keyScaleXYZ.z + 0.1f) * v);
-
-			// Apply transformations
-			SetTransformations(
-				keyScaleXYZ,
-				0.0f, 0.0f, 0.0f,
-				keyPositionXYZ
-			);
-
-			// Draw key
-			//SetShaderColor(0.6f, 0.6f, 0.6f, 1.0f);
-			//Sets matertial
-			SetShaderMaterial("blackPlastic");
-			m_basicMeshes->DrawBoxMesh();
-		}
-	}
-
-	//Draw mouse. 
-
-	//Determine size
-	glm::vec3 mouseScaleXYZ = glm::vec3(0.4f, 0.2f, 0.7f);
-	//Determine position
-	glm::vec3 mousePositionXYZ = glm::vec3(4.0f, 0.0f, 9.0f);
-	//Determine rotation
-	float mouseXrotationDegrees = 0.0f;
-	float mouseYrotationDegrees = 0.0f;
-	float mouseZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	//Sets matertial
-	SetShaderMaterial("blackPlastic");
-	//Confirm transformations
-	SetTransformations(
-		mouseScaleXYZ,
-		mouseXrotationDegrees,
-		mouseYrotationDegrees,
-		mouseZrotationDegrees,
-		mousePositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawHalfSphereMesh();
-
-	//Draw the speakers. 
-
-	//Speaker 1:
-
-	//Draw the speaker base:
-	//Determine size
-	glm::vec3 speaker1ScaleXYZ = glm::vec3(.64f, 1.2f, .5f);
-	//Determine position
-	glm::vec3 speaker1PositionXYZ = glm::vec3(-4.0f, 0.1f, 6.0f);
-	//Determine rotation
-	float speaker1XrotationDegrees = 90.0f;
-	float speaker1YrotationDegrees = 0.0f;
-	float speaker1ZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	//Sets matertial
-	SetShaderMaterial("blackPlastic");
-	//Confirm transformations
-	SetTransformations(
-		speaker1ScaleXYZ,
-		speaker1XrotationDegrees,
-		speaker1YrotationDegrees,
-		speaker1ZrotationDegrees,
-		speaker1PositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawTorusMesh();
-
-	//Draw the speaker body:
-	//Determine size
-	glm::vec3 speakerBase1ScaleXYZ = glm::vec3(.7f, 3.f, .9f);
-	//Determine position
-	glm::vec3 speakerBase1PositionXYZ = speaker1PositionXYZ;
-	speakerBase1PositionXYZ.y += .07f;
-	speakerBase1PositionXYZ.z += .3f;
-	//Determine rotation
-	float speakerBase1XrotationDegrees = 0.0f;
-	float speakerBase1YrotationDegrees = 0.0f;
-	float speakerBase1ZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	//Sets matertial
-	SetShaderMaterial("blackPlastic");
-	//Confirm transformations
-	SetTransformations(
-		speakerBase1ScaleXYZ,
-		speakerBase1XrotationDegrees,
-		speakerBase1YrotationDegrees,
-		speakerBase1ZrotationDegrees,
-		speakerBase1PositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawCylinderMesh();
-
-	//Speaker 2:
-
-	//Draw the speaker base:
-	//Determine size
-	glm::vec3 speaker2ScaleXYZ = glm::vec3(.64f, 1.2f, .5f);
-	//Determine position
-	glm::vec3 speaker2PositionXYZ = glm::vec3(4.0f, 0.1f, 6.0f);
-	//Determine rotation
-	float speaker2XrotationDegrees = 90.0f;
-	float speaker2YrotationDegrees = 0.0f;
-	float speaker2ZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	//Sets matertial
-	SetShaderMaterial("blackPlastic");
-	//Confirm transformations
-	SetTransformations(
-		speaker2ScaleXYZ,
-		speaker2XrotationDegrees,
-		speaker2YrotationDegrees,
-		speaker2ZrotationDegrees,
-		speaker2PositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawTorusMesh();
-
-	//Draw the speaker body:
-	//Determine size
-	glm::vec3 speakerBase2ScaleXYZ = glm::vec3(.7f, 3.f, .9f);
-	//Determine position
-	glm::vec3 speakerBase2PositionXYZ = speaker2PositionXYZ;
-	speakerBase2PositionXYZ.y += .07f;
-	speakerBase2PositionXYZ.z += .3f;
-	//Determine rotation
-	float speakerBase2XrotationDegrees = 0.0f;
-	float speakerBase2YrotationDegrees = 0.0f;
-	float speakerBase2ZrotationDegrees = 0.0f;
-	//Determine color: grey
-	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	//Sets matertial
-	SetShaderMaterial("blackPlastic");
-	//Confirm transformations
-	SetTransformations(
-		speakerBase2ScaleXYZ,
-		speakerBase2XrotationDegrees,
-		speakerBase2YrotationDegrees,
-		speakerBase2ZrotationDegrees,
-		speakerBase2PositionXYZ);
-	//Draw the mesh
-	m_basicMeshes->DrawCylinderMesh();
-}
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.cpp
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneManager.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	const char* g_ModelName = "model";
+	const char* g_ColorValueName = "objectColor";
+	const char* g_TextureValueName = "objectTexture";
+	const char* g_UseTextureName = "bUseTexture";
+	const char* g_UseLightingName = "bUseLighting";
+
+	// imported meshes with at least this many triangles are
+	// split into meshlets and culled per cluster
+	const size_t g_MeshletTriangleThreshold = 4096;
+
+	// a shape switches to the next coarser level when the
+	// radius of its bounding sphere covers less than this
+	// fraction of half the viewport height
+	const float g_ShapeLODScreenSizes[SHAPE_MAX_LODS - 1] = { 0.1f, 0.03f, 0.01f };
+
+	// starting size of the mesh heap - it doubles when full
+	const uint32_t g_MeshHeapVertices = 1 << 18;
+	const uint32_t g_MeshHeapIndices = 1 << 20;
+
+	// merge the static objects into a few batches at startup
+	const bool g_BakeStaticGeometry = true;
+	// size of the grid cells the batches are split into, so
+	// each batch can still be culled on its own
+	const float g_StaticCellSize = 8.0f;
+
+	// materials at least this shiny have highlights small
+	// enough to slide visibly over them as the camera moves
+	const float g_SpecularShininess = 64.0f;
+
+	/***********************************************************
+	 *  DefaultSceneObject()
+	 *
+	 *  Settings of an object before the scene changes any.
+	 ***********************************************************/
+	SCENE_OBJECT DefaultSceneObject()
+	{
+		SCENE_OBJECT object;
+		object.shape = SHAPE_PLANE;
+		object.model = glm::mat4(1.0f);
+		object.bUseTexture = false;
+		object.color = glm::vec4(1.0f);
+		object.uvScale = glm::vec2(1.0f);
+		object.bStatic = true;
+		return(object);
+	}
+}
+
+/***********************************************************
+ *  SceneManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneManager::SceneManager(RenderBackend* pBackend)
+{
+	m_pBackend = pBackend;
+	m_loadedTextures = 0;
+	m_pThreadPool = new ThreadPool();
+	m_pMeshImporter = new MeshImporter(m_pThreadPool);
+	m_modelMatrix = glm::mat4(1.0f);
+	m_viewMatrix = glm::mat4(1.0f);
+	m_projectionMatrix = glm::mat4(1.0f);
+	m_viewPosition = glm::vec3(0.0f);
+	m_debugView = DEBUG_VIEW_NONE;
+	m_debugViewWidth = 1;
+	m_debugViewHeight = 1;
+	m_currentObject = DefaultSceneObject();
+	m_bRecordingScene = false;
+	m_bSceneCaptured = false;
+	m_bStaticBaked = false;
+	m_pSoftwareRasterizer = NULL;
+	m_pRayTracer = NULL;
+	m_pPathTracer = NULL;
+	m_pScenePicker = NULL;
+	m_bPickerBuilt = false;
+	m_bCollisionBuilt = false;
+
+	for (int shape = 0; shape < SHAPE_COUNT; shape++)
+	{
+		m_shapeMeshes[shape].nLODs = 0;
+		m_shapeMeshes[shape].center = glm::vec3(0.0f);
+		m_shapeMeshes[shape].radius = 0.0f;
+		for (int lod = 0; lod < SHAPE_MAX_LODS; lod++)
+		{
+			MESH_INFO& meshInfo = m_shapeMeshes[shape].lods[lod];
+			meshInfo.heapHandle = -1;
+			meshInfo.pMeshlets = NULL;
+			meshInfo.bCullBackFaces = false;
+			meshInfo.center = glm::vec3(0.0f);
+			meshInfo.radius = 0.0f;
+		}
+	}
+}
+
+/***********************************************************
+ *  ~SceneManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneManager::~SceneManager()
+{
+	m_pBackend = NULL;
+
+	// make sure no worker is still writing into a pending mesh
+	for (size_t i = 0; i < m_pendingMeshes.size(); i++)
+	{
+		m_pendingMeshes[i].result.wait();
+		delete m_pendingMeshes[i].pMesh;
+		delete m_pendingMeshes[i].pMeshlets;
+	}
+	m_pendingMeshes.clear();
+	DestroyGLMeshes();
+
+	delete m_pSoftwareRasterizer;
+	m_pSoftwareRasterizer = NULL;
+	delete m_pRayTracer;
+	m_pRayTracer = NULL;
+	delete m_pPathTracer;
+	m_pPathTracer = NULL;
+	delete m_pScenePicker;
+	m_pScenePicker = NULL;
+	delete m_pMeshImporter;
+	m_pMeshImporter = NULL;
+	// waits for any shape still being generated, and the
+	// upload queue frees whatever was never uploaded
+	delete m_pThreadPool;
+	m_pThreadPool = NULL;
+}
+
+/***********************************************************
+ *  CreateGLTexture()
+ *
+ *  This method is used for loading textures from image files
+ *  and creating them through the rendering backend in the
+ *  next available texture slot in memory.
+ ***********************************************************/
+bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+	uint32_t textureID = 0;
+
+	// indicate to always flip images vertically when loaded
+	stbi_set_flip_vertically_on_load(true);
+
+	// try to parse the image data from the specified image file
+	unsigned char* image = stbi_load(
+		filename,
+		&width,
+		&height,
+		&colorChannels,
+		0);
+
+	// if the image was successfully read from the image file
+	if (image)
+	{
+		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
+
+		if ((colorChannels != 3) && (colorChannels != 4))
+		{
+			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
+			stbi_image_free(image);
+			return false;
+		}
+
+		// keep a copy for the CPU renderers
+		SCENE_TEXTURE& textureImage = m_textureImages[m_loadedTextures];
+		textureImage.tag = tag;
+		textureImage.width = width;
+		textureImage.height = height;
+		textureImage.texels.resize(static_cast<size_t>(width) * height);
+		for (size_t i = 0; i < textureImage.texels.size(); i++)
+		{
+			const unsigned char* texel = image + i * colorChannels;
+			uint32_t alpha = (colorChannels == 4) ? texel[3] : 0xFF;
+			textureImage.texels[i] = texel[0] | (texel[1] << 8) | (texel[2] << 16) | (alpha << 24);
+		}
+
+		// without a rendering backend only the copy is kept
+		if (NULL == m_pBackend)
+		{
+			stbi_image_free(image);
+			m_textureIDs[m_loadedTextures].ID = 0;
+			m_textureIDs[m_loadedTextures].tag = tag;
+			m_loadedTextures++;
+			return true;
+		}
+
+		// the texture repeats, is linearly filtered and gets
+		// mipmaps for mapping it to lower resolutions
+		textureID = m_pBackend->CreateTexture(width, height, colorChannels, image);
+
+		// free the image data from local memory
+		stbi_image_free(image);
+
+		// register the loaded texture and associate it with the special tag string
+		m_textureIDs[m_loadedTextures].ID = textureID;
+		m_textureIDs[m_loadedTextures].tag = tag;
+		m_loadedTextures++;
+
+		return true;
+	}
+
+	std::cout << "Could not load image:" << filename << std::endl;
+
+	// Error loading the image
+	return false;
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for binding the loaded textures to
+ *  texture memory slots.  There are up to 16 slots.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		// bind textures on corresponding texture units
+		m_pBackend->BindTexture(i, m_textureIDs[i].ID);
+	}
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory in all the
+ *  used texture memory slots.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		m_pBackend->DestroyTexture(m_textureIDs[i].ID);
+		m_textureIDs[i].ID = 0;
+	}
+}
+
+/***********************************************************
+ *  FindTextureID()
+ *
+ *  This method is used for getting an ID for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureID(std::string tag)
+{
+	int textureID = -1;
+	int index = 0;
+	bool bFound = false;
+
+	while ((index < m_loadedTextures) && (bFound == false))
+	{
+		if (m_textureIDs[index].tag.compare(tag) == 0)
+		{
+			textureID = m_textureIDs[index].ID;
+			bFound = true;
+		}
+		else
+			index++;
+	}
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting a slot index for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureSlot(std::string tag)
+{
+	int textureSlot = -1;
+	int index = 0;
+	bool bFound = false;
+
+	while ((index < m_loadedTextures) && (bFound == false))
+	{
+		if (m_textureIDs[index].tag.compare(tag) == 0)
+		{
+			textureSlot = index;
+			bFound = true;
+		}
+		else
+			index++;
+	}
+
+	return(textureSlot);
+}
+
+/***********************************************************
+ *  FindMaterial()
+ *
+ *  This method is used for getting a material from the previously
+ *  defined materials list that is associated with the passed in tag.
+ ***********************************************************/
+bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
+{
+	if (m_objectMaterials.size() == 0)
+	{
+		return(false);
+	}
+
+	int index = 0;
+	bool bFound = false;
+	while ((index < m_objectMaterials.size()) && (bFound == false))
+	{
+		if (m_objectMaterials[index].tag.compare(tag) == 0)
+		{
+			bFound = true;
+			material.ambientColor = m_objectMaterials[index].ambientColor;
+			material.ambientStrength = m_objectMaterials[index].ambientStrength;
+			material.diffuseColor = m_objectMaterials[index].diffuseColor;
+			material.specularColor = m_objectMaterials[index].specularColor;
+			material.shininess = m_objectMaterials[index].shininess;
+		}
+		else
+		{
+			index++;
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateGLMesh()
+ *
+ *  This method is used for copying parsed mesh data into
+ *  the shared mesh heap, which uses the same vertex
+ *  attribute layout as the basic shape meshes.  No buffer
+ *  objects are created per mesh.  The mesh takes
+ *  ownership of the passed meshlets, if any.
+ ***********************************************************/
+bool SceneManager::CreateGLMesh(const MESH_DATA& mesh, MESHLET_DATA* pMeshlets, bool bClosedMesh, MESH_INFO& meshInfo)
+{
+	meshInfo.tag = mesh.tag;
+	meshInfo.pMeshlets = pMeshlets;
+	meshInfo.bCullBackFaces = bClosedMesh;
+	meshInfo.heapHandle = -1;
+	meshInfo.center = (mesh.boundsMin + mesh.boundsMax) * 0.5f;
+	meshInfo.radius = glm::length(mesh.boundsMax - meshInfo.center);
+
+	// without a rendering backend only the CPU copies are used
+	if (NULL == m_pBackend)
+	{
+		delete pMeshlets;
+		meshInfo.pMeshlets = NULL;
+		return true;
+	}
+
+	meshInfo.heapHandle = m_meshHeap.Allocate(mesh);
+
+	if (meshInfo.heapHandle < 0)
+	{
+		std::cout << "Not uploading empty mesh:" << mesh.tag << std::endl;
+		delete pMeshlets;
+		meshInfo.pMeshlets = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+/***********************************************************
+ *  DestroyGLMeshes()
+ *
+ *  This method is used for freeing the GPU buffers of
+ *  all the loaded external meshes.
+ ***********************************************************/
+void SceneManager::DestroyGLMeshes()
+{
+	ClearStaticGeometry();
+
+	for (size_t i = 0; i < m_importedMeshes.size(); i++)
+	{
+		DestroyGLMesh(m_importedMeshes[i]);
+	}
+	m_importedMeshes.clear();
+	m_importedMeshData.clear();
+	ClearTracedMeshes();
+
+	for (int shape = 0; shape < SHAPE_COUNT; shape++)
+	{
+		for (int lod = 0; lod < SHAPE_MAX_LODS; lod++)
+		{
+			DestroyGLMesh(m_shapeMeshes[shape].lods[lod]);
+		}
+		m_shapeMeshes[shape].nLODs = 0;
+	}
+
+	m_meshHeap.Destroy();
+}
+
+/***********************************************************
+ *  DestroyGLMesh()
+ *
+ *  This method is used for returning the heap ranges and
+ *  freeing the meshlets of one mesh.
+ ***********************************************************/
+void SceneManager::DestroyGLMesh(MESH_INFO& meshInfo)
+{
+	if (meshInfo.heapHandle < 0)
+	{
+		return;
+	}
+
+	m_meshHeap.Free(meshInfo.heapHandle);
+	delete meshInfo.pMeshlets;
+
+	meshInfo.heapHandle = -1;
+	meshInfo.pMeshlets = NULL;
+}
+
+/***********************************************************
+ *  UnloadImportedMesh()
+ *
+ *  This method is used for dropping a loaded external mesh
+ *  that the scene no longer needs.  Its ranges go back to
+ *  the mesh heap, which is packed again once the free
+ *  space gets too scattered.
+ ***********************************************************/
+void SceneManager::UnloadImportedMesh(std::string tag)
+{
+	int meshIndex = FindMeshIndex(tag);
+	if (meshIndex < 0)
+	{
+		return;
+	}
+
+	DestroyGLMesh(m_importedMeshes[meshIndex]);
+	m_importedMeshes.erase(m_importedMeshes.begin() + meshIndex);
+	m_importedMeshData.erase(m_importedMeshData.begin() + meshIndex);
+	ClearTracedMeshes();
+
+	if (m_meshHeap.IsFragmented())
+	{
+		m_meshHeap.Defragment();
+	}
+}
+
+/***********************************************************
+ *  FindMeshIndex()
+ *
+ *  This method is used for getting the index of a loaded
+ *  external mesh associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindMeshIndex(std::string tag)
+{
+	int meshIndex = -1;
+	int index = 0;
+	bool bFound = false;
+
+	while ((index < (int)m_importedMeshes.size()) && (bFound == false))
+	{
+		if (m_importedMeshes[index].tag.compare(tag) == 0)
+		{
+			meshIndex = index;
+			bFound = true;
+		}
+		else
+			index++;
+	}
+
+	return(meshIndex);
+}
+
+/***********************************************************
+ *  QueueImportedMesh()
+ *
+ *  This method is used for starting to parse an external
+ *  model file on a worker thread.  High polygon meshes are
+ *  also split into meshlets on the worker.  The parsed mesh
+ *  is uploaded later by UploadImportedMeshes().  Only pass
+ *  bClosedMesh for watertight models, since their clusters
+ *  that face away from the camera are skipped.
+ ***********************************************************/
+void SceneManager::QueueImportedMesh(const char* filename, std::string tag, bool bClosedMesh)
+{
+	PENDING_MESH pending;
+	pending.pMesh = new MESH_DATA();
+	pending.pMesh->tag = tag;
+	pending.pMeshlets = NULL;
+	pending.bClosedMesh = bClosedMesh;
+
+	pending.result = m_pMeshImporter->LoadMeshAsync(filename, pending.pMesh);
+	m_pendingMeshes.push_back(std::move(pending));
+}
+
+/***********************************************************
+ *  UploadImportedMeshes()
+ *
+ *  This method is used for waiting on all the queued model
+ *  files and uploading the parsed meshes.  It must be called
+ *  from the thread that owns the graphics context.
+ ***********************************************************/
+void SceneManager::UploadImportedMeshes()
+{
+	// split the high polygon meshes into clusters in parallel
+	std::vector<std::future<void>> meshletJobs;
+	for (size_t i = 0; i < m_pendingMeshes.size(); i++)
+	{
+		PENDING_MESH& pending = m_pendingMeshes[i];
+		if (pending.result.get() == false)
+		{
+			// failed to load, nothing to upload
+			pending.pMesh->vertices.clear();
+			pending.pMesh->indices.clear();
+		}
+		else if (pending.pMesh->indices.size() / 3 >= g_MeshletTriangleThreshold)
+		{
+			MESH_DATA* pMesh = pending.pMesh;
+			MESHLET_DATA* pMeshlets = new MESHLET_DATA();
+			pending.pMeshlets = pMeshlets;
+			meshletJobs.push_back(m_pThreadPool->Submit([pMesh, pMeshlets]()
+			{
+				BuildMeshlets(*pMesh, *pMeshlets);
+			}));
+		}
+	}
+	for (size_t i = 0; i < meshletJobs.size(); i++)
+	{
+		meshletJobs[i].wait();
+	}
+
+	for (size_t i = 0; i < m_pendingMeshes.size(); i++)
+	{
+		MESH_INFO meshInfo;
+		if (!m_pendingMeshes[i].pMesh->indices.empty())
+		{
+			// register the loaded mesh and associate it with the tag string
+			if (CreateGLMesh(*m_pendingMeshes[i].pMesh, m_pendingMeshes[i].pMeshlets, m_pendingMeshes[i].bClosedMesh, meshInfo))
+			{
+				m_importedMeshes.push_back(meshInfo);
+				m_importedMeshData.push_back(std::move(*m_pendingMeshes[i].pMesh));
+			}
+		}
+		else
+		{
+			delete m_pendingMeshes[i].pMeshlets;
+		}
+		delete m_pendingMeshes[i].pMesh;
+	}
+
+	// the imported meshes may have moved in memory
+	if (!m_pendingMeshes.empty())
+	{
+		ClearTracedMeshes();
+	}
+	m_pendingMeshes.clear();
+}
+
+/***********************************************************
+ *  QueueShapeMeshes()
+ *
+ *  This method is used for generating every detail level of
+ *  every basic shape as its own task on the worker threads.
+ *  The finest levels are also split into meshlets there.
+ *  Finished meshes are handed back through the upload queue.
+ ***********************************************************/
+void SceneManager::QueueShapeMeshes()
+{
+	ThreadPool* pThreadPool = m_pThreadPool;
+	MeshUploadQueue* pUploads = &m_meshUploads;
+
+	for (int shape = 0; shape < SHAPE_COUNT; shape++)
+	{
+		int nLODs = GetShapeLODCount((SHAPE_TYPE)shape);
+		m_shapeMeshes[shape].nLODs = nLODs;
+		for (int lod = 0; lod < nLODs; lod++)
+		{
+			m_meshUploads.Expect();
+			m_pThreadPool->Submit([pThreadPool, pUploads, shape, lod]()
+			{
+				MESH_UPLOAD upload;
+				upload.pMesh = new MESH_DATA();
+				upload.pMeshlets = NULL;
+				upload.bClosedMesh = (shape != SHAPE_PLANE);
+				upload.slot = shape * SHAPE_MAX_LODS + lod;
+
+				GenerateShapeMesh((SHAPE_TYPE)shape, lod, *upload.pMesh, pThreadPool);
+				if (upload.pMesh->indices.size() / 3 >= g_MeshletTriangleThreshold)
+				{
+					upload.pMeshlets = new MESHLET_DATA();
+					BuildMeshlets(*upload.pMesh, *upload.pMeshlets);
+				}
+				pUploads->Push(upload);
+			});
+		}
+	}
+}
+
+/***********************************************************
+ *  UploadShapeMeshes()
+ *
+ *  This method is used for uploading the generated shapes
+ *  in the order they finish, so the uploads overlap with
+ *  the generation of the larger levels.  It must be called
+ *  from the thread that owns the graphics context.
+ ***********************************************************/
+void SceneManager::UploadShapeMeshes()
+{
+	MESH_UPLOAD upload;
+	while (m_meshUploads.WaitPop(upload))
+	{
+		int shape = upload.slot / SHAPE_MAX_LODS;
+		int lod = upload.slot % SHAPE_MAX_LODS;
+		SHAPE_INFO& shapeInfo = m_shapeMeshes[shape];
+
+		// the coarse levels sit inside the finest one, so its
+		// bounds are used for choosing the level
+		if (lod == 0)
+		{
+			shapeInfo.center = (upload.pMesh->boundsMin + upload.pMesh->boundsMax) * 0.5f;
+			shapeInfo.radius = glm::length(upload.pMesh->boundsMax - shapeInfo.center);
+		}
+		CreateGLMesh(*upload.pMesh, upload.pMeshlets, upload.bClosedMesh, shapeInfo.lods[lod]);
+		// keep the vertices around for baking the static objects
+		shapeInfo.meshes[lod] = std::move(*upload.pMesh);
+		delete upload.pMesh;
+	}
+}
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer
+ *  using the passed in transformation values.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	// variables for this method
+	glm::mat4 modelView;
+	glm::mat4 scale;
+	glm::mat4 rotationX;
+	glm::mat4 rotationY;
+	glm::mat4 rotationZ;
+	glm::mat4 translation;
+
+	// set the scale value in the transform buffer
+	scale = glm::scale(scaleXYZ);
+	// set the rotation values in the transform buffer
+	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
+	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
+	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
+	// set the translation value in the transform buffer
+	translation = glm::translate(positionXYZ);
+
+	modelView = translation * rotationZ * rotationY * rotationX * scale;
+	m_modelMatrix = modelView;
+	m_currentObject.model = modelView;
+
+	if ((NULL != m_pBackend) && !IsObjectDeferred())
+	{
+		m_pBackend->SetUniformMat4(g_ModelName, modelView);
+	}
+}
+
+/***********************************************************
+ *  SetShaderColor()
+ *
+ *  This method is used for setting the passed in color
+ *  into the shader for the next draw command
+ ***********************************************************/
+void SceneManager::SetShaderColor(
+	float redColorValue,
+	float greenColorValue,
+	float blueColorValue,
+	float alphaValue)
+{
+	// variables for this method
+	glm::vec4 currentColor;
+
+	currentColor.r = redColorValue;
+	currentColor.g = greenColorValue;
+	currentColor.b = blueColorValue;
+	currentColor.a = alphaValue;
+	m_currentObject.bUseTexture = false;
+	m_currentObject.color = currentColor;
+
+	if ((NULL != m_pBackend) && !IsObjectDeferred())
+	{
+		m_pBackend->SetUniformInt(g_UseTextureName, false);
+		m_pBackend->SetUniformVec4(g_ColorValueName, currentColor);
+	}
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in ID into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	std::string textureTag)
+{
+	m_currentObject.bUseTexture = true;
+	m_currentObject.textureTag = textureTag;
+
+	if ((NULL != m_pBackend) && !IsObjectDeferred())
+	{
+		m_pBackend->SetUniformInt(g_UseTextureName, true);
+
+		int textureID = -1;
+		textureID = FindTextureSlot(textureTag);
+		m_pBackend->SetUniformSampler(g_TextureValueName, textureID);
+	}
+}
+
+/***********************************************************
+ *  SetTextureUVScale()
+ *
+ *  This method is used for setting the texture UV scale
+ *  values into the shader.
+ ***********************************************************/
+void SceneManager::SetTextureUVScale(float u, float v)
+{
+	m_currentObject.uvScale = glm::vec2(u, v);
+
+	if ((NULL != m_pBackend) && !IsObjectDeferred())
+	{
+		m_pBackend->SetUniformVec2("UVscale", glm::vec2(u, v));
+	}
+}
+
+/***********************************************************
+ *  SetTextureEnabled()
+ *
+ *  This method is used for turning texturing on or off in
+ *  the shader for the next draw commands.
+ ***********************************************************/
+void SceneManager::SetTextureEnabled(
+	bool bUseTexture)
+{
+	m_currentObject.bUseTexture = bUseTexture;
+
+	if ((NULL != m_pBackend) && !IsObjectDeferred())
+	{
+		m_pBackend->SetUniformInt(g_UseTextureName, bUseTexture);
+	}
+}
+
+/***********************************************************
+ *  SetObjectStatic()
+ *
+ *  This method is used for marking the next objects as
+ *  never moving, which lets them be baked together, or as
+ *  moving, which keeps them drawn on their own.  Objects
+ *  are static unless marked otherwise.
+ ***********************************************************/
+void SceneManager::SetObjectStatic(
+	bool bStatic)
+{
+	m_currentObject.bStatic = bStatic;
+}
+
+/***********************************************************
+ *  IsObjectDeferred()
+ *
+ *  This method is used for checking if the shader settings
+ *  should only be remembered.  While recording nothing is
+ *  drawn, and once the static objects are baked the
+ *  settings are sent just before a live object is drawn.
+ ***********************************************************/
+bool SceneManager::IsObjectDeferred() const
+{
+	return(m_bRecordingScene || m_bStaticBaked);
+}
+
+/***********************************************************
+ *  ApplyObjectState()
+ *
+ *  This method is used for sending all the remembered
+ *  settings of an object into the shader.
+ ***********************************************************/
+void SceneManager::ApplyObjectState(
+	const SCENE_OBJECT& object)
+{
+	if (NULL == m_pBackend)
+	{
+		return;
+	}
+
+	m_modelMatrix = object.model;
+	m_pBackend->SetUniformMat4(g_ModelName, object.model);
+	m_pBackend->SetUniformInt(g_UseTextureName, object.bUseTexture);
+	if (object.bUseTexture)
+	{
+		m_pBackend->SetUniformSampler(g_TextureValueName, FindTextureSlot(object.textureTag));
+	}
+	else
+	{
+		m_pBackend->SetUniformVec4(g_ColorValueName, object.color);
+	}
+	m_pBackend->SetUniformVec2("UVscale", object.uvScale);
+
+	OBJECT_MATERIAL material;
+	if ((m_objectMaterials.size() > 0) && FindMaterial(object.materialTag, material))
+	{
+		m_pBackend->SetUniformVec3("material.ambientColor", material.ambientColor);
+		m_pBackend->SetUniformFloat("material.ambientStrength", material.ambientStrength);
+		m_pBackend->SetUniformVec3("material.diffuseColor", material.diffuseColor);
+		m_pBackend->SetUniformVec3("material.specularColor", material.specularColor);
+		m_pBackend->SetUniformFloat("material.shininess", material.shininess);
+	}
+}
+
+/***********************************************************
+ *  DrawImportedMesh()
+ *
+ *  This method is used for drawing a loaded external mesh
+ *  with the current transformation and material settings.
+ ***********************************************************/
+void SceneManager::DrawImportedMesh(
+	std::string meshTag)
+{
+	if (m_bRecordingScene)
+	{
+		SCENE_OBJECT object = m_currentObject;
+		object.meshTag = meshTag;
+		m_sceneObjects.push_back(object);
+		return;
+	}
+
+	int meshIndex = FindMeshIndex(meshTag);
+	if ((meshIndex < 0) || (m_importedMeshes[meshIndex].heapHandle < 0))
+	{
+		return;
+	}
+
+	// external meshes are never baked, so they are always
+	// drawn live with their remembered settings
+	if (m_bStaticBaked)
+	{
+		ApplyObjectState(m_currentObject);
+	}
+	AddReshadeBounds(m_importedMeshes[meshIndex].center, m_importedMeshes[meshIndex].radius);
+	DrawGLMesh(m_importedMeshes[meshIndex]);
+}
+
+/***********************************************************
+ *  IsSpecularMaterial()
+ *
+ *  This method is used for checking whether the highlights
+ *  of a material are small and bright enough to slide
+ *  visibly over an object as the camera moves.
+ ***********************************************************/
+bool SceneManager::IsSpecularMaterial(
+	const std::string& materialTag)
+{
+	OBJECT_MATERIAL material;
+	material.specularColor = glm::vec3(0.0f);
+	material.shininess = 0.0f;
+	if (!FindMaterial(materialTag, material))
+	{
+		return(false);
+	}
+	return((material.shininess >= g_SpecularShininess) && (material.specularColor != glm::vec3(0.0f)));
+}
+
+/***********************************************************
+ *  AddReshadeBounds()
+ *
+ *  This method is used for remembering the world space box
+ *  around the bounding sphere of the object about to be
+ *  drawn, when the object moves or is shiny.
+ ***********************************************************/
+void SceneManager::AddReshadeBounds(
+	const glm::vec3& center,
+	float radius)
+{
+	bool bMoving = !m_currentObject.bStatic;
+	if (!bMoving && !IsSpecularMaterial(m_currentObject.materialTag))
+	{
+		return;
+	}
+
+	glm::vec3 worldCenter = glm::vec3(m_modelMatrix * glm::vec4(center, 1.0f));
+	float scale = std::max(
+		glm::length(glm::vec3(m_modelMatrix[0])),
+		std::max(glm::length(glm::vec3(m_modelMatrix[1])), glm::length(glm::vec3(m_modelMatrix[2]))));
+	glm::vec3 extent = glm::vec3(radius * scale);
+
+	RESHADE_BOUNDS bounds;
+	bounds.boundsMin = worldCenter - extent;
+	bounds.boundsMax = worldCenter + extent;
+	bounds.bMoving = bMoving;
+	m_reshadeBounds.push_back(bounds);
+}
+
+/***********************************************************
+ *  DrawShapeMesh()
+ *
+ *  This method is used for drawing a generated basic shape
+ *  with the current transformation and material settings.
+ *  The detail level is picked from how large the shape's
+ *  bounding sphere appears with the camera set by
+ *  SetViewParameters().
+ ***********************************************************/
+void SceneManager::DrawShapeMesh(
+	SHAPE_TYPE shape)
+{
+	if (m_bRecordingScene)
+	{
+		SCENE_OBJECT object = m_currentObject;
+		object.shape = shape;
+		m_sceneObjects.push_back(object);
+		return;
+	}
+	if (m_bStaticBaked)
+	{
+		// static objects are already part of a batch
+		if (m_currentObject.bStatic)
+		{
+			return;
+		}
+		ApplyObjectState(m_currentObject);
+	}
+
+	const SHAPE_INFO& shapeInfo = m_shapeMeshes[shape];
+	int lod = SelectShapeLOD(shape, m_modelMatrix);
+
+	// fall back to any level that has been uploaded
+	int fallback = 0;
+	while ((fallback < shapeInfo.nLODs) && (shapeInfo.lods[lod].heapHandle < 0))
+	{
+		lod = fallback++;
+	}
+	if (shapeInfo.lods[lod].heapHandle < 0)
+	{
+		return;
+	}
+
+	AddReshadeBounds(shapeInfo.center, shapeInfo.radius);
+	DrawGLMesh(shapeInfo.lods[lod]);
+}
+
+/***********************************************************
+ *  SelectShapeLOD()
+ *
+ *  This method is used for picking the detail level of a
+ *  basic shape from how large its bounding sphere appears
+ *  with the camera set by SetViewParameters().
+ ***********************************************************/
+int SceneManager::SelectShapeLOD(
+	SHAPE_TYPE shape,
+	const glm::mat4& model) const
+{
+	const SHAPE_INFO& shapeInfo = m_shapeMeshes[shape];
+	int lod = 0;
+
+	if (shapeInfo.nLODs > 1)
+	{
+		float screenSize = GetScreenSize(shapeInfo.center, shapeInfo.radius, model);
+		while ((lod + 1 < shapeInfo.nLODs) && (screenSize < g_ShapeLODScreenSizes[lod]))
+		{
+			lod++;
+		}
+	}
+
+	return(lod);
+}
+
+/***********************************************************
+ *  SelectBatchLOD()
+ *
+ *  This method is used for picking the detail level of a
+ *  static batch.  Its largest object is taken to be at the
+ *  point of the batch nearest the camera, so no object in
+ *  it is drawn coarser than it would be on its own.
+ ***********************************************************/
+int SceneManager::SelectBatchLOD(
+	const STATIC_BATCH& batch) const
+{
+	glm::vec3 nearest = glm::min(glm::max(m_viewPosition, batch.boundsMin), batch.boundsMax);
+	float screenSize = GetScreenSize(nearest, batch.objectRadius, glm::mat4(1.0f));
+	int lod = 0;
+	while ((lod + 1 < batch.nLODs) && (screenSize < g_ShapeLODScreenSizes[lod]))
+	{
+		lod++;
+	}
+
+	return(lod);
+}
+
+/***********************************************************
+ *  GetScreenSize()
+ *
+ *  This method is used for getting the fraction of half
+ *  the viewport height an object space bounding sphere
+ *  covers with the camera set by SetViewParameters().
+ *  Orthographic views ignore the distance.
+ ***********************************************************/
+float SceneManager::GetScreenSize(
+	const glm::vec3& center,
+	float radius,
+	const glm::mat4& model) const
+{
+	glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+	float scale = std::max(
+		glm::length(glm::vec3(model[0])),
+		std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+	float worldRadius = radius * scale;
+
+	float screenSize = worldRadius * m_projectionMatrix[1][1];
+	if (m_projectionMatrix[3][3] == 0.0f)
+	{
+		float distance = glm::length(worldCenter - m_viewPosition);
+		screenSize = (distance > worldRadius) ? screenSize / distance : 1.0f;
+	}
+	return(screenSize);
+}
+
+/***********************************************************
+ *  SetDebugValue()
+ *
+ *  This method is used for sending the heat of a draw to
+ *  the debug view program.  Draw cost counts the draw's
+ *  triangles; triangle density divides them by the pixels
+ *  its bounding sphere covers, at most the whole frame.
+ ***********************************************************/
+void SceneManager::SetDebugValue(
+	const MESH_INFO& meshInfo,
+	size_t triangles)
+{
+	float heat = 0.0f;
+	if (DEBUG_VIEW_DRAW_COST == m_debugView)
+	{
+		heat = GetDrawCostHeat(triangles);
+	}
+	else if (DEBUG_VIEW_TRIANGLE_DENSITY == m_debugView)
+	{
+		float radiusPixels = GetScreenSize(meshInfo.center, meshInfo.radius, m_modelMatrix) * m_debugViewHeight * 0.5f;
+		float framePixels = static_cast<float>(m_debugViewWidth) * m_debugViewHeight;
+		float coveredPixels = std::min(3.14159265f * radiusPixels * radiusPixels, framePixels);
+		heat = GetTriangleDensityHeat(triangles, coveredPixels);
+	}
+	else
+	{
+		return;
+	}
+	m_pBackend->SetUniformFloat("debugValue", heat);
+}
+
+/***********************************************************
+ *  DrawGLMesh()
+ *
+ *  This method is used for drawing an uploaded mesh with
+ *  the current transformation and material settings.  Every
+ *  mesh is drawn from the mesh heap's vertex layout, with
+ *  the base vertex and first index of its ranges.
+ *  Clustered meshes are culled per meshlet against the
+ *  camera set by SetViewParameters(), and the visible
+ *  meshlets are drawn with one indirect multi-draw.
+ ***********************************************************/
+void SceneManager::DrawGLMesh(
+	const MESH_INFO& meshInfo)
+{
+	const MESH_ALLOCATION& allocation = m_meshHeap.GetAllocation(meshInfo.heapHandle);
+
+	if (NULL == meshInfo.pMeshlets)
+	{
+		SetDebugValue(meshInfo, allocation.indexCount / 3);
+		m_pBackend->DrawIndexed(
+			m_meshHeap.GetVertexLayout(),
+			allocation.indexCount,
+			allocation.firstIndex,
+			allocation.baseVertex);
+		return;
+	}
+
+	// test the clusters with the camera moved into object space
+	glm::vec3 objectCamera = glm::vec3(glm::inverse(m_modelMatrix) * glm::vec4(m_viewPosition, 1.0f));
+	m_meshletCommands.clear();
+	CullMeshlets(
+		*meshInfo.pMeshlets,
+		m_projectionMatrix * m_viewMatrix * m_modelMatrix,
+		objectCamera,
+		meshInfo.bCullBackFaces,
+		m_meshletCommands);
+
+	// move the cluster ranges to where the mesh sits in the heap
+	size_t triangles = 0;
+	for (size_t i = 0; i < m_meshletCommands.size(); i++)
+	{
+		m_meshletCommands[i].firstIndex += allocation.firstIndex;
+		m_meshletCommands[i].baseVertex = allocation.baseVertex;
+		triangles += m_meshletCommands[i].count / 3;
+	}
+	SetDebugValue(meshInfo, triangles);
+
+	m_pBackend->DrawIndexedIndirect(
+		m_meshHeap.GetVertexLayout(),
+		m_meshletCommands.data(),
+		m_meshletCommands.size());
+}
+
+/***********************************************************
+ *  LoadSceneTextures()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene
+ *  rendering
+ ***********************************************************/
+void SceneManager::LoadSceneTextures()
+{
+	bool bReturn = false;
+
+	//Function to load textures into memory.
+	bReturn = CreateGLTexture(
+		"desktop.jpg",
+		"desktop");
+
+	bReturn = CreateGLTexture(
+		"tab.png",
+		"tab");
+
+	bReturn = CreateGLTexture(
+		"table.png",
+		"table");
+
+	// afer the texture image data is loaded into memory, the
+	// loaded textures need to be bound to texture slots - there
+	// are a total of 16 available slots for scene textures
+	if (NULL != m_pBackend)
+	{
+		BindGLTextures();
+	}
+}
+
+/***********************************************************
+ *  LoadSceneMeshes()
+ *
+ *  This method is used for queueing the external model files
+ *  used in the 3D scene.  The files are parsed on worker
+ *  threads while the textures load, and uploaded at the end
+ *  of PrepareScene().
+ ***********************************************************/
+void SceneManager::LoadSceneMeshes()
+{
+	// queue every model file the scene needs - .obj, .gltf and
+	// .glb files are supported, for example:
+	//QueueImportedMesh("keyboard.glb", "keyboard", true);
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for passing the material values
+ *  into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	std::string materialTag)
+{
+	m_currentObject.materialTag = materialTag;
+
+	if ((NULL != m_pBackend) && (m_objectMaterials.size() > 0) && !IsObjectDeferred())
+	{
+		OBJECT_MATERIAL material;
+		bool bReturn = false;
+
+		bReturn = FindMaterial(materialTag, material);
+		if (bReturn == true)
+		{
+			m_pBackend->SetUniformVec3("material.ambientColor", material.ambientColor);
+			m_pBackend->SetUniformFloat("material.ambientStrength", material.ambientStrength);
+			m_pBackend->SetUniformVec3("material.diffuseColor", material.diffuseColor);
+			m_pBackend->SetUniformVec3("material.specularColor", material.specularColor);
+			m_pBackend->SetUniformFloat("material.shininess", material.shininess);
+		}
+	}
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+/**************************************************************/
+
+ /***********************************************************
+  *  DefineObjectMaterials()
+  *
+  *  This method is used for configuring the various material
+  *  settings for all of the objects within the 3D scene.
+  ***********************************************************/
+
+void SceneManager::DefineObjectMaterials()
+{
+	//Makes a non reflective material for the tabletop since it's wooden. 
+	OBJECT_MATERIAL tableMaterial;
+	tableMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	tableMaterial.ambientStrength = 0.5f;
+	tableMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.3f);
+	tableMaterial.specularColor = glm::vec3(0.8f, 0.8f, 1.0f);
+	tableMaterial.shininess = 1.0;
+	tableMaterial.tag = "table";
+	m_objectMaterials.push_back(tableMaterial);
+
+	//Makes a black pastic material for the monitor's black plastic parts.
+	OBJECT_MATERIAL blackPlasticMaterial;
+	blackPlasticMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	blackPlasticMaterial.ambientStrength = 0.1f;
+	blackPlasticMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);
+	blackPlasticMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	blackPlasticMaterial.shininess = 32.0;
+	blackPlasticMaterial.tag = "blackPlastic";
+	m_objectMaterials.push_back(blackPlasticMaterial);
+
+	//Makes a grey plastic material for the legs and base of the monitor.
+	OBJECT_MATERIAL greyPlasticMaterial;
+	greyPlasticMaterial.ambientColor = glm::vec3(0.3f, 0.3f, 0.3f);
+	greyPlasticMaterial.ambientStrength = 0.3f;
+	greyPlasticMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
+	greyPlasticMaterial.specularColor = glm::vec3(0.3f, 0.3f, 0.3f);
+	greyPlasticMaterial.shininess = 32.0;
+	greyPlasticMaterial.tag = "greyPlastic";
+	m_objectMaterials.push_back(greyPlasticMaterial);
+
+	//Makes a reflective material for the monitor's screen. 
+	OBJECT_MATERIAL screenMaterial;
+	screenMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
+	screenMaterial.ambientStrength = 0.8f;
+	screenMaterial.diffuseColor = glm::vec3(0.4f, 0.4f, 0.5f);
+	screenMaterial.specularColor = glm::vec3(1.0f, 1.0f, 1.0f);
+	screenMaterial.shininess = 256.0f;
+	screenMaterial.tag = "screen";
+	m_objectMaterials.push_back(screenMaterial);
+}
+
+/***********************************************************
+ *  SetupSceneLights()
+ *
+ *  This method is called to add and configure the light
+ *  sources for the 3D scene.  There are up to 4 light sources.
+ ***********************************************************/
+void SceneManager::SetupSceneLights()
+{
+	//Configures light source and its params to best suite scene. 
+	SCENE_LIGHT light;
+	light.position = glm::vec3(0.0f, 8.0f, 10.0f);
+	light.ambientColor = glm::vec3(0.01f, 0.01f, 0.01f);
+	light.diffuseColor = glm::vec3(0.4f, 0.4f, 0.4f);
+	light.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
+	light.focalStrength = 32.0f;
+	light.specularIntensity = 0.05f;
+	m_lightSources.push_back(light);
+
+	light.position = glm::vec3(0.0f, 4.0f, 8.0f);
+	light.ambientColor = glm::vec3(0.1f, 0.0f, 0.15f);
+	light.diffuseColor = glm::vec3(0.2f, 0.0f, 0.25f);
+	light.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
+	light.focalStrength = 32.0f;
+	light.specularIntensity = 0.05f;
+	m_lightSources.push_back(light);
+
+	// the CPU renderers read the lights from the list, and
+	// the shader gets them as uniforms
+	if (NULL == m_pBackend)
+	{
+		return;
+	}
+	for (size_t i = 0; i < m_lightSources.size(); i++)
+	{
+		std::string name = "lightSources[" + std::to_string(i) + "]";
+		m_pBackend->SetUniformVec3(name + ".position", m_lightSources[i].position);
+		m_pBackend->SetUniformVec3(name + ".ambientColor", m_lightSources[i].ambientColor);
+		m_pBackend->SetUniformVec3(name + ".diffuseColor", m_lightSources[i].diffuseColor);
+		m_pBackend->SetUniformVec3(name + ".specularColor", m_lightSources[i].specularColor);
+		m_pBackend->SetUniformFloat(name + ".focalStrength", m_lightSources[i].focalStrength);
+		m_pBackend->SetUniformFloat(name + ".specularIntensity", m_lightSources[i].specularIntensity);
+	}
+
+	//Enables lighting to be used in the scene. 
+	m_pBackend->SetUniformInt("bUseLighting", true);
+}
+
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void SceneManager::PrepareScene()
+{
+	// start parsing the external model files in the background
+	LoadSceneMeshes();
+
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene - the basic shapes and their
+	// detail levels are generated in the background too
+	QueueShapeMeshes();
+
+	// load the textures for the 3D scene
+	LoadSceneTextures();
+	DefineObjectMaterials();
+	SetupSceneLights();
+
+	// one set of buffers holds every mesh in the scene -
+	// without a rendering backend only the CPU copies are kept
+	if (NULL != m_pBackend)
+	{
+		m_meshHeap.Create(m_pBackend, g_MeshHeapVertices, g_MeshHeapIndices);
+	}
+
+	// upload the shapes and the external meshes as they finish
+	UploadShapeMeshes();
+	UploadImportedMeshes();
+
+	// merge the objects that never move into a few batches
+	if (g_BakeStaticGeometry && (NULL != m_pBackend))
+	{
+		BakeStaticGeometry();
+	}
+}
+
+/***********************************************************
+ *  SetViewParameters()
+ *
+ *  This method is used for passing in the camera of the
+ *  current frame, which is needed for culling.
+ ***********************************************************/
+void SceneManager::SetViewParameters(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	const glm::vec3& viewPosition)
+{
+	m_viewMatrix = view;
+	m_projectionMatrix = projection;
+	m_viewPosition = viewPosition;
+}
+
+/***********************************************************
+ *  SetDebugView()
+ *
+ *  This method is used for choosing the debug view the
+ *  next draws send their heat for, with the size of the
+ *  frame the triangle density is measured against.
+ ***********************************************************/
+void SceneManager::SetDebugView(
+	DEBUG_VIEW view,
+	int width,
+	int height)
+{
+	m_debugView = view;
+	m_debugViewWidth = std::max(width, 1);
+	m_debugViewHeight = std::max(height, 1);
+}
+
+/***********************************************************
+ *  BeginScene()
+ *
+ *  This method is used for starting a frame.  Once the
+ *  static objects are baked, the batches that are inside
+ *  the camera's view are drawn here, each at the detail
+ *  level that suits it, and the shader settings are only
+ *  sent when they change between batches.
+ ***********************************************************/
+void SceneManager::BeginScene()
+{
+	m_currentObject.bStatic = true;
+	if (!m_bRecordingScene)
+	{
+		m_reshadeBounds.clear();
+	}
+	if (!m_bStaticBaked || m_bRecordingScene)
+	{
+		return;
+	}
+
+	glm::vec4 planes[6];
+	ExtractFrustumPlanes(m_projectionMatrix * m_viewMatrix, planes);
+
+	const SCENE_OBJECT* pLastState = NULL;
+	for (size_t i = 0; i < m_staticBatches.size(); i++)
+	{
+		const STATIC_BATCH& batch = m_staticBatches[i];
+		if (!IsBoxInFrustum(planes, batch.boundsMin, batch.boundsMax))
+		{
+			continue;
+		}
+		if ((NULL == pLastState) || !HaveSameRenderState(*pLastState, batch.state))
+		{
+			ApplyObjectState(batch.state);
+			pLastState = &batch.state;
+		}
+		if (IsSpecularMaterial(batch.state.materialTag))
+		{
+			RESHADE_BOUNDS bounds;
+			bounds.boundsMin = batch.boundsMin;
+			bounds.boundsMax = batch.boundsMax;
+			bounds.bMoving = false;
+			m_reshadeBounds.push_back(bounds);
+		}
+		DrawGLMesh(batch.lods[SelectBatchLOD(batch)]);
+	}
+}
+
+/***********************************************************
+ *  RecordScene()
+ *
+ *  This method is used for running RenderScene() without
+ *  drawing anything, which captures every object it would
+ *  draw along with its settings in m_sceneObjects.  The
+ *  capture does not depend on the camera, so it is only
+ *  taken again after InvalidateSceneQueries().
+ ***********************************************************/
+void SceneManager::RecordScene()
+{
+	if (m_bSceneCaptured)
+	{
+		return;
+	}
+
+	SCENE_OBJECT liveObject = m_currentObject;
+
+	m_sceneObjects.clear();
+	m_currentObject = DefaultSceneObject();
+	m_bRecordingScene = true;
+	RenderScene();
+	m_bRecordingScene = false;
+	m_bSceneCaptured = true;
+
+	m_currentObject = liveObject;
+}
+
+/***********************************************************
+ *  GetSurfaceShading()
+ *
+ *  This method is used for looking up the material and
+ *  texture of a recorded object for the CPU renderers.
+ ***********************************************************/
+void SceneManager::GetSurfaceShading(
+	const SCENE_OBJECT& object,
+	SURFACE_SHADING& shading)
+{
+	OBJECT_MATERIAL material;
+	material.ambientColor = glm::vec3(0.0f);
+	material.ambientStrength = 0.0f;
+	material.diffuseColor = glm::vec3(0.0f);
+	material.specularColor = glm::vec3(0.0f);
+	material.shininess = 0.0f;
+	FindMaterial(object.materialTag, material);
+
+	shading.material.ambientColor = material.ambientColor;
+	shading.material.ambientStrength = material.ambientStrength;
+	shading.material.diffuseColor = material.diffuseColor;
+	shading.material.specularColor = material.specularColor;
+	shading.material.shininess = material.shininess;
+	shading.color = object.color;
+	shading.uvScale = object.uvScale;
+
+	shading.pTexture = NULL;
+	int textureSlot = object.bUseTexture ? FindTextureSlot(object.textureTag) : -1;
+	if ((textureSlot >= 0) && !m_textureImages[textureSlot].texels.empty())
+	{
+		shading.pTexture = &m_textureImages[textureSlot];
+	}
+}
+
+/***********************************************************
+ *  CollectSoftwareDraws()
+ *
+ *  This method is used for turning the objects captured by
+ *  RecordScene() into draws for the CPU renderers, so a
+ *  frame does not run RenderScene() again.  Each basic shape picks its detail
+ *  level like it does in DrawShapeMesh(), unless the full
+ *  detail is asked for.
+ ***********************************************************/
+void SceneManager::CollectSoftwareDraws(bool bFullDetail)
+{
+	RecordScene();
+
+	m_softwareDraws.clear();
+	for (size_t i = 0; i < m_sceneObjects.size(); i++)
+	{
+		const SCENE_OBJECT& object = m_sceneObjects[i];
+		SOFTWARE_DRAW draw;
+
+		if (!object.meshTag.empty())
+		{
+			int meshIndex = FindMeshIndex(object.meshTag);
+			if (meshIndex < 0)
+			{
+				continue;
+			}
+			draw.pMesh = &m_importedMeshData[meshIndex];
+			draw.bCullBackFaces = m_importedMeshes[meshIndex].bCullBackFaces;
+		}
+		else
+		{
+			const SHAPE_INFO& shapeInfo = m_shapeMeshes[object.shape];
+			int lod = bFullDetail ? 0 : SelectShapeLOD(object.shape, object.model);
+			while ((lod > 0) && shapeInfo.meshes[lod].indices.empty())
+			{
+				lod--;
+			}
+			if (shapeInfo.meshes[lod].indices.empty())
+			{
+				continue;
+			}
+			draw.pMesh = &shapeInfo.meshes[lod];
+			draw.bCullBackFaces = shapeInfo.lods[lod].bCullBackFaces;
+		}
+
+		draw.model = object.model;
+		GetSurfaceShading(object, draw.shading);
+		m_softwareDraws.push_back(draw);
+	}
+}
+
+/***********************************************************
+ *  ClearTracedMeshes()
+ *
+ *  This method is used for making the CPU tracers rebuild
+ *  their mesh hierarchies from the current mesh data.
+ ***********************************************************/
+void SceneManager::ClearTracedMeshes()
+{
+	if (NULL != m_pRayTracer)
+	{
+		m_pRayTracer->ClearMeshCache();
+	}
+	if (NULL != m_pPathTracer)
+	{
+		m_pPathTracer->ClearMeshCache();
+	}
+	if (NULL != m_pScenePicker)
+	{
+		m_pScenePicker->ClearMeshCache();
+	}
+	m_bPickerBuilt = false;
+}
+
+/***********************************************************
+ *  BuildScenePicker()
+ *
+ *  This method is used for placing the objects captured by
+ *  RecordScene() in the picker, whose results index them.
+ *  The basic shapes are given their most detailed level,
+ *  which the picker only tests for the shapes it cannot
+ *  test exactly.
+ ***********************************************************/
+void SceneManager::BuildScenePicker()
+{
+	if (NULL == m_pScenePicker)
+	{
+		m_pScenePicker = new ScenePicker(m_pThreadPool);
+	}
+
+	RecordScene();
+
+	std::vector<PICK_OBJECT> pickObjects(m_sceneObjects.size());
+	for (size_t i = 0; i < m_sceneObjects.size(); i++)
+	{
+		const SCENE_OBJECT& object = m_sceneObjects[i];
+		PICK_OBJECT& pickObject = pickObjects[i];
+		pickObject.model = object.model;
+		if (!object.meshTag.empty())
+		{
+			int meshIndex = FindMeshIndex(object.meshTag);
+			pickObject.pMesh = (meshIndex >= 0) ? &m_importedMeshData[meshIndex] : NULL;
+			pickObject.shape = SHAPE_COUNT;
+		}
+		else
+		{
+			pickObject.pMesh = &m_shapeMeshes[object.shape].meshes[0];
+			pickObject.shape = object.shape;
+		}
+	}
+
+	m_pScenePicker->Build(pickObjects);
+	m_bPickerBuilt = true;
+}
+
+/***********************************************************
+ *  PickObject()
+ *
+ *  This method is used for finding the object a ray hits
+ *  first, for selecting objects under the mouse.  The
+ *  picker is only built when it has nothing current, so
+ *  picking on every mouse move costs one walk of the
+ *  picker's hierarchy.
+ ***********************************************************/
+bool SceneManager::PickObject(
+	const glm::vec3& origin,
+	const glm::vec3& direction,
+	PICK_RESULT& result,
+	SCENE_OBJECT& object)
+{
+	if (!m_bPickerBuilt)
+	{
+		BuildScenePicker();
+	}
+
+	if (!m_pScenePicker->Pick(origin, direction, result))
+	{
+		return(false);
+	}
+
+	object = m_sceneObjects[result.object];
+	return(true);
+}
+
+/***********************************************************
+ *  BuildSceneCollision()
+ *
+ *  This method is used for placing the box around the mesh
+ *  of each object captured by RecordScene() in the
+ *  collision grid, sharing the capture with the picker and
+ *  the CPU renderers.  Objects whose mesh is missing are
+ *  given no box, so the indices still follow the draw
+ *  order and match the picker's.
+ ***********************************************************/
+void SceneManager::BuildSceneCollision()
+{
+	RecordScene();
+
+	std::vector<COLLISION_OBJECT> collisionObjects(m_sceneObjects.size());
+	for (size_t i = 0; i < m_sceneObjects.size(); i++)
+	{
+		const SCENE_OBJECT& object = m_sceneObjects[i];
+		const MESH_DATA* pMesh = NULL;
+		if (!object.meshTag.empty())
+		{
+			int meshIndex = FindMeshIndex(object.meshTag);
+			pMesh = (meshIndex >= 0) ? &m_importedMeshData[meshIndex] : NULL;
+		}
+		else
+		{
+			pMesh = &m_shapeMeshes[object.shape].meshes[0];
+		}
+
+		COLLISION_OBJECT& collisionObject = collisionObjects[i];
+		collisionObject.model = object.model;
+		bool bHasMesh = (NULL != pMesh) && !pMesh->vertices.empty();
+		collisionObject.boundsMin = bHasMesh ? pMesh->boundsMin : glm::vec3(1.0f);
+		collisionObject.boundsMax = bHasMesh ? pMesh->boundsMax : glm::vec3(-1.0f);
+	}
+
+	m_collision.Build(collisionObjects);
+	m_bCollisionBuilt = true;
+}
+
+/***********************************************************
+ *  GetCollision()
+ *
+ *  This method is used for getting the collision grid of
+ *  the scene, building it from the captured scene when it
+ *  has nothing current.
+ ***********************************************************/
+const SceneCollision& SceneManager::GetCollision()
+{
+	if (!m_bCollisionBuilt)
+	{
+		BuildSceneCollision();
+	}
+	return(m_collision);
+}
+
+/***********************************************************
+ *  GetReshadeBounds()
+ *
+ *  This method is used for getting the world space boxes
+ *  of the moving and the shiny objects of the last frame
+ *  drawn, so the reprojection does not reuse their pixels.
+ ***********************************************************/
+const std::vector<RESHADE_BOUNDS>& SceneManager::GetReshadeBounds() const
+{
+	return(m_reshadeBounds);
+}
+
+/***********************************************************
+ *  InvalidateSceneQueries()
+ *
+ *  This method is used for dropping the captured scene, so
+ *  the next pick and CPU rendered frame capture it again.
+ *  The collision grid is captured again straight away, in place, since the camera keeps using
+ *  it without asking for it each frame.  The mesh
+ *  hierarchies are kept.
+ ***********************************************************/
+void SceneManager::InvalidateSceneQueries()
+{
+	m_bSceneCaptured = false;
+	m_bPickerBuilt = false;
+	if (m_bCollisionBuilt)
+	{
+		BuildSceneCollision();
+	}
+}
+
+/***********************************************************
+ *  RenderSceneSoftware()
+ *
+ *  This method is used for drawing the scene without a
+ *  GPU.  The software rasterizer draws the captured
+ *  objects with the scene's lights on the worker threads.
+ ***********************************************************/
+void SceneManager::RenderSceneSoftware(int width, int height)
+{
+	if (NULL == m_pSoftwareRasterizer)
+	{
+		m_pSoftwareRasterizer = new SoftwareRasterizer(m_pThreadPool);
+	}
+	if ((m_pSoftwareRasterizer->GetWidth() != width) || (m_pSoftwareRasterizer->GetHeight() != height))
+	{
+		m_pSoftwareRasterizer->Resize(width, height);
+	}
+
+	CollectSoftwareDraws(false);
+
+	m_pSoftwareRasterizer->SetCamera(m_viewMatrix, m_projectionMatrix, m_viewPosition);
+	m_pSoftwareRasterizer->SetLights(m_lightSources);
+	m_pSoftwareRasterizer->Render(m_softwareDraws);
+}
+
+/***********************************************************
+ *  SaveSoftwareFrame()
+ *
+ *  This method is used for writing the last frame drawn by
+ *  RenderSceneSoftware() into an image file.
+ ***********************************************************/
+bool SceneManager::SaveSoftwareFrame(const char* filename)
+{
+	if (NULL == m_pSoftwareRasterizer)
+	{
+		return false;
+	}
+
+	return(m_pSoftwareRasterizer->SaveImage(filename));
+}
+
+/***********************************************************
+ *  RenderSceneRayTraced()
+ *
+ *  This method is used for rendering a still image of the
+ *  scene with the CPU ray tracer.  The basic shapes are
+ *  always traced at their most detailed level.
+ ***********************************************************/
+void SceneManager::RenderSceneRayTraced(int width, int height, const RAY_TRACE_SETTINGS& settings)
+{
+	if (NULL == m_pRayTracer)
+	{
+		m_pRayTracer = new RayTracer(m_pThreadPool);
+	}
+	if ((m_pRayTracer->GetWidth() != width) || (m_pRayTracer->GetHeight() != height))
+	{
+		m_pRayTracer->Resize(width, height);
+	}
+
+	CollectSoftwareDraws(true);
+
+	m_pRayTracer->SetSettings(settings);
+	m_pRayTracer->SetCamera(m_viewMatrix, m_projectionMatrix, m_viewPosition);
+	m_pRayTracer->SetLights(m_lightSources);
+	m_pRayTracer->Render(m_softwareDraws);
+}
+
+/***********************************************************
+ *  SaveRayTracedFrame()
+ *
+ *  This method is used for writing the last frame traced
+ *  by RenderSceneRayTraced() into an image file.
+ ***********************************************************/
+bool SceneManager::SaveRayTracedFrame(const char* filename)
+{
+	if (NULL == m_pRayTracer)
+	{
+		return false;
+	}
+
+	return(m_pRayTracer->SaveImage(filename));
+}
+
+/***********************************************************
+ *  BakeStaticGeometry()
+ *
+ *  This method is used for merging the static basic shapes
+ *  of the scene into world space batches, one per material
+ *  and grid cell, and uploading them into the mesh heap at
+ *  every detail level the shapes have.  From then on
+ *  RenderScene() draws the batches in place of those
+ *  objects, and the rest are still drawn on their own.
+ ***********************************************************/
+void SceneManager::BakeStaticGeometry()
+{
+	ClearStaticGeometry();
+	RecordScene();
+
+	// every detail level of every shape, with the shapes that
+	// have fewer levels repeating their coarsest one
+	const MESH_DATA* shapeMeshes[SHAPE_COUNT * SHAPE_MAX_LODS];
+	for (int shape = 0; shape < SHAPE_COUNT; shape++)
+	{
+		int nLODs = m_shapeMeshes[shape].nLODs;
+		for (int lod = 0; lod < SHAPE_MAX_LODS; lod++)
+		{
+			shapeMeshes[shape * SHAPE_MAX_LODS + lod] =
+				(nLODs > 0) ? &m_shapeMeshes[shape].meshes[std::min(lod, nLODs - 1)] : NULL;
+		}
+	}
+
+	std::vector<STATIC_CHUNK> chunks;
+	BakeStaticObjects(m_sceneObjects, shapeMeshes, g_StaticCellSize, chunks);
+
+	size_t objectCount = 0;
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		STATIC_BATCH batch;
+		batch.state = chunks[i].state;
+		batch.nLODs = 0;
+		batch.objectRadius = chunks[i].objectRadius;
+		batch.boundsMin = glm::vec3(1.0e30f);
+		batch.boundsMax = glm::vec3(-1.0e30f);
+		bool bCreated = true;
+		for (int lod = 0; bCreated && (lod < chunks[i].nLODs); lod++)
+		{
+			MESH_DATA& mesh = chunks[i].meshes[lod];
+			mesh.tag = "static";
+			bCreated = CreateGLMesh(mesh, NULL, false, batch.lods[lod]);
+			if (bCreated)
+			{
+				batch.nLODs++;
+				batch.boundsMin = glm::min(batch.boundsMin, mesh.boundsMin);
+				batch.boundsMax = glm::max(batch.boundsMax, mesh.boundsMax);
+			}
+		}
+
+		if (bCreated)
+		{
+			m_staticBatches.push_back(batch);
+			objectCount += chunks[i].objectCount;
+		}
+		else
+		{
+			for (int lod = 0; lod < batch.nLODs; lod++)
+			{
+				DestroyGLMesh(batch.lods[lod]);
+			}
+		}
+	}
+
+	m_bStaticBaked = !m_staticBatches.empty();
+	std::cout << "Baked " << objectCount << " static objects into " << m_staticBatches.size() << " batches" << std::endl;
+}
+
+/***********************************************************
+ *  ClearStaticGeometry()
+ *
+ *  This method is used for freeing the static batches, so
+ *  every object is drawn on its own again.
+ ***********************************************************/
+void SceneManager::ClearStaticGeometry()
+{
+	for (size_t i = 0; i < m_staticBatches.size(); i++)
+	{
+		for (int lod = 0; lod < m_staticBatches[i].nLODs; lod++)
+		{
+			DestroyGLMesh(m_staticBatches[i].lods[lod]);
+		}
+	}
+	m_staticBatches.clear();
+	m_bStaticBaked = false;
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by 
+ *  transforming and drawing the basic 3D shapes
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	// draw the baked static objects, if any - the objects
+	// below that are part of a batch are then skipped
+	BeginScene();
+
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+	/*** Set needed transformations before drawing the basic mesh.  ***/
+	/*** This same ordering of code should be used for transforming ***/
+	/*** and drawing all the basic 3D shapes.						***/
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//SetShaderColor(1, 1, 1, 1);
+	//Applies a texture
+	SetShaderTexture("table");
+	//Sets the shader material.
+	SetShaderMaterial("table");
+
+	// draw the mesh with transformation values
+	DrawShapeMesh(SHAPE_PLANE);
+	//Deactivate textures so that other objects don't receive wood texture.
+	SetTextureEnabled(false);
+	/****************************************************************/
+
+	//Student's code starts below: 
+
+	//First draw the base of the monitor stand:
+
+	//Determine size
+	glm::vec3 baseCylinderScaleXYZ = glm::vec3(1.0f, .5f, 1.0f);
+	float baseCylinderRadius = baseCylinderScaleXYZ.x;
+	//Determine rotation
+	float baseCylinderXrotationDegrees = 0.0f;
+	float baseCylinderYrotationDegrees = 0.0f;
+	float baseCylinderZrotationDegrees = 0.0f;
+	//Determine position
+	glm::vec3 baseCylinderPositionXYZ = glm::vec3(0.0f, 1.0f, 3.0f);
+	//Determine color: grey
+	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
+	//Sets shader material. 
+	SetShaderMaterial("greyPlastic");
+	//Confirm transformations
+	SetTransformations(
+		baseCylinderScaleXYZ,
+		baseCylinderXrotationDegrees,
+		baseCylinderYrotationDegrees,
+		baseCylinderZrotationDegrees,
+		baseCylinderPositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_CYLINDER);
+
+	//Create the monitor stand's legs: 
+
+	//Leg 1: 
+
+	//Determine size
+	glm::vec3 prong1ScaleXYZ = glm::vec3(.2f, .2f, 2.6f);
+	//Determine position
+	glm::vec3 prong1PositionXYZ = baseCylinderPositionXYZ;
+	prong1PositionXYZ.x -= 1.8f;
+	prong1PositionXYZ.z += 1.0f;
+	prong1PositionXYZ.y -= 0.3f;
+	//Determine rotation
+	float prong1XrotationDegrees = 30.0f;
+	float prong1YrotationDegrees = -60.0f;
+	float prong1ZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
+	//Sets shader material. 
+	SetShaderMaterial("greyPlastic");
+
+	//Confirm transformations
+	SetTransformations(
+		prong1ScaleXYZ,
+		prong1XrotationDegrees,
+		prong1YrotationDegrees,
+		prong1ZrotationDegrees,
+		prong1PositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_BOX);
+
+	//Leg 2: 
+
+	//Determine size
+	glm::vec3 prong2ScaleXYZ = glm::vec3(.2f, .2f, 2.6f);
+	//Determine position
+	glm::vec3 prong2PositionXYZ = baseCylinderPositionXYZ;
+	prong2PositionXYZ.x += 1.8f;
+	prong2PositionXYZ.z += 1.0f;
+	prong2PositionXYZ.y -= 0.3f;
+	//Determine rotation
+	float prong2XrotationDegrees = 30.0f;
+	float prong2YrotationDegrees = 60.0f;
+	float prong2ZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
+	//Sets shader material. 
+	SetShaderMaterial("greyPlastic");
+	//Confirm transformations
+	SetTransformations(
+		prong2ScaleXYZ,
+		prong2XrotationDegrees,
+		prong2YrotationDegrees,
+		prong2ZrotationDegrees,
+		prong2PositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_BOX);
+
+	//Leg 3: 
+
+	//Determine size
+	glm::vec3 prong3ScaleXYZ = glm::vec3(.2f, .2f, 1.8f);
+	//Determine position
+	glm::vec3 prong3PositionXYZ = baseCylinderPositionXYZ;
+	prong3PositionXYZ.z -= 1.5;
+	prong3PositionXYZ.y -= 0.3f;
+	//Determine rotation
+	float prong3XrotationDegrees = -45.0f;
+	float prong3YrotationDegrees = 0.0f;
+	float prong3ZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
+	//Sets shader material. 
+	SetShaderMaterial("greyPlastic");
+	//Confirm transformations
+	SetTransformations(
+		prong3ScaleXYZ,
+		prong3XrotationDegrees,
+		prong3YrotationDegrees,
+		prong3ZrotationDegrees,
+		prong3PositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_BOX);
+
+	//Now draw monitor stand post:
+
+	//Determine size
+	glm::vec3 postScaleXYZ = glm::vec3(baseCylinderScaleXYZ.x - .2f, 4.0f, 1.0f);
+	//Determine position
+	glm::vec3 postPositionXYZ = baseCylinderPositionXYZ;
+	postPositionXYZ.y += postScaleXYZ.y / 2;
+	//Determine rotation
+	float postXrotationDegrees = 0.0f;
+	float postYrotationDegrees = 0.0f;
+	float postZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(0.7f, 0.7f, 0.7f, 1.0f);
+	//Sets shader material. 
+	SetShaderMaterial("greyPlastic");
+	//Confirm transformations
+	SetTransformations(
+		postScaleXYZ,
+		postXrotationDegrees,
+		postYrotationDegrees,
+		postZrotationDegrees,
+		postPositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_BOX);
+
+	//Now draw monitor:
+
+	//Determine size
+	glm::vec3 monitorScaleXYZ = glm::vec3(8.0f, 4.0f, 1.0f);
+	//Determine position
+	glm::vec3 monitorPositionXYZ = postPositionXYZ;
+	monitorPositionXYZ.y += postScaleXYZ.y/2;
+	monitorPositionXYZ.z += .1f;
+	//Determine rotation
+	float monitorXrotationDegrees = 0.0f;
+	float monitorYrotationDegrees = 0.0f;
+	float monitorZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(.2f, .2f, .2f, 1.0f);
+	//Sets shader material.
+	SetShaderMaterial("blackPlastic");
+	//Confirm transformations
+	SetTransformations(
+		monitorScaleXYZ,
+		monitorXrotationDegrees,
+		monitorYrotationDegrees,
+		monitorZrotationDegrees,
+		monitorPositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_BOX);
+
+	//Draw screen:
+
+	//Determine size
+	glm::vec3 screenScaleXYZ = glm::vec3(3.5f, 0.0f, 1.7f);
+	//Determine position
+	glm::vec3 screenPositionXYZ = monitorPositionXYZ;
+	screenPositionXYZ.z += 0.567f;
+	//Determine rotation
+	float screenXrotationDegrees = 90.0f;
+	float screenYrotationDegrees = 0.0f;
+	float screenZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(.9f, .9f, .9f, 1.0f);
+	//Set Texture
+	//Reactivate textures to apply them to current and future objects. 
+	SetTextureEnabled(true);
+	SetShaderTexture("desktop");
+	//Sets shader material. 
+	SetShaderMaterial("screen");
+	//Confirm transformations
+	SetTransformations(
+		screenScaleXYZ,
+		screenXrotationDegrees,
+		screenYrotationDegrees,
+		screenZrotationDegrees,
+		screenPositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_PLANE);
+
+	// Determine size for the second texture (scaled down three times smaller)
+	glm::vec3 smallScreenScaleXYZ = screenScaleXYZ / 3.0f; // Divide the original size by 3
+
+	// Determine position for the second texture (adjust it to be on top of the first texture)
+	glm::vec3 smallScreenPositionXYZ = screenPositionXYZ;
+	// Adjust position slightly in the z-axis to layer it on top
+	smallScreenPositionXYZ.z += 0.01f; // Slightly closer to the camera to prevent z-fighting
+	smallScreenPositionXYZ.x -= 1.7f;
+	smallScreenPositionXYZ.y -= 1.0f;
+
+	// Set texture for the smaller texture
+	SetShaderTexture("tab");
+
+	//Sets shader material. 
+	SetShaderMaterial("screen");
+
+	// Confirm transformations for the smaller texture
+	SetTransformations(
+		smallScreenScaleXYZ,
+		screenXrotationDegrees,
+		screenYrotationDegrees,
+		screenZrotationDegrees,
+		smallScreenPositionXYZ
+	);
+
+	// Draw the smaller texture mesh
+	DrawShapeMesh(SHAPE_PLANE);
+
+	//Now draw keyboard: 
+
+	//Determine size
+	glm::vec3 keyboardScaleXYZ = glm::vec3(6.0f, .2f, 1.5f);
+	//Determine position
+	glm::vec3 keyboardPositionXYZ = glm::vec3(0.0f, 0.0f, 7.0f);
+	//Determine rotation
+	float keyboardXrotationDegrees = 0.0f;
+	float keyboardYrotationDegrees = 0.0f;
+	float keyboardZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
+	//Sets matertial
+	SetTextureEnabled(false);
+	SetShaderMaterial("blackPlastic");
+	//Confirm transformations
+	SetTransformations(
+		keyboardScaleXYZ,
+		keyboardXrotationDegrees,
+		keyboardYrotationDegrees,
+		keyboardZrotationDegrees,
+		keyboardPositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_BOX);
+
+	// Determine size of keys
+	glm::vec3 keyScaleXYZ = glm::vec3(0.2f, 0.2f, 0.2f);
+
+	// Calculate number of keys horizontally and vertically
+	int horizontalSpace = static_cast<int>(keyboardScaleXYZ.x / (keyScaleXYZ.x + 0.1f));
+	int verticalSpace = static_cast<int>(keyboardScaleXYZ.z / (keyScaleXYZ.z + 0.1f));
+
+	// Draw keys
+	for (int v = 0; v < verticalSpace; v++) {
+		for (int h = 0; h < horizontalSpace; h++) {
+			// Calculate position for each key
+			glm::vec3 keyPositionXYZ = keyboardPositionXYZ;
+			keyPositionXYZ.y += 0.1f; // Slightly above keyboard
+			keyPositionXYZ.x = keyboardPositionXYZ.x - ((keyboardScaleXYZ.x / 2) - .15f) + ((keyScaleXYZ.x + 0.1f) * h);
+			keyPositionXYZ.z = keyboardPositionXYZ.z - ((keyboardScaleXYZ.z / 2) - .15f) + ((keyScaleXYZ.z + 0.1f) * v);
+
+			// Apply transformations
+			SetTransformations(
+				keyScaleXYZ,
+				0.0f, 0.0f, 0.0f,
+				keyPositionXYZ
+			);
+
+			// Draw key
+			//SetShaderColor(0.6f, 0.6f, 0.6f, 1.0f);
+			//Sets matertial
+			SetShaderMaterial("blackPlastic");
+			DrawShapeMesh(SHAPE_BOX);
+		}
+	}
+
+	//Draw mouse. 
+
+	//Determine size
+	glm::vec3 mouseScaleXYZ = glm::vec3(0.4f, 0.2f, 0.7f);
+	//Determine position
+	glm::vec3 mousePositionXYZ = glm::vec3(4.0f, 0.0f, 9.0f);
+	//Determine rotation
+	float mouseXrotationDegrees = 0.0f;
+	float mouseYrotationDegrees = 0.0f;
+	float mouseZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
+	//Sets matertial
+	SetShaderMaterial("blackPlastic");
+	//Confirm transformations
+	SetTransformations(
+		mouseScaleXYZ,
+		mouseXrotationDegrees,
+		mouseYrotationDegrees,
+		mouseZrotationDegrees,
+		mousePositionXYZ);
+	//Draw the mesh - the mouse can be moved around, so it is
+	//never merged with the rest of the desk
+	SetObjectStatic(false);
+	DrawShapeMesh(SHAPE_HALF_SPHERE);
+	SetObjectStatic(true);
+
+	//Draw the speakers. 
+
+	//Speaker 1:
+
+	//Draw the speaker base:
+	//Determine size
+	glm::vec3 speaker1ScaleXYZ = glm::vec3(.64f, 1.2f, .5f);
+	//Determine position
+	glm::vec3 speaker1PositionXYZ = glm::vec3(-4.0f, 0.1f, 6.0f);
+	//Determine rotation
+	float speaker1XrotationDegrees = 90.0f;
+	float speaker1YrotationDegrees = 0.0f;
+	float speaker1ZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
+	//Sets matertial
+	SetShaderMaterial("blackPlastic");
+	//Confirm transformations
+	SetTransformations(
+		speaker1ScaleXYZ,
+		speaker1XrotationDegrees,
+		speaker1YrotationDegrees,
+		speaker1ZrotationDegrees,
+		speaker1PositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_TORUS);
+
+	//Draw the speaker body:
+	//Determine size
+	glm::vec3 speakerBase1ScaleXYZ = glm::vec3(.7f, 3.f, .9f);
+	//Determine position
+	glm::vec3 speakerBase1PositionXYZ = speaker1PositionXYZ;
+	speakerBase1PositionXYZ.y += .07f;
+	speakerBase1PositionXYZ.z += .3f;
+	//Determine rotation
+	float speakerBase1XrotationDegrees = 0.0f;
+	float speakerBase1YrotationDegrees = 0.0f;
+	float speakerBase1ZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
+	//Sets matertial
+	SetShaderMaterial("blackPlastic");
+	//Confirm transformations
+	SetTransformations(
+		speakerBase1ScaleXYZ,
+		speakerBase1XrotationDegrees,
+		speakerBase1YrotationDegrees,
+		speakerBase1ZrotationDegrees,
+		speakerBase1PositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_CYLINDER);
+
+	//Speaker 2:
+
+	//Draw the speaker base:
+	//Determine size
+	glm::vec3 speaker2ScaleXYZ = glm::vec3(.64f, 1.2f, .5f);
+	//Determine position
+	glm::vec3 speaker2PositionXYZ = glm::vec3(4.0f, 0.1f, 6.0f);
+	//Determine rotation
+	float speaker2XrotationDegrees = 90.0f;
+	float speaker2YrotationDegrees = 0.0f;
+	float speaker2ZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
+	//Sets matertial
+	SetShaderMaterial("blackPlastic");
+	//Confirm transformations
+	SetTransformations(
+		speaker2ScaleXYZ,
+		speaker2XrotationDegrees,
+		speaker2YrotationDegrees,
+		speaker2ZrotationDegrees,
+		speaker2PositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_TORUS);
+
+	//Draw the speaker body:
+	//Determine size
+	glm::vec3 speakerBase2ScaleXYZ = glm::vec3(.7f, 3.f, .9f);
+	//Determine position
+	glm::vec3 speakerBase2PositionXYZ = speaker2PositionXYZ;
+	speakerBase2PositionXYZ.y += .07f;
+	speakerBase2PositionXYZ.z += .3f;
+	//Determine rotation
+	float speakerBase2XrotationDegrees = 0.0f;
+	float speakerBase2YrotationDegrees = 0.0f;
+	float speakerBase2ZrotationDegrees = 0.0f;
+	//Determine color: grey
+	//SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
+	//Sets matertial
+	SetShaderMaterial("blackPlastic");
+	//Confirm transformations
+	SetTransformations(
+		speakerBase2ScaleXYZ,
+		speakerBase2XrotationDegrees,
+		speakerBase2YrotationDegrees,
+		speakerBase2ZrotationDegrees,
+		speakerBase2PositionXYZ);
+	//Draw the mesh
+	DrawShapeMesh(SHAPE_CYLINDER);
+}
+
+/***********************************************************
+ *  RenderScenePathTraced()
+ *
+ *  This method is used for refining the path traced
+ *  reference image of the scene by one sample per pixel.
+ *  The samples add up while the camera set by
+ *  SetViewParameters() stays the same.
+ ***********************************************************/
+void SceneManager::RenderScenePathTraced(int width, int height, const PATH_TRACE_SETTINGS& settings)
+{
+	if (NULL == m_pPathTracer)
+	{
+		m_pPathTracer = new PathTracer(m_pThreadPool);
+	}
+	if ((m_pPathTracer->GetWidth() != width) || (m_pPathTracer->GetHeight() != height))
+	{
+		m_pPathTracer->Resize(width, height);
+	}
+
+	CollectSoftwareDraws(true);
+
+	m_pPathTracer->SetSettings(settings);
+	m_pPathTracer->SetCamera(m_viewMatrix, m_projectionMatrix, m_viewPosition);
+	m_pPathTracer->SetLights(m_lightSources);
+	m_pPathTracer->Render(m_softwareDraws);
+}
+
+/***********************************************************
+ *  GetPathTracedSampleCount()
+ *
+ *  This method is used for getting how many samples per
+ *  pixel the path traced image holds.
+ ***********************************************************/
+int SceneManager::GetPathTracedSampleCount() const
+{
+	if (NULL == m_pPathTracer)
+	{
+		return(0);
+	}
+
+	return(m_pPathTracer->GetSampleCount());
+}
+
+/***********************************************************
+ *  SavePathTracedFrame()
+ *
+ *  This method is used for writing the path traced image
+ *  into an image file.
+ ***********************************************************/
+bool SceneManager::SavePathTracedFrame(const char* filename)
+{
+	if (NULL == m_pPathTracer)
+	{
+		return false;
+	}
+
+	return(m_pPathTracer->SaveImage(filename));
+}
@@ -1,114 +1,401 @@
-///////////////////////////////////////////////////////////////////////////////
-// shadermanager.h
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "ShapeMeshes.h"
-
-#include <string>
-#include <vector>
-
-/***********************************************************
- *  SceneManager
- *
- *  This class contains the code for preparing and rendering
- *  3D scenes, including the shader settings.
- ***********************************************************/
-class SceneManager
-{
-public:
-	// constructor
-	SceneManager(ShaderManager *pShaderManager);
-	// destructor
-	~SceneManager();
-
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
-	struct OBJECT_MATERIAL
-	{
-		float ambientStrength;
-		glm::vec3 ambientColor;
-		glm::vec3 diffuseColor;
-		glm::vec3 specularColor;
-		float shininess;
-		std::string tag;
-	};
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
-	// defined object materials
-	std::vector<OBJECT_MATERIAL> m_objectMaterials;
-
-	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
-	void BindGLTextures();
-	// free the loaded OpenGL textures
-	void DestroyGLTextures();
-	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
-	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
-
-	// set the UV scale for the texture mapping
-	void SetTextureUVScale(
-		float u, float v);
-
-	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
-
-public:
-
-	// The following methods are for the students to 
-	// customize for their own 3D scene
-	void PrepareScene();
-	void RenderScene();
-
-	// loads textures from image files
-	void LoadSceneTextures();
-
-	// pre-set light sources for 3D scene
-	void SetupSceneLights();
-	// pre-define the object materials for lighting
-	void DefineObjectMaterials();
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.h
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "DebugViewRenderer.h"
+#include "MeshImporter.h"
+#include "MeshHeap.h"
+#include "MeshletBuilder.h"
+#include "MeshUploadQueue.h"
+#include "ProceduralMeshes.h"
+#include "RenderBackend.h"
+#include "SceneCollision.h"
+#include "SceneObject.h"
+#include "ScenePicker.h"
+#include "ShadingModel.h"
+#include "SoftwareRasterizer.h"
+#include "RayTracer.h"
+#include "PathTracer.h"
+#include "StaticBatcher.h"
+#include "ThreadPool.h"
+
+#include <future>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SceneManager
+ *
+ *  This class contains the code for preparing and rendering
+ *  3D scenes, including the shader settings.
+ ***********************************************************/
+class SceneManager
+{
+public:
+	// constructor - without a backend only the CPU renderers
+	// can draw the scene
+	SceneManager(RenderBackend* pBackend);
+	// destructor
+	~SceneManager();
+
+	struct TEXTURE_INFO
+	{
+		std::string tag;
+		uint32_t ID;
+	};
+
+	struct OBJECT_MATERIAL
+	{
+		float ambientStrength;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		std::string tag;
+	};
+
+	struct MESH_INFO
+	{
+		std::string tag;
+		// ranges of the mesh in the mesh heap, or -1
+		int heapHandle;
+		// clusters of high polygon meshes, or NULL
+		MESHLET_DATA* pMeshlets;
+		// cull clusters facing away (closed meshes only)
+		bool bCullBackFaces;
+		// object space bounding sphere
+		glm::vec3 center;
+		float radius;
+	};
+
+	struct SHAPE_INFO
+	{
+		// detail levels, finest first - a negative heap handle
+		// means the level has not been uploaded
+		MESH_INFO lods[SHAPE_MAX_LODS];
+		int nLODs;
+		// object space bounding sphere of the shape
+		glm::vec3 center;
+		float radius;
+		// CPU copies of the detail levels, used for baking
+		MESH_DATA meshes[SHAPE_MAX_LODS];
+	};
+
+	struct STATIC_BATCH
+	{
+		// merged world space mesh in the mesh heap at each
+		// detail level, finest first
+		MESH_INFO lods[SHAPE_MAX_LODS];
+		int nLODs;
+		// shader settings shared by the merged objects
+		SCENE_OBJECT state;
+		// world space bounds for culling
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+		// world space radius of the largest merged object
+		float objectRadius;
+	};
+
+private:
+	// the microbenchmarks time the private hot paths
+	friend class SceneBenchmarks;
+
+	// backend the scene is rendered through, or NULL
+	RenderBackend* m_pBackend;
+	// generated basic shapes info
+	SHAPE_INFO m_shapeMeshes[SHAPE_COUNT];
+	// generated meshes waiting for the OpenGL thread
+	MeshUploadQueue m_meshUploads;
+	// total number of loaded textures
+	int m_loadedTextures;
+	// loaded textures info
+	TEXTURE_INFO m_textureIDs[16];
+	// CPU copies of the loaded textures, in the same slots
+	SCENE_TEXTURE m_textureImages[16];
+	// defined object materials
+	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// light sources of the scene
+	std::vector<SCENE_LIGHT> m_lightSources;
+	// worker threads for loading and generating scene data
+	ThreadPool* m_pThreadPool;
+	// parser for external model files
+	MeshImporter* m_pMeshImporter;
+	// loaded external meshes info
+	std::vector<MESH_INFO> m_importedMeshes;
+	// CPU copies of the loaded external meshes, in the same order
+	std::vector<MESH_DATA> m_importedMeshData;
+	// external meshes that are still being parsed
+	struct PENDING_MESH
+	{
+		MESH_DATA* pMesh;
+		MESHLET_DATA* pMeshlets;
+		bool bClosedMesh;
+		std::future<bool> result;
+	};
+	std::vector<PENDING_MESH> m_pendingMeshes;
+	// shared buffers holding every uploaded mesh
+	MeshHeap m_meshHeap;
+	// scratch list of visible cluster draw commands
+	std::vector<DRAW_ELEMENTS_INDIRECT_COMMAND> m_meshletCommands;
+	// settings of the object about to be drawn
+	SCENE_OBJECT m_currentObject;
+	// objects RenderScene() draws, captured once by
+	// RecordScene() and read by the picker, the collision
+	// grid, the static batches and the CPU renderers
+	std::vector<SCENE_OBJECT> m_sceneObjects;
+	bool m_bSceneCaptured;
+	// true while RenderScene() only captures objects
+	bool m_bRecordingScene;
+	// merged static objects, drawn in place of the originals
+	std::vector<STATIC_BATCH> m_staticBatches;
+	bool m_bStaticBaked;
+	// boxes of the moving and the shiny objects drawn since
+	// the last BeginScene()
+	std::vector<RESHADE_BOUNDS> m_reshadeBounds;
+	// CPU renderer for machines without a GPU, created on
+	// first use, and the draws of its current frame
+	SoftwareRasterizer* m_pSoftwareRasterizer;
+	std::vector<SOFTWARE_DRAW> m_softwareDraws;
+	// CPU ray tracer for still images, created on first use
+	RayTracer* m_pRayTracer;
+	// progressive path tracer for reference images, created
+	// on first use
+	PathTracer* m_pPathTracer;
+	// hierarchy for picking objects with the mouse, created
+	// on first use, with m_sceneObjects as its objects
+	ScenePicker* m_pScenePicker;
+	bool m_bPickerBuilt;
+	// boxes of the objects for overlap and sweep queries,
+	// placed at the first request
+	SceneCollision m_collision;
+	bool m_bCollisionBuilt;
+	// transformation of the object being drawn
+	glm::mat4 m_modelMatrix;
+	// camera of the current frame
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+	glm::vec3 m_viewPosition;
+	// debug view the draws are colored for, and the size of
+	// the frame in pixels
+	DEBUG_VIEW m_debugView;
+	int m_debugViewWidth;
+	int m_debugViewHeight;
+
+	// load texture images and convert to OpenGL texture data
+	bool CreateGLTexture(const char* filename, std::string tag);
+	// bind loaded OpenGL textures to slots in memory
+	void BindGLTextures();
+	// free the loaded OpenGL textures
+	void DestroyGLTextures();
+	// find a loaded texture by tag
+	int FindTextureID(std::string tag);
+	int FindTextureSlot(std::string tag);
+	// find a defined material by tag
+	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
+
+	// copy parsed mesh data into the mesh heap
+	bool CreateGLMesh(const MESH_DATA& mesh, MESHLET_DATA* pMeshlets, bool bClosedMesh, MESH_INFO& meshInfo);
+	// return the heap ranges of one mesh
+	void DestroyGLMesh(MESH_INFO& meshInfo);
+	// free the loaded OpenGL meshes
+	void DestroyGLMeshes();
+	// find a loaded external mesh by tag
+	int FindMeshIndex(std::string tag);
+
+	// set the transformation values 
+	// into the transform buffer
+	void SetTransformations(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// set the color values into the shader
+	void SetShaderColor(
+		float redColorValue,
+		float greenColorValue,
+		float blueColorValue,
+		float alphaValue);
+
+	// set the texture data into the shader
+	void SetShaderTexture(
+		std::string textureTag);
+
+	// set the UV scale for the texture mapping
+	void SetTextureUVScale(
+		float u, float v);
+
+	// set the object material into the shader
+	void SetShaderMaterial(
+		std::string materialTag);
+
+	// turn texturing on or off for the next objects
+	void SetTextureEnabled(
+		bool bUseTexture);
+
+	// mark the next objects as never moving (the default
+	// at the start of each frame) or as moving
+	void SetObjectStatic(
+		bool bStatic);
+
+	// true when the current object's settings should only be
+	// remembered, not sent to the shader
+	bool IsObjectDeferred() const;
+	// send all the settings of an object to the shader
+	void ApplyObjectState(
+		const SCENE_OBJECT& object);
+
+	// start a frame by drawing the baked static objects
+	void BeginScene();
+
+	// whether a material's highlights are small enough to
+	// slide visibly as the camera moves
+	bool IsSpecularMaterial(
+		const std::string& materialTag);
+	// remember the box of the object about to be drawn when
+	// it moves or is shiny
+	void AddReshadeBounds(
+		const glm::vec3& center,
+		float radius);
+
+	// draw an uploaded mesh with the current settings
+	void DrawGLMesh(
+		const MESH_INFO& meshInfo);
+
+	// draw a loaded external mesh
+	void DrawImportedMesh(
+		std::string meshTag);
+
+	// draw a basic shape at the detail level that suits
+	// its size on screen
+	void DrawShapeMesh(
+		SHAPE_TYPE shape);
+	// detail level that suits a shape's size on screen
+	int SelectShapeLOD(
+		SHAPE_TYPE shape,
+		const glm::mat4& model) const;
+	// detail level that suits the largest object of a static
+	// batch at the batch's nearest point
+	int SelectBatchLOD(
+		const STATIC_BATCH& batch) const;
+	// fraction of half the viewport height an object space
+	// bounding sphere covers
+	float GetScreenSize(
+		const glm::vec3& center,
+		float radius,
+		const glm::mat4& model) const;
+	// send the heat of a draw to the debug view program
+	void SetDebugValue(
+		const MESH_INFO& meshInfo,
+		size_t triangles);
+
+	// get the shader settings of an object for the CPU renderers
+	void GetSurfaceShading(
+		const SCENE_OBJECT& object,
+		SURFACE_SHADING& shading);
+	// turn the captured scene into m_softwareDraws, with the shapes
+	// at their most detailed level when bFullDetail is set
+	void CollectSoftwareDraws(bool bFullDetail);
+	// drop the ray tracing hierarchies of the meshes, before
+	// the meshes change or move in memory
+	void ClearTracedMeshes();
+	// place the objects of the captured scene in the picker
+	void BuildScenePicker();
+	// place the boxes of the captured scene's objects in the
+	// collision grid
+	void BuildSceneCollision();
+
+public:
+
+	// The following methods are for the students to 
+	// customize for their own 3D scene
+	void PrepareScene();
+	void RenderScene();
+
+	// set the camera used for culling in the next RenderScene()
+	void SetViewParameters(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		const glm::vec3& viewPosition);
+	// color the next draws for a debug view of a frame of the
+	// passed size, or stop with DEBUG_VIEW_NONE
+	void SetDebugView(
+		DEBUG_VIEW view,
+		int width,
+		int height);
+
+	// loads textures from image files
+	void LoadSceneTextures();
+	// starts loading meshes from external model files
+	void LoadSceneMeshes();
+
+	// start parsing an external model file in the background
+	void QueueImportedMesh(const char* filename, std::string tag, bool bClosedMesh);
+	// wait for the queued model files and upload them
+	void UploadImportedMeshes();
+	// drop a loaded external mesh and free its heap ranges
+	void UnloadImportedMesh(std::string tag);
+
+	// run RenderScene() without drawing to capture its
+	// objects, unless the last capture is still current
+	void RecordScene();
+	// draw the scene on the CPU into an image of the passed
+	// size, with the camera set by SetViewParameters()
+	void RenderSceneSoftware(int width, int height);
+	// write the last CPU rendered frame to an image file
+	bool SaveSoftwareFrame(const char* filename);
+	// ray trace the scene into an image of the passed size,
+	// with the camera set by SetViewParameters()
+	void RenderSceneRayTraced(int width, int height, const RAY_TRACE_SETTINGS& settings);
+	// write the last ray traced frame to an image file
+	bool SaveRayTracedFrame(const char* filename);
+	// add one path traced sample per pixel to the reference
+	// image, which starts over when the camera moves
+	void RenderScenePathTraced(int width, int height, const PATH_TRACE_SETTINGS& settings);
+	// samples per pixel in the path traced image so far
+	int GetPathTracedSampleCount() const;
+	// write the path traced image to an image file
+	bool SavePathTracedFrame(const char* filename);
+	// find the closest object along a ray that reaches as far
+	// as its direction is long, such as one from GetCameraRay()
+	// - the scene is captured for it at the first call, and
+	// again after InvalidateSceneQueries()
+	bool PickObject(
+		const glm::vec3& origin,
+		const glm::vec3& direction,
+		PICK_RESULT& result,
+		SCENE_OBJECT& object);
+	// the boxes of the scene's objects, for keeping the camera
+	// out of them and for overlap and sweep queries - the
+	// object indices are those of the scene's draw order
+	const SceneCollision& GetCollision();
+	// boxes of the moving and the shiny objects of the last
+	// frame drawn, whose pixels are shaded again in the next
+	const std::vector<RESHADE_BOUNDS>& GetReshadeBounds() const;
+	// capture the scene again for the next pick, the CPU
+	// renderers and the collision grid, needed after objects
+	// have moved
+	void InvalidateSceneQueries();
+	// merge the static objects of the scene into batches
+	void BakeStaticGeometry();
+	// go back to drawing every object on its own
+	void ClearStaticGeometry();
+
+	// start generating the basic shapes in the background
+	void QueueShapeMeshes();
+	// upload the generated shapes as they finish
+	void UploadShapeMeshes();
+
+	// pre-set light sources for 3D scene
+	void SetupSceneLights();
+	// pre-define the object materials for lighting
+	void DefineObjectMaterials();
 };
\ No newline at end of file
@@ -0,0 +1,52 @@
+///////////////////////////////////////////////////////////////////////////////
+// sceneobject.h
+// ============
+// one drawn object of the 3D scene, captured as plain data
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ProceduralMeshes.h"
+
+#include <glm/glm.hpp>
+
+#include <string>
+
+/***********************************************************
+ *  SCENE_OBJECT
+ *
+ *  Everything needed to draw one object again without
+ *  running the scene code: its mesh, its transformation and
+ *  the shader settings that were active when it was drawn.
+ ***********************************************************/
+struct SCENE_OBJECT
+{
+	// basic shape, used when no external mesh tag is set
+	SHAPE_TYPE shape;
+	std::string meshTag;
+	glm::mat4 model;
+	std::string materialTag;
+	std::string textureTag;
+	bool bUseTexture;
+	glm::vec4 color;
+	glm::vec2 uvScale;
+	// objects that never move can be baked together
+	bool bStatic;
+};
+
+/***********************************************************
+ *  RESHADE_BOUNDS
+ *
+ *  World space box of an object drawn in a frame whose
+ *  pixels should not be reused in the next: one that moves,
+ *  or one shiny enough that its highlights slide over it
+ *  as the camera does.
+ ***********************************************************/
+struct RESHADE_BOUNDS
+{
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+	// false for a still object that is only shiny
+	bool bMoving;
+};
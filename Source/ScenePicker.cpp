@@ -0,0 +1,528 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenepicker.cpp
+// ============
+// find the scene object under a point of the screen on the CPU
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ScenePicker.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// deepest node BuildBVHNodes() makes, plus room for the
+	// children pushed at the bottom
+	const int g_StackSize = 64;
+
+	/***********************************************************
+	 *  IsFlattening()
+	 *
+	 *  True when a transformation squashes at least one axis
+	 *  to almost nothing, like the scene's screen planes with
+	 *  a height of zero, so it has no usable inverse.
+	 ***********************************************************/
+	bool IsFlattening(const glm::mat4& model)
+	{
+		glm::mat3 linear = glm::mat3(model);
+		float determinant = glm::dot(linear[0], glm::cross(linear[1], linear[2]));
+		float volume = glm::length(linear[0]) * glm::length(linear[1]) * glm::length(linear[2]);
+		return(std::fabs(determinant) <= volume * 1.0e-6f);
+	}
+
+	/***********************************************************
+	 *  IsExactShape()
+	 *
+	 *  True for the curved shapes that are tested as what
+	 *  their meshes approximate.  The flat sided shapes are
+	 *  exact as triangles already, and the torus is left to
+	 *  its mesh.
+	 ***********************************************************/
+	bool IsExactShape(SHAPE_TYPE shape)
+	{
+		return((SHAPE_SPHERE == shape) || (SHAPE_HALF_SPHERE == shape) || (SHAPE_CYLINDER == shape));
+	}
+
+	/***********************************************************
+	 *  SafeReciprocal()
+	 *
+	 *  One over a direction component, keeping zero
+	 *  components away from the infinity times zero case of
+	 *  the slab test.
+	 ***********************************************************/
+	float SafeReciprocal(float value)
+	{
+		if (std::fabs(value) < 1.0e-20f)
+		{
+			value = (value < 0.0f) ? -1.0e-20f : 1.0e-20f;
+		}
+		return(1.0f / value);
+	}
+
+	/***********************************************************
+	 *  RayHitsBox()
+	 *
+	 *  Slab test of one ray against a node, giving the
+	 *  distance where the ray enters the box.
+	 ***********************************************************/
+	bool RayHitsBox(
+		const BVH_NODE& node,
+		const glm::vec3& origin,
+		const glm::vec3& inverseDirection,
+		float tMax,
+		float& entry)
+	{
+		glm::vec3 t0 = (node.boundsMin - origin) * inverseDirection;
+		glm::vec3 t1 = (node.boundsMax - origin) * inverseDirection;
+		glm::vec3 tNear = glm::min(t0, t1);
+		glm::vec3 tFar = glm::max(t0, t1);
+		entry = std::max(std::max(tNear.x, tNear.y), tNear.z);
+		float exit = std::min(std::min(tFar.x, tFar.y), tFar.z);
+		return((exit >= std::max(entry, 0.0f)) && (entry < tMax));
+	}
+
+	/***********************************************************
+	 *  HitDisc()
+	 *
+	 *  Ray against a flat cap of radius 1 across the Y axis
+	 *  at the passed height, in the space of the shape.
+	 ***********************************************************/
+	bool HitDisc(const glm::vec3& origin, const glm::vec3& direction, float height, float& t, glm::vec3& normal)
+	{
+		if (direction.y == 0.0f)
+		{
+			return(false);
+		}
+		float candidate = (height - origin.y) / direction.y;
+		glm::vec3 point = origin + direction * candidate;
+		if ((candidate <= 0.0f) || (candidate >= t) || (point.x * point.x + point.z * point.z > 1.0f))
+		{
+			return(false);
+		}
+		t = candidate;
+		normal = glm::vec3(0.0f, 1.0f, 0.0f);
+		return(true);
+	}
+
+	/***********************************************************
+	 *  HitSphere()
+	 *
+	 *  Ray against the sphere of radius 1, or its upper half
+	 *  closed by a cap, in the space of the shape.  The
+	 *  nearer crossing is taken unless it lies behind the
+	 *  ray, past the hit found so far or below the half.
+	 ***********************************************************/
+	bool HitSphere(const glm::vec3& origin, const glm::vec3& direction, bool bHalf, float& t, glm::vec3& normal)
+	{
+		bool bHit = false;
+		float a = glm::dot(direction, direction);
+		float b = glm::dot(origin, direction);
+		float c = glm::dot(origin, origin) - 1.0f;
+		float discriminant = b * b - a * c;
+		if ((a > 0.0f) && (discriminant >= 0.0f))
+		{
+			float root = std::sqrt(discriminant);
+			float crossings[2] = { (-b - root) / a, (-b + root) / a };
+			for (int i = 0; (i < 2) && !bHit; i++)
+			{
+				glm::vec3 point = origin + direction * crossings[i];
+				if ((crossings[i] > 0.0f) && (crossings[i] < t) && (!bHalf || (point.y >= 0.0f)))
+				{
+					t = crossings[i];
+					normal = point;
+					bHit = true;
+				}
+			}
+		}
+		if (bHalf && HitDisc(origin, direction, 0.0f, t, normal))
+		{
+			bHit = true;
+		}
+		return(bHit);
+	}
+
+	/***********************************************************
+	 *  HitCylinder()
+	 *
+	 *  Ray against the cylinder of radius 1 from 0 to 1 in Y,
+	 *  closed at both ends, in the space of the shape.
+	 ***********************************************************/
+	bool HitCylinder(const glm::vec3& origin, const glm::vec3& direction, float& t, glm::vec3& normal)
+	{
+		bool bHit = false;
+		float a = direction.x * direction.x + direction.z * direction.z;
+		float b = origin.x * direction.x + origin.z * direction.z;
+		float c = origin.x * origin.x + origin.z * origin.z - 1.0f;
+		float discriminant = b * b - a * c;
+		if ((a > 0.0f) && (discriminant >= 0.0f))
+		{
+			float root = std::sqrt(discriminant);
+			float crossings[2] = { (-b - root) / a, (-b + root) / a };
+			for (int i = 0; (i < 2) && !bHit; i++)
+			{
+				glm::vec3 point = origin + direction * crossings[i];
+				if ((crossings[i] > 0.0f) && (crossings[i] < t) && (point.y >= 0.0f) && (point.y <= 1.0f))
+				{
+					t = crossings[i];
+					normal = glm::vec3(point.x, 0.0f, point.z);
+					bHit = true;
+				}
+			}
+		}
+		if (HitDisc(origin, direction, 0.0f, t, normal))
+		{
+			bHit = true;
+		}
+		if (HitDisc(origin, direction, 1.0f, t, normal))
+		{
+			bHit = true;
+		}
+		return(bHit);
+	}
+
+	/***********************************************************
+	 *  GetShapeBounds()
+	 *
+	 *  Box around an exactly tested shape in its own space.
+	 ***********************************************************/
+	void GetShapeBounds(SHAPE_TYPE shape, glm::vec3& boundsMin, glm::vec3& boundsMax)
+	{
+		boundsMin = glm::vec3(-1.0f, (SHAPE_SPHERE == shape) ? -1.0f : 0.0f, -1.0f);
+		boundsMax = glm::vec3(1.0f);
+	}
+}
+
+/***********************************************************
+ *  ScenePicker()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ScenePicker::ScenePicker(ThreadPool* pThreadPool)
+{
+	m_pThreadPool = pThreadPool;
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for building the hierarchies of the
+ *  meshes seen for the first time, in parallel, and then
+ *  the hierarchy over the objects.  Objects with neither a
+ *  shape to test nor triangles are left out.
+ ***********************************************************/
+void ScenePicker::Build(const std::vector<PICK_OBJECT>& objects)
+{
+	std::vector<MeshBVH*> buildTargets;
+	std::vector<const MESH_DATA*> buildMeshes;
+	std::vector<glm::mat4> buildTransforms;
+
+	// 0 leaves an object out, 1 tests its shape, 2 its mesh
+	// hierarchy and 3 a world space one
+	std::vector<char> objectKinds(objects.size(), 0);
+	size_t flattenedCount = 0;
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		const PICK_OBJECT& object = objects[i];
+		bool bFlattening = IsFlattening(object.model);
+		bool bHasMesh = (NULL != object.pMesh) && !object.pMesh->indices.empty();
+		if (IsExactShape(object.shape) && !bFlattening)
+		{
+			objectKinds[i] = 1;
+		}
+		else if (bHasMesh)
+		{
+			objectKinds[i] = bFlattening ? 3 : 2;
+			flattenedCount += bFlattening ? 1 : 0;
+		}
+	}
+	m_worldBVHs.clear();
+	m_worldBVHs.resize(flattenedCount);
+
+	std::vector<MeshBVH*> objectBVHs(objects.size(), NULL);
+	size_t flattenedIndex = 0;
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		const PICK_OBJECT& object = objects[i];
+		if (3 == objectKinds[i])
+		{
+			objectBVHs[i] = &m_worldBVHs[flattenedIndex++];
+			buildTargets.push_back(objectBVHs[i]);
+			buildMeshes.push_back(object.pMesh);
+			buildTransforms.push_back(object.model);
+		}
+		else if (2 == objectKinds[i])
+		{
+			std::map<const MESH_DATA*, MeshBVH>::iterator cached = m_meshBVHs.find(object.pMesh);
+			if (cached == m_meshBVHs.end())
+			{
+				cached = m_meshBVHs.insert(std::make_pair(object.pMesh, MeshBVH())).first;
+				buildTargets.push_back(&cached->second);
+				buildMeshes.push_back(object.pMesh);
+				buildTransforms.push_back(glm::mat4(1.0f));
+			}
+			objectBVHs[i] = &cached->second;
+		}
+	}
+
+	m_pThreadPool->ParallelFor(
+		buildTargets.size(),
+		1,
+		[&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			buildTargets[i]->Build(*buildMeshes[i], buildTransforms[i]);
+		}
+	});
+
+	std::vector<PICK_INSTANCE> instances;
+	std::vector<glm::vec3> instanceMin;
+	std::vector<glm::vec3> instanceMax;
+	instances.reserve(objects.size());
+	instanceMin.reserve(objects.size());
+	instanceMax.reserve(objects.size());
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		const PICK_OBJECT& object = objects[i];
+		if ((0 == objectKinds[i]) || ((NULL != objectBVHs[i]) && objectBVHs[i]->IsEmpty()))
+		{
+			continue;
+		}
+
+		PICK_INSTANCE instance;
+		instance.pBVH = objectBVHs[i];
+		instance.pMesh = object.pMesh;
+		instance.shape = object.shape;
+		instance.model = object.model;
+		instance.object = static_cast<int>(i);
+
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+		if (3 == objectKinds[i])
+		{
+			instance.worldToObject = glm::mat4(1.0f);
+			boundsMin = objectBVHs[i]->GetBoundsMin();
+			boundsMax = objectBVHs[i]->GetBoundsMax();
+		}
+		else
+		{
+			instance.worldToObject = glm::inverse(object.model);
+			glm::vec3 objectMin;
+			glm::vec3 objectMax;
+			if (1 == objectKinds[i])
+			{
+				GetShapeBounds(object.shape, objectMin, objectMax);
+			}
+			else
+			{
+				objectMin = objectBVHs[i]->GetBoundsMin();
+				objectMax = objectBVHs[i]->GetBoundsMax();
+			}
+			TransformBounds(object.model, objectMin, objectMax, boundsMin, boundsMax);
+		}
+
+		instances.push_back(instance);
+		instanceMin.push_back(boundsMin);
+		instanceMax.push_back(boundsMax);
+	}
+
+	// the objects are stored in leaf order, so a leaf reads
+	// neighbours in memory
+	std::vector<uint32_t> order;
+	BuildBVHNodes(instanceMin, instanceMax, 1, m_nodes, order);
+	m_instances.resize(instances.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		m_instances[i] = instances[order[i]];
+	}
+}
+
+/***********************************************************
+ *  ClearMeshCache()
+ *
+ *  This method is used for dropping the objects and the
+ *  mesh hierarchies, so they are rebuilt from the current
+ *  mesh data by the next Build().
+ ***********************************************************/
+void ScenePicker::ClearMeshCache()
+{
+	m_meshBVHs.clear();
+	m_worldBVHs.clear();
+	m_nodes.clear();
+	m_instances.clear();
+}
+
+/***********************************************************
+ *  IsEmpty()
+ *
+ *  This method is used for checking if there is anything
+ *  to pick.
+ ***********************************************************/
+bool ScenePicker::IsEmpty() const
+{
+	return(m_nodes.empty());
+}
+
+/***********************************************************
+ *  Pick()
+ *
+ *  This method is used for finding the closest object hit
+ *  by a ray.  The boxes are walked nearest child first,
+ *  and a box further away than the closest hit so far is
+ *  never opened, so most objects the ray passes near are
+ *  not tested at all.
+ ***********************************************************/
+bool ScenePicker::Pick(const glm::vec3& origin, const glm::vec3& direction, PICK_RESULT& result) const
+{
+	result.object = -1;
+	if (m_nodes.empty())
+	{
+		return(false);
+	}
+
+	BVH_RAY ray;
+	ray.origin = origin;
+	ray.direction = direction;
+	ray.t = 1.0f;
+	ray.u = 0.0f;
+	ray.v = 0.0f;
+	ray.triangle = -1;
+	ray.instance = -1;
+
+	glm::vec3 inverseDirection(
+		SafeReciprocal(direction.x),
+		SafeReciprocal(direction.y),
+		SafeReciprocal(direction.z));
+
+	uint32_t stack[g_StackSize];
+	float stackEntry[g_StackSize];
+	int stackSize = 0;
+
+	float entry = 0.0f;
+	if (!RayHitsBox(m_nodes[0], origin, inverseDirection, ray.t, entry))
+	{
+		return(false);
+	}
+	stack[0] = 0;
+	stackEntry[0] = entry;
+	stackSize = 1;
+
+	glm::vec3 normal(0.0f);
+	while (stackSize > 0)
+	{
+		stackSize--;
+		if (stackEntry[stackSize] >= ray.t)
+		{
+			continue;
+		}
+		const BVH_NODE& node = m_nodes[stack[stackSize]];
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				if (IntersectInstance(m_instances[i], ray, normal))
+				{
+					result.object = m_instances[i].object;
+				}
+			}
+			continue;
+		}
+
+		float entryA = 0.0f;
+		float entryB = 0.0f;
+		bool bHitA = RayHitsBox(m_nodes[node.first], origin, inverseDirection, ray.t, entryA);
+		bool bHitB = RayHitsBox(m_nodes[node.first + 1], origin, inverseDirection, ray.t, entryB);
+
+		// the nearer child goes on top of the stack
+		if (bHitA && bHitB && (entryB < entryA))
+		{
+			stack[stackSize] = node.first;
+			stackEntry[stackSize++] = entryA;
+			stack[stackSize] = node.first + 1;
+			stackEntry[stackSize++] = entryB;
+		}
+		else
+		{
+			if (bHitB)
+			{
+				stack[stackSize] = node.first + 1;
+				stackEntry[stackSize++] = entryB;
+			}
+			if (bHitA)
+			{
+				stack[stackSize] = node.first;
+				stackEntry[stackSize++] = entryA;
+			}
+		}
+	}
+
+	if (result.object < 0)
+	{
+		return(false);
+	}
+
+	result.t = ray.t;
+	result.position = origin + direction * ray.t;
+	float normalLength = glm::length(normal);
+	result.normal = (normalLength > 0.0f) ? (normal / normalLength) : glm::vec3(0.0f);
+	if (glm::dot(result.normal, direction) > 0.0f)
+	{
+		result.normal = -result.normal;
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  IntersectInstance()
+ *
+ *  This method is used for moving the ray into the space
+ *  of an object and testing its shape or its triangles
+ *  there.  The direction is not normalized, so the hit
+ *  distance stays the same in both spaces.  The world
+ *  space normal of a hit is returned, not normalized.
+ ***********************************************************/
+bool ScenePicker::IntersectInstance(const PICK_INSTANCE& instance, BVH_RAY& ray, glm::vec3& normal) const
+{
+	glm::vec3 origin = glm::vec3(instance.worldToObject * glm::vec4(ray.origin, 1.0f));
+	glm::vec3 direction = glm::vec3(instance.worldToObject * glm::vec4(ray.direction, 0.0f));
+
+	if (NULL == instance.pBVH)
+	{
+		glm::vec3 shapeNormal(0.0f);
+		bool bHit = (SHAPE_CYLINDER == instance.shape) ?
+			HitCylinder(origin, direction, ray.t, shapeNormal) :
+			HitSphere(origin, direction, SHAPE_HALF_SPHERE == instance.shape, ray.t, shapeNormal);
+		if (bHit)
+		{
+			// normals go out by the inverse transpose
+			normal = glm::transpose(glm::mat3(instance.worldToObject)) * shapeNormal;
+		}
+		return(bHit);
+	}
+
+	BVH_RAY meshRay = ray;
+	meshRay.origin = origin;
+	meshRay.direction = direction;
+	if (!instance.pBVH->Intersect(meshRay, instance.object))
+	{
+		return(false);
+	}
+	ray.t = meshRay.t;
+	ray.u = meshRay.u;
+	ray.v = meshRay.v;
+	ray.triangle = meshRay.triangle;
+	ray.instance = meshRay.instance;
+
+	// the face normal of the placed triangle, which is right
+	// for the world space hierarchies as well
+	const MESH_DATA& mesh = *instance.pMesh;
+	glm::vec3 a = glm::vec3(instance.model * glm::vec4(mesh.vertices[mesh.indices[ray.triangle * 3]].position, 1.0f));
+	glm::vec3 b = glm::vec3(instance.model * glm::vec4(mesh.vertices[mesh.indices[ray.triangle * 3 + 1]].position, 1.0f));
+	glm::vec3 c = glm::vec3(instance.model * glm::vec4(mesh.vertices[mesh.indices[ray.triangle * 3 + 2]].position, 1.0f));
+	normal = glm::cross(b - a, c - a);
+	return(true);
+}
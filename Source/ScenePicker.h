@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenepicker.h
+// ============
+// find the scene object under a point of the screen on the CPU
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshBVH.h"
+#include "ProceduralMeshes.h"
+#include "ThreadPool.h"
+
+#include <glm/glm.hpp>
+
+#include <map>
+#include <vector>
+
+/***********************************************************
+ *  PICK_OBJECT
+ *
+ *  One object that can be picked.  The spheres, the half
+ *  sphere and the cylinder are tested as the exact shapes,
+ *  everything else against the triangles of its mesh.
+ ***********************************************************/
+struct PICK_OBJECT
+{
+	// the object's triangles, which may be NULL for the
+	// exactly tested shapes
+	const MESH_DATA* pMesh;
+	// basic shape, or SHAPE_COUNT for an external mesh
+	SHAPE_TYPE shape;
+	glm::mat4 model;
+};
+
+/***********************************************************
+ *  PICK_RESULT
+ *
+ *  The closest object a ray hit.
+ ***********************************************************/
+struct PICK_RESULT
+{
+	// index in the list passed to Build(), or -1
+	int object;
+	// distance along the ray, in lengths of its direction
+	float t;
+	glm::vec3 position;
+	// world space normal facing the ray, normalized
+	glm::vec3 normal;
+};
+
+/***********************************************************
+ *  ScenePicker
+ *
+ *  This class answers which object a ray hits first, for
+ *  selecting objects with the mouse.  It keeps its own
+ *  hierarchy over the world space boxes of the objects,
+ *  with the objects stored in leaf order, and only tests
+ *  the shapes or the mesh hierarchies of the boxes the ray
+ *  reaches, nearest first, so a pick takes microseconds in
+ *  scenes of many thousands of objects.  The mesh
+ *  hierarchies are kept between builds like the tracers
+ *  keep theirs.
+ ***********************************************************/
+class ScenePicker
+{
+public:
+	// constructor
+	ScenePicker(ThreadPool* pThreadPool);
+
+	// place the objects, building the missing mesh hierarchies
+	// on the worker threads - the meshes must not change while
+	// their hierarchies are cached
+	void Build(const std::vector<PICK_OBJECT>& objects);
+	// forget the objects and the cached mesh hierarchies,
+	// needed before a mesh is changed or freed
+	void ClearMeshCache();
+	bool IsEmpty() const;
+
+	// find the closest object along the ray, up to one length
+	// of its direction away - returns false when none is hit
+	bool Pick(const glm::vec3& origin, const glm::vec3& direction, PICK_RESULT& result) const;
+
+private:
+	// an object in leaf order, with what it is tested against
+	struct PICK_INSTANCE
+	{
+		// the object's mesh hierarchy, or NULL for a shape
+		// tested exactly
+		const MeshBVH* pBVH;
+		const MESH_DATA* pMesh;
+		SHAPE_TYPE shape;
+		// rays are moved into the space of the mesh or the
+		// shape, and the normals out of it
+		glm::mat4 worldToObject;
+		glm::mat4 model;
+		int object;
+	};
+
+	// workers shared with the rest of the scene code
+	ThreadPool* m_pThreadPool;
+	// hierarchies of the meshes placed so far, in mesh space
+	std::map<const MESH_DATA*, MeshBVH> m_meshBVHs;
+	// world space hierarchies of the objects whose transform
+	// flattens them and so cannot be inverted
+	std::vector<MeshBVH> m_worldBVHs;
+	std::vector<BVH_NODE> m_nodes;
+	std::vector<PICK_INSTANCE> m_instances;
+
+	// test the ray against one object, shortening it to a hit
+	bool IntersectInstance(const PICK_INSTANCE& instance, BVH_RAY& ray, glm::vec3& normal) const;
+};
@@ -0,0 +1,392 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenereprojection.cpp
+// ============
+// reuse of the last frame's scene pixels the camera still sees
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneReprojection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// texture slots of the last frame's color and depth, past
+	// those the scene's materials use
+	const int g_ColorSlot = 10;
+	const int g_DepthSlot = 11;
+	// the tiles left out for shading are this many pixels on
+	// a side, and one in this many of them each frame
+	const int g_TileSize = 16;
+	const int g_TilePhases = 8;
+	// how much nearer than its surface a reused pixel is
+	// written, so the same surface drawn again fails the
+	// depth test - a few steps of a 24 bit depth buffer
+	const float g_DepthBias = 1.0f / 262144.0f;
+	// furthest the camera may move and turn in a frame with
+	// the last frame still reused
+	const float g_MaxCameraMove = 0.2f;
+	const float g_MaxCameraTurnDegrees = 3.0f;
+	// furthest the camera may move and turn in a frame with
+	// the pixels of shiny objects still reused, as their
+	// highlights follow the view
+	const float g_MaxShinyCameraMove = 0.02f;
+	const float g_MaxShinyCameraTurnDegrees = 0.25f;
+	// most frames in a row a pixel is reused before it is
+	// shaded again, one round of the tiles
+	const float g_MaxReuseFrames = 8.0f;
+	// rectangles the program takes, the same as the size of
+	// its array - more are merged into the last
+	const int g_MaxReshadeRects = 16;
+	// difference in any element of the projection that counts
+	// as a new one
+	const float g_ProjectionTolerance = 0.0001f;
+}
+
+/***********************************************************
+ *  SceneReprojection()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneReprojection::SceneReprojection(RenderBackend* pBackend) :
+	m_history(pBackend, RENDER_TARGET_RGBA16F, true)
+{
+	m_pBackend = pBackend;
+	m_program = 0;
+	m_triangleBuffer = 0;
+	m_triangleIndexBuffer = 0;
+	m_triangleLayout = 0;
+	m_previousView = glm::mat4(1.0f);
+	m_previousProjection = glm::mat4(1.0f);
+	m_width = 0;
+	m_height = 0;
+	m_tilePhase = 0;
+	m_reusedFrameCount = 0;
+	m_fullFrameCount = 0;
+}
+
+/***********************************************************
+ *  ~SceneReprojection()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneReprojection::~SceneReprojection()
+{
+	if (0 != m_triangleLayout)
+	{
+		m_pBackend->DestroyVertexLayout(m_triangleLayout);
+		m_triangleLayout = 0;
+	}
+	if (0 != m_triangleBuffer)
+	{
+		m_pBackend->DestroyBuffer(m_triangleBuffer);
+		m_triangleBuffer = 0;
+	}
+	if (0 != m_triangleIndexBuffer)
+	{
+		m_pBackend->DestroyBuffer(m_triangleIndexBuffer);
+		m_triangleIndexBuffer = 0;
+	}
+	m_pBackend = NULL;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for making the program that draws
+ *  the last frame into this one, and the triangle that
+ *  covers the frame for it.
+ ***********************************************************/
+bool SceneReprojection::Create(const char* vertexFilename, const char* fragmentFilename)
+{
+	m_program = m_pBackend->CreateProgram(vertexFilename, fragmentFilename);
+	if (0 == m_program)
+	{
+		std::cout << "Could not load the reprojection shaders" << std::endl;
+		return(false);
+	}
+
+	const float corners[6] = { -1.0f, -1.0f, 3.0f, -1.0f, -1.0f, 3.0f };
+	const uint32_t indices[3] = { 0, 1, 2 };
+	m_triangleBuffer = m_pBackend->CreateBuffer(BUFFER_VERTEX, sizeof(corners), corners);
+	m_triangleIndexBuffer = m_pBackend->CreateBuffer(BUFFER_INDEX, sizeof(indices), indices);
+
+	VERTEX_ATTRIBUTE attribute;
+	attribute.location = 0;
+	attribute.buffer = m_triangleBuffer;
+	attribute.components = 2;
+	attribute.stride = 2 * sizeof(float);
+	attribute.offset = 0;
+	m_triangleLayout = m_pBackend->CreateVertexLayout(&attribute, 1, m_triangleIndexBuffer);
+	return(0 != m_triangleLayout);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for making the targets of the frame
+ *  size, again when the size changes.
+ ***********************************************************/
+bool SceneReprojection::BeginFrame(int width, int height)
+{
+	m_width = width;
+	m_height = height;
+	return(m_history.BeginFrame(width, height));
+}
+
+/***********************************************************
+ *  Draw()
+ *
+ *  This method is used for drawing the pixels of the last
+ *  frame that can be reused into the target bound, which
+ *  is the current target with its color and depth cleared.
+ *  Nothing is drawn with no last frame, a new projection
+ *  or a camera jump.  The depth test stays on so the depth
+ *  of each reused pixel is written.  The last frame's
+ *  moving objects are always left out, and its shiny ones
+ *  when the camera has moved more than a little.
+ ***********************************************************/
+bool SceneReprojection::Draw(const glm::mat4& view, const glm::mat4& projection)
+{
+	if ((0 == m_program) || !m_history.HasHistory() || IsCameraJump(view, projection))
+	{
+		m_fullFrameCount++;
+		return(false);
+	}
+
+	PIPELINE_STATE state;
+	state.bDepthTest = true;
+	state.blendMode = BLEND_NONE;
+	m_pBackend->SetPipelineState(state);
+
+	uint32_t historyTarget = m_history.GetHistoryTarget();
+	m_pBackend->UseProgram(m_program);
+	m_pBackend->BindTexture(g_ColorSlot, m_pBackend->GetRenderTargetTexture(historyTarget));
+	m_pBackend->SetUniformSampler("previousColor", g_ColorSlot);
+	m_pBackend->BindTexture(g_DepthSlot, m_pBackend->GetRenderTargetDepthTexture(historyTarget));
+	m_pBackend->SetUniformSampler("previousDepth", g_DepthSlot);
+
+	// from the last frame's clip space to this one's
+	glm::mat4 viewProjection = projection * view;
+	m_pBackend->SetUniformMat4("forwardReprojection", glm::inverse(m_history.GetReprojection(viewProjection)));
+	m_pBackend->SetUniformInt("tileSize", g_TileSize);
+	m_pBackend->SetUniformInt("tilePhases", g_TilePhases);
+	m_pBackend->SetUniformInt("tilePhase", m_tilePhase);
+	m_pBackend->SetUniformFloat("depthBias", g_DepthBias);
+	m_pBackend->SetUniformFloat("maxReuseFrames", g_MaxReuseFrames);
+
+	std::vector<glm::vec4> rects = m_movingRects;
+	if (HasCameraMoved(view, g_MaxShinyCameraMove, g_MaxShinyCameraTurnDegrees))
+	{
+		rects.insert(rects.end(), m_shinyRects.begin(), m_shinyRects.end());
+	}
+	for (size_t i = g_MaxReshadeRects; i < rects.size(); i++)
+	{
+		glm::vec4& last = rects[g_MaxReshadeRects - 1];
+		last = glm::vec4(
+			std::min(last.x, rects[i].x), std::min(last.y, rects[i].y),
+			std::max(last.z, rects[i].z), std::max(last.w, rects[i].w));
+	}
+	int rectCount = (int)std::min(rects.size(), (size_t)g_MaxReshadeRects);
+	for (int i = 0; i < rectCount; i++)
+	{
+		m_pBackend->SetUniformVec4("reshadeRects[" + std::to_string(i) + "]", rects[i]);
+	}
+	m_pBackend->SetUniformInt("reshadeRectCount", rectCount);
+	m_pBackend->DrawIndexed(m_triangleLayout, 3, 0, 0);
+
+	m_reusedFrameCount++;
+	return(true);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for keeping the frame just drawn,
+ *  the camera it was drawn with and the pixels of its
+ *  moving and shiny objects for the next one.
+ ***********************************************************/
+void SceneReprojection::EndFrame(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	const std::vector<RESHADE_BOUNDS>& reshadeBounds)
+{
+	glm::mat4 viewProjection = projection * view;
+	m_movingRects.clear();
+	m_shinyRects.clear();
+	for (size_t i = 0; i < reshadeBounds.size(); i++)
+	{
+		glm::vec4 rect;
+		if (GetScreenRect(reshadeBounds[i], viewProjection, rect))
+		{
+			if (reshadeBounds[i].bMoving)
+			{
+				m_movingRects.push_back(rect);
+			}
+			else
+			{
+				m_shinyRects.push_back(rect);
+			}
+		}
+	}
+
+	m_history.EndFrame(viewProjection);
+	m_previousView = view;
+	m_previousProjection = projection;
+	m_tilePhase = (m_tilePhase + 1) % g_TilePhases;
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for forgetting the last frame, so
+ *  the next one is drawn in full.
+ ***********************************************************/
+void SceneReprojection::Invalidate()
+{
+	m_history.Invalidate();
+}
+
+/***********************************************************
+ *  GetHistoryTarget()
+ *
+ *  This method is used for getting the target holding the
+ *  last frame's scene.
+ ***********************************************************/
+uint32_t SceneReprojection::GetHistoryTarget() const
+{
+	return(m_history.GetHistoryTarget());
+}
+
+/***********************************************************
+ *  GetCurrentTarget()
+ *
+ *  This method is used for getting the target this frame's
+ *  scene is drawn into.
+ ***********************************************************/
+uint32_t SceneReprojection::GetCurrentTarget() const
+{
+	return(m_history.GetCurrentTarget());
+}
+
+/***********************************************************
+ *  GetBytes()
+ *
+ *  This method is used for estimating the memory of the
+ *  targets.
+ ***********************************************************/
+size_t SceneReprojection::GetBytes() const
+{
+	return(m_history.GetBytes());
+}
+
+/***********************************************************
+ *  GetReusedFrameCount()
+ *
+ *  This method is used for getting the number of frames
+ *  that reused the one before.
+ ***********************************************************/
+size_t SceneReprojection::GetReusedFrameCount() const
+{
+	return(m_reusedFrameCount);
+}
+
+/***********************************************************
+ *  GetFullFrameCount()
+ *
+ *  This method is used for getting the number of frames
+ *  drawn in full.
+ ***********************************************************/
+size_t SceneReprojection::GetFullFrameCount() const
+{
+	return(m_fullFrameCount);
+}
+
+/***********************************************************
+ *  IsCameraJump()
+ *
+ *  This method is used for checking whether the camera has
+ *  moved or turned further since the last frame than a
+ *  slow pan does, or the projection has changed, when too
+ *  little of the last frame would be left to be worth the
+ *  reprojection.
+ ***********************************************************/
+bool SceneReprojection::IsCameraJump(const glm::mat4& view, const glm::mat4& projection) const
+{
+	for (int column = 0; column < 4; column++)
+	{
+		for (int row = 0; row < 4; row++)
+		{
+			if (std::fabs(projection[column][row] - m_previousProjection[column][row]) > g_ProjectionTolerance)
+			{
+				return(true);
+			}
+		}
+	}
+
+	return(HasCameraMoved(view, g_MaxCameraMove, g_MaxCameraTurnDegrees));
+}
+
+/***********************************************************
+ *  HasCameraMoved()
+ *
+ *  This method is used for checking whether the camera has
+ *  moved or turned further since the last frame than the
+ *  passed distance and angle.
+ ***********************************************************/
+bool SceneReprojection::HasCameraMoved(const glm::mat4& view, float maxMove, float maxTurnDegrees) const
+{
+	// the camera's position and direction are the last and
+	// third columns of the inverse view, negated for the
+	// direction as the camera looks down -z
+	glm::mat4 camera = glm::inverse(view);
+	glm::mat4 previousCamera = glm::inverse(m_previousView);
+	if (glm::length(glm::vec3(camera[3]) - glm::vec3(previousCamera[3])) > maxMove)
+	{
+		return(true);
+	}
+	float turnCosine = glm::dot(glm::normalize(glm::vec3(camera[2])), glm::normalize(glm::vec3(previousCamera[2])));
+	return(turnCosine < std::cos(glm::radians(maxTurnDegrees)));
+}
+
+/***********************************************************
+ *  GetScreenRect()
+ *
+ *  This method is used for finding the pixels of the frame
+ *  a box covers, from its corners.  A box reaching behind
+ *  the camera covers the whole frame.
+ ***********************************************************/
+bool SceneReprojection::GetScreenRect(
+	const RESHADE_BOUNDS& bounds,
+	const glm::mat4& viewProjection,
+	glm::vec4& rect) const
+{
+	glm::vec2 size = glm::vec2((float)m_width, (float)m_height);
+	glm::vec2 lowest = size;
+	glm::vec2 highest = glm::vec2(0.0f);
+	for (int corner = 0; corner < 8; corner++)
+	{
+		glm::vec3 position = glm::vec3(
+			(corner & 1) ? bounds.boundsMax.x : bounds.boundsMin.x,
+			(corner & 2) ? bounds.boundsMax.y : bounds.boundsMin.y,
+			(corner & 4) ? bounds.boundsMax.z : bounds.boundsMin.z);
+		glm::vec4 clip = viewProjection * glm::vec4(position, 1.0f);
+		if (clip.w <= 0.0f)
+		{
+			rect = glm::vec4(0.0f, 0.0f, size.x, size.y);
+			return(true);
+		}
+		float x = (clip.x / clip.w * 0.5f + 0.5f) * size.x;
+		float y = (clip.y / clip.w * 0.5f + 0.5f) * size.y;
+		lowest = glm::vec2(std::min(lowest.x, x), std::min(lowest.y, y));
+		highest = glm::vec2(std::max(highest.x, x), std::max(highest.y, y));
+	}
+
+	rect = glm::vec4(
+		std::max(std::floor(lowest.x), 0.0f), std::max(std::floor(lowest.y), 0.0f),
+		std::min(std::ceil(highest.x), size.x), std::min(std::ceil(highest.y), size.y));
+	return((rect.x < rect.z) && (rect.y < rect.w));
+}
@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenereprojection.h
+// ============
+// reuse of the last frame's scene pixels the camera still sees
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+#include "SceneObject.h"
+#include "TemporalHistory.h"
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  SceneReprojection
+ *
+ *  This class draws the last frame's scene into this one,
+ *  each pixel taken from where its surface was a frame ago
+ *  and written with the depth the surface has now.  Pixels
+ *  whose surface was hidden or off screen are left out, as
+ *  is a rotating set of tiles so lighting that depends on
+ *  the view never goes stale for long.  Drawing the scene
+ *  over it with the depth test on then shades only those
+ *  pixels, and whatever has come in front of the reused
+ *  ones.  The reprojection follows the camera only, so
+ *  pixels the last frame had on a moving object are left
+ *  out too, as are those on a shiny one once the camera
+ *  moves more than a little.  The scene's alpha counts the
+ *  frames a pixel has been reused, and one reused too
+ *  often is shaded again.  A camera that jumps further
+ *  than a frame of a slow pan draws in full.
+ ***********************************************************/
+class SceneReprojection
+{
+public:
+	// constructor
+	SceneReprojection(RenderBackend* pBackend);
+	// destructor
+	~SceneReprojection();
+
+	// make the program and the full screen triangle
+	bool Create(const char* vertexFilename, const char* fragmentFilename);
+
+	// make the targets for a frame of the passed size -
+	// returns false when the backend cannot
+	bool BeginFrame(int width, int height);
+	// draw what can be reused of the last frame into the
+	// target bound, after it is cleared and before the scene
+	// - returns false when the frame must be drawn in full
+	bool Draw(const glm::mat4& view, const glm::mat4& projection);
+	// keep the frame drawn for the next one, with the boxes of
+	// the moving and the shiny objects drawn in it
+	void EndFrame(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		const std::vector<RESHADE_BOUNDS>& reshadeBounds);
+	// forget the last frame
+	void Invalidate();
+
+	// the last frame's scene, and the target of this one's
+	uint32_t GetHistoryTarget() const;
+	uint32_t GetCurrentTarget() const;
+	// estimated memory of the targets
+	size_t GetBytes() const;
+	// frames that reused the last, and those drawn in full
+	size_t GetReusedFrameCount() const;
+	size_t GetFullFrameCount() const;
+
+private:
+	RenderBackend* m_pBackend;
+	// the scene's color and depth, this frame's and the last
+	TemporalHistory m_history;
+	uint32_t m_program;
+	// one triangle covering the frame
+	uint32_t m_triangleBuffer;
+	uint32_t m_triangleIndexBuffer;
+	uint32_t m_triangleLayout;
+	// the camera the last frame was drawn with
+	glm::mat4 m_previousView;
+	glm::mat4 m_previousProjection;
+	// size of the frame being drawn
+	int m_width;
+	int m_height;
+	// pixel rectangles of the last frame's moving and shiny
+	// objects, as minimum x and y then maximum x and y
+	std::vector<glm::vec4> m_movingRects;
+	std::vector<glm::vec4> m_shinyRects;
+	// tiles left out this frame, stepping every frame
+	int m_tilePhase;
+	size_t m_reusedFrameCount;
+	size_t m_fullFrameCount;
+
+	// whether the camera moved too far to reuse the frame
+	bool IsCameraJump(const glm::mat4& view, const glm::mat4& projection) const;
+	// whether the camera moved or turned further than passed
+	bool HasCameraMoved(const glm::mat4& view, float maxMove, float maxTurnDegrees) const;
+	// the pixels a box covers in a frame - returns false when
+	// it is off screen
+	bool GetScreenRect(
+		const RESHADE_BOUNDS& bounds,
+		const glm::mat4& viewProjection,
+		glm::vec4& rect) const;
+};
@@ -0,0 +1,692 @@
+///////////////////////////////////////////////////////////////////////////////
+// selftests.cpp
+// ============
+// randomized checks of the allocators and scene queries against brute force
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SelfTests.h"
+#include "BuddyAllocator.h"
+#include "MeshHeap.h"
+#include "MeshImporter.h"
+#include "ProceduralMeshes.h"
+#include "SceneCollision.h"
+#include "ScenePicker.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <vector>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// allocations and frees of the allocator and heap runs
+	const int g_AllocatorSteps = 200000;
+	const int g_MeshHeapSteps = 20000;
+	// triangles of the OBJ file that shares no corners, and
+	// how far its loaded positions may be from those written
+	const int g_SoupTriangles = 1000;
+	const float g_PositionTolerance = 0.0001f;
+	// objects along each side of the picking and collision
+	// grids, and the rays, sweeps and moves tested in them
+	const int g_GridSide = 24;
+	const int g_RayCount = 2000;
+	const int g_SweepCount = 1000;
+	const int g_MoveCount = 5000;
+	// size of the sphere moved through the collision grid,
+	// and the steps a sweep is marched in to find its touch
+	const float g_SphereRadius = 0.2f;
+	const int g_SweepSteps = 2000;
+	// how far apart the picker's and the brute force hits
+	// may be, since a ray glancing off a face finds it less
+	// exactly
+	const float g_PickTolerance = 0.001f;
+	// how far the triangles are shrunk and grown, in their
+	// own proportions, for the brute force hits between which
+	// the picker's must be, since a ray through an edge or a
+	// corner may as rightly hit the faces there as miss them
+	const float g_EdgeTolerance = 0.0001f;
+	// how far a touching or pushed out sphere may be from
+	// resting on a box
+	const float g_ContactTolerance = 0.001f;
+
+	// a box of the collision grid in the form the checks test
+	// points against
+	struct TEST_BOX
+	{
+		glm::vec3 center;
+		glm::vec3 axes[3];
+		glm::vec3 halfExtents;
+	};
+
+	/***********************************************************
+	 *  MakeTestBox()
+	 *
+	 *  This function is used for getting the box a model
+	 *  places the unit cube around the origin at.
+	 ***********************************************************/
+	TEST_BOX MakeTestBox(const glm::mat4& model)
+	{
+		TEST_BOX box;
+		box.center = glm::vec3(model[3]);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			glm::vec3 column = glm::vec3(model[axis]);
+			float length = glm::length(column);
+			box.axes[axis] = column / length;
+			box.halfExtents[axis] = 0.5f * length;
+		}
+		return(box);
+	}
+
+	/***********************************************************
+	 *  GetBoxDistance()
+	 *
+	 *  This function is used for getting how far a point is
+	 *  from a box, zero inside it.
+	 ***********************************************************/
+	float GetBoxDistance(const TEST_BOX& box, const glm::vec3& point)
+	{
+		glm::vec3 offset = point - box.center;
+		float distanceSquared = 0.0f;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float outside = std::max(std::fabs(glm::dot(offset, box.axes[axis])) - box.halfExtents[axis], 0.0f);
+			distanceSquared += outside * outside;
+		}
+		return(std::sqrt(distanceSquared));
+	}
+
+	/***********************************************************
+	 *  IsNearGridObject()
+	 *
+	 *  This function is used for checking whether a point is
+	 *  close enough to a grid object's center for the object
+	 *  to be worth testing.  The objects are less than one
+	 *  grid step across with the sphere around them.
+	 ***********************************************************/
+	bool IsNearGridObject(const glm::vec3& center, const glm::vec3& point)
+	{
+		return((std::fabs(center.x - point.x) <= 1.0f) && (std::fabs(center.z - point.z) <= 1.0f));
+	}
+
+	/***********************************************************
+	 *  IntersectTriangle()
+	 *
+	 *  This function is used for finding where a ray crosses
+	 *  a triangle, from either side, in lengths of its
+	 *  direction.  The triangle is grown by the slack, or
+	 *  shrunk when it is negative.
+	 ***********************************************************/
+	bool IntersectTriangle(
+		const glm::vec3& origin,
+		const glm::vec3& direction,
+		const glm::vec3& a,
+		const glm::vec3& b,
+		const glm::vec3& c,
+		float slack,
+		float& t)
+	{
+		glm::vec3 edge1 = b - a;
+		glm::vec3 edge2 = c - a;
+		glm::vec3 p = glm::cross(direction, edge2);
+		float determinant = glm::dot(edge1, p);
+		if (std::fabs(determinant) < 1e-12f)
+		{
+			return(false);
+		}
+		float inverse = 1.0f / determinant;
+		glm::vec3 s = origin - a;
+		float u = glm::dot(s, p) * inverse;
+		if ((u < -slack) || (u > 1.0f + slack))
+		{
+			return(false);
+		}
+		glm::vec3 q = glm::cross(s, edge1);
+		float v = glm::dot(direction, q) * inverse;
+		if ((v < -slack) || (u + v > 1.0f + slack))
+		{
+			return(false);
+		}
+		t = glm::dot(edge2, q) * inverse;
+		return(t >= 0.0f);
+	}
+
+	/***********************************************************
+	 *  FindNearestHit()
+	 *
+	 *  This function is used for testing a ray against every
+	 *  triangle of every object, up to its full length, and
+	 *  returning the object hit first, or -1.
+	 ***********************************************************/
+	int FindNearestHit(
+		const std::vector<std::vector<glm::vec3>>& triangles,
+		const glm::vec3& origin,
+		const glm::vec3& direction,
+		float slack,
+		float& nearestT)
+	{
+		int nearestObject = -1;
+		nearestT = 1.0f;
+		for (size_t i = 0; i < triangles.size(); i++)
+		{
+			for (size_t corner = 0; corner < triangles[i].size(); corner += 3)
+			{
+				float t = 0.0f;
+				if (IntersectTriangle(origin, direction, triangles[i][corner], triangles[i][corner + 1], triangles[i][corner + 2], slack, t) &&
+					(t <= nearestT))
+				{
+					nearestT = t;
+					nearestObject = static_cast<int>(i);
+				}
+			}
+		}
+		return(nearestObject);
+	}
+}
+
+/***********************************************************
+ *  SelfTests()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SelfTests::SelfTests(unsigned int seed) :
+	m_random(seed)
+{
+}
+
+/***********************************************************
+ *  ~SelfTests()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SelfTests::~SelfTests()
+{
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for running every check and
+ *  printing how each went.
+ ***********************************************************/
+int SelfTests::Run()
+{
+	int failures = 0;
+	failures += CheckBuddyAllocator();
+	failures += CheckMeshHeap();
+	failures += CheckMeshImporter();
+	failures += CheckScenePicker();
+	failures += CheckSceneCollision();
+	std::cout << ((0 == failures) ? "All checks passed" : "Some checks failed") << std::endl;
+	return(failures);
+}
+
+/***********************************************************
+ *  CheckBuddyAllocator()
+ *
+ *  This method is used for allocating and freeing random
+ *  sizes, growing the range now and then when it is full,
+ *  and checking that every block given out is aligned to
+ *  its size, inside the range and clear of the others,
+ *  and that the used size adds up.  Once everything is
+ *  freed the whole range must be one block again.
+ ***********************************************************/
+int SelfTests::CheckBuddyAllocator()
+{
+	BuddyAllocator allocator;
+	allocator.Reset(1 << 16, 64);
+	// size of each block given out, by its offset
+	std::map<uint32_t, uint32_t> blocks;
+	int failures = 0;
+
+	for (int step = 0; step < g_AllocatorSteps; step++)
+	{
+		if (blocks.empty() || (m_random() % 2))
+		{
+			uint32_t size = 1 + m_random() % 3000;
+			uint32_t offset = 0;
+			if (!allocator.Allocate(size, offset))
+			{
+				if (0 == m_random() % 50)
+				{
+					allocator.Grow();
+				}
+				continue;
+			}
+
+			uint32_t blockSize = allocator.GetBlockSize(size);
+			bool bOverlaps = false;
+			std::map<uint32_t, uint32_t>::iterator next = blocks.lower_bound(offset);
+			if ((next != blocks.end()) && (next->first < offset + blockSize))
+			{
+				bOverlaps = true;
+			}
+			if ((next != blocks.begin()) && (std::prev(next)->first + std::prev(next)->second > offset))
+			{
+				bOverlaps = true;
+			}
+			if ((0 != offset % blockSize) || (offset + blockSize > allocator.GetCapacity()) || bOverlaps)
+			{
+				failures++;
+			}
+			blocks[offset] = blockSize;
+		}
+		else
+		{
+			std::map<uint32_t, uint32_t>::iterator block = blocks.begin();
+			std::advance(block, m_random() % blocks.size());
+			allocator.Free(block->first);
+			blocks.erase(block);
+		}
+
+		if (0 == step % 1000)
+		{
+			uint32_t used = 0;
+			for (std::map<uint32_t, uint32_t>::iterator block = blocks.begin(); block != blocks.end(); ++block)
+			{
+				used += block->second;
+			}
+			if (used != allocator.GetUsedSize())
+			{
+				failures++;
+			}
+		}
+	}
+
+	for (std::map<uint32_t, uint32_t>::iterator block = blocks.begin(); block != blocks.end(); ++block)
+	{
+		allocator.Free(block->first);
+	}
+	if ((0 != allocator.GetUsedSize()) || (allocator.GetLargestFreeBlock() != allocator.GetCapacity()))
+	{
+		failures++;
+	}
+
+	return(Report("Buddy allocator", g_AllocatorSteps, failures));
+}
+
+/***********************************************************
+ *  CheckMeshHeap()
+ *
+ *  This method is used for copying meshes of random sizes
+ *  into a small heap and freeing them, which makes it grow
+ *  and split up, and checking after each step and after
+ *  defragmenting now and then that every mesh keeps its
+ *  sizes and that no two share a vertex or an index.
+ ***********************************************************/
+int SelfTests::CheckMeshHeap()
+{
+	MeshHeap heap;
+	if (!heap.Create(&m_backend, 1024, 4096))
+	{
+		return(Report("Mesh heap", 1, 1));
+	}
+
+	// vertex and index counts of each handle in use
+	std::map<int, std::pair<uint32_t, uint32_t>> meshes;
+	int failures = 0;
+	for (int step = 0; step < g_MeshHeapSteps; step++)
+	{
+		if (meshes.empty() || (m_random() % 2))
+		{
+			MESH_DATA mesh;
+			mesh.vertices.resize(1 + m_random() % 600);
+			mesh.indices.resize(3 * (1 + m_random() % 600), 0);
+			int handle = heap.Allocate(mesh);
+			if ((handle < 0) || (meshes.count(handle) > 0))
+			{
+				failures++;
+				continue;
+			}
+			meshes[handle] = std::make_pair(
+				static_cast<uint32_t>(mesh.vertices.size()), static_cast<uint32_t>(mesh.indices.size()));
+		}
+		else
+		{
+			std::map<int, std::pair<uint32_t, uint32_t>>::iterator mesh = meshes.begin();
+			std::advance(mesh, m_random() % meshes.size());
+			heap.Free(mesh->first);
+			meshes.erase(mesh);
+		}
+		if (0 == step % 500)
+		{
+			heap.Defragment();
+		}
+
+		// the ranges of the meshes, by where they start
+		std::map<uint32_t, uint32_t> vertexRanges;
+		std::map<uint32_t, uint32_t> indexRanges;
+		bool bValid = true;
+		for (std::map<int, std::pair<uint32_t, uint32_t>>::iterator mesh = meshes.begin(); mesh != meshes.end(); ++mesh)
+		{
+			const MESH_ALLOCATION& allocation = heap.GetAllocation(mesh->first);
+			if (!allocation.bInUse || (allocation.vertexCount != mesh->second.first) ||
+				(allocation.indexCount != mesh->second.second) || (allocation.baseVertex < 0))
+			{
+				bValid = false;
+			}
+			vertexRanges[static_cast<uint32_t>(allocation.baseVertex)] = allocation.vertexCount;
+			indexRanges[allocation.firstIndex] = allocation.indexCount;
+		}
+		if ((vertexRanges.size() != meshes.size()) || (indexRanges.size() != meshes.size()))
+		{
+			bValid = false;
+		}
+		std::map<uint32_t, uint32_t>* pRanges[2] = { &vertexRanges, &indexRanges };
+		for (int kind = 0; kind < 2; kind++)
+		{
+			uint32_t end = 0;
+			for (std::map<uint32_t, uint32_t>::iterator range = pRanges[kind]->begin(); range != pRanges[kind]->end(); ++range)
+			{
+				if (range->first < end)
+				{
+					bValid = false;
+				}
+				end = range->first + range->second;
+			}
+		}
+		if (!bValid)
+		{
+			failures++;
+		}
+	}
+
+	heap.Destroy();
+	return(Report("Mesh heap", g_MeshHeapSteps, failures));
+}
+
+/***********************************************************
+ *  CheckMeshImporter()
+ *
+ *  This method is used for writing an OBJ file in which no
+ *  two triangles share a corner, each with positions,
+ *  texture coordinates and a normal of its own, as in a
+ *  triangle soup or a faceted export, and checking that
+ *  it loads with a vertex for every corner, in the order
+ *  they were written.
+ ***********************************************************/
+int SelfTests::CheckMeshImporter()
+{
+	const char* filename = "selftest_soup.obj";
+	std::vector<glm::vec3> positions(3 * g_SoupTriangles);
+	std::ofstream file(filename);
+	if (!file.is_open())
+	{
+		return(Report("Mesh importer", 1, 1));
+	}
+	file << std::setprecision(9);
+	for (size_t i = 0; i < positions.size(); i++)
+	{
+		positions[i] = glm::vec3(GetUnit(), GetUnit(), GetUnit()) * 10.0f;
+		file << "v " << positions[i].x << " " << positions[i].y << " " << positions[i].z << "\n";
+		file << "vt " << GetUnit() << " " << GetUnit() << "\n";
+	}
+	for (int i = 0; i < g_SoupTriangles; i++)
+	{
+		file << "vn 0 0 1\n";
+	}
+	for (int i = 0; i < g_SoupTriangles; i++)
+	{
+		file << "f";
+		for (int corner = 1; corner <= 3; corner++)
+		{
+			file << " " << (3 * i + corner) << "/" << (3 * i + corner) << "/" << (i + 1);
+		}
+		file << "\n";
+	}
+	file.close();
+
+	MeshImporter importer(&m_threadPool);
+	MESH_DATA mesh;
+	bool bLoaded = importer.LoadMesh(filename, mesh);
+	std::remove(filename);
+
+	int failures = 0;
+	if (!bLoaded || (mesh.vertices.size() != positions.size()) || (mesh.indices.size() != positions.size()))
+	{
+		return(Report("Mesh importer", static_cast<int>(positions.size()), static_cast<int>(positions.size())));
+	}
+	for (size_t i = 0; i < positions.size(); i++)
+	{
+		if (glm::length(mesh.vertices[mesh.indices[i]].position - positions[i]) > g_PositionTolerance)
+		{
+			failures++;
+		}
+	}
+	return(Report("Mesh importer", static_cast<int>(positions.size()), failures));
+}
+
+/***********************************************************
+ *  CheckScenePicker()
+ *
+ *  This method is used for placing turned and stretched
+ *  boxes and prisms over a grid, which the picker tests by
+ *  their triangles, and checking that the picker finds
+ *  the same first hit along random rays as testing every
+ *  triangle of every object, give or take rays through
+ *  an edge.
+ ***********************************************************/
+int SelfTests::CheckScenePicker()
+{
+	const SHAPE_TYPE shapes[2] = { SHAPE_BOX, SHAPE_PRISM };
+	MESH_DATA meshes[2];
+	for (int i = 0; i < 2; i++)
+	{
+		GenerateShapeMesh(shapes[i], 0, meshes[i], NULL);
+	}
+
+	std::vector<PICK_OBJECT> objects(g_GridSide * g_GridSide);
+	// the triangles of each object in world space, three
+	// corners each
+	std::vector<std::vector<glm::vec3>> triangles(objects.size());
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		glm::vec3 position(static_cast<float>(i % g_GridSide), 0.0f, static_cast<float>(i / g_GridSide));
+		glm::vec3 scale = glm::vec3(0.2f) + glm::vec3(GetUnit(), GetUnit(), GetUnit()) * 0.6f;
+		glm::vec3 axis = glm::normalize(glm::vec3(GetUnit(), 1.0f, GetUnit()));
+		PICK_OBJECT& object = objects[i];
+		const MESH_DATA& mesh = meshes[i % 2];
+		object.shape = shapes[i % 2];
+		object.pMesh = &mesh;
+		object.model = glm::translate(position) * glm::rotate(GetUnit() * 6.2831853f, axis) * glm::scale(scale);
+
+		for (size_t index = 0; index < mesh.indices.size(); index++)
+		{
+			glm::vec3 corner = mesh.vertices[mesh.indices[index]].position;
+			triangles[i].push_back(glm::vec3(object.model * glm::vec4(corner, 1.0f)));
+		}
+	}
+
+	ScenePicker picker(&m_threadPool);
+	picker.Build(objects);
+
+	float side = static_cast<float>(g_GridSide);
+	int failures = 0;
+	for (int ray = 0; ray < g_RayCount; ray++)
+	{
+		glm::vec3 origin(GetUnit() * side, 0.5f + GetUnit() * 3.0f, GetUnit() * side);
+		glm::vec3 target(GetUnit() * side, GetUnit() * 0.5f - 0.5f, GetUnit() * side);
+		glm::vec3 direction = (target - origin) * 1.2f;
+
+		// a hit on the shrunk triangles must be found, none
+		// past the grown ones may be, and one in between may be
+		// found or not
+		float shrunkT = 1.0f;
+		float grownT = 1.0f;
+		bool bMustHit = (FindNearestHit(triangles, origin, direction, -g_EdgeTolerance, shrunkT) >= 0);
+		bool bMayHit = (FindNearestHit(triangles, origin, direction, g_EdgeTolerance, grownT) >= 0);
+
+		PICK_RESULT result;
+		bool bPicked = picker.Pick(origin, direction, result);
+		float tolerance = g_PickTolerance / glm::length(direction);
+		if ((bMustHit && !bPicked) || (bPicked && !bMayHit))
+		{
+			failures++;
+		}
+		else if (bPicked && ((result.t < grownT - tolerance) || (result.t > shrunkT + tolerance)))
+		{
+			failures++;
+		}
+	}
+
+	return(Report("Scene picker", g_RayCount, failures));
+}
+
+/***********************************************************
+ *  CheckSceneCollision()
+ *
+ *  This method is used for placing turned and stretched
+ *  boxes over a grid and checking the collision grid
+ *  against testing every box: the boxes a sphere overlaps,
+ *  the first touch of a sphere moved from outside them,
+ *  found by marching along the move, with the sphere then
+ *  resting on the box it touched, and that a sphere moved
+ *  from anywhere, even inside a box, never ends up in one.
+ ***********************************************************/
+int SelfTests::CheckSceneCollision()
+{
+	std::vector<COLLISION_OBJECT> objects(g_GridSide * g_GridSide);
+	std::vector<TEST_BOX> boxes(objects.size());
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		glm::vec3 position(static_cast<float>(i % g_GridSide), 0.0f, static_cast<float>(i / g_GridSide));
+		glm::vec3 scale = glm::vec3(0.2f) + glm::vec3(GetUnit(), GetUnit(), GetUnit()) * 0.25f;
+		glm::vec3 axis = glm::normalize(glm::vec3(GetUnit(), 1.0f, GetUnit()));
+		COLLISION_OBJECT& object = objects[i];
+		object.boundsMin = glm::vec3(-0.5f);
+		object.boundsMax = glm::vec3(0.5f);
+		object.model = glm::translate(position) * glm::rotate(GetUnit() * 6.2831853f, axis) * glm::scale(scale);
+		boxes[i] = MakeTestBox(object.model);
+	}
+
+	SceneCollision collision;
+	collision.Build(objects);
+	float side = static_cast<float>(g_GridSide);
+
+	int queryFailures = 0;
+	for (int query = 0; query < g_SweepCount; query++)
+	{
+		glm::vec3 center(GetUnit() * side, GetUnit() * 0.8f - 0.4f, GetUnit() * side);
+		std::vector<int> found;
+		collision.QuerySphere(center, g_SphereRadius, found);
+		std::sort(found.begin(), found.end());
+		std::vector<int> expected;
+		for (size_t i = 0; i < boxes.size(); i++)
+		{
+			if (GetBoxDistance(boxes[i], center) <= g_SphereRadius)
+			{
+				expected.push_back(static_cast<int>(i));
+			}
+		}
+		if (found != expected)
+		{
+			queryFailures++;
+		}
+	}
+
+	int sweepFailures = 0;
+	int sweeps = 0;
+	float stepTolerance = 1.5f / static_cast<float>(g_SweepSteps) + 0.0001f;
+	while (sweeps < g_SweepCount)
+	{
+		glm::vec3 start(GetUnit() * side, GetUnit() * 0.8f - 0.2f, GetUnit() * side);
+		glm::vec3 direction = glm::vec3(GetUnit(), GetUnit(), GetUnit()) - glm::vec3(0.5f);
+		if (glm::length(direction) < 0.01f)
+		{
+			continue;
+		}
+		glm::vec3 end = start + glm::normalize(direction) * (GetUnit() * 2.0f);
+		bool bStartsInside = false;
+		for (size_t i = 0; i < boxes.size(); i++)
+		{
+			if (GetBoxDistance(boxes[i], start) < g_SphereRadius)
+			{
+				bStartsInside = true;
+			}
+		}
+		if (bStartsInside)
+		{
+			continue;
+		}
+		sweeps++;
+
+		float firstTouch = 1.0f;
+		for (int step = 1; (step <= g_SweepSteps) && (firstTouch >= 1.0f); step++)
+		{
+			float t = static_cast<float>(step) / static_cast<float>(g_SweepSteps);
+			glm::vec3 position = start + (end - start) * t;
+			for (size_t i = 0; i < boxes.size(); i++)
+			{
+				if (IsNearGridObject(boxes[i].center, position) && (GetBoxDistance(boxes[i], position) <= g_SphereRadius))
+				{
+					firstTouch = t;
+				}
+			}
+		}
+
+		SWEEP_HIT hit;
+		bool bHit = collision.SweepSphere(start, end, g_SphereRadius, hit);
+		float t = bHit ? hit.t : 1.0f;
+		if (std::fabs(t - firstTouch) > stepTolerance)
+		{
+			sweepFailures++;
+		}
+		else if (bHit && (std::fabs(GetBoxDistance(boxes[hit.object], hit.position) - g_SphereRadius) > g_ContactTolerance))
+		{
+			sweepFailures++;
+		}
+	}
+
+	int moveFailures = 0;
+	for (int move = 0; move < g_MoveCount; move++)
+	{
+		glm::vec3 start(GetUnit() * side, GetUnit() * 0.6f - 0.1f, GetUnit() * side);
+		glm::vec3 end = start + (glm::vec3(GetUnit(), GetUnit(), GetUnit()) - glm::vec3(0.5f)) * 0.6f;
+		glm::vec3 position = collision.MoveSphere(start, end, g_SphereRadius);
+		for (size_t i = 0; i < boxes.size(); i++)
+		{
+			if (IsNearGridObject(boxes[i].center, position) &&
+				(GetBoxDistance(boxes[i], position) < g_SphereRadius - g_ContactTolerance))
+			{
+				moveFailures++;
+				break;
+			}
+		}
+	}
+
+	return(Report("Collision queries", g_SweepCount, queryFailures) +
+		Report("Collision sweeps", g_SweepCount, sweepFailures) +
+		Report("Collision moves", g_MoveCount, moveFailures));
+}
+
+/***********************************************************
+ *  GetUnit()
+ *
+ *  This method is used for getting a random number from
+ *  zero to one.
+ ***********************************************************/
+float SelfTests::GetUnit()
+{
+	return(std::uniform_real_distribution<float>(0.0f, 1.0f)(m_random));
+}
+
+/***********************************************************
+ *  Report()
+ *
+ *  This method is used for printing how many of a check's
+ *  cases failed, and returning one when any did.
+ ***********************************************************/
+int SelfTests::Report(const std::string& name, int cases, int failures) const
+{
+	std::cout << name << ": " << failures << " of " << cases << " cases failed" << std::endl;
+	return((failures > 0) ? 1 : 0);
+}
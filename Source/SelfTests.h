@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////////////
+// selftests.h
+// ============
+// randomized checks of the allocators and scene queries against brute force
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "NullRenderBackend.h"
+#include "ThreadPool.h"
+
+#include <random>
+#include <string>
+
+/***********************************************************
+ *  SelfTests
+ *
+ *  This class runs randomized checks that need no display
+ *  or GPU: the buddy allocator and the mesh heap through
+ *  long runs of allocations and frees, the importer on an
+ *  OBJ file that shares no corners, the picker against
+ *  testing every triangle of every object, and the
+ *  collision grid's queries, sweeps and moves against
+ *  testing every box.  The same seed gives the same runs,
+ *  so a failure can be repeated.
+ ***********************************************************/
+class SelfTests
+{
+public:
+	// constructor
+	SelfTests(unsigned int seed);
+	// destructor
+	~SelfTests();
+
+	// run every check and print the results - returns the
+	// number of checks that failed
+	int Run();
+
+private:
+	std::mt19937 m_random;
+	// backend the mesh heap's buffers are made on
+	NullRenderBackend m_backend;
+	// workers the importer parses and the picker builds its
+	// hierarchies on
+	ThreadPool m_threadPool;
+
+	int CheckBuddyAllocator();
+	int CheckMeshHeap();
+	int CheckMeshImporter();
+	int CheckScenePicker();
+	int CheckSceneCollision();
+
+	// a random number from zero to one
+	float GetUnit();
+	// print how many of a check's cases failed
+	int Report(const std::string& name, int cases, int failures) const;
+};
@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadingmodel.h
+// ============
+// CPU copy of the lighting done by the scene's fragment shader
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SCENE_LIGHT
+ *
+ *  One entry of the shader's lightSources[] array.
+ ***********************************************************/
+struct SCENE_LIGHT
+{
+	glm::vec3 position;
+	glm::vec3 ambientColor;
+	glm::vec3 diffuseColor;
+	glm::vec3 specularColor;
+	float focalStrength;
+	float specularIntensity;
+};
+
+/***********************************************************
+ *  SHADING_MATERIAL
+ *
+ *  The values of the shader's material uniform.
+ ***********************************************************/
+struct SHADING_MATERIAL
+{
+	glm::vec3 ambientColor;
+	float ambientStrength;
+	glm::vec3 diffuseColor;
+	glm::vec3 specularColor;
+	float shininess;
+};
+
+/***********************************************************
+ *  SCENE_TEXTURE
+ *
+ *  CPU copy of a loaded texture image, stored bottom row
+ *  first like the OpenGL texture, as RGBA bytes.
+ ***********************************************************/
+struct SCENE_TEXTURE
+{
+	std::string tag;
+	int width;
+	int height;
+	std::vector<uint32_t> texels;
+};
+
+/***********************************************************
+ *  SURFACE_SHADING
+ *
+ *  The shader settings of one object, as seen by the CPU
+ *  renderers.
+ ***********************************************************/
+struct SURFACE_SHADING
+{
+	SHADING_MATERIAL material;
+	// texture to sample, or NULL to use the color
+	const SCENE_TEXTURE* pTexture;
+	glm::vec4 color;
+	glm::vec2 uvScale;
+};
+
+/***********************************************************
+ *  ComputeNormalMatrix()
+ *
+ *  Matrix for transforming normals by a model matrix.  It
+ *  points the same way as the inverse transpose but also
+ *  works for transformations that flatten an axis, like
+ *  the scene's screen planes scaled to zero height.
+ ***********************************************************/
+inline glm::mat3 ComputeNormalMatrix(const glm::mat4& model)
+{
+	glm::mat3 linear = glm::mat3(model);
+	glm::mat3 cofactor;
+	cofactor[0] = glm::cross(linear[1], linear[2]);
+	cofactor[1] = glm::cross(linear[2], linear[0]);
+	cofactor[2] = glm::cross(linear[0], linear[1]);
+
+	// mirroring transformations would turn the normals inside out
+	float determinant = glm::dot(linear[0], cofactor[0]);
+	if (determinant < 0.0f)
+	{
+		cofactor = cofactor * -1.0f;
+	}
+	return(cofactor);
+}
+
+/***********************************************************
+ *  SampleTexture()
+ *
+ *  Bilinear lookup with repeat wrapping, matching the
+ *  GL_LINEAR and GL_REPEAT settings of the scene textures.
+ ***********************************************************/
+inline glm::vec4 SampleTexture(const SCENE_TEXTURE& texture, const glm::vec2& texCoord)
+{
+	float x = texCoord.x * texture.width - 0.5f;
+	float y = texCoord.y * texture.height - 0.5f;
+	float xFloor = std::floor(x);
+	float yFloor = std::floor(y);
+	float fx = x - xFloor;
+	float fy = y - yFloor;
+
+	int x0 = static_cast<int>(xFloor) % texture.width;
+	int y0 = static_cast<int>(yFloor) % texture.height;
+	x0 = (x0 < 0) ? x0 + texture.width : x0;
+	y0 = (y0 < 0) ? y0 + texture.height : y0;
+	int x1 = (x0 + 1 == texture.width) ? 0 : x0 + 1;
+	int y1 = (y0 + 1 == texture.height) ? 0 : y0 + 1;
+
+	const uint32_t corners[4] = {
+		texture.texels[y0 * texture.width + x0],
+		texture.texels[y0 * texture.width + x1],
+		texture.texels[y1 * texture.width + x0],
+		texture.texels[y1 * texture.width + x1] };
+	const float weights[4] = {
+		(1.0f - fx) * (1.0f - fy),
+		fx * (1.0f - fy),
+		(1.0f - fx) * fy,
+		fx * fy };
+
+	glm::vec4 result(0.0f);
+	for (int i = 0; i < 4; i++)
+	{
+		result.r += weights[i] * static_cast<float>(corners[i] & 0xFF);
+		result.g += weights[i] * static_cast<float>((corners[i] >> 8) & 0xFF);
+		result.b += weights[i] * static_cast<float>((corners[i] >> 16) & 0xFF);
+		result.a += weights[i] * static_cast<float>(corners[i] >> 24);
+	}
+	return(result * (1.0f / 255.0f));
+}
+
+/***********************************************************
+ *  ShadeSurface()
+ *
+ *  Color of one surface point, following the fragment
+ *  shader: the ambient, diffuse and specular terms of every
+ *  light are added up and multiplied by the texture or the
+ *  object color.  Renderers that trace shadows can pass
+ *  how much of each light reaches the point, which scales
+ *  its diffuse and specular terms.
+ ***********************************************************/
+inline glm::vec4 ShadeSurface(
+	const SURFACE_SHADING& surface,
+	const SCENE_LIGHT* pLights,
+	int lightCount,
+	const glm::vec3& viewPosition,
+	const glm::vec3& position,
+	const glm::vec3& vertexNormal,
+	const glm::vec2& texCoord,
+	const float* pLightVisibility = NULL)
+{
+	glm::vec3 normal = glm::normalize(vertexNormal);
+	glm::vec3 viewDirection = glm::normalize(viewPosition - position);
+	glm::vec3 phongResult(0.0f);
+
+	for (int i = 0; i < lightCount; i++)
+	{
+		const SCENE_LIGHT& light = pLights[i];
+		glm::vec3 ambient = light.ambientColor * surface.material.ambientColor;
+
+		glm::vec3 lightDirection = glm::normalize(light.position - position);
+		float impact = std::max(glm::dot(normal, lightDirection), 0.0f);
+		glm::vec3 diffuse = impact * light.diffuseColor * surface.material.diffuseColor;
+
+		glm::vec3 reflectDirection = glm::reflect(-lightDirection, normal);
+		float specularComponent = std::pow(std::max(glm::dot(viewDirection, reflectDirection), 0.0f), light.focalStrength);
+		glm::vec3 specular = light.specularIntensity * specularComponent * surface.material.specularColor;
+
+		float visibility = (NULL != pLightVisibility) ? pLightVisibility[i] : 1.0f;
+		phongResult += ambient + visibility * (diffuse + specular);
+	}
+
+	if (NULL != surface.pTexture)
+	{
+		glm::vec4 textureColor = SampleTexture(*surface.pTexture, texCoord * surface.uvScale);
+		return(glm::vec4(phongResult * glm::vec3(textureColor), 1.0f));
+	}
+	return(glm::vec4(phongResult * glm::vec3(surface.color), surface.color.a));
+}
+
+/***********************************************************
+ *  PackColor()
+ *
+ *  Convert a shaded color into RGBA bytes, clamped like
+ *  the output of the fragment shader.
+ ***********************************************************/
+inline uint32_t PackColor(const glm::vec4& color)
+{
+	uint32_t packed = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		float channel = std::min(std::max(color[i], 0.0f), 1.0f);
+		packed |= static_cast<uint32_t>(channel * 255.0f + 0.5f) << (8 * i);
+	}
+	return(packed);
+}
@@ -0,0 +1,817 @@
+///////////////////////////////////////////////////////////////////////////////
+// softwarerasterizer.cpp
+// ============
+// draw the scene on the CPU in screen tiles, for machines without a GPU
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SoftwareRasterizer.h"
+#include "ImageFile.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cmath>
+
+// functions using AVX2 are compiled for it on their own, and
+// only called after checking that the processor supports it
+#if defined(_MSC_VER)
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+// declaration of the global variables and helpers
+namespace
+{
+	// width and height of a screen tile in pixels - a
+	// multiple of 8 so the SIMD spans never leave a tile
+	const int g_TileSize = 64;
+	// screen positions are snapped to 1/16 of a pixel
+	const float g_SubPixelSteps = 16.0f;
+	// triangles in the clip space guard band are rasterized
+	// without clipping against the sides of the screen
+	const float g_GuardBand = 4.0f;
+	// triangles and vertices handled by one parallel batch
+	const size_t g_TriangleBatchSize = 2048;
+	const size_t g_VertexBatchSize = 8192;
+	// marks a pixel that no triangle covers
+	const uint32_t g_NoTriangle = 0xFFFFFFFF;
+
+	/***********************************************************
+	 *  TILE_BUFFERS
+	 *
+	 *  Visibility buffer of one tile: the depth, triangle and
+	 *  screen space barycentric weights of corners 1 and 2 of
+	 *  the nearest triangle at each pixel.
+	 ***********************************************************/
+	struct TILE_BUFFERS
+	{
+		std::vector<float> depth;
+		std::vector<uint32_t> triangle;
+		std::vector<float> weight1;
+		std::vector<float> weight2;
+	};
+
+	/***********************************************************
+	 *  TILE_TRIANGLE
+	 *
+	 *  Edge functions and depth plane of a triangle, relative
+	 *  to the center of the first pixel of a tile, so they can
+	 *  be stepped across the tile without large values.
+	 ***********************************************************/
+	struct TILE_TRIANGLE
+	{
+		float edgeA[3];
+		float edgeB[3];
+		float edgeC[3];
+		float depthA;
+		float depthB;
+		float depthC;
+		float invArea;
+		// tile relative pixel bounds
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+		uint32_t id;
+	};
+
+	/***********************************************************
+	 *  HasAVX2()
+	 *
+	 *  Check if the processor and operating system support
+	 *  the 256 bit AVX2 instructions.
+	 ***********************************************************/
+	bool HasAVX2()
+	{
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return(false);
+		}
+		__cpuid(info, 1);
+		bool bOSXSave = (info[2] & (1 << 27)) != 0;
+		bool bAVX = (info[2] & (1 << 28)) != 0;
+		if (!bOSXSave || !bAVX || ((_xgetbv(0) & 6) != 6))
+		{
+			return(false);
+		}
+		__cpuidex(info, 7, 0);
+		return((info[1] & (1 << 5)) != 0);
+#else
+		return(__builtin_cpu_supports("avx2") != 0);
+#endif
+	}
+
+	/***********************************************************
+	 *  LerpVertex()
+	 *
+	 *  Blend all the attributes of two vertices, for the new
+	 *  corners made by clipping.
+	 ***********************************************************/
+	template<class VERTEX>
+	VERTEX LerpVertex(const VERTEX& a, const VERTEX& b, float t)
+	{
+		VERTEX result;
+		result.clip = a.clip + (b.clip - a.clip) * t;
+		result.world = a.world + (b.world - a.world) * t;
+		result.normal = a.normal + (b.normal - a.normal) * t;
+		result.texCoord = a.texCoord + (b.texCoord - a.texCoord) * t;
+		return(result);
+	}
+
+	/***********************************************************
+	 *  RasterizeSSE()
+	 *
+	 *  Find the pixels of a tile covered by a triangle, four
+	 *  at a time, and keep the ones nearer than what the tile
+	 *  already holds.
+	 ***********************************************************/
+	void RasterizeSSE(const TILE_TRIANGLE& triangle, TILE_BUFFERS& tile)
+	{
+		const __m128 laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128i id = _mm_set1_epi32(static_cast<int>(triangle.id));
+		const __m128 invArea = _mm_set1_ps(triangle.invArea);
+
+		__m128 step[3];
+		for (int e = 0; e < 3; e++)
+		{
+			step[e] = _mm_set1_ps(triangle.edgeA[e] * 4.0f);
+		}
+		__m128 depthStep = _mm_set1_ps(triangle.depthA * 4.0f);
+
+		int startX = triangle.minX & ~3;
+		for (int y = triangle.minY; y <= triangle.maxY; y++)
+		{
+			float rowX = static_cast<float>(startX);
+			float rowY = static_cast<float>(y);
+			__m128 edge[3];
+			for (int e = 0; e < 3; e++)
+			{
+				edge[e] = _mm_add_ps(
+					_mm_set1_ps(triangle.edgeA[e] * rowX + triangle.edgeB[e] * rowY + triangle.edgeC[e]),
+					_mm_mul_ps(_mm_set1_ps(triangle.edgeA[e]), laneOffsets));
+			}
+			__m128 depth = _mm_add_ps(
+				_mm_set1_ps(triangle.depthA * rowX + triangle.depthB * rowY + triangle.depthC),
+				_mm_mul_ps(_mm_set1_ps(triangle.depthA), laneOffsets));
+
+			for (int x = startX; x <= triangle.maxX; x += 4)
+			{
+				__m128 inside = _mm_cmpge_ps(_mm_min_ps(edge[0], _mm_min_ps(edge[1], edge[2])), zero);
+				if (_mm_movemask_ps(inside) != 0)
+				{
+					int pixel = y * g_TileSize + x;
+					__m128 storedDepth = _mm_loadu_ps(&tile.depth[pixel]);
+					__m128 visible = _mm_and_ps(inside, _mm_cmplt_ps(depth, storedDepth));
+					if (_mm_movemask_ps(visible) != 0)
+					{
+						__m128i visibleInt = _mm_castps_si128(visible);
+						__m128i storedId = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&tile.triangle[pixel]));
+						__m128 weight1 = _mm_mul_ps(edge[1], invArea);
+						__m128 weight2 = _mm_mul_ps(edge[2], invArea);
+
+						_mm_storeu_ps(&tile.depth[pixel],
+							_mm_or_ps(_mm_and_ps(visible, depth), _mm_andnot_ps(visible, storedDepth)));
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(&tile.triangle[pixel]),
+							_mm_or_si128(_mm_and_si128(visibleInt, id), _mm_andnot_si128(visibleInt, storedId)));
+						_mm_storeu_ps(&tile.weight1[pixel],
+							_mm_or_ps(_mm_and_ps(visible, weight1), _mm_andnot_ps(visible, _mm_loadu_ps(&tile.weight1[pixel]))));
+						_mm_storeu_ps(&tile.weight2[pixel],
+							_mm_or_ps(_mm_and_ps(visible, weight2), _mm_andnot_ps(visible, _mm_loadu_ps(&tile.weight2[pixel]))));
+					}
+				}
+
+				for (int e = 0; e < 3; e++)
+				{
+					edge[e] = _mm_add_ps(edge[e], step[e]);
+				}
+				depth = _mm_add_ps(depth, depthStep);
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  RasterizeAVX2()
+	 *
+	 *  The same as RasterizeSSE(), eight pixels at a time.
+	 ***********************************************************/
+	TARGET_AVX2 void RasterizeAVX2(const TILE_TRIANGLE& triangle, TILE_BUFFERS& tile)
+	{
+		const __m256 laneOffsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 id = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(triangle.id)));
+		const __m256 invArea = _mm256_set1_ps(triangle.invArea);
+
+		__m256 step[3];
+		for (int e = 0; e < 3; e++)
+		{
+			step[e] = _mm256_set1_ps(triangle.edgeA[e] * 8.0f);
+		}
+		__m256 depthStep = _mm256_set1_ps(triangle.depthA * 8.0f);
+
+		int startX = triangle.minX & ~7;
+		for (int y = triangle.minY; y <= triangle.maxY; y++)
+		{
+			float rowX = static_cast<float>(startX);
+			float rowY = static_cast<float>(y);
+			__m256 edge[3];
+			for (int e = 0; e < 3; e++)
+			{
+				edge[e] = _mm256_add_ps(
+					_mm256_set1_ps(triangle.edgeA[e] * rowX + triangle.edgeB[e] * rowY + triangle.edgeC[e]),
+					_mm256_mul_ps(_mm256_set1_ps(triangle.edgeA[e]), laneOffsets));
+			}
+			__m256 depth = _mm256_add_ps(
+				_mm256_set1_ps(triangle.depthA * rowX + triangle.depthB * rowY + triangle.depthC),
+				_mm256_mul_ps(_mm256_set1_ps(triangle.depthA), laneOffsets));
+
+			for (int x = startX; x <= triangle.maxX; x += 8)
+			{
+				__m256 inside = _mm256_cmp_ps(_mm256_min_ps(edge[0], _mm256_min_ps(edge[1], edge[2])), zero, _CMP_GE_OQ);
+				if (_mm256_movemask_ps(inside) != 0)
+				{
+					int pixel = y * g_TileSize + x;
+					__m256 storedDepth = _mm256_loadu_ps(&tile.depth[pixel]);
+					__m256 visible = _mm256_and_ps(inside, _mm256_cmp_ps(depth, storedDepth, _CMP_LT_OQ));
+					if (_mm256_movemask_ps(visible) != 0)
+					{
+						float* pTriangle = reinterpret_cast<float*>(&tile.triangle[pixel]);
+						_mm256_storeu_ps(&tile.depth[pixel], _mm256_blendv_ps(storedDepth, depth, visible));
+						_mm256_storeu_ps(pTriangle, _mm256_blendv_ps(_mm256_loadu_ps(pTriangle), id, visible));
+						_mm256_storeu_ps(&tile.weight1[pixel],
+							_mm256_blendv_ps(_mm256_loadu_ps(&tile.weight1[pixel]), _mm256_mul_ps(edge[1], invArea), visible));
+						_mm256_storeu_ps(&tile.weight2[pixel],
+							_mm256_blendv_ps(_mm256_loadu_ps(&tile.weight2[pixel]), _mm256_mul_ps(edge[2], invArea), visible));
+					}
+				}
+
+				for (int e = 0; e < 3; e++)
+				{
+					edge[e] = _mm256_add_ps(edge[e], step[e]);
+				}
+				depth = _mm256_add_ps(depth, depthStep);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  SoftwareRasterizer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SoftwareRasterizer::SoftwareRasterizer(ThreadPool* pThreadPool)
+{
+	m_pThreadPool = pThreadPool;
+	m_bUseAVX2 = HasAVX2();
+	m_width = 0;
+	m_height = 0;
+	m_tilesX = 0;
+	m_tilesY = 0;
+	m_clearColor = PackColor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	m_viewProjection = glm::mat4(1.0f);
+	m_viewPosition = glm::vec3(0.0f);
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the size of the color
+ *  buffer that the next frames are drawn into.
+ ***********************************************************/
+void SoftwareRasterizer::Resize(int width, int height)
+{
+	m_width = std::max(width, 0);
+	m_height = std::max(height, 0);
+	m_tilesX = (m_width + g_TileSize - 1) / g_TileSize;
+	m_tilesY = (m_height + g_TileSize - 1) / g_TileSize;
+	m_colorBuffer.assign(static_cast<size_t>(m_width) * m_height, m_clearColor);
+}
+
+/***********************************************************
+ *  SetCamera()
+ *
+ *  This method is used for setting the view and projection
+ *  matrices and the camera position, as they are passed to
+ *  the shaders.
+ ***********************************************************/
+void SoftwareRasterizer::SetCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition)
+{
+	m_viewProjection = projection * view;
+	m_viewPosition = viewPosition;
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for setting the light sources.
+ ***********************************************************/
+void SoftwareRasterizer::SetLights(const std::vector<SCENE_LIGHT>& lights)
+{
+	m_lights = lights;
+}
+
+/***********************************************************
+ *  SetClearColor()
+ *
+ *  This method is used for setting the background color.
+ ***********************************************************/
+void SoftwareRasterizer::SetClearColor(const glm::vec4& color)
+{
+	m_clearColor = PackColor(color);
+}
+
+/***********************************************************
+ *  Render()
+ *
+ *  This method is used for drawing a frame.  The vertices
+ *  are transformed and the triangles binned in parallel
+ *  batches, then the tiles are rasterized and shaded in
+ *  parallel.
+ ***********************************************************/
+void SoftwareRasterizer::Render(const std::vector<SOFTWARE_DRAW>& draws)
+{
+	if ((m_width == 0) || (m_height == 0))
+	{
+		return;
+	}
+
+	TransformVertices(draws);
+	SetupTriangles(draws);
+
+	m_pThreadPool->ParallelFor(
+		static_cast<size_t>(m_tilesX) * m_tilesY,
+		1,
+		[this, &draws](size_t begin, size_t end)
+	{
+		for (size_t tile = begin; tile < end; tile++)
+		{
+			RenderTile(static_cast<int>(tile), draws);
+		}
+	});
+}
+
+/***********************************************************
+ *  TransformVertices()
+ *
+ *  This method is used for running the vertex stage: every
+ *  vertex is moved into clip space and world space, with
+ *  its normal, like the vertex shader does.
+ ***********************************************************/
+void SoftwareRasterizer::TransformVertices(const std::vector<SOFTWARE_DRAW>& draws)
+{
+	std::vector<glm::mat4> clipMatrices(draws.size());
+	std::vector<glm::mat3> normalMatrices(draws.size());
+
+	m_vertexOffsets.resize(draws.size() + 1);
+	m_vertexOffsets[0] = 0;
+	for (size_t d = 0; d < draws.size(); d++)
+	{
+		clipMatrices[d] = m_viewProjection * draws[d].model;
+		normalMatrices[d] = ComputeNormalMatrix(draws[d].model);
+		m_vertexOffsets[d + 1] = m_vertexOffsets[d] + draws[d].pMesh->vertices.size();
+	}
+	m_vertices.resize(m_vertexOffsets.back());
+
+	m_pThreadPool->ParallelFor(
+		m_vertices.size(),
+		g_VertexBatchSize,
+		[this, &draws, &clipMatrices, &normalMatrices](size_t begin, size_t end)
+	{
+		size_t d = std::upper_bound(m_vertexOffsets.begin(), m_vertexOffsets.end(), begin) - m_vertexOffsets.begin() - 1;
+		for (size_t i = begin; i < end; i++)
+		{
+			while (i >= m_vertexOffsets[d + 1])
+			{
+				d++;
+			}
+			const MESH_VERTEX& source = draws[d].pMesh->vertices[i - m_vertexOffsets[d]];
+			glm::vec4 position(source.position, 1.0f);
+			RASTER_VERTEX& vertex = m_vertices[i];
+			vertex.clip = clipMatrices[d] * position;
+			vertex.world = glm::vec3(draws[d].model * position);
+			vertex.normal = normalMatrices[d] * source.normal;
+			vertex.texCoord = source.texCoord;
+		}
+	});
+}
+
+/***********************************************************
+ *  SetupTriangles()
+ *
+ *  This method is used for running the triangle setup in
+ *  parallel batches.  Each batch keeps its own list of
+ *  triangles per tile, and the tiles later walk the batches
+ *  in order, so the triangles are still drawn in the order
+ *  they were submitted.
+ ***********************************************************/
+void SoftwareRasterizer::SetupTriangles(const std::vector<SOFTWARE_DRAW>& draws)
+{
+	m_triangleOffsets.resize(draws.size() + 1);
+	m_triangleOffsets[0] = 0;
+	for (size_t d = 0; d < draws.size(); d++)
+	{
+		m_triangleOffsets[d + 1] = m_triangleOffsets[d] + draws[d].pMesh->indices.size() / 3;
+	}
+
+	size_t batchCount = (m_triangleOffsets.back() + g_TriangleBatchSize - 1) / g_TriangleBatchSize;
+	size_t tileCount = static_cast<size_t>(m_tilesX) * m_tilesY;
+	m_batches.resize(batchCount);
+
+	m_pThreadPool->ParallelFor(
+		batchCount,
+		1,
+		[this, &draws, tileCount](size_t begin, size_t end)
+	{
+		for (size_t b = begin; b < end; b++)
+		{
+			TRIANGLE_BATCH& batch = m_batches[b];
+			batch.triangles.clear();
+			batch.bins.resize(tileCount);
+			for (size_t tile = 0; tile < tileCount; tile++)
+			{
+				batch.bins[tile].clear();
+			}
+
+			size_t first = b * g_TriangleBatchSize;
+			size_t last = std::min(first + g_TriangleBatchSize, m_triangleOffsets.back());
+			size_t d = std::upper_bound(m_triangleOffsets.begin(), m_triangleOffsets.end(), first) - m_triangleOffsets.begin() - 1;
+			for (size_t t = first; t < last; t++)
+			{
+				while (t >= m_triangleOffsets[d + 1])
+				{
+					d++;
+				}
+				const std::vector<uint32_t>& indices = draws[d].pMesh->indices;
+				size_t index = (t - m_triangleOffsets[d]) * 3;
+				const RASTER_VERTEX* corners[3] = {
+					&m_vertices[m_vertexOffsets[d] + indices[index]],
+					&m_vertices[m_vertexOffsets[d] + indices[index + 1]],
+					&m_vertices[m_vertexOffsets[d] + indices[index + 2]] };
+				SetupTriangle(corners, draws[d], static_cast<uint32_t>(d), batch);
+			}
+		}
+	});
+}
+
+/***********************************************************
+ *  SetupTriangle()
+ *
+ *  This method is used for clipping a triangle against the
+ *  near and far planes and the guard band.  Most triangles
+ *  are entirely inside and go straight to binning.
+ ***********************************************************/
+void SoftwareRasterizer::SetupTriangle(const RASTER_VERTEX* corners[3], const SOFTWARE_DRAW& draw, uint32_t drawIndex, TRIANGLE_BATCH& batch)
+{
+	// distance of a clip space point inside each plane
+	const glm::vec4 planes[6] = {
+		glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+		glm::vec4(0.0f, 0.0f, -1.0f, 1.0f),
+		glm::vec4(1.0f, 0.0f, 0.0f, g_GuardBand),
+		glm::vec4(-1.0f, 0.0f, 0.0f, g_GuardBand),
+		glm::vec4(0.0f, 1.0f, 0.0f, g_GuardBand),
+		glm::vec4(0.0f, -1.0f, 0.0f, g_GuardBand) };
+
+	int outsideAny = 0;
+	for (int p = 0; p < 6; p++)
+	{
+		int outside = 0;
+		for (int c = 0; c < 3; c++)
+		{
+			if (glm::dot(planes[p], corners[c]->clip) < 0.0f)
+			{
+				outside |= (1 << c);
+			}
+		}
+		if (outside == 7)
+		{
+			return;
+		}
+		outsideAny |= outside;
+	}
+	if (outsideAny == 0)
+	{
+		BinTriangle(corners, draw, drawIndex, batch);
+		return;
+	}
+
+	// clip the polygon against one plane after another
+	RASTER_VERTEX polygon[2][9];
+	int count = 3;
+	for (int c = 0; c < 3; c++)
+	{
+		polygon[0][c] = *corners[c];
+	}
+	int current = 0;
+	for (int p = 0; (p < 6) && (count >= 3); p++)
+	{
+		const RASTER_VERTEX* input = polygon[current];
+		RASTER_VERTEX* output = polygon[1 - current];
+		int outputCount = 0;
+		for (int i = 0; i < count; i++)
+		{
+			const RASTER_VERTEX& a = input[i];
+			const RASTER_VERTEX& b = input[(i + 1) % count];
+			float distanceA = glm::dot(planes[p], a.clip);
+			float distanceB = glm::dot(planes[p], b.clip);
+			if (distanceA >= 0.0f)
+			{
+				output[outputCount++] = a;
+			}
+			if ((distanceA >= 0.0f) != (distanceB >= 0.0f))
+			{
+				output[outputCount++] = LerpVertex(a, b, distanceA / (distanceA - distanceB));
+			}
+		}
+		count = outputCount;
+		current = 1 - current;
+	}
+
+	for (int i = 1; i + 1 < count; i++)
+	{
+		const RASTER_VERTEX* fan[3] = { &polygon[current][0], &polygon[current][i], &polygon[current][i + 1] };
+		BinTriangle(fan, draw, drawIndex, batch);
+	}
+}
+
+/***********************************************************
+ *  BinTriangle()
+ *
+ *  This method is used for projecting a clipped triangle
+ *  onto the screen and adding it to the tiles it touches.
+ *  Both windings are kept, as OpenGL face culling is off,
+ *  with the corners reordered so the area is positive -
+ *  only closed meshes drop the faces turned away.
+ ***********************************************************/
+void SoftwareRasterizer::BinTriangle(const RASTER_VERTEX* corners[3], const SOFTWARE_DRAW& draw, uint32_t drawIndex, TRIANGLE_BATCH& batch)
+{
+	RASTER_TRIANGLE triangle;
+	for (int c = 0; c < 3; c++)
+	{
+		const RASTER_VERTEX& vertex = *corners[c];
+		float invW = 1.0f / vertex.clip.w;
+		float screenX = (vertex.clip.x * invW * 0.5f + 0.5f) * m_width;
+		float screenY = (0.5f - vertex.clip.y * invW * 0.5f) * m_height;
+		triangle.x[c] = std::floor(screenX * g_SubPixelSteps + 0.5f) / g_SubPixelSteps;
+		triangle.y[c] = std::floor(screenY * g_SubPixelSteps + 0.5f) / g_SubPixelSteps;
+		triangle.invW[c] = invW;
+	}
+
+	// the screen rows run downwards, so triangles facing the
+	// camera have a negative area
+	float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) -
+		(triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+	if ((area == 0.0f) || (draw.bCullBackFaces && (area > 0.0f)))
+	{
+		return;
+	}
+
+	// pixels whose centers fall inside the bounding box
+	float minX = std::min(triangle.x[0], std::min(triangle.x[1], triangle.x[2]));
+	float minY = std::min(triangle.y[0], std::min(triangle.y[1], triangle.y[2]));
+	float maxX = std::max(triangle.x[0], std::max(triangle.x[1], triangle.x[2]));
+	float maxY = std::max(triangle.y[0], std::max(triangle.y[1], triangle.y[2]));
+	triangle.minX = std::max(static_cast<int>(std::ceil(minX - 0.5f)), 0);
+	triangle.minY = std::max(static_cast<int>(std::ceil(minY - 0.5f)), 0);
+	triangle.maxX = std::min(static_cast<int>(std::floor(maxX - 0.5f)), m_width - 1);
+	triangle.maxY = std::min(static_cast<int>(std::floor(maxY - 0.5f)), m_height - 1);
+	if ((triangle.minX > triangle.maxX) || (triangle.minY > triangle.maxY))
+	{
+		return;
+	}
+
+	for (int c = 0; c < 3; c++)
+	{
+		const RASTER_VERTEX& vertex = *corners[c];
+		triangle.z[c] = vertex.clip.z * triangle.invW[c] * 0.5f + 0.5f;
+		triangle.world[c] = vertex.world;
+		triangle.normal[c] = vertex.normal;
+		triangle.texCoord[c] = vertex.texCoord;
+	}
+	if (area < 0.0f)
+	{
+		std::swap(triangle.x[1], triangle.x[2]);
+		std::swap(triangle.y[1], triangle.y[2]);
+		std::swap(triangle.z[1], triangle.z[2]);
+		std::swap(triangle.invW[1], triangle.invW[2]);
+		std::swap(triangle.world[1], triangle.world[2]);
+		std::swap(triangle.normal[1], triangle.normal[2]);
+		std::swap(triangle.texCoord[1], triangle.texCoord[2]);
+	}
+	triangle.drawIndex = drawIndex;
+
+	uint32_t index = static_cast<uint32_t>(batch.triangles.size());
+	batch.triangles.push_back(triangle);
+
+	int tileMinX = triangle.minX / g_TileSize;
+	int tileMinY = triangle.minY / g_TileSize;
+	int tileMaxX = triangle.maxX / g_TileSize;
+	int tileMaxY = triangle.maxY / g_TileSize;
+	bool bSingleTile = (tileMinX == tileMaxX) && (tileMinY == tileMaxY);
+
+	for (int tileY = tileMinY; tileY <= tileMaxY; tileY++)
+	{
+		for (int tileX = tileMinX; tileX <= tileMaxX; tileX++)
+		{
+			// skip the tiles of the bounding box that are
+			// entirely outside one of the edges
+			bool bOutside = false;
+			for (int e = 0; (e < 3) && !bSingleTile && !bOutside; e++)
+			{
+				int a = (e + 1) % 3;
+				int b = (e + 2) % 3;
+				float edgeA = triangle.y[a] - triangle.y[b];
+				float edgeB = triangle.x[b] - triangle.x[a];
+				float cornerX = (edgeA > 0.0f) ? (tileX + 1) * g_TileSize - 0.5f : tileX * g_TileSize + 0.5f;
+				float cornerY = (edgeB > 0.0f) ? (tileY + 1) * g_TileSize - 0.5f : tileY * g_TileSize + 0.5f;
+				bOutside = (edgeA * (cornerX - triangle.x[a]) + edgeB * (cornerY - triangle.y[a])) < 0.0f;
+			}
+			if (!bOutside)
+			{
+				batch.bins[tileY * m_tilesX + tileX].push_back(index);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  RenderTile()
+ *
+ *  This method is used for rasterizing every triangle
+ *  binned into a tile into its visibility buffer, then
+ *  shading each covered pixel once with the attributes of
+ *  its nearest triangle.
+ ***********************************************************/
+void SoftwareRasterizer::RenderTile(int tileIndex, const std::vector<SOFTWARE_DRAW>& draws)
+{
+	int tileX = (tileIndex % m_tilesX) * g_TileSize;
+	int tileY = (tileIndex / m_tilesX) * g_TileSize;
+	const size_t tilePixels = static_cast<size_t>(g_TileSize) * g_TileSize;
+
+	TILE_BUFFERS tile;
+	tile.depth.assign(tilePixels, 1.0f);
+	tile.triangle.assign(tilePixels, g_NoTriangle);
+	tile.weight1.resize(tilePixels);
+	tile.weight2.resize(tilePixels);
+
+	for (size_t b = 0; b < m_batches.size(); b++)
+	{
+		const TRIANGLE_BATCH& batch = m_batches[b];
+		const std::vector<uint32_t>& bin = batch.bins[tileIndex];
+		for (size_t i = 0; i < bin.size(); i++)
+		{
+			const RASTER_TRIANGLE& source = batch.triangles[bin[i]];
+			TILE_TRIANGLE triangle;
+			triangle.id = static_cast<uint32_t>((b << 16) | bin[i]);
+			triangle.minX = std::max(source.minX - tileX, 0);
+			triangle.minY = std::max(source.minY - tileY, 0);
+			triangle.maxX = std::min(source.maxX - tileX, g_TileSize - 1);
+			triangle.maxY = std::min(source.maxY - tileY, g_TileSize - 1);
+
+			// edge e gives the weight of corner e, and is zero
+			// along the side facing it - pixels exactly on a
+			// side are only drawn for top and left sides, so
+			// shared sides are drawn once
+			double originX = tileX + 0.5;
+			double originY = tileY + 0.5;
+			float originEdges[3];
+			for (int e = 0; e < 3; e++)
+			{
+				int a = (e + 1) % 3;
+				int c = (e + 2) % 3;
+				float edgeA = source.y[a] - source.y[c];
+				float edgeB = source.x[c] - source.x[a];
+				bool bTopLeft = (edgeA > 0.0f) || ((edgeA == 0.0f) && (edgeB > 0.0f));
+				double edgeC = edgeA * (originX - source.x[a]) + edgeB * (originY - source.y[a]);
+				triangle.edgeA[e] = edgeA;
+				triangle.edgeB[e] = edgeB;
+				triangle.edgeC[e] = static_cast<float>(bTopLeft ? edgeC : edgeC - 1.0 / (g_SubPixelSteps * g_SubPixelSteps));
+				originEdges[e] = static_cast<float>(edgeC);
+			}
+			float area = triangle.edgeA[0] * (source.x[0] - source.x[1]) + triangle.edgeB[0] * (source.y[0] - source.y[1]);
+			triangle.invArea = 1.0f / area;
+
+			// depth is a plane in screen space
+			float depth1 = (source.z[1] - source.z[0]) * triangle.invArea;
+			float depth2 = (source.z[2] - source.z[0]) * triangle.invArea;
+			triangle.depthA = triangle.edgeA[1] * depth1 + triangle.edgeA[2] * depth2;
+			triangle.depthB = triangle.edgeB[1] * depth1 + triangle.edgeB[2] * depth2;
+			triangle.depthC = source.z[0] + originEdges[1] * depth1 + originEdges[2] * depth2;
+
+			if (m_bUseAVX2)
+			{
+				RasterizeAVX2(triangle, tile);
+			}
+			else
+			{
+				RasterizeSSE(triangle, tile);
+			}
+		}
+	}
+
+	// shade the nearest triangle of every pixel
+	int width = std::min(g_TileSize, m_width - tileX);
+	int height = std::min(g_TileSize, m_height - tileY);
+	const SCENE_LIGHT* pLights = m_lights.empty() ? NULL : &m_lights[0];
+	int lightCount = static_cast<int>(m_lights.size());
+	for (int y = 0; y < height; y++)
+	{
+		uint32_t* pOutput = &m_colorBuffer[static_cast<size_t>(tileY + y) * m_width + tileX];
+		for (int x = 0; x < width; x++)
+		{
+			int pixel = y * g_TileSize + x;
+			uint32_t id = tile.triangle[pixel];
+			if (id == g_NoTriangle)
+			{
+				pOutput[x] = m_clearColor;
+				continue;
+			}
+
+			const RASTER_TRIANGLE& triangle = m_batches[id >> 16].triangles[id & 0xFFFF];
+			// turn the screen space weights into perspective
+			// correct ones
+			float weight1 = tile.weight1[pixel];
+			float weight2 = tile.weight2[pixel];
+			float perspective0 = (1.0f - weight1 - weight2) * triangle.invW[0];
+			float perspective1 = weight1 * triangle.invW[1];
+			float perspective2 = weight2 * triangle.invW[2];
+			float scale = 1.0f / (perspective0 + perspective1 + perspective2);
+			perspective0 *= scale;
+			perspective1 *= scale;
+			perspective2 *= scale;
+
+			glm::vec3 world = triangle.world[0] * perspective0 + triangle.world[1] * perspective1 + triangle.world[2] * perspective2;
+			glm::vec3 normal = triangle.normal[0] * perspective0 + triangle.normal[1] * perspective1 + triangle.normal[2] * perspective2;
+			glm::vec2 texCoord = triangle.texCoord[0] * perspective0 + triangle.texCoord[1] * perspective1 + triangle.texCoord[2] * perspective2;
+
+			pOutput[x] = PackColor(ShadeSurface(
+				draws[triangle.drawIndex].shading,
+				pLights,
+				lightCount,
+				m_viewPosition,
+				world,
+				normal,
+				texCoord));
+		}
+	}
+}
+
+/***********************************************************
+ *  GetWidth()
+ *
+ *  This method returns the width of the color buffer.
+ ***********************************************************/
+int SoftwareRasterizer::GetWidth() const
+{
+	return(m_width);
+}
+
+/***********************************************************
+ *  GetHeight()
+ *
+ *  This method returns the height of the color buffer.
+ ***********************************************************/
+int SoftwareRasterizer::GetHeight() const
+{
+	return(m_height);
+}
+
+/***********************************************************
+ *  GetColorBuffer()
+ *
+ *  This method returns the pixels of the last frame.
+ ***********************************************************/
+const uint32_t* SoftwareRasterizer::GetColorBuffer() const
+{
+	return(m_colorBuffer.empty() ? NULL : &m_colorBuffer[0]);
+}
+
+/***********************************************************
+ *  IsUsingAVX2()
+ *
+ *  This method returns true when the processor supports
+ *  AVX2 and the 8 pixel wide path is used.
+ ***********************************************************/
+bool SoftwareRasterizer::IsUsingAVX2() const
+{
+	return(m_bUseAVX2);
+}
+
+/***********************************************************
+ *  SaveImage()
+ *
+ *  This method is used for writing the last frame into a
+ *  binary PPM image, which most image viewers can open.
+ ***********************************************************/
+bool SoftwareRasterizer::SaveImage(const char* filename) const
+{
+	return(SavePPMImage(filename, m_width, m_height, m_colorBuffer.data()));
+}
@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+// softwarerasterizer.h
+// ============
+// draw the scene on the CPU in screen tiles, for machines without a GPU
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshData.h"
+#include "ShadingModel.h"
+#include "ThreadPool.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  SOFTWARE_DRAW
+ *
+ *  One mesh drawn by the software rasterizer, with the
+ *  transformation and shader settings it was submitted with.
+ ***********************************************************/
+struct SOFTWARE_DRAW
+{
+	const MESH_DATA* pMesh;
+	glm::mat4 model;
+	SURFACE_SHADING shading;
+	// skip the faces turned away (closed meshes only)
+	bool bCullBackFaces;
+};
+
+/***********************************************************
+ *  SoftwareRasterizer
+ *
+ *  This class renders triangle meshes into a color buffer
+ *  without OpenGL.  The screen is split into square tiles,
+ *  the triangles are sorted into the tiles they touch, and
+ *  then every tile is rasterized and shaded on its own
+ *  worker thread.  The edge functions are tested for 8
+ *  pixels at a time with AVX2, or 4 with SSE on processors
+ *  without it.  Each tile first records the nearest
+ *  triangle per pixel and then shades every pixel once,
+ *  using the same lighting as the fragment shader.
+ ***********************************************************/
+class SoftwareRasterizer
+{
+public:
+	// constructor
+	SoftwareRasterizer(ThreadPool* pThreadPool);
+
+	// set the size of the color buffer in pixels
+	void Resize(int width, int height);
+	// set the camera used for the next frames
+	void SetCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition);
+	// set the lights used for the next frames
+	void SetLights(const std::vector<SCENE_LIGHT>& lights);
+	// set the color of the pixels not covered by any mesh
+	void SetClearColor(const glm::vec4& color);
+
+	// draw a frame with the passed meshes - the meshes and
+	// textures only need to stay alive during the call
+	void Render(const std::vector<SOFTWARE_DRAW>& draws);
+
+	int GetWidth() const;
+	int GetHeight() const;
+	// RGBA bytes of the last frame, top row first
+	const uint32_t* GetColorBuffer() const;
+	// write the last frame to a binary PPM file
+	bool SaveImage(const char* filename) const;
+
+	// true when the 8 pixel wide AVX2 path is in use
+	bool IsUsingAVX2() const;
+
+private:
+	// one vertex after the vertex stage
+	struct RASTER_VERTEX
+	{
+		glm::vec4 clip;
+		glm::vec3 world;
+		glm::vec3 normal;
+		glm::vec2 texCoord;
+	};
+
+	// one clipped triangle, ready to be rasterized
+	struct RASTER_TRIANGLE
+	{
+		// screen position snapped to the sub-pixel grid
+		float x[3];
+		float y[3];
+		// window depth and reciprocal clip w of the corners
+		float z[3];
+		float invW[3];
+		// attributes of the corners, for the shading pass
+		glm::vec3 world[3];
+		glm::vec3 normal[3];
+		glm::vec2 texCoord[3];
+		uint32_t drawIndex;
+		// pixel bounds, clamped to the screen
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+	};
+
+	// triangles set up by one batch, and per tile the
+	// indices of the ones that touch it
+	struct TRIANGLE_BATCH
+	{
+		std::vector<RASTER_TRIANGLE> triangles;
+		std::vector<std::vector<uint32_t>> bins;
+	};
+
+	// workers shared with the rest of the scene code
+	ThreadPool* m_pThreadPool;
+	bool m_bUseAVX2;
+
+	int m_width;
+	int m_height;
+	int m_tilesX;
+	int m_tilesY;
+	std::vector<uint32_t> m_colorBuffer;
+	uint32_t m_clearColor;
+
+	glm::mat4 m_viewProjection;
+	glm::vec3 m_viewPosition;
+	std::vector<SCENE_LIGHT> m_lights;
+
+	// per frame scratch data, kept to reuse the memory
+	std::vector<size_t> m_vertexOffsets;
+	std::vector<size_t> m_triangleOffsets;
+	std::vector<RASTER_VERTEX> m_vertices;
+	std::vector<TRIANGLE_BATCH> m_batches;
+
+	// transform every vertex of every draw into clip space
+	void TransformVertices(const std::vector<SOFTWARE_DRAW>& draws);
+	// clip the triangles and sort them into the tiles
+	void SetupTriangles(const std::vector<SOFTWARE_DRAW>& draws);
+	// clip, project and bin one triangle
+	void SetupTriangle(const RASTER_VERTEX* corners[3], const SOFTWARE_DRAW& draw, uint32_t drawIndex, TRIANGLE_BATCH& batch);
+	// add one projected triangle to the batch and its tiles
+	void BinTriangle(const RASTER_VERTEX* corners[3], const SOFTWARE_DRAW& draw, uint32_t drawIndex, TRIANGLE_BATCH& batch);
+	// rasterize and shade one tile
+	void RenderTile(int tileIndex, const std::vector<SOFTWARE_DRAW>& draws);
+};
@@ -0,0 +1,232 @@
+///////////////////////////////////////////////////////////////////////////////
+// staticbatcher.cpp
+// ============
+// merge objects that never move into a few world space meshes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StaticBatcher.h"
+#include "ShadingModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of the helpers
+namespace
+{
+	/***********************************************************
+	 *  AppendTransformed()
+	 *
+	 *  Append a mesh to the chunk in world space.  The UV
+	 *  scale is baked into the texture coordinates, and the
+	 *  winding is flipped for mirroring transformations.
+	 ***********************************************************/
+	void AppendTransformed(const MESH_DATA& mesh, const SCENE_OBJECT& object, MESH_DATA& chunk)
+	{
+		glm::mat3 linear = glm::mat3(object.model);
+		float determinant = glm::dot(linear[0], glm::cross(linear[1], linear[2]));
+		float handedness = (determinant < 0.0f) ? -1.0f : 1.0f;
+		glm::mat3 normalMatrix = ComputeNormalMatrix(object.model);
+		bool bHasTangents = (mesh.tangents.size() == mesh.vertices.size());
+
+		uint32_t base = static_cast<uint32_t>(chunk.vertices.size());
+		for (size_t i = 0; i < mesh.vertices.size(); i++)
+		{
+			const MESH_VERTEX& source = mesh.vertices[i];
+			MESH_VERTEX vertex;
+			vertex.position = glm::vec3(object.model * glm::vec4(source.position, 1.0f));
+			vertex.normal = normalMatrix * source.normal;
+			float normalLength = glm::length(vertex.normal);
+			vertex.normal = (normalLength > 0.0f) ? vertex.normal / normalLength : source.normal;
+			vertex.texCoord = source.texCoord * object.uvScale;
+			chunk.vertices.push_back(vertex);
+
+			chunk.boundsMin = glm::min(chunk.boundsMin, vertex.position);
+			chunk.boundsMax = glm::max(chunk.boundsMax, vertex.position);
+
+			if (bHasTangents)
+			{
+				glm::vec3 sourceTangent = glm::vec3(mesh.tangents[i]);
+				glm::vec3 tangent = linear * sourceTangent;
+				float tangentLength = glm::length(tangent);
+				tangent = (tangentLength > 0.0f) ? tangent / tangentLength : sourceTangent;
+				chunk.tangents.push_back(glm::vec4(tangent, mesh.tangents[i].w * handedness));
+			}
+		}
+
+		for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+		{
+			chunk.indices.push_back(base + mesh.indices[i]);
+			if (determinant < 0.0f)
+			{
+				chunk.indices.push_back(base + mesh.indices[i + 2]);
+				chunk.indices.push_back(base + mesh.indices[i + 1]);
+			}
+			else
+			{
+				chunk.indices.push_back(base + mesh.indices[i + 1]);
+				chunk.indices.push_back(base + mesh.indices[i + 2]);
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  RenderStateLess()
+	 *
+	 *  Ordering of the chunks so that chunks with the same
+	 *  shader settings end up next to each other.
+	 ***********************************************************/
+	bool RenderStateLess(const STATIC_CHUNK& a, const STATIC_CHUNK& b)
+	{
+		int order = a.state.materialTag.compare(b.state.materialTag);
+		if (order != 0)
+		{
+			return(order < 0);
+		}
+		if (a.state.bUseTexture != b.state.bUseTexture)
+		{
+			return(a.state.bUseTexture);
+		}
+		return(a.state.textureTag.compare(b.state.textureTag) < 0);
+	}
+}
+
+/***********************************************************
+ *  HaveSameRenderState()
+ *
+ *  This function is used for checking if two objects use
+ *  the same material and texture, or the same material and
+ *  color when they are not textured.
+ ***********************************************************/
+bool HaveSameRenderState(const SCENE_OBJECT& a, const SCENE_OBJECT& b)
+{
+	if ((a.materialTag != b.materialTag) || (a.bUseTexture != b.bUseTexture))
+	{
+		return(false);
+	}
+	if (a.bUseTexture)
+	{
+		return(a.textureTag == b.textureTag);
+	}
+	return(a.color == b.color);
+}
+
+/***********************************************************
+ *  BakeStaticObjects()
+ *
+ *  This function is used for merging the static objects.
+ *  Each object goes into the grid cell holding the center
+ *  of its bounds, so the chunks stay small enough to be
+ *  culled, and objects in the same cell with the same
+ *  shader settings share one chunk.  Every detail level is
+ *  merged into a mesh of its own, so the chunk can still
+ *  be drawn coarser far away.
+ ***********************************************************/
+void BakeStaticObjects(
+	const std::vector<SCENE_OBJECT>& objects,
+	const MESH_DATA* const* shapeMeshes,
+	float cellSize,
+	std::vector<STATIC_CHUNK>& chunks)
+{
+	chunks.clear();
+	std::vector<glm::ivec3> chunkCells;
+
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		const SCENE_OBJECT& object = objects[i];
+		if (!object.bStatic || !object.meshTag.empty())
+		{
+			continue;
+		}
+		const MESH_DATA* const* pLevels = shapeMeshes + object.shape * SHAPE_MAX_LODS;
+		const MESH_DATA* pMesh = pLevels[0];
+		if ((NULL == pMesh) || pMesh->indices.empty())
+		{
+			continue;
+		}
+		int nLODs = 1;
+		while ((nLODs < SHAPE_MAX_LODS) && (pLevels[nLODs] != pLevels[nLODs - 1]))
+		{
+			nLODs++;
+		}
+		float scale = std::max(
+			glm::length(glm::vec3(object.model[0])),
+			std::max(glm::length(glm::vec3(object.model[1])), glm::length(glm::vec3(object.model[2]))));
+		float radius = glm::length(pMesh->boundsMax - pMesh->boundsMin) * 0.5f * scale;
+
+		glm::vec3 localCenter = (pMesh->boundsMin + pMesh->boundsMax) * 0.5f;
+		glm::vec3 center = glm::vec3(object.model * glm::vec4(localCenter, 1.0f));
+		glm::ivec3 cell(
+			static_cast<int>(std::floor(center.x / cellSize)),
+			static_cast<int>(std::floor(center.y / cellSize)),
+			static_cast<int>(std::floor(center.z / cellSize)));
+
+		size_t chunkIndex = 0;
+		while ((chunkIndex < chunks.size()) &&
+			((chunkCells[chunkIndex] != cell) || !HaveSameRenderState(chunks[chunkIndex].state, object)))
+		{
+			chunkIndex++;
+		}
+		if (chunkIndex == chunks.size())
+		{
+			STATIC_CHUNK chunk;
+			chunk.state = object;
+			chunk.state.model = glm::mat4(1.0f);
+			chunk.state.uvScale = glm::vec2(1.0f);
+			for (int lod = 0; lod < SHAPE_MAX_LODS; lod++)
+			{
+				chunk.meshes[lod].boundsMin = glm::vec3(1.0e30f);
+				chunk.meshes[lod].boundsMax = glm::vec3(-1.0e30f);
+			}
+			chunk.nLODs = 1;
+			chunk.objectRadius = 0.0f;
+			chunk.objectCount = 0;
+			chunks.push_back(chunk);
+			chunkCells.push_back(cell);
+		}
+
+		STATIC_CHUNK& chunk = chunks[chunkIndex];
+		for (int lod = 0; lod < SHAPE_MAX_LODS; lod++)
+		{
+			AppendTransformed(*pLevels[lod], object, chunk.meshes[lod]);
+		}
+		chunk.nLODs = std::max(chunk.nLODs, nLODs);
+		chunk.objectRadius = std::max(chunk.objectRadius, radius);
+		chunk.objectCount++;
+	}
+
+	// the levels past the last one any merged shape has are
+	// copies of it
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		for (int lod = chunks[i].nLODs; lod < SHAPE_MAX_LODS; lod++)
+		{
+			chunks[i].meshes[lod] = MESH_DATA();
+		}
+	}
+
+	std::stable_sort(chunks.begin(), chunks.end(), RenderStateLess);
+}
+
+/***********************************************************
+ *  IsBoxInFrustum()
+ *
+ *  This function is used for testing a bounding box against
+ *  the frustum planes.  A box is only rejected when its
+ *  corner furthest along a plane's normal is still outside.
+ ***********************************************************/
+bool IsBoxInFrustum(const glm::vec4 planes[6], const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+	for (int p = 0; p < 6; p++)
+	{
+		glm::vec3 corner(
+			(planes[p].x >= 0.0f) ? boundsMax.x : boundsMin.x,
+			(planes[p].y >= 0.0f) ? boundsMax.y : boundsMin.y,
+			(planes[p].z >= 0.0f) ? boundsMax.z : boundsMin.z);
+		if (glm::dot(glm::vec3(planes[p]), corner) + planes[p].w < 0.0f)
+		{
+			return(false);
+		}
+	}
+	return(true);
+}
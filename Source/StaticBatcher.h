@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////////////
+// staticbatcher.h
+// ============
+// merge objects that never move into a few world space meshes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshData.h"
+#include "SceneObject.h"
+
+#include <vector>
+
+/***********************************************************
+ *  STATIC_CHUNK
+ *
+ *  The static objects of one spatial cell that share the
+ *  same shader settings, merged into one world space mesh.
+ ***********************************************************/
+struct STATIC_CHUNK
+{
+	// merged mesh at each detail level, finest first - their
+	// bounds are in world space
+	MESH_DATA meshes[SHAPE_MAX_LODS];
+	// levels the merged shapes have, at most - the meshes
+	// past them are left empty
+	int nLODs;
+	// shader settings shared by the merged objects, with an
+	// identity transformation and a UV scale of one
+	SCENE_OBJECT state;
+	// world space radius of the largest merged object, which
+	// the detail level is picked for
+	float objectRadius;
+	// number of objects merged into the chunk
+	size_t objectCount;
+};
+
+// true when two objects can be drawn with the same shader
+// settings, ignoring their transformations
+bool HaveSameRenderState(const SCENE_OBJECT& a, const SCENE_OBJECT& b);
+
+// merge the static basic shapes of the scene into chunks,
+// one per render state and grid cell of cellSize world
+// units - shapeMeshes holds SHAPE_MAX_LODS meshes for each
+// shape, finest first, with a shape that has fewer levels
+// repeating its coarsest one, and objects using external
+// meshes are left out
+void BakeStaticObjects(
+	const std::vector<SCENE_OBJECT>& objects,
+	const MESH_DATA* const* shapeMeshes,
+	float cellSize,
+	std::vector<STATIC_CHUNK>& chunks);
+
+// true when the box is at least partly inside the planes
+bool IsBoxInFrustum(const glm::vec4 planes[6], const glm::vec3& boundsMin, const glm::vec3& boundsMax);
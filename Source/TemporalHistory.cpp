@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+// temporalhistory.cpp
+// ============
+// the previous frame kept for reprojecting into the next
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TemporalHistory.h"
+
+/***********************************************************
+ *  TemporalHistory()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TemporalHistory::TemporalHistory(RenderBackend* pBackend, RENDER_TARGET_FORMAT format, bool bDepth)
+{
+	m_pBackend = pBackend;
+	m_format = format;
+	m_bDepth = bDepth;
+	m_targets[0] = 0;
+	m_targets[1] = 0;
+	m_current = 0;
+	m_width = 0;
+	m_height = 0;
+	m_bHasHistory = false;
+	m_previousViewProjection = glm::mat4(1.0f);
+}
+
+/***********************************************************
+ *  ~TemporalHistory()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TemporalHistory::~TemporalHistory()
+{
+	DestroyTargets();
+	m_pBackend = NULL;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for making the two targets of the
+ *  frame size, again when the size changes, which drops
+ *  the history.
+ ***********************************************************/
+bool TemporalHistory::BeginFrame(int width, int height)
+{
+	if ((0 != m_targets[0]) && (width == m_width) && (height == m_height))
+	{
+		return(true);
+	}
+
+	DestroyTargets();
+	m_bHasHistory = false;
+	m_width = width;
+	m_height = height;
+	for (int i = 0; i < 2; i++)
+	{
+		m_targets[i] = m_pBackend->CreateRenderTarget(width, height, m_format, m_bDepth, 1);
+	}
+	if ((0 == m_targets[0]) || (0 == m_targets[1]))
+	{
+		DestroyTargets();
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for making the frame just drawn the
+ *  history of the next one.
+ ***********************************************************/
+void TemporalHistory::EndFrame(const glm::mat4& viewProjection)
+{
+	if (0 == m_targets[0])
+	{
+		return;
+	}
+	m_previousViewProjection = viewProjection;
+	m_current = 1 - m_current;
+	m_bHasHistory = true;
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for forgetting the last frame, so
+ *  the next one starts without history.
+ ***********************************************************/
+void TemporalHistory::Invalidate()
+{
+	m_bHasHistory = false;
+}
+
+/***********************************************************
+ *  GetHistoryTarget()
+ *
+ *  This method is used for getting the target holding the
+ *  last frame.
+ ***********************************************************/
+uint32_t TemporalHistory::GetHistoryTarget() const
+{
+	return(m_targets[1 - m_current]);
+}
+
+/***********************************************************
+ *  GetCurrentTarget()
+ *
+ *  This method is used for getting the target this frame
+ *  is drawn into.
+ ***********************************************************/
+uint32_t TemporalHistory::GetCurrentTarget() const
+{
+	return(m_targets[m_current]);
+}
+
+/***********************************************************
+ *  HasHistory()
+ *
+ *  This method is used for checking whether the history
+ *  target holds a frame that can be blended in.
+ ***********************************************************/
+bool TemporalHistory::HasHistory() const
+{
+	return(m_bHasHistory);
+}
+
+/***********************************************************
+ *  GetReprojection()
+ *
+ *  This method is used for getting the matrix that takes a
+ *  point from this frame's clip space back to the world
+ *  and into the last frame's clip space.  The scene does
+ *  not move, so the camera is all that changed.
+ ***********************************************************/
+glm::mat4 TemporalHistory::GetReprojection(const glm::mat4& viewProjection) const
+{
+	return(m_previousViewProjection * glm::inverse(viewProjection));
+}
+
+/***********************************************************
+ *  GetBytes()
+ *
+ *  This method is used for estimating the memory of the
+ *  targets, with four bytes a pixel for a depth buffer.
+ ***********************************************************/
+size_t TemporalHistory::GetBytes() const
+{
+	if (0 == m_targets[0])
+	{
+		return(0);
+	}
+	size_t texelBytes = ((RENDER_TARGET_RGBA16F == m_format) ? 8 : 4) + (m_bDepth ? 4 : 0);
+	return(2 * static_cast<size_t>(m_width) * m_height * texelBytes);
+}
+
+/***********************************************************
+ *  DestroyTargets()
+ *
+ *  This method is used for destroying the targets.
+ ***********************************************************/
+void TemporalHistory::DestroyTargets()
+{
+	for (int i = 0; i < 2; i++)
+	{
+		if (0 != m_targets[i])
+		{
+			m_pBackend->DestroyRenderTarget(m_targets[i]);
+			m_targets[i] = 0;
+		}
+	}
+	m_current = 0;
+}
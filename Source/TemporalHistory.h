@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////
+// temporalhistory.h
+// ============
+// the previous frame kept for reprojecting into the next
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  TemporalHistory
+ *
+ *  This class keeps two frame sized targets, one holding
+ *  the last frame and one the frame being drawn, which swap
+ *  at the end of each frame, along with the camera the last
+ *  frame was drawn with.  A pixel of this frame at a known
+ *  depth is found in the last one with GetReprojection().
+ *  The history is dropped when the size changes or the
+ *  caller stops using it, so nothing stale is blended in.
+ ***********************************************************/
+class TemporalHistory
+{
+public:
+	// constructor - the targets are made in the format, with
+	// a depth buffer when asked for
+	TemporalHistory(RenderBackend* pBackend, RENDER_TARGET_FORMAT format, bool bDepth);
+	// destructor
+	~TemporalHistory();
+
+	// make the targets for a frame of the passed size -
+	// returns false when the backend cannot
+	bool BeginFrame(int width, int height);
+	// keep the frame drawn as the history of the next one,
+	// with the view and projection it was drawn with
+	void EndFrame(const glm::mat4& viewProjection);
+	// forget the last frame
+	void Invalidate();
+
+	// the last frame, and the target of this one
+	uint32_t GetHistoryTarget() const;
+	uint32_t GetCurrentTarget() const;
+	// whether the last frame can be blended in
+	bool HasHistory() const;
+	// from this frame's clip space to the last frame's
+	glm::mat4 GetReprojection(const glm::mat4& viewProjection) const;
+	// estimated memory of the two targets
+	size_t GetBytes() const;
+
+private:
+	RenderBackend* m_pBackend;
+	RENDER_TARGET_FORMAT m_format;
+	bool m_bDepth;
+	uint32_t m_targets[2];
+	// which target this frame draws into
+	int m_current;
+	int m_width;
+	int m_height;
+	bool m_bHasHistory;
+	glm::mat4 m_previousViewProjection;
+
+	// destroy both targets
+	void DestroyTargets();
+};
@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+// threadpool.cpp
+// ============
+// manage a fixed set of worker threads for background tasks
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+/***********************************************************
+ *  ThreadPool()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	m_bStopping = false;
+
+	if (threadCount == 0)
+	{
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+	}
+}
+
+/***********************************************************
+ *  ~ThreadPool()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_queueMutex);
+		m_bStopping = true;
+	}
+	m_queueSignal.notify_all();
+
+	// let the workers drain the queue and exit
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+}
+
+/***********************************************************
+ *  GetThreadCount()
+ *
+ *  This method returns the number of worker threads.
+ ***********************************************************/
+unsigned int ThreadPool::GetThreadCount() const
+{
+	return(static_cast<unsigned int>(m_workers.size()));
+}
+
+/***********************************************************
+ *  Enqueue()
+ *
+ *  This method adds a task to the queue and wakes up one
+ *  of the waiting worker threads.
+ ***********************************************************/
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_queueMutex);
+		m_tasks.push(std::move(task));
+	}
+	m_queueSignal.notify_one();
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is run by every worker thread.  It keeps
+ *  pulling tasks off the queue until the pool is stopped
+ *  and the queue is empty.
+ ***********************************************************/
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_queueMutex);
+			m_queueSignal.wait(lock, [this]() { return m_bStopping || !m_tasks.empty(); });
+			if (m_tasks.empty())
+			{
+				return;
+			}
+			task = std::move(m_tasks.front());
+			m_tasks.pop();
+		}
+		task();
+	}
+}
+
+/***********************************************************
+ *  ParallelFor()
+ *
+ *  This method splits the range [0, count) into batches of
+ *  batchSize items and runs the body on each batch.  The
+ *  calling thread works on batches too, so it is safe to
+ *  call from inside a task that is running on the pool.
+ ***********************************************************/
+void ThreadPool::ParallelFor(
+	size_t count,
+	size_t batchSize,
+	const std::function<void(size_t, size_t)>& body)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	batchSize = std::max<size_t>(1, batchSize);
+
+	size_t batchCount = (count + batchSize - 1) / batchSize;
+	if (batchCount == 1)
+	{
+		body(0, count);
+		return;
+	}
+
+	// the batches are claimed through a shared counter so the
+	// caller and any idle workers pick them up as they free up
+	struct SHARED_STATE
+	{
+		std::atomic<size_t> nextBatch;
+		std::atomic<size_t> doneBatches;
+		std::mutex doneMutex;
+		std::condition_variable doneSignal;
+	};
+	std::shared_ptr<SHARED_STATE> state = std::make_shared<SHARED_STATE>();
+	state->nextBatch = 0;
+	state->doneBatches = 0;
+
+	std::function<void()> runBatches = [state, count, batchSize, batchCount, &body]()
+	{
+		size_t batch = state->nextBatch.fetch_add(1);
+		while (batch < batchCount)
+		{
+			size_t begin = batch * batchSize;
+			body(begin, std::min(count, begin + batchSize));
+			if (state->doneBatches.fetch_add(1) + 1 == batchCount)
+			{
+				std::lock_guard<std::mutex> lock(state->doneMutex);
+				state->doneSignal.notify_all();
+			}
+			batch = state->nextBatch.fetch_add(1);
+		}
+	};
+
+	size_t helpers = std::min<size_t>(m_workers.size(), batchCount - 1);
+	for (size_t i = 0; i < helpers; i++)
+	{
+		Enqueue(runBatches);
+	}
+	runBatches();
+
+	std::unique_lock<std::mutex> lock(state->doneMutex);
+	state->doneSignal.wait(lock, [state, batchCount]() { return state->doneBatches == batchCount; });
+}
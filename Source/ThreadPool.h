@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// threadpool.h
+// ============
+// manage a fixed set of worker threads for background tasks
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  ThreadPool
+ *
+ *  This class owns a fixed number of worker threads that
+ *  pull tasks from a shared queue.  It is used for work
+ *  that does not touch the OpenGL context, such as parsing
+ *  mesh files or generating geometry.
+ ***********************************************************/
+class ThreadPool
+{
+public:
+	// constructor - zero threads means one per hardware core
+	ThreadPool(unsigned int threadCount = 0);
+	// destructor
+	~ThreadPool();
+
+	// number of worker threads owned by the pool
+	unsigned int GetThreadCount() const;
+
+	// queue a task and get a future for its result
+	template<class TASK>
+	auto Submit(TASK task) -> std::future<decltype(task())>
+	{
+		typedef decltype(task()) RESULT;
+		std::shared_ptr<std::packaged_task<RESULT()>> packaged =
+			std::make_shared<std::packaged_task<RESULT()>>(task);
+		std::future<RESULT> result = packaged->get_future();
+		Enqueue([packaged]() { (*packaged)(); });
+		return(result);
+	}
+
+	// split the range [0, count) into batches and run them
+	// on the workers, returning when all batches are done
+	void ParallelFor(
+		size_t count,
+		size_t batchSize,
+		const std::function<void(size_t, size_t)>& body);
+
+private:
+	// worker threads
+	std::vector<std::thread> m_workers;
+	// tasks waiting for a worker
+	std::queue<std::function<void()>> m_tasks;
+	// guards the task queue and the stop flag
+	std::mutex m_queueMutex;
+	// signalled when a task is queued or the pool stops
+	std::condition_variable m_queueSignal;
+	// set when the pool is being destroyed
+	bool m_bStopping;
+
+	// add a task to the queue and wake a worker
+	void Enqueue(std::function<void()> task);
+	// main loop for each worker thread
+	void WorkerLoop();
+};
@@ -0,0 +1,242 @@
+///////////////////////////////////////////////////////////////////////////////
+// tonemappasses.cpp
+// ============
+// bloom, exposure and tone mapping passes of the post-processing chain
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ToneMapPasses.h"
+
+#include <iostream>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// levels the bloom halves the scene down to, and the share
+	// of the glow in the result - all the light blooms, the
+	// brightest the most, so there is no threshold
+	const int g_BloomLevels = 5;
+	const float g_BloomStrength = 0.05f;
+	// the bloom level the luminance histogram reads, its bins
+	// and the bands it is counted in, and the range of the
+	// bins in stops
+	const int g_HistogramLevel = 4;
+	const int g_HistogramBins = 64;
+	const int g_HistogramBands = 16;
+	const float g_MinLogLuminance = -8.0f;
+	const float g_MaxLogLuminance = 4.0f;
+	// the share of darkest and brightest samples left out of
+	// the exposure, the luminance the rest is brought to, the
+	// limits of the exposure and how fast it adapts a second -
+	// the scene is lit for a display with no gamma curve after
+	// the tone mapping, so the key is where the ACES curve
+	// gives its average back about as it was
+	const float g_ExposureLowPercent = 0.5f;
+	const float g_ExposureHighPercent = 0.95f;
+	const float g_ExposureKey = 0.4f;
+	const float g_MinExposure = 0.25f;
+	const float g_MaxExposure = 4.0f;
+	const float g_ExposureAdaptationSpeed = 1.5f;
+}
+
+/***********************************************************
+ *  ToneMapPasses()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ToneMapPasses::ToneMapPasses(RenderBackend* pBackend) :
+	m_exposureHistory(pBackend, RENDER_TARGET_R32F, false)
+{
+	m_pBackend = pBackend;
+	m_bloomDownsampleProgram = 0;
+	m_bloomUpsampleProgram = 0;
+	m_histogramProgram = 0;
+	m_exposureProgram = 0;
+	m_toneMapProgram = 0;
+	m_frameSeconds = 0.0f;
+}
+
+/***********************************************************
+ *  ~ToneMapPasses()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ToneMapPasses::~ToneMapPasses()
+{
+	m_pBackend = NULL;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for loading the programs of the
+ *  passes, which all draw the triangle covering the frame.
+ ***********************************************************/
+bool ToneMapPasses::Create()
+{
+	const char* vertexFilename = "Shaders/fullscreenVertexShader.glsl";
+	m_bloomDownsampleProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/bloomDownsampleFragmentShader.glsl");
+	m_bloomUpsampleProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/bloomUpsampleFragmentShader.glsl");
+	m_histogramProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/luminanceHistogramFragmentShader.glsl");
+	m_exposureProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/exposureFragmentShader.glsl");
+	m_toneMapProgram = m_pBackend->CreateProgram(vertexFilename, "Shaders/toneMapFragmentShader.glsl");
+	if ((0 == m_bloomDownsampleProgram) || (0 == m_bloomUpsampleProgram) || (0 == m_histogramProgram) ||
+		(0 == m_exposureProgram) || (0 == m_toneMapProgram))
+	{
+		std::cout << "Could not load the tone mapping shaders" << std::endl;
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  AddPasses()
+ *
+ *  This method is used for adding the passes to a chain,
+ *  reading the passed output and tone mapping it into the
+ *  named one, or into the window.
+ ***********************************************************/
+void ToneMapPasses::AddPasses(PostProcessChain* pChain, const std::string& scene, const std::string& output)
+{
+	POST_PROCESS_PASS pass;
+	pass.width = 0;
+	pass.height = 0;
+
+	// the bloom halves the scene level by level, then adds
+	// each level to the one above on the way back up, so wide
+	// and tight glows are summed in a fixed number of passes
+	std::string above = scene;
+	for (int level = 1; level <= g_BloomLevels; level++)
+	{
+		pass.name = "bloom down " + std::to_string(level);
+		pass.program = m_bloomDownsampleProgram;
+		pass.inputs.assign(1, above);
+		pass.output = "bloomDown" + std::to_string(level);
+		pass.format = RENDER_TARGET_RGBA16F;
+		pass.scale = 1.0f / static_cast<float>(1 << level);
+		int firstLevel = (1 == level) ? 1 : 0;
+		pass.setUniforms = [firstLevel](RenderBackend* pBackend)
+		{
+			pBackend->SetUniformInt("firstLevel", firstLevel);
+		};
+		pChain->AddPass(pass);
+		above = pass.output;
+	}
+	pass.setUniforms = nullptr;
+	for (int level = g_BloomLevels - 1; level >= 1; level--)
+	{
+		pass.name = "bloom up " + std::to_string(level);
+		pass.program = m_bloomUpsampleProgram;
+		pass.inputs.assign(1, above);
+		pass.inputs.push_back("bloomDown" + std::to_string(level));
+		pass.output = "bloomUp" + std::to_string(level);
+		pass.scale = 1.0f / static_cast<float>(1 << level);
+		pChain->AddPass(pass);
+		above = pass.output;
+	}
+	std::string bloom = above;
+
+	// the exposure comes from a histogram of a small level,
+	// counted over a grid of the same size at any resolution
+	// in bands that the exposure pass adds up, and eases from
+	// the last frame's towards the one the histogram asks for
+	pass.name = "luminance histogram";
+	pass.program = m_histogramProgram;
+	pass.inputs.assign(1, "bloomDown" + std::to_string(g_HistogramLevel));
+	pass.output = "luminanceHistogram";
+	pass.format = RENDER_TARGET_R32F;
+	pass.width = g_HistogramBins;
+	pass.height = g_HistogramBands;
+	pass.setUniforms = [](RenderBackend* pBackend)
+	{
+		pBackend->SetUniformFloat("minimumLogLuminance", g_MinLogLuminance);
+		pBackend->SetUniformFloat("maximumLogLuminance", g_MaxLogLuminance);
+		pBackend->SetUniformInt("binCount", g_HistogramBins);
+		pBackend->SetUniformInt("bandCount", g_HistogramBands);
+	};
+	pChain->AddPass(pass);
+
+	pass.name = "exposure";
+	pass.program = m_exposureProgram;
+	pass.inputs.assign(1, "luminanceHistogram");
+	pass.inputs.push_back("exposureHistory");
+	pass.output = "exposure";
+	pass.width = 1;
+	pass.height = 1;
+	pass.setUniforms = [this](RenderBackend* pBackend)
+	{
+		pBackend->SetUniformFloat("minimumLogLuminance", g_MinLogLuminance);
+		pBackend->SetUniformFloat("maximumLogLuminance", g_MaxLogLuminance);
+		pBackend->SetUniformFloat("lowPercent", g_ExposureLowPercent);
+		pBackend->SetUniformFloat("highPercent", g_ExposureHighPercent);
+		pBackend->SetUniformFloat("key", g_ExposureKey);
+		pBackend->SetUniformFloat("minimumExposure", g_MinExposure);
+		pBackend->SetUniformFloat("maximumExposure", g_MaxExposure);
+		pBackend->SetUniformFloat("deltaTime", m_frameSeconds);
+		pBackend->SetUniformFloat("adaptationSpeed", g_ExposureAdaptationSpeed);
+		pBackend->SetUniformInt("hasHistory", m_exposureHistory.HasHistory() ? 1 : 0);
+	};
+	pChain->AddPass(pass);
+	pass.width = 0;
+	pass.height = 0;
+
+	pass.name = "tone map";
+	pass.program = m_toneMapProgram;
+	pass.inputs.assign(1, scene);
+	pass.inputs.push_back(bloom);
+	pass.inputs.push_back("exposure");
+	pass.output = output;
+	pass.format = RENDER_TARGET_RGBA8;
+	pass.scale = 1.0f;
+	pass.setUniforms = [](RenderBackend* pBackend)
+	{
+		pBackend->SetUniformFloat("bloomStrength", g_BloomStrength);
+		pBackend->SetUniformFloat("bloomScale", 1.0f / static_cast<float>(g_BloomLevels));
+	};
+	pChain->AddPass(pass);
+}
+
+/***********************************************************
+ *  ImportTargets()
+ *
+ *  This method is used for putting the exposure targets in
+ *  place of the transient ones the chain declared for the
+ *  exposure pass.  They swap every frame, so they are
+ *  imported again each one.
+ ***********************************************************/
+void ToneMapPasses::ImportTargets(FrameGraph* pGraph)
+{
+	pGraph->ImportTarget("exposureHistory", m_exposureHistory.GetHistoryTarget());
+	pGraph->ImportTarget("exposure", m_exposureHistory.GetCurrentTarget());
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for making the exposure targets for
+ *  a frame that is tone mapped and putting them in the
+ *  graph.  Any other frame, such as a debug view, leaves
+ *  the exposure alone, so it is dropped.
+ ***********************************************************/
+bool ToneMapPasses::BeginFrame(FrameGraph* pGraph, bool bToneMapped, float frameSeconds)
+{
+	m_frameSeconds = frameSeconds;
+	if (bToneMapped && m_exposureHistory.BeginFrame(1, 1))
+	{
+		ImportTargets(pGraph);
+		return(true);
+	}
+	m_exposureHistory.Invalidate();
+	return(false);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for keeping the exposure worked out
+ *  this frame for the next one to ease from.
+ ***********************************************************/
+void ToneMapPasses::EndFrame()
+{
+	m_exposureHistory.EndFrame(glm::mat4(1.0f));
+}
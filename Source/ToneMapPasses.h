@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+// tonemappasses.h
+// ============
+// bloom, exposure and tone mapping passes of the post-processing chain
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameGraph.h"
+#include "PostProcessChain.h"
+#include "RenderBackend.h"
+#include "TemporalHistory.h"
+
+#include <string>
+
+/***********************************************************
+ *  ToneMapPasses
+ *
+ *  This class holds the programs of the passes that bring
+ *  the scene into the display's range, and the exposure of
+ *  the last frame, and adds the passes to a chain: a bloom
+ *  halving the scene down a chain of levels and tent
+ *  filtering it back up, a histogram of the luminance of
+ *  one of the small levels summed into the exposure, and
+ *  the ACES tone mapping that adds the bloom at that
+ *  exposure.  The histogram and exposure targets have a
+ *  fixed size, and the levels shrink by four each step, so
+ *  the passes cost little more than the first level at any
+ *  resolution.
+ ***********************************************************/
+class ToneMapPasses
+{
+public:
+	// constructor
+	ToneMapPasses(RenderBackend* pBackend);
+	// destructor
+	~ToneMapPasses();
+
+	// make the programs
+	bool Create();
+
+	// add the passes reading the passed output of the chain
+	// and tone mapping it into the named output, or into the
+	// window when the name is empty
+	void AddPasses(PostProcessChain* pChain, const std::string& scene, const std::string& output);
+	// put the exposure targets in place of the transient ones
+	// the chain declared
+	void ImportTargets(FrameGraph* pGraph);
+
+	// keep the exposure through a frame that is tone mapped,
+	// easing it over the passed seconds since the last, or
+	// drop it - returns whether it is kept
+	bool BeginFrame(FrameGraph* pGraph, bool bToneMapped, float frameSeconds);
+	// keep the frame's exposure for the next one
+	void EndFrame();
+
+private:
+	RenderBackend* m_pBackend;
+	uint32_t m_bloomDownsampleProgram;
+	uint32_t m_bloomUpsampleProgram;
+	uint32_t m_histogramProgram;
+	uint32_t m_exposureProgram;
+	uint32_t m_toneMapProgram;
+	// the last frame's exposure, which the next eases from
+	TemporalHistory m_exposureHistory;
+	float m_frameSeconds;
+};
@@ -0,0 +1,626 @@
+///////////////////////////////////////////////////////////////////////////////
+// tracereplayer.cpp
+// ============
+// replay a recorded stream of rendering commands on a backend
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TraceReplayer.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// declaration of the global variables and helpers
+namespace
+{
+	/***********************************************************
+	 *  TRACE_READER
+	 *
+	 *  Position in the commands being replayed.  Reading past
+	 *  the end marks the reader failed instead of reading on.
+	 ***********************************************************/
+	struct TRACE_READER
+	{
+		const unsigned char* pData;
+		size_t position;
+		size_t end;
+		bool bFailed;
+	};
+
+	/***********************************************************
+	 *  ReadBytes()
+	 *
+	 *  This function is used for getting a pointer to the next
+	 *  bytes of the trace and moving past them, or NULL when
+	 *  the trace ends first.
+	 ***********************************************************/
+	const unsigned char* ReadBytes(TRACE_READER& reader, size_t size)
+	{
+		if (reader.bFailed || (size > reader.end - reader.position))
+		{
+			reader.bFailed = true;
+			return(NULL);
+		}
+
+		const unsigned char* pBytes = reader.pData + reader.position;
+		reader.position += size;
+		return(pBytes);
+	}
+
+	/***********************************************************
+	 *  ReadValue()
+	 *
+	 *  This function is used for copying the next bytes of the
+	 *  trace into a value, which is left zero when the trace
+	 *  ends first.
+	 ***********************************************************/
+	void ReadValue(TRACE_READER& reader, void* pValue, size_t size)
+	{
+		const unsigned char* pBytes = ReadBytes(reader, size);
+		if (NULL != pBytes)
+		{
+			memcpy(pValue, pBytes, size);
+		}
+		else
+		{
+			memset(pValue, 0, size);
+		}
+	}
+
+	/***********************************************************
+	 *  ReadUint32()
+	 *
+	 *  This function is used for reading a size, offset or
+	 *  handle.
+	 ***********************************************************/
+	uint32_t ReadUint32(TRACE_READER& reader)
+	{
+		uint32_t value = 0;
+		ReadValue(reader, &value, sizeof(value));
+		return(value);
+	}
+
+	/***********************************************************
+	 *  ReadData()
+	 *
+	 *  This function is used for reading data that was passed
+	 *  by pointer, returning its size and a pointer into the
+	 *  trace, which is NULL when NULL was passed.
+	 ***********************************************************/
+	const unsigned char* ReadData(TRACE_READER& reader, size_t& size)
+	{
+		uint8_t present = 0;
+		size = ReadUint32(reader);
+		ReadValue(reader, &present, sizeof(present));
+		return((0 != present) ? ReadBytes(reader, size) : NULL);
+	}
+
+	/***********************************************************
+	 *  ReadString()
+	 *
+	 *  This function is used for reading a string.
+	 ***********************************************************/
+	std::string ReadString(TRACE_READER& reader)
+	{
+		uint16_t length = 0;
+		ReadValue(reader, &length, sizeof(length));
+		const unsigned char* pText = ReadBytes(reader, length);
+		return((NULL != pText) ? std::string(reinterpret_cast<const char*>(pText), length) : std::string());
+	}
+
+	/***********************************************************
+	 *  MapHandle()
+	 *
+	 *  This function is used for finding the replayed object of
+	 *  a recorded handle, or zero for an unknown one.
+	 ***********************************************************/
+	uint32_t MapHandle(const std::unordered_map<uint32_t, uint32_t>& handles, uint32_t recorded)
+	{
+		std::unordered_map<uint32_t, uint32_t>::const_iterator found = handles.find(recorded);
+		return((found != handles.end()) ? found->second : 0);
+	}
+}
+
+/***********************************************************
+ *  TraceReplayer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TraceReplayer::TraceReplayer()
+{
+	m_frameStart = 0;
+	m_frameCount = 0;
+}
+
+/***********************************************************
+ *  ~TraceReplayer()
+ *
+ *  The destructor for the class.  The replayed objects
+ *  belong to the backend and are freed by Release().
+ ***********************************************************/
+TraceReplayer::~TraceReplayer()
+{
+}
+
+/***********************************************************
+ *  LoadTrace()
+ *
+ *  This method is used for reading a trace file and
+ *  checking its header.
+ ***********************************************************/
+bool TraceReplayer::LoadTrace(const char* filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not open trace:" << filename << std::endl;
+		return(false);
+	}
+
+	TRACE_HEADER header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file || (0 != memcmp(header.magic, "RTRC", sizeof(header.magic))) || (g_TraceVersion != header.version))
+	{
+		std::cout << "Not a command trace:" << filename << std::endl;
+		return(false);
+	}
+
+	m_commands.resize(header.commandBytes);
+	file.read(reinterpret_cast<char*>(m_commands.data()), m_commands.size());
+	if (!file)
+	{
+		std::cout << "Command trace is cut short:" << filename << std::endl;
+		m_commands.clear();
+		return(false);
+	}
+	m_frameCount = header.frameCount;
+	// no frames until Prepare() has walked the setup
+	m_frameStart = m_commands.size();
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetFrameCount()
+ *
+ *  This method is used for getting the number of frames
+ *  one ReplayFrames() call draws.
+ ***********************************************************/
+size_t TraceReplayer::GetFrameCount() const
+{
+	return(m_frameCount);
+}
+
+/***********************************************************
+ *  Prepare()
+ *
+ *  This method is used for running the setup commands,
+ *  which creates the objects the frames draw with, and
+ *  finds where the frames start.
+ ***********************************************************/
+bool TraceReplayer::Prepare(RenderBackend* pBackend)
+{
+	return(Execute(pBackend, 0, true));
+}
+
+/***********************************************************
+ *  ReplayFrames()
+ *
+ *  This method is used for running every recorded frame.
+ ***********************************************************/
+bool TraceReplayer::ReplayFrames(RenderBackend* pBackend)
+{
+	return(Execute(pBackend, m_frameStart, false));
+}
+
+/***********************************************************
+ *  Release()
+ *
+ *  This method is used for destroying every object the
+ *  replay created that the trace did not destroy itself.
+ ***********************************************************/
+void TraceReplayer::Release(RenderBackend* pBackend)
+{
+	std::unordered_map<uint32_t, uint32_t>::const_iterator handle;
+	for (handle = m_renderTargets.begin(); handle != m_renderTargets.end(); ++handle)
+	{
+		pBackend->DestroyRenderTarget(handle->second);
+	}
+	for (handle = m_layouts.begin(); handle != m_layouts.end(); ++handle)
+	{
+		pBackend->DestroyVertexLayout(handle->second);
+	}
+	for (handle = m_buffers.begin(); handle != m_buffers.end(); ++handle)
+	{
+		pBackend->DestroyBuffer(handle->second);
+	}
+	for (handle = m_textures.begin(); handle != m_textures.end(); ++handle)
+	{
+		pBackend->DestroyTexture(handle->second);
+	}
+	m_layouts.clear();
+	m_buffers.clear();
+	m_textures.clear();
+	m_renderTargets.clear();
+	m_targetTextures.clear();
+	// the backends have no way to delete a program
+	m_programs.clear();
+}
+
+/***********************************************************
+ *  DestroyRenderTarget()
+ *
+ *  This method is used for destroying a replayed render
+ *  target, dropping its textures from the texture handles
+ *  so a later bind of them binds nothing.
+ ***********************************************************/
+void TraceReplayer::DestroyRenderTarget(RenderBackend* pBackend, uint32_t target)
+{
+	uint32_t texture = pBackend->GetRenderTargetTexture(target);
+	uint32_t depthTexture = pBackend->GetRenderTargetDepthTexture(target);
+	std::unordered_map<uint32_t, uint32_t>::iterator handle = m_targetTextures.begin();
+	while (handle != m_targetTextures.end())
+	{
+		if ((handle->second == texture) || ((0 != depthTexture) && (handle->second == depthTexture)))
+		{
+			handle = m_targetTextures.erase(handle);
+		}
+		else
+		{
+			++handle;
+		}
+	}
+	pBackend->DestroyRenderTarget(target);
+}
+
+/***********************************************************
+ *  Execute()
+ *
+ *  This method is used for decoding the commands from an
+ *  offset and making them on the backend.  The setup stops
+ *  in front of the first TRACE_BEGIN_FRAME and remembers
+ *  where it is.  Returns false for a damaged trace.
+ ***********************************************************/
+bool TraceReplayer::Execute(RenderBackend* pBackend, size_t begin, bool bSetup)
+{
+	TRACE_READER reader = { m_commands.data(), begin, m_commands.size(), false };
+
+	while ((reader.position < reader.end) && !reader.bFailed)
+	{
+		size_t commandStart = reader.position;
+		uint8_t command = 0;
+		ReadValue(reader, &command, sizeof(command));
+
+		switch (command)
+		{
+		case TRACE_DEFINE_NAME:
+		{
+			uint16_t id = 0;
+			ReadValue(reader, &id, sizeof(id));
+			if (id >= m_names.size())
+			{
+				m_names.resize(id + 1);
+			}
+			m_names[id] = ReadString(reader);
+			break;
+		}
+		case TRACE_CREATE_BUFFER:
+		{
+			uint32_t recorded = ReadUint32(reader);
+			BUFFER_TYPE type = static_cast<BUFFER_TYPE>(ReadUint32(reader));
+			size_t size = 0;
+			const unsigned char* pData = ReadData(reader, size);
+			uint32_t earlier = MapHandle(m_buffers, recorded);
+			if (0 != earlier)
+			{
+				pBackend->DestroyBuffer(earlier);
+			}
+			m_buffers[recorded] = pBackend->CreateBuffer(type, size, pData);
+			break;
+		}
+		case TRACE_UPDATE_BUFFER:
+		{
+			uint32_t buffer = MapHandle(m_buffers, ReadUint32(reader));
+			size_t offset = ReadUint32(reader);
+			size_t size = 0;
+			const unsigned char* pData = ReadData(reader, size);
+			pBackend->UpdateBuffer(buffer, offset, size, pData);
+			break;
+		}
+		case TRACE_COPY_BUFFER:
+		{
+			uint32_t source = MapHandle(m_buffers, ReadUint32(reader));
+			uint32_t destination = MapHandle(m_buffers, ReadUint32(reader));
+			size_t sourceOffset = ReadUint32(reader);
+			size_t destinationOffset = ReadUint32(reader);
+			size_t size = ReadUint32(reader);
+			pBackend->CopyBuffer(source, destination, sourceOffset, destinationOffset, size);
+			break;
+		}
+		case TRACE_DESTROY_BUFFER:
+		{
+			uint32_t recorded = ReadUint32(reader);
+			uint32_t buffer = MapHandle(m_buffers, recorded);
+			if (0 != buffer)
+			{
+				pBackend->DestroyBuffer(buffer);
+				m_buffers.erase(recorded);
+			}
+			break;
+		}
+		case TRACE_CREATE_VERTEX_LAYOUT:
+		{
+			uint32_t recorded = ReadUint32(reader);
+			uint32_t indexBuffer = MapHandle(m_buffers, ReadUint32(reader));
+			uint32_t attributeCount = ReadUint32(reader);
+			const unsigned char* pAttributes = ReadBytes(reader, attributeCount * sizeof(VERTEX_ATTRIBUTE));
+			if (NULL == pAttributes)
+			{
+				break;
+			}
+			m_attributes.resize(attributeCount);
+			memcpy(m_attributes.data(), pAttributes, attributeCount * sizeof(VERTEX_ATTRIBUTE));
+			for (size_t i = 0; i < m_attributes.size(); i++)
+			{
+				m_attributes[i].buffer = MapHandle(m_buffers, m_attributes[i].buffer);
+			}
+			uint32_t earlier = MapHandle(m_layouts, recorded);
+			if (0 != earlier)
+			{
+				pBackend->DestroyVertexLayout(earlier);
+			}
+			m_layouts[recorded] = pBackend->CreateVertexLayout(m_attributes.data(), attributeCount, indexBuffer);
+			break;
+		}
+		case TRACE_DESTROY_VERTEX_LAYOUT:
+		{
+			uint32_t recorded = ReadUint32(reader);
+			uint32_t layout = MapHandle(m_layouts, recorded);
+			if (0 != layout)
+			{
+				pBackend->DestroyVertexLayout(layout);
+				m_layouts.erase(recorded);
+			}
+			break;
+		}
+		case TRACE_CREATE_TEXTURE:
+		{
+			uint32_t recorded = ReadUint32(reader);
+			int width = static_cast<int>(ReadUint32(reader));
+			int height = static_cast<int>(ReadUint32(reader));
+			int channels = static_cast<int>(ReadUint32(reader));
+			size_t size = 0;
+			const unsigned char* pPixels = ReadData(reader, size);
+			uint32_t earlier = MapHandle(m_textures, recorded);
+			if (0 != earlier)
+			{
+				pBackend->DestroyTexture(earlier);
+			}
+			m_textures[recorded] = pBackend->CreateTexture(width, height, channels, pPixels);
+			break;
+		}
+		case TRACE_BIND_TEXTURE:
+		{
+			int slot = static_cast<int>(ReadUint32(reader));
+			uint32_t recorded = ReadUint32(reader);
+			uint32_t texture = MapHandle(m_textures, recorded);
+			if (0 == texture)
+			{
+				texture = MapHandle(m_targetTextures, recorded);
+			}
+			pBackend->BindTexture(slot, texture);
+			break;
+		}
+		case TRACE_DESTROY_TEXTURE:
+		{
+			uint32_t recorded = ReadUint32(reader);
+			uint32_t texture = MapHandle(m_textures, recorded);
+			if (0 != texture)
+			{
+				pBackend->DestroyTexture(texture);
+				m_textures.erase(recorded);
+			}
+			break;
+		}
+		case TRACE_CREATE_PROGRAM:
+		{
+			uint32_t recorded = ReadUint32(reader);
+			std::string vertexFilename = ReadString(reader);
+			std::string fragmentFilename = ReadString(reader);
+			// a program is only built once, however often the
+			// frames create it
+			if (0 == MapHandle(m_programs, recorded))
+			{
+				m_programs[recorded] = pBackend->CreateProgram(vertexFilename.c_str(), fragmentFilename.c_str());
+			}
+			break;
+		}
+		case TRACE_USE_PROGRAM:
+		{
+			pBackend->UseProgram(MapHandle(m_programs, ReadUint32(reader)));
+			break;
+		}
+		case TRACE_SET_UNIFORM_INT:
+		case TRACE_SET_UNIFORM_FLOAT:
+		case TRACE_SET_UNIFORM_VEC2:
+		case TRACE_SET_UNIFORM_VEC3:
+		case TRACE_SET_UNIFORM_VEC4:
+		case TRACE_SET_UNIFORM_MAT4:
+		case TRACE_SET_UNIFORM_SAMPLER:
+		{
+			uint16_t id = 0;
+			ReadValue(reader, &id, sizeof(id));
+			if (id >= m_names.size())
+			{
+				reader.bFailed = true;
+				break;
+			}
+			const std::string& name = m_names[id];
+
+			if ((TRACE_SET_UNIFORM_INT == command) || (TRACE_SET_UNIFORM_SAMPLER == command))
+			{
+				int value = 0;
+				ReadValue(reader, &value, sizeof(value));
+				if (TRACE_SET_UNIFORM_INT == command)
+				{
+					pBackend->SetUniformInt(name, value);
+				}
+				else
+				{
+					pBackend->SetUniformSampler(name, value);
+				}
+			}
+			else if (TRACE_SET_UNIFORM_FLOAT == command)
+			{
+				float value = 0.0f;
+				ReadValue(reader, &value, sizeof(value));
+				pBackend->SetUniformFloat(name, value);
+			}
+			else if (TRACE_SET_UNIFORM_VEC2 == command)
+			{
+				glm::vec2 value;
+				ReadValue(reader, &value, sizeof(value));
+				pBackend->SetUniformVec2(name, value);
+			}
+			else if (TRACE_SET_UNIFORM_VEC3 == command)
+			{
+				glm::vec3 value;
+				ReadValue(reader, &value, sizeof(value));
+				pBackend->SetUniformVec3(name, value);
+			}
+			else if (TRACE_SET_UNIFORM_VEC4 == command)
+			{
+				glm::vec4 value;
+				ReadValue(reader, &value, sizeof(value));
+				pBackend->SetUniformVec4(name, value);
+			}
+			else
+			{
+				glm::mat4 value;
+				ReadValue(reader, &value, sizeof(value));
+				pBackend->SetUniformMat4(name, value);
+			}
+			break;
+		}
+		case TRACE_BEGIN_FRAME:
+		{
+			if (bSetup)
+			{
+				m_frameStart = commandStart;
+				return(true);
+			}
+			pBackend->BeginFrame();
+			break;
+		}
+		case TRACE_END_FRAME:
+		{
+			pBackend->EndFrame();
+			break;
+		}
+		case TRACE_SET_PIPELINE_STATE:
+		{
+			uint8_t flags[2] = { 0, 0 };
+			ReadValue(reader, flags, sizeof(flags));
+			PIPELINE_STATE state;
+			state.bDepthTest = (0 != flags[0]);
+			state.blendMode = (flags[1] < BLEND_MODE_COUNT) ? static_cast<BLEND_MODE>(flags[1]) : BLEND_NONE;
+			pBackend->SetPipelineState(state);
+			break;
+		}
+		case TRACE_CREATE_RENDER_TARGET:
+		{
+			uint32_t recorded = ReadUint32(reader);
+			int width = static_cast<int>(ReadUint32(reader));
+			int height = static_cast<int>(ReadUint32(reader));
+			uint8_t flags[3] = { 0, 0, 1 };
+			ReadValue(reader, flags, sizeof(flags));
+			uint32_t earlier = MapHandle(m_renderTargets, recorded);
+			if (0 != earlier)
+			{
+				DestroyRenderTarget(pBackend, earlier);
+			}
+			m_renderTargets[recorded] = pBackend->CreateRenderTarget(
+				width, height, static_cast<RENDER_TARGET_FORMAT>(flags[0]), 0 != flags[1], flags[2]);
+			break;
+		}
+		case TRACE_GET_RENDER_TARGET_TEXTURE:
+		{
+			uint32_t target = MapHandle(m_renderTargets, ReadUint32(reader));
+			uint32_t recorded = ReadUint32(reader);
+			m_targetTextures[recorded] = pBackend->GetRenderTargetTexture(target);
+			break;
+		}
+		case TRACE_GET_RENDER_TARGET_DEPTH_TEXTURE:
+		{
+			uint32_t target = MapHandle(m_renderTargets, ReadUint32(reader));
+			uint32_t recorded = ReadUint32(reader);
+			m_targetTextures[recorded] = pBackend->GetRenderTargetDepthTexture(target);
+			break;
+		}
+		case TRACE_SET_RENDER_TARGET:
+		{
+			pBackend->SetRenderTarget(MapHandle(m_renderTargets, ReadUint32(reader)));
+			break;
+		}
+		case TRACE_DESTROY_RENDER_TARGET:
+		{
+			uint32_t recorded = ReadUint32(reader);
+			uint32_t target = MapHandle(m_renderTargets, recorded);
+			if (0 != target)
+			{
+				DestroyRenderTarget(pBackend, target);
+				m_renderTargets.erase(recorded);
+			}
+			break;
+		}
+		case TRACE_CLEAR:
+		{
+			glm::vec4 color;
+			ReadValue(reader, &color, sizeof(color));
+			pBackend->Clear(color);
+			break;
+		}
+		case TRACE_DRAW_INDEXED:
+		{
+			uint32_t layout = MapHandle(m_layouts, ReadUint32(reader));
+			uint32_t indexCount = ReadUint32(reader);
+			uint32_t firstIndex = ReadUint32(reader);
+			int32_t baseVertex = 0;
+			ReadValue(reader, &baseVertex, sizeof(baseVertex));
+			pBackend->DrawIndexed(layout, indexCount, firstIndex, baseVertex);
+			break;
+		}
+		case TRACE_DRAW_INDEXED_INDIRECT:
+		{
+			uint32_t layout = MapHandle(m_layouts, ReadUint32(reader));
+			uint32_t commandCount = ReadUint32(reader);
+			size_t commandBytes = commandCount * sizeof(DRAW_ELEMENTS_INDIRECT_COMMAND);
+			const unsigned char* pCommands = ReadBytes(reader, commandBytes);
+			if (NULL == pCommands)
+			{
+				break;
+			}
+			m_indirectCommands.resize(commandCount);
+			memcpy(m_indirectCommands.data(), pCommands, commandBytes);
+			pBackend->DrawIndexedIndirect(layout, m_indirectCommands.data(), commandCount);
+			break;
+		}
+		default:
+			reader.bFailed = true;
+			break;
+		}
+	}
+
+	if (reader.bFailed)
+	{
+		std::cout << "Damaged command trace at byte " << reader.position << std::endl;
+		return(false);
+	}
+	if (bSetup)
+	{
+		// a trace with no frames is all setup
+		m_frameStart = m_commands.size();
+	}
+	return(true);
+}
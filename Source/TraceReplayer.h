@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// tracereplayer.h
+// ============
+// replay a recorded stream of rendering commands on a backend
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CommandTrace.h"
+#include "RenderBackend.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  TraceReplayer
+ *
+ *  This class loads a trace written by the recording
+ *  backend and issues its commands again on any backend,
+ *  with no scene behind them.  Prepare() runs the setup
+ *  once, ReplayFrames() runs every recorded frame and can
+ *  be called in a loop, so timing it measures the driver
+ *  and the GPU with a fixed workload.  The recorded object
+ *  handles are mapped onto the ones the backend returns;
+ *  an object a frame creates again replaces the earlier
+ *  one, so looping never leaks.
+ ***********************************************************/
+class TraceReplayer
+{
+public:
+	// constructor
+	TraceReplayer();
+	// destructor
+	~TraceReplayer();
+
+	// read a trace file - returns false when it is missing
+	// or is not a trace
+	bool LoadTrace(const char* filename);
+	size_t GetFrameCount() const;
+
+	// run the setup commands on a backend
+	bool Prepare(RenderBackend* pBackend);
+	// run every recorded frame once
+	bool ReplayFrames(RenderBackend* pBackend);
+	// destroy the objects the replay created
+	void Release(RenderBackend* pBackend);
+
+private:
+	// commands without the header
+	std::vector<unsigned char> m_commands;
+	// where the first frame starts, found by Prepare()
+	size_t m_frameStart;
+	size_t m_frameCount;
+
+	// uniform names by id
+	std::vector<std::string> m_names;
+	// recorded handles to the replayed ones
+	std::unordered_map<uint32_t, uint32_t> m_buffers;
+	std::unordered_map<uint32_t, uint32_t> m_layouts;
+	std::unordered_map<uint32_t, uint32_t> m_textures;
+	std::unordered_map<uint32_t, uint32_t> m_programs;
+	std::unordered_map<uint32_t, uint32_t> m_renderTargets;
+	// textures owned by the render targets
+	std::unordered_map<uint32_t, uint32_t> m_targetTextures;
+	// scratch space for aligned copies of trace data
+	std::vector<VERTEX_ATTRIBUTE> m_attributes;
+	std::vector<DRAW_ELEMENTS_INDIRECT_COMMAND> m_indirectCommands;
+
+	// run the commands from an offset to the end, or for the
+	// setup up to the first frame
+	bool Execute(RenderBackend* pBackend, size_t begin, bool bSetup);
+	// destroy a replayed render target and forget its texture
+	void DestroyRenderTarget(RenderBackend* pBackend, uint32_t target);
+};
@@ -0,0 +1,260 @@
+///////////////////////////////////////////////////////////////////////////////
+// tracedscene.cpp
+// ============
+// the scene's draws placed in ray tracing hierarchies for the CPU tracers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TracedScene.h"
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of the global variables and helpers
+namespace
+{
+	// distance that rays leaving a surface start off it,
+	// relative to the size of the coordinates, so a surface
+	// does not hit itself
+	const float g_SurfaceBias = 1.0e-4f;
+
+	/***********************************************************
+	 *  IsFlattening()
+	 *
+	 *  True when a transformation squashes at least one axis
+	 *  to almost nothing, like the scene's screen planes with
+	 *  a height of zero, so it has no usable inverse.
+	 ***********************************************************/
+	bool IsFlattening(const glm::mat4& model)
+	{
+		glm::mat3 linear = glm::mat3(model);
+		float determinant = glm::dot(linear[0], glm::cross(linear[1], linear[2]));
+		float volume = glm::length(linear[0]) * glm::length(linear[1]) * glm::length(linear[2]);
+		return(std::fabs(determinant) <= volume * 1.0e-6f);
+	}
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for building the hierarchies of the
+ *  meshes seen for the first time, in parallel, and then
+ *  the hierarchy over the passed draws.
+ ***********************************************************/
+void TracedScene::Build(const std::vector<SOFTWARE_DRAW>& draws, ThreadPool* pThreadPool)
+{
+	std::vector<MeshBVH*> buildTargets;
+	std::vector<const MESH_DATA*> buildMeshes;
+	std::vector<glm::mat4> buildTransforms;
+
+	// draws without triangles are left out
+	std::vector<char> drawKinds(draws.size(), 0);
+	size_t flattenedCount = 0;
+	for (size_t i = 0; i < draws.size(); i++)
+	{
+		if ((NULL != draws[i].pMesh) && !draws[i].pMesh->indices.empty())
+		{
+			drawKinds[i] = IsFlattening(draws[i].model) ? 2 : 1;
+			flattenedCount += (drawKinds[i] == 2) ? 1 : 0;
+		}
+	}
+	m_worldBVHs.resize(flattenedCount);
+
+	std::vector<MeshBVH*> drawBVHs(draws.size(), NULL);
+	size_t flattenedIndex = 0;
+	for (size_t i = 0; i < draws.size(); i++)
+	{
+		const SOFTWARE_DRAW& draw = draws[i];
+		if (drawKinds[i] == 0)
+		{
+			continue;
+		}
+
+		if (drawKinds[i] == 2)
+		{
+			drawBVHs[i] = &m_worldBVHs[flattenedIndex++];
+			buildTargets.push_back(drawBVHs[i]);
+			buildMeshes.push_back(draw.pMesh);
+			buildTransforms.push_back(draw.model);
+			continue;
+		}
+
+		std::map<const MESH_DATA*, MeshBVH>::iterator cached = m_meshBVHs.find(draw.pMesh);
+		if (cached == m_meshBVHs.end())
+		{
+			cached = m_meshBVHs.insert(std::make_pair(draw.pMesh, MeshBVH())).first;
+			buildTargets.push_back(&cached->second);
+			buildMeshes.push_back(draw.pMesh);
+			buildTransforms.push_back(glm::mat4(1.0f));
+		}
+		drawBVHs[i] = &cached->second;
+	}
+
+	pThreadPool->ParallelFor(
+		buildTargets.size(),
+		1,
+		[&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			buildTargets[i]->Build(*buildMeshes[i], buildTransforms[i]);
+		}
+	});
+
+	m_instances.clear();
+	m_instanceDraws.clear();
+	m_normalMatrices.clear();
+	for (size_t i = 0; i < draws.size(); i++)
+	{
+		if ((NULL == drawBVHs[i]) || drawBVHs[i]->IsEmpty())
+		{
+			continue;
+		}
+
+		BVH_INSTANCE instance;
+		instance.pBVH = drawBVHs[i];
+		if (drawKinds[i] == 2)
+		{
+			instance.worldToMesh = glm::mat4(1.0f);
+			instance.boundsMin = drawBVHs[i]->GetBoundsMin();
+			instance.boundsMax = drawBVHs[i]->GetBoundsMax();
+		}
+		else
+		{
+			instance.worldToMesh = glm::inverse(draws[i].model);
+			TransformBounds(
+				draws[i].model,
+				drawBVHs[i]->GetBoundsMin(),
+				drawBVHs[i]->GetBoundsMax(),
+				instance.boundsMin,
+				instance.boundsMax);
+		}
+
+		m_instances.push_back(instance);
+		m_instanceDraws.push_back(i);
+		m_normalMatrices.push_back(ComputeNormalMatrix(draws[i].model));
+	}
+
+	m_sceneBVH.Build(m_instances);
+}
+
+/***********************************************************
+ *  ClearMeshCache()
+ *
+ *  This method is used for dropping the mesh hierarchies so
+ *  they are rebuilt from the current mesh data.
+ ***********************************************************/
+void TracedScene::ClearMeshCache()
+{
+	m_meshBVHs.clear();
+	m_worldBVHs.clear();
+	m_instances.clear();
+	m_instanceDraws.clear();
+	m_normalMatrices.clear();
+	m_sceneBVH.Build(m_instances);
+}
+
+/***********************************************************
+ *  GetBVH()
+ *
+ *  This method is used for getting the hierarchy over the
+ *  placed meshes, to cast rays against.
+ ***********************************************************/
+const SceneBVH& TracedScene::GetBVH() const
+{
+	return(m_sceneBVH);
+}
+
+/***********************************************************
+ *  GetSurfacePoint()
+ *
+ *  This method is used for interpolating the vertices of
+ *  the triangle a ray hit, the way the vertex shader
+ *  passes them on to the fragment shader.
+ ***********************************************************/
+void TracedScene::GetSurfacePoint(
+	const BVH_RAY& ray,
+	const std::vector<SOFTWARE_DRAW>& draws,
+	SURFACE_POINT& point) const
+{
+	const SOFTWARE_DRAW& draw = draws[m_instanceDraws[ray.instance]];
+	const MESH_DATA& mesh = *draw.pMesh;
+	const MESH_VERTEX& a = mesh.vertices[mesh.indices[ray.triangle * 3]];
+	const MESH_VERTEX& b = mesh.vertices[mesh.indices[ray.triangle * 3 + 1]];
+	const MESH_VERTEX& c = mesh.vertices[mesh.indices[ray.triangle * 3 + 2]];
+	float w = 1.0f - ray.u - ray.v;
+
+	point.pDraw = &draw;
+	point.position = ray.origin + ray.direction * ray.t;
+	point.normal = m_normalMatrices[ray.instance] * (a.normal * w + b.normal * ray.u + c.normal * ray.v);
+	point.texCoord = a.texCoord * w + b.texCoord * ray.u + c.texCoord * ray.v;
+}
+
+/***********************************************************
+ *  IsPointVisible()
+ *
+ *  This method is used for checking if nothing lies between
+ *  a surface point and another point, such as a light.
+ ***********************************************************/
+bool TracedScene::IsPointVisible(
+	const glm::vec3& position,
+	const glm::vec3& normal,
+	const glm::vec3& target) const
+{
+	BVH_RAY ray;
+	ray.origin = OffsetFromSurface(position, normal, target - position);
+	ray.direction = target - ray.origin;
+	ray.t = 1.0f;
+	return(!m_sceneBVH.IsOccluded(ray));
+}
+
+/***********************************************************
+ *  OffsetFromSurface()
+ *
+ *  This function is used for moving the start of a ray that
+ *  leaves a surface a little off it, on the side the ray
+ *  goes to.
+ ***********************************************************/
+glm::vec3 OffsetFromSurface(
+	const glm::vec3& position,
+	const glm::vec3& normal,
+	const glm::vec3& direction)
+{
+	float normalLength = glm::length(normal);
+	if (normalLength <= 0.0f)
+	{
+		return(position);
+	}
+
+	float scale = std::max(
+		std::max(std::fabs(position.x), std::fabs(position.y)),
+		std::max(std::fabs(position.z), 1.0f));
+	float side = (glm::dot(normal, direction) >= 0.0f) ? 1.0f : -1.0f;
+	return(position + normal * (side * g_SurfaceBias * scale / normalLength));
+}
+
+/***********************************************************
+ *  GetCameraRay()
+ *
+ *  This function is used for finding the ray through a
+ *  point of the screen, measured in pixels from the top
+ *  left corner.  The ray starts on the near plane and
+ *  reaches the far plane at a distance of one, so the same
+ *  objects are clipped away as in the rasterizers.
+ ***********************************************************/
+void GetCameraRay(
+	const glm::mat4& inverseViewProjection,
+	int width,
+	int height,
+	float x,
+	float y,
+	glm::vec3& origin,
+	glm::vec3& direction)
+{
+	float ndcX = 2.0f * x / width - 1.0f;
+	float ndcY = 1.0f - 2.0f * y / height;
+	glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+	glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+	origin = glm::vec3(nearPoint) / nearPoint.w;
+	direction = glm::vec3(farPoint) / farPoint.w - origin;
+}
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// tracedscene.h
+// ============
+// the scene's draws placed in ray tracing hierarchies for the CPU tracers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshBVH.h"
+#include "ShadingModel.h"
+#include "SoftwareRasterizer.h"
+#include "ThreadPool.h"
+
+#include <glm/glm.hpp>
+
+#include <map>
+#include <vector>
+
+/***********************************************************
+ *  SURFACE_POINT
+ *
+ *  The interpolated vertex data where a ray hit a draw.
+ ***********************************************************/
+struct SURFACE_POINT
+{
+	const SOFTWARE_DRAW* pDraw;
+	glm::vec3 position;
+	// world space normal, not normalized
+	glm::vec3 normal;
+	glm::vec2 texCoord;
+};
+
+/***********************************************************
+ *  TracedScene
+ *
+ *  This class places the draws of a frame in a hierarchy
+ *  the CPU tracers cast rays against.  Each mesh gets a
+ *  hierarchy that is kept between frames, and the small
+ *  hierarchy over the placed meshes is rebuilt per frame.
+ ***********************************************************/
+class TracedScene
+{
+public:
+	// place the draws, building the missing mesh hierarchies
+	// on the worker threads - the meshes must not change while
+	// their hierarchies are cached
+	void Build(const std::vector<SOFTWARE_DRAW>& draws, ThreadPool* pThreadPool);
+	// forget the cached mesh hierarchies, needed before a
+	// drawn mesh is changed or freed
+	void ClearMeshCache();
+
+	const SceneBVH& GetBVH() const;
+	// vertex data where a ray hit, for the draws passed to Build()
+	void GetSurfacePoint(
+		const BVH_RAY& ray,
+		const std::vector<SOFTWARE_DRAW>& draws,
+		SURFACE_POINT& point) const;
+	// true when nothing lies between a surface point and the
+	// target point
+	bool IsPointVisible(
+		const glm::vec3& position,
+		const glm::vec3& normal,
+		const glm::vec3& target) const;
+
+private:
+	// hierarchies of the meshes drawn so far, in mesh space
+	std::map<const MESH_DATA*, MeshBVH> m_meshBVHs;
+	// world space hierarchies of the draws whose transform
+	// flattens them and so cannot be inverted
+	std::vector<MeshBVH> m_worldBVHs;
+
+	// the placed meshes, with the draw and the normal matrix
+	// of each
+	std::vector<BVH_INSTANCE> m_instances;
+	std::vector<size_t> m_instanceDraws;
+	std::vector<glm::mat3> m_normalMatrices;
+	SceneBVH m_sceneBVH;
+};
+
+// start of a ray leaving a surface in the passed direction,
+// moved off the surface so the ray does not hit it again
+glm::vec3 OffsetFromSurface(
+	const glm::vec3& position,
+	const glm::vec3& normal,
+	const glm::vec3& direction);
+
+// ray from the near to the far plane through a point of the
+// screen, in pixels from the top left corner
+void GetCameraRay(
+	const glm::mat4& inverseViewProjection,
+	int width,
+	int height,
+	float x,
+	float y,
+	glm::vec3& origin,
+	glm::vec3& direction);
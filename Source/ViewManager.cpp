@@ -1,325 +1,599 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "ViewManager.h"
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>    
-
-// declaration of the global variables and defines
-namespace
-{
-	// Variables for window width and height
-	const int WINDOW_WIDTH = 1000;
-	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
-
-	// camera object used for viewing and interacting with
-	// the 3D scene
-	Camera* g_pCamera = nullptr;
-
-	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
-	bool gFirstMouse = true;
-
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f; 
-	float gLastFrame = 0.0f;
-
-	// the following variable is false when orthographic projection
-	// is off and true when it is on
-	bool perspectiveProjection = false;
-
-	float yaw = -90.0f;
-	float pitch = 0.0f;
-}
-
-/***********************************************************
- *  ViewManager()
- *
- *  The constructor for the class
- ***********************************************************/
-ViewManager::ViewManager(
-	ShaderManager *pShaderManager)
-{
-	// initialize the member variables
-	m_pShaderManager = pShaderManager;
-	m_pWindow = NULL;
-	g_pCamera = new Camera();
-	// default camera view parameters
-	g_pCamera->Position = glm::vec3(0.0f, 3.3f, 12.0f);
-	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	g_pCamera->Zoom = 80;
-	// Initialize the projection mode to perspective by default
-	perspectiveProjection = true;
-}
-
-/***********************************************************
- *  ~ViewManager()
- *
- *  The destructor for the class
- ***********************************************************/
-ViewManager::~ViewManager()
-{
-	// free up allocated memory
-	m_pShaderManager = NULL;
-	m_pWindow = NULL;
-	if (NULL != g_pCamera)
-	{
-		delete g_pCamera;
-		g_pCamera = NULL;
-	}
-}
-
-/***********************************************************
- *  CreateDisplayWindow()
- *
- *  This method is used to create the main display window.
- ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
-{
-	GLFWwindow* window = nullptr;
-
-	// try to create the displayed OpenGL window
-	window = glfwCreateWindow(
-		WINDOW_WIDTH,
-		WINDOW_HEIGHT,
-		windowTitle,
-		NULL, NULL);
-	if (window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return NULL;
-	}
-	glfwMakeContextCurrent(window);
-
-	// Set the user pointer to the current ViewManager instance
-	glfwSetWindowUserPointer(window, this);
-
-	//Make glfw monitor scrollwheel. 
-	glfwSetScrollCallback(window, scroll_callback);
-
-	// tell GLFW to capture all mouse events
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-	// this callback is used to receive mouse moving events when in perspective mode. 
-	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
-
-	// enable blending for supporting tranparent rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	m_pWindow = window;
-
-	return(window);
-}
-
-/***********************************************************
- *  Mouse_Position_Callback()
- *
- *  This method is automatically called from GLFW whenever
- *  the mouse is moved within the active GLFW display window.
- ***********************************************************/
-void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xpos, double ypos)
-{
-	// Retrieve the ViewManager instance to access non static variable perspectiveProjection.
-	ViewManager* viewManager = static_cast<ViewManager*>(glfwGetWindowUserPointer(window));
-
-	// If perspectiveProjection is true, ignore mouse input.
-	if (!viewManager->perspectiveProjection)
-	{
-		return;
-	}
-
-	//Make the screen not start tweaking upon loading into scene. 
-	if (gFirstMouse)
-	{
-		gLastX = xpos;
-		gLastY = ypos;
-		gFirstMouse = false;
-	}
-
-	//Calculate offsets. 
-	float xoffset = xpos - gLastX;
-	float yoffset = gLastY - ypos;
-	gLastX = xpos;
-	gLastY = ypos;
-
-	//Determine how far user looks to the side. 
-	float sensitivity = 0.1f;
-	xoffset *= sensitivity;
-	yoffset *= sensitivity;
-
-	//Set pitch and yaw.
-	yaw += xoffset;
-	pitch += yoffset;
-
-	//Stops the user from flipping his screen upside down. 
-	if (pitch > 89.0f)
-		pitch = 89.0f;
-	if (pitch < -89.0f)
-		pitch = -89.0f;
-
-	//Determine camera position. 
-	glm::vec3 direction;
-	direction.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
-	direction.y = sin(glm::radians(pitch));
-	direction.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
-	g_pCamera->Front = glm::normalize(direction);
-}
-
-/***********************************************************
- *  scroll_callback()
- *
- *  This method increases or decreases the speed of camera movement.
- ***********************************************************/
-void ViewManager::scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
-{
-	if (g_pCamera != nullptr)
-	{
-		// Adjust MovementSpeed based on scroll input
-		g_pCamera->MovementSpeed += static_cast<float>(yoffset) * 0.1f;
-
-		// Clamp MovementSpeed to prevent it from becoming negative or too fast
-		if (g_pCamera->MovementSpeed < 0.1f)
-			g_pCamera->MovementSpeed = 0.1f;
-		if (g_pCamera->MovementSpeed > 20.0f)
-			g_pCamera->MovementSpeed = 10.0f;
-	}
-}
-
-/***********************************************************
- *  ProcessKeyboardEvents()
- *
- *  This method is called to process any keyboard events
- *  that may be waiting in the event queue.
- ***********************************************************/
-void ViewManager::ProcessKeyboardEvents()
-{
-	// close the window if the escape key has been pressed
-	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(m_pWindow, true);
-	}
-
-	// if the camera object is null, then exit this method
-	if (NULL == g_pCamera)
-	{
-		return;
-	}
-
-	// Check if the user toggled perspective or orthographic view
-	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-	{
-		perspectiveProjection = true; // Switch to perspective
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
-	{
-		perspectiveProjection = false; // Switch to orthographic
-	}
-
-	//Allows movement only in perspective mode. 
-	if (perspectiveProjection) {
-		//Determines the speed at which the camera travels around the scene. 
-		float cameraSpeed = g_pCamera->MovementSpeed * gDeltaTime;
-
-		// process camera zooming in and out
-		if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-		{
-			g_pCamera->Position += cameraSpeed * g_pCamera->Front;
-		}
-		if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-		{
-			g_pCamera->Position -= cameraSpeed * g_pCamera->Front;
-		}
-
-		// process camera panning left and right
-		if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-		{
-			g_pCamera->Position -= glm::normalize(glm::cross(g_pCamera->Front, g_pCamera->Up)) * cameraSpeed;
-		}
-		if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-		{
-			g_pCamera->Position += glm::normalize(glm::cross(g_pCamera->Front, g_pCamera->Up)) * cameraSpeed;
-		}
-
-		// process camera upward motion (Q key)
-		if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-		{
-			g_pCamera->Position += cameraSpeed * g_pCamera->Up;
-		}
-
-		// process camera downward motion (E key)
-		if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-		{
-			g_pCamera->Position -= cameraSpeed * g_pCamera->Up;
-		}
-	}
-}
-
-/***********************************************************
- *  PrepareSceneView()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void ViewManager::PrepareSceneView()
-{
-	glm::mat4 view;
-	glm::mat4 projection;
-
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
-
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
-
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
-	// Switch between perspective and orthographic projection
-	if (!perspectiveProjection)
-	{
-		// Perspective projection setup
-		projection = glm::perspective(
-			glm::radians(45.0f), // Field of view
-			(float)WINDOW_WIDTH / (float)WINDOW_HEIGHT, // Aspect ratio
-			0.1f, 100.0f         // Near, far
-		);
-
-		// Reset camera for perspective view
-		g_pCamera->Position = glm::vec3(0.0f, 5.0f, 14.0f);
-		g_pCamera->Front = glm::vec3(0.0f, -0.2f, -1.0f);
-		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	}
-
-	// define the current projection matrix
-	projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
-
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
-	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
-	}
-}
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ViewManager.h"
+#include "TracedScene.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>    
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of the global variables and defines
+namespace
+{
+	// Variables for window width and height
+	const int WINDOW_WIDTH = 1000;
+	const int WINDOW_HEIGHT = 800;
+	const char* g_ViewName = "view";
+	const char* g_ProjectionName = "projection";
+
+	// camera object used for viewing and interacting with
+	// the 3D scene
+	Camera* g_pCamera = nullptr;
+
+	// these variables are used for mouse movement processing
+	float gLastX = WINDOW_WIDTH / 2.0f;
+	float gLastY = WINDOW_HEIGHT / 2.0f;
+	bool gFirstMouse = true;
+
+	// time between current frame and last frame
+	float gDeltaTime = 0.0f; 
+	float gLastFrame = 0.0f;
+
+	// the following variable is false when orthographic projection
+	// is off and true when it is on
+	bool perspectiveProjection = false;
+
+	float yaw = -90.0f;
+	float pitch = 0.0f;
+
+	// size of the sphere kept out of the scene objects, larger
+	// than the distance to the near plane so they are not cut
+	// open
+	const float g_CameraRadius = 0.2f;
+}
+
+/***********************************************************
+ *  ViewManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ViewManager::ViewManager(
+	RenderBackend* pBackend)
+{
+	// initialize the member variables
+	m_pBackend = pBackend;
+	m_pWindow = NULL;
+	m_bShowPerformanceHUD = false;
+	m_bHUDKeyDown = false;
+	m_debugView = DEBUG_VIEW_NONE;
+	m_bDebugViewKeyDown = false;
+	m_antiAliasing = ANTI_ALIASING_NONE;
+	m_bAntiAliasingKeyDown = false;
+	m_jitterFrame = 0;
+	m_bReprojection = false;
+	m_bReprojectionKeyDown = false;
+	m_bAmbientOcclusion = true;
+	m_bAmbientOcclusionKeyDown = false;
+	m_bPickRequested = false;
+	m_bPickButtonDown = false;
+	m_pCollision = NULL;
+	g_pCamera = new Camera();
+	// default camera view parameters
+	g_pCamera->Position = glm::vec3(0.0f, 3.3f, 12.0f);
+	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 80;
+	// Initialize the projection mode to perspective by default
+	perspectiveProjection = true;
+}
+
+/***********************************************************
+ *  ~ViewManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ViewManager::~ViewManager()
+{
+	// free up allocated memory
+	m_pBackend = NULL;
+	m_pWindow = NULL;
+	if (NULL != g_pCamera)
+	{
+		delete g_pCamera;
+		g_pCamera = NULL;
+	}
+}
+
+/***********************************************************
+ *  CreateDisplayWindow()
+ *
+ *  This method is used to create the main display window.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
+{
+	GLFWwindow* window = nullptr;
+
+	// try to create the displayed OpenGL window
+	window = glfwCreateWindow(
+		WINDOW_WIDTH,
+		WINDOW_HEIGHT,
+		windowTitle,
+		NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// Set the user pointer to the current ViewManager instance
+	glfwSetWindowUserPointer(window, this);
+
+	//Make glfw monitor scrollwheel. 
+	glfwSetScrollCallback(window, scroll_callback);
+
+	// tell GLFW to capture all mouse events
+	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+	// this callback is used to receive mouse moving events when in perspective mode. 
+	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+/***********************************************************
+ *  Mouse_Position_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the mouse is moved within the active GLFW display window.
+ ***********************************************************/
+void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xpos, double ypos)
+{
+	// Retrieve the ViewManager instance to access non static variable perspectiveProjection.
+	ViewManager* viewManager = static_cast<ViewManager*>(glfwGetWindowUserPointer(window));
+
+	// If perspectiveProjection is true, ignore mouse input.
+	if (!viewManager->perspectiveProjection)
+	{
+		return;
+	}
+
+	//Make the screen not start tweaking upon loading into scene. 
+	if (gFirstMouse)
+	{
+		gLastX = xpos;
+		gLastY = ypos;
+		gFirstMouse = false;
+	}
+
+	//Calculate offsets. 
+	float xoffset = xpos - gLastX;
+	float yoffset = gLastY - ypos;
+	gLastX = xpos;
+	gLastY = ypos;
+
+	//Determine how far user looks to the side. 
+	float sensitivity = 0.1f;
+	xoffset *= sensitivity;
+	yoffset *= sensitivity;
+
+	//Set pitch and yaw.
+	yaw += xoffset;
+	pitch += yoffset;
+
+	//Stops the user from flipping his screen upside down. 
+	if (pitch > 89.0f)
+		pitch = 89.0f;
+	if (pitch < -89.0f)
+		pitch = -89.0f;
+
+	//Determine camera position. 
+	glm::vec3 direction;
+	direction.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+	direction.y = sin(glm::radians(pitch));
+	direction.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+	g_pCamera->Front = glm::normalize(direction);
+}
+
+/***********************************************************
+ *  scroll_callback()
+ *
+ *  This method increases or decreases the speed of camera movement.
+ ***********************************************************/
+void ViewManager::scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+	if (g_pCamera != nullptr)
+	{
+		// Adjust MovementSpeed based on scroll input
+		g_pCamera->MovementSpeed += static_cast<float>(yoffset) * 0.1f;
+
+		// Clamp MovementSpeed to prevent it from becoming negative or too fast
+		if (g_pCamera->MovementSpeed < 0.1f)
+			g_pCamera->MovementSpeed = 0.1f;
+		if (g_pCamera->MovementSpeed > 20.0f)
+			g_pCamera->MovementSpeed = 10.0f;
+	}
+}
+
+/***********************************************************
+ *  ProcessKeyboardEvents()
+ *
+ *  This method is called to process any keyboard events
+ *  that may be waiting in the event queue.
+ ***********************************************************/
+void ViewManager::ProcessKeyboardEvents()
+{
+	// close the window if the escape key has been pressed
+	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	{
+		glfwSetWindowShouldClose(m_pWindow, true);
+	}
+
+	// toggle the performance overlay when F1 goes down
+	bool bHUDKeyDown = (glfwGetKey(m_pWindow, GLFW_KEY_F1) == GLFW_PRESS);
+	if (bHUDKeyDown && !m_bHUDKeyDown)
+	{
+		m_bShowPerformanceHUD = !m_bShowPerformanceHUD;
+	}
+	m_bHUDKeyDown = bHUDKeyDown;
+
+	// step through the debug views when F2 goes down
+	bool bDebugViewKeyDown = (glfwGetKey(m_pWindow, GLFW_KEY_F2) == GLFW_PRESS);
+	if (bDebugViewKeyDown && !m_bDebugViewKeyDown)
+	{
+		m_debugView = static_cast<DEBUG_VIEW>((m_debugView + 1) % DEBUG_VIEW_COUNT);
+		std::cout << "Debug view: " << GetDebugViewName(m_debugView) << std::endl;
+	}
+	m_bDebugViewKeyDown = bDebugViewKeyDown;
+
+	// step through the anti-aliasing modes when F3 goes down
+	bool bAntiAliasingKeyDown = (glfwGetKey(m_pWindow, GLFW_KEY_F3) == GLFW_PRESS);
+	if (bAntiAliasingKeyDown && !m_bAntiAliasingKeyDown)
+	{
+		m_antiAliasing = static_cast<ANTI_ALIASING>((m_antiAliasing + 1) % ANTI_ALIASING_COUNT);
+		std::cout << "Anti-aliasing: " << GetAntiAliasingName(m_antiAliasing) << std::endl;
+	}
+	m_bAntiAliasingKeyDown = bAntiAliasingKeyDown;
+
+	// toggle the scene reprojection when F4 goes down
+	bool bReprojectionKeyDown = (glfwGetKey(m_pWindow, GLFW_KEY_F4) == GLFW_PRESS);
+	if (bReprojectionKeyDown && !m_bReprojectionKeyDown)
+	{
+		m_bReprojection = !m_bReprojection;
+		std::cout << "Reprojection: " << (m_bReprojection ? "on" : "off") << std::endl;
+	}
+	m_bReprojectionKeyDown = bReprojectionKeyDown;
+
+	// toggle the ambient occlusion when F5 goes down
+	bool bAmbientOcclusionKeyDown = (glfwGetKey(m_pWindow, GLFW_KEY_F5) == GLFW_PRESS);
+	if (bAmbientOcclusionKeyDown && !m_bAmbientOcclusionKeyDown)
+	{
+		m_bAmbientOcclusion = !m_bAmbientOcclusion;
+		std::cout << "Ambient occlusion: " << (m_bAmbientOcclusion ? "on" : "off") << std::endl;
+	}
+	m_bAmbientOcclusionKeyDown = bAmbientOcclusionKeyDown;
+
+	// pick the object under the cursor when the left mouse
+	// button goes down
+	bool bPickButtonDown = (glfwGetMouseButton(m_pWindow, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS);
+	if (bPickButtonDown && !m_bPickButtonDown)
+	{
+		m_bPickRequested = true;
+	}
+	m_bPickButtonDown = bPickButtonDown;
+
+	// if the camera object is null, then exit this method
+	if (NULL == g_pCamera)
+	{
+		return;
+	}
+
+	// Check if the user toggled perspective or orthographic view
+	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
+	{
+		perspectiveProjection = true; // Switch to perspective
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
+	{
+		perspectiveProjection = false; // Switch to orthographic
+	}
+
+	//Allows movement only in perspective mode. 
+	if (perspectiveProjection) {
+		//Determines the speed at which the camera travels around the scene. 
+		float cameraSpeed = g_pCamera->MovementSpeed * gDeltaTime;
+		glm::vec3 previousPosition = g_pCamera->Position;
+
+		// process camera zooming in and out
+		if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
+		{
+			g_pCamera->Position += cameraSpeed * g_pCamera->Front;
+		}
+		if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
+		{
+			g_pCamera->Position -= cameraSpeed * g_pCamera->Front;
+		}
+
+		// process camera panning left and right
+		if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
+		{
+			g_pCamera->Position -= glm::normalize(glm::cross(g_pCamera->Front, g_pCamera->Up)) * cameraSpeed;
+		}
+		if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
+		{
+			g_pCamera->Position += glm::normalize(glm::cross(g_pCamera->Front, g_pCamera->Up)) * cameraSpeed;
+		}
+
+		// process camera upward motion (Q key)
+		if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
+		{
+			g_pCamera->Position += cameraSpeed * g_pCamera->Up;
+		}
+
+		// process camera downward motion (E key)
+		if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
+		{
+			g_pCamera->Position -= cameraSpeed * g_pCamera->Up;
+		}
+
+		// slide along the objects in the way instead of passing
+		// through them
+		if (NULL != m_pCollision)
+		{
+			g_pCamera->Position = m_pCollision->MoveSphere(previousPosition, g_pCamera->Position, g_CameraRadius);
+		}
+	}
+}
+
+/***********************************************************
+ *  PrepareSceneView()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void ViewManager::PrepareSceneView()
+{
+	// per-frame timing
+	float currentFrame = glfwGetTime();
+	gDeltaTime = currentFrame - gLastFrame;
+	gLastFrame = currentFrame;
+
+	// process any keyboard events that may be waiting in the 
+	// event queue
+	ProcessKeyboardEvents();
+
+	UpdateCameraMatrices();
+}
+
+/***********************************************************
+ *  UpdateCameraMatrices()
+ *
+ *  This method is used for computing the view and
+ *  projection matrices from the camera and setting them
+ *  into the shader.  It needs no window, so it can run
+ *  headless.
+ ***********************************************************/
+void ViewManager::UpdateCameraMatrices()
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+
+	// get the current view matrix from the camera
+	view = g_pCamera->GetViewMatrix();
+
+	// Switch between perspective and orthographic projection
+	if (!perspectiveProjection)
+	{
+		// Perspective projection setup
+		projection = glm::perspective(
+			glm::radians(45.0f), // Field of view
+			(float)WINDOW_WIDTH / (float)WINDOW_HEIGHT, // Aspect ratio
+			0.1f, 100.0f         // Near, far
+		);
+
+		// Reset camera for perspective view
+		g_pCamera->Position = glm::vec3(0.0f, 5.0f, 14.0f);
+		g_pCamera->Front = glm::vec3(0.0f, -0.2f, -1.0f);
+		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	}
+
+	// define the current projection matrix
+	projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
+
+	// temporal anti-aliasing moves the projection by part of
+	// a pixel each frame, so the frames it blends sample the
+	// pixels at different places; shifting the third column
+	// shifts every point by the same amount after the divide
+	if (ANTI_ALIASING_TAA == m_antiAliasing)
+	{
+		int frameWidth = WINDOW_WIDTH;
+		int frameHeight = WINDOW_HEIGHT;
+		if (NULL != m_pWindow)
+		{
+			glfwGetFramebufferSize(m_pWindow, &frameWidth, &frameHeight);
+		}
+		glm::vec2 jitter = GetTemporalJitter(m_jitterFrame++);
+		projection[2][0] += 2.0f * jitter.x / static_cast<float>(std::max(frameWidth, 1));
+		projection[2][1] += 2.0f * jitter.y / static_cast<float>(std::max(frameHeight, 1));
+	}
+
+	// keep the matrices for the systems that cull against them
+	m_viewMatrix = view;
+	m_projectionMatrix = projection;
+
+	// if the rendering backend is valid
+	if (NULL != m_pBackend)
+	{
+		// set the view matrix into the shader for proper rendering
+		m_pBackend->SetUniformMat4(g_ViewName, view);
+		// set the view matrix into the shader for proper rendering
+		m_pBackend->SetUniformMat4(g_ProjectionName, projection);
+		// set the view position of the camera into the shader for proper rendering
+		m_pBackend->SetUniformVec3("viewPosition", g_pCamera->Position);
+	}
+}
+
+/***********************************************************
+ *  GetViewMatrix()
+ *
+ *  This method returns the view matrix that was set into
+ *  the shader by the last PrepareSceneView() call.
+ ***********************************************************/
+glm::mat4 ViewManager::GetViewMatrix() const
+{
+	return(m_viewMatrix);
+}
+
+/***********************************************************
+ *  GetProjectionMatrix()
+ *
+ *  This method returns the projection matrix that was set
+ *  into the shader by the last PrepareSceneView() call.
+ ***********************************************************/
+glm::mat4 ViewManager::GetProjectionMatrix() const
+{
+	return(m_projectionMatrix);
+}
+
+/***********************************************************
+ *  GetViewPosition()
+ *
+ *  This method returns the current camera position.
+ ***********************************************************/
+glm::vec3 ViewManager::GetViewPosition() const
+{
+	return(g_pCamera->Position);
+}
+
+/***********************************************************
+ *  IsPerformanceHUDVisible()
+ *
+ *  This method is used for checking whether the performance
+ *  overlay has been turned on with the F1 key.
+ ***********************************************************/
+bool ViewManager::IsPerformanceHUDVisible() const
+{
+	return(m_bShowPerformanceHUD);
+}
+
+/***********************************************************
+ *  GetDebugView()
+ *
+ *  This method is used for getting the debug view the F2
+ *  key has stepped to, DEBUG_VIEW_NONE for the scene as
+ *  it is.
+ ***********************************************************/
+DEBUG_VIEW ViewManager::GetDebugView() const
+{
+	return(m_debugView);
+}
+
+/***********************************************************
+ *  GetAntiAliasing()
+ *
+ *  This method is used for getting the anti-aliasing mode
+ *  the F3 key has stepped to.
+ ***********************************************************/
+ANTI_ALIASING ViewManager::GetAntiAliasing() const
+{
+	return(m_antiAliasing);
+}
+
+/***********************************************************
+ *  SetAntiAliasing()
+ *
+ *  This method is used for choosing the anti-aliasing mode
+ *  without the key, as the benchmark of the modes does.
+ ***********************************************************/
+void ViewManager::SetAntiAliasing(ANTI_ALIASING mode)
+{
+	m_antiAliasing = mode;
+}
+
+/***********************************************************
+ *  IsReprojectionEnabled()
+ *
+ *  This method is used for checking whether the F4 key has
+ *  turned on the reuse of the last frame's scene pixels.
+ ***********************************************************/
+bool ViewManager::IsReprojectionEnabled() const
+{
+	return(m_bReprojection);
+}
+
+/***********************************************************
+ *  IsAmbientOcclusionEnabled()
+ *
+ *  This method is used for checking whether the scene is
+ *  darkened by ambient occlusion, on until F5 turns it off.
+ ***********************************************************/
+bool ViewManager::IsAmbientOcclusionEnabled() const
+{
+	return(m_bAmbientOcclusion);
+}
+
+/***********************************************************
+ *  TakePickRequest()
+ *
+ *  This method is used for checking whether a click is
+ *  waiting to pick an object, which it then clears.
+ ***********************************************************/
+bool ViewManager::TakePickRequest()
+{
+	bool bPickRequested = m_bPickRequested;
+	m_bPickRequested = false;
+	return(bPickRequested);
+}
+
+/***********************************************************
+ *  GetCursorRay()
+ *
+ *  This method is used for getting the ray through the
+ *  cursor with the matrices of the last PrepareSceneView()
+ *  call.  The cursor is captured while the mouse turns the
+ *  camera, and then the ray goes through the middle of the
+ *  window, where the view is aimed.
+ ***********************************************************/
+void ViewManager::GetCursorRay(glm::vec3& origin, glm::vec3& direction) const
+{
+	int width = WINDOW_WIDTH;
+	int height = WINDOW_HEIGHT;
+	double x = width * 0.5;
+	double y = height * 0.5;
+	if (NULL != m_pWindow)
+	{
+		glfwGetWindowSize(m_pWindow, &width, &height);
+		x = width * 0.5;
+		y = height * 0.5;
+		if (glfwGetInputMode(m_pWindow, GLFW_CURSOR) != GLFW_CURSOR_DISABLED)
+		{
+			glfwGetCursorPos(m_pWindow, &x, &y);
+		}
+	}
+
+	GetCameraRay(
+		glm::inverse(m_projectionMatrix * m_viewMatrix),
+		std::max(width, 1),
+		std::max(height, 1),
+		static_cast<float>(x),
+		static_cast<float>(y),
+		origin,
+		direction);
+}
+
+/***********************************************************
+ *  SetCollision()
+ *
+ *  This method is used for setting the boxes the camera
+ *  slides along as it moves.  They must stay alive while
+ *  they are set.
+ ***********************************************************/
+void ViewManager::SetCollision(const SceneCollision* pCollision)
+{
+	m_pCollision = pCollision;
+}
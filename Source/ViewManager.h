@@ -1,51 +1,119 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "camera.h"
-
-// GLFW library
-#include "GLFW/glfw3.h" 
-
-class ViewManager
-{
-public:
-	// constructor
-	ViewManager(
-		ShaderManager* pShaderManager);
-	// destructor
-	~ViewManager();
-
-	// mouse position callback for mouse interaction with the 3D scene
-	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
-
-	// Scroll wheel callback for increasing camera travel speed. 
-	static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// active OpenGL display window
-	GLFWwindow* m_pWindow;
-
-	// process keyboard events for interaction with the 3D scene
-	void ProcessKeyboardEvents();
-
-public:
-	// create the initial OpenGL display window
-	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
-	
-	// prepare the conversion from 3D object display to 2D scene display
-	void PrepareSceneView();
-
-	// Flag for toggling orthographic vs perspective projection
-	bool perspectiveProjection;
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "AntiAliasing.h"
+#include "DebugViewRenderer.h"
+#include "RenderBackend.h"
+#include "SceneCollision.h"
+
+// GLEW library, ahead of the camera and GLFW headers
+#include <GL/glew.h>
+#include "camera.h"
+
+#include <glm/glm.hpp>
+
+// GLFW library
+#include "GLFW/glfw3.h" 
+
+class ViewManager
+{
+public:
+	// constructor
+	ViewManager(
+		RenderBackend* pBackend);
+	// destructor
+	~ViewManager();
+
+	// mouse position callback for mouse interaction with the 3D scene
+	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
+
+	// Scroll wheel callback for increasing camera travel speed. 
+	static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+
+private:
+	// backend the camera uniforms are set through
+	RenderBackend* m_pBackend;
+	// active OpenGL display window
+	GLFWwindow* m_pWindow;
+	// view and projection matrices of the current frame
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+	// whether the performance overlay is shown, and whether
+	// its key was down at the last check
+	bool m_bShowPerformanceHUD;
+	bool m_bHUDKeyDown;
+	// debug view the scene is drawn as, and whether its key
+	// was down at the last check
+	DEBUG_VIEW m_debugView;
+	bool m_bDebugViewKeyDown;
+	// anti-aliasing mode, whether its key was down at the
+	// last check, and the frames drawn with jitter so far
+	ANTI_ALIASING m_antiAliasing;
+	bool m_bAntiAliasingKeyDown;
+	unsigned int m_jitterFrame;
+	// whether the scene reuses the last frame's pixels, and
+	// whether its key was down at the last check
+	bool m_bReprojection;
+	bool m_bReprojectionKeyDown;
+	// whether the scene is darkened by ambient occlusion, and
+	// whether its key was down at the last check
+	bool m_bAmbientOcclusion;
+	bool m_bAmbientOcclusionKeyDown;
+	// whether a click is waiting to pick an object, and
+	// whether the left mouse button was down at the last check
+	bool m_bPickRequested;
+	bool m_bPickButtonDown;
+	// boxes the camera is kept out of, or NULL to fly freely
+	const SceneCollision* m_pCollision;
+
+	// process keyboard events for interaction with the 3D scene
+	void ProcessKeyboardEvents();
+
+public:
+	// create the initial OpenGL display window
+	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+	
+	// prepare the conversion from 3D object display to 2D scene display
+	void PrepareSceneView();
+	// compute the camera matrices and set them into the shader,
+	// without reading any input
+	void UpdateCameraMatrices();
+
+	// get the matrices and camera position of the current frame
+	glm::mat4 GetViewMatrix() const;
+	glm::mat4 GetProjectionMatrix() const;
+	glm::vec3 GetViewPosition() const;
+
+	// whether F1 has turned the performance overlay on
+	bool IsPerformanceHUDVisible() const;
+	// debug view F2 has stepped to
+	DEBUG_VIEW GetDebugView() const;
+	// anti-aliasing mode F3 has stepped to, or one chosen
+	ANTI_ALIASING GetAntiAliasing() const;
+	void SetAntiAliasing(ANTI_ALIASING mode);
+	// whether F4 has turned the scene reprojection on
+	bool IsReprojectionEnabled() const;
+	// whether F5 has left the ambient occlusion on
+	bool IsAmbientOcclusionEnabled() const;
+	// whether the left mouse button has gone down since the
+	// last call
+	bool TakePickRequest();
+	// ray from the near to the far plane under the cursor, or
+	// through the middle of the window while the cursor is
+	// captured for looking around
+	void GetCursorRay(glm::vec3& origin, glm::vec3& direction) const;
+	// boxes the camera slides along instead of flying through,
+	// or NULL
+	void SetCollision(const SceneCollision* pCollision);
+
+	// Flag for toggling orthographic vs perspective projection
+	bool perspectiveProjection;
 };
\ No newline at end of file
@@ -0,0 +1,345 @@
+#!/usr/bin/env python3
+###############################################################################
+# perfdb.py
+# ============
+# keep benchmark results per build and compare builds with statistics
+#
+# The results of "--benchmark ... results.json N" (Google Benchmark JSON)
+# and of "--null ... stats.json" / "--stats stats.json" (frame statistics)
+# are stored in a local SQLite file with the build hash and a fingerprint
+# of the machine.  Two builds are compared metric by metric with a
+# Mann-Whitney U test and a bootstrap confidence interval of the change in
+# the median.  Lower is better for every metric, since they are times and
+# command counts.
+#
+#   perfdb.py record perf.db results.json [--build HASH] [--note TEXT]
+#   perfdb.py builds perf.db
+#   perfdb.py compare perf.db BASE NEW [--metric TEXT] [--alpha 0.05]
+#
+# compare exits with 1 when a metric got significantly worse, so it can
+# fail a CI job.  Only Python's standard library is used.
+###############################################################################
+
+import argparse
+import datetime
+import hashlib
+import json
+import math
+import os
+import platform
+import random
+import sqlite3
+import subprocess
+import sys
+
+SCHEMA = """
+CREATE TABLE IF NOT EXISTS machines (
+    fingerprint TEXT PRIMARY KEY,
+    description TEXT NOT NULL
+);
+CREATE TABLE IF NOT EXISTS runs (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    build TEXT NOT NULL,
+    machine TEXT NOT NULL REFERENCES machines(fingerprint),
+    recorded_at TEXT NOT NULL,
+    source TEXT NOT NULL,
+    note TEXT
+);
+CREATE TABLE IF NOT EXISTS samples (
+    run_id INTEGER NOT NULL REFERENCES runs(id),
+    metric TEXT NOT NULL,
+    value REAL NOT NULL,
+    unit TEXT NOT NULL
+);
+CREATE INDEX IF NOT EXISTS samples_by_run ON samples(run_id, metric);
+CREATE INDEX IF NOT EXISTS runs_by_build ON runs(build, machine);
+"""
+
+
+def open_database(filename):
+    """Open the database, creating the tables the first time."""
+    connection = sqlite3.connect(filename)
+    connection.executescript(SCHEMA)
+    return connection
+
+
+def current_build():
+    """Hash of the checked out commit, marked when the tree has changes."""
+    try:
+        build = subprocess.check_output(
+            ["git", "rev-parse", "--short=12", "HEAD"], stderr=subprocess.DEVNULL).decode().strip()
+        changed = subprocess.call(["git", "diff", "--quiet", "HEAD"], stderr=subprocess.DEVNULL) != 0
+        return build + ("-dirty" if changed else "")
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+def machine_description():
+    """What the results depend on: OS, CPU model and core count."""
+    cpu = platform.processor()
+    try:
+        with open("/proc/cpuinfo") as cpuinfo:
+            for line in cpuinfo:
+                if line.startswith("model name"):
+                    cpu = line.split(":", 1)[1].strip()
+                    break
+    except OSError:
+        pass
+    return "{} {} {}, {}, {} cores".format(
+        platform.system(), platform.release(), platform.machine(), cpu or "unknown CPU", os.cpu_count())
+
+
+def machine_fingerprint(description):
+    """Short stable id of a machine description."""
+    return hashlib.sha1(description.encode()).hexdigest()[:12]
+
+
+def read_samples(filename):
+    """Read (metric, value, unit) samples from either kind of result file."""
+    with open(filename) as results:
+        document = json.load(results)
+
+    samples = []
+    if "benchmarks" in document:
+        # Google Benchmark - one sample per repetition, skipping the
+        # aggregates Google Benchmark itself adds
+        for benchmark in document["benchmarks"]:
+            if benchmark.get("run_type", "iteration") != "iteration":
+                continue
+            name = benchmark.get("run_name", benchmark["name"])
+            unit = benchmark.get("time_unit", "ns")
+            samples.append((name + "/real_time", float(benchmark["real_time"]), unit))
+            samples.append((name + "/cpu_time", float(benchmark["cpu_time"]), unit))
+    elif "frames" in document:
+        # frame statistics - one sample per kept frame
+        for frame in document["frames"]:
+            for key, value in frame.items():
+                if key == "frame":
+                    continue
+                unit = "ms" if key == "milliseconds" else "count"
+                samples.append(("frame/" + key, float(value), unit))
+    else:
+        raise ValueError("{} is neither benchmark nor frame statistics output".format(filename))
+    return samples
+
+
+def find_build(connection, prefix, fingerprint):
+    """Full build hash starting with the prefix, on the machine if one is given.
+
+    A build named exactly wins over longer ones it prefixes, so a full
+    hash still finds its clean build once a "<hash>-dirty" one exists."""
+    machine = ""
+    parameters = []
+    if fingerprint:
+        machine = " AND machine = ?"
+        parameters.append(fingerprint)
+    query = "SELECT DISTINCT build FROM runs WHERE build = ?" + machine
+    builds = [row[0] for row in connection.execute(query, [prefix] + parameters)]
+    if builds:
+        return builds[0]
+    query = "SELECT DISTINCT build FROM runs WHERE substr(build, 1, ?) = ?" + machine
+    builds = [row[0] for row in connection.execute(query, [len(prefix), prefix] + parameters)]
+    if len(builds) != 1:
+        raise ValueError("{} matches {} builds{}".format(
+            prefix, len(builds), "" if not builds else ": " + ", ".join(builds)))
+    return builds[0]
+
+
+def load_metrics(connection, build, fingerprint, metric_filter):
+    """Samples of every metric of a build, pooled over its runs."""
+    query = ("SELECT metric, value, unit FROM samples JOIN runs ON runs.id = samples.run_id "
+             "WHERE runs.build = ?")
+    parameters = [build]
+    if fingerprint:
+        query += " AND runs.machine = ?"
+        parameters.append(fingerprint)
+    metrics = {}
+    for metric, value, unit in connection.execute(query, parameters):
+        if metric_filter and metric_filter not in metric:
+            continue
+        metrics.setdefault(metric, ([], unit))[0].append(value)
+    return metrics
+
+
+def median(values):
+    ordered = sorted(values)
+    middle = len(ordered) // 2
+    if len(ordered) % 2:
+        return ordered[middle]
+    return 0.5 * (ordered[middle - 1] + ordered[middle])
+
+
+def mann_whitney(base, new):
+    """Two sided p value of the Mann-Whitney U test, from the normal
+    approximation with the tie and continuity corrections."""
+    combined = sorted([(value, 0) for value in base] + [(value, 1) for value in new])
+    ranks = [0.0] * len(combined)
+    ties = 0.0
+    i = 0
+    while i < len(combined):
+        j = i
+        while j + 1 < len(combined) and combined[j + 1][0] == combined[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = 0.5 * (i + j) + 1.0
+        count = j - i + 1
+        ties += count ** 3 - count
+        i = j + 1
+
+    n1 = len(base)
+    n2 = len(new)
+    rank_sum = sum(rank for rank, (_, group) in zip(ranks, combined) if group == 0)
+    u = rank_sum - n1 * (n1 + 1) / 2.0
+    mean = n1 * n2 / 2.0
+    n = n1 + n2
+    variance = n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1)))
+    if variance <= 0.0:
+        return 1.0
+    z = (abs(u - mean) - 0.5) / math.sqrt(variance)
+    return min(1.0, math.erfc(max(z, 0.0) / math.sqrt(2.0)))
+
+
+def bootstrap_change(base, new, resamples, confidence, seed=1):
+    """Confidence interval of median(new) / median(base) - 1."""
+    generator = random.Random(seed)
+    changes = []
+    for _ in range(resamples):
+        base_median = median([generator.choice(base) for _ in base])
+        new_median = median([generator.choice(new) for _ in new])
+        if base_median != 0.0:
+            changes.append(new_median / base_median - 1.0)
+    if not changes:
+        return (0.0, 0.0)
+    changes.sort()
+    tail = (1.0 - confidence) / 2.0
+    low = changes[int(tail * (len(changes) - 1))]
+    high = changes[int((1.0 - tail) * (len(changes) - 1))]
+    return (low, high)
+
+
+def command_record(arguments):
+    connection = open_database(arguments.database)
+    description = machine_description()
+    fingerprint = machine_fingerprint(description)
+    build = arguments.build or current_build()
+    samples = read_samples(arguments.results)
+
+    connection.execute("INSERT OR IGNORE INTO machines VALUES (?, ?)", (fingerprint, description))
+    cursor = connection.execute(
+        "INSERT INTO runs (build, machine, recorded_at, source, note) VALUES (?, ?, ?, ?, ?)",
+        (build, fingerprint, datetime.datetime.now().isoformat(timespec="seconds"),
+         os.path.basename(arguments.results), arguments.note))
+    connection.executemany(
+        "INSERT INTO samples VALUES (?, ?, ?, ?)",
+        [(cursor.lastrowid, metric, value, unit) for metric, value, unit in samples])
+    connection.commit()
+    print("Recorded {} samples of build {} on {} ({})".format(len(samples), build, fingerprint, description))
+    return 0
+
+
+def command_builds(arguments):
+    connection = open_database(arguments.database)
+    rows = connection.execute(
+        "SELECT runs.build, runs.machine, machines.description, COUNT(DISTINCT runs.id), MAX(runs.recorded_at) "
+        "FROM runs JOIN machines ON machines.fingerprint = runs.machine "
+        "GROUP BY runs.build, runs.machine ORDER BY MAX(runs.recorded_at)")
+    for build, machine, description, runs, last in rows:
+        print("{:20} {:12} {:3} runs  last {}  {}".format(build, machine, runs, last, description))
+    return 0
+
+
+def command_compare(arguments):
+    connection = open_database(arguments.database)
+    if arguments.machine == "any":
+        fingerprint = None
+    elif arguments.machine == "this":
+        fingerprint = machine_fingerprint(machine_description())
+    else:
+        fingerprint = arguments.machine
+
+    base_build = find_build(connection, arguments.base, fingerprint)
+    new_build = find_build(connection, arguments.new, fingerprint)
+    base_metrics = load_metrics(connection, base_build, fingerprint, arguments.metric)
+    new_metrics = load_metrics(connection, new_build, fingerprint, arguments.metric)
+
+    print("Comparing {} (base) with {} on {}".format(base_build, new_build, fingerprint or "any machine"))
+    print("{:52} {:>12} {:>12} {:>8} {:>18} {:>9}  {}".format(
+        "Metric", "Base median", "New median", "Change", "95% interval", "p", "Verdict"))
+
+    regressions = 0
+    for metric in sorted(set(base_metrics) & set(new_metrics)):
+        base, unit = base_metrics[metric]
+        new = new_metrics[metric][0]
+        base_median = median(base)
+        new_median = median(new)
+        change = (new_median / base_median - 1.0) if base_median != 0.0 else 0.0
+
+        if min(len(base), len(new)) < arguments.min_samples:
+            p_value = float("nan")
+            interval = (float("nan"), float("nan"))
+            verdict = "too few samples"
+        else:
+            p_value = mann_whitney(base, new)
+            interval = bootstrap_change(base, new, arguments.resamples, 1.0 - arguments.alpha)
+            significant = (p_value < arguments.alpha and (interval[0] > 0.0 or interval[1] < 0.0)
+                           and abs(change) >= arguments.threshold)
+            if not significant:
+                verdict = "same"
+            elif change > 0.0:
+                verdict = "REGRESSION"
+                regressions += 1
+            else:
+                verdict = "improvement"
+
+        label = "" if unit == "count" else unit
+        print("{:52} {:>9.4g} {:2} {:>9.4g} {:2} {:>+7.1%} [{:>+7.1%}, {:>+7.1%}] {:>9.2g}  {}".format(
+            metric[:52], base_median, label, new_median, label, change,
+            interval[0], interval[1], p_value, verdict))
+
+    missing = sorted(set(base_metrics) ^ set(new_metrics))
+    if missing:
+        print("Only in one build: " + ", ".join(missing))
+    print("{} regression{}".format(regressions, "" if regressions == 1 else "s"))
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Store benchmark results per build and compare builds.")
+    commands = parser.add_subparsers(dest="command")
+    commands.required = True
+
+    record = commands.add_parser("record", help="store a results file")
+    record.add_argument("database")
+    record.add_argument("results", help="--benchmark or frame statistics JSON")
+    record.add_argument("--build", help="build id, the git commit by default")
+    record.add_argument("--note", help="free text kept with the run")
+    record.set_defaults(function=command_record)
+
+    builds = commands.add_parser("builds", help="list the stored builds")
+    builds.add_argument("database")
+    builds.set_defaults(function=command_builds)
+
+    compare = commands.add_parser("compare", help="compare two builds")
+    compare.add_argument("database")
+    compare.add_argument("base", help="build id or its prefix")
+    compare.add_argument("new", help="build id or its prefix")
+    compare.add_argument("--machine", default="this",
+                         help="'this' (default), 'any' or a machine fingerprint")
+    compare.add_argument("--metric", help="only metrics containing this text")
+    compare.add_argument("--alpha", type=float, default=0.05, help="significance level")
+    compare.add_argument("--threshold", type=float, default=0.02,
+                         help="smallest relative change reported as significant")
+    compare.add_argument("--resamples", type=int, default=2000, help="bootstrap resamples")
+    compare.add_argument("--min-samples", type=int, default=5, help="samples needed per build")
+    compare.set_defaults(function=command_compare)
+
+    arguments = parser.parse_args()
+    try:
+        return arguments.function(arguments)
+    except (OSError, ValueError, sqlite3.Error) as error:
+        print("perfdb: {}".format(error), file=sys.stderr)
+        return 2
+
+
+if __name__ == "__main__":
+    sys.exit(main())